@@ -1,6 +1,7 @@
 import ctypes
 import sys
 import re
+import threading
 
 librubix = ctypes.CDLL("./librubix.so")
 
@@ -18,6 +19,9 @@ librubix.rubix_cube_allocate_scrambled.restype = ctypes.c_void_p
 librubix.rubix_cube_allocate_solved.restype = ctypes.c_void_p
 
 librubix.rubix_cube_free.argtypes = [ctypes.c_void_p]
+librubix.rubix_cube_is_solved.argtypes = [ctypes.c_void_p]
+librubix.rubix_cube_equivelence_check.argtypes = [ctypes.c_void_p, ctypes.c_void_p]
+librubix.rubix_cube_rotate_face.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int]
 librubix.rubix_cube_scramble_free.argtypes = [ctypes.c_void_p]
 
 librubix.rubix_cube_scramble_allocate.restype = ctypes.c_void_p
@@ -28,6 +32,238 @@ librubix.rubix_cube_unapply_scramble.argtypes = [ctypes.c_void_p, ctypes.c_void_
 
 # librubix.rubix_cube_free(cuberef)
 
+librubix.rubix_cube_pool_allocate.restype = ctypes.c_void_p
+librubix.rubix_cube_pool_allocate.argtypes = [ctypes.c_size_t]
+librubix.rubix_cube_pool_cube_solved.restype = ctypes.c_void_p
+librubix.rubix_cube_pool_cube_solved.argtypes = [ctypes.c_void_p]
+librubix.rubix_cube_pool_cube_scrambled.restype = ctypes.c_void_p
+librubix.rubix_cube_pool_cube_scrambled.argtypes = [ctypes.c_void_p, ctypes.c_ulonglong]
+librubix.rubix_cube_pool_cube_release.argtypes = [ctypes.c_void_p, ctypes.c_void_p]
+
+librubix.rubix_cube_journal_allocate.restype = ctypes.c_void_p
+librubix.rubix_cube_journal_allocate.argtypes = [ctypes.c_void_p, ctypes.c_size_t, ctypes.c_size_t]
+librubix.rubix_cube_journal_free.argtypes = [ctypes.c_void_p]
+librubix.rubix_cube_journal_apply_codes.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_size_t]
+librubix.rubix_cube_journal_unapply_codes.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_size_t]
+librubix.rubix_cube_journal_rewind.argtypes = [ctypes.c_void_p, ctypes.c_size_t]
+librubix.rubix_cube_journal_undo.argtypes = [ctypes.c_void_p, ctypes.c_size_t]
+librubix.rubix_cube_journal_position.restype = ctypes.c_size_t
+librubix.rubix_cube_journal_position.argtypes = [ctypes.c_void_p]
+librubix.rubix_cube_journal_oldest.restype = ctypes.c_size_t
+librubix.rubix_cube_journal_oldest.argtypes = [ctypes.c_void_p]
+
+# Moves a RubixCube remembers for undo(), and how often it keeps a copy of the whole cube
+JOURNAL_CAPACITY = 1024
+JOURNAL_INTERVAL = 32
+
+# Every RubixCube comes from this pool rather than from malloc(), and goes back to it when collected.
+# ctypes lets go of the GIL during calls and a pool is not thread safe, hence the lock.
+_pool = librubix.rubix_cube_pool_allocate(0)
+_pool_lock = threading.Lock()
+
+def _pool_cube(seed = 0):
+    with _pool_lock:
+        if seed:
+            return librubix.rubix_cube_pool_cube_scrambled(_pool, seed)
+        return librubix.rubix_cube_pool_cube_solved(_pool)
+
+# Bound as defaults so that it still works while the module is torn down at exit
+def _pool_release(ptr, release = librubix.rubix_cube_pool_cube_release, pool = _pool, lock = _pool_lock):
+    with lock:
+        release(pool, ptr)
+
+def _journal_free(journal, free = librubix.rubix_cube_journal_free):
+    free(journal)
+
+# Mirrors RubixCubeStats in src/rubix_cube_stats.h
+class RubixCubeStats(ctypes.Structure):
+    SIDE_COUNT = 6
+    _fields_ = [
+            ("rotate_face", ctypes.c_ulonglong * SIDE_COUNT),
+            ("rotate_face_cycles", ctypes.c_ulonglong * SIDE_COUNT),
+            ("rotate_piece_quadset", ctypes.c_ulonglong),
+            ("apply_scramble", ctypes.c_ulonglong),
+            ("apply_scramble_moves", ctypes.c_ulonglong),
+            ("apply_scramble_cycles", ctypes.c_ulonglong),
+            ("unapply_scramble", ctypes.c_ulonglong),
+            ("unapply_scramble_moves", ctypes.c_ulonglong),
+            ("unapply_scramble_cycles", ctypes.c_ulonglong),
+            ("allocations", ctypes.c_ulonglong),
+            ("allocation_bytes", ctypes.c_ulonglong)
+            ]
+
+    def as_dict(self):
+        result = {}
+        for name, kind in self._fields_:
+            value = getattr(self, name)
+            result[name] = list(value) if hasattr(value, "__len__") else value
+        return result
+
+librubix.rubix_cube_stats_snapshot.argtypes = [ctypes.POINTER(RubixCubeStats)]
+librubix.rubix_cube_stats_enable_timers.argtypes = [ctypes.c_int]
+
+def stats_enabled():
+    """True if librubix.so was built with make STATS=1"""
+    return librubix.rubix_cube_stats_enabled() != 0
+
+def stats_snapshot():
+    """Counters of every thread since the last stats_reset(), as a dict"""
+    stats = RubixCubeStats()
+    librubix.rubix_cube_stats_snapshot(ctypes.byref(stats))
+    return stats.as_dict()
+
+def stats_reset():
+    librubix.rubix_cube_stats_reset()
+
+def stats_enable_timers(enable = True):
+    librubix.rubix_cube_stats_enable_timers(1 if enable else 0)
+
+# Batch entry points, each call does a whole buffer worth of work
+#
+# Cubes go over as RubixCubeFacelets, 64 bytes each (54 colors and zero padding), move
+# streams as one byte code per move (side * 3 + rotation). Anything with the buffer
+# protocol works: bytearray, memoryview, array.array or a C contiguous numpy array.
+# Nothing is copied, the C side reads and writes the Python buffer in place.
+
+FACELET_STRIDE = 64
+FACELET_COUNT = 54
+MOVE_COUNT = 18
+
+librubix.rubix_cube_facelets_apply_codes_all.argtypes = [ctypes.c_void_p, ctypes.c_size_t, ctypes.c_void_p, ctypes.c_size_t]
+librubix.rubix_cube_facelets_apply_codes_rows.argtypes = [ctypes.c_void_p, ctypes.c_size_t, ctypes.c_void_p, ctypes.c_size_t]
+librubix.rubix_cube_facelets_unapply_codes_rows.argtypes = [ctypes.c_void_p, ctypes.c_size_t, ctypes.c_void_p, ctypes.c_size_t]
+librubix.rubix_cube_facelets_fill_solved.argtypes = [ctypes.c_void_p, ctypes.c_size_t]
+librubix.rubix_cube_facelets_count_solved.argtypes = [ctypes.c_void_p, ctypes.c_size_t, ctypes.c_void_p]
+librubix.rubix_cube_facelets_count_solved.restype = ctypes.c_size_t
+librubix.rubix_cube_count_solved.argtypes = [ctypes.c_void_p, ctypes.c_size_t, ctypes.c_void_p]
+librubix.rubix_cube_count_solved.restype = ctypes.c_size_t
+librubix.rubix_cube_apply_move_codes.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_size_t]
+librubix.rubix_cube_unapply_move_codes.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_size_t]
+librubix.rubix_cube_generate_move_codes.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_size_t, ctypes.c_size_t]
+
+def _address(buffer, readonly = False):
+    """Address and size in bytes of the memory behind @buffer, without copying it"""
+    if readonly and isinstance(buffer, bytes):
+        return ctypes.cast(ctypes.c_char_p(buffer), ctypes.c_void_p).value, len(buffer)
+    view = memoryview(buffer)
+    if not view.c_contiguous:
+        raise ValueError("buffer is not contiguous")
+    if view.nbytes == 0:
+        return None, 0
+    return ctypes.addressof((ctypes.c_char * view.nbytes).from_buffer(view)), view.nbytes
+
+def _check(ok):
+    if not ok:
+        raise ValueError("move code out of range (0 to %d)" % (MOVE_COUNT - 1))
+
+def generate_scramble_codes(count, intensity = None, seeds = None):
+    """Byte codes of @count scrambles of @intensity moves each, back to back, as a bytearray
+
+    Scramble i comes from @seeds[i], or from a fresh seed if @seeds is None or holds a 0.
+    Returns (codes, seeds) with the seeds that were used, as an array of unsigned 64 bit ints.
+    """
+    if intensity is None:
+        intensity = librubix.rubix_cube_get_default_scramble_intensity()
+    seed_buffer = (ctypes.c_ulonglong * count)(*(seeds if seeds is not None else [0] * count))
+    codes = bytearray(count * intensity)
+    address, size = _address(codes)
+    librubix.rubix_cube_generate_move_codes(address, seed_buffer, count, intensity)
+    return codes, seed_buffer
+
+NOTATION_EXTENDED = 0x1
+NOTATION_INVERSE = 0x2
+
+# Mirrors RubixCubeNotationStatus in src/rubix_cube_notation.h
+class RubixCubeNotationStatus(ctypes.Structure):
+    _fields_ = [
+            ("offset", ctypes.c_size_t),
+            ("error", ctypes.c_char_p)
+            ]
+
+librubix.rubix_cube_notation_parse_codes.argtypes = [ctypes.c_void_p, ctypes.c_size_t, ctypes.c_char_p, ctypes.c_size_t, ctypes.c_uint, ctypes.POINTER(RubixCubeNotationStatus)]
+librubix.rubix_cube_notation_parse_codes.restype = ctypes.c_size_t
+librubix.rubix_cube_notation_format_codes.argtypes = [ctypes.c_void_p, ctypes.c_size_t, ctypes.c_void_p, ctypes.c_size_t, ctypes.c_uint]
+librubix.rubix_cube_notation_format_codes.restype = ctypes.c_size_t
+
+def parse_moves(text, extended = False):
+    """Move codes of the first line of @text, in Singmaster notation ("R U R' U2"), as bytes
+
+    With @extended, wide, slice and rotation moves are taken as well. Raises ValueError on a bad token.
+    """
+    if isinstance(text, str):
+        text = text.encode()
+    status = RubixCubeNotationStatus()
+    codes = bytearray(2 * len(text))
+    address, size = _address(codes)
+    count = librubix.rubix_cube_notation_parse_codes(address, size, text, len(text),
+            NOTATION_EXTENDED if extended else 0, ctypes.byref(status))
+    if status.error:
+        raise ValueError("%s at offset %d" % (status.error.decode(), status.offset))
+    return bytes(codes[:count])
+
+def format_moves(codes, inverse = False):
+    """Singmaster notation for the move codes in @codes, or for the moves that undo them"""
+    address, size = _address(codes, readonly = True)
+    text = ctypes.create_string_buffer(3 * size)
+    written = librubix.rubix_cube_notation_format_codes(text, len(text), address, size,
+            NOTATION_INVERSE if inverse else 0)
+    _check(written or not size)
+    return text.raw[:written].decode()
+
+class CubeArray:
+    """@count cubes in facelet form, in one 64 byte aligned buffer that numpy can view"""
+
+    def __init__(self, count):
+        self.count = count
+        self._raw = (ctypes.c_ubyte * (count * FACELET_STRIDE + FACELET_STRIDE))()
+        self._offset = (-ctypes.addressof(self._raw)) % FACELET_STRIDE
+        self.address = ctypes.addressof(self._raw) + self._offset
+        librubix.rubix_cube_facelets_fill_solved(self.address, count)
+
+    def __len__(self):
+        return self.count
+
+    @property
+    def buffer(self):
+        """Writable memoryview of the cubes, @count * 64 bytes, e.g. numpy.frombuffer(a.buffer, numpy.uint8).reshape(-1, 64)"""
+        return memoryview(self._raw)[self._offset : self._offset + self.count * FACELET_STRIDE]
+
+    def colors(self, index):
+        """The 54 colors of cube @index, face after face (top, front, right, left, back, bottom)"""
+        start = index * FACELET_STRIDE
+        return bytes(self.buffer[start : start + FACELET_COUNT])
+
+    def reset(self):
+        librubix.rubix_cube_facelets_fill_solved(self.address, self.count)
+
+    def apply_all(self, codes):
+        """Apply the move stream @codes, in order, to every cube"""
+        address, size = _address(codes, readonly = True)
+        _check(librubix.rubix_cube_facelets_apply_codes_all(self.address, self.count, address, size))
+
+    def apply_rows(self, codes, moves_per_cube, unapply = False):
+        """Apply row i of @codes (@moves_per_cube codes) to cube i, or undo it"""
+        address, size = _address(codes, readonly = True)
+        if size != self.count * moves_per_cube:
+            raise ValueError("need %d codes, got %d" % (self.count * moves_per_cube, size))
+        function = librubix.rubix_cube_facelets_unapply_codes_rows if unapply else librubix.rubix_cube_facelets_apply_codes_rows
+        _check(function(self.address, self.count, address, moves_per_cube))
+
+    def scramble(self, intensity = None, seeds = None):
+        """Scramble cube i from seed i, return the (codes, seeds) used, see generate_scramble_codes()"""
+        codes, used = generate_scramble_codes(self.count, intensity, seeds)
+        self.apply_rows(codes, len(codes) // self.count if self.count else 0)
+        return codes, used
+
+    def solved(self, results = None):
+        """Number of solved cubes, if given a writable @results buffer of @count bytes also mark each solved one"""
+        address = None
+        if results is not None:
+            address, size = _address(results)
+            if size < self.count:
+                raise ValueError("results needs %d bytes" % self.count)
+        return librubix.rubix_cube_facelets_count_solved(self.address, self.count, address)
+
 class RubixCube:
 
     FACES = [
@@ -48,16 +284,25 @@ class RubixCube:
     DEFAULT_SCRAMBLE_INTENSITY = librubix.rubix_cube_get_default_scramble_intensity()
 
     def __init__(self,seed):
-        if seed == 0 or seed == None:
-            self.ptr = librubix.rubix_cube_allocate_solved()
-        else:
-            self.ptr = librubix.rubix_cube_allocate_scrambled(int(seed))
-        self.scramble_ptrs = []
+        self.ptr = _pool_cube(int(seed or 0))
+        if not self.ptr:
+            raise MemoryError("RubixCube allocation failed")
+        self.scrambles = []
+        self.journal = None
 
     def __del__(self):
-        librubix.rubix_cube_free(self.ptr)
-        for ptr in self.scramble_ptrs:
-            librubix.rubix_cube_scramble_free(ptr)
+        if getattr(self, "journal", None):
+            _journal_free(self.journal)
+        if getattr(self, "ptr", None):
+            _pool_release(self.ptr)
+
+    def _journal(self):
+        # Made on the first move, most cubes in a batch never need one
+        if not self.journal:
+            self.journal = librubix.rubix_cube_journal_allocate(self.ptr, JOURNAL_CAPACITY, JOURNAL_INTERVAL)
+            if not self.journal:
+                raise MemoryError("RubixCube journal allocation failed")
+        return self.journal
 
     def __eq__(self, other):
         return librubix.rubix_cube_equivelence_check(self.ptr,other.ptr) == True
@@ -71,22 +316,48 @@ class RubixCube:
     def rotate(self,face,rotation):
         if not face in self.FACES or not rotation in self.ROTATIONS:
             return None
-        librubix.rubix_cube_rotate_face(self.ptr, self.FACES.index(face), self.ROTATIONS.index(rotation))
+        self.apply(bytes([self.FACES.index(face) * len(self.ROTATIONS) + self.ROTATIONS.index(rotation)]))
+
+    def apply(self, codes):
+        """Apply a whole move stream (byte codes, side * 3 + rotation) in one call"""
+        address, size = _address(codes, readonly = True)
+        _check(librubix.rubix_cube_journal_apply_codes(self._journal(), address, size))
+
+    def unapply(self, codes):
+        address, size = _address(codes, readonly = True)
+        _check(librubix.rubix_cube_journal_unapply_codes(self._journal(), address, size))
+
+    def position(self):
+        """Moves made on the cube so far, less the undone ones"""
+        return librubix.rubix_cube_journal_position(self.journal) if self.journal else 0
+
+    def undo(self, count = 1):
+        """Take back the last count moves, False if the cube does not remember that many"""
+        return librubix.rubix_cube_journal_undo(self._journal(), count) == 1
+
+    def rewind(self, position):
+        """Take the cube back to how it was position moves in, False if that was forgotten"""
+        return librubix.rubix_cube_journal_rewind(self._journal(), position) == 1
 
     def scramble(self,intensity = DEFAULT_SCRAMBLE_INTENSITY, seed = 0):
-        self.scramble_ptrs.append(librubix.rubix_cube_scramble_allocate(seed,intensity))
-        librubix.rubix_cube_apply_scramble(self.ptr, self.scramble_ptrs[-1])
+        codes, seeds = generate_scramble_codes(1, intensity, [seed])
+        self.apply(codes)
+        self.scrambles.append(bytes(codes))
 
     def unscramble(self, history_depth = 1):
-        if len(self.scramble_ptrs) == 0:
+        if len(self.scrambles) == 0:
             print("No scrambles in scramble history. Doing nothing.")
             return
-        librubix.rubix_cube_unapply_scramble(self.ptr, self.scramble_ptrs[-1 * history_depth])
-        librubix.rubix_cube_scramble_free(self.scramble_ptrs.pop())
+        self.unapply(self.scrambles[-1 * history_depth])
+        self.scrambles.pop()
 
     def reset(self):
-        librubix.rubix_cube_free(self.ptr)
-        self.ptr = librubix.rubix_cube_allocate_solved()
+        if self.journal:
+            _journal_free(self.journal)
+            self.journal = None
+        _pool_release(self.ptr)
+        self.ptr = _pool_cube()
+        self.scrambles = []
 
 class CubeShell:
     def exit(self,tokens):
@@ -100,10 +371,15 @@ new:        start a new cube, discarding the old one\n\
 rotate:     rotate a side by a rotation value\n\
       sides = top, front, right, left, back, bottom\n\
   rotations = clockwise (c), counterclockwise (cc), double(d)\n\
+moves:      apply moves in Singmaster notation, e.g. moves R U R' U2\n\
 print:      display a 3D representation of the cube\n\
 scramble:   scramble the cube and save to scramble history\n\
 unscramble: unscramble the cube based on most recent scramble\n\
+undo:       take back moves, defaults to the last one\n\
+          n = number of moves to take back\n\
 check:      check if the cube is solved\n\
+stats:      show hot path counters (needs a make STATS=1 build)\n\
+          reset = start counting from zero again\n\
 history:    execute previous commands, defaults to previous\n\
           n = steps back in history (max 50)\n\
 !           alias for history\n"
@@ -162,6 +438,16 @@ history:    execute previous commands, defaults to previous\n\
         self.cube.rotate(face,rotation)
         self.cube.print3D()
 
+    def moves(self,tokens):
+        try:
+            # Case matters in notation, so take the moves from the command as it was typed
+            codes = parse_moves(self.raw_command.split(None, 1)[1] if len(tokens) > 1 else "", extended = True)
+        except ValueError as error:
+            print("Moves failed: %s" % error)
+            return
+        self.cube.apply(codes)
+        self.cube.print3D()
+
     def print3D(self,tokens):
         self.cube.print3D()
         return
@@ -176,12 +462,37 @@ history:    execute previous commands, defaults to previous\n\
         self.cube.print3D()
         return
 
+    def undo(self,tokens):
+        count = 1
+        if len(tokens) > 1:
+            try:
+                count = int(tokens[1])
+            except ValueError:
+                print("Undo failed: not a number of moves")
+                return
+        if not self.cube.undo(count):
+            print("Undo failed: the cube does not remember %d moves back" % count)
+            return
+        self.cube.print3D()
+
     def check(self,tokens):
         if self.cube.is_solved():
             print("The cube is solved")
         else:
             print("The cube is scrambled")
 
+    def stats(self,tokens):
+        if not stats_enabled():
+            print("Stats are off, rebuild with make STATS=1")
+            return
+        if len(tokens) > 1 and tokens[1] == "reset":
+            stats_reset()
+            return
+        for name, value in stats_snapshot().items():
+            if name.startswith("rotate_face"):
+                value = dict(zip(self.cube.FACES, value))
+            print("%-24s %s" % (name, value))
+
     MAXIMUM_ARCHEOLOGY = 50 # arbitrary
     def historic_execution(self,tokens):
         #print("depth: %d" % self.historic_execution_depth)
@@ -219,10 +530,13 @@ history:    execute previous commands, defaults to previous\n\
             "help"      :show_help,
             "new"       :new,
             "rotate"    :rotate,
+            "moves"     :moves,
             "print"     :print3D,
             "scramble"  :scramble,
             "unscramble":unscramble,
+            "undo"      :undo,
             "check"     :check,
+            "stats"     :stats,
             "history"   :historic_execution,
             "!"         :historic_execution
             }
@@ -234,6 +548,7 @@ history:    execute previous commands, defaults to previous\n\
             self.default()
         else:
             try:
+                self.raw_command = raw_command
                 tokens = raw_command.lower().split()
                 fun = self.COMMANDS[tokens[0]]
             except:
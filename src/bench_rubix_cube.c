@@ -0,0 +1,620 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Microbenchmarks for the hot paths:
+ *
+ * 	bench [--filter <substring>] [--repetitions <n>] [--sample-ms <ms>] [--json <path>]
+ *
+ * Each benchmark is warmed up, then timed over --repetitions samples of about
+ * --sample-ms each. A sample runs the operation a fixed number of times picked during
+ * warm-up, so every sample gives one ns/op figure and the spread of those figures is
+ * what the percentiles describe. ops/sec is taken from the median.
+ *
+ * Results go to stdout as a table and, with --json, to <path> as well.
+ */
+
+#include "rubix_cube.h"
+#include "rubix_cube_tracked.h"
+#include "rubix_cube_zobrist.h"
+#include "rubix_cube_render.h"
+#include "rubix_cube_notation.h"
+#include "rubix_cube_nxn.h"
+#include "rubix_cube_pool.h"
+#include "rubix_cube_journal.h"
+#include "rubix_cube_symmetry.h"
+#include "rubix_cube_turn.h"
+#include "rubix_cube_packed_scramble.h"
+#include "rubix_cube_optimize.h"
+#include "rubix_cube_monkeys.h"
+#include "rubix_cube_service.h"
+#include "rubix_cube_unrolled.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+
+#define BENCH_DEFAULT_REPETITIONS 	25
+#define BENCH_DEFAULT_SAMPLE_MS 	20
+#define BENCH_WARM_UP_MS 		100
+#define BENCH_MAX_REPETITIONS 		1000
+#define BENCH_NAME_SIZE 		64
+
+typedef struct bench_context {
+	RubixCube 			cube ;
+	RubixCube 			other ;
+	RubixCubeTracked 		tracked ;
+	RubixCubeScramble * 		pScramble ;
+	RubixCubePool * 		pPool ;
+	RubixCubeJournal * 		pJournal ;
+	RubixCubeService * 		pService ;
+	RubixCubeSide 			side ;
+	RubixCubeFaceRotation 		rotation ;
+	FILE * 				sink_file ;
+} BenchContext ;
+
+typedef void (*BenchFunction)(BenchContext * pContext, size_t iterations) ;
+
+typedef struct bench_result {
+	char 				name[BENCH_NAME_SIZE] ;
+	size_t 				iterations ;	/* per sample */
+	size_t 				repetitions ;
+	double 				min ;
+	double 				p50 ;
+	double 				p90 ;
+	double 				p99 ;
+	double 				max ;
+	double 				mean ;
+	double 				ops_per_second ;
+} BenchResult ;
+
+typedef struct bench_options {
+	const char * 			filter ;
+	size_t 				repetitions ;
+	double 				sample_ms ;
+	const char * 			json_path ;
+} BenchOptions ;
+
+/* Results are folded into here so the compiler can not drop the work */
+static volatile unsigned long long bench_sink ;
+
+static double bench_now_ns(void) {
+	struct timespec now ;
+	clock_gettime(CLOCK_MONOTONIC,&now) ;
+	return (double)now.tv_sec * 1e9 + (double)now.tv_nsec ;
+}
+
+static void bench_rotate_face(BenchContext * pContext, size_t iterations) {
+	for (size_t i = 0; i < iterations; ++i) rubix_cube_rotate_face(&pContext->cube,pContext->side,pContext->rotation) ;
+	bench_sink += pContext->cube.planes[0][0].sides[0] ;
+}
+
+/* Same turn as rotate_face, straight from rubix_cube_rotation_table and by the inlined unrolled R */
+static void bench_rotate_face_generic(BenchContext * pContext, size_t iterations) {
+	for (size_t i = 0; i < iterations; ++i) rubix_cube_rotate_face_generic(&pContext->cube,pContext->side,pContext->rotation) ;
+	bench_sink += pContext->cube.planes[0][0].sides[0] ;
+}
+
+static void bench_unrolled_right(BenchContext * pContext, size_t iterations) {
+	for (size_t i = 0; i < iterations; ++i) rubix_cube_unrolled_right_clockwise(&pContext->cube) ;
+	bench_sink += pContext->cube.planes[0][0].sides[0] ;
+}
+
+/* Same turn as rotate_face, on the facelet layout of each size, and an inner slice of the 5x5x5 */
+static void bench_nxn_rotate_3x3(BenchContext * pContext, size_t iterations) {
+	static RubixCube3x3 cube ;
+	for (size_t i = 0; i < iterations; ++i) rubix_cube_3x3_rotate_layer(&cube,pContext->side,0,pContext->rotation) ;
+	bench_sink += cube.facelets[0] ;
+}
+
+static void bench_nxn_rotate_7x7(BenchContext * pContext, size_t iterations) {
+	static RubixCube7x7 cube ;
+	for (size_t i = 0; i < iterations; ++i) rubix_cube_7x7_rotate_layer(&cube,pContext->side,0,pContext->rotation) ;
+	bench_sink += cube.facelets[0] ;
+}
+
+static void bench_nxn_slice_5x5(BenchContext * pContext, size_t iterations) {
+	static RubixCube5x5 cube ;
+	for (size_t i = 0; i < iterations; ++i) rubix_cube_5x5_rotate_layer(&cube,pContext->side,2,pContext->rotation) ;
+	bench_sink += cube.facelets[0] ;
+}
+
+static void bench_apply_scramble(BenchContext * pContext, size_t iterations) {
+	for (size_t i = 0; i < iterations; ++i) rubix_cube_apply_scramble(&pContext->cube,pContext->pScramble) ;
+	bench_sink += pContext->cube.planes[0][0].sides[0] ;
+}
+
+static void bench_is_solved(BenchContext * pContext, size_t iterations) {
+	unsigned long long solved = 0 ;
+	for (size_t i = 0; i < iterations; ++i) {
+		solved += rubix_cube_is_solved(&pContext->cube) ;
+		__asm__ volatile("" : : "g"(&pContext->cube) : "memory") ;
+	}
+	bench_sink += solved ;
+}
+
+/* A random walk step: one move, then check for solved, as search loops do */
+static void bench_walk(BenchContext * pContext, size_t iterations) {
+	unsigned long long solved = 0 ;
+	for (size_t i = 0; i < iterations; ++i) {
+		RubixCubeMove move = rubix_cube_generate_move_from_seed(1,i) ;
+		rubix_cube_apply_move(&pContext->cube,&move) ;
+		solved += rubix_cube_is_solved(&pContext->cube) ;
+	}
+	bench_sink += solved ;
+}
+
+static void bench_walk_tracked(BenchContext * pContext, size_t iterations) {
+	unsigned long long solved = 0 ;
+	for (size_t i = 0; i < iterations; ++i) {
+		RubixCubeMove move = rubix_cube_generate_move_from_seed(1,i) ;
+		rubix_cube_tracked_apply_move(&pContext->tracked,&move) ;
+		solved += rubix_cube_tracked_is_solved(&pContext->tracked) ;
+	}
+	bench_sink += solved ;
+}
+
+static void bench_zobrist_hash(BenchContext * pContext, size_t iterations) {
+	unsigned long long hash = 0 ;
+	for (size_t i = 0; i < iterations; ++i) {
+		hash ^= rubix_cube_zobrist_hash(&pContext->cube) ;
+		__asm__ volatile("" : : "g"(&pContext->cube) : "memory") ;
+	}
+	bench_sink += hash ;
+}
+
+/* A move with the hash kept up to date, compare with rotate_face and zobrist_hash */
+static void bench_zobrist_rotate_face(BenchContext * pContext, size_t iterations) {
+	RubixCubeHash hash = 0 ;
+	for (size_t i = 0; i < iterations; ++i) hash = rubix_cube_zobrist_rotate_face(&pContext->cube,hash,pContext->side,pContext->rotation) ;
+	bench_sink += hash ;
+}
+
+static void bench_equivelence_check(BenchContext * pContext, size_t iterations) {
+	unsigned long long equal = 0 ;
+	for (size_t i = 0; i < iterations; ++i) {
+		equal += rubix_cube_equivelence_check(&pContext->cube,&pContext->other) ;
+		__asm__ volatile("" : : "g"(&pContext->cube) : "memory") ;
+	}
+	bench_sink += equal ;
+}
+
+static void bench_generate_scrambled(BenchContext * pContext, size_t iterations) {
+	for (size_t i = 0; i < iterations; ++i) {
+		pContext->cube = rubix_cube_generate_scrambled((RubixCubeSeed)i + 1) ;
+		bench_sink += pContext->cube.planes[0][0].sides[0] ;
+	}
+}
+
+/* A cube and a scramble for it made and thrown away, the way the Python shell goes through them */
+static void bench_allocate_malloc(BenchContext * pContext, size_t iterations) {
+	for (size_t i = 0; i < iterations; ++i) {
+		RubixCube * pRubix_cube = rubix_cube_allocate_solved() ;
+		RubixCubeScramble * pScramble = rubix_cube_scramble_allocate((RubixCubeSeed)i + 1,RUBIX_CUBE_SCRAMBLE_INTENSITY) ;
+		bench_sink += pScramble->moves[0].side + pRubix_cube->planes[0][0].sides[0] ;
+		rubix_cube_scramble_free(pScramble) ;
+		rubix_cube_free(pRubix_cube) ;
+	}
+}
+
+static void bench_allocate_pool(BenchContext * pContext, size_t iterations) {
+	for (size_t i = 0; i < iterations; ++i) {
+		RubixCube * pRubix_cube = rubix_cube_pool_cube_solved(pContext->pPool) ;
+		RubixCubeScramble * pScramble = rubix_cube_pool_scramble(pContext->pPool,(RubixCubeSeed)i + 1,RUBIX_CUBE_SCRAMBLE_INTENSITY) ;
+		bench_sink += pScramble->moves[0].side + pRubix_cube->planes[0][0].sides[0] ;
+		rubix_cube_pool_scramble_release(pContext->pPool,pScramble) ;
+		rubix_cube_pool_cube_release(pContext->pPool,pRubix_cube) ;
+	}
+}
+
+/* Back and forth between two points of a long line of moves, 1000 and 1000 - 137 */
+static void bench_journal_rewind(BenchContext * pContext, size_t iterations) {
+	unsigned char codes[137] ;
+
+	rubix_cube_journal_read_codes(pContext->pJournal,1000 - 137,codes,137) ;
+	for (size_t i = 0; i < iterations; ++i) {
+		rubix_cube_journal_rewind(pContext->pJournal,1000 - 137) ;
+		rubix_cube_journal_apply_codes(pContext->pJournal,codes,137) ;
+	}
+	bench_sink += pContext->cube.planes[0][0].sides[0] ;
+}
+
+static void bench_symmetry_canonicalize(BenchContext * pContext, size_t iterations) {
+	RubixCubeFacelets cube = rubix_cube_facelets_from_cube(&pContext->cube), canonical ;
+
+	for (size_t i = 0; i < iterations; ++i) {
+		bench_sink += rubix_cube_symmetry_canonicalize(&canonical,&cube,RUBIX_CUBE_SYMMETRY_COUNT) ;
+	}
+}
+
+static void bench_turn_slice(BenchContext * pContext, size_t iterations) {
+	for (size_t i = 0; i < iterations; ++i) rubix_cube_rotate_slice(&pContext->cube,RUBIX_CUBE_SLICE_M,RUBIX_CUBE_FACE_ROTATION_CLOCKWISE) ;
+	bench_sink += pContext->cube.planes[0][0].sides[0] ;
+}
+
+/* M the way rubix_cube_notation_parse() makes it */
+static void bench_turn_slice_emulated(BenchContext * pContext, size_t iterations) {
+	for (size_t i = 0; i < iterations; ++i) {
+		rubix_cube_rotate_face(&pContext->cube,RUBIX_CUBE_SQUARE_RIGHT,RUBIX_CUBE_FACE_ROTATION_CLOCKWISE) ;
+		rubix_cube_rotate_face(&pContext->cube,RUBIX_CUBE_SQUARE_LEFT,RUBIX_CUBE_FACE_ROTATION_COUNTERCLOCKWISE) ;
+	}
+	bench_sink += pContext->cube.planes[0][0].sides[0] ;
+}
+
+/* A few hand written algorithms with the slices, wide turns and rotations people use */
+static const char bench_turn_replay_text[] = "x2 y r U R' U' M U r' R U R' U' R' F R2 U' R' U' R U R' F' M2 U M2 U2 M2 U M2 "
+		"y' R U R' U' M' U R U' r' F R U R' U' F' z y2 Rw U Rw' U2 M' U M U2 Rw U' Rw' S R2 S' x'" ;
+
+static void bench_turn_replay(BenchContext * pContext, size_t iterations) {
+	unsigned char codes[128] ;
+	size_t count = rubix_cube_notation_parse_codes(codes,sizeof(codes),bench_turn_replay_text,sizeof(bench_turn_replay_text) - 1,
+			RUBIX_CUBE_NOTATION_TURNS,NULL) ;
+
+	for (size_t i = 0; i < iterations; ++i) {
+		RubixCubeFrame frame = rubix_cube_frame_identity ;
+		rubix_cube_apply_turn_codes(&pContext->cube,&frame,codes,count) ;
+		bench_sink += frame.sides[0] ;
+	}
+	bench_sink += pContext->cube.planes[0][0].sides[0] ;
+}
+
+static void bench_turn_replay_emulated(BenchContext * pContext, size_t iterations) {
+	unsigned char codes[256] ;
+	size_t count = rubix_cube_notation_parse_codes(codes,sizeof(codes),bench_turn_replay_text,sizeof(bench_turn_replay_text) - 1,
+			RUBIX_CUBE_NOTATION_EXTENDED,NULL) ;
+
+	for (size_t i = 0; i < iterations; ++i) rubix_cube_apply_move_codes(&pContext->cube,codes,count) ;
+	bench_sink += pContext->cube.planes[0][0].sides[0] ;
+}
+
+/* A default length scramble, which loses about a quarter of its moves */
+static void bench_optimize_codes(BenchContext * pContext, size_t iterations) {
+	unsigned char scramble[RUBIX_CUBE_SCRAMBLE_INTENSITY], codes[RUBIX_CUBE_SCRAMBLE_INTENSITY] ;
+	RubixCubeSeed seed = 36 ;
+
+	rubix_cube_generate_move_codes(scramble,&seed,1,RUBIX_CUBE_SCRAMBLE_INTENSITY) ;
+	for (size_t i = 0; i < iterations; ++i) {
+		size_t count = RUBIX_CUBE_SCRAMBLE_INTENSITY ;
+		memcpy(codes,scramble,sizeof(codes)) ;
+		rubix_cube_optimize_codes(codes,&count) ;
+		bench_sink += count ;
+	}
+}
+
+static unsigned long long bench_service_answered ;
+
+static void bench_service_count(const RubixCubeServiceResponse * pResponse, void * context) {
+	__atomic_add_fetch(&bench_service_answered,1,__ATOMIC_RELAXED) ;
+}
+
+/* Requests of 20 moves each, queued in bursts of up to a batch, from queueing to the last answer */
+static void bench_service_apply(BenchContext * pContext, size_t iterations) {
+	RubixCubeServiceRequest request = { .kind = RUBIX_CUBE_SERVICE_APPLY, .count = 20 } ;
+	RubixCubeSeed seed = 38 ;
+
+	rubix_cube_pack(&request.state,&pContext->cube) ;
+	rubix_cube_generate_move_codes(request.codes,&seed,1,request.count) ;
+	for (size_t i = 0; i < iterations;) {
+		unsigned long long target = __atomic_load_n(&bench_service_answered,__ATOMIC_RELAXED) ;
+		for (size_t k = 0; k < RUBIX_CUBE_SERVICE_BATCH && i < iterations; ++k, ++i) {
+			request.id = i ;
+			target += rubix_cube_service_submit(pContext->pService,&request) ;
+		}
+		while (__atomic_load_n(&bench_service_answered,__ATOMIC_RELAXED) < target) sched_yield() ;
+	}
+}
+
+/* One walk of RUBIX_CUBE_MONKEYS_LENGTH moves per iteration, on the calling thread */
+static void bench_monkeys_walk(BenchContext * pContext, size_t iterations) {
+	RubixCubeMonkeysJob job = { .seed = 37, .walkers = 1, .length = RUBIX_CUBE_MONKEYS_LENGTH, .walks = iterations, .threads = 1 } ;
+	RubixCubeMonkeysSummary summary ;
+
+	if (rubix_cube_monkeys_run(&job,&summary)) bench_sink += summary.moves ;
+}
+
+static void bench_print_ascii(BenchContext * pContext, size_t iterations) {
+	for (size_t i = 0; i < iterations; ++i) rubix_cube_print_ascii(pContext->sink_file,&pContext->cube) ;
+	fflush(pContext->sink_file) ;
+}
+
+static void bench_print_ascii_double(BenchContext * pContext, size_t iterations) {
+	for (size_t i = 0; i < iterations; ++i) rubix_cube_print_ascii_double(pContext->sink_file,&pContext->cube) ;
+	fflush(pContext->sink_file) ;
+}
+
+static void bench_print_face_ascii(BenchContext * pContext, size_t iterations) {
+	for (size_t i = 0; i < iterations; ++i) rubix_cube_print_face_ascii(pContext->sink_file,&pContext->cube,pContext->side) ;
+	fflush(pContext->sink_file) ;
+}
+
+#define BENCH_RENDER_BATCH 	64
+
+/* Into memory only, per cube, compare with print_ascii_double */
+static void bench_render(BenchContext * pContext, size_t iterations) {
+	static char buffer[RUBIX_CUBE_RENDER_MAX_SIZE] ;
+	for (size_t i = 0; i < iterations; ++i) {
+		bench_sink += rubix_cube_render(buffer,sizeof(buffer),RUBIX_CUBE_RENDER_WHOLE_CUBE,&pContext->cube,NULL) ;
+	}
+}
+
+/* BENCH_RENDER_BATCH cubes into one buffer and a single write, per cube */
+static void bench_render_batch(BenchContext * pContext, size_t iterations) {
+	static char buffer[BENCH_RENDER_BATCH * RUBIX_CUBE_RENDER_MAX_SIZE] ;
+	static RubixCube cubes[BENCH_RENDER_BATCH] ;
+	for (size_t i = 0; i < BENCH_RENDER_BATCH; ++i) cubes[i] = pContext->cube ;
+	for (size_t i = 0; i < iterations; i += BENCH_RENDER_BATCH) {
+		size_t size = rubix_cube_render_batch(buffer,sizeof(buffer),RUBIX_CUBE_RENDER_WHOLE_CUBE,cubes,BENCH_RENDER_BATCH,NULL) ;
+		fwrite(buffer,1,size,pContext->sink_file) ;
+	}
+	fflush(pContext->sink_file) ;
+}
+
+#define BENCH_NOTATION_MOVES 	20
+
+/* A line of BENCH_NOTATION_MOVES moves, parsed into the same scramble every time */
+static void bench_notation_parse(BenchContext * pContext, size_t iterations) {
+	static char text[RUBIX_CUBE_NOTATION_FORMAT_SIZE(BENCH_NOTATION_MOVES)] ;
+	static RubixCubeScramble parsed ;
+	size_t size = rubix_cube_notation_format(text,sizeof(text),pContext->pScramble->moves,BENCH_NOTATION_MOVES,0) ;
+	for (size_t i = 0; i < iterations; ++i) {
+		rubix_cube_notation_parse_into(&parsed,text,size,0,NULL) ;
+		bench_sink += parsed.size ;
+	}
+}
+
+static void bench_notation_format(BenchContext * pContext, size_t iterations) {
+	static char text[RUBIX_CUBE_NOTATION_FORMAT_SIZE(BENCH_NOTATION_MOVES)] ;
+	for (size_t i = 0; i < iterations; ++i) {
+		bench_sink += rubix_cube_notation_format(text,sizeof(text),pContext->pScramble->moves,BENCH_NOTATION_MOVES,0) ;
+	}
+}
+
+static int bench_compare_doubles(const void * first, const void * second) {
+	double a = *(const double *)first, b = *(const double *)second ;
+	return (a > b) - (a < b) ;
+}
+
+/* Nearest rank percentile of @count sorted values */
+static double bench_percentile(const double * sorted, size_t count, double percent) {
+	size_t rank = (size_t)(percent / 100.0 * (double)count + 0.999999) ;
+	if (rank < 1) rank = 1 ;
+	if (rank > count) rank = count ;
+	return sorted[rank - 1] ;
+}
+
+/* Warm up @function on @pContext, then time it, return 0 if it was filtered out */
+static int bench_run(BenchResult * pResult, const BenchOptions * pOptions, const char * name, BenchFunction function, BenchContext * pContext) {
+	double samples[BENCH_MAX_REPETITIONS], start, elapsed, mean = 0 ;
+	size_t iterations = 1 ;
+
+	if (pOptions->filter && !strstr(name,pOptions->filter)) return 0 ;
+
+	/* Double the batch until one takes a good part of a sample, running for at least the warm-up time */
+	start = bench_now_ns() ;
+	for (;;) {
+		double before = bench_now_ns() ;
+		function(pContext,iterations) ;
+		elapsed = bench_now_ns() - before ;
+		if (elapsed >= pOptions->sample_ms * 1e6 / 4 && bench_now_ns() - start >= BENCH_WARM_UP_MS * 1e6) break ;
+		if (elapsed < pOptions->sample_ms * 1e6 / 4) iterations *= 2 ;
+	}
+	iterations = (size_t)((double)iterations * pOptions->sample_ms * 1e6 / elapsed) ;
+	if (!iterations) iterations = 1 ;
+
+	for (size_t r = 0; r < pOptions->repetitions; ++r) {
+		double before = bench_now_ns() ;
+		function(pContext,iterations) ;
+		samples[r] = (bench_now_ns() - before) / (double)iterations ;
+		mean += samples[r] ;
+	}
+	qsort(samples,pOptions->repetitions,sizeof(double),bench_compare_doubles) ;
+
+	snprintf(pResult->name,sizeof(pResult->name),"%s",name) ;
+	pResult->iterations = iterations ;
+	pResult->repetitions = pOptions->repetitions ;
+	pResult->min = samples[0] ;
+	pResult->p50 = bench_percentile(samples,pOptions->repetitions,50) ;
+	pResult->p90 = bench_percentile(samples,pOptions->repetitions,90) ;
+	pResult->p99 = bench_percentile(samples,pOptions->repetitions,99) ;
+	pResult->max = samples[pOptions->repetitions - 1] ;
+	pResult->mean = mean / (double)pOptions->repetitions ;
+	pResult->ops_per_second = 1e9 / pResult->p50 ;
+
+	printf("%-36s %12.1f %12.1f %12.1f %12.1f %16.0f\n",pResult->name,pResult->min,pResult->p50,pResult->p90,pResult->p99,pResult->ops_per_second) ;
+	fflush(stdout) ;
+	return 1 ;
+}
+
+static void bench_write_json(FILE * output_file, const BenchResult * results, size_t count, const BenchOptions * pOptions) {
+	fprintf(output_file,"{\n\t\"repetitions\": %zu,\n\t\"sample_ms\": %g,\n\t\"benchmarks\": [\n",pOptions->repetitions,pOptions->sample_ms) ;
+	for (size_t i = 0; i < count; ++i) {
+		const BenchResult * r = &results[i] ;
+		fprintf(output_file,"\t\t{ \"name\": \"%s\", \"iterations\": %zu, \"repetitions\": %zu, "
+				    "\"ns_per_op\": { \"min\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f, \"mean\": %.3f }, "
+				    "\"ops_per_second\": %.1f }%s\n",
+			r->name,r->iterations,r->repetitions,r->min,r->p50,r->p90,r->p99,r->max,r->mean,r->ops_per_second,i + 1 < count ? "," : "") ;
+	}
+	fprintf(output_file,"\t]\n}\n") ;
+}
+
+static int bench_parse_options(BenchOptions * pOptions, int argc, char ** argv) {
+	pOptions->filter = NULL ;
+	pOptions->repetitions = BENCH_DEFAULT_REPETITIONS ;
+	pOptions->sample_ms = BENCH_DEFAULT_SAMPLE_MS ;
+	pOptions->json_path = NULL ;
+
+	for (int i = 1; i < argc; ++i) {
+		if (i + 1 == argc) return 0 ;
+		if (!strcmp(argv[i],"--filter")) pOptions->filter = argv[++i] ;
+		else if (!strcmp(argv[i],"--repetitions")) pOptions->repetitions = strtoul(argv[++i],NULL,10) ;
+		else if (!strcmp(argv[i],"--sample-ms")) pOptions->sample_ms = strtod(argv[++i],NULL) ;
+		else if (!strcmp(argv[i],"--json")) pOptions->json_path = argv[++i] ;
+		else return 0 ;
+	}
+	return pOptions->repetitions > 0 && pOptions->repetitions <= BENCH_MAX_REPETITIONS && pOptions->sample_ms > 0 ;
+}
+
+int main(int argc, char ** argv) {
+	static const char side_names[RUBIX_CUBE_SIDE_COUNT] = { 'U', 'F', 'R', 'L', 'B', 'D' } ;
+	static const char * rotation_names[RUBIX_CUBE_FACE_ROTATION_COUNT] = { "", "'", "2" } ;
+	static const size_t intensities[] = { 1, 10, 50, 200, 1000 } ;
+	static BenchResult results[128] ;
+	char name[BENCH_NAME_SIZE] ;
+	BenchOptions options ;
+	BenchContext context ;
+	RubixCubeServiceOptions service = RUBIX_CUBE_SERVICE_DEFAULT_OPTIONS ;
+	size_t count = 0 ;
+
+	if (!bench_parse_options(&options,argc,argv)) {
+		fprintf(stderr,"usage: %s [--filter <substring>] [--repetitions <1-%d>] [--sample-ms <ms>] [--json <path>]\n",argv[0],BENCH_MAX_REPETITIONS) ;
+		return 1 ;
+	}
+	memset(&context,0,sizeof(context)) ;
+	if (!(context.sink_file = fopen("/dev/null","w"))) {
+		fprintf(stderr,"could not open /dev/null\n") ;
+		return 1 ;
+	}
+
+	printf("%-36s %12s %12s %12s %12s %16s\n","benchmark (ns/op)","min","p50","p90","p99","ops/sec") ;
+
+	for (size_t side = 0; side < RUBIX_CUBE_SIDE_COUNT; ++side) {
+		for (size_t rotation = 0; rotation < RUBIX_CUBE_FACE_ROTATION_COUNT; ++rotation) {
+			context.cube = rubix_cube_generate_solved() ;
+			context.side = (RubixCubeSide)side ;
+			context.rotation = (RubixCubeFaceRotation)rotation ;
+			snprintf(name,sizeof(name),"rotate_face/%c%s",side_names[side],rotation_names[rotation]) ;
+			count += bench_run(&results[count],&options,name,bench_rotate_face,&context) ;
+		}
+	}
+
+	context.side = RUBIX_CUBE_SQUARE_RIGHT ;
+	context.rotation = RUBIX_CUBE_FACE_ROTATION_CLOCKWISE ;
+	count += bench_run(&results[count],&options,"rotate_face_generic/R",bench_rotate_face_generic,&context) ;
+	context.rotation = RUBIX_CUBE_FACE_ROTATION_DOUBLE ;
+	count += bench_run(&results[count],&options,"rotate_face_generic/R2",bench_rotate_face_generic,&context) ;
+	context.rotation = RUBIX_CUBE_FACE_ROTATION_CLOCKWISE ;
+	count += bench_run(&results[count],&options,"unrolled_inline/R",bench_unrolled_right,&context) ;
+	count += bench_run(&results[count],&options,"nxn_rotate_layer/3x3/R",bench_nxn_rotate_3x3,&context) ;
+	count += bench_run(&results[count],&options,"nxn_rotate_layer/7x7/R",bench_nxn_rotate_7x7,&context) ;
+	count += bench_run(&results[count],&options,"nxn_rotate_layer/5x5/slice",bench_nxn_slice_5x5,&context) ;
+
+	for (size_t i = 0; i < sizeof(intensities) / sizeof(intensities[0]); ++i) {
+		context.cube = rubix_cube_generate_solved() ;
+		context.pScramble = rubix_cube_scramble_allocate(i + 1,intensities[i]) ;
+		snprintf(name,sizeof(name),"apply_scramble/%zu",intensities[i]) ;
+		if (context.pScramble) count += bench_run(&results[count],&options,name,bench_apply_scramble,&context) ;
+		rubix_cube_scramble_free(context.pScramble) ;
+		context.pScramble = NULL ;
+	}
+
+	/* A solved cube has to be read all the way through, a scrambled one fails early */
+	context.cube = rubix_cube_generate_solved() ;
+	count += bench_run(&results[count],&options,"is_solved/solved",bench_is_solved,&context) ;
+	context.cube = rubix_cube_generate_scrambled(1) ;
+	count += bench_run(&results[count],&options,"is_solved/scrambled",bench_is_solved,&context) ;
+
+	context.cube = rubix_cube_generate_solved() ;
+	count += bench_run(&results[count],&options,"walk/plain",bench_walk,&context) ;
+	context.tracked = rubix_cube_tracked_generate_solved() ;
+	count += bench_run(&results[count],&options,"walk/tracked",bench_walk_tracked,&context) ;
+
+	context.cube = rubix_cube_generate_scrambled(5) ;
+	count += bench_run(&results[count],&options,"zobrist_hash",bench_zobrist_hash,&context) ;
+	context.side = (RubixCubeSide)(RUBIX_CUBE_SQUARE_RIGHT) ;
+	context.rotation = RUBIX_CUBE_FACE_ROTATION_CLOCKWISE ;
+	count += bench_run(&results[count],&options,"zobrist_rotate_face/R",bench_zobrist_rotate_face,&context) ;
+
+	context.cube = context.other = rubix_cube_generate_scrambled(2) ;
+	count += bench_run(&results[count],&options,"equivelence_check/equal",bench_equivelence_check,&context) ;
+	context.other = rubix_cube_generate_scrambled(3) ;
+	count += bench_run(&results[count],&options,"equivelence_check/different",bench_equivelence_check,&context) ;
+
+	count += bench_run(&results[count],&options,"generate_scrambled",bench_generate_scrambled,&context) ;
+	context.cube = rubix_cube_generate_solved() ;
+	if ((context.pJournal = rubix_cube_journal_allocate(&context.cube,0,0))) {
+		RubixCubeRandom random = rubix_cube_random_generate(3) ;
+		for (size_t i = 0; i < 1000; ++i) {
+			RubixCubeMove move = rubix_cube_generate_random_move_r(&random) ;
+			rubix_cube_journal_apply_move(context.pJournal,&move) ;
+		}
+		count += bench_run(&results[count],&options,"journal/rewind_137_and_replay",bench_journal_rewind,&context) ;
+		rubix_cube_journal_free(context.pJournal) ;
+		context.pJournal = NULL ;
+	}
+
+	/* Close to solved most of the 48 agree with the best so far for longer before losing */
+	context.cube = rubix_cube_generate_scrambled(8) ;
+	count += bench_run(&results[count],&options,"symmetry_canonicalize/scrambled",bench_symmetry_canonicalize,&context) ;
+	context.cube = rubix_cube_generate_solved() ;
+	rubix_cube_rotate_face(&context.cube,RUBIX_CUBE_SQUARE_RIGHT,RUBIX_CUBE_FACE_ROTATION_CLOCKWISE) ;
+	rubix_cube_rotate_face(&context.cube,RUBIX_CUBE_SQUARE_TOP,RUBIX_CUBE_FACE_ROTATION_CLOCKWISE) ;
+	count += bench_run(&results[count],&options,"symmetry_canonicalize/two_moves",bench_symmetry_canonicalize,&context) ;
+
+	context.cube = rubix_cube_generate_scrambled(4) ;
+	count += bench_run(&results[count],&options,"turn/slice",bench_turn_slice,&context) ;
+	count += bench_run(&results[count],&options,"turn/slice_emulated",bench_turn_slice_emulated,&context) ;
+	count += bench_run(&results[count],&options,"turn/replay",bench_turn_replay,&context) ;
+	count += bench_run(&results[count],&options,"turn/replay_emulated",bench_turn_replay_emulated,&context) ;
+
+	count += bench_run(&results[count],&options,"optimize_codes/scramble",bench_optimize_codes,&context) ;
+	count += bench_run(&results[count],&options,"monkeys/walk",bench_monkeys_walk,&context) ;
+	service.callback = bench_service_count ;
+	context.cube = rubix_cube_generate_solved() ;
+	if ((context.pService = rubix_cube_service_start(&service))) {
+		count += bench_run(&results[count],&options,"service/apply",bench_service_apply,&context) ;
+		rubix_cube_service_stop(context.pService) ;
+		context.pService = NULL ;
+	}
+
+	count += bench_run(&results[count],&options,"allocate/malloc",bench_allocate_malloc,&context) ;
+	if ((context.pPool = rubix_cube_pool_allocate(0))) {
+		count += bench_run(&results[count],&options,"allocate/pool",bench_allocate_pool,&context) ;
+		rubix_cube_pool_free(context.pPool) ;
+		context.pPool = NULL ;
+	}
+
+	context.cube = rubix_cube_generate_scrambled(4) ;
+	context.side = (RubixCubeSide)(RUBIX_CUBE_SQUARE_FRONT) ;
+	count += bench_run(&results[count],&options,"print_ascii",bench_print_ascii,&context) ;
+	count += bench_run(&results[count],&options,"print_ascii_double",bench_print_ascii_double,&context) ;
+	count += bench_run(&results[count],&options,"print_face_ascii",bench_print_face_ascii,&context) ;
+	count += bench_run(&results[count],&options,"render/whole_cube",bench_render,&context) ;
+	count += bench_run(&results[count],&options,"render_batch/whole_cube",bench_render_batch,&context) ;
+
+	context.pScramble = rubix_cube_scramble_allocate(1,BENCH_NOTATION_MOVES) ;
+	if (context.pScramble) {
+		count += bench_run(&results[count],&options,"notation_parse/20",bench_notation_parse,&context) ;
+		count += bench_run(&results[count],&options,"notation_format/20",bench_notation_format,&context) ;
+	}
+	rubix_cube_scramble_free(context.pScramble) ;
+	context.pScramble = NULL ;
+
+	fclose(context.sink_file) ;
+
+	if (options.json_path) {
+		FILE * json_file = fopen(options.json_path,"w") ;
+		if (!json_file) {
+			fprintf(stderr,"could not write %s\n",options.json_path) ;
+			return 1 ;
+		}
+		bench_write_json(json_file,results,count,&options) ;
+		fclose(json_file) ;
+	}
+	return 0 ;
+}
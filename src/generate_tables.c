@@ -0,0 +1,106 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Build every solver table once and save it, so that later runs can map the
+ * files instead of building them:
+ *
+ * 	generate_tables <directory> [threads]
+ *
+ * Point RUBIX_CUBE_TABLES at <directory> to have the solvers pick them up.
+ */
+
+#include "rubix_cube_solver.h"
+#include "rubix_cube_two_phase.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static double generate_tables_seconds(const struct timespec * start) {
+	struct timespec now ;
+	clock_gettime(CLOCK_MONOTONIC,&now) ;
+	return (double)(now.tv_sec - start->tv_sec) + (double)(now.tv_nsec - start->tv_nsec) / 1e9 ;
+}
+
+/* Map @path back and check every byte of it made it to disk */
+static int generate_tables_verify(const char * path, RubixCubeTableKind kind) {
+	RubixCubeTableMapping mapping ;
+	int success ;
+
+	if (!rubix_cube_table_map(&mapping,path,kind,NULL,0)) return 0 ;
+	success = rubix_cube_table_verify(&mapping) ;
+	rubix_cube_table_unmap(&mapping) ;
+	return success ;
+}
+
+int main(int argc, char ** argv) {
+	const unsigned char corners[] = {
+		RUBIX_CUBE_CORNER_URF, RUBIX_CUBE_CORNER_UFL, RUBIX_CUBE_CORNER_ULB, RUBIX_CUBE_CORNER_UBR,
+		RUBIX_CUBE_CORNER_DFR, RUBIX_CUBE_CORNER_DLF, RUBIX_CUBE_CORNER_DBL, RUBIX_CUBE_CORNER_DRB
+	} ;
+	const unsigned char first_edges[] = {
+		RUBIX_CUBE_EDGE_UR, RUBIX_CUBE_EDGE_UF, RUBIX_CUBE_EDGE_UL, RUBIX_CUBE_EDGE_UB, RUBIX_CUBE_EDGE_DR, RUBIX_CUBE_EDGE_DF
+	} ;
+	const unsigned char second_edges[] = {
+		RUBIX_CUBE_EDGE_DL, RUBIX_CUBE_EDGE_DB, RUBIX_CUBE_EDGE_FR, RUBIX_CUBE_EDGE_FL, RUBIX_CUBE_EDGE_BL, RUBIX_CUBE_EDGE_BR
+	} ;
+	const struct { RubixCubePieceKind kind ; const unsigned char * pieces ; size_t count ; } databases[] = {
+		{ RUBIX_CUBE_PIECE_KIND_CORNER, corners, sizeof(corners) },
+		{ RUBIX_CUBE_PIECE_KIND_EDGE, first_edges, sizeof(first_edges) },
+		{ RUBIX_CUBE_PIECE_KIND_EDGE, second_edges, sizeof(second_edges) }
+	} ;
+	char path[RUBIX_CUBE_SOLVER_PATH_SIZE] ;
+	struct timespec start ;
+	size_t threads = 0 ;
+
+	if (argc < 2 || argc > 3) {
+		fprintf(stderr,"usage: %s <directory> [threads]\n",argv[0]) ;
+		return 1 ;
+	}
+	if (argc == 3) threads = strtoul(argv[2],NULL,10) ;
+
+	/* Same databases as rubix_cube_solver_allocate_default(), in the same order */
+	for (size_t i = 0; i < sizeof(databases) / sizeof(databases[0]); ++i) {
+		RubixCubePatternDatabase * pDatabase = rubix_cube_pattern_allocate_empty(databases[i].kind,databases[i].pieces,databases[i].count) ;
+		if (!pDatabase) {
+			fprintf(stderr,"out of memory\n") ;
+			return 1 ;
+		}
+
+		clock_gettime(CLOCK_MONOTONIC,&start) ;
+		rubix_cube_pattern_build_threads(pDatabase,threads) ;
+		snprintf(path,sizeof(path),"%s/" RUBIX_CUBE_SOLVER_TABLE_NAME,argv[1],i) ;
+		if (!rubix_cube_pattern_save(pDatabase,path) || !generate_tables_verify(path,RUBIX_CUBE_TABLE_KIND_PATTERN)) {
+			fprintf(stderr,"could not write %s\n",path) ;
+			rubix_cube_pattern_free(pDatabase) ;
+			return 1 ;
+		}
+		printf("%s: %zu entries, depth %zu, %.1f s\n",path,pDatabase->size,pDatabase->depth,generate_tables_seconds(&start)) ;
+		rubix_cube_pattern_free(pDatabase) ;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC,&start) ;
+	snprintf(path,sizeof(path),"%s/" RUBIX_CUBE_TWO_PHASE_TABLE_NAME,argv[1]) ;
+	if (!rubix_cube_two_phase_save(path) || !generate_tables_verify(path,RUBIX_CUBE_TABLE_KIND_TWO_PHASE)) {
+		fprintf(stderr,"could not write %s\n",path) ;
+		return 1 ;
+	}
+	printf("%s: %.1f s\n",path,generate_tables_seconds(&start)) ;
+
+	return 0 ;
+}
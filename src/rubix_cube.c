@@ -16,9 +16,13 @@
     LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
 */
 #include "rubix_cube.h"
+#include "rubix_cube_stats.h"
+#include "rubix_cube_render.h"
+#include "rubix_cube_unrolled.h"
 #include <stdlib.h>
 #include <time.h>
 #include <assert.h>
+#include <string.h>
 
 const char RUBIX_CUBE_COLOR_CHARS[] = {
 	'X', /* NULL */
@@ -46,6 +50,32 @@ const char * RUBIX_CUBE_FACE_ROTATION_STRINGS[] = {
 	"Double"
 } ;
 
+/* Solved piece at [@plane][@index]: a side shows its color if the piece is on that side of the cube */
+#define RUBIX_CUBE_SOLVED_PIECE(plane, index) \
+	{ .sides = { \
+		(index) / 3 == 0 	? RUBIX_CUBE_COLOR_WHITE 	: RUBIX_CUBE_COLOR_NULL, \
+		(plane) == 0 		? RUBIX_CUBE_COLOR_RED 		: RUBIX_CUBE_COLOR_NULL, \
+		(index) % 3 == 2 	? RUBIX_CUBE_COLOR_BLUE 	: RUBIX_CUBE_COLOR_NULL, \
+		(index) % 3 == 0 	? RUBIX_CUBE_COLOR_GREEN 	: RUBIX_CUBE_COLOR_NULL, \
+		(plane) == 2 		? RUBIX_CUBE_COLOR_ORANGE 	: RUBIX_CUBE_COLOR_NULL, \
+		(index) / 3 == 2 	? RUBIX_CUBE_COLOR_YELLOW 	: RUBIX_CUBE_COLOR_NULL  \
+	} }
+
+#define RUBIX_CUBE_SOLVED_PLANE(plane) { \
+		RUBIX_CUBE_SOLVED_PIECE(plane,0), RUBIX_CUBE_SOLVED_PIECE(plane,1), RUBIX_CUBE_SOLVED_PIECE(plane,2), \
+		RUBIX_CUBE_SOLVED_PIECE(plane,3), RUBIX_CUBE_SOLVED_PIECE(plane,4), RUBIX_CUBE_SOLVED_PIECE(plane,5), \
+		RUBIX_CUBE_SOLVED_PIECE(plane,6), RUBIX_CUBE_SOLVED_PIECE(plane,7), RUBIX_CUBE_SOLVED_PIECE(plane,8)  \
+	}
+
+/* Same as RUBIX_CUBE_IDENTITY, but built once at compile time rather than on the stack per use */
+const RubixCube rubix_cube_solved = {
+	.planes = {
+		RUBIX_CUBE_SOLVED_PLANE(0),
+		RUBIX_CUBE_SOLVED_PLANE(1),
+		RUBIX_CUBE_SOLVED_PLANE(2)
+	}
+} ;
+
 RubixCube rubix_cube_generate_solved(void) {
 	return RUBIX_CUBE_SOLVED_LITERAL ;	
 }
@@ -88,231 +118,40 @@ RubixCubeFace rubix_cube_get_face_of_side(RubixCube * pRubix_cube, RubixCubeSide
 }
 
 
-const char rubix_cube_face_format_string[] =
- "+---+---+---+\n"
- "| %c | %c | %c |\n"
- "+---+---+---+\n"
- "| %c | %c | %c |\n"
- "+---+---+---+\n"
- "| %c | %c | %c |\n"
- "+---+---+---+\n" ;
-
-const char rubix_cube_half_cube_format_string[] =
- " ====Rubix cube====\n"
- "        +--+--+--+\n"
- "  TOP  / %c/ %c/ %c/|\n"
- "      +--+--+--+ |\n"
- "     / %c/ %c/ %c/| |\n"
- "    +--+--+--+ |%c|	\n"
- "   / %c/ %c/ %c/|%c|/|   RIGHT\n"
- "  +--+--+--+%c|/|%c/ \n"
- "  | %c| %c| %c|/|%c|/|      	\n"
- "  +--+--+--+%c|/|%c|      2 \n"
- "  | %c| %c| %c|/|%c|/           _.\n"
- "  +--+--+--+%c|/        1    /|\n"
- "  | %c| %c| %c| /             /  \n"
- "  +--+--+--+^         0   / Direction of array of rubix cube face arrays\n"
- "      FRONT \n"
- " \n"
- " \n" ;
+/* Room for any single cube rendering, in any layout */
+#define RUBIX_CUBE_PRINT_BUFFER_SIZE 	RUBIX_CUBE_RENDER_MAX_SIZE
 
 void rubix_cube_print_ascii(FILE * output_file, RubixCube * pRubix_cube) {
-
-	RubixCubeFace top_face = rubix_cube_get_face_of_side(pRubix_cube,RUBIX_CUBE_SQUARE_TOP) ;
-	RubixCubeFace front_face = rubix_cube_get_face_of_side(pRubix_cube,RUBIX_CUBE_SQUARE_FRONT) ;
-	RubixCubeFace right_face = rubix_cube_get_face_of_side(pRubix_cube,RUBIX_CUBE_SQUARE_RIGHT) ;
-
-	fprintf(output_file,rubix_cube_half_cube_format_string,
-		/* begin top face */
-		rubix_cube_get_char_of_color(top_face.squares[0]),
-		rubix_cube_get_char_of_color(top_face.squares[1]),
-		rubix_cube_get_char_of_color(top_face.squares[2]),
-		rubix_cube_get_char_of_color(top_face.squares[3]),
-		rubix_cube_get_char_of_color(top_face.squares[4]),
-		rubix_cube_get_char_of_color(top_face.squares[5]),
-		/* begin right face (mixed in) */
-		rubix_cube_get_char_of_color(right_face.squares[2]),
-		rubix_cube_get_char_of_color(top_face.squares[6]),
-		rubix_cube_get_char_of_color(top_face.squares[7]),
-		rubix_cube_get_char_of_color(top_face.squares[8]),
-		rubix_cube_get_char_of_color(right_face.squares[1]),
-		rubix_cube_get_char_of_color(right_face.squares[0]),
-		rubix_cube_get_char_of_color(right_face.squares[5]),
-		/* begin front face */
-		rubix_cube_get_char_of_color(front_face.squares[0]),
-		rubix_cube_get_char_of_color(front_face.squares[1]),
-		rubix_cube_get_char_of_color(front_face.squares[2]),
-		rubix_cube_get_char_of_color(right_face.squares[4]),
-		rubix_cube_get_char_of_color(right_face.squares[3]),
-		rubix_cube_get_char_of_color(right_face.squares[8]),
-		rubix_cube_get_char_of_color(front_face.squares[3]),
-		rubix_cube_get_char_of_color(front_face.squares[4]),
-		rubix_cube_get_char_of_color(front_face.squares[5]),
-		rubix_cube_get_char_of_color(right_face.squares[7]),
-		rubix_cube_get_char_of_color(right_face.squares[6]),
-		rubix_cube_get_char_of_color(front_face.squares[6]),
-		rubix_cube_get_char_of_color(front_face.squares[7]),
-		rubix_cube_get_char_of_color(front_face.squares[8])
-	) ;
-
+	char buffer[RUBIX_CUBE_PRINT_BUFFER_SIZE] ;
+	fwrite(buffer,1,rubix_cube_render(buffer,sizeof(buffer),RUBIX_CUBE_RENDER_HALF_CUBE,pRubix_cube,NULL),output_file) ;
 }
 
-const char rubix_cube_whole_cube_format_string[] =
- " ==========================[The Rubix Cube]==========================\n"
- "        +--+--+--+                       +--+--+--+                  \n"
- "  TOP  / %c/ %c/ %c/|            BOTTOM    / %c/ %c/ %c/|            \n"
- "      +--+--+--+ |                     +--+--+--+ |                  \n"
- "     / %c/ %c/ %c/| |                    / %c/ %c/ %c/| |            \n"
- "    +--+--+--+ |%c|	             +--+--+--+ |%c|	               \n"
- "   / %c/ %c/ %c/|%c|/|   RIGHT          / %c/ %c/ %c/|%c|/|   BACK   \n"
- "  +--+--+--+%c|/|%c/                 +--+--+--+%c|/|%c/              \n"
- "  | %c| %c| %c|/|%c|/|      	   | %c| %c| %c|/|%c|/|      	       \n"
- "  +--+--+--+%c|/|%c|      2          +--+--+--+%c|/|%c|              \n"
- "  | %c| %c| %c|/|%c|/           _.     | %c| %c| %c|/|%c|/           \n"
- "  +--+--+--+%c|/        1    /|     +--+--+--+%c|/                   \n"
- "  | %c| %c| %c| /             /       | %c| %c| %c| /                \n"
- "  +--+--+--+^         0   /        +--+--+--+^        0  1  2        \n"
- "      FRONT                              LEFT       ------->         \n"
- "                                                                     \n"
- " ====================================================================\n"
- "                                                                     \n" ;
-
 void rubix_cube_print_ascii_double(FILE * output_file, RubixCube * pRubix_cube) {
-
-	RubixCubeFace top_face = rubix_cube_get_face_of_side(pRubix_cube,RUBIX_CUBE_SQUARE_TOP) ;
-	RubixCubeFace front_face = rubix_cube_get_face_of_side(pRubix_cube,RUBIX_CUBE_SQUARE_FRONT) ;
-	RubixCubeFace right_face = rubix_cube_get_face_of_side(pRubix_cube,RUBIX_CUBE_SQUARE_RIGHT) ;
-	RubixCubeFace left_face = rubix_cube_get_face_of_side(pRubix_cube,RUBIX_CUBE_SQUARE_LEFT) ;
-	RubixCubeFace back_face = rubix_cube_get_face_of_side(pRubix_cube,RUBIX_CUBE_SQUARE_BACK) ;
-	RubixCubeFace bottom_face = rubix_cube_get_face_of_side(pRubix_cube,RUBIX_CUBE_SQUARE_BOTTOM) ;
-
-	(void)back_face, (void)left_face ;
-
-	fprintf(output_file,rubix_cube_whole_cube_format_string,
-		/* LINE 0 */
-		/* begin top face */
-		rubix_cube_get_char_of_color(top_face.squares[0]),
-		rubix_cube_get_char_of_color(top_face.squares[1]),
-		rubix_cube_get_char_of_color(top_face.squares[2]),
-
-		/* begin bottom face */
-		rubix_cube_get_char_of_color(bottom_face.squares[2]),
-		rubix_cube_get_char_of_color(bottom_face.squares[5]),
-		rubix_cube_get_char_of_color(bottom_face.squares[8]),
-		/* LINE 1 */
-
-		rubix_cube_get_char_of_color(top_face.squares[3]),
-		rubix_cube_get_char_of_color(top_face.squares[4]),
-		rubix_cube_get_char_of_color(top_face.squares[5]),
-
-		rubix_cube_get_char_of_color(bottom_face.squares[1]),
-		rubix_cube_get_char_of_color(bottom_face.squares[4]),
-		rubix_cube_get_char_of_color(bottom_face.squares[7]),
-
-		/* LINE 2 */
-		/* begin right & left face (mixed in) */
-		rubix_cube_get_char_of_color(right_face.squares[2]),
-		rubix_cube_get_char_of_color(back_face.squares[6]),
-
-		/* LINE 3 */
-		rubix_cube_get_char_of_color(top_face.squares[6]),
-		rubix_cube_get_char_of_color(top_face.squares[7]),
-		rubix_cube_get_char_of_color(top_face.squares[8]),
-		rubix_cube_get_char_of_color(right_face.squares[1]),
-
-		rubix_cube_get_char_of_color(bottom_face.squares[0]),
-		rubix_cube_get_char_of_color(bottom_face.squares[3]),
-		rubix_cube_get_char_of_color(bottom_face.squares[6]),
-		rubix_cube_get_char_of_color(back_face.squares[1]),
-
-		/* LINE 4 */
-		rubix_cube_get_char_of_color(right_face.squares[0]),
-		rubix_cube_get_char_of_color(right_face.squares[5]),
-
-		rubix_cube_get_char_of_color(back_face.squares[3]),
-		rubix_cube_get_char_of_color(back_face.squares[8]),
-
-		/* LINE 5 */
-		/* begin front face */
-		rubix_cube_get_char_of_color(front_face.squares[0]),
-		rubix_cube_get_char_of_color(front_face.squares[1]),
-		rubix_cube_get_char_of_color(front_face.squares[2]),
-		rubix_cube_get_char_of_color(right_face.squares[4]),
-
-		rubix_cube_get_char_of_color(left_face.squares[8]),
-		rubix_cube_get_char_of_color(left_face.squares[7]),
-		rubix_cube_get_char_of_color(left_face.squares[6]),
-		rubix_cube_get_char_of_color(back_face.squares[4]),
-
-		/* LINE 6 */
-		rubix_cube_get_char_of_color(right_face.squares[3]),
-		rubix_cube_get_char_of_color(right_face.squares[8]),
-
-		rubix_cube_get_char_of_color(back_face.squares[0]),
-		rubix_cube_get_char_of_color(back_face.squares[5]),
-
-		/* LINE 7 */
-		rubix_cube_get_char_of_color(front_face.squares[3]),
-		rubix_cube_get_char_of_color(front_face.squares[4]),
-		rubix_cube_get_char_of_color(front_face.squares[5]),
-		rubix_cube_get_char_of_color(right_face.squares[7]),
-
-		rubix_cube_get_char_of_color(left_face.squares[5]),
-		rubix_cube_get_char_of_color(left_face.squares[4]),
-		rubix_cube_get_char_of_color(left_face.squares[3]),
-		rubix_cube_get_char_of_color(back_face.squares[5]),
-
-		/* LINE 8 */
-		rubix_cube_get_char_of_color(right_face.squares[6]),
-
-		rubix_cube_get_char_of_color(back_face.squares[2]),
-		
-		/* LINE 9 */
-		rubix_cube_get_char_of_color(front_face.squares[6]),
-		rubix_cube_get_char_of_color(front_face.squares[7]),
-		rubix_cube_get_char_of_color(front_face.squares[8]),
-
-		rubix_cube_get_char_of_color(left_face.squares[2]),
-		rubix_cube_get_char_of_color(left_face.squares[1]),
-		rubix_cube_get_char_of_color(left_face.squares[0])
-
-	) ;
-
+	char buffer[RUBIX_CUBE_PRINT_BUFFER_SIZE] ;
+	fwrite(buffer,1,rubix_cube_render(buffer,sizeof(buffer),RUBIX_CUBE_RENDER_WHOLE_CUBE,pRubix_cube,NULL),output_file) ;
 }
-#define RUBIX_CUBE_FACE_TO_PRINTF_ARGS(rubix_cube_face_id) \
-	rubix_cube_get_char_of_color(rubix_cube_face_id.squares[0]), \
-	rubix_cube_get_char_of_color(rubix_cube_face_id.squares[1]), \
-	rubix_cube_get_char_of_color(rubix_cube_face_id.squares[2]), \
-	rubix_cube_get_char_of_color(rubix_cube_face_id.squares[3]), \
-	rubix_cube_get_char_of_color(rubix_cube_face_id.squares[4]), \
-	rubix_cube_get_char_of_color(rubix_cube_face_id.squares[5]), \
-	rubix_cube_get_char_of_color(rubix_cube_face_id.squares[6]), \
-	rubix_cube_get_char_of_color(rubix_cube_face_id.squares[7]), \
-	rubix_cube_get_char_of_color(rubix_cube_face_id.squares[8])
 
 void rubix_cube_print_all_faces_ascii(FILE * output_file, RubixCube * pRubix_cube) {
-	printf("Top face:\n") ;
-	rubix_cube_print_face_ascii(stdout,pRubix_cube,RUBIX_CUBE_SQUARE_TOP) ;
-	printf("Front face:\n") ;
-	rubix_cube_print_face_ascii(stdout,pRubix_cube,RUBIX_CUBE_SQUARE_FRONT) ;
-	printf("Right face:\n") ;
-	rubix_cube_print_face_ascii(stdout,pRubix_cube,RUBIX_CUBE_SQUARE_RIGHT) ;
-	printf("Left face:\n") ;
-	rubix_cube_print_face_ascii(stdout,pRubix_cube,RUBIX_CUBE_SQUARE_LEFT) ;
-	printf("Back face:\n") ;
-	rubix_cube_print_face_ascii(stdout,pRubix_cube,RUBIX_CUBE_SQUARE_BACK) ;
-	printf("Bottom face:\n") ;
-	rubix_cube_print_face_ascii(stdout,pRubix_cube,RUBIX_CUBE_SQUARE_BOTTOM) ;
+	char buffer[RUBIX_CUBE_PRINT_BUFFER_SIZE] ;
+	fwrite(buffer,1,rubix_cube_render_all_faces(buffer,sizeof(buffer),pRubix_cube,NULL),output_file) ;
 }
 
 void rubix_cube_print_face_ascii(FILE * output_file, RubixCube * pRubix_cube, RubixCubeSide side) {
-	RubixCubeFace face = rubix_cube_get_face_of_side(pRubix_cube,side) ;
-	fprintf(output_file,rubix_cube_face_format_string,
-		RUBIX_CUBE_FACE_TO_PRINTF_ARGS(face) ) ;
+	/* An invalid side shows up as RUBIX_CUBE_FACE_NULL, a face of null colors */
+	static const RubixCube null_cube ;
+	char buffer[RUBIX_CUBE_PRINT_BUFFER_SIZE] ;
+
+	if ((size_t)side >= RUBIX_CUBE_SIDE_COUNT) {
+		pRubix_cube = (RubixCube *)&null_cube ;
+		side = (RubixCubeSide)(RUBIX_CUBE_SQUARE_TOP) ;
+	}
+	fwrite(buffer,1,rubix_cube_render(buffer,sizeof(buffer),RUBIX_CUBE_RENDER_LAYOUT_FACE(side),pRubix_cube,NULL),output_file) ;
 }
 
 RubixCube * rubix_cube_allocate_solved() {
 	RubixCube * new_cube = (RubixCube*)malloc(sizeof(RubixCube)) ;
+	RUBIX_CUBE_STATS_ADD(allocations,1) ;
+	RUBIX_CUBE_STATS_ADD(allocation_bytes,sizeof(RubixCube)) ;
 	if (!new_cube) {
 		printf("RubixCube allocation failed!\n") ;
 	} else {
@@ -498,6 +337,7 @@ void rubix_cube_rotate_piece(RubixCubePiece * piece, RubixCubeRotation rotation)
 
 void rubix_cube_rotate_piece_quadset(RubixCubePiece * piece_quadset[], RubixCubeRotationQuadset set_rotation, RubixCubeRotation piece_rotation) {
 	int repititions = 0 ;
+	RUBIX_CUBE_STATS_ADD(rotate_piece_quadset,1) ;
 	/* for(int i = 0; i < 4; i++) { */
 	/* 	rubix_cube_print_piece(*piece_quadset[i]) ; */
 	/* 	printf("---\n") ; */
@@ -557,6 +397,8 @@ void rubix_cube_rotate_front_face(RubixCube * pRubix_cube, RubixCubeFaceRotation
 			piece_rotation = RUBIX_CUBE_ROTATE_CLOCKWISE ;
 			set_rotation = RUBIX_CUBE_ROTATE_QUADSET_FULL ;
 			break ;
+		default:
+			return ;
 	}
 
 	RubixCubePiece * corner_piece_quadset[RUBIX_CUBE_PIECES_PER_QUADSET] = {
@@ -593,6 +435,8 @@ void rubix_cube_rotate_top_face(RubixCube * pRubix_cube, RubixCubeFaceRotation f
 			piece_rotation = RUBIX_CUBE_ROTATE_RIGHT ;
 			set_rotation = RUBIX_CUBE_ROTATE_QUADSET_FULL ;
 			break ;
+		default:
+			return ;
 	}
 
 	RubixCubePiece * corner_piece_quadset[RUBIX_CUBE_PIECES_PER_QUADSET] = {
@@ -683,144 +527,36 @@ int rubix_cube_equivelence_check(RubixCube * first, RubixCube * second) {
  * Will break early if early squares do not match
  */
 inline int rubix_cube_is_solved(RubixCube * pRubix_cube) {
-	return rubix_cube_equivelence_check(pRubix_cube,&RUBIX_CUBE_IDENTITY) ;
+	return rubix_cube_equivelence_check(pRubix_cube,(RubixCube *)&rubix_cube_solved) ;
 }
 
+size_t rubix_cube_count_solved(RubixCube * cubes, size_t count, unsigned char * results) {
+	size_t solved = 0 ;
 
-RubixCubeFaceRotationData rubix_cube_rotation_table[RUBIX_CUBE_SIDE_COUNT] = {
-	/* TOP */
-	{
-		.corner_quadset = {
-			{ 2, 0 },
-			{ 2, 2 },
-			{ 0, 0 },
-			{ 0, 2 }
-
-		},
-		.side_quadset = {
-			{ 2, 1 },
-			{ 1, 2 },
-			{ 1, 0 },
-			{ 0, 1 }
-		},
-		.subrotation_set = {
-			{ RUBIX_CUBE_ROTATE_QUADSET_RIGHT, RUBIX_CUBE_ROTATE_LEFT },
-			{ RUBIX_CUBE_ROTATE_QUADSET_LEFT, RUBIX_CUBE_ROTATE_RIGHT },
-			{ RUBIX_CUBE_ROTATE_QUADSET_FULL, RUBIX_CUBE_ROTATE_RIGHT }
-		}
-	},
-	/* FRONT */
-	{
-		.corner_quadset = {
-			{ 0, 0 },
-			{ 0, 2 },
-			{ 0, 6 },
-			{ 0, 8 }
-
-		},
-		.side_quadset = {
-			{ 0, 1 },
-			{ 0, 5 },
-			{ 0, 3 },
-			{ 0, 7 }
-		},
-		.subrotation_set = {
-			{ RUBIX_CUBE_ROTATE_QUADSET_RIGHT, RUBIX_CUBE_ROTATE_CLOCKWISE },
-			{ RUBIX_CUBE_ROTATE_QUADSET_LEFT, RUBIX_CUBE_ROTATE_COUNTERCLOCKWISE },
-			{ RUBIX_CUBE_ROTATE_QUADSET_FULL, RUBIX_CUBE_ROTATE_COUNTERCLOCKWISE }
-		}
-	},
-	/* RIGHT */
-	{
-		.corner_quadset = {
-			{ 0, 2 },
-			{ 2, 2 },
-			{ 0, 8 },
-			{ 2, 8 }
-
-		},
-		.side_quadset = {
-			{ 1, 2 },
-			{ 2, 5 },
-			{ 0, 5 },
-			{ 1, 8 }
-		},
-		.subrotation_set = {
-			{ RUBIX_CUBE_ROTATE_QUADSET_RIGHT, RUBIX_CUBE_ROTATE_UP },
-			{ RUBIX_CUBE_ROTATE_QUADSET_LEFT, RUBIX_CUBE_ROTATE_DOWN },
-			{ RUBIX_CUBE_ROTATE_QUADSET_FULL, RUBIX_CUBE_ROTATE_DOWN }
-		}
-	},
-	/* RIGHT */
-	{
-		.corner_quadset = {
-			{ 2, 0 },
-			{ 0, 0 },
-			{ 2, 6 },
-			{ 0, 6 }
-
-		},
-		.side_quadset = {
-			{ 1, 0 },
-			{ 0, 3 },
-			{ 2, 3 },
-			{ 1, 6 }
-		},
-		.subrotation_set = {
-			{ RUBIX_CUBE_ROTATE_QUADSET_RIGHT, RUBIX_CUBE_ROTATE_DOWN },
-			{ RUBIX_CUBE_ROTATE_QUADSET_LEFT, RUBIX_CUBE_ROTATE_UP },
-			{ RUBIX_CUBE_ROTATE_QUADSET_FULL, RUBIX_CUBE_ROTATE_UP }
-		}
-	},
-	/* BACK */
-	{
-		.corner_quadset = {
-			{ 2, 2 },
-			{ 2, 0 },
-			{ 2, 8 },
-			{ 2, 6 }
-
-		},
-		.side_quadset = {
-			{ 2, 1 },
-			{ 2, 3 },
-			{ 2, 5 },
-			{ 2, 7 }
-		},
-		.subrotation_set = {
-			{ RUBIX_CUBE_ROTATE_QUADSET_RIGHT, RUBIX_CUBE_ROTATE_COUNTERCLOCKWISE },
-			{ RUBIX_CUBE_ROTATE_QUADSET_LEFT, RUBIX_CUBE_ROTATE_CLOCKWISE },
-			{ RUBIX_CUBE_ROTATE_QUADSET_FULL, RUBIX_CUBE_ROTATE_CLOCKWISE }
-		}
-	},
-	/* BOTTOM */
-	{
-		.corner_quadset = {
-			{ 0, 6 },
-			{ 0, 8 },
-			{ 2, 6 },
-			{ 2, 8 }
-
-		},
-		.side_quadset = {
-			{ 0, 7 },
-			{ 1, 8 },
-			{ 1, 6 },
-			{ 2, 7 }
-		},
-		.subrotation_set = {
-			{ RUBIX_CUBE_ROTATE_QUADSET_RIGHT, RUBIX_CUBE_ROTATE_RIGHT },
-			{ RUBIX_CUBE_ROTATE_QUADSET_LEFT, RUBIX_CUBE_ROTATE_LEFT },
-			{ RUBIX_CUBE_ROTATE_QUADSET_FULL, RUBIX_CUBE_ROTATE_LEFT }
-		}
+	for (size_t i = 0; i < count; ++i) {
+		int is_solved = !memcmp(&cubes[i],&rubix_cube_solved,sizeof(RubixCube)) ;
+		if (results) results[i] = (unsigned char)is_solved ;
+		solved += is_solved ;
 	}
+	return solved ;
+}
+
 
+/* From RUBIX_CUBE_FACE_ROTATIONS() in rubix_cube.h, which the unrolled turns are made from as well */
+RubixCubeFaceRotationData rubix_cube_rotation_table[RUBIX_CUBE_SIDE_COUNT] = {
+	RUBIX_CUBE_FACE_ROTATIONS(RUBIX_CUBE_FACE_ROTATION_DATA)
 } ;
-/* Generic face rotate */
-void rubix_cube_rotate_face(RubixCube * pRubix_cube, RubixCubeSide side, RubixCubeFaceRotation face_rotation) {
 
-	RubixCubePieceReference * corner_refs  = rubix_cube_rotation_table[side].corner_quadset ;
-	RubixCubePieceReference * side_refs = rubix_cube_rotation_table[side].side_quadset ;
+/* A slice is the layer next to the face it turns like, so its quadsets are that face's one layer in: */
+/* M from L a column right, E from D a row up and S from F a plane back */
+RubixCubeFaceRotationData rubix_cube_slice_rotation_table[RUBIX_CUBE_SLICE_COUNT] = {
+	RUBIX_CUBE_SLICE_ROTATIONS(RUBIX_CUBE_FACE_ROTATION_DATA)
+} ;
+
+/* Turn both quadsets of @data, for a face or a slice alike */
+static inline void rubix_cube_rotate_quadsets(RubixCube * pRubix_cube, const RubixCubeFaceRotationData * data, RubixCubeFaceRotation face_rotation) {
+	const RubixCubePieceReference * corner_refs  = data->corner_quadset ;
+	const RubixCubePieceReference * side_refs = data->side_quadset ;
 
 	RubixCubePiece * corner_piece_quadset[RUBIX_CUBE_PIECES_PER_QUADSET] = {
 			&pRubix_cube->planes[corner_refs[0].plane][corner_refs[0].index],
@@ -837,30 +573,60 @@ void rubix_cube_rotate_face(RubixCube * pRubix_cube, RubixCubeSide side, RubixCu
 	} ;
 
 	rubix_cube_rotate_piece_quadset(corner_piece_quadset,
-			rubix_cube_rotation_table[side].subrotation_set[face_rotation].set_rotation,
-			rubix_cube_rotation_table[side].subrotation_set[face_rotation].piece_rotation
+			data->subrotation_set[face_rotation].set_rotation,
+			data->subrotation_set[face_rotation].piece_rotation
 	) ;
 
 	rubix_cube_rotate_piece_quadset(side_piece_quadset,
-			rubix_cube_rotation_table[side].subrotation_set[face_rotation].set_rotation,
-			rubix_cube_rotation_table[side].subrotation_set[face_rotation].piece_rotation
+			data->subrotation_set[face_rotation].set_rotation,
+			data->subrotation_set[face_rotation].piece_rotation
 	) ;
 }
 
-inline void rubix_cube_apply_move(RubixCube * pRubixCube, RubixCubeMove * move) {
+/* Generic face rotate, by the unrolled turn of rubix_cube_unrolled.h made from rubix_cube_rotation_table */
+void rubix_cube_rotate_face(RubixCube * pRubix_cube, RubixCubeSide side, RubixCubeFaceRotation face_rotation) {
+	RUBIX_CUBE_STATS_TIMER_START(start) ;
+	RUBIX_CUBE_STATS_ADD(rotate_face[side],1) ;
+
+	rubix_cube_unrolled_rotate_face(pRubix_cube,side,face_rotation) ;
+	RUBIX_CUBE_STATS_TIMER_STOP(start,rotate_face_cycles[side]) ;
+}
+
+void rubix_cube_rotate_face_generic(RubixCube * pRubix_cube, RubixCubeSide side, RubixCubeFaceRotation face_rotation) {
+	rubix_cube_rotate_quadsets(pRubix_cube,&rubix_cube_rotation_table[side],face_rotation) ;
+}
+
+void rubix_cube_rotate_slice(RubixCube * pRubix_cube, RubixCubeSlice slice, RubixCubeFaceRotation face_rotation) {
+	if (slice >= RUBIX_CUBE_SLICE_COUNT || face_rotation >= RUBIX_CUBE_FACE_ROTATION_COUNT) return ;
+	rubix_cube_unrolled_rotate_slice(pRubix_cube,slice,face_rotation) ;
+}
+
+void rubix_cube_rotate_slice_generic(RubixCube * pRubix_cube, RubixCubeSlice slice, RubixCubeFaceRotation face_rotation) {
+	if (slice >= RUBIX_CUBE_SLICE_COUNT || face_rotation >= RUBIX_CUBE_FACE_ROTATION_COUNT) return ;
+	rubix_cube_rotate_quadsets(pRubix_cube,&rubix_cube_slice_rotation_table[slice],face_rotation) ;
+}
+
+inline void rubix_cube_apply_move(RubixCube * pRubixCube, const RubixCubeMove * move) {
 	if (move) rubix_cube_rotate_face(pRubixCube,move->side,move->rotation) ;
 }
 
-inline void rubix_cube_unapply_move(RubixCube * pRubixCube, RubixCubeMove * move) {
+inline RubixCubeMove rubix_cube_move_inverse(const RubixCubeMove * move) {
+	RubixCubeMove inverse = *move ;
+
+	if (move->rotation == RUBIX_CUBE_FACE_ROTATION_CLOCKWISE) {
+		inverse.rotation = RUBIX_CUBE_FACE_ROTATION_COUNTERCLOCKWISE ;
+	}
+	else
+	if (move->rotation == RUBIX_CUBE_FACE_ROTATION_COUNTERCLOCKWISE) {
+		inverse.rotation = RUBIX_CUBE_FACE_ROTATION_CLOCKWISE ;
+	}
+	return inverse ;
+}
+
+inline void rubix_cube_unapply_move(RubixCube * pRubixCube, const RubixCubeMove * move) {
 	if(move) {
-		if(move->rotation == RUBIX_CUBE_FACE_ROTATION_CLOCKWISE) {
-			move->rotation = RUBIX_CUBE_FACE_ROTATION_COUNTERCLOCKWISE ;
-		}
-		else
-		if(move->rotation == RUBIX_CUBE_FACE_ROTATION_COUNTERCLOCKWISE) {
-			move->rotation = RUBIX_CUBE_FACE_ROTATION_CLOCKWISE ;
-		}
-		rubix_cube_apply_move(pRubixCube,move) ;
+		RubixCubeMove inverse = rubix_cube_move_inverse(move) ;
+		rubix_cube_apply_move(pRubixCube,&inverse) ;
 	}
 }
 
@@ -871,16 +637,58 @@ inline RubixCubeMove rubix_cube_generate_random_move() {
 	} ;
 }
 
-void rubix_cube_generate_moves_from_seed(RubixCubeSeed seed, size_t number_of_moves, RubixCubeMove * dest) {
-	/* validity of @dest is a preconditon, so expect SIGSEGV if you ignore that requirement */
-	/* I'm not going to save any users, but I will print a message */
+/* SplitMix64: output k is the finalizer of seed + (k + 1) * golden ratio, no state carried between outputs */
+static inline unsigned long long rubix_cube_random_at(RubixCubeSeed seed, unsigned long long position) {
+	return rubix_cube_mix64(seed + (position + 1) * RUBIX_CUBE_RANDOM_GAMMA) ;
+}
+
+/* Map 64 random bits onto the RUBIX_CUBE_MOVE_COUNT moves, in RUBIX_CUBE_MOVE_INDEX() order */
+static inline RubixCubeMove rubix_cube_random_to_move(unsigned long long bits) {
+	size_t index = (size_t)(((bits >> 32) * RUBIX_CUBE_MOVE_COUNT) >> 32) ;
+	return (RubixCubeMove){
+		.side 		= (RubixCubeSide)(index / RUBIX_CUBE_FACE_ROTATION_COUNT),
+		.rotation 	= (RubixCubeFaceRotation)(index % RUBIX_CUBE_FACE_ROTATION_COUNT)
+	} ;
+}
+
+RubixCubeRandom rubix_cube_random_generate(RubixCubeSeed seed) {
+	return (RubixCubeRandom){
+		.seed 		= seed,
+		.counter 	= 0
+	} ;
+}
+
+unsigned long long rubix_cube_random_next(RubixCubeRandom * pRandom) {
+	return rubix_cube_random_at(pRandom->seed,pRandom->counter++) ;
+}
+
+void rubix_cube_random_seek(RubixCubeRandom * pRandom, unsigned long long position) {
+	pRandom->counter = position ;
+}
+
+RubixCubeMove rubix_cube_generate_random_move_r(RubixCubeRandom * pRandom) {
+	return rubix_cube_random_to_move(rubix_cube_random_next(pRandom)) ;
+}
+
+RubixCubeMove rubix_cube_generate_move_from_seed(RubixCubeSeed seed, size_t index) {
+	return rubix_cube_random_to_move(rubix_cube_random_at(seed,index)) ;
+}
+
+void rubix_cube_generate_moves_from_random(RubixCubeRandom * pRandom, size_t number_of_moves, RubixCubeMove * dest) {
 	assert(dest) ;
 
-	srand(seed) ;
 	for(size_t i = 0; i < number_of_moves; ++i) {
-		dest[i] = rubix_cube_generate_random_move() ;
+		dest[i] = rubix_cube_generate_random_move_r(pRandom) ;
 	}
+}
 
+void rubix_cube_generate_moves_from_seed(RubixCubeSeed seed, size_t number_of_moves, RubixCubeMove * dest) {
+	/* validity of @dest is a preconditon, so expect SIGSEGV if you ignore that requirement */
+	/* I'm not going to save any users, but I will print a message */
+	assert(dest) ;
+
+	RubixCubeRandom random = rubix_cube_random_generate(seed) ;
+	rubix_cube_generate_moves_from_random(&random,number_of_moves,dest) ;
 }
 
 inline const char * rubix_cube_get_face_rotation_string(RubixCubeFaceRotation face_rotation) {
@@ -902,7 +710,6 @@ inline void rubix_cube_print_move_string(RubixCubeMove * move) {
 }
 
 void rubix_cube_solve_scrambled_from_seed(RubixCube * pRubix_cube, RubixCubeSeed seed) {
-	srand(seed) ;
 	RubixCubeMove moves[RUBIX_CUBE_SCRAMBLE_INTENSITY];
 	rubix_cube_generate_moves_from_seed(seed,RUBIX_CUBE_SCRAMBLE_INTENSITY,moves) ;
 
@@ -920,13 +727,10 @@ RubixCubeSeed rubix_cube_generate_seed() {
 	return time(0) ;	
 }
 
-void rubix_cube_rotate_face_strings(RubixCube * pRubix_cube, const char * side, const  char * face_rotation) {
-	(void)pRubix_cube ;
-	printf("side: %s\nrotation: %s\n",side,face_rotation) ;
-}
-
 RubixCubeScramble * rubix_cube_scramble_allocate(RubixCubeSeed seed,size_t intensity) {
 	RubixCubeScramble * pNew ;
+	RUBIX_CUBE_STATS_ADD(allocations,2) ;
+	RUBIX_CUBE_STATS_ADD(allocation_bytes,sizeof(RubixCubeScramble) + sizeof(RubixCubeMove) * intensity) ;
 	if (!(pNew = (RubixCubeScramble *)malloc(sizeof(RubixCubeScramble)))) return NULL ;
 
 	pNew->capacity = intensity ;
@@ -953,14 +757,22 @@ int rubix_cube_get_default_scramble_intensity() {
 	return RUBIX_CUBE_SCRAMBLE_INTENSITY ;
 }
 
-void rubix_cube_apply_scramble(RubixCube * pRubix_cube, RubixCubeScramble * pScramble) {
+void rubix_cube_apply_scramble(RubixCube * pRubix_cube, const RubixCubeScramble * pScramble) {
+	RUBIX_CUBE_STATS_TIMER_START(start) ;
 	for(size_t i = 0; i < pScramble->size; ++i) {
 		rubix_cube_apply_move(pRubix_cube,&pScramble->moves[i]) ;
 	}
+	RUBIX_CUBE_STATS_ADD(apply_scramble,1) ;
+	RUBIX_CUBE_STATS_ADD(apply_scramble_moves,pScramble->size) ;
+	RUBIX_CUBE_STATS_TIMER_STOP(start,apply_scramble_cycles) ;
 }
 
-void rubix_cube_unapply_scramble(RubixCube * pRubix_cube, RubixCubeScramble * pScramble) {
+void rubix_cube_unapply_scramble(RubixCube * pRubix_cube, const RubixCubeScramble * pScramble) {
+	RUBIX_CUBE_STATS_TIMER_START(start) ;
 	for(size_t i = pScramble->size; i > 0; --i) {
 		rubix_cube_unapply_move(pRubix_cube,&pScramble->moves[i-1]) ;
 	}
+	RUBIX_CUBE_STATS_ADD(unapply_scramble,1) ;
+	RUBIX_CUBE_STATS_ADD(unapply_scramble_moves,pScramble->size) ;
+	RUBIX_CUBE_STATS_TIMER_STOP(start,unapply_scramble_cycles) ;
 }
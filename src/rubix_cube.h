@@ -51,12 +51,12 @@
 /* Faces/sides of a square. */
 #define RUBIX_CUBE_SIDE_COUNT 		6
 
-/* NxNxN rubix cube. Note that no other values are yet supported, but might be in the future. */
+/* NxNxN rubix cube. The plane model only supports 3, other sizes are in rubix_cube_nxn.h */
 #define RUBIX_CUBE_SIDE_LENGTH 		3 
 #define RUBIX_CUBE_PLANE_COUNT 		RUBIX_CUBE_SIDE_LENGTH
 
 /* Determine the size of each plane (in pieces) as a constant at compile time */
-#define RUBIX_CUBE_PIECES_PER_PLANE 	RUBIX_CUBE_SIDE_LENGTH * RUBIX_CUBE_SIDE_LENGTH
+#define RUBIX_CUBE_PIECES_PER_PLANE 	(RUBIX_CUBE_SIDE_LENGTH * RUBIX_CUBE_SIDE_LENGTH)
 #define RUBIX_CUBE_PIECES_PER_FACE 	RUBIX_CUBE_PIECES_PER_PLANE
 
 typedef enum rubix_cube_side  {
@@ -120,6 +120,28 @@ typedef enum rubix_cube_face_rotation {
 } RubixCubeFaceRotation ;
 #define RUBIX_CUBE_FACE_ROTATION_COUNT 	3
 
+/* Every face turn (side x rotation) gets a dense index, handy for lookup tables */
+#define RUBIX_CUBE_MOVE_COUNT 		(RUBIX_CUBE_SIDE_COUNT * RUBIX_CUBE_FACE_ROTATION_COUNT)
+#define RUBIX_CUBE_MOVE_INDEX(side, rotation) \
+	((size_t)(side) * RUBIX_CUBE_FACE_ROTATION_COUNT + (size_t)(rotation))
+
+/* Index of the move that undoes move @index, a double turn undoes itself */
+#define RUBIX_CUBE_MOVE_INDEX_INVERSE(index) \
+	((size_t)(index) - (size_t)(index) % RUBIX_CUBE_FACE_ROTATION_COUNT + \
+	 ((size_t)(index) % RUBIX_CUBE_FACE_ROTATION_COUNT == RUBIX_CUBE_FACE_ROTATION_DOUBLE ? \
+	  RUBIX_CUBE_FACE_ROTATION_DOUBLE : 1 - (size_t)(index) % RUBIX_CUBE_FACE_ROTATION_COUNT))
+
+/* The middle layers, each turning the way its face does: M as L, E as D (bottom) and S as F */
+typedef enum rubix_cube_slice {
+	RUBIX_CUBE_SLICE_M,
+	RUBIX_CUBE_SLICE_E,
+	RUBIX_CUBE_SLICE_S
+} RubixCubeSlice ;
+#define RUBIX_CUBE_SLICE_COUNT 		3
+
+/* Square indices are numbered so that opposite faces add up to 5 (top/bottom, front/back, right/left) */
+#define RUBIX_CUBE_SQUARE_OPPOSITE(side) 	(RUBIX_CUBE_SIDE_COUNT - 1 - (side))
+
 /* Seed type of value for generation of scrambled rubix cube */
 typedef unsigned long long int RubixCubeSeed ;
 
@@ -549,6 +571,40 @@ typedef struct rubix_cube_face_rotation_data {
 	RubixCubeSubrotationSet 	subrotation_set	[RUBIX_CUBE_FACE_ROTATION_COUNT] ;
 } RubixCubeFaceRotationData ;
 
+/*
+ * The data of rubix_cube_rotation_table, one face per line in square order: its name,
+ * its corner and side quadsets as (plane, index) pairs, and the piece rotation of a
+ * clockwise, counterclockwise and double turn (by RUBIX_CUBE_ROTATE_QUADSET_RIGHT, LEFT
+ * and FULL). Call it with a macro taking those six arguments, see rubix_cube_unrolled.h.
+ */
+#define RUBIX_CUBE_FACE_ROTATIONS(X) \
+	X(top, 		(2,0, 2,2, 0,0, 0,2), (2,1, 1,2, 1,0, 0,1), LEFT, RIGHT, RIGHT) \
+	X(front, 	(0,0, 0,2, 0,6, 0,8), (0,1, 0,5, 0,3, 0,7), CLOCKWISE, COUNTERCLOCKWISE, COUNTERCLOCKWISE) \
+	X(right, 	(0,2, 2,2, 0,8, 2,8), (1,2, 2,5, 0,5, 1,8), UP, DOWN, DOWN) \
+	X(left, 	(2,0, 0,0, 2,6, 0,6), (1,0, 0,3, 2,3, 1,6), DOWN, UP, UP) \
+	X(back, 	(2,2, 2,0, 2,8, 2,6), (2,1, 2,3, 2,5, 2,7), COUNTERCLOCKWISE, CLOCKWISE, CLOCKWISE) \
+	X(bottom, 	(0,6, 0,8, 2,6, 2,8), (0,7, 1,8, 1,6, 2,7), RIGHT, LEFT, LEFT)
+
+/* The same for rubix_cube_slice_rotation_table, by RubixCubeSlice, edges first and centers second */
+#define RUBIX_CUBE_SLICE_ROTATIONS(X) \
+	X(slice_m, 	(2,1, 0,1, 2,7, 0,7), (1,1, 0,4, 2,4, 1,7), DOWN, UP, UP) \
+	X(slice_e, 	(0,3, 0,5, 2,3, 2,5), (0,4, 1,5, 1,3, 2,4), RIGHT, LEFT, LEFT) \
+	X(slice_s, 	(1,0, 1,2, 1,6, 1,8), (1,1, 1,5, 1,3, 1,7), CLOCKWISE, COUNTERCLOCKWISE, COUNTERCLOCKWISE)
+
+/* One RubixCubeFaceRotationData initializer from a line of either list */
+#define RUBIX_CUBE_QUADSET_REFERENCES(refs) 	RUBIX_CUBE_QUADSET_REFERENCES_ refs
+#define RUBIX_CUBE_QUADSET_REFERENCES_(p0, i0, p1, i1, p2, i2, p3, i3) 	{ { p0, i0 }, { p1, i1 }, { p2, i2 }, { p3, i3 } }
+#define RUBIX_CUBE_FACE_ROTATION_DATA(name, corners, sides, clockwise, counterclockwise, half) \
+	{ \
+		.corner_quadset = RUBIX_CUBE_QUADSET_REFERENCES(corners), \
+		.side_quadset = RUBIX_CUBE_QUADSET_REFERENCES(sides), \
+		.subrotation_set = { \
+			{ RUBIX_CUBE_ROTATE_QUADSET_RIGHT, RUBIX_CUBE_ROTATE_##clockwise }, \
+			{ RUBIX_CUBE_ROTATE_QUADSET_LEFT, RUBIX_CUBE_ROTATE_##counterclockwise }, \
+			{ RUBIX_CUBE_ROTATE_QUADSET_FULL, RUBIX_CUBE_ROTATE_##half } \
+		} \
+	},
+
 typedef struct rubix_cube_move {
 	RubixCubeSide		 	side ;
 	RubixCubeFaceRotation 		rotation ;
@@ -563,6 +619,28 @@ typedef struct rubix_cube_scramble {
 
 #define RUBIX_CUBE_SCRAMBLE_INTENSITY 50
 
+/*
+ * Random number generator state for scramble generation
+ *
+ * The generator is counter based: value k of a seed is a pure function of (seed, k),
+ * so each thread can own a RubixCubeRandom and any position of a sequence can be
+ * reached directly without generating everything before it.
+ */
+typedef struct rubix_cube_random {
+	RubixCubeSeed 			seed ;
+	unsigned long long 		counter ;
+} RubixCubeRandom ;
+
+/* The SplitMix64 increment, 2^64 over the golden ratio */
+#define RUBIX_CUBE_RANDOM_GAMMA 	0x9e3779b97f4a7c15ULL
+
+/* The SplitMix64 finalizer, every input bit affects every output bit: the generator and the hashes all mix with it */
+static inline unsigned long long rubix_cube_mix64(unsigned long long z) {
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL ;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL ;
+	return z ^ (z >> 31) ;
+}
+
 /* Library Functions */
 
 /* Get a copy of the solved cube literal */
@@ -577,6 +655,9 @@ RubixCube rubix_cube_generate_scrambled(RubixCubeSeed seed) ;
 /* Return a pointer to a freshly allocated cube based on the provided seed value */
 RubixCube * rubix_cube_allocate_scrambled(RubixCubeSeed seed) ;
 
+/* Return the letter used to print @color */
+char rubix_cube_get_char_of_color(RubixCubeColor color) ;
+
 /* TODO: rename these functons to something that makes sense */
 void rubix_cube_print_ascii(FILE * output_file, RubixCube * pRubix_cube) ;
 void rubix_cube_print_ascii_double(FILE * output_file, RubixCube * pRubix_cube) ;
@@ -585,6 +666,9 @@ void rubix_cube_print_ascii_double_stdout(RubixCube * pRubix_cube) ;
 
 void rubix_cube_print_face_ascii(FILE * output_file, RubixCube * pRubix_cube, RubixCubeSide side) ;
 
+/* Print every face of the cube, one after the other, to @output_file */
+void rubix_cube_print_all_faces_ascii(FILE * output_file, RubixCube * pRubix_cube) ;
+
 /* Free all memory allocated to a rubix cube object */
 void rubix_cube_free(RubixCube * pRubix_cube) ;
 
@@ -600,35 +684,75 @@ void rubix_cube_print_piece_from_cube(RubixCube * pRubix_cube, unsigned plane, u
 /* Return 0 if the cube is not solved, else reutrn nonzero value */
 int rubix_cube_is_solved(RubixCube * pRubix_cube) ;
 
+/* Return the number of solved cubes among the @count in @cubes, if @results is not NULL also set @results[i] nonzero for each solved cube */
+size_t rubix_cube_count_solved(RubixCube * cubes, size_t count, unsigned char * results) ;
+
 /* Return nonzero if the two cubes have identical values for every piece, else return 0 */
 int rubix_cube_equivelence_check(RubixCube * first, RubixCube * second) ;
 
 /* Return the number of rotations made to scramble the cube by default */
 int rubix_cube_get_default_scramble_intensity() ;
 
+/* The solved cube, equal to RUBIX_CUBE_IDENTITY */
+extern const RubixCube rubix_cube_solved ;
+
+/* The corner and side pieces moved by a rotation of each face, by square index */
+extern RubixCubeFaceRotationData rubix_cube_rotation_table[RUBIX_CUBE_SIDE_COUNT] ;
+
+/* The same for the middle layers, by RubixCubeSlice: the edges come first and the centers second */
+extern RubixCubeFaceRotationData rubix_cube_slice_rotation_table[RUBIX_CUBE_SLICE_COUNT] ;
+
 /* Rotate a face of a rubix cube by pi/2, -pi/2, or pi radians */
 void rubix_cube_rotate_face(RubixCube * pRubix_cube, RubixCubeSide side, RubixCubeFaceRotation face_rotation) ;
 
-//TODO
-/* Same as rotate_face() but side and rotation can be specified by a character string */
-//void rubix_cube_rotate_face_strings(RubixCube * pRubix_cube, const char * side, const  char * face_rotation) ;
+/* The face turn straight from rubix_cube_rotation_table, as rubix_cube_rotate_face() did before rubix_cube_unrolled.h */
+void rubix_cube_rotate_face_generic(RubixCube * pRubix_cube, RubixCubeSide side, RubixCubeFaceRotation face_rotation) ;
+
+/* Rotate a middle layer, which unlike a face turn moves centers, see rubix_cube_turn.h for keeping track of that */
+void rubix_cube_rotate_slice(RubixCube * pRubix_cube, RubixCubeSlice slice, RubixCubeFaceRotation face_rotation) ;
+
+/* The same straight from rubix_cube_slice_rotation_table */
+void rubix_cube_rotate_slice_generic(RubixCube * pRubix_cube, RubixCubeSlice slice, RubixCubeFaceRotation face_rotation) ;
 
 /* Apply a move to a rubix cube from a move object */
-void rubix_cube_apply_move(RubixCube * pRubixCube, RubixCubeMove * move) ;
+void rubix_cube_apply_move(RubixCube * pRubixCube, const RubixCubeMove * move) ;
 
-/* Apply a move to a rubix cube that is the reverse of one specified in a RubixCubeMove object */
-void rubix_cube_unapply_move(RubixCube * pRubixCube, RubixCubeMove * move) ;
+/* Return the move that undoes @move */
+RubixCubeMove rubix_cube_move_inverse(const RubixCubeMove * move) ;
+
+/* Apply a move to a rubix cube that is the reverse of one specified in a RubixCubeMove object, @move is left as it is */
+void rubix_cube_unapply_move(RubixCube * pRubixCube, const RubixCubeMove * move) ;
 
 /* Print a string describing a RubixCubeMove in plain English */
 void rubix_cube_print_move_string(RubixCubeMove * move) ;
 
 /* Generate a random valid RubixCubeMove */
+/* Uses rand(), so not reentrant, see rubix_cube_generate_random_move_r() */
 RubixCubeMove rubix_cube_generate_random_move() ;
 
+/* Get a random number generator positioned at the start of the sequence for @seed */
+RubixCubeRandom rubix_cube_random_generate(RubixCubeSeed seed) ;
+
+/* Return the next 64 random bits from @pRandom */
+unsigned long long rubix_cube_random_next(RubixCubeRandom * pRandom) ;
+
+/* Move @pRandom to @position in its sequence, in constant time */
+void rubix_cube_random_seek(RubixCubeRandom * pRandom, unsigned long long position) ;
+
+/* Generate a random valid RubixCubeMove from @pRandom */
+RubixCubeMove rubix_cube_generate_random_move_r(RubixCubeRandom * pRandom) ;
+
+/* Generate move number @index of the sequence for @seed without generating the moves before it */
+RubixCubeMove rubix_cube_generate_move_from_seed(RubixCubeSeed seed, size_t index) ;
+
 /* Generate the first @number_of_moves from a seed, place results in @dest */
 /* Precondition: dest points to @number_of_moves * sizeof(RubixCubeMove) allocated bytes */
+/* Safe to call from many threads at once, the same @seed always gives the same moves */
 void rubix_cube_generate_moves_from_seed(RubixCubeSeed seed, size_t number_of_moves, RubixCubeMove * dest) ;
 
+/* Generate the next @number_of_moves from @pRandom, place results in @dest */
+void rubix_cube_generate_moves_from_random(RubixCubeRandom * pRandom, size_t number_of_moves, RubixCubeMove * dest) ;
+
 /* Get a character string representing a RubixCubeSide value in English */
 const char * rubix_cube_get_side_string(RubixCubeSide side) ;
 
@@ -645,10 +769,10 @@ RubixCubeScramble * rubix_cube_scramble_allocate() ;
 void rubix_cube_scramble_free() ;
 
 /* Apply all moves in a @pScramble to @pRubix_cube */
-void rubix_cube_apply_scramble(RubixCube * pRubix_cube, RubixCubeScramble * pScramble) ;
+void rubix_cube_apply_scramble(RubixCube * pRubix_cube, const RubixCubeScramble * pScramble) ;
 
-/* Unapply all moves in a @pScramble to @pRubix_cube */
-void rubix_cube_unapply_scramble(RubixCube * pRubix_cube, RubixCubeScramble * pScramble) ;
+/* Unapply all moves in a @pScramble to @pRubix_cube, without changing @pScramble so it can be shared between threads */
+void rubix_cube_unapply_scramble(RubixCube * pRubix_cube, const RubixCubeScramble * pScramble) ;
 
 /* Get a random rubix cube seed */
 RubixCubeSeed rubix_cube_generate_seed() ;
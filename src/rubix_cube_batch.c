@@ -0,0 +1,212 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+#include "rubix_cube_batch.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+/* Cubes are processed this many at a time so that the rows in flight stay in L1 */
+#define RUBIX_CUBE_BATCH_BLOCK 		256
+
+/* A face rotation really only moves 20 facelets (8 on its face and 12 around it) */
+#define RUBIX_CUBE_BATCH_MAX_MOVED 	20
+
+/* Just the rows each move actually changes */
+typedef struct rubix_cube_batch_move {
+	size_t 		moved_count ;
+	unsigned char 	moved		[RUBIX_CUBE_BATCH_MAX_MOVED] ;	/* destination rows */
+	unsigned char 	sources		[RUBIX_CUBE_BATCH_MAX_MOVED] ;	/* where each one comes from */
+} RubixCubeBatchMove ;
+
+RubixCubeBatchMove rubix_cube_batch_move_table[RUBIX_CUBE_MOVE_COUNT] ;
+
+static pthread_once_t rubix_cube_batch_tables_once = PTHREAD_ONCE_INIT ;
+
+static void rubix_cube_batch_build_tables(void) {
+	for (size_t side = 0; side < RUBIX_CUBE_SIDE_COUNT; ++side) {
+		for (size_t rotation = 0; rotation < RUBIX_CUBE_FACE_ROTATION_COUNT; ++rotation) {
+			const RubixCubeFaceletPermutation * permutation = rubix_cube_facelet_get_move(side,rotation) ;
+			RubixCubeBatchMove * move = &rubix_cube_batch_move_table[RUBIX_CUBE_MOVE_INDEX(side,rotation)] ;
+			move->moved_count = 0 ;
+			for (size_t i = 0; i < RUBIX_CUBE_FACELET_COUNT; ++i) {
+				if (permutation->map[i] == i) continue ;
+				assert(move->moved_count < RUBIX_CUBE_BATCH_MAX_MOVED) ;
+				move->moved[move->moved_count] = (unsigned char)i ;
+				move->sources[move->moved_count++] = permutation->map[i] ;
+			}
+		}
+	}
+}
+
+static inline const RubixCubeBatchMove * rubix_cube_batch_get_move(const RubixCubeMove * move) {
+	return &rubix_cube_batch_move_table[RUBIX_CUBE_MOVE_INDEX(move->side,move->rotation)] ;
+}
+
+static inline unsigned char * rubix_cube_batch_row(RubixCubeBatch * pBatch, size_t facelet) {
+	return pBatch->facelets + facelet * pBatch->stride ;
+}
+
+RubixCubeBatch * rubix_cube_batch_allocate(size_t count) {
+	RubixCubeBatch * pNew ;
+	pthread_once(&rubix_cube_batch_tables_once,rubix_cube_batch_build_tables) ;
+
+	if (!(pNew = (RubixCubeBatch *)malloc(sizeof(RubixCubeBatch)))) return NULL ;
+
+	pNew->count = count ;
+	pNew->stride = (count + RUBIX_CUBE_BATCH_ALIGNMENT - 1) / RUBIX_CUBE_BATCH_ALIGNMENT * RUBIX_CUBE_BATCH_ALIGNMENT ;
+	if (!pNew->stride) pNew->stride = RUBIX_CUBE_BATCH_ALIGNMENT ;
+
+	if (posix_memalign((void **)&pNew->facelets,RUBIX_CUBE_BATCH_ALIGNMENT,RUBIX_CUBE_FACELET_COUNT * pNew->stride)) {
+		free(pNew) ; return NULL ;
+	}
+
+	RubixCubeFacelets solved = rubix_cube_facelets_generate_solved() ;
+	for (size_t i = 0; i < RUBIX_CUBE_FACELET_COUNT; ++i) {
+		memset(rubix_cube_batch_row(pNew,i),solved.facelets[i],pNew->stride) ;
+	}
+	return pNew ;
+}
+
+void rubix_cube_batch_free(RubixCubeBatch * pBatch) {
+	if (pBatch) {
+		free(pBatch->facelets) ;
+		free(pBatch) ;
+	}
+}
+
+void rubix_cube_batch_store(RubixCubeBatch * pBatch, size_t index, const RubixCubeFacelets * pFacelets) {
+	for (size_t i = 0; i < RUBIX_CUBE_FACELET_COUNT; ++i) {
+		rubix_cube_batch_row(pBatch,i)[index] = pFacelets->facelets[i] ;
+	}
+}
+
+RubixCubeFacelets rubix_cube_batch_load(RubixCubeBatch * pBatch, size_t index) {
+	RubixCubeFacelets new ;
+	memset(&new,0,sizeof(RubixCubeFacelets)) ;
+	for (size_t i = 0; i < RUBIX_CUBE_FACELET_COUNT; ++i) {
+		new.facelets[i] = rubix_cube_batch_row(pBatch,i)[index] ;
+	}
+	return new ;
+}
+
+void rubix_cube_batch_store_cube(RubixCubeBatch * pBatch, size_t index, RubixCube * pRubix_cube) {
+	RubixCubeFacelets facelets = rubix_cube_facelets_from_cube(pRubix_cube) ;
+	rubix_cube_batch_store(pBatch,index,&facelets) ;
+}
+
+RubixCube rubix_cube_batch_load_cube(RubixCubeBatch * pBatch, size_t index) {
+	RubixCubeFacelets facelets = rubix_cube_batch_load(pBatch,index) ;
+	return rubix_cube_facelets_to_cube(&facelets) ;
+}
+
+void rubix_cube_batch_apply_moves(RubixCubeBatch * pBatch, const RubixCubeMove * moves, size_t number_of_moves) {
+	unsigned char moved[RUBIX_CUBE_BATCH_MAX_MOVED][RUBIX_CUBE_BATCH_BLOCK] ;
+
+	/* Run the whole sequence over one block of cubes before moving to the next */
+	for (size_t start = 0; start < pBatch->count; start += RUBIX_CUBE_BATCH_BLOCK) {
+		size_t width = pBatch->count - start < RUBIX_CUBE_BATCH_BLOCK ? pBatch->count - start : RUBIX_CUBE_BATCH_BLOCK ;
+
+		for (size_t m = 0; m < number_of_moves; ++m) {
+			const RubixCubeBatchMove * move = rubix_cube_batch_get_move(&moves[m]) ;
+			for (size_t k = 0; k < move->moved_count; ++k) {
+				memcpy(moved[k],rubix_cube_batch_row(pBatch,move->sources[k]) + start,width) ;
+			}
+			for (size_t k = 0; k < move->moved_count; ++k) {
+				memcpy(rubix_cube_batch_row(pBatch,move->moved[k]) + start,moved[k],width) ;
+			}
+		}
+	}
+}
+
+void rubix_cube_batch_apply_scramble(RubixCubeBatch * pBatch, RubixCubeScramble * pScramble) {
+	rubix_cube_batch_apply_moves(pBatch,pScramble->moves,pScramble->size) ;
+}
+
+void rubix_cube_batch_permute(RubixCubeBatch * pBatch, const RubixCubeFaceletPermutation * permutation) {
+	unsigned char original[RUBIX_CUBE_FACELET_COUNT][RUBIX_CUBE_BATCH_BLOCK] ;
+
+	for (size_t start = 0; start < pBatch->count; start += RUBIX_CUBE_BATCH_BLOCK) {
+		size_t width = pBatch->count - start < RUBIX_CUBE_BATCH_BLOCK ? pBatch->count - start : RUBIX_CUBE_BATCH_BLOCK ;
+
+		for (size_t i = 0; i < RUBIX_CUBE_FACELET_COUNT; ++i) {
+			memcpy(original[i],rubix_cube_batch_row(pBatch,i) + start,width) ;
+		}
+		for (size_t i = 0; i < RUBIX_CUBE_FACELET_COUNT; ++i) {
+			if (permutation->map[i] == i) continue ;
+			memcpy(rubix_cube_batch_row(pBatch,i) + start,original[permutation->map[i]],width) ;
+		}
+	}
+}
+
+/*
+ * Every cube gets its own move here, so each block is copied aside and then, for each
+ * move that shows up in the block, the rows it touches are blended back in only on the
+ * lanes (cubes) that asked for it.
+ */
+void rubix_cube_batch_apply_each(RubixCubeBatch * pBatch, const RubixCubeMove * moves) {
+	unsigned char original[RUBIX_CUBE_FACELET_COUNT][RUBIX_CUBE_BATCH_BLOCK] ;
+	unsigned char lanes[RUBIX_CUBE_MOVE_COUNT][RUBIX_CUBE_BATCH_BLOCK] ;
+
+	for (size_t start = 0; start < pBatch->count; start += RUBIX_CUBE_BATCH_BLOCK) {
+		size_t width = pBatch->count - start < RUBIX_CUBE_BATCH_BLOCK ? pBatch->count - start : RUBIX_CUBE_BATCH_BLOCK ;
+		unsigned present = 0 ;
+
+		memset(lanes,0,sizeof(lanes)) ;
+		for (size_t c = 0; c < width; ++c) {
+			size_t index = RUBIX_CUBE_MOVE_INDEX(moves[start + c].side,moves[start + c].rotation) ;
+			lanes[index][c] = 0xff ;
+			present |= 1u << index ;
+		}
+		for (size_t i = 0; i < RUBIX_CUBE_FACELET_COUNT; ++i) {
+			memcpy(original[i],rubix_cube_batch_row(pBatch,i) + start,width) ;
+		}
+
+		for (size_t m = 0; m < RUBIX_CUBE_MOVE_COUNT; ++m) {
+			if (!(present & (1u << m))) continue ;
+			const RubixCubeBatchMove * move = &rubix_cube_batch_move_table[m] ;
+			const unsigned char * mask = lanes[m] ;
+			for (size_t k = 0; k < move->moved_count; ++k) {
+				unsigned char * dest = rubix_cube_batch_row(pBatch,move->moved[k]) + start ;
+				const unsigned char * src = original[move->sources[k]] ;
+				for (size_t c = 0; c < width; ++c) {
+					dest[c] = (unsigned char)((dest[c] & ~mask[c]) | (src[c] & mask[c])) ;
+				}
+			}
+		}
+	}
+}
+
+size_t rubix_cube_batch_count_solved(RubixCubeBatch * pBatch, unsigned char * results) {
+	RubixCubeFacelets solved = rubix_cube_facelets_generate_solved() ;
+	unsigned char matches[RUBIX_CUBE_BATCH_BLOCK] ;
+	size_t total = 0 ;
+
+	for (size_t start = 0; start < pBatch->count; start += RUBIX_CUBE_BATCH_BLOCK) {
+		size_t width = pBatch->count - start < RUBIX_CUBE_BATCH_BLOCK ? pBatch->count - start : RUBIX_CUBE_BATCH_BLOCK ;
+
+		memset(matches,1,width) ;
+		for (size_t i = 0; i < RUBIX_CUBE_FACELET_COUNT; ++i) {
+			const unsigned char * row = rubix_cube_batch_row(pBatch,i) + start ;
+			for (size_t c = 0; c < width; ++c) matches[c] &= row[c] == solved.facelets[i] ;
+		}
+		for (size_t c = 0; c < width; ++c) total += matches[c] ;
+		if (results) memcpy(results + start,matches,width) ;
+	}
+	return total ;
+}
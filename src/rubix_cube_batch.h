@@ -0,0 +1,77 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Batches of cubes:
+ *
+ * A RubixCubeBatch holds many cubes as a structure of arrays. Facelet i of every
+ * cube in the batch sits in one contiguous row:
+ *
+ * row i:  [ cube 0 | cube 1 | cube 2 | ... | cube count-1 | padding ]
+ *
+ * A face rotation then only has to move the 20 rows it touches, and moving a row
+ * is a straight memcpy across all cubes at once, so every vector lane works on a
+ * different cube and no per cube function call or table lookup is made.
+ *
+ * To apply the same moves to an array of RubixCubeFacelets instead, see
+ * rubix_cube_facelets_apply_moves_all() in rubix_cube_facelet.h
+ */
+
+#ifndef RUBIX_CUBE_BATCH_H
+#define RUBIX_CUBE_BATCH_H "rubix_cube_batch.h"
+
+#include "rubix_cube.h"
+#include "rubix_cube_facelet.h"
+
+/* Rows are padded to a multiple of this many cubes (bytes) */
+#define RUBIX_CUBE_BATCH_ALIGNMENT 	64
+
+typedef struct rubix_cube_batch {
+	size_t			count ;
+	size_t			stride ;	/* bytes per row, count rounded up to RUBIX_CUBE_BATCH_ALIGNMENT */
+	unsigned char * 	facelets ;	/* RUBIX_CUBE_FACELET_COUNT rows of @stride bytes */
+} RubixCubeBatch ;
+
+/* Return a pointer to a freshly allocated batch of @count solved cubes */
+RubixCubeBatch * rubix_cube_batch_allocate(size_t count) ;
+
+/* Free all memory associated with a RubixCubeBatch object */
+void rubix_cube_batch_free(RubixCubeBatch * pBatch) ;
+
+/* Copy a cube into / out of slot @index of @pBatch */
+void rubix_cube_batch_store(RubixCubeBatch * pBatch, size_t index, const RubixCubeFacelets * pFacelets) ;
+RubixCubeFacelets rubix_cube_batch_load(RubixCubeBatch * pBatch, size_t index) ;
+void rubix_cube_batch_store_cube(RubixCubeBatch * pBatch, size_t index, RubixCube * pRubix_cube) ;
+RubixCube rubix_cube_batch_load_cube(RubixCubeBatch * pBatch, size_t index) ;
+
+/* Apply @number_of_moves @moves, in order, to every cube in @pBatch */
+void rubix_cube_batch_apply_moves(RubixCubeBatch * pBatch, const RubixCubeMove * moves, size_t number_of_moves) ;
+
+/* Apply all moves in a @pScramble to every cube in @pBatch */
+void rubix_cube_batch_apply_scramble(RubixCubeBatch * pBatch, RubixCubeScramble * pScramble) ;
+
+/* Apply @moves[i] to cube i, @moves must hold @pBatch->count moves */
+void rubix_cube_batch_apply_each(RubixCubeBatch * pBatch, const RubixCubeMove * moves) ;
+
+/* Apply @permutation to every cube in @pBatch */
+void rubix_cube_batch_permute(RubixCubeBatch * pBatch, const RubixCubeFaceletPermutation * permutation) ;
+
+/* Return the number of solved cubes in @pBatch, if @results is not NULL also set @results[i] nonzero for each solved cube */
+size_t rubix_cube_batch_count_solved(RubixCubeBatch * pBatch, unsigned char * results) ;
+
+#endif // RUBIX_CUBE_BATCH_H
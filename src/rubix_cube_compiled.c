@@ -0,0 +1,114 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+#include "rubix_cube_compiled.h"
+
+RubixCubeCompiledScramble rubix_cube_compiled_scramble_identity(void) {
+	RubixCubeCompiledScramble identity ;
+	identity.facelets = rubix_cube_facelet_permutation_identity() ;
+	identity.cubie = rubix_cube_cubie_generate_solved() ;
+	identity.size = 0 ;
+	return identity ;
+}
+
+RubixCubeCompiledScramble rubix_cube_compile_moves(const RubixCubeMove * moves, size_t number_of_moves) {
+	RubixCubeCompiledScramble new = rubix_cube_compiled_scramble_identity() ;
+
+	for (size_t i = 0; i < number_of_moves; ++i) {
+		rubix_cube_facelet_permutation_compose(&new.facelets,&new.facelets,rubix_cube_facelet_get_move(moves[i].side,moves[i].rotation)) ;
+		rubix_cube_cubie_multiply(&new.cubie,&new.cubie,rubix_cube_cubie_get_move(moves[i].side,moves[i].rotation)) ;
+	}
+	new.size = number_of_moves ;
+
+	return new ;
+}
+
+RubixCubeCompiledScramble rubix_cube_compile_scramble(RubixCubeScramble * pScramble) {
+	return rubix_cube_compile_moves(pScramble->moves,pScramble->size) ;
+}
+
+void rubix_cube_compiled_scramble_compose(RubixCubeCompiledScramble * dest, const RubixCubeCompiledScramble * first, const RubixCubeCompiledScramble * second) {
+	size_t size = first->size + second->size ;
+	rubix_cube_facelet_permutation_compose(&dest->facelets,&first->facelets,&second->facelets) ;
+	rubix_cube_cubie_multiply(&dest->cubie,&first->cubie,&second->cubie) ;
+	dest->size = size ;
+}
+
+void rubix_cube_compiled_scramble_power(RubixCubeCompiledScramble * dest, const RubixCubeCompiledScramble * src, unsigned long long power) {
+	RubixCubeCompiledScramble result = rubix_cube_compiled_scramble_identity() ;
+	RubixCubeCompiledScramble square = *src ;
+	size_t size = src->size * power ;
+
+	/* Every sequence is its own power k + order, no need to square more than that */
+	power %= rubix_cube_compiled_scramble_order(src) ;
+
+	while (power) {
+		if (power & 1) rubix_cube_compiled_scramble_compose(&result,&result,&square) ;
+		if (power >>= 1) rubix_cube_compiled_scramble_compose(&square,&square,&square) ;
+	}
+
+	result.size = size ;
+	*dest = result ;
+}
+
+static unsigned long long rubix_cube_gcd(unsigned long long a, unsigned long long b) {
+	while (b) {
+		unsigned long long t = a % b ;
+		a = b ;
+		b = t ;
+	}
+	return a ;
+}
+
+/* The order of a permutation is the least common multiple of the lengths of its cycles */
+unsigned long long rubix_cube_compiled_scramble_order(const RubixCubeCompiledScramble * pCompiled) {
+	unsigned char seen[RUBIX_CUBE_FACELET_COUNT] = {0} ;
+	unsigned long long order = 1 ;
+
+	for (size_t i = 0; i < RUBIX_CUBE_FACELET_COUNT; ++i) {
+		unsigned long long length = 0 ;
+		for (size_t j = i; !seen[j]; j = pCompiled->facelets.map[j]) {
+			seen[j] = 1 ;
+			++length ;
+		}
+		if (length) order = order / rubix_cube_gcd(order,length) * length ;
+	}
+
+	return order ;
+}
+
+void rubix_cube_compiled_scramble_apply(RubixCube * pRubix_cube, const RubixCubeCompiledScramble * pCompiled) {
+	RubixCubeFacelets facelets = rubix_cube_facelets_from_cube(pRubix_cube) ;
+	rubix_cube_facelets_permute(&facelets,&facelets,&pCompiled->facelets) ;
+	*pRubix_cube = rubix_cube_facelets_to_cube(&facelets) ;
+}
+
+void rubix_cube_compiled_scramble_apply_facelets(RubixCubeFacelets * pFacelets, const RubixCubeCompiledScramble * pCompiled) {
+	rubix_cube_facelets_permute(pFacelets,pFacelets,&pCompiled->facelets) ;
+}
+
+void rubix_cube_compiled_scramble_apply_cubie(RubixCubeCubie * pCubie, const RubixCubeCompiledScramble * pCompiled) {
+	rubix_cube_cubie_multiply(pCubie,pCubie,&pCompiled->cubie) ;
+}
+
+void rubix_cube_compiled_scramble_apply_all(RubixCubeFacelets * cubes, size_t count, const RubixCubeCompiledScramble * pCompiled) {
+	rubix_cube_facelets_permute_all(cubes,count,&pCompiled->facelets) ;
+}
+
+void rubix_cube_compiled_scramble_apply_batch(RubixCubeBatch * pBatch, const RubixCubeCompiledScramble * pCompiled) {
+	rubix_cube_batch_permute(pBatch,&pCompiled->facelets) ;
+}
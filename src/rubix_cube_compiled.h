@@ -0,0 +1,75 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Compiled scrambles:
+ *
+ * Any sequence of face rotations is itself just one permutation of the cube, so a
+ * RubixCubeScramble can be folded once into a single facelet permutation (and the
+ * matching cubie) and from then on applied to any number of cubes in constant time,
+ * instead of replaying every move on every cube.
+ *
+ * Compiled scrambles compose like the moves they were built from, which also gives
+ * cheap powers (repeated squaring) and the order of a sequence, i.e. how many times
+ * it has to be repeated before the cube comes back to where it started.
+ */
+
+#ifndef RUBIX_CUBE_COMPILED_H
+#define RUBIX_CUBE_COMPILED_H "rubix_cube_compiled.h"
+
+#include "rubix_cube.h"
+#include "rubix_cube_cubie.h"
+#include "rubix_cube_facelet.h"
+#include "rubix_cube_batch.h"
+
+typedef struct rubix_cube_compiled_scramble {
+	RubixCubeFaceletPermutation	facelets ;
+	RubixCubeCubie			cubie ;
+	size_t				size ;		/* number of face rotations folded in */
+} RubixCubeCompiledScramble ;
+
+/* Get the compiled scramble that does nothing */
+RubixCubeCompiledScramble rubix_cube_compiled_scramble_identity() ;
+
+/* Fold all @number_of_moves @moves into one compiled scramble */
+RubixCubeCompiledScramble rubix_cube_compile_moves(const RubixCubeMove * moves, size_t number_of_moves) ;
+
+/* Fold all moves in @pScramble into one compiled scramble */
+RubixCubeCompiledScramble rubix_cube_compile_scramble(RubixCubeScramble * pScramble) ;
+
+/* Set @dest to doing @first, then @second, @dest may alias either argument */
+void rubix_cube_compiled_scramble_compose(RubixCubeCompiledScramble * dest, const RubixCubeCompiledScramble * first, const RubixCubeCompiledScramble * second) ;
+
+/* Set @dest to @src repeated @power times, @dest may alias @src */
+void rubix_cube_compiled_scramble_power(RubixCubeCompiledScramble * dest, const RubixCubeCompiledScramble * src, unsigned long long power) ;
+
+/* Return the smallest nonzero number of repetitions of @pCompiled that does nothing */
+unsigned long long rubix_cube_compiled_scramble_order(const RubixCubeCompiledScramble * pCompiled) ;
+
+/* Same as rubix_cube_apply_scramble() with the original scramble, for each cube model */
+void rubix_cube_compiled_scramble_apply(RubixCube * pRubix_cube, const RubixCubeCompiledScramble * pCompiled) ;
+void rubix_cube_compiled_scramble_apply_facelets(RubixCubeFacelets * pFacelets, const RubixCubeCompiledScramble * pCompiled) ;
+void rubix_cube_compiled_scramble_apply_cubie(RubixCubeCubie * pCubie, const RubixCubeCompiledScramble * pCompiled) ;
+
+/* Apply @pCompiled to each of the @count facelet cubes in @cubes */
+void rubix_cube_compiled_scramble_apply_all(RubixCubeFacelets * cubes, size_t count, const RubixCubeCompiledScramble * pCompiled) ;
+
+/* Apply @pCompiled to every cube in @pBatch */
+void rubix_cube_compiled_scramble_apply_batch(RubixCubeBatch * pBatch, const RubixCubeCompiledScramble * pCompiled) ;
+
+#endif // RUBIX_CUBE_COMPILED_H
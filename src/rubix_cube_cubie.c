@@ -0,0 +1,242 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+#include "rubix_cube_cubie.h"
+#include <string.h>
+#include <pthread.h>
+#include <assert.h>
+
+/*
+ * Where each corner and edge position lives in the RubixCube plane model.
+ * Corner sides are listed U/D side first, then clockwise around the corner,
+ * which is what makes the orientation arithmetic below work.
+ */
+typedef struct rubix_cube_corner_position {
+	RubixCubePieceReference 	piece ;
+	unsigned char 			sides[3] ;
+} RubixCubeCornerPosition ;
+
+typedef struct rubix_cube_edge_position {
+	RubixCubePieceReference 	piece ;
+	unsigned char 			sides[2] ;
+} RubixCubeEdgePosition ;
+
+const RubixCubeCornerPosition rubix_cube_corner_positions[RUBIX_CUBE_CORNER_COUNT] = {
+	/* URF */ { { 0, 2 }, { RUBIX_CUBE_SQUARE_TOP, RUBIX_CUBE_SQUARE_RIGHT, RUBIX_CUBE_SQUARE_FRONT } },
+	/* UFL */ { { 0, 0 }, { RUBIX_CUBE_SQUARE_TOP, RUBIX_CUBE_SQUARE_FRONT, RUBIX_CUBE_SQUARE_LEFT } },
+	/* ULB */ { { 2, 0 }, { RUBIX_CUBE_SQUARE_TOP, RUBIX_CUBE_SQUARE_LEFT, RUBIX_CUBE_SQUARE_BACK } },
+	/* UBR */ { { 2, 2 }, { RUBIX_CUBE_SQUARE_TOP, RUBIX_CUBE_SQUARE_BACK, RUBIX_CUBE_SQUARE_RIGHT } },
+	/* DFR */ { { 0, 8 }, { RUBIX_CUBE_SQUARE_BOTTOM, RUBIX_CUBE_SQUARE_FRONT, RUBIX_CUBE_SQUARE_RIGHT } },
+	/* DLF */ { { 0, 6 }, { RUBIX_CUBE_SQUARE_BOTTOM, RUBIX_CUBE_SQUARE_LEFT, RUBIX_CUBE_SQUARE_FRONT } },
+	/* DBL */ { { 2, 6 }, { RUBIX_CUBE_SQUARE_BOTTOM, RUBIX_CUBE_SQUARE_BACK, RUBIX_CUBE_SQUARE_LEFT } },
+	/* DRB */ { { 2, 8 }, { RUBIX_CUBE_SQUARE_BOTTOM, RUBIX_CUBE_SQUARE_RIGHT, RUBIX_CUBE_SQUARE_BACK } }
+} ;
+
+const RubixCubeEdgePosition rubix_cube_edge_positions[RUBIX_CUBE_EDGE_COUNT] = {
+	/* UR */ { { 1, 2 }, { RUBIX_CUBE_SQUARE_TOP, RUBIX_CUBE_SQUARE_RIGHT } },
+	/* UF */ { { 0, 1 }, { RUBIX_CUBE_SQUARE_TOP, RUBIX_CUBE_SQUARE_FRONT } },
+	/* UL */ { { 1, 0 }, { RUBIX_CUBE_SQUARE_TOP, RUBIX_CUBE_SQUARE_LEFT } },
+	/* UB */ { { 2, 1 }, { RUBIX_CUBE_SQUARE_TOP, RUBIX_CUBE_SQUARE_BACK } },
+	/* DR */ { { 1, 8 }, { RUBIX_CUBE_SQUARE_BOTTOM, RUBIX_CUBE_SQUARE_RIGHT } },
+	/* DF */ { { 0, 7 }, { RUBIX_CUBE_SQUARE_BOTTOM, RUBIX_CUBE_SQUARE_FRONT } },
+	/* DL */ { { 1, 6 }, { RUBIX_CUBE_SQUARE_BOTTOM, RUBIX_CUBE_SQUARE_LEFT } },
+	/* DB */ { { 2, 7 }, { RUBIX_CUBE_SQUARE_BOTTOM, RUBIX_CUBE_SQUARE_BACK } },
+	/* FR */ { { 0, 5 }, { RUBIX_CUBE_SQUARE_FRONT, RUBIX_CUBE_SQUARE_RIGHT } },
+	/* FL */ { { 0, 3 }, { RUBIX_CUBE_SQUARE_FRONT, RUBIX_CUBE_SQUARE_LEFT } },
+	/* BL */ { { 2, 3 }, { RUBIX_CUBE_SQUARE_BACK, RUBIX_CUBE_SQUARE_LEFT } },
+	/* BR */ { { 2, 5 }, { RUBIX_CUBE_SQUARE_BACK, RUBIX_CUBE_SQUARE_RIGHT } }
+} ;
+
+#define RUBIX_CUBE_PIECE_AT(pRubix_cube, reference) \
+	((pRubix_cube)->planes[(reference).plane][(reference).index])
+
+/* The cubie each of the RUBIX_CUBE_MOVE_COUNT face turns makes out of the identity */
+RubixCubeCubie rubix_cube_cubie_move_table[RUBIX_CUBE_MOVE_COUNT] ;
+
+static pthread_once_t rubix_cube_cubie_tables_once = PTHREAD_ONCE_INIT ;
+
+static void rubix_cube_cubie_build_tables(void) {
+	/* Derive every move from the plane model itself so the two can never disagree */
+	for (size_t side = 0; side < RUBIX_CUBE_SIDE_COUNT; ++side) {
+		for (size_t rotation = 0; rotation < RUBIX_CUBE_FACE_ROTATION_COUNT; ++rotation) {
+			RubixCube moved = rubix_cube_generate_solved() ;
+			rubix_cube_rotate_face(&moved,(RubixCubeSide)side,(RubixCubeFaceRotation)rotation) ;
+			int ok = rubix_cube_cubie_from_cube(&rubix_cube_cubie_move_table[RUBIX_CUBE_MOVE_INDEX(side,rotation)],&moved) ;
+			assert(ok) ; (void)ok ;
+		}
+	}
+}
+
+static inline void rubix_cube_cubie_init_tables(void) {
+	pthread_once(&rubix_cube_cubie_tables_once,rubix_cube_cubie_build_tables) ;
+}
+
+RubixCubeCubie rubix_cube_cubie_generate_solved(void) {
+	return RUBIX_CUBE_CUBIE_SOLVED_LITERAL ;
+}
+
+/* Return the parity (0 even, 1 odd) of a permutation of @count elements */
+static unsigned rubix_cube_permutation_parity(const unsigned char * permutation, size_t count) {
+	unsigned parity = 0 ;
+	for (size_t i = 0; i < count; ++i) {
+		for (size_t j = i + 1; j < count; ++j) {
+			parity ^= permutation[i] > permutation[j] ;
+		}
+	}
+	return parity ;
+}
+
+/* The move tables are built with this, so it must not depend on them */
+int rubix_cube_cubie_from_cube(RubixCubeCubie * dest, RubixCube * pRubix_cube) {
+	if (!dest || !pRubix_cube) return 0 ;
+
+	RubixCube solved = rubix_cube_generate_solved() ;
+	RubixCubeColor top = solved.planes[1][1].sides[RUBIX_CUBE_SQUARE_TOP] ;
+	RubixCubeColor bottom = solved.planes[1][7].sides[RUBIX_CUBE_SQUARE_BOTTOM] ;
+	unsigned corners_seen = 0, edges_seen = 0, twist = 0, flip = 0 ;
+
+	for (size_t i = 0; i < RUBIX_CUBE_CORNER_COUNT; ++i) {
+		const RubixCubeCornerPosition * position = &rubix_cube_corner_positions[i] ;
+		RubixCubeColor colors[3] ;
+		size_t orientation ;
+
+		for (size_t j = 0; j < 3; ++j) {
+			colors[j] = RUBIX_CUBE_PIECE_AT(pRubix_cube,position->piece).sides[position->sides[j]] ;
+		}
+		for (orientation = 0; orientation < 3; ++orientation) {
+			if (colors[orientation] == top || colors[orientation] == bottom) break ;
+		}
+		if (orientation == 3) return 0 ;
+
+		size_t corner ;
+		for (corner = 0; corner < RUBIX_CUBE_CORNER_COUNT; ++corner) {
+			const RubixCubeCornerPosition * home = &rubix_cube_corner_positions[corner] ;
+			if (	colors[(orientation + 1) % 3] == RUBIX_CUBE_PIECE_AT(&solved,home->piece).sides[home->sides[1]] &&
+				colors[(orientation + 2) % 3] == RUBIX_CUBE_PIECE_AT(&solved,home->piece).sides[home->sides[2]] &&
+				colors[orientation] == RUBIX_CUBE_PIECE_AT(&solved,home->piece).sides[home->sides[0]]) break ;
+		}
+		if (corner == RUBIX_CUBE_CORNER_COUNT || corners_seen & (1u << corner)) return 0 ;
+
+		corners_seen |= 1u << corner ;
+		dest->corner_permutation[i] = (unsigned char)corner ;
+		dest->corner_orientation[i] = (unsigned char)orientation ;
+		twist += orientation ;
+	}
+
+	for (size_t i = 0; i < RUBIX_CUBE_EDGE_COUNT; ++i) {
+		const RubixCubeEdgePosition * position = &rubix_cube_edge_positions[i] ;
+		RubixCubeColor first = RUBIX_CUBE_PIECE_AT(pRubix_cube,position->piece).sides[position->sides[0]] ;
+		RubixCubeColor second = RUBIX_CUBE_PIECE_AT(pRubix_cube,position->piece).sides[position->sides[1]] ;
+		size_t edge ;
+		unsigned char orientation = 0 ;
+
+		for (edge = 0; edge < RUBIX_CUBE_EDGE_COUNT; ++edge) {
+			const RubixCubeEdgePosition * home = &rubix_cube_edge_positions[edge] ;
+			RubixCubeColor home_first = RUBIX_CUBE_PIECE_AT(&solved,home->piece).sides[home->sides[0]] ;
+			RubixCubeColor home_second = RUBIX_CUBE_PIECE_AT(&solved,home->piece).sides[home->sides[1]] ;
+			if (first == home_first && second == home_second) break ;
+			if (first == home_second && second == home_first) { orientation = 1 ; break ; }
+		}
+		if (edge == RUBIX_CUBE_EDGE_COUNT || edges_seen & (1u << edge)) return 0 ;
+
+		edges_seen |= 1u << edge ;
+		dest->edge_permutation[i] = (unsigned char)edge ;
+		dest->edge_orientation[i] = orientation ;
+		flip += orientation ;
+	}
+
+	/* Twisted corners, flipped edges and swapped pairs cannot be reached by turning faces */
+	if (twist % 3 || flip % 2) return 0 ;
+	if (rubix_cube_permutation_parity(dest->corner_permutation,RUBIX_CUBE_CORNER_COUNT) !=
+		rubix_cube_permutation_parity(dest->edge_permutation,RUBIX_CUBE_EDGE_COUNT)) return 0 ;
+
+	/* Anything else (moved centers, stray colors in null slots) shows up as a lossy round trip */
+	RubixCube round_trip = rubix_cube_cubie_to_cube(dest) ;
+	return rubix_cube_equivelence_check(&round_trip,pRubix_cube) ;
+}
+
+RubixCube rubix_cube_cubie_to_cube(RubixCubeCubie * pCubie) {
+	RubixCube solved = rubix_cube_generate_solved() ;
+	RubixCube new = solved ;
+
+	for (size_t i = 0; i < RUBIX_CUBE_CORNER_COUNT; ++i) {
+		const RubixCubeCornerPosition * position = &rubix_cube_corner_positions[i] ;
+		const RubixCubeCornerPosition * home = &rubix_cube_corner_positions[pCubie->corner_permutation[i]] ;
+		for (size_t j = 0; j < 3; ++j) {
+			RUBIX_CUBE_PIECE_AT(&new,position->piece).sides[position->sides[(j + pCubie->corner_orientation[i]) % 3]] =
+				RUBIX_CUBE_PIECE_AT(&solved,home->piece).sides[home->sides[j]] ;
+		}
+	}
+
+	for (size_t i = 0; i < RUBIX_CUBE_EDGE_COUNT; ++i) {
+		const RubixCubeEdgePosition * position = &rubix_cube_edge_positions[i] ;
+		const RubixCubeEdgePosition * home = &rubix_cube_edge_positions[pCubie->edge_permutation[i]] ;
+		for (size_t j = 0; j < 2; ++j) {
+			RUBIX_CUBE_PIECE_AT(&new,position->piece).sides[position->sides[(j + pCubie->edge_orientation[i]) % 2]] =
+				RUBIX_CUBE_PIECE_AT(&solved,home->piece).sides[home->sides[j]] ;
+		}
+	}
+
+	return new ;
+}
+
+void rubix_cube_cubie_multiply(RubixCubeCubie * dest, const RubixCubeCubie * first, const RubixCubeCubie * second) {
+	RubixCubeCubie product ;
+
+	for (size_t i = 0; i < RUBIX_CUBE_CORNER_COUNT; ++i) {
+		unsigned char from = second->corner_permutation[i] ;
+		product.corner_permutation[i] = first->corner_permutation[from] ;
+		product.corner_orientation[i] = (first->corner_orientation[from] + second->corner_orientation[i]) % 3 ;
+	}
+	for (size_t i = 0; i < RUBIX_CUBE_EDGE_COUNT; ++i) {
+		unsigned char from = second->edge_permutation[i] ;
+		product.edge_permutation[i] = first->edge_permutation[from] ;
+		product.edge_orientation[i] = first->edge_orientation[from] ^ second->edge_orientation[i] ;
+	}
+
+	*dest = product ;
+}
+
+const RubixCubeCubie * rubix_cube_cubie_get_move(RubixCubeSide side, RubixCubeFaceRotation face_rotation) {
+	rubix_cube_cubie_init_tables() ;
+	return &rubix_cube_cubie_move_table[RUBIX_CUBE_MOVE_INDEX(side,face_rotation)] ;
+}
+
+void rubix_cube_cubie_rotate_face(RubixCubeCubie * pCubie, RubixCubeSide side, RubixCubeFaceRotation face_rotation) {
+	rubix_cube_cubie_init_tables() ;
+	rubix_cube_cubie_multiply(pCubie,pCubie,&rubix_cube_cubie_move_table[RUBIX_CUBE_MOVE_INDEX(side,face_rotation)]) ;
+}
+
+void rubix_cube_cubie_apply_move(RubixCubeCubie * pCubie, RubixCubeMove * move) {
+	if (move) rubix_cube_cubie_rotate_face(pCubie,move->side,move->rotation) ;
+}
+
+void rubix_cube_cubie_apply_scramble(RubixCubeCubie * pCubie, RubixCubeScramble * pScramble) {
+	for (size_t i = 0; i < pScramble->size; ++i) {
+		rubix_cube_cubie_apply_move(pCubie,&pScramble->moves[i]) ;
+	}
+}
+
+int rubix_cube_cubie_equivelence_check(const RubixCubeCubie * first, const RubixCubeCubie * second) {
+	if (!first && !second) return 1 ;
+	if (!first || !second) return 0 ;
+	return !memcmp(first,second,sizeof(RubixCubeCubie)) ;
+}
+
+int rubix_cube_cubie_is_solved(const RubixCubeCubie * pCubie) {
+	return rubix_cube_cubie_equivelence_check(pCubie,&RUBIX_CUBE_CUBIE_IDENTITY) ;
+}
@@ -0,0 +1,123 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Cubie level model:
+ *
+ * Instead of storing every color of every piece, a cube can be described by
+ * where each of the 8 corner pieces and 12 edge pieces is (permutation) and
+ * how it is twisted in that spot (orientation). The center pieces never move
+ * under face rotations so they are not stored at all.
+ *
+ * Corners and edges are named by the sides they touch using the usual letters:
+ * U = top, D = bottom, F = front, B = back, R = right, L = left
+ *
+ * corner_permutation[i] is the corner that currently sits in position i
+ * corner_orientation[i] is 0, 1 or 2 clockwise twists of that corner
+ * edge_permutation[i]   is the edge that currently sits in position i
+ * edge_orientation[i]   is 0 or 1 (flipped) for that edge
+ *
+ * This is the same convention used by most cube solving literature, so the
+ * coordinates built on top of it can be compared against published numbers.
+ */
+
+#ifndef RUBIX_CUBE_CUBIE_H
+#define RUBIX_CUBE_CUBIE_H "rubix_cube_cubie.h"
+
+#include "rubix_cube.h"
+
+#define RUBIX_CUBE_CORNER_COUNT 	8
+#define RUBIX_CUBE_EDGE_COUNT 		12
+
+typedef enum rubix_cube_corner {
+	RUBIX_CUBE_CORNER_URF,
+	RUBIX_CUBE_CORNER_UFL,
+	RUBIX_CUBE_CORNER_ULB,
+	RUBIX_CUBE_CORNER_UBR,
+	RUBIX_CUBE_CORNER_DFR,
+	RUBIX_CUBE_CORNER_DLF,
+	RUBIX_CUBE_CORNER_DBL,
+	RUBIX_CUBE_CORNER_DRB
+} RubixCubeCorner ;
+
+typedef enum rubix_cube_edge {
+	RUBIX_CUBE_EDGE_UR,
+	RUBIX_CUBE_EDGE_UF,
+	RUBIX_CUBE_EDGE_UL,
+	RUBIX_CUBE_EDGE_UB,
+	RUBIX_CUBE_EDGE_DR,
+	RUBIX_CUBE_EDGE_DF,
+	RUBIX_CUBE_EDGE_DL,
+	RUBIX_CUBE_EDGE_DB,
+	RUBIX_CUBE_EDGE_FR,
+	RUBIX_CUBE_EDGE_FL,
+	RUBIX_CUBE_EDGE_BL,
+	RUBIX_CUBE_EDGE_BR
+} RubixCubeEdge ;
+
+/* 40 bytes, versus the 648 bytes of a RubixCube */
+typedef struct rubix_cube_cubie {
+	unsigned char corner_permutation	[RUBIX_CUBE_CORNER_COUNT] ;
+	unsigned char corner_orientation	[RUBIX_CUBE_CORNER_COUNT] ;
+	unsigned char edge_permutation		[RUBIX_CUBE_EDGE_COUNT] ;
+	unsigned char edge_orientation		[RUBIX_CUBE_EDGE_COUNT] ;
+} RubixCubeCubie ;
+
+#define RUBIX_CUBE_CUBIE_SOLVED_LITERAL \
+	(RubixCubeCubie) { \
+		.corner_permutation 	= { 0, 1, 2, 3, 4, 5, 6, 7 }, \
+		.corner_orientation 	= { 0 }, \
+		.edge_permutation 	= { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 }, \
+		.edge_orientation 	= { 0 } \
+	}
+
+#define RUBIX_CUBE_CUBIE_IDENTITY RUBIX_CUBE_CUBIE_SOLVED_LITERAL
+
+/* Get a copy of the solved cubie literal */
+RubixCubeCubie rubix_cube_cubie_generate_solved() ;
+
+/* Convert @pRubix_cube to cubie form in @dest */
+/* Return nonzero on success, 0 if the colors do not describe a cube reachable by face rotations */
+int rubix_cube_cubie_from_cube(RubixCubeCubie * dest, RubixCube * pRubix_cube) ;
+
+/* Get the full RubixCube described by @pCubie */
+RubixCube rubix_cube_cubie_to_cube(RubixCubeCubie * pCubie) ;
+
+/* Set @dest to the result of doing everything in @first, then everything in @second */
+/* @dest may alias either argument */
+void rubix_cube_cubie_multiply(RubixCubeCubie * dest, const RubixCubeCubie * first, const RubixCubeCubie * second) ;
+
+/* Same as rubix_cube_rotate_face(), on a cubie */
+void rubix_cube_cubie_rotate_face(RubixCubeCubie * pCubie, RubixCubeSide side, RubixCubeFaceRotation face_rotation) ;
+
+/* Same as rubix_cube_apply_move(), on a cubie */
+void rubix_cube_cubie_apply_move(RubixCubeCubie * pCubie, RubixCubeMove * move) ;
+
+/* Same as rubix_cube_apply_scramble(), on a cubie */
+void rubix_cube_cubie_apply_scramble(RubixCubeCubie * pCubie, RubixCubeScramble * pScramble) ;
+
+/* Get the cubie that a single move turns the solved cube into */
+const RubixCubeCubie * rubix_cube_cubie_get_move(RubixCubeSide side, RubixCubeFaceRotation face_rotation) ;
+
+/* Return nonzero if the two cubies describe the same cube, else return 0 */
+int rubix_cube_cubie_equivelence_check(const RubixCubeCubie * first, const RubixCubeCubie * second) ;
+
+/* Return 0 if the cubie is not solved, else return nonzero value */
+int rubix_cube_cubie_is_solved(const RubixCubeCubie * pCubie) ;
+
+#endif // RUBIX_CUBE_CUBIE_H
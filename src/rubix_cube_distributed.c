@@ -0,0 +1,728 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+#include "rubix_cube_distributed.h"
+#include "rubix_cube_storage.h"
+#include <errno.h>
+#include <netdb.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+/* Messages from the coordinator */
+#define RUBIX_CUBE_DISTRIBUTED_JOB 		1
+#define RUBIX_CUBE_DISTRIBUTED_SUBTREE 		2
+#define RUBIX_CUBE_DISTRIBUTED_SPLIT 		3
+#define RUBIX_CUBE_DISTRIBUTED_CANCEL 		4
+#define RUBIX_CUBE_DISTRIBUTED_QUIT 		5
+
+/* Messages from the workers */
+#define RUBIX_CUBE_DISTRIBUTED_READY 		16
+#define RUBIX_CUBE_DISTRIBUTED_DONE 		17
+#define RUBIX_CUBE_DISTRIBUTED_FOUND 		18
+#define RUBIX_CUBE_DISTRIBUTED_GIVEN 		19
+
+/* Job kinds */
+#define RUBIX_CUBE_DISTRIBUTED_KIND_SOLVE 	0
+#define RUBIX_CUBE_DISTRIBUTED_KIND_ENUMERATE 	1
+
+#define RUBIX_CUBE_DISTRIBUTED_NO_SIDE 		RUBIX_CUBE_SIDE_COUNT
+#define RUBIX_CUBE_DISTRIBUTED_NO_BOUND 	0xffu	/* nothing went over the bound */
+
+/* How many nodes a worker searches between looks at its connection */
+#define RUBIX_CUBE_DISTRIBUTED_CHECK_NODES 	4096
+
+/* A worker only gives away subtrees at least this many moves deep */
+#define RUBIX_CUBE_DISTRIBUTED_MIN_SPLIT 	3
+
+#define RUBIX_CUBE_DISTRIBUTED_BUFFERED 	32	/* messages read ahead per connection */
+
+/* Canonical sequences only, as in the optimal solver */
+#define RUBIX_CUBE_DISTRIBUTED_CANONICAL(side, last_side) \
+	((side) != (last_side) && !((last_side) != RUBIX_CUBE_DISTRIBUTED_NO_SIDE && (side) == RUBIX_CUBE_SQUARE_OPPOSITE(last_side) && (side) < (last_side)))
+
+typedef struct rubix_cube_distributed_message {
+	unsigned 			type ;
+	unsigned 			length ;	/* of @moves */
+	unsigned 			bound ;
+	unsigned 			kind ;
+	uint32_t 			round ;
+	unsigned long long 		values[2] ;
+	unsigned long long 		nodes ;
+	unsigned char 			moves[RUBIX_CUBE_DISTRIBUTED_MAX_DEPTH] ;
+} RubixCubeDistributedMessage ;
+
+typedef struct rubix_cube_distributed_frame {
+	RubixCubeCubie 			cubie ;
+	unsigned char 			next ;		/* the next move code to try */
+	unsigned char 			end ;		/* and the first one not to, lowered when some are given away */
+	unsigned char 			last_side ;
+} RubixCubeDistributedFrame ;
+
+/* One connection of rubix_cube_distributed_work() */
+typedef struct rubix_cube_distributed_worker {
+	int 				fd ;
+	const RubixCubeSolver * 	pSolver ;
+	const RubixCubeCubie * 		moves[RUBIX_CUBE_MOVE_COUNT] ;
+	const char * 			host ;
+	unsigned 			port ;
+	int 				connected ;
+	pthread_t 			thread ;
+	/* the job */
+	unsigned 			kind ;
+	RubixCubeCubie 			start ;
+	/* the subtree being searched */
+	uint32_t 			round ;
+	unsigned 			bound ;
+	size_t 				root ;
+	unsigned char 			path[RUBIX_CUBE_DISTRIBUTED_MAX_DEPTH] ;
+	RubixCubeDistributedFrame 	frames[RUBIX_CUBE_DISTRIBUTED_MAX_DEPTH + 1] ;
+	size_t 				top ;
+	unsigned long long 		nodes ;
+	unsigned long long 		sequences ;
+	unsigned long long 		solved ;
+	unsigned 			exceeded ;
+	size_t 				length ;	/* of the solution, once found */
+	int 				found ;
+	int 				cancelled ;
+	int 				quit ;
+} RubixCubeDistributedWorker ;
+
+typedef struct rubix_cube_distributed_connection {
+	int 				fd ;
+	unsigned char 			input[RUBIX_CUBE_DISTRIBUTED_BUFFERED * RUBIX_CUBE_DISTRIBUTED_MESSAGE_SIZE] ;
+	size_t 				size ;
+	unsigned 			job ;		/* the last job it was sent */
+	int 				busy ;
+	int 				split_asked ;
+	RubixCubeDistributedMessage 	subtree ;	/* the one it is on, kept to hand out again if it goes away */
+} RubixCubeDistributedConnection ;
+
+struct rubix_cube_distributed {
+	int 				listener ;
+	unsigned 			port ;
+	size_t 				prefix_length ;
+	RubixCubeDistributedConnection * connections[RUBIX_CUBE_DISTRIBUTED_MAX_WORKERS] ;
+	size_t 				number_of_connections ;
+	/* the job and round under way */
+	unsigned 			job ;
+	RubixCubeDistributedMessage 	job_message ;
+	uint32_t 			round ;
+	RubixCubeDistributedMessage * 	queue ;		/* subtrees nobody has yet, taken from the end */
+	size_t 				queued ;
+	size_t 				queue_capacity ;
+	size_t 				busy ;
+	unsigned 			exceeded ;
+	int 				found ;
+	int 				lost ;
+	RubixCubeDistributedMessage 	solution ;
+	RubixCubeDistributedStats 	stats ;
+} ;
+
+static void rubix_cube_distributed_put(unsigned char * bytes, unsigned long long value, size_t size) {
+	for (size_t i = 0; i < size; ++i) bytes[i] = (unsigned char)(value >> (8 * i)) ;
+}
+
+static unsigned long long rubix_cube_distributed_get(const unsigned char * bytes, size_t size) {
+	unsigned long long value = 0 ;
+	for (size_t i = 0; i < size; ++i) value |= (unsigned long long)bytes[i] << (8 * i) ;
+	return value ;
+}
+
+static void rubix_cube_distributed_encode(unsigned char * bytes, const RubixCubeDistributedMessage * pMessage) {
+	memset(bytes,0,RUBIX_CUBE_DISTRIBUTED_MESSAGE_SIZE) ;
+	bytes[0] = (unsigned char)pMessage->type ;
+	bytes[1] = (unsigned char)pMessage->length ;
+	bytes[2] = (unsigned char)pMessage->bound ;
+	bytes[3] = (unsigned char)pMessage->kind ;
+	rubix_cube_distributed_put(&bytes[4],pMessage->round,4) ;
+	rubix_cube_distributed_put(&bytes[8],pMessage->values[0],8) ;
+	rubix_cube_distributed_put(&bytes[16],pMessage->values[1],8) ;
+	rubix_cube_distributed_put(&bytes[24],pMessage->nodes,8) ;
+	memcpy(&bytes[32],pMessage->moves,pMessage->length) ;
+}
+
+/* Return 0 for a message no side would send */
+static int rubix_cube_distributed_decode(RubixCubeDistributedMessage * pMessage, const unsigned char * bytes) {
+	memset(pMessage,0,sizeof(*pMessage)) ;
+	pMessage->type = bytes[0] ;
+	pMessage->length = bytes[1] ;
+	pMessage->bound = bytes[2] ;
+	pMessage->kind = bytes[3] ;
+	pMessage->round = (uint32_t)rubix_cube_distributed_get(&bytes[4],4) ;
+	pMessage->values[0] = rubix_cube_distributed_get(&bytes[8],8) ;
+	pMessage->values[1] = rubix_cube_distributed_get(&bytes[16],8) ;
+	pMessage->nodes = rubix_cube_distributed_get(&bytes[24],8) ;
+	if (pMessage->length > RUBIX_CUBE_DISTRIBUTED_MAX_DEPTH) return 0 ;
+	memcpy(pMessage->moves,&bytes[32],pMessage->length) ;
+	for (size_t i = 0; i < pMessage->length; ++i) {
+		if (pMessage->moves[i] >= RUBIX_CUBE_MOVE_COUNT) return 0 ;
+	}
+	return 1 ;
+}
+
+static int rubix_cube_distributed_send(int fd, const RubixCubeDistributedMessage * pMessage) {
+	unsigned char bytes[RUBIX_CUBE_DISTRIBUTED_MESSAGE_SIZE] ;
+	size_t sent = 0 ;
+
+	rubix_cube_distributed_encode(bytes,pMessage) ;
+	while (sent < sizeof(bytes)) {
+		ssize_t size = send(fd,&bytes[sent],sizeof(bytes) - sent,MSG_NOSIGNAL) ;
+		if (size < 0 && errno == EINTR) continue ;
+		if (size <= 0) return 0 ;
+		sent += (size_t)size ;
+	}
+	return 1 ;
+}
+
+/* Wait for a whole message, return 0 if the connection is gone or sent garbage */
+static int rubix_cube_distributed_receive(int fd, RubixCubeDistributedMessage * pMessage) {
+	unsigned char bytes[RUBIX_CUBE_DISTRIBUTED_MESSAGE_SIZE] ;
+	size_t received = 0 ;
+
+	while (received < sizeof(bytes)) {
+		ssize_t size = recv(fd,&bytes[received],sizeof(bytes) - received,0) ;
+		if (size < 0 && errno == EINTR) continue ;
+		if (size <= 0) return 0 ;
+		received += (size_t)size ;
+	}
+	return rubix_cube_distributed_decode(pMessage,bytes) ;
+}
+
+/* The start state travels packed, in the two values of the job */
+static void rubix_cube_distributed_pack_start(RubixCubeDistributedMessage * pMessage, const RubixCubePacked * pPacked) {
+	pMessage->values[0] = rubix_cube_distributed_get(pPacked->bytes,8) ;
+	pMessage->values[1] = rubix_cube_distributed_get(&pPacked->bytes[8],8) ;
+}
+
+static int rubix_cube_distributed_unpack_start(RubixCubeCubie * dest, const RubixCubeDistributedMessage * pMessage) {
+	RubixCubePacked packed ;
+	rubix_cube_distributed_put(packed.bytes,pMessage->values[0],8) ;
+	rubix_cube_distributed_put(&packed.bytes[8],pMessage->values[1],8) ;
+	return rubix_cube_unpack_cubie(dest,&packed) ;
+}
+
+/*
+ * Worker side
+ */
+
+/* Count @pCubie, @depth moves in, and return nonzero if its children are to be searched */
+static int rubix_cube_distributed_visit(RubixCubeDistributedWorker * pWorker, const RubixCubeCubie * pCubie, size_t depth) {
+	unsigned estimate ;
+
+	++pWorker->nodes ;
+	if (pWorker->kind == RUBIX_CUBE_DISTRIBUTED_KIND_ENUMERATE) {
+		if (depth < pWorker->bound) return 1 ;
+		++pWorker->sequences ;
+		pWorker->solved += (unsigned long long)rubix_cube_cubie_is_solved(pCubie) ;
+		return 0 ;
+	}
+
+	estimate = pWorker->pSolver ? rubix_cube_solver_estimate(pWorker->pSolver,pCubie) : 0 ;
+	if (depth + estimate > pWorker->bound) {
+		if (depth + estimate < pWorker->exceeded) pWorker->exceeded = (unsigned)(depth + estimate) ;
+		return 0 ;
+	}
+	if (!estimate && rubix_cube_cubie_is_solved(pCubie)) {
+		pWorker->found = 1 ;
+		pWorker->length = depth ;
+		return 0 ;
+	}
+	if (depth == pWorker->bound) {
+		if (depth + 1 < pWorker->exceeded) pWorker->exceeded = (unsigned)(depth + 1) ;
+		return 0 ;
+	}
+	return 1 ;
+}
+
+/* Give back half of the untried moves at the shallowest depth that has a few, each one a subtree of its own */
+static void rubix_cube_distributed_split(RubixCubeDistributedWorker * pWorker) {
+	for (size_t depth = pWorker->root; depth <= pWorker->top && depth + RUBIX_CUBE_DISTRIBUTED_MIN_SPLIT <= pWorker->bound; ++depth) {
+		RubixCubeDistributedFrame * pFrame = &pWorker->frames[depth] ;
+		unsigned char untried[RUBIX_CUBE_MOVE_COUNT] ;
+		size_t count = 0 ;
+
+		for (unsigned code = pFrame->next; code < pFrame->end; ++code) {
+			if (RUBIX_CUBE_DISTRIBUTED_CANONICAL(code / RUBIX_CUBE_FACE_ROTATION_COUNT,pFrame->last_side)) untried[count++] = (unsigned char)code ;
+		}
+		if (count < 2) continue ;
+
+		for (size_t i = count - count / 2; i < count; ++i) {
+			RubixCubeDistributedMessage given = {
+				.type 	= RUBIX_CUBE_DISTRIBUTED_GIVEN,
+				.length = (unsigned)depth + 1,
+				.bound 	= pWorker->bound,
+				.round 	= pWorker->round
+			} ;
+			memcpy(given.moves,pWorker->path,depth) ;
+			given.moves[depth] = untried[i] ;
+			if (!rubix_cube_distributed_send(pWorker->fd,&given)) pWorker->quit = pWorker->cancelled = 1 ;
+		}
+		pFrame->end = untried[count - count / 2] ;
+		return ;
+	}
+}
+
+/* Answer whatever the coordinator sent while searching, up to a cancel: what comes after it is the next job, for the serve loop */
+static void rubix_cube_distributed_check(RubixCubeDistributedWorker * pWorker) {
+	struct pollfd pending = { .fd = pWorker->fd, .events = POLLIN } ;
+	RubixCubeDistributedMessage message ;
+
+	while (!pWorker->quit && !pWorker->cancelled && poll(&pending,1,0) > 0) {
+		if (!rubix_cube_distributed_receive(pWorker->fd,&message)) {
+			pWorker->quit = pWorker->cancelled = 1 ;
+		} else if (message.type == RUBIX_CUBE_DISTRIBUTED_QUIT) {
+			pWorker->quit = pWorker->cancelled = 1 ;
+		} else if (message.type == RUBIX_CUBE_DISTRIBUTED_CANCEL && message.round == pWorker->round) {
+			pWorker->cancelled = 1 ;
+		} else if (message.type == RUBIX_CUBE_DISTRIBUTED_SPLIT && !pWorker->cancelled) {
+			rubix_cube_distributed_split(pWorker) ;
+		}
+	}
+}
+
+/* Search the subtree under @pSubtree depth first, without recursion so it can be split at any depth */
+static void rubix_cube_distributed_search(RubixCubeDistributedWorker * pWorker, const RubixCubeDistributedMessage * pSubtree) {
+	RubixCubeCubie cubie = pWorker->start, child ;
+	unsigned char last_side = RUBIX_CUBE_DISTRIBUTED_NO_SIDE ;
+
+	pWorker->round = pSubtree->round ;
+	pWorker->bound = pSubtree->bound ;
+	pWorker->root = pSubtree->length ;
+	pWorker->nodes = pWorker->sequences = pWorker->solved = 0 ;
+	pWorker->exceeded = RUBIX_CUBE_DISTRIBUTED_NO_BOUND ;
+	pWorker->found = pWorker->cancelled = 0 ;
+
+	for (size_t i = 0; i < pSubtree->length; ++i) {
+		rubix_cube_cubie_multiply(&child,&cubie,pWorker->moves[pSubtree->moves[i]]) ;
+		cubie = child ;
+		pWorker->path[i] = pSubtree->moves[i] ;
+		last_side = (unsigned char)(pSubtree->moves[i] / RUBIX_CUBE_FACE_ROTATION_COUNT) ;
+	}
+	if (!rubix_cube_distributed_visit(pWorker,&cubie,pWorker->root)) return ;
+
+	pWorker->top = pWorker->root ;
+	pWorker->frames[pWorker->top] = (RubixCubeDistributedFrame){ cubie, 0, RUBIX_CUBE_MOVE_COUNT, last_side } ;
+	while (!pWorker->found && !pWorker->cancelled) {
+		RubixCubeDistributedFrame * pFrame = &pWorker->frames[pWorker->top] ;
+		unsigned code ;
+
+		while (pFrame->next < pFrame->end && !RUBIX_CUBE_DISTRIBUTED_CANONICAL(pFrame->next / RUBIX_CUBE_FACE_ROTATION_COUNT,pFrame->last_side)) ++pFrame->next ;
+		if (pFrame->next >= pFrame->end) {
+			if (pWorker->top == pWorker->root) break ;
+			--pWorker->top ;
+			continue ;
+		}
+		code = pFrame->next++ ;
+		pWorker->path[pWorker->top] = (unsigned char)code ;
+		rubix_cube_cubie_multiply(&child,&pFrame->cubie,pWorker->moves[code]) ;
+		if (rubix_cube_distributed_visit(pWorker,&child,pWorker->top + 1)) {
+			++pWorker->top ;
+			pWorker->frames[pWorker->top] = (RubixCubeDistributedFrame){ child, 0, RUBIX_CUBE_MOVE_COUNT, (unsigned char)(code / RUBIX_CUBE_FACE_ROTATION_COUNT) } ;
+		}
+		if (!(pWorker->nodes % RUBIX_CUBE_DISTRIBUTED_CHECK_NODES)) rubix_cube_distributed_check(pWorker) ;
+	}
+}
+
+static int rubix_cube_distributed_connect(const char * host, unsigned port) {
+	struct addrinfo hints = { .ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM }, * addresses, * pAddress ;
+	char service[16] ;
+	int fd = -1, yes = 1 ;
+
+	snprintf(service,sizeof(service),"%u",port) ;
+	if (getaddrinfo(host ? host : "127.0.0.1",service,&hints,&addresses)) return -1 ;
+	for (pAddress = addresses; pAddress && fd < 0; pAddress = pAddress->ai_next) {
+		if ((fd = socket(pAddress->ai_family,pAddress->ai_socktype,pAddress->ai_protocol)) < 0) continue ;
+		if (connect(fd,pAddress->ai_addr,pAddress->ai_addrlen)) {
+			close(fd) ;
+			fd = -1 ;
+		}
+	}
+	freeaddrinfo(addresses) ;
+	if (fd >= 0) setsockopt(fd,IPPROTO_TCP,TCP_NODELAY,&yes,sizeof(yes)) ;
+	return fd ;
+}
+
+static void * rubix_cube_distributed_serve(void * argument) {
+	RubixCubeDistributedWorker * pWorker = (RubixCubeDistributedWorker *)argument ;
+	RubixCubeDistributedMessage message = { .type = RUBIX_CUBE_DISTRIBUTED_READY } ;
+	int have_job = 0 ;
+
+	if ((pWorker->fd = rubix_cube_distributed_connect(pWorker->host,pWorker->port)) < 0) return NULL ;
+	pWorker->connected = 1 ;
+	for (size_t m = 0; m < RUBIX_CUBE_MOVE_COUNT; ++m) {
+		pWorker->moves[m] = rubix_cube_cubie_get_move(m / RUBIX_CUBE_FACE_ROTATION_COUNT,m % RUBIX_CUBE_FACE_ROTATION_COUNT) ;
+	}
+
+	pWorker->quit = !rubix_cube_distributed_send(pWorker->fd,&message) ;
+	while (!pWorker->quit && rubix_cube_distributed_receive(pWorker->fd,&message)) {
+		if (message.type == RUBIX_CUBE_DISTRIBUTED_QUIT) break ;
+		if (message.type == RUBIX_CUBE_DISTRIBUTED_JOB) {
+			pWorker->kind = message.kind ;
+			have_job = rubix_cube_distributed_unpack_start(&pWorker->start,&message) ;
+		}
+		if (message.type != RUBIX_CUBE_DISTRIBUTED_SUBTREE || !have_job) continue ;
+
+		rubix_cube_distributed_search(pWorker,&message) ;
+		if (pWorker->cancelled) continue ;
+
+		memset(&message,0,sizeof(message)) ;
+		message.round = pWorker->round ;
+		message.nodes = pWorker->nodes ;
+		if (pWorker->found) {
+			message.type = RUBIX_CUBE_DISTRIBUTED_FOUND ;
+			message.length = (unsigned)pWorker->length ;
+			memcpy(message.moves,pWorker->path,pWorker->length) ;
+		} else {
+			message.type = RUBIX_CUBE_DISTRIBUTED_DONE ;
+			message.values[0] = pWorker->kind == RUBIX_CUBE_DISTRIBUTED_KIND_ENUMERATE ? pWorker->sequences : pWorker->exceeded ;
+			message.values[1] = pWorker->solved ;
+		}
+		pWorker->quit = !rubix_cube_distributed_send(pWorker->fd,&message) ;
+	}
+	close(pWorker->fd) ;
+	return NULL ;
+}
+
+int rubix_cube_distributed_work(const char * host, unsigned port, const RubixCubeSolver * pSolver, size_t threads) {
+	RubixCubeDistributedWorker * workers ;
+	int success = 1 ;
+
+	if (!threads) {
+		long online = sysconf(_SC_NPROCESSORS_ONLN) ;
+		threads = online > 0 ? (size_t)online : 1 ;
+	}
+	if (!(workers = (RubixCubeDistributedWorker *)calloc(threads,sizeof(RubixCubeDistributedWorker)))) return 0 ;
+	for (size_t i = 0; i < threads; ++i) {
+		workers[i].pSolver = pSolver ;
+		workers[i].host = host ;
+		workers[i].port = port ;
+	}
+
+	/* The calling thread serves the first connection */
+	for (size_t i = 1; i < threads; ++i) {
+		if (pthread_create(&workers[i].thread,NULL,rubix_cube_distributed_serve,&workers[i])) {
+			threads = i ;
+			success = 0 ;
+		}
+	}
+	rubix_cube_distributed_serve(&workers[0]) ;
+	for (size_t i = 1; i < threads; ++i) pthread_join(workers[i].thread,NULL) ;
+	for (size_t i = 0; i < threads; ++i) success &= workers[i].connected ;
+	free(workers) ;
+	return success ;
+}
+
+/*
+ * Coordinator side
+ */
+
+RubixCubeDistributed * rubix_cube_distributed_listen(unsigned port) {
+	struct sockaddr_in address = { .sin_family = AF_INET, .sin_port = htons((uint16_t)port), .sin_addr.s_addr = htonl(INADDR_ANY) } ;
+	socklen_t size = sizeof(address) ;
+	RubixCubeDistributed * pNew ;
+	int yes = 1 ;
+
+	if (port > 65535 || !(pNew = (RubixCubeDistributed *)calloc(1,sizeof(RubixCubeDistributed)))) return NULL ;
+	if ((pNew->listener = socket(AF_INET,SOCK_STREAM,0)) < 0) {
+		free(pNew) ;
+		return NULL ;
+	}
+	setsockopt(pNew->listener,SOL_SOCKET,SO_REUSEADDR,&yes,sizeof(yes)) ;
+	if (bind(pNew->listener,(struct sockaddr *)&address,sizeof(address)) || listen(pNew->listener,SOMAXCONN) ||
+			getsockname(pNew->listener,(struct sockaddr *)&address,&size)) {
+		close(pNew->listener) ;
+		free(pNew) ;
+		return NULL ;
+	}
+	pNew->port = ntohs(address.sin_port) ;
+	pNew->prefix_length = RUBIX_CUBE_DISTRIBUTED_PREFIX_LENGTH ;
+	return pNew ;
+}
+
+int rubix_cube_distributed_set_prefix_length(RubixCubeDistributed * pDistributed, size_t length) {
+	if (length > RUBIX_CUBE_DISTRIBUTED_MAX_DEPTH) return 0 ;
+	pDistributed->prefix_length = length ;
+	return 1 ;
+}
+
+unsigned rubix_cube_distributed_port(const RubixCubeDistributed * pDistributed) {
+	return pDistributed->port ;
+}
+
+void rubix_cube_distributed_close(RubixCubeDistributed * pDistributed) {
+	RubixCubeDistributedMessage quit = { .type = RUBIX_CUBE_DISTRIBUTED_QUIT } ;
+
+	if (!pDistributed) return ;
+	for (size_t i = 0; i < pDistributed->number_of_connections; ++i) {
+		rubix_cube_distributed_send(pDistributed->connections[i]->fd,&quit) ;
+		close(pDistributed->connections[i]->fd) ;
+		free(pDistributed->connections[i]) ;
+	}
+	close(pDistributed->listener) ;
+	free(pDistributed->queue) ;
+	free(pDistributed) ;
+}
+
+static int rubix_cube_distributed_enqueue(RubixCubeDistributed * pDistributed, const RubixCubeDistributedMessage * pSubtree) {
+	if (pDistributed->queued == pDistributed->queue_capacity) {
+		size_t capacity = pDistributed->queue_capacity ? 2 * pDistributed->queue_capacity : 4096 ;
+		RubixCubeDistributedMessage * grown = (RubixCubeDistributedMessage *)realloc(pDistributed->queue,capacity * sizeof(*grown)) ;
+		if (!grown) return 0 ;
+		pDistributed->queue = grown ;
+		pDistributed->queue_capacity = capacity ;
+	}
+	pDistributed->queue[pDistributed->queued++] = *pSubtree ;
+	++pDistributed->stats.subtrees ;
+	return 1 ;
+}
+
+/* Queue every canonical sequence of @length moves after the ones in @pPrefix as a subtree */
+static int rubix_cube_distributed_enqueue_prefixes(RubixCubeDistributed * pDistributed, RubixCubeDistributedMessage * pPrefix, size_t length) {
+	size_t last_side = pPrefix->length ? pPrefix->moves[pPrefix->length - 1] / RUBIX_CUBE_FACE_ROTATION_COUNT : RUBIX_CUBE_DISTRIBUTED_NO_SIDE ;
+
+	if (pPrefix->length == length) return rubix_cube_distributed_enqueue(pDistributed,pPrefix) ;
+	for (unsigned code = 0; code < RUBIX_CUBE_MOVE_COUNT; ++code) {
+		if (!RUBIX_CUBE_DISTRIBUTED_CANONICAL(code / RUBIX_CUBE_FACE_ROTATION_COUNT,last_side)) continue ;
+		pPrefix->moves[pPrefix->length++] = (unsigned char)code ;
+		if (!rubix_cube_distributed_enqueue_prefixes(pDistributed,pPrefix,length)) return 0 ;
+		--pPrefix->length ;
+	}
+	return 1 ;
+}
+
+static void rubix_cube_distributed_drop(RubixCubeDistributed * pDistributed, size_t index) {
+	RubixCubeDistributedConnection * pConnection = pDistributed->connections[index] ;
+
+	if (pConnection->busy) {
+		--pDistributed->busy ;
+		/* What it gave away is already counted elsewhere, a solve only searches some nodes twice */
+		if (pDistributed->job_message.kind == RUBIX_CUBE_DISTRIBUTED_KIND_ENUMERATE) pDistributed->lost = 1 ;
+		else if (!rubix_cube_distributed_enqueue(pDistributed,&pConnection->subtree)) pDistributed->lost = 1 ;
+	}
+	close(pConnection->fd) ;
+	free(pConnection) ;
+	pDistributed->connections[index] = pDistributed->connections[--pDistributed->number_of_connections] ;
+}
+
+/* Stop the round on every worker still at it */
+static void rubix_cube_distributed_cancel(RubixCubeDistributed * pDistributed) {
+	RubixCubeDistributedMessage cancel = { .type = RUBIX_CUBE_DISTRIBUTED_CANCEL, .round = pDistributed->round } ;
+
+	for (size_t i = 0; i < pDistributed->number_of_connections; ++i) {
+		RubixCubeDistributedConnection * pConnection = pDistributed->connections[i] ;
+		if (pConnection->busy) rubix_cube_distributed_send(pConnection->fd,&cancel) ;
+		pConnection->busy = pConnection->split_asked = 0 ;
+	}
+	pDistributed->busy = 0 ;
+	pDistributed->queued = 0 ;
+}
+
+static void rubix_cube_distributed_handle(RubixCubeDistributed * pDistributed, RubixCubeDistributedConnection * pConnection,
+		const RubixCubeDistributedMessage * pMessage) {
+	/* Anything from an earlier round was cancelled and is already accounted for */
+	if (pMessage->round != pDistributed->round) return ;
+
+	if (pMessage->type == RUBIX_CUBE_DISTRIBUTED_GIVEN && pConnection->busy) {
+		RubixCubeDistributedMessage subtree = *pMessage ;
+
+		subtree.type = RUBIX_CUBE_DISTRIBUTED_SUBTREE ;
+		pConnection->split_asked = 0 ;
+		++pDistributed->stats.splits ;
+		if (!rubix_cube_distributed_enqueue(pDistributed,&subtree)) pDistributed->lost = 1 ;
+	} else if ((pMessage->type == RUBIX_CUBE_DISTRIBUTED_DONE || pMessage->type == RUBIX_CUBE_DISTRIBUTED_FOUND) && pConnection->busy) {
+		pConnection->busy = pConnection->split_asked = 0 ;
+		--pDistributed->busy ;
+		pDistributed->stats.nodes += pMessage->nodes ;
+		if (pMessage->type == RUBIX_CUBE_DISTRIBUTED_FOUND) {
+			pDistributed->found = 1 ;
+			pDistributed->solution = *pMessage ;
+		} else if (pDistributed->job_message.kind == RUBIX_CUBE_DISTRIBUTED_KIND_ENUMERATE) {
+			pDistributed->stats.sequences += pMessage->values[0] ;
+			pDistributed->stats.solved += pMessage->values[1] ;
+		} else if (pMessage->values[0] < pDistributed->exceeded) {
+			pDistributed->exceeded = (unsigned)pMessage->values[0] ;
+		}
+	}
+}
+
+/* Read what @pConnection sent, return 0 once it is gone */
+static int rubix_cube_distributed_read(RubixCubeDistributed * pDistributed, RubixCubeDistributedConnection * pConnection) {
+	ssize_t size = recv(pConnection->fd,&pConnection->input[pConnection->size],sizeof(pConnection->input) - pConnection->size,MSG_DONTWAIT) ;
+	size_t used = 0 ;
+
+	if (size < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ;
+	if (size == 0) return 0 ;
+	pConnection->size += (size_t)size ;
+	for (; pConnection->size - used >= RUBIX_CUBE_DISTRIBUTED_MESSAGE_SIZE; used += RUBIX_CUBE_DISTRIBUTED_MESSAGE_SIZE) {
+		RubixCubeDistributedMessage message ;
+		if (!rubix_cube_distributed_decode(&message,&pConnection->input[used])) return 0 ;
+		rubix_cube_distributed_handle(pDistributed,pConnection,&message) ;
+	}
+	memmove(pConnection->input,&pConnection->input[used],pConnection->size - used) ;
+	pConnection->size -= used ;
+	return 1 ;
+}
+
+/* Hand out subtrees to the idle workers, or if there are none left ask the busy ones to split theirs */
+static void rubix_cube_distributed_dispatch(RubixCubeDistributed * pDistributed) {
+	RubixCubeDistributedMessage split = { .type = RUBIX_CUBE_DISTRIBUTED_SPLIT, .round = pDistributed->round } ;
+	size_t idle = 0 ;
+
+	for (size_t i = 0; i < pDistributed->number_of_connections; ++i) {
+		RubixCubeDistributedConnection * pConnection = pDistributed->connections[i] ;
+
+		if (pConnection->busy) continue ;
+		if (!pDistributed->queued) {
+			++idle ;
+			continue ;
+		}
+		if (pConnection->job != pDistributed->job && rubix_cube_distributed_send(pConnection->fd,&pDistributed->job_message)) pConnection->job = pDistributed->job ;
+		pConnection->subtree = pDistributed->queue[--pDistributed->queued] ;
+		pConnection->subtree.round = pDistributed->round ;
+		/* A send that fails shows up as a closed connection on the next poll, which queues the subtree again */
+		rubix_cube_distributed_send(pConnection->fd,&pConnection->subtree) ;
+		pConnection->busy = 1 ;
+		++pDistributed->busy ;
+	}
+	for (size_t i = 0; idle && i < pDistributed->number_of_connections; ++i) {
+		RubixCubeDistributedConnection * pConnection = pDistributed->connections[i] ;
+		if (!pConnection->busy || pConnection->split_asked) continue ;
+		rubix_cube_distributed_send(pConnection->fd,&split) ;
+		pConnection->split_asked = 1 ;
+		--idle ;
+	}
+}
+
+static void rubix_cube_distributed_accept(RubixCubeDistributed * pDistributed) {
+	RubixCubeDistributedConnection * pConnection ;
+	int fd = accept(pDistributed->listener,NULL,NULL), yes = 1 ;
+
+	if (fd < 0) return ;
+	if (pDistributed->number_of_connections == RUBIX_CUBE_DISTRIBUTED_MAX_WORKERS ||
+			!(pConnection = (RubixCubeDistributedConnection *)calloc(1,sizeof(RubixCubeDistributedConnection)))) {
+		close(fd) ;
+		return ;
+	}
+	setsockopt(fd,IPPROTO_TCP,TCP_NODELAY,&yes,sizeof(yes)) ;
+	pConnection->fd = fd ;
+	pDistributed->connections[pDistributed->number_of_connections++] = pConnection ;
+}
+
+/* Run one round over what is queued, until everything came back, a solution turned up or a worker was lost */
+static void rubix_cube_distributed_round(RubixCubeDistributed * pDistributed) {
+	struct pollfd fds[RUBIX_CUBE_DISTRIBUTED_MAX_WORKERS + 1] ;
+
+	pDistributed->exceeded = RUBIX_CUBE_DISTRIBUTED_NO_BOUND ;
+	++pDistributed->stats.rounds ;
+	for (;;) {
+		size_t count = pDistributed->number_of_connections ;
+
+		if (pDistributed->found || pDistributed->lost) {
+			rubix_cube_distributed_cancel(pDistributed) ;
+			return ;
+		}
+		rubix_cube_distributed_dispatch(pDistributed) ;
+		if (!pDistributed->queued && !pDistributed->busy) return ;
+
+		fds[0] = (struct pollfd){ .fd = pDistributed->listener, .events = POLLIN } ;
+		for (size_t i = 0; i < count; ++i) fds[i + 1] = (struct pollfd){ .fd = pDistributed->connections[i]->fd, .events = POLLIN } ;
+		if (poll(fds,count + 1,-1) < 0) continue ;
+
+		/* From the back, so dropping a connection only moves ones already looked at */
+		for (size_t i = count; i > 0; --i) {
+			if (fds[i].revents && !rubix_cube_distributed_read(pDistributed,pDistributed->connections[i - 1])) rubix_cube_distributed_drop(pDistributed,i - 1) ;
+		}
+		if (fds[0].revents & POLLIN) rubix_cube_distributed_accept(pDistributed) ;
+	}
+}
+
+/* Start a new job from @pStart, which every worker gets before its first subtree of it */
+static int rubix_cube_distributed_start(RubixCubeDistributed * pDistributed, const RubixCubeCubie * pStart, unsigned kind) {
+	RubixCubeCubie solved = rubix_cube_cubie_generate_solved() ;
+	RubixCubePacked packed ;
+
+	if (!rubix_cube_pack_cubie(&packed,pStart ? pStart : &solved)) return 0 ;
+	memset(&pDistributed->stats,0,sizeof(pDistributed->stats)) ;
+	memset(&pDistributed->job_message,0,sizeof(pDistributed->job_message)) ;
+	pDistributed->job_message.type = RUBIX_CUBE_DISTRIBUTED_JOB ;
+	pDistributed->job_message.kind = kind ;
+	rubix_cube_distributed_pack_start(&pDistributed->job_message,&packed) ;
+	++pDistributed->job ;
+	pDistributed->found = pDistributed->lost = 0 ;
+	return 1 ;
+}
+
+/* Queue the subtrees of a round searching @bound moves deep */
+static int rubix_cube_distributed_prepare(RubixCubeDistributed * pDistributed, unsigned bound) {
+	RubixCubeDistributedMessage prefix = { .type = RUBIX_CUBE_DISTRIBUTED_SUBTREE, .bound = bound } ;
+
+	++pDistributed->round ;
+	pDistributed->queued = 0 ;
+	return rubix_cube_distributed_enqueue_prefixes(pDistributed,&prefix,bound < pDistributed->prefix_length ? bound : pDistributed->prefix_length) ;
+}
+
+static void rubix_cube_distributed_finish(RubixCubeDistributed * pDistributed, RubixCubeDistributedStats * pStats) {
+	pDistributed->stats.workers = pDistributed->number_of_connections ;
+	if (pStats) *pStats = pDistributed->stats ;
+}
+
+RubixCubeScramble * rubix_cube_distributed_solve(RubixCubeDistributed * pDistributed, const RubixCubeCubie * pCubie, size_t max_depth,
+		RubixCubeDistributedStats * pStats) {
+	RubixCubeScramble * pNew ;
+	unsigned bound = 0 ;
+
+	if (max_depth > RUBIX_CUBE_SOLVER_MAX_DEPTH) max_depth = RUBIX_CUBE_SOLVER_MAX_DEPTH ;
+	if (!rubix_cube_distributed_start(pDistributed,pCubie,RUBIX_CUBE_DISTRIBUTED_KIND_SOLVE)) return NULL ;
+	while (bound <= max_depth && !pDistributed->found && !pDistributed->lost) {
+		if (!rubix_cube_distributed_prepare(pDistributed,bound)) break ;
+		rubix_cube_distributed_round(pDistributed) ;
+		bound = pDistributed->exceeded ;
+	}
+	rubix_cube_distributed_finish(pDistributed,pStats) ;
+	if (!pDistributed->found) return NULL ;
+
+	if (!(pNew = (RubixCubeScramble *)malloc(sizeof(RubixCubeScramble)))) return NULL ;
+	pNew->capacity = pDistributed->solution.length ? pDistributed->solution.length : 1 ;
+	if (!(pNew->moves = (RubixCubeMove *)malloc(sizeof(RubixCubeMove) * pNew->capacity))) {
+		free(pNew) ; return NULL ;
+	}
+	pNew->size = pDistributed->solution.length ;
+	pNew->seed = 0 ;
+	for (size_t i = 0; i < pNew->size; ++i) {
+		pNew->moves[i] = (RubixCubeMove){ (RubixCubeSide)(pDistributed->solution.moves[i] / RUBIX_CUBE_FACE_ROTATION_COUNT),
+			(RubixCubeFaceRotation)(pDistributed->solution.moves[i] % RUBIX_CUBE_FACE_ROTATION_COUNT) } ;
+	}
+	return pNew ;
+}
+
+int rubix_cube_distributed_enumerate(RubixCubeDistributed * pDistributed, const RubixCubeCubie * pStart, size_t depth,
+		RubixCubeDistributedStats * pStats) {
+	if (depth > RUBIX_CUBE_DISTRIBUTED_MAX_DEPTH) return 0 ;
+	if (!rubix_cube_distributed_start(pDistributed,pStart,RUBIX_CUBE_DISTRIBUTED_KIND_ENUMERATE)) return 0 ;
+	if (rubix_cube_distributed_prepare(pDistributed,(unsigned)depth)) rubix_cube_distributed_round(pDistributed) ;
+	else pDistributed->lost = 1 ;
+	rubix_cube_distributed_finish(pDistributed,pStats) ;
+	return !pDistributed->lost ;
+}
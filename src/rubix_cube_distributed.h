@@ -0,0 +1,113 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+/*
+ * Distributed search:
+ *
+ * One coordinator hands subtrees of a search to any number of worker connections, from
+ * worker processes on any number of machines, over TCP:
+ *
+ * 	rubix_cube_distributed_solve() 		an optimal solve, IDA* as in rubix_cube_solver.h,
+ * 						with the pattern databases on each worker's
+ * 						machine (mapped read only and shared by all of
+ * 						its threads) giving the estimates
+ * 	rubix_cube_distributed_enumerate() 	every move sequence of some length from a
+ * 						start state, counting them and the ones that
+ * 						end solved
+ *
+ * Both only search canonical sequences, not the same face twice in a row and of two
+ * opposite faces in a row only the lower first, exactly as the optimal solver does.
+ *
+ * The tree is split by move prefix, RUBIX_CUBE_DISTRIBUTED_PREFIX_LENGTH moves deep
+ * (3240 subtrees) unless set otherwise, and a worker is handed one subtree at a time. When the coordinator
+ * runs out of subtrees while a worker is idle, it asks a busy one to split: that worker
+ * hands back half of the moves it has not tried yet at the shallowest depth where it
+ * has some, as subtrees of their own, and carries on with the rest. Subtrees of
+ * very different sizes so spread out evenly over every core of every machine.
+ *
+ * Each IDA* bound is one round. A solution found in a round is as short as possible,
+ * because every subtree of the round before came back without one. So the first one
+ * found is the answer: the coordinator cancels the round on every worker at once and
+ * returns it. A worker lost in the middle of a solve has its subtree searched again by
+ * another one. An enumeration can not do that without counting what the lost worker
+ * gave away twice, so it fails instead.
+ *
+ * Messages are RUBIX_CUBE_DISTRIBUTED_MESSAGE_SIZE bytes each, always, little endian:
+ *
+ * 	[ type 1 | length 1 | bound 1 | kind 1 | round 4 | value 8 | value 8 | nodes 8 | moves 20 | 0 4 ]
+ *
+ * The coordinator sends a job (the start state packed into the two values), subtrees
+ * (their prefix in moves), split and cancel requests and a quit. Workers send subtrees
+ * done (an enumeration's counts in the values, or the smallest estimate over the bound),
+ * solutions and subtrees given away.
+ */
+
+#ifndef RUBIX_CUBE_DISTRIBUTED_H
+#define RUBIX_CUBE_DISTRIBUTED_H "rubix_cube_distributed.h"
+
+#include "rubix_cube.h"
+#include "rubix_cube_cubie.h"
+#include "rubix_cube_solver.h"
+
+#define RUBIX_CUBE_DISTRIBUTED_PREFIX_LENGTH 	3
+#define RUBIX_CUBE_DISTRIBUTED_MESSAGE_SIZE 	56
+#define RUBIX_CUBE_DISTRIBUTED_MAX_WORKERS 	1024
+
+/* Longest enumeration, a solve is never longer than RUBIX_CUBE_SOLVER_MAX_DEPTH */
+#define RUBIX_CUBE_DISTRIBUTED_MAX_DEPTH 	20
+
+typedef struct rubix_cube_distributed_stats {
+	unsigned long long 		nodes ;		/* over all workers and rounds */
+	unsigned long long 		sequences ;	/* of an enumeration */
+	unsigned long long 		solved ;	/* of those, the ones ending solved */
+	unsigned long long 		subtrees ;	/* handed out, given away ones included */
+	unsigned long long 		splits ;	/* subtrees given away */
+	size_t 				rounds ;
+	size_t 				workers ;	/* connected at the end */
+} RubixCubeDistributedStats ;
+
+typedef struct rubix_cube_distributed RubixCubeDistributed ;
+
+/* Start a coordinator listening on TCP @port, 0 for any free port */
+/* Return NULL if the port can not be listened on */
+RubixCubeDistributed * rubix_cube_distributed_listen(unsigned port) ;
+
+/* Return the port @pDistributed listens on */
+unsigned rubix_cube_distributed_port(const RubixCubeDistributed * pDistributed) ;
+
+/* Split later searches @length moves deep, return 0 for a @length past RUBIX_CUBE_DISTRIBUTED_MAX_DEPTH */
+int rubix_cube_distributed_set_prefix_length(RubixCubeDistributed * pDistributed, size_t length) ;
+
+/* Tell every worker to quit, close the connections and free @pDistributed */
+void rubix_cube_distributed_close(RubixCubeDistributed * pDistributed) ;
+
+/* Find a shortest sequence of at most @max_depth moves solving @pCubie on the workers, which may connect at any time */
+/* Return it as a freshly allocated RubixCubeScramble, or NULL if @pCubie needs more moves, and fill @pStats if not NULL */
+RubixCubeScramble * rubix_cube_distributed_solve(RubixCubeDistributed * pDistributed, const RubixCubeCubie * pCubie, size_t max_depth,
+		RubixCubeDistributedStats * pStats) ;
+
+/* Go through every sequence of @depth moves from @pStart, NULL for the solved cube, and fill @pStats */
+/* Return nonzero on success, 0 if @depth is too large or a worker was lost */
+int rubix_cube_distributed_enumerate(RubixCubeDistributed * pDistributed, const RubixCubeCubie * pStart, size_t depth,
+		RubixCubeDistributedStats * pStats) ;
+
+/* Work for the coordinator at @host:@port over @threads connections (0 for one per online cpu) */
+/* @pSolver, which may be NULL for enumerations only, gives the estimates and is only read from */
+/* Return once the coordinator quits or goes away, nonzero if every connection was made */
+int rubix_cube_distributed_work(const char * host, unsigned port, const RubixCubeSolver * pSolver, size_t threads) ;
+
+#endif // RUBIX_CUBE_DISTRIBUTED_H
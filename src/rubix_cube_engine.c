@@ -0,0 +1,192 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+#include "rubix_cube_engine.h"
+#include "rubix_cube_rank.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <pthread.h>
+
+/*
+ * Each worker owns a range of chunk indices [begin, end), packed into one 64 bit word
+ * so that the owner taking from the front and thieves taking from the back can both
+ * update it with a single compare and swap.
+ */
+#define RUBIX_CUBE_ENGINE_RANGE(begin, end) 	(((uint64_t)(begin) << 32) | (uint64_t)(end))
+#define RUBIX_CUBE_ENGINE_RANGE_BEGIN(range) 	((uint32_t)((range) >> 32))
+#define RUBIX_CUBE_ENGINE_RANGE_END(range) 	((uint32_t)(range))
+
+typedef struct rubix_cube_engine rubix_cube_engine ;
+
+typedef struct rubix_cube_engine_worker {
+	uint64_t 			range ;
+	RubixCubeEngineSummary 		summary ;
+	size_t 				index ;
+	rubix_cube_engine * 		pEngine ;
+	pthread_t 			thread ;
+} __attribute__((aligned(64))) RubixCubeEngineWorker ;
+
+struct rubix_cube_engine {
+	const RubixCubeEngineJob * 	pJob ;
+	RubixCubeEngineWorker * 	workers ;
+	size_t 				number_of_workers ;
+} ;
+
+unsigned long long rubix_cube_engine_checksum(RubixCube * pRubix_cube) {
+	return rubix_cube_hash(pRubix_cube) ;
+}
+
+static void rubix_cube_engine_process(rubix_cube_engine * pEngine, RubixCubeEngineWorker * pWorker, RubixCubeSeed seed) {
+	const RubixCubeEngineJob * pJob = pEngine->pJob ;
+	RubixCubeEngineResult result = {
+		.seed 	= seed,
+		.cube 	= RUBIX_CUBE_SOLVED_LITERAL
+	} ;
+
+	for (size_t k = 0; k < pJob->intensity; ++k) {
+		RubixCubeMove move = rubix_cube_generate_move_from_seed(seed,k) ;
+		rubix_cube_apply_move(&result.cube,&move) ;
+	}
+	result.checksum = rubix_cube_engine_checksum(&result.cube) ;
+
+	if (pJob->pVisited) {
+		RubixCubePacked packed ;
+		if (rubix_cube_pack(&packed,&result.cube) &&
+				rubix_cube_transposition_insert(pJob->pVisited,&packed,(uint32_t)(seed - pJob->first_seed),NULL) == RUBIX_CUBE_TRANSPOSITION_FOUND) {
+			++pWorker->summary.duplicates ;
+		}
+	}
+
+	RubixCube cube = result.cube ;
+	for (size_t k = pJob->intensity; k > 0; --k) {
+		RubixCubeMove move = rubix_cube_generate_move_from_seed(seed,k - 1) ;
+		rubix_cube_unapply_move(&cube,&move) ;
+	}
+	result.verified = rubix_cube_is_solved(&cube) ;
+
+	++pWorker->summary.processed ;
+	pWorker->summary.failures += !result.verified ;
+	pWorker->summary.checksum += result.checksum ;
+
+	if (pJob->results) pJob->results[seed - pJob->first_seed] = result ;
+	if (pJob->callback) pJob->callback(&result,pJob->context) ;
+}
+
+/* Take the next chunk from the front of our own range */
+static int rubix_cube_engine_take(RubixCubeEngineWorker * pWorker, uint32_t * chunk) {
+	uint64_t range = __atomic_load_n(&pWorker->range,__ATOMIC_ACQUIRE) ;
+
+	do {
+		uint32_t begin = RUBIX_CUBE_ENGINE_RANGE_BEGIN(range), end = RUBIX_CUBE_ENGINE_RANGE_END(range) ;
+		if (begin >= end) return 0 ;
+		*chunk = begin ;
+		if (__atomic_compare_exchange_n(&pWorker->range,&range,RUBIX_CUBE_ENGINE_RANGE(begin + 1,end),
+						0,__ATOMIC_ACQ_REL,__ATOMIC_ACQUIRE)) return 1 ;
+	} while (1) ;
+}
+
+/* Move the back half of some other worker's range into our own (empty) one */
+static int rubix_cube_engine_steal(rubix_cube_engine * pEngine, RubixCubeEngineWorker * pWorker) {
+	for (size_t i = 1; i < pEngine->number_of_workers; ++i) {
+		RubixCubeEngineWorker * pVictim = &pEngine->workers[(pWorker->index + i) % pEngine->number_of_workers] ;
+		uint64_t range = __atomic_load_n(&pVictim->range,__ATOMIC_ACQUIRE) ;
+
+		for (;;) {
+			uint32_t begin = RUBIX_CUBE_ENGINE_RANGE_BEGIN(range), end = RUBIX_CUBE_ENGINE_RANGE_END(range) ;
+			if (begin >= end) break ;
+			uint32_t split = end - (end - begin + 1) / 2 ;
+			if (__atomic_compare_exchange_n(&pVictim->range,&range,RUBIX_CUBE_ENGINE_RANGE(begin,split),
+							0,__ATOMIC_ACQ_REL,__ATOMIC_ACQUIRE)) {
+				__atomic_store_n(&pWorker->range,RUBIX_CUBE_ENGINE_RANGE(split,end),__ATOMIC_RELEASE) ;
+				return 1 ;
+			}
+		}
+	}
+	return 0 ;
+}
+
+static void * rubix_cube_engine_work(void * argument) {
+	RubixCubeEngineWorker * pWorker = (RubixCubeEngineWorker *)argument ;
+	rubix_cube_engine * pEngine = pWorker->pEngine ;
+	const RubixCubeEngineJob * pJob = pEngine->pJob ;
+	uint32_t chunk ;
+
+	for (;;) {
+		if (!rubix_cube_engine_take(pWorker,&chunk)) {
+			if (rubix_cube_engine_steal(pEngine,pWorker)) continue ;
+			break ;
+		}
+
+		size_t first = (size_t)chunk * RUBIX_CUBE_ENGINE_CHUNK ;
+		size_t last = first + RUBIX_CUBE_ENGINE_CHUNK < pJob->count ? first + RUBIX_CUBE_ENGINE_CHUNK : pJob->count ;
+		for (size_t i = first; i < last; ++i) {
+			rubix_cube_engine_process(pEngine,pWorker,pJob->first_seed + i) ;
+		}
+	}
+	return NULL ;
+}
+
+int rubix_cube_engine_run(const RubixCubeEngineJob * pJob, RubixCubeEngineSummary * pSummary) {
+	rubix_cube_engine engine = { .pJob = pJob } ;
+	size_t chunks, started ;
+	int success = 1 ;
+
+	if (!pJob || pJob->count > RUBIX_CUBE_ENGINE_MAX_COUNT) return 0 ;
+	chunks = (pJob->count + RUBIX_CUBE_ENGINE_CHUNK - 1) / RUBIX_CUBE_ENGINE_CHUNK ;
+
+	engine.number_of_workers = pJob->threads ;
+	if (!engine.number_of_workers) {
+		long online = sysconf(_SC_NPROCESSORS_ONLN) ;
+		engine.number_of_workers = online > 0 ? (size_t)online : 1 ;
+	}
+	if (engine.number_of_workers > chunks) engine.number_of_workers = chunks ? chunks : 1 ;
+
+	if (posix_memalign((void **)&engine.workers,64,engine.number_of_workers * sizeof(RubixCubeEngineWorker))) return 0 ;
+
+	/* Hand out equal contiguous shares up front, stealing evens out the rest */
+	for (size_t i = 0; i < engine.number_of_workers; ++i) {
+		engine.workers[i] = (RubixCubeEngineWorker){
+			.range 		= RUBIX_CUBE_ENGINE_RANGE(chunks * i / engine.number_of_workers,
+								  chunks * (i + 1) / engine.number_of_workers),
+			.index 		= i,
+			.pEngine 	= &engine
+		} ;
+	}
+
+	/* The calling thread works too, as worker 0 */
+	for (started = 1; started < engine.number_of_workers; ++started) {
+		if (pthread_create(&engine.workers[started].thread,NULL,rubix_cube_engine_work,&engine.workers[started])) break ;
+	}
+	rubix_cube_engine_work(&engine.workers[0]) ;
+
+	for (size_t i = 1; i < started; ++i) pthread_join(engine.workers[i].thread,NULL) ;
+	/* Any share whose thread never started was stolen by the ones that did */
+
+	RubixCubeEngineSummary total = { 0, 0, 0, 0 } ;
+	for (size_t i = 0; i < engine.number_of_workers; ++i) {
+		total.processed += engine.workers[i].summary.processed ;
+		total.failures += engine.workers[i].summary.failures ;
+		total.checksum += engine.workers[i].summary.checksum ;
+		total.duplicates += engine.workers[i].summary.duplicates ;
+	}
+	if (total.processed != pJob->count) success = 0 ;
+	if (pSummary) *pSummary = total ;
+
+	free(engine.workers) ;
+	return success ;
+}
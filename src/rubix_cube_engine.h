@@ -0,0 +1,80 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Bulk scramble engine:
+ *
+ * For every seed in [first_seed, first_seed + count) the engine scrambles a solved cube
+ * with @intensity moves from that seed, records the scrambled state, then undoes the
+ * same moves and checks the cube came back solved, which exercises the same round trip
+ * as rubix_cube_generate_scrambled() followed by rubix_cube_solve_scrambled_from_seed().
+ *
+ * The seed range is split evenly between the worker threads, and a worker that runs out
+ * of seeds steals half of what is left from another one. Moves come straight from the
+ * counter based generator, so no global state is shared, results are identical for any
+ * thread count, and nothing is allocated per cube.
+ */
+
+#ifndef RUBIX_CUBE_ENGINE_H
+#define RUBIX_CUBE_ENGINE_H "rubix_cube_engine.h"
+
+#include "rubix_cube.h"
+#include "rubix_cube_transposition.h"
+
+typedef struct rubix_cube_engine_result {
+	RubixCubeSeed 			seed ;
+	RubixCube 			cube ;		/* the scrambled state */
+	unsigned long long 		checksum ;	/* hash of the scrambled state */
+	int 				verified ;	/* nonzero if undoing the scramble solved the cube */
+} RubixCubeEngineResult ;
+
+/* Called from worker threads, once per seed, in no particular order */
+typedef void (*RubixCubeEngineCallback)(const RubixCubeEngineResult * pResult, void * context) ;
+
+typedef struct rubix_cube_engine_job {
+	RubixCubeSeed 			first_seed ;
+	size_t 				count ;
+	size_t 				intensity ;	/* moves per scramble */
+	size_t 				threads ;	/* 0 for one per online cpu */
+	RubixCubeEngineResult * 	results ;	/* optional, results[i] is for seed first_seed + i */
+	RubixCubeEngineCallback 	callback ;	/* optional */
+	void * 				context ;	/* passed to @callback */
+	RubixCubeTranspositionTable * 	pVisited ;	/* optional, every scrambled state goes in with value seed - first_seed */
+} RubixCubeEngineJob ;
+
+typedef struct rubix_cube_engine_summary {
+	size_t 				processed ;
+	size_t 				failures ;	/* seeds whose round trip did not come back solved */
+	unsigned long long 		checksum ;	/* sum of all checksums, independent of the order of work */
+	size_t 				duplicates ;	/* scrambled states that were already in @pVisited */
+} RubixCubeEngineSummary ;
+
+/* Largest @count a single job can take */
+#define RUBIX_CUBE_ENGINE_MAX_COUNT 	((size_t)0xffffffff * RUBIX_CUBE_ENGINE_CHUNK)
+
+/* Seeds handed out at a time */
+#define RUBIX_CUBE_ENGINE_CHUNK 	64
+
+/* Run @pJob to completion, fill @pSummary if not NULL */
+/* Return nonzero on success, 0 if the job is invalid or the threads could not be started */
+int rubix_cube_engine_run(const RubixCubeEngineJob * pJob, RubixCubeEngineSummary * pSummary) ;
+
+/* Hash of a cube state, as used for RubixCubeEngineResult checksums, same as rubix_cube_hash() */
+unsigned long long rubix_cube_engine_checksum(RubixCube * pRubix_cube) ;
+
+#endif // RUBIX_CUBE_ENGINE_H
@@ -0,0 +1,544 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+#include "rubix_cube_facelet.h"
+#include <string.h>
+#include <pthread.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define RUBIX_CUBE_FACELET_X86
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__)
+#define RUBIX_CUBE_FACELET_NEON
+#include <arm_neon.h>
+#endif
+
+const char * RUBIX_CUBE_FACELET_KERNEL_STRINGS[] = {
+	"auto",
+	"scalar",
+	"ssse3",
+	"avx2",
+	"neon"
+} ;
+
+/* Where each facelet lives in the plane model */
+typedef struct rubix_cube_facelet_reference {
+	RubixCubePieceReference 	piece ;
+	size_t 				side ;
+} RubixCubeFaceletReference ;
+
+RubixCubeFaceletReference rubix_cube_facelet_references[RUBIX_CUBE_FACELET_COUNT] ;
+
+RubixCubeFaceletPermutation rubix_cube_facelet_move_table[RUBIX_CUBE_MOVE_COUNT] ;
+
+RubixCubeFacelets rubix_cube_facelets_solved ;
+
+typedef void (*RubixCubeFaceletPermuteFunction)(unsigned char * dest, const unsigned char * src, const unsigned char * map) ;
+typedef void (*RubixCubeFaceletPermuteAllFunction)(unsigned char * cubes, size_t count, const unsigned char * const * maps, size_t number_of_maps) ;
+typedef void (*RubixCubeFaceletPermuteEachFunction)(unsigned char * cubes, size_t count, const unsigned char * const * maps) ;
+typedef size_t (*RubixCubeFaceletWalkFunction)(unsigned char * cube, const unsigned char * const * maps, size_t number_of_maps, const unsigned char * target) ;
+
+/* One set of these per kernel, the batch versions keep the core inlined in their loops */
+typedef struct rubix_cube_facelet_kernel_functions {
+	RubixCubeFaceletPermuteFunction 	permute ;
+	RubixCubeFaceletPermuteAllFunction 	permute_all ;	/* every map, in order, to every cube */
+	RubixCubeFaceletPermuteEachFunction 	permute_each ;	/* maps[i] to cube i */
+	RubixCubeFaceletWalkFunction 		walk ;		/* maps in order until the cube is the target */
+} RubixCubeFaceletKernelFunctions ;
+
+static RubixCubeFaceletKernelFunctions rubix_cube_facelet_functions ;
+static RubixCubeFaceletKernel rubix_cube_facelet_kernel ;
+
+static pthread_once_t rubix_cube_facelet_tables_once = PTHREAD_ONCE_INIT ;
+static int rubix_cube_facelet_tables_ready ;
+
+/*
+ * Kernels
+ *
+ * All of them take a 64 byte map and a 64 byte source and must behave
+ * exactly like the scalar loop. @dest may alias @src.
+ */
+
+#define RUBIX_CUBE_FACELET_DEFINE_KERNEL(name, attributes) \
+	attributes static void rubix_cube_facelet_permute_##name(unsigned char * dest, const unsigned char * src, const unsigned char * map) { \
+		rubix_cube_facelet_permute_##name##_core(dest,src,map) ; \
+	} \
+	attributes static void rubix_cube_facelet_permute_all_##name(unsigned char * cubes, size_t count, const unsigned char * const * maps, size_t number_of_maps) { \
+		for (size_t i = 0; i < count; ++i) { \
+			unsigned char * cube = cubes + i * RUBIX_CUBE_FACELET_STRIDE ; \
+			for (size_t j = 0; j < number_of_maps; ++j) rubix_cube_facelet_permute_##name##_core(cube,cube,maps[j]) ; \
+		} \
+	} \
+	attributes static void rubix_cube_facelet_permute_each_##name(unsigned char * cubes, size_t count, const unsigned char * const * maps) { \
+		for (size_t i = 0; i < count; ++i) { \
+			unsigned char * cube = cubes + i * RUBIX_CUBE_FACELET_STRIDE ; \
+			rubix_cube_facelet_permute_##name##_core(cube,cube,maps[i]) ; \
+		} \
+	} \
+	attributes static size_t rubix_cube_facelet_walk_##name(unsigned char * cube, const unsigned char * const * maps, size_t number_of_maps, const unsigned char * target) { \
+		for (size_t j = 0; j < number_of_maps; ++j) { \
+			rubix_cube_facelet_permute_##name##_core(cube,cube,maps[j]) ; \
+			if (!memcmp(cube,target,RUBIX_CUBE_FACELET_STRIDE)) return j + 1 ; \
+		} \
+		return number_of_maps ; \
+	}
+
+#define RUBIX_CUBE_FACELET_KERNEL_FUNCTIONS(name) \
+	(RubixCubeFaceletKernelFunctions){ \
+		.permute 	= rubix_cube_facelet_permute_##name, \
+		.permute_all 	= rubix_cube_facelet_permute_all_##name, \
+		.permute_each 	= rubix_cube_facelet_permute_each_##name, \
+		.walk 		= rubix_cube_facelet_walk_##name \
+	}
+
+static inline __attribute__((always_inline))
+void rubix_cube_facelet_permute_scalar_core(unsigned char * dest, const unsigned char * src, const unsigned char * map) {
+	unsigned char permuted[RUBIX_CUBE_FACELET_STRIDE] ;
+	for (size_t i = 0; i < RUBIX_CUBE_FACELET_STRIDE; ++i) {
+		permuted[i] = src[map[i]] ;
+	}
+	memcpy(dest,permuted,RUBIX_CUBE_FACELET_STRIDE) ;
+}
+RUBIX_CUBE_FACELET_DEFINE_KERNEL(scalar,)
+
+#ifdef RUBIX_CUBE_FACELET_X86
+/*
+ * pshufb only looks at the low 4 bits of each index and zeroes lanes with the high bit set.
+ * Subtracting the base of a 16 byte block and then adding 0x70 with unsigned saturation
+ * leaves indices inside the block alone (0x70-0x7f) and pushes everything else to >= 0x80,
+ * so each source block can be shuffled in and OR'd together.
+ */
+static inline __attribute__((always_inline, target("ssse3")))
+void rubix_cube_facelet_permute_ssse3_core(unsigned char * dest, const unsigned char * src, const unsigned char * map) {
+	const __m128i bias = _mm_set1_epi8(0x70) ;
+	__m128i blocks[4], out[4] ;
+
+	for (int k = 0; k < 4; ++k) blocks[k] = _mm_load_si128((const __m128i *)src + k) ;
+
+	for (int j = 0; j < 4; ++j) {
+		__m128i index = _mm_load_si128((const __m128i *)map + j) ;
+		__m128i result = _mm_shuffle_epi8(blocks[0],_mm_adds_epu8(index,bias)) ;
+		for (int k = 1; k < 4; ++k) {
+			index = _mm_sub_epi8(index,_mm_set1_epi8(16)) ;
+			result = _mm_or_si128(result,_mm_shuffle_epi8(blocks[k],_mm_adds_epu8(index,bias))) ;
+		}
+		out[j] = result ;
+	}
+
+	for (int j = 0; j < 4; ++j) _mm_store_si128((__m128i *)dest + j,out[j]) ;
+}
+RUBIX_CUBE_FACELET_DEFINE_KERNEL(ssse3,__attribute__((target("ssse3"))))
+
+/*
+ * Same trick with 256 bit registers. vpshufb stays inside each 128 bit lane, so every
+ * source half is also used with its lanes swapped, giving each output lane access to
+ * all four 16 byte blocks with four shuffles.
+ */
+static inline __attribute__((always_inline, target("avx2")))
+void rubix_cube_facelet_permute_avx2_core(unsigned char * dest, const unsigned char * src, const unsigned char * map) {
+	const __m256i bias = _mm256_set1_epi8(0x70) ;
+	const __m256i low = _mm256_load_si256((const __m256i *)src) ;
+	const __m256i high = _mm256_load_si256((const __m256i *)src + 1) ;
+	const __m256i sources[4] = {
+		low,
+		_mm256_permute2x128_si256(low,low,0x01),
+		high,
+		_mm256_permute2x128_si256(high,high,0x01)
+	} ;
+	/* Which 16 byte block each lane of each source holds, times 16 */
+	const __m256i bases[4] = {
+		_mm256_setr_m128i(_mm_set1_epi8(0),_mm_set1_epi8(16)),
+		_mm256_setr_m128i(_mm_set1_epi8(16),_mm_set1_epi8(0)),
+		_mm256_setr_m128i(_mm_set1_epi8(32),_mm_set1_epi8(48)),
+		_mm256_setr_m128i(_mm_set1_epi8(48),_mm_set1_epi8(32))
+	} ;
+	__m256i out[2] ;
+
+	for (int j = 0; j < 2; ++j) {
+		__m256i index = _mm256_load_si256((const __m256i *)map + j) ;
+		__m256i result = _mm256_setzero_si256() ;
+		for (int k = 0; k < 4; ++k) {
+			__m256i local = _mm256_adds_epu8(_mm256_sub_epi8(index,bases[k]),bias) ;
+			result = _mm256_or_si256(result,_mm256_shuffle_epi8(sources[k],local)) ;
+		}
+		out[j] = result ;
+	}
+
+	_mm256_store_si256((__m256i *)dest,out[0]) ;
+	_mm256_store_si256((__m256i *)dest + 1,out[1]) ;
+}
+RUBIX_CUBE_FACELET_DEFINE_KERNEL(avx2,__attribute__((target("avx2"))))
+#endif
+
+#ifdef RUBIX_CUBE_FACELET_NEON
+/* tbl takes a 64 byte table directly, out of range indices give 0 */
+static inline __attribute__((always_inline))
+void rubix_cube_facelet_permute_neon_core(unsigned char * dest, const unsigned char * src, const unsigned char * map) {
+	uint8x16x4_t table = vld1q_u8_x4(src) ;
+	uint8x16_t out[4] ;
+	for (int j = 0; j < 4; ++j) out[j] = vqtbl4q_u8(table,vld1q_u8(map + 16 * j)) ;
+	for (int j = 0; j < 4; ++j) vst1q_u8(dest + 16 * j,out[j]) ;
+}
+RUBIX_CUBE_FACELET_DEFINE_KERNEL(neon,)
+#endif
+
+int rubix_cube_facelet_kernel_supported(RubixCubeFaceletKernel kernel) {
+	switch(kernel) {
+		case RUBIX_CUBE_FACELET_KERNEL_AUTO:
+		case RUBIX_CUBE_FACELET_KERNEL_SCALAR:
+			return 1 ;
+#ifdef RUBIX_CUBE_FACELET_X86
+		case RUBIX_CUBE_FACELET_KERNEL_SSSE3:
+			return __builtin_cpu_supports("ssse3") ;
+		case RUBIX_CUBE_FACELET_KERNEL_AVX2:
+			return __builtin_cpu_supports("avx2") ;
+#endif
+#ifdef RUBIX_CUBE_FACELET_NEON
+		case RUBIX_CUBE_FACELET_KERNEL_NEON:
+			return 1 ;
+#endif
+		default:
+			return 0 ;
+	}
+}
+
+static int rubix_cube_facelet_install_kernel(RubixCubeFaceletKernel kernel) {
+	if (!rubix_cube_facelet_kernel_supported(kernel)) return 0 ;
+
+	if (kernel == RUBIX_CUBE_FACELET_KERNEL_AUTO) {
+		/* Best first */
+		const RubixCubeFaceletKernel preference[] = {
+			RUBIX_CUBE_FACELET_KERNEL_AVX2,
+			RUBIX_CUBE_FACELET_KERNEL_NEON,
+			RUBIX_CUBE_FACELET_KERNEL_SSSE3,
+			RUBIX_CUBE_FACELET_KERNEL_SCALAR
+		} ;
+		for (size_t i = 0; i < sizeof(preference)/sizeof(preference[0]); ++i) {
+			if (rubix_cube_facelet_install_kernel(preference[i])) return 1 ;
+		}
+		return 0 ;
+	}
+
+	switch(kernel) {
+#ifdef RUBIX_CUBE_FACELET_X86
+		case RUBIX_CUBE_FACELET_KERNEL_SSSE3:
+			rubix_cube_facelet_functions = RUBIX_CUBE_FACELET_KERNEL_FUNCTIONS(ssse3) ;
+			break ;
+		case RUBIX_CUBE_FACELET_KERNEL_AVX2:
+			rubix_cube_facelet_functions = RUBIX_CUBE_FACELET_KERNEL_FUNCTIONS(avx2) ;
+			break ;
+#endif
+#ifdef RUBIX_CUBE_FACELET_NEON
+		case RUBIX_CUBE_FACELET_KERNEL_NEON:
+			rubix_cube_facelet_functions = RUBIX_CUBE_FACELET_KERNEL_FUNCTIONS(neon) ;
+			break ;
+#endif
+		default:
+			rubix_cube_facelet_functions = RUBIX_CUBE_FACELET_KERNEL_FUNCTIONS(scalar) ;
+			break ;
+	}
+	rubix_cube_facelet_kernel = kernel ;
+	return 1 ;
+}
+
+/*
+ * Everything here is derived from the plane model: each slot of a cube is labeled
+ * with a unique number in place of a color, put through the existing face macros
+ * and rubix_cube_rotate_face(), and the labels are read back out.
+ */
+#define RUBIX_CUBE_SLOT_LABEL(plane, index, side) \
+	((plane) * RUBIX_CUBE_PIECES_PER_PLANE * RUBIX_CUBE_SIDE_COUNT + (index) * RUBIX_CUBE_SIDE_COUNT + (side) + 1)
+
+static void rubix_cube_facelet_build_tables(void) {
+	RubixCube labeled ;
+	RubixCube solved = rubix_cube_generate_solved() ;
+
+	for (size_t plane = 0; plane < RUBIX_CUBE_PLANE_COUNT; ++plane) {
+		for (size_t index = 0; index < RUBIX_CUBE_PIECES_PER_PLANE; ++index) {
+			for (size_t side = 0; side < RUBIX_CUBE_SIDE_COUNT; ++side) {
+				labeled.planes[plane][index].sides[side] = (RubixCubeColor)RUBIX_CUBE_SLOT_LABEL(plane,index,side) ;
+			}
+		}
+	}
+
+	RubixCubeFace faces[RUBIX_CUBE_SIDE_COUNT] = {
+		RUBIX_CUBE_GET_TOP_FACE(labeled),
+		RUBIX_CUBE_GET_FRONT_FACE(labeled),
+		RUBIX_CUBE_GET_RIGHT_FACE(labeled),
+		RUBIX_CUBE_GET_LEFT_FACE(labeled),
+		RUBIX_CUBE_GET_BACK_FACE(labeled),
+		RUBIX_CUBE_GET_BOTTOM_FACE(labeled)
+	} ;
+
+	for (size_t face = 0; face < RUBIX_CUBE_SIDE_COUNT; ++face) {
+		for (size_t square = 0; square < RUBIX_CUBE_PIECES_PER_FACE; ++square) {
+			size_t label = (size_t)faces[face].squares[square] - 1 ;
+			RubixCubeFaceletReference * reference = &rubix_cube_facelet_references[face * RUBIX_CUBE_PIECES_PER_FACE + square] ;
+			reference->side = label % RUBIX_CUBE_SIDE_COUNT ;
+			reference->piece.index = (label / RUBIX_CUBE_SIDE_COUNT) % RUBIX_CUBE_PIECES_PER_PLANE ;
+			reference->piece.plane = label / (RUBIX_CUBE_SIDE_COUNT * RUBIX_CUBE_PIECES_PER_PLANE) ;
+		}
+	}
+
+	/* Now label by facelet index instead, and see where each rotation sends the labels */
+	for (size_t side = 0; side < RUBIX_CUBE_SIDE_COUNT; ++side) {
+		for (size_t rotation = 0; rotation < RUBIX_CUBE_FACE_ROTATION_COUNT; ++rotation) {
+			RubixCube moved = solved ;
+			for (size_t i = 0; i < RUBIX_CUBE_FACELET_COUNT; ++i) {
+				RubixCubeFaceletReference * reference = &rubix_cube_facelet_references[i] ;
+				moved.planes[reference->piece.plane][reference->piece.index].sides[reference->side] = (RubixCubeColor)(i + 1) ;
+			}
+			rubix_cube_rotate_face(&moved,(RubixCubeSide)side,(RubixCubeFaceRotation)rotation) ;
+
+			RubixCubeFaceletPermutation * permutation = &rubix_cube_facelet_move_table[RUBIX_CUBE_MOVE_INDEX(side,rotation)] ;
+			*permutation = rubix_cube_facelet_permutation_identity() ;
+			for (size_t i = 0; i < RUBIX_CUBE_FACELET_COUNT; ++i) {
+				RubixCubeFaceletReference * reference = &rubix_cube_facelet_references[i] ;
+				permutation->map[i] = (unsigned char)(moved.planes[reference->piece.plane][reference->piece.index].sides[reference->side] - 1) ;
+			}
+		}
+	}
+
+	memset(&rubix_cube_facelets_solved,0,sizeof(RubixCubeFacelets)) ;
+	for (size_t i = 0; i < RUBIX_CUBE_FACELET_COUNT; ++i) {
+		RubixCubeFaceletReference * reference = &rubix_cube_facelet_references[i] ;
+		rubix_cube_facelets_solved.facelets[i] = (unsigned char)solved.planes[reference->piece.plane][reference->piece.index].sides[reference->side] ;
+	}
+
+	rubix_cube_facelet_install_kernel(RUBIX_CUBE_FACELET_KERNEL_AUTO) ;
+	__atomic_store_n(&rubix_cube_facelet_tables_ready,1,__ATOMIC_RELEASE) ;
+}
+
+/* Checked on every move, so skip the call into pthread_once once the tables exist */
+static inline void rubix_cube_facelet_init_tables(void) {
+	if (__builtin_expect(!__atomic_load_n(&rubix_cube_facelet_tables_ready,__ATOMIC_ACQUIRE),0)) {
+		pthread_once(&rubix_cube_facelet_tables_once,rubix_cube_facelet_build_tables) ;
+	}
+}
+
+int rubix_cube_facelet_select_kernel(RubixCubeFaceletKernel kernel) {
+	rubix_cube_facelet_init_tables() ;
+	return rubix_cube_facelet_install_kernel(kernel) ;
+}
+
+RubixCubeFaceletKernel rubix_cube_facelet_get_kernel(void) {
+	rubix_cube_facelet_init_tables() ;
+	return rubix_cube_facelet_kernel ;
+}
+
+const char * rubix_cube_facelet_get_kernel_string(RubixCubeFaceletKernel kernel) {
+	if ((size_t)kernel >= RUBIX_CUBE_FACELET_KERNEL_COUNT) return "invalid" ;
+	return RUBIX_CUBE_FACELET_KERNEL_STRINGS[kernel] ;
+}
+
+RubixCubeFaceletPermutation rubix_cube_facelet_permutation_identity(void) {
+	RubixCubeFaceletPermutation identity ;
+	for (size_t i = 0; i < RUBIX_CUBE_FACELET_STRIDE; ++i) identity.map[i] = (unsigned char)i ;
+	return identity ;
+}
+
+void rubix_cube_facelet_permutation_compose(RubixCubeFaceletPermutation * dest, const RubixCubeFaceletPermutation * first, const RubixCubeFaceletPermutation * second) {
+	RubixCubeFaceletPermutation product ;
+	rubix_cube_facelet_init_tables() ;
+	/* Doing @first then @second reads old[first[second[i]]], which is just @first permuted by @second */
+	rubix_cube_facelet_functions.permute(product.map,first->map,second->map) ;
+	*dest = product ;
+}
+
+RubixCubeFacelets rubix_cube_facelets_generate_solved(void) {
+	rubix_cube_facelet_init_tables() ;
+	return rubix_cube_facelets_solved ;
+}
+
+RubixCubeFacelets rubix_cube_facelets_from_cube(RubixCube * pRubix_cube) {
+	RubixCubeFacelets new ;
+	rubix_cube_facelet_init_tables() ;
+
+	memset(&new,0,sizeof(RubixCubeFacelets)) ;
+	for (size_t i = 0; i < RUBIX_CUBE_FACELET_COUNT; ++i) {
+		RubixCubeFaceletReference * reference = &rubix_cube_facelet_references[i] ;
+		new.facelets[i] = (unsigned char)pRubix_cube->planes[reference->piece.plane][reference->piece.index].sides[reference->side] ;
+	}
+	return new ;
+}
+
+RubixCube rubix_cube_facelets_to_cube(RubixCubeFacelets * pFacelets) {
+	RubixCube new ;
+	rubix_cube_facelet_init_tables() ;
+
+	/* Null slots are never referenced by a facelet, so start from all null */
+	memset(&new,0,sizeof(RubixCube)) ;
+	for (size_t i = 0; i < RUBIX_CUBE_FACELET_COUNT; ++i) {
+		RubixCubeFaceletReference * reference = &rubix_cube_facelet_references[i] ;
+		new.planes[reference->piece.plane][reference->piece.index].sides[reference->side] = (RubixCubeColor)pFacelets->facelets[i] ;
+	}
+	return new ;
+}
+
+const RubixCubeFaceletPermutation * rubix_cube_facelet_get_move(RubixCubeSide side, RubixCubeFaceRotation face_rotation) {
+	rubix_cube_facelet_init_tables() ;
+	return &rubix_cube_facelet_move_table[RUBIX_CUBE_MOVE_INDEX(side,face_rotation)] ;
+}
+
+void rubix_cube_facelets_permute(RubixCubeFacelets * dest, const RubixCubeFacelets * src, const RubixCubeFaceletPermutation * permutation) {
+	rubix_cube_facelet_init_tables() ;
+	rubix_cube_facelet_functions.permute(dest->facelets,src->facelets,permutation->map) ;
+}
+
+void rubix_cube_facelets_rotate_face(RubixCubeFacelets * pFacelets, RubixCubeSide side, RubixCubeFaceRotation face_rotation) {
+	rubix_cube_facelet_init_tables() ;
+	rubix_cube_facelet_functions.permute(pFacelets->facelets,pFacelets->facelets,
+		rubix_cube_facelet_move_table[RUBIX_CUBE_MOVE_INDEX(side,face_rotation)].map) ;
+}
+
+void rubix_cube_facelets_apply_move(RubixCubeFacelets * pFacelets, RubixCubeMove * move) {
+	if (move) rubix_cube_facelets_rotate_face(pFacelets,move->side,move->rotation) ;
+}
+
+void rubix_cube_facelets_apply_scramble(RubixCubeFacelets * pFacelets, RubixCubeScramble * pScramble) {
+	rubix_cube_facelets_apply_moves_all(pFacelets,1,pScramble->moves,pScramble->size) ;
+}
+
+/* Moves are turned into map pointers this many at a time */
+#define RUBIX_CUBE_FACELET_MAP_CHUNK 64
+
+void rubix_cube_facelets_apply_moves_all(RubixCubeFacelets * cubes, size_t count, const RubixCubeMove * moves, size_t number_of_moves) {
+	const unsigned char * maps[RUBIX_CUBE_FACELET_MAP_CHUNK] ;
+	rubix_cube_facelet_init_tables() ;
+
+	/* With a short sequence every cube runs the whole thing while it is in a register */
+	/* With a long one, each chunk of moves passes over the cubes once */
+	for (size_t done = 0; done < number_of_moves; done += RUBIX_CUBE_FACELET_MAP_CHUNK) {
+		size_t chunk = number_of_moves - done < RUBIX_CUBE_FACELET_MAP_CHUNK ? number_of_moves - done : RUBIX_CUBE_FACELET_MAP_CHUNK ;
+		for (size_t i = 0; i < chunk; ++i) {
+			maps[i] = rubix_cube_facelet_move_table[RUBIX_CUBE_MOVE_INDEX(moves[done + i].side,moves[done + i].rotation)].map ;
+		}
+		rubix_cube_facelet_functions.permute_all(cubes->facelets,count,maps,chunk) ;
+	}
+}
+
+void rubix_cube_facelets_apply_moves_each(RubixCubeFacelets * cubes, const RubixCubeMove * moves, size_t count) {
+	const unsigned char * maps[RUBIX_CUBE_FACELET_MAP_CHUNK] ;
+	rubix_cube_facelet_init_tables() ;
+
+	for (size_t done = 0; done < count; done += RUBIX_CUBE_FACELET_MAP_CHUNK) {
+		size_t chunk = count - done < RUBIX_CUBE_FACELET_MAP_CHUNK ? count - done : RUBIX_CUBE_FACELET_MAP_CHUNK ;
+		for (size_t i = 0; i < chunk; ++i) {
+			maps[i] = rubix_cube_facelet_move_table[RUBIX_CUBE_MOVE_INDEX(moves[done + i].side,moves[done + i].rotation)].map ;
+		}
+		rubix_cube_facelet_functions.permute_each(cubes[done].facelets,chunk,maps) ;
+	}
+}
+
+void rubix_cube_facelets_permute_all(RubixCubeFacelets * cubes, size_t count, const RubixCubeFaceletPermutation * permutation) {
+	const unsigned char * map = permutation->map ;
+	rubix_cube_facelet_init_tables() ;
+	rubix_cube_facelet_functions.permute_all(cubes->facelets,count,&map,1) ;
+}
+
+static int rubix_cube_facelet_codes_valid(const unsigned char * codes, size_t count) {
+	unsigned char highest = 0 ;
+	for (size_t i = 0; i < count; ++i) highest = codes[i] > highest ? codes[i] : highest ;
+	return highest < RUBIX_CUBE_MOVE_COUNT ;
+}
+
+int rubix_cube_facelets_apply_codes_all(RubixCubeFacelets * cubes, size_t count, const unsigned char * codes, size_t number_of_moves) {
+	const unsigned char * maps[RUBIX_CUBE_FACELET_MAP_CHUNK] ;
+
+	if (!rubix_cube_facelet_codes_valid(codes,number_of_moves)) return 0 ;
+	rubix_cube_facelet_init_tables() ;
+	for (size_t done = 0; done < number_of_moves; done += RUBIX_CUBE_FACELET_MAP_CHUNK) {
+		size_t chunk = number_of_moves - done < RUBIX_CUBE_FACELET_MAP_CHUNK ? number_of_moves - done : RUBIX_CUBE_FACELET_MAP_CHUNK ;
+		for (size_t i = 0; i < chunk; ++i) maps[i] = rubix_cube_facelet_move_table[codes[done + i]].map ;
+		rubix_cube_facelet_functions.permute_all(cubes->facelets,count,maps,chunk) ;
+	}
+	return 1 ;
+}
+
+/* Every cube has its own moves here, so each one runs its whole row while it is in a register */
+static int rubix_cube_facelets_codes_rows(RubixCubeFacelets * cubes, size_t count, const unsigned char * codes, size_t moves_per_cube, int inverse) {
+	const unsigned char * maps[RUBIX_CUBE_FACELET_MAP_CHUNK] ;
+
+	if (!rubix_cube_facelet_codes_valid(codes,count * moves_per_cube)) return 0 ;
+	rubix_cube_facelet_init_tables() ;
+	for (size_t cube = 0; cube < count; ++cube) {
+		const unsigned char * row = codes + cube * moves_per_cube ;
+		for (size_t done = 0; done < moves_per_cube; done += RUBIX_CUBE_FACELET_MAP_CHUNK) {
+			size_t chunk = moves_per_cube - done < RUBIX_CUBE_FACELET_MAP_CHUNK ? moves_per_cube - done : RUBIX_CUBE_FACELET_MAP_CHUNK ;
+			for (size_t i = 0; i < chunk; ++i) {
+				maps[i] = inverse
+					? rubix_cube_facelet_move_table[RUBIX_CUBE_MOVE_INDEX_INVERSE(row[moves_per_cube - 1 - done - i])].map
+					: rubix_cube_facelet_move_table[row[done + i]].map ;
+			}
+			rubix_cube_facelet_functions.permute_all(cubes[cube].facelets,1,maps,chunk) ;
+		}
+	}
+	return 1 ;
+}
+
+int rubix_cube_facelets_apply_codes_rows(RubixCubeFacelets * cubes, size_t count, const unsigned char * codes, size_t moves_per_cube) {
+	return rubix_cube_facelets_codes_rows(cubes,count,codes,moves_per_cube,0) ;
+}
+
+int rubix_cube_facelets_unapply_codes_rows(RubixCubeFacelets * cubes, size_t count, const unsigned char * codes, size_t moves_per_cube) {
+	return rubix_cube_facelets_codes_rows(cubes,count,codes,moves_per_cube,1) ;
+}
+
+size_t rubix_cube_facelets_walk_codes(RubixCubeFacelets * pFacelets, const unsigned char * codes, size_t count) {
+	const unsigned char * maps[RUBIX_CUBE_FACELET_MAP_CHUNK] ;
+
+	if (!rubix_cube_facelet_codes_valid(codes,count)) return 0 ;
+	rubix_cube_facelet_init_tables() ;
+	for (size_t done = 0; done < count; done += RUBIX_CUBE_FACELET_MAP_CHUNK) {
+		size_t chunk = count - done < RUBIX_CUBE_FACELET_MAP_CHUNK ? count - done : RUBIX_CUBE_FACELET_MAP_CHUNK, made ;
+		for (size_t i = 0; i < chunk; ++i) maps[i] = rubix_cube_facelet_move_table[codes[done + i]].map ;
+		made = rubix_cube_facelet_functions.walk(pFacelets->facelets,maps,chunk,rubix_cube_facelets_solved.facelets) ;
+		/* A walk that ends solved on the last one of the chunk also stops here */
+		if (made < chunk || !memcmp(pFacelets,&rubix_cube_facelets_solved,sizeof(RubixCubeFacelets))) return done + made ;
+	}
+	return count ;
+}
+
+void rubix_cube_facelets_fill_solved(RubixCubeFacelets * cubes, size_t count) {
+	rubix_cube_facelet_init_tables() ;
+	for (size_t i = 0; i < count; ++i) cubes[i] = rubix_cube_facelets_solved ;
+}
+
+size_t rubix_cube_facelets_count_solved(const RubixCubeFacelets * cubes, size_t count, unsigned char * results) {
+	size_t solved = 0 ;
+
+	rubix_cube_facelet_init_tables() ;
+	for (size_t i = 0; i < count; ++i) {
+		int is_solved = !memcmp(&cubes[i],&rubix_cube_facelets_solved,sizeof(RubixCubeFacelets)) ;
+		if (results) results[i] = (unsigned char)is_solved ;
+		solved += is_solved ;
+	}
+	return solved ;
+}
+
+int rubix_cube_facelets_equivelence_check(const RubixCubeFacelets * first, const RubixCubeFacelets * second) {
+	if (!first && !second) return 1 ;
+	if (!first || !second) return 0 ;
+	return !memcmp(first,second,sizeof(RubixCubeFacelets)) ;
+}
+
+int rubix_cube_facelets_is_solved(const RubixCubeFacelets * pFacelets) {
+	rubix_cube_facelet_init_tables() ;
+	return rubix_cube_facelets_equivelence_check(pFacelets,&rubix_cube_facelets_solved) ;
+}
@@ -0,0 +1,148 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Facelet model:
+ *
+ * Every visible square (facelet) of the cube is one byte holding its RubixCubeColor.
+ * Facelets are stored face after face in RubixCubeSquare order (top, front, right,
+ * left, back, bottom), and within a face in the same order RubixCubeFace uses:
+ *
+ * facelet index = face * RUBIX_CUBE_PIECES_PER_FACE + square
+ *
+ * That makes 54 bytes, padded to 64 so that a cube fills exactly one cache line and
+ * four 16 byte vector registers. The padding is always zero.
+ *
+ * Under this layout every move is just a permutation of bytes:
+ *
+ * new.facelets[i] = old.facelets[permutation.map[i]]
+ *
+ * which is applied with byte shuffles (pshufb on x86, tbl on ARM) where available
+ * and a plain loop everywhere else.
+ */
+
+#ifndef RUBIX_CUBE_FACELET_H
+#define RUBIX_CUBE_FACELET_H "rubix_cube_facelet.h"
+
+#include "rubix_cube.h"
+
+#define RUBIX_CUBE_FACELET_COUNT 	(RUBIX_CUBE_SIDE_COUNT * RUBIX_CUBE_PIECES_PER_FACE)
+#define RUBIX_CUBE_FACELET_STRIDE 	64
+
+typedef struct rubix_cube_facelets {
+	unsigned char facelets[RUBIX_CUBE_FACELET_STRIDE] ;
+} __attribute__((aligned(RUBIX_CUBE_FACELET_STRIDE))) RubixCubeFacelets ;
+
+typedef struct rubix_cube_facelet_permutation {
+	unsigned char map[RUBIX_CUBE_FACELET_STRIDE] ;
+} __attribute__((aligned(RUBIX_CUBE_FACELET_STRIDE))) RubixCubeFaceletPermutation ;
+
+/* Implementations of the permutation kernel, RUBIX_CUBE_FACELET_KERNEL_AUTO picks the best one */
+typedef enum rubix_cube_facelet_kernel {
+	RUBIX_CUBE_FACELET_KERNEL_AUTO,
+	RUBIX_CUBE_FACELET_KERNEL_SCALAR,
+	RUBIX_CUBE_FACELET_KERNEL_SSSE3,
+	RUBIX_CUBE_FACELET_KERNEL_AVX2,
+	RUBIX_CUBE_FACELET_KERNEL_NEON
+} RubixCubeFaceletKernel ;
+#define RUBIX_CUBE_FACELET_KERNEL_COUNT 5
+
+/* Get a copy of the solved cube in facelet form */
+RubixCubeFacelets rubix_cube_facelets_generate_solved() ;
+
+/* Convert a RubixCube to facelet form */
+RubixCubeFacelets rubix_cube_facelets_from_cube(RubixCube * pRubix_cube) ;
+
+/* Convert facelets back into a RubixCube */
+RubixCube rubix_cube_facelets_to_cube(RubixCubeFacelets * pFacelets) ;
+
+/* Get the permutation that makes up a single face rotation */
+const RubixCubeFaceletPermutation * rubix_cube_facelet_get_move(RubixCubeSide side, RubixCubeFaceRotation face_rotation) ;
+
+/* Get the permutation that does nothing */
+RubixCubeFaceletPermutation rubix_cube_facelet_permutation_identity() ;
+
+/* Set @dest to the permutation doing @first, then @second, @dest may alias either argument */
+void rubix_cube_facelet_permutation_compose(RubixCubeFaceletPermutation * dest, const RubixCubeFaceletPermutation * first, const RubixCubeFaceletPermutation * second) ;
+
+/* Set @dest to @src with @permutation applied, @dest may alias @src */
+void rubix_cube_facelets_permute(RubixCubeFacelets * dest, const RubixCubeFacelets * src, const RubixCubeFaceletPermutation * permutation) ;
+
+/* Same as rubix_cube_rotate_face(), on facelets */
+void rubix_cube_facelets_rotate_face(RubixCubeFacelets * pFacelets, RubixCubeSide side, RubixCubeFaceRotation face_rotation) ;
+
+/* Same as rubix_cube_apply_move(), on facelets */
+void rubix_cube_facelets_apply_move(RubixCubeFacelets * pFacelets, RubixCubeMove * move) ;
+
+/* Same as rubix_cube_apply_scramble(), on facelets */
+void rubix_cube_facelets_apply_scramble(RubixCubeFacelets * pFacelets, RubixCubeScramble * pScramble) ;
+
+/* Apply @number_of_moves @moves, in order, to each of the @count facelet cubes in @cubes */
+void rubix_cube_facelets_apply_moves_all(RubixCubeFacelets * cubes, size_t count, const RubixCubeMove * moves, size_t number_of_moves) ;
+
+/* Apply @moves[i] to @cubes[i] for each of the @count cubes */
+void rubix_cube_facelets_apply_moves_each(RubixCubeFacelets * cubes, const RubixCubeMove * moves, size_t count) ;
+
+/* Apply @permutation to each of the @count facelet cubes in @cubes */
+void rubix_cube_facelets_permute_all(RubixCubeFacelets * cubes, size_t count, const RubixCubeFaceletPermutation * permutation) ;
+
+/*
+ * Byte coded moves (see rubix_cube_packed_scramble.h) are what the Python bindings hand
+ * over, straight from a buffer they own. Every code is checked before any cube is touched,
+ * so these return 0 and leave @cubes alone if one of them is not a move.
+ */
+
+/* Apply the @number_of_moves @codes, in order, to each of the @count facelet cubes in @cubes */
+int rubix_cube_facelets_apply_codes_all(RubixCubeFacelets * cubes, size_t count, const unsigned char * codes, size_t number_of_moves) ;
+
+/* Apply row i of @codes, @moves_per_cube codes starting at @codes[i * @moves_per_cube], to @cubes[i] */
+int rubix_cube_facelets_apply_codes_rows(RubixCubeFacelets * cubes, size_t count, const unsigned char * codes, size_t moves_per_cube) ;
+
+/* Undo what rubix_cube_facelets_apply_codes_rows() did with the same arguments */
+int rubix_cube_facelets_unapply_codes_rows(RubixCubeFacelets * cubes, size_t count, const unsigned char * codes, size_t moves_per_cube) ;
+
+/* Apply @count byte @codes to @pFacelets in order, stopping right after the first one that leaves it solved */
+/* Return how many were applied, which is @count if it never was, 0 and nothing done if a code is not a move */
+size_t rubix_cube_facelets_walk_codes(RubixCubeFacelets * pFacelets, const unsigned char * codes, size_t count) ;
+
+/* Set each of the @count facelet cubes in @cubes to the solved cube */
+void rubix_cube_facelets_fill_solved(RubixCubeFacelets * cubes, size_t count) ;
+
+/* Return the number of solved cubes in @cubes, if @results is not NULL also set @results[i] nonzero for each solved cube */
+size_t rubix_cube_facelets_count_solved(const RubixCubeFacelets * cubes, size_t count, unsigned char * results) ;
+
+/* Return nonzero if the two facelet cubes are identical, else return 0 */
+int rubix_cube_facelets_equivelence_check(const RubixCubeFacelets * first, const RubixCubeFacelets * second) ;
+
+/* Return 0 if the facelet cube is not solved, else return nonzero value */
+int rubix_cube_facelets_is_solved(const RubixCubeFacelets * pFacelets) ;
+
+/* Switch the permutation kernel, return nonzero if @kernel is supported on this machine */
+/* Not safe to call while other threads are applying moves */
+int rubix_cube_facelet_select_kernel(RubixCubeFaceletKernel kernel) ;
+
+/* Return nonzero if @kernel can run on this machine */
+int rubix_cube_facelet_kernel_supported(RubixCubeFaceletKernel kernel) ;
+
+/* Get the kernel currently used for permutations */
+RubixCubeFaceletKernel rubix_cube_facelet_get_kernel() ;
+
+/* Get a character string naming a RubixCubeFaceletKernel value */
+const char * rubix_cube_facelet_get_kernel_string(RubixCubeFaceletKernel kernel) ;
+
+#endif // RUBIX_CUBE_FACELET_H
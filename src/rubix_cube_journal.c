@@ -0,0 +1,146 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+#include "rubix_cube_journal.h"
+#include "rubix_cube_packed_scramble.h"
+#include <stdlib.h>
+
+#define RUBIX_CUBE_JOURNAL_SIDE(code) 		((RubixCubeSide)((code) / RUBIX_CUBE_FACE_ROTATION_COUNT))
+#define RUBIX_CUBE_JOURNAL_ROTATION(code) 	((RubixCubeFaceRotation)((code) % RUBIX_CUBE_FACE_ROTATION_COUNT))
+
+static inline RubixCube * rubix_cube_journal_snapshot(const RubixCubeJournal * pJournal, size_t position) {
+	return &pJournal->snapshots[position / pJournal->interval % pJournal->snapshot_count] ;
+}
+
+/* Record @code as the move at the current position, which it then moves past */
+static inline void rubix_cube_journal_record(RubixCubeJournal * pJournal, unsigned char code) {
+	pJournal->moves[pJournal->position % pJournal->capacity] = code ;
+	if (++pJournal->position % pJournal->interval == 0) {
+		*rubix_cube_journal_snapshot(pJournal,pJournal->position) = *pJournal->pCube ;
+	}
+	/* The first position whose snapshot and moves up to now are all still there */
+	if (pJournal->position - pJournal->oldest > pJournal->capacity) pJournal->oldest += pJournal->interval ;
+}
+
+static inline void rubix_cube_journal_make(RubixCubeJournal * pJournal, unsigned char code) {
+	rubix_cube_rotate_face(pJournal->pCube,RUBIX_CUBE_JOURNAL_SIDE(code),RUBIX_CUBE_JOURNAL_ROTATION(code)) ;
+	rubix_cube_journal_record(pJournal,code) ;
+}
+
+RubixCubeJournal * rubix_cube_journal_allocate(RubixCube * pRubix_cube, size_t capacity, size_t interval) {
+	RubixCubeJournal * pNew ;
+
+	if (!pRubix_cube) return NULL ;
+	if (!(pNew = (RubixCubeJournal *)calloc(1,sizeof(RubixCubeJournal)))) return NULL ;
+
+	pNew->pCube = pRubix_cube ;
+	pNew->interval = interval ? interval : RUBIX_CUBE_JOURNAL_INTERVAL ;
+	if (!capacity) capacity = RUBIX_CUBE_JOURNAL_CAPACITY ;
+	pNew->capacity = (capacity + pNew->interval - 1) / pNew->interval * pNew->interval ;
+	pNew->snapshot_count = pNew->capacity / pNew->interval + 1 ;
+
+	if (!(pNew->moves = (unsigned char *)malloc(pNew->capacity)) ||
+			!(pNew->snapshots = (RubixCube *)malloc(sizeof(RubixCube) * pNew->snapshot_count))) {
+		rubix_cube_journal_free(pNew) ;
+		return NULL ;
+	}
+	rubix_cube_journal_restart(pNew) ;
+	return pNew ;
+}
+
+void rubix_cube_journal_free(RubixCubeJournal * pJournal) {
+	if (pJournal) {
+		free(pJournal->moves) ;
+		free(pJournal->snapshots) ;
+		free(pJournal) ;
+	}
+}
+
+void rubix_cube_journal_restart(RubixCubeJournal * pJournal) {
+	pJournal->position = 0 ;
+	pJournal->oldest = 0 ;
+	pJournal->snapshots[0] = *pJournal->pCube ;
+}
+
+void rubix_cube_journal_apply_move(RubixCubeJournal * pJournal, const RubixCubeMove * move) {
+	if (move) rubix_cube_journal_make(pJournal,rubix_cube_move_encode(move)) ;
+}
+
+void rubix_cube_journal_apply_scramble(RubixCubeJournal * pJournal, const RubixCubeScramble * pScramble) {
+	for (size_t i = 0; i < pScramble->size; ++i) {
+		rubix_cube_journal_make(pJournal,rubix_cube_move_encode(&pScramble->moves[i])) ;
+	}
+}
+
+void rubix_cube_journal_unapply_scramble(RubixCubeJournal * pJournal, const RubixCubeScramble * pScramble) {
+	for (size_t i = pScramble->size; i > 0; --i) {
+		rubix_cube_journal_make(pJournal,RUBIX_CUBE_MOVE_INDEX_INVERSE(rubix_cube_move_encode(&pScramble->moves[i-1]))) ;
+	}
+}
+
+int rubix_cube_journal_apply_codes(RubixCubeJournal * pJournal, const unsigned char * codes, size_t count) {
+	for (size_t i = 0; i < count; ++i) if (codes[i] >= RUBIX_CUBE_MOVE_COUNT) return 0 ;
+	for (size_t i = 0; i < count; ++i) rubix_cube_journal_make(pJournal,codes[i]) ;
+	return 1 ;
+}
+
+int rubix_cube_journal_unapply_codes(RubixCubeJournal * pJournal, const unsigned char * codes, size_t count) {
+	for (size_t i = 0; i < count; ++i) if (codes[i] >= RUBIX_CUBE_MOVE_COUNT) return 0 ;
+	for (size_t i = count; i > 0; --i) rubix_cube_journal_make(pJournal,RUBIX_CUBE_MOVE_INDEX_INVERSE(codes[i-1])) ;
+	return 1 ;
+}
+
+int rubix_cube_journal_rewind(RubixCubeJournal * pJournal, size_t position) {
+	size_t from = position / pJournal->interval * pJournal->interval ;
+
+	if (position > pJournal->position || position < pJournal->oldest) return 0 ;
+
+	/* Only moves back to the last snapshot, turning them back is cheaper than a copy and a replay */
+	if (pJournal->position - position < position - from) {
+		for (size_t p = pJournal->position; p > position; --p) {
+			unsigned char code = RUBIX_CUBE_MOVE_INDEX_INVERSE(pJournal->moves[(p - 1) % pJournal->capacity]) ;
+			rubix_cube_rotate_face(pJournal->pCube,RUBIX_CUBE_JOURNAL_SIDE(code),RUBIX_CUBE_JOURNAL_ROTATION(code)) ;
+		}
+	} else {
+		*pJournal->pCube = *rubix_cube_journal_snapshot(pJournal,from) ;
+		for (size_t p = from; p < position; ++p) {
+			unsigned char code = pJournal->moves[p % pJournal->capacity] ;
+			rubix_cube_rotate_face(pJournal->pCube,RUBIX_CUBE_JOURNAL_SIDE(code),RUBIX_CUBE_JOURNAL_ROTATION(code)) ;
+		}
+	}
+	pJournal->position = position ;
+	return 1 ;
+}
+
+int rubix_cube_journal_undo(RubixCubeJournal * pJournal, size_t count) {
+	if (count > pJournal->position) return 0 ;
+	return rubix_cube_journal_rewind(pJournal,pJournal->position - count) ;
+}
+
+size_t rubix_cube_journal_position(const RubixCubeJournal * pJournal) {
+	return pJournal->position ;
+}
+
+size_t rubix_cube_journal_oldest(const RubixCubeJournal * pJournal) {
+	return pJournal->oldest ;
+}
+
+int rubix_cube_journal_read_codes(const RubixCubeJournal * pJournal, size_t position, unsigned char * codes, size_t count) {
+	if (position < pJournal->oldest || position > pJournal->position || count > pJournal->position - position) return 0 ;
+	for (size_t i = 0; i < count; ++i) codes[i] = pJournal->moves[(position + i) % pJournal->capacity] ;
+	return 1 ;
+}
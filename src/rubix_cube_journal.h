@@ -0,0 +1,89 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+/*
+ * Journals:
+ *
+ * A RubixCubeJournal records every move made on a cube so that it can be taken back to
+ * how it was at any earlier point, without replaying everything from the start. Moves go
+ * in a ring of move codes (see rubix_cube_packed_scramble.h) and every @interval moves a
+ * copy of the whole cube goes in a ring of snapshots:
+ *
+ * 	moves: 	   [ m0 m1 ... m31 | m32 ... m63 | m64 ... ]
+ * 	snapshots: [ at 0 ]        [ at 32 ]     [ at 64 ] ...
+ *
+ * Rewinding to position p copies the snapshot at or before p and replays the fewer than
+ * @interval moves after it, and moves made after a rewind write over the ones that were
+ * undone. Once more than @capacity moves were made the oldest ones are forgotten, the
+ * earliest position that can still be reached is then rubix_cube_journal_oldest().
+ *
+ * The cube itself is the caller's, its moves just have to go through the journal.
+ */
+
+#ifndef RUBIX_CUBE_JOURNAL_H
+#define RUBIX_CUBE_JOURNAL_H "rubix_cube_journal.h"
+
+#include "rubix_cube.h"
+
+#define RUBIX_CUBE_JOURNAL_CAPACITY 	4096
+#define RUBIX_CUBE_JOURNAL_INTERVAL 	32
+
+typedef struct rubix_cube_journal {
+	RubixCube * 			pCube ;
+	unsigned char * 		moves ;		/* move codes, the one made at position p is at p % capacity */
+	RubixCube * 			snapshots ;	/* the cube at position k * interval is at k % snapshot_count */
+	size_t 				capacity ;	/* a multiple of interval */
+	size_t 				interval ;
+	size_t 				snapshot_count ;
+	size_t 				position ;	/* moves made since the start, less the rewound ones */
+	size_t 				oldest ;	/* earliest position that can be rewound to */
+} RubixCubeJournal ;
+
+/* Return a journal for @pRubix_cube, which is at position 0 as it is now. 0 for @capacity or @interval takes the defaults above */
+RubixCubeJournal * rubix_cube_journal_allocate(RubixCube * pRubix_cube, size_t capacity, size_t interval) ;
+
+/* Free a journal, the cube is left as it is */
+void rubix_cube_journal_free(RubixCubeJournal * pJournal) ;
+
+/* Forget every move, the cube as it is now is the new position 0 */
+void rubix_cube_journal_restart(RubixCubeJournal * pJournal) ;
+
+/* Make a move on the cube and record it */
+void rubix_cube_journal_apply_move(RubixCubeJournal * pJournal, const RubixCubeMove * move) ;
+
+/* Same as rubix_cube_apply_scramble() / rubix_cube_unapply_scramble(), recorded move by move */
+void rubix_cube_journal_apply_scramble(RubixCubeJournal * pJournal, const RubixCubeScramble * pScramble) ;
+void rubix_cube_journal_unapply_scramble(RubixCubeJournal * pJournal, const RubixCubeScramble * pScramble) ;
+
+/* Same as rubix_cube_apply_move_codes() / rubix_cube_unapply_move_codes(), 0 and nothing done for a bad code */
+int rubix_cube_journal_apply_codes(RubixCubeJournal * pJournal, const unsigned char * codes, size_t count) ;
+int rubix_cube_journal_unapply_codes(RubixCubeJournal * pJournal, const unsigned char * codes, size_t count) ;
+
+/* Take the cube back to @position, replaying at most interval - 1 moves. 0 if it is ahead of now or was forgotten */
+int rubix_cube_journal_rewind(RubixCubeJournal * pJournal, size_t position) ;
+
+/* Take back the last @count moves, 0 if there are not that many left */
+int rubix_cube_journal_undo(RubixCubeJournal * pJournal, size_t count) ;
+
+/* Return the current position, and the earliest one rubix_cube_journal_rewind() can go to */
+size_t rubix_cube_journal_position(const RubixCubeJournal * pJournal) ;
+size_t rubix_cube_journal_oldest(const RubixCubeJournal * pJournal) ;
+
+/* Copy the @count codes of the moves from @position on into @codes, 0 if some of them are forgotten or not made yet */
+int rubix_cube_journal_read_codes(const RubixCubeJournal * pJournal, size_t position, unsigned char * codes, size_t count) ;
+
+#endif // RUBIX_CUBE_JOURNAL_H
@@ -0,0 +1,327 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+#include "rubix_cube_monkeys.h"
+#include "rubix_cube_facelet.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#define RUBIX_CUBE_MONKEYS_SKETCH_SIZE 	(1u << RUBIX_CUBE_MONKEYS_SKETCH_BITS)
+
+/* Moves generated at a time, and how many a worker makes between publishing its counts */
+#define RUBIX_CUBE_MONKEYS_CHUNK 	256
+#define RUBIX_CUBE_MONKEYS_PUBLISH 	(1ull << 20)
+
+/* Everything a worker counts, only whole unsigned long longs so it can be published one word at a time */
+typedef struct rubix_cube_monkeys_counts {
+	unsigned long long 		moves ;
+	unsigned long long 		walks ;
+	unsigned long long 		returns[RUBIX_CUBE_MONKEYS_DEPTHS] ;
+	unsigned long long 		late_returns ;
+	unsigned long long 		misplaced[RUBIX_CUBE_MONKEYS_DEPTHS] ;
+} RubixCubeMonkeysCounts ;
+
+#define RUBIX_CUBE_MONKEYS_WORDS 	(sizeof(RubixCubeMonkeysCounts) / sizeof(unsigned long long))
+
+typedef struct rubix_cube_monkeys rubix_cube_monkeys ;
+
+typedef struct rubix_cube_monkeys_worker {
+	RubixCubeMonkeysCounts 		published ;	/* only written by the worker, read by the reporter */
+	unsigned char 			sketches[RUBIX_CUBE_MONKEYS_DEPTHS][RUBIX_CUBE_MONKEYS_SKETCH_SIZE] ;
+	size_t 				first_walker ;
+	size_t 				walkers ;
+	rubix_cube_monkeys * 		pMonkeys ;
+	pthread_t 			thread ;
+	int 				failed ;
+} __attribute__((aligned(64))) RubixCubeMonkeysWorker ;
+
+struct rubix_cube_monkeys {
+	const RubixCubeMonkeysJob * 	pJob ;
+	size_t 				walkers ;
+	size_t 				length ;
+	RubixCubeMonkeysWorker * 	workers ;
+	size_t 				number_of_workers ;
+	int 				stop ;
+	size_t 				running ;
+	pthread_mutex_t 		lock ;		/* only around @running, so the reporter can wait for the end */
+	pthread_cond_t 			finished ;
+	struct timespec 		start ;
+} ;
+
+/* Eight moves out of every 64 random bits, each one the top of the bits times RUBIX_CUBE_MOVE_COUNT */
+/* with the rest going on to the next, that leaves 31 bits for the last one so the bias is far below noise */
+static inline void rubix_cube_monkeys_codes(RubixCubeRandom * pRandom, unsigned char * codes, size_t count) {
+	for (size_t i = 0; i < count; i += 8) {
+		unsigned long long bits = rubix_cube_random_next(pRandom) ;
+		for (size_t k = 0; k < 8 && i + k < count; ++k) {
+			unsigned __int128 product = (unsigned __int128)bits * RUBIX_CUBE_MOVE_COUNT ;
+			codes[i + k] = (unsigned char)(product >> 64) ;
+			bits = (unsigned long long)product ;
+		}
+	}
+}
+
+static inline uint64_t rubix_cube_monkeys_hash(const RubixCubeFacelets * pFacelets) {
+	uint64_t words[RUBIX_CUBE_FACELET_STRIDE / sizeof(uint64_t)], hash = 0 ;
+
+	memcpy(words,pFacelets->facelets,sizeof(words)) ;
+	for (size_t i = 0; i < sizeof(words) / sizeof(*words); ++i) hash = (hash ^ words[i]) * RUBIX_CUBE_RANDOM_GAMMA ;
+	return rubix_cube_mix64(hash) ;
+}
+
+/* A sketch register keeps the longest run of zeros seen after the hash bits that pick it */
+static inline void rubix_cube_monkeys_sketch(unsigned char * sketch, const RubixCubeFacelets * pFacelets) {
+	uint64_t hash = rubix_cube_monkeys_hash(pFacelets), rest = hash << RUBIX_CUBE_MONKEYS_SKETCH_BITS ;
+	size_t index = (size_t)(hash >> (64 - RUBIX_CUBE_MONKEYS_SKETCH_BITS)) ;
+	unsigned char rank = rest ? (unsigned char)(__builtin_clzll(rest) + 1) : (unsigned char)(64 - RUBIX_CUBE_MONKEYS_SKETCH_BITS + 1) ;
+
+	if (rank > sketch[index]) __atomic_store_n(&sketch[index],rank,__ATOMIC_RELAXED) ;
+}
+
+static double rubix_cube_monkeys_estimate(const unsigned char * sketch) {
+	const double m = RUBIX_CUBE_MONKEYS_SKETCH_SIZE, alpha = 0.7213 / (1.0 + 1.079 / m) ;
+	double sum = 0.0, estimate ;
+	size_t zeros = 0 ;
+
+	for (size_t i = 0; i < RUBIX_CUBE_MONKEYS_SKETCH_SIZE; ++i) {
+		sum += ldexp(1.0,-(int)sketch[i]) ;
+		zeros += !sketch[i] ;
+	}
+	estimate = alpha * m * m / sum ;
+	/* Few states leave most registers empty, counting those is better then */
+	if (estimate <= 2.5 * m && zeros) estimate = m * log(m / (double)zeros) ;
+	return estimate ;
+}
+
+static inline size_t rubix_cube_monkeys_count_misplaced(const RubixCubeFacelets * pFacelets, const RubixCubeFacelets * pSolved) {
+	size_t misplaced = 0 ;
+	for (size_t i = 0; i < RUBIX_CUBE_FACELET_COUNT; ++i) misplaced += pFacelets->facelets[i] != pSolved->facelets[i] ;
+	return misplaced ;
+}
+
+/* Make one whole walk */
+static void rubix_cube_monkeys_walk(RubixCubeMonkeysWorker * pWorker, RubixCubeRandom * pRandom, RubixCubeMonkeysCounts * pCounts,
+		const RubixCubeFacelets * pSolved) {
+	size_t length = pWorker->pMonkeys->length, t = 0 ;
+	unsigned char codes[RUBIX_CUBE_MONKEYS_CHUNK] ;
+	RubixCubeFacelets cube = *pSolved ;
+	int returned = 0 ;
+
+	rubix_cube_monkeys_sketch(pWorker->sketches[0],&cube) ;
+	while (t < length) {
+		size_t chunk = length - t < RUBIX_CUBE_MONKEYS_CHUNK ? length - t : RUBIX_CUBE_MONKEYS_CHUNK, i = 0 ;
+
+		rubix_cube_monkeys_codes(pRandom,codes,chunk) ;
+		/* The first moves one at a time, every state they go through is counted */
+		for (; i < chunk && t + 1 < RUBIX_CUBE_MONKEYS_DEPTHS; ++i) {
+			rubix_cube_facelets_apply_codes_all(&cube,1,&codes[i],1) ;
+			++t ;
+			pCounts->misplaced[t] += rubix_cube_monkeys_count_misplaced(&cube,pSolved) ;
+			rubix_cube_monkeys_sketch(pWorker->sketches[t],&cube) ;
+			if (!returned && !memcmp(&cube,pSolved,sizeof(cube))) {
+				++pCounts->returns[t] ;
+				returned = 1 ;
+			}
+		}
+		while (!returned && i < chunk) {
+			size_t made = rubix_cube_facelets_walk_codes(&cube,&codes[i],chunk - i) ;
+			i += made ;
+			t += made ;
+			if (!memcmp(&cube,pSolved,sizeof(cube))) {
+				++pCounts->late_returns ;
+				returned = 1 ;
+			}
+		}
+		if (i < chunk) rubix_cube_facelets_apply_codes_all(&cube,1,&codes[i],chunk - i) ;
+		t += chunk - i ;
+	}
+	pCounts->moves += length ;
+	++pCounts->walks ;
+}
+
+static void rubix_cube_monkeys_publish(RubixCubeMonkeysWorker * pWorker, const RubixCubeMonkeysCounts * pCounts) {
+	const unsigned long long * from = (const unsigned long long *)pCounts ;
+	unsigned long long * to = (unsigned long long *)&pWorker->published ;
+
+	for (size_t i = 0; i < RUBIX_CUBE_MONKEYS_WORDS; ++i) __atomic_store_n(&to[i],from[i],__ATOMIC_RELAXED) ;
+}
+
+static void * rubix_cube_monkeys_work(void * argument) {
+	RubixCubeMonkeysWorker * pWorker = (RubixCubeMonkeysWorker *)argument ;
+	rubix_cube_monkeys * pMonkeys = pWorker->pMonkeys ;
+	const RubixCubeMonkeysJob * pJob = pMonkeys->pJob ;
+	RubixCubeRandom * randoms = (RubixCubeRandom *)malloc(pWorker->walkers * sizeof(RubixCubeRandom)) ;
+	RubixCubeRandom seeds = rubix_cube_random_generate(pJob->seed) ;
+	RubixCubeFacelets solved = rubix_cube_facelets_generate_solved() ;
+	RubixCubeMonkeysCounts counts ;
+	unsigned long long published = 0 ;
+
+	memset(&counts,0,sizeof(counts)) ;
+	if (!randoms) {
+		pWorker->failed = 1 ;
+		__atomic_store_n(&pMonkeys->stop,1,__ATOMIC_RELAXED) ;
+	}
+	/* Walker i's generator is seeded with value i of the job's own */
+	for (size_t i = 0; randoms && i < pWorker->walkers; ++i) {
+		rubix_cube_random_seek(&seeds,pWorker->first_walker + i) ;
+		randoms[i] = rubix_cube_random_generate((RubixCubeSeed)rubix_cube_random_next(&seeds)) ;
+	}
+
+	for (size_t walk = 0; randoms && (!pJob->walks || walk < pJob->walks); ++walk) {
+		for (size_t i = 0; i < pWorker->walkers; ++i) {
+			if (__atomic_load_n(&pMonkeys->stop,__ATOMIC_RELAXED)) goto stopped ;
+			rubix_cube_monkeys_walk(pWorker,&randoms[i],&counts,&solved) ;
+			if (counts.moves - published >= RUBIX_CUBE_MONKEYS_PUBLISH) {
+				rubix_cube_monkeys_publish(pWorker,&counts) ;
+				published = counts.moves ;
+			}
+		}
+	}
+stopped:
+	rubix_cube_monkeys_publish(pWorker,&counts) ;
+	free(randoms) ;
+
+	pthread_mutex_lock(&pMonkeys->lock) ;
+	if (!--pMonkeys->running) pthread_cond_signal(&pMonkeys->finished) ;
+	pthread_mutex_unlock(&pMonkeys->lock) ;
+	return NULL ;
+}
+
+/* Add up what the workers have published so far */
+static void rubix_cube_monkeys_collect(rubix_cube_monkeys * pMonkeys, RubixCubeMonkeysSummary * pSummary) {
+	unsigned char sketch[RUBIX_CUBE_MONKEYS_SKETCH_SIZE] ;
+	RubixCubeMonkeysCounts total ;
+	unsigned long long * sums = (unsigned long long *)&total ;
+	struct timespec now ;
+
+	memset(&total,0,sizeof(total)) ;
+	for (size_t w = 0; w < pMonkeys->number_of_workers; ++w) {
+		const unsigned long long * words = (const unsigned long long *)&pMonkeys->workers[w].published ;
+		for (size_t i = 0; i < RUBIX_CUBE_MONKEYS_WORDS; ++i) sums[i] += __atomic_load_n(&words[i],__ATOMIC_RELAXED) ;
+	}
+	memset(pSummary,0,sizeof(*pSummary)) ;
+	pSummary->moves = total.moves ;
+	pSummary->walks = total.walks ;
+	pSummary->late_returns = total.late_returns ;
+	memcpy(pSummary->returns,total.returns,sizeof(total.returns)) ;
+	memcpy(pSummary->misplaced,total.misplaced,sizeof(total.misplaced)) ;
+
+	/* Sketches merge by taking the larger register */
+	for (size_t t = 0; t < RUBIX_CUBE_MONKEYS_DEPTHS; ++t) {
+		memset(sketch,0,sizeof(sketch)) ;
+		for (size_t w = 0; w < pMonkeys->number_of_workers; ++w) {
+			const unsigned char * registers = pMonkeys->workers[w].sketches[t] ;
+			for (size_t i = 0; i < RUBIX_CUBE_MONKEYS_SKETCH_SIZE; ++i) {
+				unsigned char rank = __atomic_load_n(&registers[i],__ATOMIC_RELAXED) ;
+				sketch[i] = rank > sketch[i] ? rank : sketch[i] ;
+			}
+		}
+		pSummary->states[t] = rubix_cube_monkeys_estimate(sketch) ;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC,&now) ;
+	pSummary->seconds = (double)(now.tv_sec - pMonkeys->start.tv_sec) + (double)(now.tv_nsec - pMonkeys->start.tv_nsec) * 1e-9 ;
+}
+
+/* Wait up to @seconds for the workers to finish, return nonzero once they have */
+static int rubix_cube_monkeys_wait(rubix_cube_monkeys * pMonkeys, double seconds) {
+	struct timespec deadline ;
+	int done ;
+
+	clock_gettime(CLOCK_REALTIME,&deadline) ;
+	deadline.tv_sec += (time_t)seconds ;
+	deadline.tv_nsec += (long)((seconds - (double)(time_t)seconds) * 1e9) ;
+	if (deadline.tv_nsec >= 1000000000L) {
+		++deadline.tv_sec ;
+		deadline.tv_nsec -= 1000000000L ;
+	}
+	pthread_mutex_lock(&pMonkeys->lock) ;
+	while (pMonkeys->running && pthread_cond_timedwait(&pMonkeys->finished,&pMonkeys->lock,&deadline) == 0) ;
+	done = !pMonkeys->running ;
+	pthread_mutex_unlock(&pMonkeys->lock) ;
+	return done ;
+}
+
+int rubix_cube_monkeys_run(const RubixCubeMonkeysJob * pJob, RubixCubeMonkeysSummary * pSummary) {
+	rubix_cube_monkeys monkeys = { .pJob = pJob } ;
+	RubixCubeMonkeysSummary summary ;
+	int reporting, success = 1 ;
+	size_t started ;
+
+	if (!pJob) return 0 ;
+	reporting = pJob->callback && pJob->interval > 0.0 ;
+	if (!pJob->walks && !reporting) return 0 ;
+	monkeys.walkers = pJob->walkers ? pJob->walkers : RUBIX_CUBE_MONKEYS_WALKERS ;
+	monkeys.length = pJob->length ? pJob->length : RUBIX_CUBE_MONKEYS_LENGTH ;
+
+	monkeys.number_of_workers = pJob->threads ;
+	if (!monkeys.number_of_workers) {
+		long online = sysconf(_SC_NPROCESSORS_ONLN) ;
+		monkeys.number_of_workers = online > 0 ? (size_t)online : 1 ;
+	}
+	if (monkeys.number_of_workers > monkeys.walkers) monkeys.number_of_workers = monkeys.walkers ;
+
+	if (posix_memalign((void **)&monkeys.workers,64,monkeys.number_of_workers * sizeof(RubixCubeMonkeysWorker))) return 0 ;
+	memset(monkeys.workers,0,monkeys.number_of_workers * sizeof(RubixCubeMonkeysWorker)) ;
+	for (size_t i = 0; i < monkeys.number_of_workers; ++i) {
+		monkeys.workers[i].first_walker = monkeys.walkers * i / monkeys.number_of_workers ;
+		monkeys.workers[i].walkers = monkeys.walkers * (i + 1) / monkeys.number_of_workers - monkeys.workers[i].first_walker ;
+		monkeys.workers[i].pMonkeys = &monkeys ;
+	}
+	pthread_mutex_init(&monkeys.lock,NULL) ;
+	pthread_cond_init(&monkeys.finished,NULL) ;
+	monkeys.running = monkeys.number_of_workers ;
+	clock_gettime(CLOCK_MONOTONIC,&monkeys.start) ;
+
+	/* The calling thread works too, as worker 0, unless it has to report */
+	for (started = reporting ? 0 : 1; started < monkeys.number_of_workers; ++started) {
+		if (pthread_create(&monkeys.workers[started].thread,NULL,rubix_cube_monkeys_work,&monkeys.workers[started])) break ;
+	}
+	if (started < monkeys.number_of_workers) {
+		/* Whatever did start stops right away, and the ones that did not are not waited for */
+		__atomic_store_n(&monkeys.stop,1,__ATOMIC_RELAXED) ;
+		pthread_mutex_lock(&monkeys.lock) ;
+		monkeys.running -= monkeys.number_of_workers - started ;
+		pthread_mutex_unlock(&monkeys.lock) ;
+		success = 0 ;
+	}
+	if (!reporting && success) rubix_cube_monkeys_work(&monkeys.workers[0]) ;
+	while (reporting && success && !rubix_cube_monkeys_wait(&monkeys,pJob->interval)) {
+		rubix_cube_monkeys_collect(&monkeys,&summary) ;
+		if (pJob->callback(&summary,pJob->context)) __atomic_store_n(&monkeys.stop,1,__ATOMIC_RELAXED) ;
+	}
+
+	for (size_t i = reporting ? 0 : 1; i < started; ++i) pthread_join(monkeys.workers[i].thread,NULL) ;
+	for (size_t i = 0; i < monkeys.number_of_workers; ++i) success &= !monkeys.workers[i].failed ;
+	rubix_cube_monkeys_collect(&monkeys,&summary) ;
+	if (pSummary) *pSummary = summary ;
+
+	pthread_cond_destroy(&monkeys.finished) ;
+	pthread_mutex_destroy(&monkeys.lock) ;
+	free(monkeys.workers) ;
+	return success ;
+}
+
+double rubix_cube_monkeys_misplaced(const RubixCubeMonkeysSummary * pSummary, size_t depth) {
+	if (depth >= RUBIX_CUBE_MONKEYS_DEPTHS || !pSummary->walks) return 0.0 ;
+	return (double)pSummary->misplaced[depth] / (double)pSummary->walks ;
+}
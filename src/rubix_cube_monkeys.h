@@ -0,0 +1,87 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+/*
+ * Monkeys:
+ *
+ * Lots of monkeys, each one turning the faces of its own cube at random. Every walker
+ * starts at the solved cube, makes @length random moves and starts over, @walks times.
+ * No walk is kept, only what they all add up to:
+ *
+ * 	- how many moves it took a walk to first come back to solved, if it did
+ * 	- how far the walks are from solved after t moves, as misplaced facelets
+ * 	- how many different states the walks were in after t moves, estimated with
+ * 	  a HyperLogLog sketch per t, so it takes the same memory for any number of walks
+ *
+ * the last two for t < RUBIX_CUBE_MONKEYS_DEPTHS. Cubes are in facelet form, and past
+ * those first moves a walk is only checked for having come back, by the same kernel
+ * that makes the moves (see rubix_cube_facelets_walk_codes()).
+ *
+ * Walker i has a RubixCubeRandom of its own and the walkers are split evenly between
+ * the threads, which count into their own cache lines without locks or atomic adds.
+ * Every @interval seconds the calling thread adds up what has been counted so far for
+ * the callback, which can end the job. Walker i always makes the same moves, so a job
+ * that runs to the end gives the same totals for any number of threads.
+ */
+
+#ifndef RUBIX_CUBE_MONKEYS_H
+#define RUBIX_CUBE_MONKEYS_H "rubix_cube_monkeys.h"
+
+#include "rubix_cube.h"
+
+/* Moves from solved with their own statistics, 0 up to God's number */
+#define RUBIX_CUBE_MONKEYS_DEPTHS 	21
+
+/* Defaults for a job that leaves them 0 */
+#define RUBIX_CUBE_MONKEYS_WALKERS 	4096
+#define RUBIX_CUBE_MONKEYS_LENGTH 	1024
+
+/* 2^10 registers per sketch, the state counts are then good to about 3% */
+#define RUBIX_CUBE_MONKEYS_SKETCH_BITS 	10
+
+typedef struct rubix_cube_monkeys_summary {
+	unsigned long long 		moves ;
+	unsigned long long 		walks ;						/* walks made to the end */
+	unsigned long long 		returns[RUBIX_CUBE_MONKEYS_DEPTHS] ;		/* walks first back at solved after t moves */
+	unsigned long long 		late_returns ;					/* the same after RUBIX_CUBE_MONKEYS_DEPTHS or more */
+	unsigned long long 		misplaced[RUBIX_CUBE_MONKEYS_DEPTHS] ;		/* misplaced facelets after t moves, over all walks */
+	double 				states[RUBIX_CUBE_MONKEYS_DEPTHS] ;		/* different states after t moves, estimated */
+	double 				seconds ;
+} RubixCubeMonkeysSummary ;
+
+/* Called from the thread running the job with the totals so far, return nonzero to stop the job */
+typedef int (*RubixCubeMonkeysCallback)(const RubixCubeMonkeysSummary * pSummary, void * context) ;
+
+typedef struct rubix_cube_monkeys_job {
+	RubixCubeSeed 			seed ;
+	size_t 				walkers ;	/* 0 for RUBIX_CUBE_MONKEYS_WALKERS */
+	size_t 				length ;	/* moves per walk, 0 for RUBIX_CUBE_MONKEYS_LENGTH */
+	size_t 				walks ;		/* per walker, 0 to go on until @callback stops the job */
+	size_t 				threads ;	/* 0 for one per online cpu */
+	double 				interval ;	/* seconds between calls to @callback */
+	RubixCubeMonkeysCallback 	callback ;	/* optional if @walks is not 0 */
+	void * 				context ;	/* passed to @callback */
+} RubixCubeMonkeysJob ;
+
+/* Run @pJob until it is done or stopped, and fill @pSummary if it is not NULL */
+/* Return nonzero on success, 0 if the job is invalid or the threads could not be started */
+int rubix_cube_monkeys_run(const RubixCubeMonkeysJob * pJob, RubixCubeMonkeysSummary * pSummary) ;
+
+/* Return the average number of misplaced facelets after @depth moves, 0 for a @depth past the summary */
+double rubix_cube_monkeys_misplaced(const RubixCubeMonkeysSummary * pSummary, size_t depth) ;
+
+#endif // RUBIX_CUBE_MONKEYS_H
@@ -0,0 +1,316 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+#include "rubix_cube_notation.h"
+#include "rubix_cube_stats.h"
+#include "rubix_cube_turn.h"
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+typedef enum rubix_cube_notation_kind {
+	RUBIX_CUBE_NOTATION_KIND_NONE,
+	RUBIX_CUBE_NOTATION_KIND_END,
+	RUBIX_CUBE_NOTATION_KIND_SPACE,
+	RUBIX_CUBE_NOTATION_KIND_FACE,
+	RUBIX_CUBE_NOTATION_KIND_WIDE,
+	RUBIX_CUBE_NOTATION_KIND_SLICE,
+	RUBIX_CUBE_NOTATION_KIND_ROTATION
+} RubixCubeNotationKind ;
+
+/* What a token letter does per clockwise quarter turn, in the frame the cube is held in */
+typedef struct rubix_cube_notation_token {
+	unsigned char 			kind ;
+	unsigned char 			moves ;		/* at most this many face turns */
+	signed char 			face[2] ;	/* square of each face turned, -1 for none */
+	signed char 			turns[2] ;	/* its quarter turns */
+	signed char 			axis ;		/* whole cube rotation about x, y or z, -1 for none */
+	signed char 			axis_turns ;
+} RubixCubeNotationToken ;
+
+enum { RUBIX_CUBE_NOTATION_X, RUBIX_CUBE_NOTATION_Y, RUBIX_CUBE_NOTATION_Z } ;
+
+#define RUBIX_CUBE_NOTATION_FACE(face) \
+	{ RUBIX_CUBE_NOTATION_KIND_FACE, 1, { face, -1 }, { 1, 0 }, -1, 0 }
+#define RUBIX_CUBE_NOTATION_WIDE(face, axis, axis_turns) \
+	{ RUBIX_CUBE_NOTATION_KIND_WIDE, 1, { face, -1 }, { 1, 0 }, axis, axis_turns }
+#define RUBIX_CUBE_NOTATION_SLICE(first, first_turns, second, second_turns, axis, axis_turns) \
+	{ RUBIX_CUBE_NOTATION_KIND_SLICE, 2, { first, second }, { first_turns, second_turns }, axis, axis_turns }
+#define RUBIX_CUBE_NOTATION_ROTATION(axis) \
+	{ RUBIX_CUBE_NOTATION_KIND_ROTATION, 0, { -1, -1 }, { 0, 0 }, axis, 1 }
+
+/* A wide turn is the opposite face and a rotation (r = L x), a slice is both faces and a rotation (M = R L' x') */
+static const RubixCubeNotationToken rubix_cube_notation_tokens[256] = {
+	['\n'] 	= { RUBIX_CUBE_NOTATION_KIND_END, 0, { -1, -1 }, { 0, 0 }, -1, 0 },
+	['\0'] 	= { RUBIX_CUBE_NOTATION_KIND_END, 0, { -1, -1 }, { 0, 0 }, -1, 0 },
+	[' '] 	= { RUBIX_CUBE_NOTATION_KIND_SPACE, 0, { -1, -1 }, { 0, 0 }, -1, 0 },
+	['\t'] 	= { RUBIX_CUBE_NOTATION_KIND_SPACE, 0, { -1, -1 }, { 0, 0 }, -1, 0 },
+	['\r'] 	= { RUBIX_CUBE_NOTATION_KIND_SPACE, 0, { -1, -1 }, { 0, 0 }, -1, 0 },
+	['U'] 	= RUBIX_CUBE_NOTATION_FACE(RUBIX_CUBE_SQUARE_TOP),
+	['F'] 	= RUBIX_CUBE_NOTATION_FACE(RUBIX_CUBE_SQUARE_FRONT),
+	['R'] 	= RUBIX_CUBE_NOTATION_FACE(RUBIX_CUBE_SQUARE_RIGHT),
+	['L'] 	= RUBIX_CUBE_NOTATION_FACE(RUBIX_CUBE_SQUARE_LEFT),
+	['B'] 	= RUBIX_CUBE_NOTATION_FACE(RUBIX_CUBE_SQUARE_BACK),
+	['D'] 	= RUBIX_CUBE_NOTATION_FACE(RUBIX_CUBE_SQUARE_BOTTOM),
+	['u'] 	= RUBIX_CUBE_NOTATION_WIDE(RUBIX_CUBE_SQUARE_BOTTOM, RUBIX_CUBE_NOTATION_Y, 1),
+	['f'] 	= RUBIX_CUBE_NOTATION_WIDE(RUBIX_CUBE_SQUARE_BACK, RUBIX_CUBE_NOTATION_Z, 1),
+	['r'] 	= RUBIX_CUBE_NOTATION_WIDE(RUBIX_CUBE_SQUARE_LEFT, RUBIX_CUBE_NOTATION_X, 1),
+	['l'] 	= RUBIX_CUBE_NOTATION_WIDE(RUBIX_CUBE_SQUARE_RIGHT, RUBIX_CUBE_NOTATION_X, -1),
+	['b'] 	= RUBIX_CUBE_NOTATION_WIDE(RUBIX_CUBE_SQUARE_FRONT, RUBIX_CUBE_NOTATION_Z, -1),
+	['d'] 	= RUBIX_CUBE_NOTATION_WIDE(RUBIX_CUBE_SQUARE_TOP, RUBIX_CUBE_NOTATION_Y, -1),
+	['M'] 	= RUBIX_CUBE_NOTATION_SLICE(RUBIX_CUBE_SQUARE_RIGHT, 1, RUBIX_CUBE_SQUARE_LEFT, -1, RUBIX_CUBE_NOTATION_X, -1),
+	['E'] 	= RUBIX_CUBE_NOTATION_SLICE(RUBIX_CUBE_SQUARE_TOP, 1, RUBIX_CUBE_SQUARE_BOTTOM, -1, RUBIX_CUBE_NOTATION_Y, -1),
+	['S'] 	= RUBIX_CUBE_NOTATION_SLICE(RUBIX_CUBE_SQUARE_FRONT, -1, RUBIX_CUBE_SQUARE_BACK, 1, RUBIX_CUBE_NOTATION_Z, 1),
+	['x'] 	= RUBIX_CUBE_NOTATION_ROTATION(RUBIX_CUBE_NOTATION_X),
+	['y'] 	= RUBIX_CUBE_NOTATION_ROTATION(RUBIX_CUBE_NOTATION_Y),
+	['z'] 	= RUBIX_CUBE_NOTATION_ROTATION(RUBIX_CUBE_NOTATION_Z)
+} ;
+
+/* A clockwise quarter rotation about an axis brings the face at [i + 1] to where [i] was */
+static const unsigned char rubix_cube_notation_axis_cycles[3][4] = {
+	{ RUBIX_CUBE_SQUARE_TOP, RUBIX_CUBE_SQUARE_FRONT, RUBIX_CUBE_SQUARE_BOTTOM, RUBIX_CUBE_SQUARE_BACK },	/* x, as R */
+	{ RUBIX_CUBE_SQUARE_FRONT, RUBIX_CUBE_SQUARE_RIGHT, RUBIX_CUBE_SQUARE_BACK, RUBIX_CUBE_SQUARE_LEFT },	/* y, as U */
+	{ RUBIX_CUBE_SQUARE_TOP, RUBIX_CUBE_SQUARE_LEFT, RUBIX_CUBE_SQUARE_BOTTOM, RUBIX_CUBE_SQUARE_RIGHT }	/* z, as F */
+} ;
+
+/* The letter of every turn code divided by 3, the face letters come first */
+static const char rubix_cube_notation_face_letters[RUBIX_CUBE_TURN_COUNT / RUBIX_CUBE_FACE_ROTATION_COUNT] = {
+	'U', 'F', 'R', 'L', 'B', 'D',
+	'u', 'f', 'r', 'l', 'b', 'd',
+	'M', 'E', 'S',
+	'x', 'y', 'z'
+} ;
+
+/* Quarter turns to rotations, 0 is no move at all */
+static const signed char rubix_cube_notation_rotations[4] = {
+	-1, RUBIX_CUBE_FACE_ROTATION_CLOCKWISE, RUBIX_CUBE_FACE_ROTATION_DOUBLE, RUBIX_CUBE_FACE_ROTATION_COUNTERCLOCKWISE
+} ;
+
+static const char * const rubix_cube_notation_suffixes[RUBIX_CUBE_FACE_ROTATION_COUNT] = { "", "'", "2" } ;
+
+/* Upper bound of the moves in the sequence at the start of @text */
+static size_t rubix_cube_notation_count(const char * text, size_t length) {
+	size_t moves = 0 ;
+
+	for (size_t i = 0; i < length; ++i) {
+		const RubixCubeNotationToken * token = &rubix_cube_notation_tokens[(unsigned char)text[i]] ;
+		if (token->kind == RUBIX_CUBE_NOTATION_KIND_END) break ;
+		moves += token->moves ;
+	}
+	return moves ;
+}
+
+static inline int rubix_cube_notation_fail(RubixCubeNotationStatus * pStatus, size_t offset, const char * error) {
+	pStatus->offset = offset ;
+	pStatus->error = error ;
+	return 0 ;
+}
+
+/* The turn code of @token, the axis of a slice is its number too (M x, E y, S z) */
+static inline unsigned char rubix_cube_notation_turn(const RubixCubeNotationToken * token, RubixCubeFaceRotation rotation) {
+	switch (token->kind) {
+	case RUBIX_CUBE_NOTATION_KIND_WIDE:
+		return (unsigned char)RUBIX_CUBE_TURN_WIDE(RUBIX_CUBE_SIDE_COUNT - 1 - token->face[0],rotation) ;
+	case RUBIX_CUBE_NOTATION_KIND_SLICE:
+		return (unsigned char)RUBIX_CUBE_TURN_SLICE(token->axis,rotation) ;
+	case RUBIX_CUBE_NOTATION_KIND_ROTATION:
+		return (unsigned char)RUBIX_CUBE_TURN_ROTATION(token->axis,rotation) ;
+	default:
+		return (unsigned char)RUBIX_CUBE_TURN_FACE(token->face[0],rotation) ;
+	}
+}
+
+/* Parse into @moves if it is not NULL, else into @codes, never more than @capacity of them */
+static int rubix_cube_notation_parse_core(RubixCubeMove * moves, unsigned char * codes, size_t capacity, size_t * pCount,
+		const char * text, size_t length, unsigned flags, RubixCubeNotationStatus * pStatus) {
+	unsigned char frame[RUBIX_CUBE_SIDE_COUNT] = { 0, 1, 2, 3, 4, 5 } ;
+	size_t count = 0, i = 0 ;
+
+	*pCount = 0 ;
+	while (i < length) {
+		unsigned char c = (unsigned char)text[i] ;
+		const RubixCubeNotationToken * token = &rubix_cube_notation_tokens[c] ;
+		size_t start = i++ ;
+		unsigned quarters = 1 ;
+
+		/* The newline or NUL counts as used up */
+		if (token->kind == RUBIX_CUBE_NOTATION_KIND_END) break ;
+		switch (token->kind) {
+		case RUBIX_CUBE_NOTATION_KIND_SPACE:
+			continue ;
+		case RUBIX_CUBE_NOTATION_KIND_NONE:
+			if (c == '\'' || (c >= '0' && c <= '9')) return rubix_cube_notation_fail(pStatus,start,"no move before ' or turn count") ;
+			return rubix_cube_notation_fail(pStatus,start,"unexpected character") ;
+		case RUBIX_CUBE_NOTATION_KIND_FACE:
+			if (i < length && text[i] == 'w') {
+				token = &rubix_cube_notation_tokens[c | 0x20] ;
+				++i ;
+			}
+			break ;
+		default:
+			break ;
+		}
+		if (token->kind != RUBIX_CUBE_NOTATION_KIND_FACE && !(flags & (RUBIX_CUBE_NOTATION_EXTENDED | RUBIX_CUBE_NOTATION_TURNS))) {
+			return rubix_cube_notation_fail(pStatus,start,"wide, slice and rotation moves need RUBIX_CUBE_NOTATION_EXTENDED") ;
+		}
+
+		if (i < length && text[i] >= '0' && text[i] <= '9') {
+			/* Only the count mod 4 matters, so R10 is R2 */
+			for (quarters = 0; i < length && text[i] >= '0' && text[i] <= '9'; ++i) quarters = (quarters * 10 + (text[i] - '0')) % 4 ;
+		}
+		if (i < length && text[i] == '\'') {
+			quarters = (4 - quarters) % 4 ;
+			++i ;
+		}
+
+		if (flags & RUBIX_CUBE_NOTATION_TURNS) {
+			signed char rotation = rubix_cube_notation_rotations[quarters] ;
+			if (rotation < 0) continue ;
+			if (count == capacity) return rubix_cube_notation_fail(pStatus,start,"too many moves") ;
+			codes[count++] = rubix_cube_notation_turn(token,(RubixCubeFaceRotation)rotation) ;
+			continue ;
+		}
+		for (size_t m = 0; m < token->moves; ++m) {
+			signed char rotation = rubix_cube_notation_rotations[(unsigned)(token->turns[m] * (int)quarters) & 3] ;
+			if (rotation < 0) continue ;
+			if (count == capacity) return rubix_cube_notation_fail(pStatus,start,"too many moves") ;
+			if (moves) {
+				moves[count].side = (RubixCubeSide)frame[(size_t)token->face[m]] ;
+				moves[count].rotation = (RubixCubeFaceRotation)rotation ;
+			} else {
+				codes[count] = (unsigned char)RUBIX_CUBE_MOVE_INDEX(frame[(size_t)token->face[m]],rotation) ;
+			}
+			++count ;
+		}
+		if (token->axis >= 0) {
+			const unsigned char * cycle = rubix_cube_notation_axis_cycles[(size_t)token->axis] ;
+			for (unsigned q = (unsigned)(token->axis_turns * (int)quarters) & 3; q > 0; --q) {
+				unsigned char first = frame[cycle[0]] ;
+				frame[cycle[0]] = frame[cycle[1]] ;
+				frame[cycle[1]] = frame[cycle[2]] ;
+				frame[cycle[2]] = frame[cycle[3]] ;
+				frame[cycle[3]] = first ;
+			}
+		}
+	}
+	*pCount = count ;
+	pStatus->offset = i ;
+	pStatus->error = NULL ;
+	return 1 ;
+}
+
+int rubix_cube_notation_parse_into(RubixCubeScramble * pScramble, const char * text, size_t length, unsigned flags, RubixCubeNotationStatus * pStatus) {
+	RubixCubeNotationStatus status ;
+	size_t bound = rubix_cube_notation_count(text,length) ;
+
+	if (!pStatus) pStatus = &status ;
+	pScramble->size = 0 ;
+	pScramble->seed = 0 ;
+	if (bound > pScramble->capacity) {
+		RubixCubeMove * moves = (RubixCubeMove *)realloc(pScramble->moves,bound * sizeof(RubixCubeMove)) ;
+		if (!moves) return rubix_cube_notation_fail(pStatus,0,"out of memory") ;
+		RUBIX_CUBE_STATS_ADD(allocations,1) ;
+		RUBIX_CUBE_STATS_ADD(allocation_bytes,bound * sizeof(RubixCubeMove)) ;
+		pScramble->moves = moves ;
+		pScramble->capacity = bound ;
+	}
+	return rubix_cube_notation_parse_core(pScramble->moves,NULL,pScramble->capacity,&pScramble->size,text,length,
+			flags & ~RUBIX_CUBE_NOTATION_TURNS,pStatus) ;
+}
+
+RubixCubeScramble * rubix_cube_notation_parse(const char * text, size_t length, unsigned flags, RubixCubeNotationStatus * pStatus) {
+	RubixCubeScramble * pNew ;
+
+	RUBIX_CUBE_STATS_ADD(allocations,1) ;
+	RUBIX_CUBE_STATS_ADD(allocation_bytes,sizeof(RubixCubeScramble)) ;
+	if (!(pNew = (RubixCubeScramble *)calloc(1,sizeof(RubixCubeScramble)))) {
+		if (pStatus) rubix_cube_notation_fail(pStatus,0,"out of memory") ;
+		return NULL ;
+	}
+	if (!rubix_cube_notation_parse_into(pNew,text,length,flags,pStatus)) {
+		rubix_cube_scramble_free(pNew) ; return NULL ;
+	}
+	return pNew ;
+}
+
+size_t rubix_cube_notation_parse_codes(unsigned char * codes, size_t capacity, const char * text, size_t length, unsigned flags, RubixCubeNotationStatus * pStatus) {
+	RubixCubeNotationStatus status ;
+	size_t count ;
+
+	if (!pStatus) pStatus = &status ;
+	return rubix_cube_notation_parse_core(NULL,codes,capacity,&count,text,length,flags,pStatus) ? count : 0 ;
+}
+
+size_t rubix_cube_notation_format_codes(char * dest, size_t size, const unsigned char * codes, size_t count, unsigned flags) {
+	size_t written = 0, limit = flags & RUBIX_CUBE_NOTATION_TURNS ? RUBIX_CUBE_TURN_COUNT : RUBIX_CUBE_MOVE_COUNT ;
+
+	for (size_t i = 0; i < count; ++i) {
+		size_t code = flags & RUBIX_CUBE_NOTATION_INVERSE ? RUBIX_CUBE_MOVE_INDEX_INVERSE(codes[count - 1 - i]) : codes[i] ;
+		const char * suffix ;
+
+		if (code >= limit) return 0 ;
+		suffix = rubix_cube_notation_suffixes[code % RUBIX_CUBE_FACE_ROTATION_COUNT] ;
+		if (written + (i > 0) + 1 + (*suffix != '\0') > size) return 0 ;
+		if (i > 0) dest[written++] = ' ' ;
+		dest[written++] = rubix_cube_notation_face_letters[code / RUBIX_CUBE_FACE_ROTATION_COUNT] ;
+		if (*suffix) dest[written++] = *suffix ;
+	}
+	return written ;
+}
+
+/* Codes go through a small buffer so that nothing is allocated */
+#define RUBIX_CUBE_NOTATION_FORMAT_CHUNK 	256
+
+size_t rubix_cube_notation_format(char * dest, size_t size, const RubixCubeMove * moves, size_t count, unsigned flags) {
+	unsigned char codes[RUBIX_CUBE_NOTATION_FORMAT_CHUNK] ;
+	size_t written = 0 ;
+
+	for (size_t done = 0; done < count; done += RUBIX_CUBE_NOTATION_FORMAT_CHUNK) {
+		size_t chunk = count - done < RUBIX_CUBE_NOTATION_FORMAT_CHUNK ? count - done : RUBIX_CUBE_NOTATION_FORMAT_CHUNK ;
+		/* With INVERSE the chunks are taken from the back and each one is reversed by the formatter */
+		const RubixCubeMove * first = flags & RUBIX_CUBE_NOTATION_INVERSE ? moves + count - done - chunk : moves + done ;
+		size_t bytes ;
+
+		for (size_t i = 0; i < chunk; ++i) {
+			codes[i] = (unsigned char)RUBIX_CUBE_MOVE_INDEX(first[i].side,first[i].rotation) ;
+			if (codes[i] >= RUBIX_CUBE_MOVE_COUNT) return 0 ;
+		}
+		if (done > 0) {
+			if (written == size) return 0 ;
+			dest[written++] = ' ' ;
+		}
+		if (!(bytes = rubix_cube_notation_format_codes(dest + written,size - written,codes,chunk,flags))) return 0 ;
+		written += bytes ;
+	}
+	return written ;
+}
+
+int rubix_cube_rotate_face_strings(RubixCube * pRubix_cube, const char * side, const char * face_rotation) {
+	int face = -1, rotation = -1 ;
+
+	/* A side is a face letter or its name, as rubix_cube_get_side_string() has it */
+	for (size_t i = 0; i < RUBIX_CUBE_SIDE_COUNT; ++i) {
+		if ((side[0] == rubix_cube_notation_face_letters[i] && !side[1]) || !strcasecmp(side,rubix_cube_get_side_string(i + 1))) face = (int)i ;
+	}
+	/* A rotation is a notation suffix or its name, as rubix_cube_get_face_rotation_string() has it */
+	for (size_t i = 0; i < RUBIX_CUBE_FACE_ROTATION_COUNT; ++i) {
+		if (!strcmp(face_rotation,rubix_cube_notation_suffixes[i]) || !strcasecmp(face_rotation,rubix_cube_get_face_rotation_string(i))) rotation = (int)i ;
+	}
+	if (face < 0 || rotation < 0) return 0 ;
+	rubix_cube_rotate_face(pRubix_cube,(RubixCubeSide)face,(RubixCubeFaceRotation)rotation) ;
+	return 1 ;
+}
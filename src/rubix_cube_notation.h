@@ -0,0 +1,93 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+/*
+ * Singmaster notation:
+ *
+ * 	R U R' U2 F'
+ *
+ * A face letter (U D F B R L) is a clockwise quarter turn of that face, a trailing '
+ * turns it the other way and a trailing number turns it that many times, so R2 is a
+ * double turn and R3 is the same as R'. Whitespace between moves is optional, and a
+ * sequence ends at a newline, a NUL or the end of the buffer, whichever comes first,
+ * so a file with one solution per line is parsed one line per call.
+ *
+ * With RUBIX_CUBE_NOTATION_EXTENDED the parser also takes wide turns (r or Rw and
+ * friends), slice turns (M E S) and whole cube rotations (x y z). The cube model
+ * only turns faces and keeps its centers put, so these become the face turns that
+ * do the same to the cube up to a rotation of the whole thing: M is R L', r is L,
+ * and x is nothing at all. The parser keeps track of the rotation so that the face
+ * letters after it still turn the faces they mean. For example "x U" becomes F.
+ *
+ * With RUBIX_CUBE_NOTATION_TURNS the codes are turn codes instead (see rubix_cube_turn.h),
+ * one per token as it is written, so "x U" stays x U and M is one slice turn.
+ *
+ * Parsing is one pass over the input through a table indexed by the byte, plus a
+ * counting pass to size the moves. rubix_cube_notation_parse_into() reuses the room
+ * of a scramble from an earlier call, so it only allocates when a sequence is longer
+ * than every one before it.
+ */
+
+#ifndef RUBIX_CUBE_NOTATION_H
+#define RUBIX_CUBE_NOTATION_H "rubix_cube_notation.h"
+
+#include "rubix_cube.h"
+
+/* Flags for the parser */
+#define RUBIX_CUBE_NOTATION_EXTENDED 	0x1	/* accept wide, slice and rotation tokens */
+
+/* Flags for the codes parser and formatter */
+#define RUBIX_CUBE_NOTATION_TURNS 	0x4	/* the codes are turn codes, implies RUBIX_CUBE_NOTATION_EXTENDED */
+
+/* Flags for the formatter */
+#define RUBIX_CUBE_NOTATION_INVERSE 	0x2	/* write the moves that undo the sequence instead */
+
+/* Bytes needed to format @count moves, each one is at most two characters and a space */
+#define RUBIX_CUBE_NOTATION_FORMAT_SIZE(count) 	((count) * 3)
+
+/* Where a parse stopped and why */
+typedef struct rubix_cube_notation_status {
+	size_t 				offset ;	/* on success, bytes used up including the newline, else where the bad token starts */
+	const char * 			error ;		/* NULL on success, else what went wrong */
+} RubixCubeNotationStatus ;
+
+/* Return a pointer to a freshly allocated scramble of the moves in the first sequence of @text, NULL on failure */
+/* @length bytes of @text are read at most, @pStatus can be NULL */
+RubixCubeScramble * rubix_cube_notation_parse(const char * text, size_t length, unsigned flags, RubixCubeNotationStatus * pStatus) ;
+
+/* Same as rubix_cube_notation_parse(), into @pScramble (which may start out empty and zeroed), return nonzero on success */
+/* @pScramble is left empty on failure, its moves should be freed with rubix_cube_scramble_free() or free() when done */
+int rubix_cube_notation_parse_into(RubixCubeScramble * pScramble, const char * text, size_t length, unsigned flags, RubixCubeNotationStatus * pStatus) ;
+
+/* Write the byte codes (see rubix_cube_packed_scramble.h, or rubix_cube_turn.h with RUBIX_CUBE_NOTATION_TURNS) of the */
+/* first sequence of @text to @codes */
+/* Return the number of codes, 0 with @pStatus->error set on failure or if they would not fit in @capacity */
+size_t rubix_cube_notation_parse_codes(unsigned char * codes, size_t capacity, const char * text, size_t length, unsigned flags, RubixCubeNotationStatus * pStatus) ;
+
+/* Write @count @moves to @dest as in "R U R' U2", return the number of bytes written or 0 if @size is too small */
+/* Nothing is NUL terminated, see RUBIX_CUBE_NOTATION_FORMAT_SIZE() for how much room to leave */
+size_t rubix_cube_notation_format(char * dest, size_t size, const RubixCubeMove * moves, size_t count, unsigned flags) ;
+
+/* Same as rubix_cube_notation_format(), from @count byte @codes, 0 if one of them is not a move (or a turn, with */
+/* RUBIX_CUBE_NOTATION_TURNS) */
+size_t rubix_cube_notation_format_codes(char * dest, size_t size, const unsigned char * codes, size_t count, unsigned flags) ;
+
+/* Same as rubix_cube_rotate_face() but side and rotation are given by strings, "R" or "Right" and "'" or "Counter-Clockwise" */
+/* Return 0 and leave the cube alone if either one is not understood */
+int rubix_cube_rotate_face_strings(RubixCube * pRubix_cube, const char * side, const char * face_rotation) ;
+
+#endif // RUBIX_CUBE_NOTATION_H
@@ -0,0 +1,165 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+#include "rubix_cube_nxn.h"
+#include <assert.h>
+#include <string.h>
+
+/*
+ * Geometry, only used to build the tables:
+ *
+ * A facelet sits on the cubie at (x, y, z), with x from left to right, y from top
+ * to bottom and z from front to back, each in 0 .. n - 1, and faces out along a unit
+ * normal. Centering the cubie coordinates (2c - (n - 1)) makes a quarter turn of a
+ * layer a plain rotation of both vectors about the axis of its side.
+ */
+
+typedef struct rubix_cube_nxn_facelet_place {
+	int 				position[3] ;	/* centered, so in -(n - 1) .. n - 1 by steps of 2 */
+	int 				normal[3] ;
+} RubixCubeNxNFaceletPlace ;
+
+/* Axis and direction of the outward normal of each side, in RubixCubeSquare order */
+static const int rubix_cube_nxn_axes[RUBIX_CUBE_SIDE_COUNT] = { 1, 2, 0, 0, 2, 1 } ;
+static const int rubix_cube_nxn_directions[RUBIX_CUBE_SIDE_COUNT] = { -1, -1, 1, -1, 1, 1 } ;
+
+static RubixCubeNxNFaceletPlace rubix_cube_nxn_place(size_t n, size_t face, size_t row, size_t column) {
+	RubixCubeNxNFaceletPlace place = { { 0, 0, 0 }, { 0, 0, 0 } } ;
+	int last = (int)n - 1, r = (int)row, c = (int)column, x, y, z ;
+
+	/* The same layouts as RUBIX_CUBE_GET_*_FACE() */
+	switch (face) {
+	case RUBIX_CUBE_SQUARE_TOP: 	x = c ; 	y = 0 ; 	z = last - r ; 	break ;
+	case RUBIX_CUBE_SQUARE_FRONT: 	x = c ; 	y = r ; 	z = 0 ; 	break ;
+	case RUBIX_CUBE_SQUARE_RIGHT: 	x = last ; 	y = r ; 	z = c ; 	break ;
+	case RUBIX_CUBE_SQUARE_LEFT: 	x = 0 ; 	y = r ; 	z = last - c ; 	break ;
+	case RUBIX_CUBE_SQUARE_BACK: 	x = last - c ; 	y = r ; 	z = last ; 	break ;
+	default: 			x = c ; 	y = last ; 	z = r ; 	break ;
+	}
+	place.position[0] = 2 * x - last ;
+	place.position[1] = 2 * y - last ;
+	place.position[2] = 2 * z - last ;
+	place.normal[rubix_cube_nxn_axes[face]] = rubix_cube_nxn_directions[face] ;
+	return place ;
+}
+
+static size_t rubix_cube_nxn_find(size_t n, const RubixCubeNxNFaceletPlace * place) {
+	int last = (int)n - 1, x = (place->position[0] + last) / 2, y = (place->position[1] + last) / 2, z = (place->position[2] + last) / 2 ;
+	size_t face = 0 ;
+	int row, column ;
+
+	while (place->normal[rubix_cube_nxn_axes[face]] != rubix_cube_nxn_directions[face]) ++face ;
+	switch (face) {
+	case RUBIX_CUBE_SQUARE_TOP: 	row = last - z ; 	column = x ; 		break ;
+	case RUBIX_CUBE_SQUARE_FRONT: 	row = y ; 		column = x ; 		break ;
+	case RUBIX_CUBE_SQUARE_RIGHT: 	row = y ; 		column = z ; 		break ;
+	case RUBIX_CUBE_SQUARE_LEFT: 	row = y ; 		column = last - z ; 	break ;
+	case RUBIX_CUBE_SQUARE_BACK: 	row = y ; 		column = last - x ; 	break ;
+	default: 			row = z ; 		column = x ; 		break ;
+	}
+	return RUBIX_CUBE_NXN_FACELET_INDEX(n,face,row,column) ;
+}
+
+/* A clockwise turn seen from outside is a quarter turn the negative way about the outward normal */
+static void rubix_cube_nxn_turn(int vector[3], size_t side) {
+	int axis = rubix_cube_nxn_axes[side], a = (axis + 1) % 3, b = (axis + 2) % 3 ;
+	int first = vector[a], second = vector[b] ;
+
+	if (rubix_cube_nxn_directions[side] > 0) {
+		vector[a] = second ;
+		vector[b] = -first ;
+	} else {
+		vector[a] = -second ;
+		vector[b] = first ;
+	}
+}
+
+/* Where a clockwise turn of the layer of @side at @coordinate takes facelet @i, @i itself if it is not on that layer */
+static size_t rubix_cube_nxn_destination(size_t n, size_t side, int coordinate, size_t i) {
+	RubixCubeNxNFaceletPlace place = rubix_cube_nxn_place(n,i / (n * n),(i / n) % n,i % n) ;
+
+	if (place.position[rubix_cube_nxn_axes[side]] != coordinate) return i ;
+	rubix_cube_nxn_turn(place.position,side) ;
+	rubix_cube_nxn_turn(place.normal,side) ;
+	return rubix_cube_nxn_find(n,&place) ;
+}
+
+int rubix_cube_nxn_build_cycles(size_t n, unsigned short (*cycles)[4]) {
+	size_t count = RUBIX_CUBE_NXN_FACELET_COUNT(n), per_layer = RUBIX_CUBE_NXN_CYCLES_PER_LAYER(n) ;
+
+	if (n > RUBIX_CUBE_NXN_MAX_SIZE) return 0 ;
+	for (size_t side = 0; side < RUBIX_CUBE_SIDE_COUNT; ++side) {
+		int axis = rubix_cube_nxn_axes[side] ;
+		for (size_t layer = 0; layer < n; ++layer) {
+			/* Layer 0 is the one furthest out along the normal of @side */
+			int coordinate = rubix_cube_nxn_directions[side] * ((int)n - 1 - 2 * (int)layer) ;
+			unsigned short (*out)[4] = cycles + (side * n + layer) * per_layer ;
+			size_t found = 0 ;
+
+			/* The ring around the layer first, then the face if this layer has one */
+			/* Each cycle is written from its lowest facelet, so nothing is kept per facelet */
+			for (int pass = 0; pass < 2; ++pass) {
+				for (size_t i = 0; i < count; ++i) {
+					int on_face = rubix_cube_nxn_axes[i / (n * n)] == axis ;
+					size_t cycle[4] = { i } ;
+
+					if (on_face != pass) continue ;
+					for (size_t k = 1; k < 4; ++k) cycle[k] = rubix_cube_nxn_destination(n,side,coordinate,cycle[k - 1]) ;
+					if (cycle[1] <= i || cycle[2] < i || cycle[3] < i) continue ;
+					for (size_t k = 0; k < 4; ++k) out[found][k] = (unsigned short)cycle[k] ;
+					assert(rubix_cube_nxn_destination(n,side,coordinate,cycle[3]) == i) ;
+					++found ;
+				}
+			}
+			assert(found == (layer == 0 || layer == n - 1 ? per_layer : n)) ;
+		}
+	}
+	return 1 ;
+}
+
+static void rubix_cube_nxn_multiply(int vector[3], const int matrix[3][3]) {
+	int product[3] ;
+
+	for (size_t i = 0; i < 3; ++i) product[i] = matrix[i][0] * vector[0] + matrix[i][1] * vector[1] + matrix[i][2] * vector[2] ;
+	memcpy(vector,product,sizeof(product)) ;
+}
+
+void rubix_cube_nxn_build_transform(size_t n, const int matrix[3][3], unsigned short * destination, unsigned char * sides) {
+	for (size_t i = 0; i < RUBIX_CUBE_NXN_FACELET_COUNT(n); ++i) {
+		RubixCubeNxNFaceletPlace place = rubix_cube_nxn_place(n,i / (n * n),(i / n) % n,i % n) ;
+		rubix_cube_nxn_multiply(place.position,matrix) ;
+		rubix_cube_nxn_multiply(place.normal,matrix) ;
+		destination[i] = (unsigned short)rubix_cube_nxn_find(n,&place) ;
+	}
+	for (size_t side = 0; side < RUBIX_CUBE_SIDE_COUNT; ++side) {
+		/* Every facelet of a face ends up on the side the face does */
+		sides[side] = (unsigned char)(destination[RUBIX_CUBE_NXN_FACELET_INDEX(n,side,0,0)] / (n * n)) ;
+	}
+}
+
+#define RUBIX_CUBE_NXN_N 2
+#include "rubix_cube_nxn_template.h"
+#define RUBIX_CUBE_NXN_N 3
+#include "rubix_cube_nxn_template.h"
+#define RUBIX_CUBE_NXN_N 4
+#include "rubix_cube_nxn_template.h"
+#define RUBIX_CUBE_NXN_N 5
+#include "rubix_cube_nxn_template.h"
+#define RUBIX_CUBE_NXN_N 6
+#include "rubix_cube_nxn_template.h"
+#define RUBIX_CUBE_NXN_N 7
+#include "rubix_cube_nxn_template.h"
@@ -0,0 +1,103 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+/*
+ * NxNxN cubes:
+ *
+ * The plane model above is written for 3x3x3 only. Cubes of other sizes are kept as
+ * facelets, one byte per visible square holding its RubixCubeColor, face after face
+ * in RubixCubeSquare order and row by row within a face:
+ *
+ * facelet index = (face * N + row) * N + column
+ *
+ * The faces are laid out as RUBIX_CUBE_GET_*_FACE() lays them out for 3x3x3, so
+ * RubixCube3x3 holds the same 54 bytes as RubixCubeFacelets. A cube of size N takes
+ * 6 N^2 bytes where the plane model would take 6 N^3 colors, most of them null, which
+ * matters on big cubes: 294 bytes instead of 8 KiB for a 7x7x7.
+ *
+ * Every layer can turn. Layer 0 of a side is its face, layer N - 1 is the opposite
+ * face, and the ones in between are inner slices, so a wide turn is a run of layers
+ * from 0. A quarter turn of a layer moves its facelets in cycles of four. The cycles
+ * of each size are worked out once from the geometry of the cube on first use.
+ *
+ * Each size has its own copy of the code, from rubix_cube_nxn_template.h, so every
+ * loop in it runs a number of times known at compile time and is unrolled for that
+ * size. Sizes 2 to 7 are built into the library. For another size, declare it with
+ * RUBIX_CUBE_NXN_DECLARE() and define it in one source file:
+ *
+ * 	#define RUBIX_CUBE_NXN_N 9
+ * 	#include "rubix_cube_nxn_template.h"
+ */
+
+#ifndef RUBIX_CUBE_NXN_H
+#define RUBIX_CUBE_NXN_H "rubix_cube_nxn.h"
+
+#include "rubix_cube.h"
+
+#define RUBIX_CUBE_NXN_FACELET_COUNT(n) 		(RUBIX_CUBE_SIDE_COUNT * (n) * (n))
+#define RUBIX_CUBE_NXN_FACELET_INDEX(n, face, row, column) 	(((size_t)(face) * (n) + (row)) * (n) + (column))
+
+/* Cycles of four a quarter turn of a face layer moves its facelets in, an inner layer has only the first @n */
+#define RUBIX_CUBE_NXN_CYCLES_PER_LAYER(n) 	((n) + (n) * (n) / 4)
+
+/* Sizes up to this one keep facelet indices in 16 bits */
+#define RUBIX_CUBE_NXN_MAX_SIZE 		104
+
+typedef struct rubix_cube_nxn_move {
+	RubixCubeSide 			side ;
+	unsigned 			layer ;		/* 0 is the face of @side */
+	RubixCubeFaceRotation 		rotation ;
+} RubixCubeNxNMove ;
+
+/* Write the cycles of every layer turned clockwise, [side][layer][RUBIX_CUBE_NXN_CYCLES_PER_LAYER(@n)], for a cube of size @n */
+/* Facelet cycle[0] goes to cycle[1], cycle[1] to cycle[2] and so on. Used by rubix_cube_nxn_template.h */
+/* Return 0 and write nothing if @n is over RUBIX_CUBE_NXN_MAX_SIZE */
+int rubix_cube_nxn_build_cycles(size_t n, unsigned short (*cycles)[4]) ;
+
+/* Write where each facelet of a cube of size @n goes, @destination[facelet], and each side goes, @sides[side], when */
+/* the whole cube is moved by @matrix, a signed permutation matrix in the (x, y, z) coordinates of rubix_cube_nxn.c */
+void rubix_cube_nxn_build_transform(size_t n, const int matrix[3][3], unsigned short * destination, unsigned char * sides) ;
+
+#define RUBIX_CUBE_NXN_DECLARE(n) \
+	typedef struct rubix_cube_nxn_##n { \
+		unsigned char facelets[RUBIX_CUBE_NXN_FACELET_COUNT(n)] ; \
+	} RubixCube##n##x##n ; \
+	\
+	/* Get a copy of the solved cube */ \
+	RubixCube##n##x##n rubix_cube_##n##x##n##_generate_solved(void) ; \
+	\
+	/* Turn @layer of @side, nothing happens if either one is out of range */ \
+	void rubix_cube_##n##x##n##_rotate_layer(RubixCube##n##x##n * pCube, RubixCubeSide side, unsigned layer, RubixCubeFaceRotation rotation) ; \
+	\
+	/* Turn layers 0 to @layers - 1 of @side together */ \
+	void rubix_cube_##n##x##n##_rotate_wide(RubixCube##n##x##n * pCube, RubixCubeSide side, unsigned layers, RubixCubeFaceRotation rotation) ; \
+	\
+	/* Apply / unapply @count @moves in order */ \
+	void rubix_cube_##n##x##n##_apply_moves(RubixCube##n##x##n * pCube, const RubixCubeNxNMove * moves, size_t count) ; \
+	void rubix_cube_##n##x##n##_unapply_moves(RubixCube##n##x##n * pCube, const RubixCubeNxNMove * moves, size_t count) ; \
+	\
+	/* Return 0 if the cube is not solved, else return nonzero value */ \
+	int rubix_cube_##n##x##n##_is_solved(const RubixCube##n##x##n * pCube) ;
+
+RUBIX_CUBE_NXN_DECLARE(2)
+RUBIX_CUBE_NXN_DECLARE(3)
+RUBIX_CUBE_NXN_DECLARE(4)
+RUBIX_CUBE_NXN_DECLARE(5)
+RUBIX_CUBE_NXN_DECLARE(6)
+RUBIX_CUBE_NXN_DECLARE(7)
+
+#endif // RUBIX_CUBE_NXN_H
@@ -0,0 +1,150 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+/*
+ * The code for one size of NxNxN cube, see rubix_cube_nxn.h
+ *
+ * Define RUBIX_CUBE_NXN_N and include this file to get the functions that
+ * RUBIX_CUBE_NXN_DECLARE(RUBIX_CUBE_NXN_N) declares. It has no include guard on
+ * purpose, it is meant to be included once per size.
+ */
+
+#include "rubix_cube_nxn.h"
+#include <pthread.h>
+#include <string.h>
+
+#ifndef RUBIX_CUBE_NXN_N
+#error "define RUBIX_CUBE_NXN_N to the size of the cube before including rubix_cube_nxn_template.h"
+#endif
+
+#if RUBIX_CUBE_NXN_N < 2 || RUBIX_CUBE_NXN_N > RUBIX_CUBE_NXN_MAX_SIZE
+#error "RUBIX_CUBE_NXN_N is out of range"
+#endif
+
+/* Two steps so that RUBIX_CUBE_NXN_N is expanded before it is pasted */
+#define RUBIX_CUBE_NXN_PASTE_(n, name) 		rubix_cube_##n##x##n##_##name
+#define RUBIX_CUBE_NXN_PASTE(n, name) 		RUBIX_CUBE_NXN_PASTE_(n, name)
+#define RUBIX_CUBE_NXN_TYPE_(n) 		RubixCube##n##x##n
+#define RUBIX_CUBE_NXN_TYPE(n) 			RUBIX_CUBE_NXN_TYPE_(n)
+
+#define RUBIX_CUBE_NXN_F(name) 			RUBIX_CUBE_NXN_PASTE(RUBIX_CUBE_NXN_N, name)
+#define RUBIX_CUBE_NXN_CUBE 			RUBIX_CUBE_NXN_TYPE(RUBIX_CUBE_NXN_N)
+#define RUBIX_CUBE_NXN_CYCLES 			RUBIX_CUBE_NXN_CYCLES_PER_LAYER(RUBIX_CUBE_NXN_N)
+
+static unsigned short RUBIX_CUBE_NXN_F(cycles)[RUBIX_CUBE_SIDE_COUNT][RUBIX_CUBE_NXN_N][RUBIX_CUBE_NXN_CYCLES][4] ;
+static RUBIX_CUBE_NXN_CUBE RUBIX_CUBE_NXN_F(solved) ;
+static pthread_once_t RUBIX_CUBE_NXN_F(tables_once) = PTHREAD_ONCE_INIT ;
+static int RUBIX_CUBE_NXN_F(tables_ready) ;
+
+static void RUBIX_CUBE_NXN_F(build_tables)(void) {
+	rubix_cube_nxn_build_cycles(RUBIX_CUBE_NXN_N,&RUBIX_CUBE_NXN_F(cycles)[0][0][0]) ;
+	for (size_t i = 0; i < RUBIX_CUBE_NXN_FACELET_COUNT(RUBIX_CUBE_NXN_N); ++i) {
+		RUBIX_CUBE_NXN_F(solved).facelets[i] = (unsigned char)(i / (RUBIX_CUBE_NXN_N * RUBIX_CUBE_NXN_N) + RUBIX_CUBE_COLOR_WHITE) ;
+	}
+	__atomic_store_n(&RUBIX_CUBE_NXN_F(tables_ready),1,__ATOMIC_RELEASE) ;
+}
+
+static inline void RUBIX_CUBE_NXN_F(init_tables)(void) {
+	if (__builtin_expect(!__atomic_load_n(&RUBIX_CUBE_NXN_F(tables_ready),__ATOMIC_ACQUIRE),0)) {
+		pthread_once(&RUBIX_CUBE_NXN_F(tables_once),RUBIX_CUBE_NXN_F(build_tables)) ;
+	}
+}
+
+RUBIX_CUBE_NXN_CUBE RUBIX_CUBE_NXN_F(generate_solved)(void) {
+	RUBIX_CUBE_NXN_F(init_tables)() ;
+	return RUBIX_CUBE_NXN_F(solved) ;
+}
+
+/* Move the facelets of @count cycles, @count is one of two constants so the loop unrolls */
+static inline __attribute__((always_inline))
+void RUBIX_CUBE_NXN_F(cycle)(unsigned char * f, const unsigned short (*cycles)[4], size_t count, RubixCubeFaceRotation rotation) {
+	switch (rotation) {
+	case RUBIX_CUBE_FACE_ROTATION_CLOCKWISE:
+		for (size_t i = 0; i < count; ++i) {
+			unsigned char last = f[cycles[i][3]] ;
+			f[cycles[i][3]] = f[cycles[i][2]] ;
+			f[cycles[i][2]] = f[cycles[i][1]] ;
+			f[cycles[i][1]] = f[cycles[i][0]] ;
+			f[cycles[i][0]] = last ;
+		}
+		break ;
+	case RUBIX_CUBE_FACE_ROTATION_COUNTERCLOCKWISE:
+		for (size_t i = 0; i < count; ++i) {
+			unsigned char first = f[cycles[i][0]] ;
+			f[cycles[i][0]] = f[cycles[i][1]] ;
+			f[cycles[i][1]] = f[cycles[i][2]] ;
+			f[cycles[i][2]] = f[cycles[i][3]] ;
+			f[cycles[i][3]] = first ;
+		}
+		break ;
+	case RUBIX_CUBE_FACE_ROTATION_DOUBLE:
+		for (size_t i = 0; i < count; ++i) {
+			unsigned char first = f[cycles[i][0]], second = f[cycles[i][1]] ;
+			f[cycles[i][0]] = f[cycles[i][2]] ;
+			f[cycles[i][1]] = f[cycles[i][3]] ;
+			f[cycles[i][2]] = first ;
+			f[cycles[i][3]] = second ;
+		}
+		break ;
+	default:
+		break ;
+	}
+}
+
+void RUBIX_CUBE_NXN_F(rotate_layer)(RUBIX_CUBE_NXN_CUBE * pCube, RubixCubeSide side, unsigned layer, RubixCubeFaceRotation rotation) {
+	if ((size_t)side >= RUBIX_CUBE_SIDE_COUNT || layer >= RUBIX_CUBE_NXN_N) return ;
+	RUBIX_CUBE_NXN_F(init_tables)() ;
+
+	const unsigned short (*cycles)[4] = (const unsigned short (*)[4])RUBIX_CUBE_NXN_F(cycles)[side][layer] ;
+	if (layer == 0 || layer == RUBIX_CUBE_NXN_N - 1) {
+		RUBIX_CUBE_NXN_F(cycle)(pCube->facelets,cycles,RUBIX_CUBE_NXN_CYCLES,rotation) ;
+	} else {
+		RUBIX_CUBE_NXN_F(cycle)(pCube->facelets,cycles,RUBIX_CUBE_NXN_N,rotation) ;
+	}
+}
+
+void RUBIX_CUBE_NXN_F(rotate_wide)(RUBIX_CUBE_NXN_CUBE * pCube, RubixCubeSide side, unsigned layers, RubixCubeFaceRotation rotation) {
+	if (layers > RUBIX_CUBE_NXN_N) layers = RUBIX_CUBE_NXN_N ;
+	for (unsigned layer = 0; layer < layers; ++layer) RUBIX_CUBE_NXN_F(rotate_layer)(pCube,side,layer,rotation) ;
+}
+
+void RUBIX_CUBE_NXN_F(apply_moves)(RUBIX_CUBE_NXN_CUBE * pCube, const RubixCubeNxNMove * moves, size_t count) {
+	for (size_t i = 0; i < count; ++i) RUBIX_CUBE_NXN_F(rotate_layer)(pCube,moves[i].side,moves[i].layer,moves[i].rotation) ;
+}
+
+void RUBIX_CUBE_NXN_F(unapply_moves)(RUBIX_CUBE_NXN_CUBE * pCube, const RubixCubeNxNMove * moves, size_t count) {
+	for (size_t i = count; i > 0; --i) {
+		RubixCubeFaceRotation rotation = moves[i - 1].rotation ;
+		if (rotation == RUBIX_CUBE_FACE_ROTATION_CLOCKWISE) rotation = RUBIX_CUBE_FACE_ROTATION_COUNTERCLOCKWISE ;
+		else if (rotation == RUBIX_CUBE_FACE_ROTATION_COUNTERCLOCKWISE) rotation = RUBIX_CUBE_FACE_ROTATION_CLOCKWISE ;
+		RUBIX_CUBE_NXN_F(rotate_layer)(pCube,moves[i - 1].side,moves[i - 1].layer,rotation) ;
+	}
+}
+
+int RUBIX_CUBE_NXN_F(is_solved)(const RUBIX_CUBE_NXN_CUBE * pCube) {
+	RUBIX_CUBE_NXN_F(init_tables)() ;
+	return !memcmp(pCube,&RUBIX_CUBE_NXN_F(solved),sizeof(RUBIX_CUBE_NXN_CUBE)) ;
+}
+
+#undef RUBIX_CUBE_NXN_PASTE_
+#undef RUBIX_CUBE_NXN_PASTE
+#undef RUBIX_CUBE_NXN_TYPE_
+#undef RUBIX_CUBE_NXN_TYPE
+#undef RUBIX_CUBE_NXN_F
+#undef RUBIX_CUBE_NXN_CUBE
+#undef RUBIX_CUBE_NXN_CYCLES
+#undef RUBIX_CUBE_NXN_N
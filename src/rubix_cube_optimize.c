@@ -0,0 +1,171 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+#include "rubix_cube_optimize.h"
+#include "rubix_cube_packed_scramble.h"
+#include "rubix_cube_stats.h"
+#include <stdlib.h>
+
+#define RUBIX_CUBE_OPTIMIZE_SIDE(code) 		((size_t)(code) / RUBIX_CUBE_FACE_ROTATION_COUNT)
+#define RUBIX_CUBE_OPTIMIZE_AXIS(side) 		((side) < RUBIX_CUBE_SQUARE_OPPOSITE(side) ? (side) : RUBIX_CUBE_SQUARE_OPPOSITE(side))
+#define RUBIX_CUBE_OPTIMIZE_DOUBLE(code) 	((code) % RUBIX_CUBE_FACE_ROTATION_COUNT == RUBIX_CUBE_FACE_ROTATION_DOUBLE)
+
+/* Moves that fit on the stack of rubix_cube_scramble_optimize() before it has to allocate */
+#define RUBIX_CUBE_OPTIMIZE_LOCAL 	256
+
+/* Quarter turns of each rotation and back, 0 is no move at all */
+static const unsigned char rubix_cube_optimize_quarters[RUBIX_CUBE_FACE_ROTATION_COUNT] = { 1, 3, 2 } ;
+static const unsigned char rubix_cube_optimize_rotations[4] = {
+	0, RUBIX_CUBE_FACE_ROTATION_CLOCKWISE, RUBIX_CUBE_FACE_ROTATION_DOUBLE, RUBIX_CUBE_FACE_ROTATION_COUNTERCLOCKWISE
+} ;
+
+static inline unsigned rubix_cube_optimize_quarters_of(unsigned char code) {
+	return rubix_cube_optimize_quarters[code % RUBIX_CUBE_FACE_ROTATION_COUNT] ;
+}
+
+static inline unsigned char rubix_cube_optimize_code(size_t side, unsigned quarters) {
+	return (unsigned char)RUBIX_CUBE_MOVE_INDEX(side,rubix_cube_optimize_rotations[quarters & 3]) ;
+}
+
+/* Where the run of moves about one axis that ends at @end starts, the stack never has more than two in a row */
+static inline size_t rubix_cube_optimize_block(const unsigned char * stack, size_t end) {
+	size_t side = RUBIX_CUBE_OPTIMIZE_SIDE(stack[end - 1]) ;
+	return end > 1 && RUBIX_CUBE_OPTIMIZE_SIDE(stack[end - 2]) == RUBIX_CUBE_SQUARE_OPPOSITE(side) ? end - 2 : end - 1 ;
+}
+
+/* Both faces of an axis turned by half commutes with the same on any other axis */
+static inline int rubix_cube_optimize_square(const unsigned char * stack, size_t start, size_t end) {
+	return end - start == 2 && RUBIX_CUBE_OPTIMIZE_DOUBLE(stack[start]) && RUBIX_CUBE_OPTIMIZE_DOUBLE(stack[start + 1]) ;
+}
+
+/* Add the quarter turns of the block @start to @end to @quarters, by face of its axis */
+static inline void rubix_cube_optimize_count(unsigned quarters[2], const unsigned char * stack, size_t start, size_t end) {
+	for (size_t i = start; i < end; ++i) {
+		size_t side = RUBIX_CUBE_OPTIMIZE_SIDE(stack[i]) ;
+		quarters[side != RUBIX_CUBE_OPTIMIZE_AXIS(side)] += rubix_cube_optimize_quarters_of(stack[i]) ;
+	}
+}
+
+static inline size_t rubix_cube_optimize_moves(const unsigned quarters[2]) {
+	return ((quarters[0] & 3) != 0) + ((quarters[1] & 3) != 0) ;
+}
+
+/* Write the block with @quarters on @axis to @dest, return the moves written */
+static inline size_t rubix_cube_optimize_emit(unsigned char * dest, size_t axis, const unsigned quarters[2]) {
+	size_t count = 0 ;
+
+	if (quarters[0] & 3) dest[count++] = rubix_cube_optimize_code(axis,quarters[0]) ;
+	if (quarters[1] & 3) dest[count++] = rubix_cube_optimize_code(RUBIX_CUBE_SQUARE_OPPOSITE(axis),quarters[1]) ;
+	return count ;
+}
+
+static void rubix_cube_optimize_push(unsigned char * stack, size_t * pSize, unsigned char code) ;
+
+/* If the block on top and one on the same axis have only half turns of both faces of other axes between them, */
+/* a half turn of both faces of their axis can go from one to the other past those, say U D2 F2 B2 U2 is U' F2 B2 D2 */
+static void rubix_cube_optimize_squares(unsigned char * stack, size_t * pSize) {
+	size_t size = *pSize, top = rubix_cube_optimize_block(stack,size), end = top, start = 0 ;
+	size_t axis = RUBIX_CUBE_OPTIMIZE_AXIS(RUBIX_CUBE_OPTIMIZE_SIDE(stack[size - 1])) ;
+	unsigned first[2] = { 0 }, last[2] = { 0 } ;
+	unsigned char suffix[8] ;
+	size_t count = 0, moves ;
+	int found = 0 ;
+
+	/* Two such blocks in a row at most, a third one would have merged with the first */
+	for (size_t blocks = 0; blocks < 3 && end > 0; ++blocks) {
+		start = rubix_cube_optimize_block(stack,end) ;
+		if (RUBIX_CUBE_OPTIMIZE_AXIS(RUBIX_CUBE_OPTIMIZE_SIDE(stack[start])) == axis) {
+			found = blocks > 0 ;
+			break ;
+		}
+		if (!rubix_cube_optimize_square(stack,start,end)) return ;
+		end = start ;
+	}
+	if (!found) return ;
+
+	rubix_cube_optimize_count(first,stack,start,end) ;
+	rubix_cube_optimize_count(last,stack,top,size) ;
+	moves = rubix_cube_optimize_moves(first) + rubix_cube_optimize_moves(last) ;
+	first[0] += 2 ; first[1] += 2 ;
+	last[0] += 2 ; last[1] += 2 ;
+	if (rubix_cube_optimize_moves(first) + rubix_cube_optimize_moves(last) >= moves) return ;
+
+	count += rubix_cube_optimize_emit(suffix + count,axis,first) ;
+	for (size_t i = end; i < top; ++i) suffix[count++] = stack[i] ;
+	count += rubix_cube_optimize_emit(suffix + count,axis,last) ;
+	*pSize = start ;
+	for (size_t i = 0; i < count; ++i) rubix_cube_optimize_push(stack,pSize,suffix[i]) ;
+}
+
+static void rubix_cube_optimize_push(unsigned char * stack, size_t * pSize, unsigned char code) {
+	size_t size = *pSize, side = RUBIX_CUBE_OPTIMIZE_SIDE(code) ;
+
+	if (size > 0) {
+		unsigned char last = stack[size - 1] ;
+		size_t last_side = RUBIX_CUBE_OPTIMIZE_SIDE(last) ;
+
+		if (last_side == side) {
+			unsigned quarters = rubix_cube_optimize_quarters_of(last) + rubix_cube_optimize_quarters_of(code) ;
+			*pSize = size - 1 ;
+			if (quarters & 3) rubix_cube_optimize_push(stack,pSize,rubix_cube_optimize_code(side,quarters)) ;
+			return ;
+		}
+		/* The opposite face commutes with this one, so it goes after it if it is out of order or in the way of a merge */
+		if (last_side == RUBIX_CUBE_SQUARE_OPPOSITE(side) && (side < last_side || (size > 1 && RUBIX_CUBE_OPTIMIZE_SIDE(stack[size - 2]) == side))) {
+			*pSize = size - 1 ;
+			rubix_cube_optimize_push(stack,pSize,code) ;
+			rubix_cube_optimize_push(stack,pSize,last) ;
+			return ;
+		}
+	}
+	stack[(*pSize)++] = code ;
+	rubix_cube_optimize_squares(stack,pSize) ;
+}
+
+int rubix_cube_optimize_codes(unsigned char * codes, size_t * pCount) {
+	size_t size = 0 ;
+
+	for (size_t i = 0; i < *pCount; ++i) {
+		if (codes[i] >= RUBIX_CUBE_MOVE_COUNT) return 0 ;
+	}
+	/* The stack never holds more moves than were read, so it can live in the codes */
+	for (size_t i = 0; i < *pCount; ++i) rubix_cube_optimize_push(codes,&size,codes[i]) ;
+	*pCount = size ;
+	return 1 ;
+}
+
+size_t rubix_cube_scramble_optimize(RubixCubeScramble * pScramble) {
+	unsigned char local[RUBIX_CUBE_OPTIMIZE_LOCAL], * codes = local ;
+	size_t count = pScramble->size, removed ;
+
+	for (size_t i = 0; i < count; ++i) {
+		const RubixCubeMove * move = &pScramble->moves[i] ;
+		if ((size_t)move->side >= RUBIX_CUBE_SIDE_COUNT || (size_t)move->rotation >= RUBIX_CUBE_FACE_ROTATION_COUNT) return 0 ;
+	}
+	if (count > RUBIX_CUBE_OPTIMIZE_LOCAL) {
+		if (!(codes = (unsigned char *)malloc(count))) return 0 ;
+		RUBIX_CUBE_STATS_ADD(allocations,1) ;
+		RUBIX_CUBE_STATS_ADD(allocation_bytes,count) ;
+	}
+	rubix_cube_moves_encode(codes,pScramble->moves,count) ;
+	rubix_cube_optimize_codes(codes,&count) ;
+	rubix_cube_moves_decode(pScramble->moves,codes,count) ;
+	removed = pScramble->size - count ;
+	pScramble->size = count ;
+	if (codes != local) free(codes) ;
+	return removed ;
+}
@@ -0,0 +1,50 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+/*
+ * Move sequence optimizer:
+ *
+ * Random scrambles and solutions joined from several searches often say things the
+ * long way. rubix_cube_optimize_codes() rewrites a sequence as a shorter one that does
+ * the same to the cube, in a single pass with the output as a stack:
+ *
+ * 	- turns of the same face in a row merge, U U' is nothing and U U is U2
+ * 	- opposite faces commute, so U D U' is D, and such a pair is put in the order
+ * 	  the solvers use, the lower RUBIX_CUBE_SQUARE_* first (U D, not D U)
+ * 	- both faces of an axis turned by half, such as F2 B2, commute with both faces
+ * 	  of another axis turned by half, so U F2 B2 U2 D2 is U' D2 F2 B2
+ *
+ * The last one is the only relation shorter than 6 moves that the first two miss:
+ * of the 577368 sequences of 5 moves with neither a face twice in a row nor opposite
+ * faces out of order, the 168 that have a shorter equivalent all come from it. So
+ * every 5 moves of the result are as short as they can be, although longer runs of
+ * the result may not be.
+ */
+
+#ifndef RUBIX_CUBE_OPTIMIZE_H
+#define RUBIX_CUBE_OPTIMIZE_H "rubix_cube_optimize.h"
+
+#include "rubix_cube.h"
+
+/* Rewrite the *@pCount move codes (see rubix_cube_packed_scramble.h) at @codes in place, *@pCount is set to how many */
+/* are left. Return 0 and leave both alone if any of them is not a move */
+int rubix_cube_optimize_codes(unsigned char * codes, size_t * pCount) ;
+
+/* Same as rubix_cube_optimize_codes(), on the moves of @pScramble, return the number of moves taken out */
+size_t rubix_cube_scramble_optimize(RubixCubeScramble * pScramble) ;
+
+#endif // RUBIX_CUBE_OPTIMIZE_H
@@ -0,0 +1,282 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+#include "rubix_cube_packed_scramble.h"
+#include "rubix_cube_stats.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RUBIX_CUBE_PACKED_MOVE_MASK 		((1u << RUBIX_CUBE_MOVE_BITS) - 1)
+
+/* Moves per group, a group is exactly RUBIX_CUBE_MOVE_BITS bytes */
+#define RUBIX_CUBE_PACKED_GROUP 		8
+
+/* Bytes of a record header on disk */
+#define RUBIX_CUBE_PACKED_RECORD_HEADER 	12
+
+unsigned char rubix_cube_move_encode(const RubixCubeMove * move) {
+	return (unsigned char)RUBIX_CUBE_MOVE_INDEX(move->side,move->rotation) ;
+}
+
+int rubix_cube_move_decode(RubixCubeMove * dest, unsigned char code) {
+	if (code >= RUBIX_CUBE_MOVE_COUNT) return 0 ;
+	dest->side = (RubixCubeSide)(code / RUBIX_CUBE_FACE_ROTATION_COUNT) ;
+	dest->rotation = (RubixCubeFaceRotation)(code % RUBIX_CUBE_FACE_ROTATION_COUNT) ;
+	return 1 ;
+}
+
+void rubix_cube_moves_encode(unsigned char * codes, const RubixCubeMove * moves, size_t count) {
+	for (size_t i = 0; i < count; ++i) codes[i] = rubix_cube_move_encode(&moves[i]) ;
+}
+
+int rubix_cube_moves_decode(RubixCubeMove * moves, const unsigned char * codes, size_t count) {
+	int valid = 1 ;
+	for (size_t i = 0; i < count; ++i) valid &= rubix_cube_move_decode(&moves[i],codes[i]) ;
+	return valid ;
+}
+
+int rubix_cube_apply_move_codes(RubixCube * pRubix_cube, const unsigned char * codes, size_t count) {
+	for (size_t i = 0; i < count; ++i) if (codes[i] >= RUBIX_CUBE_MOVE_COUNT) return 0 ;
+	for (size_t i = 0; i < count; ++i) {
+		rubix_cube_rotate_face(pRubix_cube,(RubixCubeSide)(codes[i] / RUBIX_CUBE_FACE_ROTATION_COUNT),(RubixCubeFaceRotation)(codes[i] % RUBIX_CUBE_FACE_ROTATION_COUNT)) ;
+	}
+	return 1 ;
+}
+
+int rubix_cube_unapply_move_codes(RubixCube * pRubix_cube, const unsigned char * codes, size_t count) {
+	for (size_t i = 0; i < count; ++i) if (codes[i] >= RUBIX_CUBE_MOVE_COUNT) return 0 ;
+	for (size_t i = count; i > 0; --i) {
+		size_t code = RUBIX_CUBE_MOVE_INDEX_INVERSE(codes[i - 1]) ;
+		rubix_cube_rotate_face(pRubix_cube,(RubixCubeSide)(code / RUBIX_CUBE_FACE_ROTATION_COUNT),(RubixCubeFaceRotation)(code % RUBIX_CUBE_FACE_ROTATION_COUNT)) ;
+	}
+	return 1 ;
+}
+
+void rubix_cube_generate_move_codes(unsigned char * codes, RubixCubeSeed * seeds, size_t count, size_t intensity) {
+	for (size_t i = 0; i < count; ++i) {
+		RubixCubeRandom random ;
+
+		if (!seeds[i]) seeds[i] = rubix_cube_generate_seed() ;
+		random = rubix_cube_random_generate(seeds[i]) ;
+		for (size_t j = 0; j < intensity; ++j) {
+			RubixCubeMove move = rubix_cube_generate_random_move_r(&random) ;
+			codes[i * intensity + j] = rubix_cube_move_encode(&move) ;
+		}
+	}
+}
+
+/* Pack up to a group of @count moves into its bits */
+static inline uint64_t rubix_cube_packed_group(const RubixCubeMove * moves, size_t count) {
+	uint64_t group = 0 ;
+	for (size_t j = 0; j < count; ++j) group |= (uint64_t)rubix_cube_move_encode(&moves[j]) << (RUBIX_CUBE_MOVE_BITS * j) ;
+	return group ;
+}
+
+static inline int rubix_cube_unpacked_group(RubixCubeMove * moves, uint64_t group, size_t count) {
+	int valid = 1 ;
+	for (size_t j = 0; j < count; ++j) {
+		valid &= rubix_cube_move_decode(&moves[j],(unsigned char)((group >> (RUBIX_CUBE_MOVE_BITS * j)) & RUBIX_CUBE_PACKED_MOVE_MASK)) ;
+	}
+	return valid ;
+}
+
+void rubix_cube_moves_pack(unsigned char * dest, const RubixCubeMove * moves, size_t count) {
+	size_t i = 0 ;
+
+	for (; i + RUBIX_CUBE_PACKED_GROUP <= count; i += RUBIX_CUBE_PACKED_GROUP, dest += RUBIX_CUBE_MOVE_BITS) {
+		uint64_t group = rubix_cube_packed_group(moves + i,RUBIX_CUBE_PACKED_GROUP) ;
+		for (size_t b = 0; b < RUBIX_CUBE_MOVE_BITS; ++b) dest[b] = (unsigned char)(group >> (8 * b)) ;
+	}
+	if (i < count) {
+		uint64_t group = rubix_cube_packed_group(moves + i,count - i) ;
+		for (size_t b = 0; b < RUBIX_CUBE_PACKED_MOVES_SIZE(count - i); ++b) dest[b] = (unsigned char)(group >> (8 * b)) ;
+	}
+}
+
+int rubix_cube_moves_unpack(RubixCubeMove * moves, const unsigned char * src, size_t count) {
+	size_t i = 0 ;
+	int valid = 1 ;
+
+	for (; i + RUBIX_CUBE_PACKED_GROUP <= count; i += RUBIX_CUBE_PACKED_GROUP, src += RUBIX_CUBE_MOVE_BITS) {
+		uint64_t group = 0 ;
+		for (size_t b = 0; b < RUBIX_CUBE_MOVE_BITS; ++b) group |= (uint64_t)src[b] << (8 * b) ;
+		valid &= rubix_cube_unpacked_group(moves + i,group,RUBIX_CUBE_PACKED_GROUP) ;
+	}
+	if (i < count) {
+		uint64_t group = 0 ;
+		for (size_t b = 0; b < RUBIX_CUBE_PACKED_MOVES_SIZE(count - i); ++b) group |= (uint64_t)src[b] << (8 * b) ;
+		valid &= rubix_cube_unpacked_group(moves + i,group,count - i) ;
+	}
+	return valid ;
+}
+
+/* Allocate an empty packed scramble with room for @capacity moves */
+/* One byte more than the moves need is kept so that any code can be read as two whole bytes */
+static RubixCubePackedScramble * rubix_cube_packed_scramble_allocate_empty(size_t capacity, RubixCubeSeed seed) {
+	RubixCubePackedScramble * pNew ;
+	if (!(pNew = (RubixCubePackedScramble *)malloc(sizeof(RubixCubePackedScramble)))) return NULL ;
+	if (!(pNew->bits = (unsigned char *)calloc(RUBIX_CUBE_PACKED_MOVES_SIZE(capacity) + 1,1))) {
+		free(pNew) ; return NULL ;
+	}
+	pNew->size = 0 ;
+	pNew->capacity = capacity ;
+	pNew->seed = seed ;
+	return pNew ;
+}
+
+static inline unsigned rubix_cube_packed_scramble_code(const RubixCubePackedScramble * pPacked, size_t index) {
+	size_t bit = index * RUBIX_CUBE_MOVE_BITS ;
+	unsigned pair = pPacked->bits[bit >> 3] | (unsigned)pPacked->bits[(bit >> 3) + 1] << 8 ;
+	return (pair >> (bit & 7)) & RUBIX_CUBE_PACKED_MOVE_MASK ;
+}
+
+RubixCubePackedScramble * rubix_cube_packed_scramble_allocate(RubixCubeSeed seed, size_t intensity) {
+	RubixCubePackedScramble * pNew ;
+	RubixCubeRandom random ;
+
+	if (!seed) seed = rubix_cube_generate_seed() ;
+	if (!(pNew = rubix_cube_packed_scramble_allocate_empty(intensity,seed))) return NULL ;
+
+	/* A group at a time, the same moves rubix_cube_scramble_allocate() would make */
+	random = rubix_cube_random_generate(seed) ;
+	for (size_t i = 0; i < intensity; i += RUBIX_CUBE_PACKED_GROUP) {
+		RubixCubeMove moves[RUBIX_CUBE_PACKED_GROUP] ;
+		size_t count = intensity - i < RUBIX_CUBE_PACKED_GROUP ? intensity - i : RUBIX_CUBE_PACKED_GROUP ;
+		rubix_cube_generate_moves_from_random(&random,count,moves) ;
+		rubix_cube_moves_pack(pNew->bits + i / RUBIX_CUBE_PACKED_GROUP * RUBIX_CUBE_MOVE_BITS,moves,count) ;
+	}
+	pNew->size = intensity ;
+	return pNew ;
+}
+
+RubixCubePackedScramble * rubix_cube_packed_scramble_from_scramble(const RubixCubeScramble * pScramble) {
+	RubixCubePackedScramble * pNew ;
+	if (!(pNew = rubix_cube_packed_scramble_allocate_empty(pScramble->size,pScramble->seed))) return NULL ;
+	rubix_cube_moves_pack(pNew->bits,pScramble->moves,pScramble->size) ;
+	pNew->size = pScramble->size ;
+	return pNew ;
+}
+
+RubixCubeScramble * rubix_cube_packed_scramble_to_scramble(const RubixCubePackedScramble * pPacked) {
+	RubixCubeScramble * pNew ;
+	if (!(pNew = (RubixCubeScramble *)malloc(sizeof(RubixCubeScramble)))) return NULL ;
+
+	pNew->capacity = pPacked->size ? pPacked->size : 1 ;
+	if (!(pNew->moves = (RubixCubeMove *)malloc(sizeof(RubixCubeMove) * pNew->capacity))) {
+		free(pNew) ; return NULL ;
+	}
+	pNew->size = pPacked->size ;
+	pNew->seed = pPacked->seed ;
+	if (!rubix_cube_moves_unpack(pNew->moves,pPacked->bits,pPacked->size)) {
+		rubix_cube_scramble_free(pNew) ; return NULL ;
+	}
+	return pNew ;
+}
+
+void rubix_cube_packed_scramble_free(RubixCubePackedScramble * pPacked) {
+	if (pPacked) {
+		free(pPacked->bits) ;
+		free(pPacked) ;
+	}
+}
+
+RubixCubeMove rubix_cube_packed_scramble_get(const RubixCubePackedScramble * pPacked, size_t index) {
+	RubixCubeMove move = { 0 } ;
+	rubix_cube_move_decode(&move,(unsigned char)rubix_cube_packed_scramble_code(pPacked,index)) ;
+	return move ;
+}
+
+int rubix_cube_packed_scramble_append(RubixCubePackedScramble * pPacked, const RubixCubeMove * move) {
+	if (pPacked->size == pPacked->capacity) {
+		size_t capacity = pPacked->capacity ? pPacked->capacity * 2 : RUBIX_CUBE_SCRAMBLE_INTENSITY ;
+		size_t old_size = RUBIX_CUBE_PACKED_MOVES_SIZE(pPacked->capacity) + 1, new_size = RUBIX_CUBE_PACKED_MOVES_SIZE(capacity) + 1 ;
+		unsigned char * bits = (unsigned char *)realloc(pPacked->bits,new_size) ;
+		if (!bits) return 0 ;
+		memset(bits + old_size,0,new_size - old_size) ;
+		pPacked->bits = bits ;
+		pPacked->capacity = capacity ;
+	}
+
+	size_t bit = pPacked->size++ * RUBIX_CUBE_MOVE_BITS ;
+	unsigned pair = (unsigned)rubix_cube_move_encode(move) << (bit & 7) ;
+	pPacked->bits[bit >> 3] |= (unsigned char)pair ;
+	pPacked->bits[(bit >> 3) + 1] |= (unsigned char)(pair >> 8) ;
+	return 1 ;
+}
+
+void rubix_cube_apply_packed_scramble(RubixCube * pRubix_cube, const RubixCubePackedScramble * pPacked) {
+	RUBIX_CUBE_STATS_TIMER_START(start) ;
+	for (size_t i = 0; i < pPacked->size; ++i) {
+		unsigned code = rubix_cube_packed_scramble_code(pPacked,i) ;
+		if (code >= RUBIX_CUBE_MOVE_COUNT) continue ;
+		rubix_cube_rotate_face(pRubix_cube,(RubixCubeSide)(code / RUBIX_CUBE_FACE_ROTATION_COUNT),(RubixCubeFaceRotation)(code % RUBIX_CUBE_FACE_ROTATION_COUNT)) ;
+	}
+	RUBIX_CUBE_STATS_ADD(apply_scramble,1) ;
+	RUBIX_CUBE_STATS_ADD(apply_scramble_moves,pPacked->size) ;
+	RUBIX_CUBE_STATS_TIMER_STOP(start,apply_scramble_cycles) ;
+}
+
+void rubix_cube_unapply_packed_scramble(RubixCube * pRubix_cube, const RubixCubePackedScramble * pPacked) {
+	RUBIX_CUBE_STATS_TIMER_START(start) ;
+	for (size_t i = pPacked->size; i > 0; --i) {
+		unsigned code = rubix_cube_packed_scramble_code(pPacked,i - 1) ;
+		if (code >= RUBIX_CUBE_MOVE_COUNT) continue ;
+		RubixCubeFaceRotation rotation = (RubixCubeFaceRotation)(code % RUBIX_CUBE_FACE_ROTATION_COUNT) ;
+		if (rotation == RUBIX_CUBE_FACE_ROTATION_CLOCKWISE) rotation = RUBIX_CUBE_FACE_ROTATION_COUNTERCLOCKWISE ;
+		else if (rotation == RUBIX_CUBE_FACE_ROTATION_COUNTERCLOCKWISE) rotation = RUBIX_CUBE_FACE_ROTATION_CLOCKWISE ;
+		rubix_cube_rotate_face(pRubix_cube,(RubixCubeSide)(code / RUBIX_CUBE_FACE_ROTATION_COUNT),rotation) ;
+	}
+	RUBIX_CUBE_STATS_ADD(unapply_scramble,1) ;
+	RUBIX_CUBE_STATS_ADD(unapply_scramble_moves,pPacked->size) ;
+	RUBIX_CUBE_STATS_TIMER_STOP(start,unapply_scramble_cycles) ;
+}
+
+int rubix_cube_packed_scramble_write(const RubixCubePackedScramble * pPacked, FILE * output_file) {
+	unsigned char header[RUBIX_CUBE_PACKED_RECORD_HEADER] ;
+	size_t size = RUBIX_CUBE_PACKED_MOVES_SIZE(pPacked->size) ;
+
+	if (pPacked->size > RUBIX_CUBE_PACKED_SCRAMBLE_MAX_MOVES) return 0 ;
+	for (size_t b = 0; b < 8; ++b) header[b] = (unsigned char)((unsigned long long)pPacked->seed >> (8 * b)) ;
+	for (size_t b = 0; b < 4; ++b) header[8 + b] = (unsigned char)(pPacked->size >> (8 * b)) ;
+
+	return fwrite(header,sizeof(header),1,output_file) == 1 && fwrite(pPacked->bits,1,size,output_file) == size ;
+}
+
+RubixCubePackedScramble * rubix_cube_packed_scramble_read(FILE * input_file) {
+	unsigned char header[RUBIX_CUBE_PACKED_RECORD_HEADER] ;
+	unsigned long long seed = 0 ;
+	size_t count = 0 ;
+	RubixCubePackedScramble * pNew ;
+
+	if (fread(header,sizeof(header),1,input_file) != 1) return NULL ;
+	for (size_t b = 0; b < 8; ++b) seed |= (unsigned long long)header[b] << (8 * b) ;
+	for (size_t b = 0; b < 4; ++b) count |= (size_t)header[8 + b] << (8 * b) ;
+
+	if (count > RUBIX_CUBE_PACKED_SCRAMBLE_MAX_MOVES) return NULL ;
+	if (!(pNew = rubix_cube_packed_scramble_allocate_empty(count,(RubixCubeSeed)seed))) return NULL ;
+	pNew->size = count ;
+	if (fread(pNew->bits,1,RUBIX_CUBE_PACKED_MOVES_SIZE(count),input_file) != RUBIX_CUBE_PACKED_MOVES_SIZE(count)) {
+		rubix_cube_packed_scramble_free(pNew) ; return NULL ;
+	}
+	for (size_t i = 0; i < count; ++i) {
+		if (rubix_cube_packed_scramble_code(pNew,i) >= RUBIX_CUBE_MOVE_COUNT) {
+			rubix_cube_packed_scramble_free(pNew) ; return NULL ;
+		}
+	}
+	return pNew ;
+}
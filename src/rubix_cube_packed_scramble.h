@@ -0,0 +1,118 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Packed moves:
+ *
+ * There are only RUBIX_CUBE_MOVE_COUNT (18) moves, so a move fits in a single byte
+ * code, its RUBIX_CUBE_MOVE_INDEX() value, or in 5 bits. A RubixCubeMove takes 8.
+ *
+ * The 5 bit form is a little endian bit stream, move i is bits 5i to 5i + 4:
+ *
+ * 	byte 	|   0    |   1    |   2    | ...
+ * 	bits 	 11100000 32222211 44443333  ...
+ *
+ * so 8 moves fill exactly 5 bytes. A RubixCubePackedScramble keeps its moves this way
+ * and can be applied to a cube without unpacking it first.
+ */
+
+#ifndef RUBIX_CUBE_PACKED_SCRAMBLE_H
+#define RUBIX_CUBE_PACKED_SCRAMBLE_H "rubix_cube_packed_scramble.h"
+
+#include "rubix_cube.h"
+#include <stdio.h>
+
+#define RUBIX_CUBE_MOVE_BITS 			5
+
+/* Bytes needed for @count moves in the 5 bit form */
+#define RUBIX_CUBE_PACKED_MOVES_SIZE(count) 	(((count) * RUBIX_CUBE_MOVE_BITS + 7) / 8)
+
+typedef struct rubix_cube_packed_scramble {
+	unsigned char * 		bits ;
+	size_t 				size ;		/* in moves */
+	size_t 				capacity ;	/* in moves */
+	RubixCubeSeed 			seed ;
+} RubixCubePackedScramble ;
+
+/* Get the byte code of @move */
+unsigned char rubix_cube_move_encode(const RubixCubeMove * move) ;
+
+/* Set @dest to the move @code stands for, return 0 if @code is not a move */
+int rubix_cube_move_decode(RubixCubeMove * dest, unsigned char code) ;
+
+/* Set @codes[i] to the byte code of @moves[i] for each of the @count moves */
+void rubix_cube_moves_encode(unsigned char * codes, const RubixCubeMove * moves, size_t count) ;
+
+/* Set @moves[i] to the move @codes[i] stands for, return 0 if any code is not a move */
+int rubix_cube_moves_decode(RubixCubeMove * moves, const unsigned char * codes, size_t count) ;
+
+/* Apply / unapply @count byte @codes to @pRubix_cube, return 0 and leave it alone if any code is not a move */
+int rubix_cube_apply_move_codes(RubixCube * pRubix_cube, const unsigned char * codes, size_t count) ;
+int rubix_cube_unapply_move_codes(RubixCube * pRubix_cube, const unsigned char * codes, size_t count) ;
+
+/*
+ * Write the byte codes of @count scrambles of @intensity moves each, back to back, to @codes,
+ * scramble i from @seeds[i]. A seed of 0 is replaced with a fresh one, written back to @seeds.
+ * Scramble i is the same one rubix_cube_scramble_allocate(@seeds[i],@intensity) makes.
+ */
+void rubix_cube_generate_move_codes(unsigned char * codes, RubixCubeSeed * seeds, size_t count, size_t intensity) ;
+
+/* Pack @count @moves into RUBIX_CUBE_PACKED_MOVES_SIZE(@count) bytes at @dest, unused high bits are zero */
+void rubix_cube_moves_pack(unsigned char * dest, const RubixCubeMove * moves, size_t count) ;
+
+/* Unpack @count moves from @src into @moves, return 0 if any of them is not a move */
+int rubix_cube_moves_unpack(RubixCubeMove * moves, const unsigned char * src, size_t count) ;
+
+/* Return a pointer to a freshly allocated packed scramble of @intensity moves from @seed (0 for a random seed) */
+RubixCubePackedScramble * rubix_cube_packed_scramble_allocate(RubixCubeSeed seed, size_t intensity) ;
+
+/* Return a pointer to a freshly allocated packed copy of @pScramble */
+RubixCubePackedScramble * rubix_cube_packed_scramble_from_scramble(const RubixCubeScramble * pScramble) ;
+
+/* Return a pointer to a freshly allocated unpacked copy of @pPacked, NULL if it holds something that is not a move */
+RubixCubeScramble * rubix_cube_packed_scramble_to_scramble(const RubixCubePackedScramble * pPacked) ;
+
+/* Free all memory associated with a RubixCubePackedScramble object */
+void rubix_cube_packed_scramble_free(RubixCubePackedScramble * pPacked) ;
+
+/* Get move @index of @pPacked */
+RubixCubeMove rubix_cube_packed_scramble_get(const RubixCubePackedScramble * pPacked, size_t index) ;
+
+/* Add @move to the end of @pPacked, growing it as needed, return nonzero on success */
+int rubix_cube_packed_scramble_append(RubixCubePackedScramble * pPacked, const RubixCubeMove * move) ;
+
+/* Apply / unapply all moves in @pPacked to @pRubix_cube, straight from the packed form */
+void rubix_cube_apply_packed_scramble(RubixCube * pRubix_cube, const RubixCubePackedScramble * pPacked) ;
+void rubix_cube_unapply_packed_scramble(RubixCube * pRubix_cube, const RubixCubePackedScramble * pPacked) ;
+
+/*
+ * On disk a packed scramble is its seed (8 bytes), its size in moves (4 bytes), both
+ * little endian, then RUBIX_CUBE_PACKED_MOVES_SIZE(size) bytes of moves. Records can be
+ * written back to back into one log. A size above RUBIX_CUBE_PACKED_SCRAMBLE_MAX_MOVES
+ * is a bad record, so a corrupt header cannot ask for gigabytes.
+ */
+
+#define RUBIX_CUBE_PACKED_SCRAMBLE_MAX_MOVES 	((size_t)1 << 24)
+
+/* Write @pPacked to @output_file, return nonzero on success, 0 if it is over RUBIX_CUBE_PACKED_SCRAMBLE_MAX_MOVES */
+int rubix_cube_packed_scramble_write(const RubixCubePackedScramble * pPacked, FILE * output_file) ;
+
+/* Return a pointer to a freshly allocated packed scramble read from @input_file, NULL at end of file or on a bad record */
+RubixCubePackedScramble * rubix_cube_packed_scramble_read(FILE * input_file) ;
+
+#endif // RUBIX_CUBE_PACKED_SCRAMBLE_H
@@ -0,0 +1,398 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+#include "rubix_cube_pattern.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+/*
+ * Where each face rotation sends a single piece: the piece in position p goes to
+ * position to[move][p] and picks up twist[move][p] more twist (or flip).
+ */
+typedef struct rubix_cube_pattern_moves {
+	unsigned char 	to 	[RUBIX_CUBE_MOVE_COUNT][RUBIX_CUBE_EDGE_COUNT] ;
+	unsigned char 	twist 	[RUBIX_CUBE_MOVE_COUNT][RUBIX_CUBE_EDGE_COUNT] ;
+} RubixCubePatternMoves ;
+
+RubixCubePatternMoves rubix_cube_pattern_corner_moves ;
+RubixCubePatternMoves rubix_cube_pattern_edge_moves ;
+
+static pthread_once_t rubix_cube_pattern_tables_once = PTHREAD_ONCE_INIT ;
+
+static void rubix_cube_pattern_build_tables(void) {
+	for (size_t m = 0; m < RUBIX_CUBE_MOVE_COUNT; ++m) {
+		const RubixCubeCubie * move = rubix_cube_cubie_get_move(m / RUBIX_CUBE_FACE_ROTATION_COUNT,m % RUBIX_CUBE_FACE_ROTATION_COUNT) ;
+		/* new.cp[i] = old.cp[move.cp[i]], so whatever was at move.cp[i] ends up at i */
+		for (size_t i = 0; i < RUBIX_CUBE_CORNER_COUNT; ++i) {
+			rubix_cube_pattern_corner_moves.to[m][move->corner_permutation[i]] = (unsigned char)i ;
+			rubix_cube_pattern_corner_moves.twist[m][move->corner_permutation[i]] = move->corner_orientation[i] ;
+		}
+		for (size_t i = 0; i < RUBIX_CUBE_EDGE_COUNT; ++i) {
+			rubix_cube_pattern_edge_moves.to[m][move->edge_permutation[i]] = (unsigned char)i ;
+			rubix_cube_pattern_edge_moves.twist[m][move->edge_permutation[i]] = move->edge_orientation[i] ;
+		}
+	}
+}
+
+static inline size_t rubix_cube_pattern_positions(RubixCubePieceKind kind) {
+	return kind == RUBIX_CUBE_PIECE_KIND_CORNER ? RUBIX_CUBE_CORNER_COUNT : RUBIX_CUBE_EDGE_COUNT ;
+}
+
+static inline unsigned rubix_cube_pattern_twists(RubixCubePieceKind kind) {
+	return kind == RUBIX_CUBE_PIECE_KIND_CORNER ? 3 : 2 ;
+}
+
+/* When every piece is tracked the last twist follows from the others and is left out */
+static inline size_t rubix_cube_pattern_twisted(RubixCubePieceKind kind, size_t count) {
+	return count == rubix_cube_pattern_positions(kind) ? count - 1 : count ;
+}
+
+/* Number of ways to place @count distinguishable pieces in @positions spots */
+static size_t rubix_cube_pattern_arrangements(size_t positions, size_t count) {
+	size_t arrangements = 1 ;
+	for (size_t i = 0; i < count; ++i) arrangements *= positions - i ;
+	return arrangements ;
+}
+
+size_t rubix_cube_pattern_size(RubixCubePieceKind kind, size_t count) {
+	size_t positions = rubix_cube_pattern_positions(kind) ;
+	if (!count || count > positions) return 0 ;
+
+	size_t size = rubix_cube_pattern_arrangements(positions,count) ;
+	for (size_t i = 0; i < rubix_cube_pattern_twisted(kind,count); ++i) size *= rubix_cube_pattern_twists(kind) ;
+	return size ;
+}
+
+/* Index of tracked pieces sitting at @position with @twist, tracked piece by tracked piece */
+static size_t rubix_cube_pattern_rank(const RubixCubePatternDatabase * pDatabase, const unsigned char * position, const unsigned char * twist) {
+	size_t positions = rubix_cube_pattern_positions(pDatabase->kind) ;
+	unsigned used = 0 ;
+	size_t rank = 0 ;
+
+	/* Partial permutation: digit i counts the free positions below position[i] */
+	for (size_t i = 0; i < pDatabase->count; ++i) {
+		size_t digit = position[i] - __builtin_popcount(used & ((1u << position[i]) - 1)) ;
+		rank = rank * (positions - i) + digit ;
+		used |= 1u << position[i] ;
+	}
+	for (size_t i = 0; i < rubix_cube_pattern_twisted(pDatabase->kind,pDatabase->count); ++i) {
+		rank = rank * rubix_cube_pattern_twists(pDatabase->kind) + twist[i] ;
+	}
+	return rank ;
+}
+
+static void rubix_cube_pattern_unrank(const RubixCubePatternDatabase * pDatabase, size_t rank, unsigned char * position, unsigned char * twist) {
+	size_t positions = rubix_cube_pattern_positions(pDatabase->kind) ;
+	unsigned base = rubix_cube_pattern_twists(pDatabase->kind) ;
+	size_t twisted = rubix_cube_pattern_twisted(pDatabase->kind,pDatabase->count) ;
+	unsigned total = 0 ;
+
+	for (size_t i = twisted; i > 0; --i) {
+		twist[i - 1] = (unsigned char)(rank % base) ;
+		total += twist[i - 1] ;
+		rank /= base ;
+	}
+	if (twisted < pDatabase->count) twist[twisted] = (unsigned char)((base - total % base) % base) ;
+
+	unsigned char digits[RUBIX_CUBE_EDGE_COUNT] ;
+	for (size_t i = pDatabase->count; i > 0; --i) {
+		digits[i - 1] = (unsigned char)(rank % (positions - (i - 1))) ;
+		rank /= positions - (i - 1) ;
+	}
+
+	unsigned used = 0 ;
+	for (size_t i = 0; i < pDatabase->count; ++i) {
+		size_t free_seen = 0, p ;
+		for (p = 0; p < positions; ++p) {
+			if (used & (1u << p)) continue ;
+			if (free_seen++ == digits[i]) break ;
+		}
+		position[i] = (unsigned char)p ;
+		used |= 1u << p ;
+	}
+}
+
+size_t rubix_cube_pattern_index(const RubixCubePatternDatabase * pDatabase, const RubixCubeCubie * pCubie) {
+	const unsigned char * permutation, * orientation ;
+	unsigned char where[RUBIX_CUBE_EDGE_COUNT], position[RUBIX_CUBE_EDGE_COUNT], twist[RUBIX_CUBE_EDGE_COUNT] ;
+	size_t positions = rubix_cube_pattern_positions(pDatabase->kind) ;
+
+	if (pDatabase->kind == RUBIX_CUBE_PIECE_KIND_CORNER) {
+		permutation = pCubie->corner_permutation ;
+		orientation = pCubie->corner_orientation ;
+	} else {
+		permutation = pCubie->edge_permutation ;
+		orientation = pCubie->edge_orientation ;
+	}
+
+	for (size_t p = 0; p < positions; ++p) where[permutation[p]] = (unsigned char)p ;
+	for (size_t i = 0; i < pDatabase->count; ++i) {
+		position[i] = where[pDatabase->pieces[i]] ;
+		twist[i] = orientation[position[i]] ;
+	}
+	return rubix_cube_pattern_rank(pDatabase,position,twist) ;
+}
+
+unsigned rubix_cube_pattern_get(const RubixCubePatternDatabase * pDatabase, size_t index) {
+	return (pDatabase->table[index >> 1] >> ((index & 1) << 2)) & 0xf ;
+}
+
+static inline void rubix_cube_pattern_set(RubixCubePatternDatabase * pDatabase, size_t index, unsigned value) {
+	unsigned shift = (index & 1) << 2 ;
+	pDatabase->table[index >> 1] = (unsigned char)((pDatabase->table[index >> 1] & ~(0xf << shift)) | (value << shift)) ;
+}
+
+unsigned rubix_cube_pattern_lookup(const RubixCubePatternDatabase * pDatabase, const RubixCubeCubie * pCubie) {
+	return rubix_cube_pattern_get(pDatabase,rubix_cube_pattern_index(pDatabase,pCubie)) ;
+}
+
+/* Allocate a database with everything but its table filled in, NULL if the pieces are invalid */
+static RubixCubePatternDatabase * rubix_cube_pattern_describe(RubixCubePieceKind kind, const unsigned char * pieces, size_t count) {
+	RubixCubePatternDatabase * pNew ;
+	size_t size = rubix_cube_pattern_size(kind,count) ;
+	unsigned seen = 0 ;
+
+	if (!size || !pieces) return NULL ;
+	for (size_t i = 0; i < count; ++i) {
+		if (pieces[i] >= rubix_cube_pattern_positions(kind) || seen & (1u << pieces[i])) return NULL ;
+		seen |= 1u << pieces[i] ;
+	}
+
+	if (!(pNew = (RubixCubePatternDatabase *)malloc(sizeof(RubixCubePatternDatabase)))) return NULL ;
+
+	pNew->kind = kind ;
+	pNew->count = count ;
+	memset(pNew->pieces,0,sizeof(pNew->pieces)) ;
+	memcpy(pNew->pieces,pieces,count) ;
+	pNew->size = size ;
+	pNew->depth = 0 ;
+	pNew->table = NULL ;
+	memset(&pNew->mapping,0,sizeof(pNew->mapping)) ;
+
+	return pNew ;
+}
+
+RubixCubePatternDatabase * rubix_cube_pattern_allocate_empty(RubixCubePieceKind kind, const unsigned char * pieces, size_t count) {
+	RubixCubePatternDatabase * pNew = rubix_cube_pattern_describe(kind,pieces,count) ;
+
+	if (!pNew) return NULL ;
+	if (!(pNew->table = (unsigned char *)malloc((pNew->size + 1) / 2))) {
+		free(pNew) ; return NULL ;
+	}
+	memset(pNew->table,0xff,(pNew->size + 1) / 2) ;
+
+	return pNew ;
+}
+
+/* Rank of the state @move takes the given pieces to */
+static inline size_t rubix_cube_pattern_neighbour(const RubixCubePatternDatabase * pDatabase, const RubixCubePatternMoves * moves, size_t move,
+						  const unsigned char * position, const unsigned char * twist) {
+	unsigned char next_position[RUBIX_CUBE_EDGE_COUNT], next_twist[RUBIX_CUBE_EDGE_COUNT] ;
+	unsigned base = rubix_cube_pattern_twists(pDatabase->kind) ;
+
+	for (size_t i = 0; i < pDatabase->count; ++i) {
+		next_position[i] = moves->to[move][position[i]] ;
+		next_twist[i] = (unsigned char)((twist[i] + moves->twist[move][position[i]]) % base) ;
+	}
+	return rubix_cube_pattern_rank(pDatabase,next_position,next_twist) ;
+}
+
+/* Entries are read and claimed with atomics while building, since other threads may be setting the neighbouring nibble */
+static inline unsigned rubix_cube_pattern_get_shared(const RubixCubePatternDatabase * pDatabase, size_t index) {
+	unsigned char byte = __atomic_load_n(&pDatabase->table[index >> 1],__ATOMIC_RELAXED) ;
+	return (byte >> ((index & 1) << 2)) & 0xf ;
+}
+
+/* Set entry @index to @value if it is still unknown, return nonzero if this call was the one to set it */
+static inline int rubix_cube_pattern_claim(RubixCubePatternDatabase * pDatabase, size_t index, unsigned value) {
+	unsigned char * byte = &pDatabase->table[index >> 1] ;
+	unsigned shift = (index & 1) << 2 ;
+	unsigned char old = __atomic_load_n(byte,__ATOMIC_RELAXED) ;
+
+	while (((old >> shift) & 0xf) == RUBIX_CUBE_PATTERN_UNKNOWN) {
+		unsigned char new = (unsigned char)((old & ~(0xf << shift)) | (value << shift)) ;
+		if (__atomic_compare_exchange_n(byte,&old,new,1,__ATOMIC_RELAXED,__ATOMIC_RELAXED)) return 1 ;
+	}
+	return 0 ;
+}
+
+/* One thread's share of one level of the search */
+typedef struct rubix_cube_pattern_worker {
+	pthread_t 			thread ;
+	RubixCubePatternDatabase * 	pDatabase ;
+	const RubixCubePatternMoves * 	moves ;
+	size_t 				begin ;
+	size_t 				end ;
+	unsigned 			depth ;
+	int 				backward ;
+	size_t 				found ;
+} RubixCubePatternWorker ;
+
+/*
+ * Level by level: while few entries are known every entry found at depth d is expanded
+ * by all 18 moves and any neighbour not seen yet gets depth d + 1. Once more than half
+ * the table is known it is cheaper to go the other way round and give each unknown
+ * entry depth d + 1 as soon as one of its neighbours turns out to be at depth d (every
+ * move has its inverse among the 18, so neighbours are the same both ways).
+ *
+ * Either way only entries at depth d are looked at and only entries at d + 1 are written
+ * during a level, so the table can be split between threads as long as writes are atomic.
+ */
+static void * rubix_cube_pattern_build_level(void * pArgument) {
+	RubixCubePatternWorker * pWorker = (RubixCubePatternWorker *)pArgument ;
+	RubixCubePatternDatabase * pDatabase = pWorker->pDatabase ;
+	unsigned char position[RUBIX_CUBE_EDGE_COUNT], twist[RUBIX_CUBE_EDGE_COUNT] ;
+	unsigned depth = pWorker->depth ;
+
+	pWorker->found = 0 ;
+	for (size_t index = pWorker->begin; index < pWorker->end; ++index) {
+		unsigned value = rubix_cube_pattern_get_shared(pDatabase,index) ;
+
+		if (pWorker->backward) {
+			if (value != RUBIX_CUBE_PATTERN_UNKNOWN) continue ;
+			rubix_cube_pattern_unrank(pDatabase,index,position,twist) ;
+			for (size_t m = 0; m < RUBIX_CUBE_MOVE_COUNT; ++m) {
+				if (rubix_cube_pattern_get_shared(pDatabase,rubix_cube_pattern_neighbour(pDatabase,pWorker->moves,m,position,twist)) == depth) {
+					pWorker->found += rubix_cube_pattern_claim(pDatabase,index,depth + 1) ;
+					break ;
+				}
+			}
+		} else {
+			if (value != depth) continue ;
+			rubix_cube_pattern_unrank(pDatabase,index,position,twist) ;
+			for (size_t m = 0; m < RUBIX_CUBE_MOVE_COUNT; ++m) {
+				size_t next = rubix_cube_pattern_neighbour(pDatabase,pWorker->moves,m,position,twist) ;
+				pWorker->found += rubix_cube_pattern_claim(pDatabase,next,depth + 1) ;
+			}
+		}
+	}
+	return NULL ;
+}
+
+void rubix_cube_pattern_build_threads(RubixCubePatternDatabase * pDatabase, size_t threads) {
+	RubixCubePatternWorker workers[RUBIX_CUBE_PATTERN_MAX_THREADS] ;
+	const RubixCubePatternMoves * moves ;
+	size_t known = 1 ;
+
+	pthread_once(&rubix_cube_pattern_tables_once,rubix_cube_pattern_build_tables) ;
+	moves = pDatabase->kind == RUBIX_CUBE_PIECE_KIND_CORNER ? &rubix_cube_pattern_corner_moves : &rubix_cube_pattern_edge_moves ;
+
+	if (!threads) {
+		long online = sysconf(_SC_NPROCESSORS_ONLN) ;
+		threads = online > 0 ? (size_t)online : 1 ;
+	}
+	if (threads > RUBIX_CUBE_PATTERN_MAX_THREADS) threads = RUBIX_CUBE_PATTERN_MAX_THREADS ;
+
+	RubixCubeCubie solved = rubix_cube_cubie_generate_solved() ;
+	rubix_cube_pattern_set(pDatabase,rubix_cube_pattern_index(pDatabase,&solved),0) ;
+
+	for (unsigned depth = 0; known < pDatabase->size && depth + 1 < RUBIX_CUBE_PATTERN_UNKNOWN; ++depth) {
+		/* Shares start on even indices so that no two threads scan the same byte */
+		size_t share = (pDatabase->size / threads + 1) & ~(size_t)1 ;
+		size_t found = 0, started = 1 ;
+
+		for (size_t i = 0; i < threads; ++i) {
+			workers[i].pDatabase = pDatabase ;
+			workers[i].moves = moves ;
+			workers[i].begin = i * share < pDatabase->size ? i * share : pDatabase->size ;
+			workers[i].end = i + 1 == threads || (i + 1) * share > pDatabase->size ? pDatabase->size : (i + 1) * share ;
+			workers[i].depth = depth ;
+			workers[i].backward = known > pDatabase->size / 2 ;
+		}
+
+		for (; started < threads; ++started) {
+			if (pthread_create(&workers[started].thread,NULL,rubix_cube_pattern_build_level,&workers[started])) break ;
+		}
+		/* The calling thread takes the first share, and any share a thread could not be started for */
+		rubix_cube_pattern_build_level(&workers[0]) ;
+		for (size_t i = started; i < threads; ++i) rubix_cube_pattern_build_level(&workers[i]) ;
+		for (size_t i = 1; i < started; ++i) pthread_join(workers[i].thread,NULL) ;
+		for (size_t i = 0; i < threads; ++i) found += workers[i].found ;
+
+		if (!found) break ;
+		known += found ;
+		pDatabase->depth = depth + 1 ;
+	}
+}
+
+void rubix_cube_pattern_build(RubixCubePatternDatabase * pDatabase) {
+	rubix_cube_pattern_build_threads(pDatabase,1) ;
+}
+
+RubixCubePatternDatabase * rubix_cube_pattern_allocate(RubixCubePieceKind kind, const unsigned char * pieces, size_t count) {
+	RubixCubePatternDatabase * pNew = rubix_cube_pattern_allocate_empty(kind,pieces,count) ;
+	if (pNew) rubix_cube_pattern_build(pNew) ;
+	return pNew ;
+}
+
+void rubix_cube_pattern_free(RubixCubePatternDatabase * pDatabase) {
+	if (pDatabase) {
+		if (pDatabase->mapping.address) rubix_cube_table_unmap(&pDatabase->mapping) ;
+		else free(pDatabase->table) ;
+		free(pDatabase) ;
+	}
+}
+
+/* What a pattern table file was built for */
+typedef struct rubix_cube_pattern_parameters {
+	uint32_t 			kind ;
+	uint32_t 			count ;
+	uint32_t 			depth ;
+	unsigned char 			pieces[RUBIX_CUBE_EDGE_COUNT] ;
+} RubixCubePatternParameters ;
+
+int rubix_cube_pattern_save(const RubixCubePatternDatabase * pDatabase, const char * path) {
+	RubixCubePatternParameters parameters ;
+	const void * sections[] = { pDatabase->table } ;
+	size_t sizes[] = { (pDatabase->size + 1) / 2 } ;
+
+	memset(&parameters,0,sizeof(parameters)) ;
+	parameters.kind = pDatabase->kind ;
+	parameters.count = (uint32_t)pDatabase->count ;
+	parameters.depth = (uint32_t)pDatabase->depth ;
+	memcpy(parameters.pieces,pDatabase->pieces,sizeof(parameters.pieces)) ;
+
+	return rubix_cube_table_write(path,RUBIX_CUBE_TABLE_KIND_PATTERN,&parameters,sizeof(parameters),sections,sizes,1) ;
+}
+
+RubixCubePatternDatabase * rubix_cube_pattern_map(const char * path) {
+	RubixCubePatternDatabase * pNew ;
+	RubixCubePatternParameters parameters ;
+	RubixCubeTableMapping mapping ;
+
+	if (!rubix_cube_table_map(&mapping,path,RUBIX_CUBE_TABLE_KIND_PATTERN,NULL,0)) return NULL ;
+	memcpy(&parameters,mapping.header->parameters,sizeof(parameters)) ;
+
+	/* Check the file against a database built the usual way, but keep only its description */
+	if (parameters.kind > RUBIX_CUBE_PIECE_KIND_EDGE || parameters.count > RUBIX_CUBE_EDGE_COUNT ||
+	    !(pNew = rubix_cube_pattern_describe(parameters.kind,parameters.pieces,parameters.count))) {
+		rubix_cube_table_unmap(&mapping) ;
+		return NULL ;
+	}
+	if (mapping.header->payload_size != rubix_cube_table_padded_size((pNew->size + 1) / 2)) {
+		free(pNew) ;
+		rubix_cube_table_unmap(&mapping) ;
+		return NULL ;
+	}
+
+	pNew->depth = parameters.depth ;
+	pNew->mapping = mapping ;
+	pNew->table = (unsigned char *)rubix_cube_table_section(&mapping,0) ;
+	return pNew ;
+}
@@ -0,0 +1,102 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Pattern databases:
+ *
+ * A pattern database only looks at a subset of the pieces of one kind (some or all of
+ * the corners, or some of the edges) and stores, for every place and twist those pieces
+ * can be in, the fewest face rotations needed to bring just them home. That number can
+ * never be more than what it takes to solve the whole cube, which makes it an admissible
+ * heuristic for IDA* (see rubix_cube_solver.h).
+ *
+ * Distances are built by breadth first search out from solved and stored in nibbles.
+ *
+ * 	all 8 corners 		8! * 3^7 		= 88179840 entries, 42 MiB
+ * 	6 of the edges 		12!/6! * 2^6 		= 42577920 entries, 20 MiB
+ * 	7 of the edges 		12!/5! * 2^7 		= 510935040 entries, 244 MiB
+ *
+ * Small subsets build in well under a second and are handy for tests. Big ones are better
+ * built once, saved with rubix_cube_pattern_save() and memory mapped from then on.
+ */
+
+#ifndef RUBIX_CUBE_PATTERN_H
+#define RUBIX_CUBE_PATTERN_H "rubix_cube_pattern.h"
+
+#include "rubix_cube.h"
+#include "rubix_cube_cubie.h"
+#include "rubix_cube_table.h"
+
+typedef enum rubix_cube_piece_kind {
+	RUBIX_CUBE_PIECE_KIND_CORNER,
+	RUBIX_CUBE_PIECE_KIND_EDGE
+} RubixCubePieceKind ;
+
+/* Stored for entries the search never reached, which should not happen for a finished table */
+#define RUBIX_CUBE_PATTERN_UNKNOWN 	0xf
+
+/* Most threads a single build will use */
+#define RUBIX_CUBE_PATTERN_MAX_THREADS 	64
+
+typedef struct rubix_cube_pattern_database {
+	RubixCubePieceKind 		kind ;
+	size_t 				count ;				/* number of tracked pieces */
+	unsigned char 			pieces[RUBIX_CUBE_EDGE_COUNT] ;	/* RubixCubeCorner or RubixCubeEdge values */
+	size_t 				size ;				/* number of entries */
+	size_t 				depth ;				/* largest distance in the table */
+	unsigned char * 		table ;				/* two entries per byte, low nibble first */
+	RubixCubeTableMapping 		mapping ;			/* where @table lives if it was mapped, read only */
+} RubixCubePatternDatabase ;
+
+/* Return a pointer to a freshly allocated and fully built pattern database over @count @pieces of one @kind */
+/* Return NULL if the pieces are invalid or memory runs out */
+RubixCubePatternDatabase * rubix_cube_pattern_allocate(RubixCubePieceKind kind, const unsigned char * pieces, size_t count) ;
+
+/* Same as rubix_cube_pattern_allocate() but leave every entry RUBIX_CUBE_PATTERN_UNKNOWN */
+RubixCubePatternDatabase * rubix_cube_pattern_allocate_empty(RubixCubePieceKind kind, const unsigned char * pieces, size_t count) ;
+
+/* Fill every entry of @pDatabase by breadth first search */
+void rubix_cube_pattern_build(RubixCubePatternDatabase * pDatabase) ;
+
+/* Same as rubix_cube_pattern_build(), splitting every level of the search between @threads threads */
+/* If @threads is 0 use one thread per online cpu */
+void rubix_cube_pattern_build_threads(RubixCubePatternDatabase * pDatabase, size_t threads) ;
+
+/* Free all memory associated with a RubixCubePatternDatabase object */
+void rubix_cube_pattern_free(RubixCubePatternDatabase * pDatabase) ;
+
+/* Write @pDatabase to a table file at @path, return nonzero on success */
+int rubix_cube_pattern_save(const RubixCubePatternDatabase * pDatabase, const char * path) ;
+
+/* Return a pointer to a freshly allocated pattern database whose table is the file at @path mapped read only */
+/* Return NULL if the file is missing or is not a pattern table of this version */
+RubixCubePatternDatabase * rubix_cube_pattern_map(const char * path) ;
+
+/* Get the entry index of @pCubie in @pDatabase */
+size_t rubix_cube_pattern_index(const RubixCubePatternDatabase * pDatabase, const RubixCubeCubie * pCubie) ;
+
+/* Get the stored distance of entry @index */
+unsigned rubix_cube_pattern_get(const RubixCubePatternDatabase * pDatabase, size_t index) ;
+
+/* Get a lower bound on the number of face rotations needed to solve @pCubie */
+unsigned rubix_cube_pattern_lookup(const RubixCubePatternDatabase * pDatabase, const RubixCubeCubie * pCubie) ;
+
+/* Get the number of entries a database over @count pieces of @kind would have, 0 if @count is out of range */
+size_t rubix_cube_pattern_size(RubixCubePieceKind kind, size_t count) ;
+
+#endif // RUBIX_CUBE_PATTERN_H
@@ -0,0 +1,207 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+#include "rubix_cube_pool.h"
+#include "rubix_cube_stats.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct rubix_cube_pool_slab {
+	RubixCubePoolSlab * 	next ;
+	size_t 			size ;
+	size_t 			used ;
+	unsigned char 		data[] __attribute__((aligned(RUBIX_CUBE_POOL_ALIGNMENT))) ;
+} ;
+
+/* A scramble as the pool hands it out, its moves follow right after it */
+struct rubix_cube_pool_scramble {
+	RubixCubePoolScramble * 	next ;
+	RubixCubeScramble 		scramble ;
+	RubixCubeMove 			moves[] ;
+} ;
+
+static RubixCubePoolSlab * rubix_cube_pool_slab_allocate(size_t size) {
+	RubixCubePoolSlab * pNew ;
+
+	RUBIX_CUBE_STATS_ADD(allocations,1) ;
+	RUBIX_CUBE_STATS_ADD(allocation_bytes,sizeof(RubixCubePoolSlab) + size) ;
+	if (posix_memalign((void **)&pNew,RUBIX_CUBE_POOL_ALIGNMENT,sizeof(RubixCubePoolSlab) + size)) return NULL ;
+	pNew->next = NULL ;
+	pNew->size = size ;
+	pNew->used = 0 ;
+	return pNew ;
+}
+
+/* Cut @size bytes aligned to @alignment from the unused part of @slab, NULL if they do not fit */
+static inline void * rubix_cube_pool_slab_carve(RubixCubePoolSlab * slab, size_t size, size_t alignment, size_t * pTaken) {
+	uintptr_t start = (uintptr_t)slab->data + slab->used ;
+	size_t offset = ((start + alignment - 1) & ~(uintptr_t)(alignment - 1)) - (uintptr_t)slab->data ;
+
+	if (offset > slab->size || size > slab->size - offset) return NULL ;
+	*pTaken = offset + size - slab->used ;
+	slab->used = offset + size ;
+	return slab->data + offset ;
+}
+
+RubixCubePool * rubix_cube_pool_allocate(size_t slab_size) {
+	RubixCubePool * pNew ;
+
+	if (!(pNew = (RubixCubePool *)calloc(1,sizeof(RubixCubePool)))) return NULL ;
+	pNew->slab_size = slab_size ? slab_size : RUBIX_CUBE_POOL_SLAB_SIZE ;
+	return pNew ;
+}
+
+void rubix_cube_pool_free(RubixCubePool * pPool) {
+	if (!pPool) return ;
+	for (RubixCubePoolSlab * slab = pPool->slabs, * next; slab; slab = next) {
+		next = slab->next ;
+		free(slab) ;
+	}
+	free(pPool) ;
+}
+
+void rubix_cube_pool_reset(RubixCubePool * pPool) {
+	for (RubixCubePoolSlab * slab = pPool->slabs; slab; slab = slab->next) slab->used = 0 ;
+	pPool->current = pPool->slabs ;
+	pPool->free_cubes = NULL ;
+	pPool->free_scrambles = NULL ;
+	pPool->bytes_used = 0 ;
+}
+
+void * rubix_cube_pool_carve(RubixCubePool * pPool, size_t size, size_t alignment) {
+	RubixCubePoolSlab * slab ;
+	size_t taken = 0 ;
+	void * pNew ;
+
+	if (!alignment || alignment & (alignment - 1)) return NULL ;
+
+	/* Slabs kept by a reset come after the current one, so the space before it is never looked at again until the next reset */
+	for (slab = pPool->current; slab; slab = slab->next) {
+		if ((pNew = rubix_cube_pool_slab_carve(slab,size,alignment,&taken))) {
+			pPool->current = slab ;
+			pPool->bytes_used += taken ;
+			return pNew ;
+		}
+	}
+
+	if (size > SIZE_MAX - alignment - sizeof(RubixCubePoolSlab)) return NULL ;
+	if (size + alignment > pPool->slab_size) {
+		/* Too big for a slab, it gets one of its own that goes behind the current slab so that slab keeps being used */
+		if (!(slab = rubix_cube_pool_slab_allocate(size + alignment))) return NULL ;
+		if (pPool->current) {
+			slab->next = pPool->current->next ;
+			pPool->current->next = slab ;
+		} else {
+			pPool->slabs = slab ;
+		}
+	} else {
+		if (!(slab = rubix_cube_pool_slab_allocate(pPool->slab_size))) return NULL ;
+		if (pPool->current) {
+			while (pPool->current->next) pPool->current = pPool->current->next ;
+			pPool->current->next = slab ;
+		} else {
+			pPool->slabs = slab ;
+		}
+		pPool->current = slab ;
+	}
+	++pPool->slab_count ;
+
+	pNew = rubix_cube_pool_slab_carve(slab,size,alignment,&taken) ;
+	pPool->bytes_used += taken ;
+	if (!pPool->current) pPool->current = slab ;
+	return pNew ;
+}
+
+RubixCube * rubix_cube_pool_cube_solved(RubixCubePool * pPool) {
+	RubixCube * pNew ;
+
+	if ((pNew = (RubixCube *)pPool->free_cubes)) {
+		memcpy(&pPool->free_cubes,pNew,sizeof(void *)) ;
+	} else if (!(pNew = (RubixCube *)rubix_cube_pool_carve(pPool,sizeof(RubixCube),RUBIX_CUBE_POOL_ALIGNMENT))) {
+		return NULL ;
+	}
+	*pNew = rubix_cube_solved ;
+	return pNew ;
+}
+
+RubixCube * rubix_cube_pool_cube_scrambled(RubixCubePool * pPool, RubixCubeSeed seed) {
+	RubixCube * pNew = rubix_cube_pool_cube_solved(pPool) ;
+
+	if (pNew) *pNew = rubix_cube_generate_scrambled(seed) ;
+	return pNew ;
+}
+
+void rubix_cube_pool_cube_release(RubixCubePool * pPool, RubixCube * pRubix_cube) {
+	if (!pRubix_cube) return ;
+	memcpy(pRubix_cube,&pPool->free_cubes,sizeof(void *)) ;
+	pPool->free_cubes = pRubix_cube ;
+}
+
+RubixCube * rubix_cube_pool_cubes(RubixCubePool * pPool, size_t count) {
+	RubixCube * cubes ;
+
+	if (count > SIZE_MAX / sizeof(RubixCube)) return NULL ;
+	if (!(cubes = (RubixCube *)rubix_cube_pool_carve(pPool,sizeof(RubixCube) * count,RUBIX_CUBE_POOL_ALIGNMENT))) return NULL ;
+	for (size_t i = 0; i < count; ++i) cubes[i] = rubix_cube_solved ;
+	return cubes ;
+}
+
+RubixCubeFacelets * rubix_cube_pool_facelets(RubixCubePool * pPool, size_t count) {
+	RubixCubeFacelets * cubes ;
+
+	if (count > SIZE_MAX / sizeof(RubixCubeFacelets)) return NULL ;
+	if (!(cubes = (RubixCubeFacelets *)rubix_cube_pool_carve(pPool,sizeof(RubixCubeFacelets) * count,RUBIX_CUBE_POOL_ALIGNMENT))) return NULL ;
+	rubix_cube_facelets_fill_solved(cubes,count) ;
+	return cubes ;
+}
+
+RubixCubeScramble * rubix_cube_pool_scramble(RubixCubePool * pPool, RubixCubeSeed seed, size_t intensity) {
+	RubixCubePoolScramble ** link, * pNew ;
+
+	/* First fit, scrambles are nearly always the same few sizes */
+	for (link = &pPool->free_scrambles; *link; link = &(*link)->next) {
+		if ((*link)->scramble.capacity >= intensity) break ;
+	}
+
+	if ((pNew = *link)) {
+		*link = pNew->next ;
+	} else {
+		if (intensity > (SIZE_MAX - sizeof(RubixCubePoolScramble)) / sizeof(RubixCubeMove)) return NULL ;
+		if (!(pNew = (RubixCubePoolScramble *)rubix_cube_pool_carve(pPool,
+				sizeof(RubixCubePoolScramble) + sizeof(RubixCubeMove) * intensity,
+				__alignof__(RubixCubePoolScramble)))) return NULL ;
+		pNew->scramble.moves = pNew->moves ;
+		pNew->scramble.capacity = intensity ;
+	}
+	pNew->next = NULL ;
+
+	pNew->scramble.size = intensity ;
+	pNew->scramble.seed = seed ? seed : rubix_cube_generate_seed() ;
+	rubix_cube_generate_moves_from_seed(pNew->scramble.seed,pNew->scramble.size,pNew->scramble.moves) ;
+	return &pNew->scramble ;
+}
+
+void rubix_cube_pool_scramble_release(RubixCubePool * pPool, RubixCubeScramble * pScramble) {
+	RubixCubePoolScramble * block ;
+
+	if (!pScramble) return ;
+	block = (RubixCubePoolScramble *)((char *)pScramble - offsetof(RubixCubePoolScramble,scramble)) ;
+	block->next = pPool->free_scrambles ;
+	pPool->free_scrambles = block ;
+}
@@ -0,0 +1,90 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+/*
+ * Pools:
+ *
+ * A RubixCubePool hands out cubes and scrambles from big slabs instead of making a
+ * malloc() call (two for a scramble) for every object:
+ *
+ * 	slab: [ header | cube | cube | scramble + its moves | cube array ... | unused ]
+ *
+ * Objects are cut from the front of the unused part of the current slab, and a new
+ * slab is only allocated when that runs out. Single cubes and scrambles given back
+ * with the release functions go on free lists and are handed out again first, and
+ * rubix_cube_pool_reset() takes everything back at once, keeping the slabs for reuse.
+ * Nothing from a pool may be passed to rubix_cube_free() or rubix_cube_scramble_free().
+ *
+ * Cube arrays are aligned to RUBIX_CUBE_POOL_ALIGNMENT (a cache line) and contiguous,
+ * and a scramble's moves sit right after it in the same slab, so rubix_cube_notation_parse_into()
+ * must not be asked to grow one past its capacity.
+ *
+ * A pool is not thread safe, give each thread its own.
+ */
+
+#ifndef RUBIX_CUBE_POOL_H
+#define RUBIX_CUBE_POOL_H "rubix_cube_pool.h"
+
+#include "rubix_cube.h"
+#include "rubix_cube_facelet.h"
+
+#define RUBIX_CUBE_POOL_ALIGNMENT 	64
+#define RUBIX_CUBE_POOL_SLAB_SIZE 	(1 << 20)
+
+typedef struct rubix_cube_pool_slab RubixCubePoolSlab ;
+typedef struct rubix_cube_pool_scramble RubixCubePoolScramble ;
+
+typedef struct rubix_cube_pool {
+	RubixCubePoolSlab * 		slabs ;		/* first slab, in the order they were allocated */
+	RubixCubePoolSlab * 		current ;	/* the one objects are cut from */
+	size_t 				slab_size ;
+	void * 				free_cubes ;	/* released cubes, linked through their first bytes */
+	RubixCubePoolScramble * 	free_scrambles ;
+	size_t 				slab_count ;
+	size_t 				bytes_used ;	/* in all slabs since the last reset, alignment padding included */
+} RubixCubePool ;
+
+/* Return a pointer to a freshly allocated pool whose slabs are @slab_size bytes (0 for RUBIX_CUBE_POOL_SLAB_SIZE) */
+RubixCubePool * rubix_cube_pool_allocate(size_t slab_size) ;
+
+/* Free a pool, all of its slabs, and so everything it ever handed out */
+void rubix_cube_pool_free(RubixCubePool * pPool) ;
+
+/* Take back everything the pool handed out at once, the slabs are kept for what comes next */
+void rubix_cube_pool_reset(RubixCubePool * pPool) ;
+
+/* Return @size bytes aligned to @alignment (a power of two) from @pPool, NULL if out of memory */
+void * rubix_cube_pool_carve(RubixCubePool * pPool, size_t size, size_t alignment) ;
+
+/* Return a pointer to a solved / scrambled cube from @pPool, NULL if out of memory */
+RubixCube * rubix_cube_pool_cube_solved(RubixCubePool * pPool) ;
+RubixCube * rubix_cube_pool_cube_scrambled(RubixCubePool * pPool, RubixCubeSeed seed) ;
+
+/* Give a cube from rubix_cube_pool_cube_solved() or _scrambled() back to @pPool */
+void rubix_cube_pool_cube_release(RubixCubePool * pPool, RubixCube * pRubix_cube) ;
+
+/* Return @count contiguous solved cubes from @pPool, cache line aligned, only taken back by a reset */
+RubixCube * rubix_cube_pool_cubes(RubixCubePool * pPool, size_t count) ;
+RubixCubeFacelets * rubix_cube_pool_facelets(RubixCubePool * pPool, size_t count) ;
+
+/* Same as rubix_cube_scramble_allocate(), from @pPool, with the moves in the same block as the scramble */
+RubixCubeScramble * rubix_cube_pool_scramble(RubixCubePool * pPool, RubixCubeSeed seed, size_t intensity) ;
+
+/* Give a scramble from rubix_cube_pool_scramble() back to @pPool, a later one of at most its capacity reuses it */
+void rubix_cube_pool_scramble_release(RubixCubePool * pPool, RubixCubeScramble * pScramble) ;
+
+#endif // RUBIX_CUBE_POOL_H
@@ -0,0 +1,121 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+#include "rubix_cube_rank.h"
+
+/* n! for n < 12 */
+static const unsigned long rubix_cube_factorials[RUBIX_CUBE_EDGE_COUNT] = {
+	1, 1, 2, 6, 24, 120, 720, 5040, 40320, 362880, 3628800, 39916800
+} ;
+
+/* Lehmer code: for each position, how many later pieces are smaller, weighted by (count - 1 - i)! */
+static unsigned long rubix_cube_rank_permutation(const unsigned char * permutation, size_t count) {
+	unsigned long rank = 0 ;
+	for (size_t i = 0; i + 1 < count; ++i) {
+		unsigned long smaller = 0 ;
+		for (size_t j = i + 1; j < count; ++j) smaller += permutation[j] < permutation[i] ;
+		rank += smaller * rubix_cube_factorials[count - 1 - i] ;
+	}
+	return rank ;
+}
+
+static void rubix_cube_unrank_permutation(unsigned char * permutation, size_t count, unsigned long rank) {
+	unsigned char left[RUBIX_CUBE_EDGE_COUNT] ;
+	for (size_t i = 0; i < count; ++i) left[i] = (unsigned char)i ;
+
+	for (size_t i = 0; i < count; ++i) {
+		unsigned long weight = rubix_cube_factorials[count - 1 - i] ;
+		size_t digit = rank / weight ;
+		rank %= weight ;
+
+		permutation[i] = left[digit] ;
+		for (size_t j = digit; j + 1 < count - i; ++j) left[j] = left[j + 1] ;
+	}
+}
+
+/* The last orientation is left out, it is whatever makes the total a multiple of @base */
+static unsigned long rubix_cube_rank_orientation(const unsigned char * orientation, size_t count, unsigned base) {
+	unsigned long rank = 0 ;
+	for (size_t i = 0; i + 1 < count; ++i) rank = rank * base + orientation[i] ;
+	return rank ;
+}
+
+static void rubix_cube_unrank_orientation(unsigned char * orientation, size_t count, unsigned base, unsigned long rank) {
+	unsigned total = 0 ;
+	for (size_t i = count - 1; i > 0; --i) {
+		orientation[i - 1] = (unsigned char)(rank % base) ;
+		total += orientation[i - 1] ;
+		rank /= base ;
+	}
+	orientation[count - 1] = (unsigned char)((base - total % base) % base) ;
+}
+
+unsigned long rubix_cube_rank_corner_permutation(const RubixCubeCubie * pCubie) {
+	return rubix_cube_rank_permutation(pCubie->corner_permutation,RUBIX_CUBE_CORNER_COUNT) ;
+}
+
+unsigned long rubix_cube_rank_corner_orientation(const RubixCubeCubie * pCubie) {
+	return rubix_cube_rank_orientation(pCubie->corner_orientation,RUBIX_CUBE_CORNER_COUNT,3) ;
+}
+
+unsigned long rubix_cube_rank_edge_permutation(const RubixCubeCubie * pCubie) {
+	return rubix_cube_rank_permutation(pCubie->edge_permutation,RUBIX_CUBE_EDGE_COUNT) ;
+}
+
+unsigned long rubix_cube_rank_edge_orientation(const RubixCubeCubie * pCubie) {
+	return rubix_cube_rank_orientation(pCubie->edge_orientation,RUBIX_CUBE_EDGE_COUNT,2) ;
+}
+
+void rubix_cube_unrank_corner_permutation(RubixCubeCubie * pCubie, unsigned long rank) {
+	rubix_cube_unrank_permutation(pCubie->corner_permutation,RUBIX_CUBE_CORNER_COUNT,rank) ;
+}
+
+void rubix_cube_unrank_corner_orientation(RubixCubeCubie * pCubie, unsigned long rank) {
+	rubix_cube_unrank_orientation(pCubie->corner_orientation,RUBIX_CUBE_CORNER_COUNT,3,rank) ;
+}
+
+void rubix_cube_unrank_edge_permutation(RubixCubeCubie * pCubie, unsigned long rank) {
+	rubix_cube_unrank_permutation(pCubie->edge_permutation,RUBIX_CUBE_EDGE_COUNT,rank) ;
+}
+
+void rubix_cube_unrank_edge_orientation(RubixCubeCubie * pCubie, unsigned long rank) {
+	rubix_cube_unrank_orientation(pCubie->edge_orientation,RUBIX_CUBE_EDGE_COUNT,2,rank) ;
+}
+
+/* Colors fit in 3 bits, so 21 facelets pack into each word and 3 words hold the cube */
+unsigned long long rubix_cube_facelets_hash(const RubixCubeFacelets * pFacelets) {
+	unsigned long long words[3] = { 0 }, hash = 0 ;
+
+	for (size_t i = 0; i < RUBIX_CUBE_FACELET_COUNT; ++i) {
+		words[i / 21] = (words[i / 21] << 3) | (pFacelets->facelets[i] & 7) ;
+	}
+	for (size_t i = 0; i < 3; ++i) hash = rubix_cube_mix64(hash ^ words[i]) ;
+	return hash ;
+}
+
+unsigned long long rubix_cube_hash(RubixCube * pRubix_cube) {
+	RubixCubeFacelets facelets = rubix_cube_facelets_from_cube(pRubix_cube) ;
+	return rubix_cube_facelets_hash(&facelets) ;
+}
+
+unsigned long long rubix_cube_cubie_hash(const RubixCubeCubie * pCubie) {
+	unsigned long long corners = rubix_cube_rank_corner_permutation(pCubie) * RUBIX_CUBE_RANK_CORNER_ORIENTATION_COUNT +
+		rubix_cube_rank_corner_orientation(pCubie) ;
+	unsigned long long edges = rubix_cube_rank_edge_permutation(pCubie) * RUBIX_CUBE_RANK_EDGE_ORIENTATION_COUNT +
+		rubix_cube_rank_edge_orientation(pCubie) ;
+	return rubix_cube_mix64(rubix_cube_mix64(corners) ^ edges) ;
+}
@@ -0,0 +1,64 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Ranks and hashes:
+ *
+ * Each part of a cubie maps to a dense integer in [0, count) and back again:
+ *
+ * corner permutation 	8!	= 40320
+ * corner orientation 	3^7	= 2187		(the last corner's twist follows from the others)
+ * edge permutation 	12!	= 479001600
+ * edge orientation 	2^11	= 2048		(the last edge's flip follows from the others)
+ *
+ * which is what pruning tables and other flat arrays are indexed with. The whole cube
+ * group has about 4.3 * 10^19 states, a little more than fits in a 64 bit integer, so
+ * for sets and maps of whole cubes there is a 64 bit hash instead.
+ */
+
+#ifndef RUBIX_CUBE_RANK_H
+#define RUBIX_CUBE_RANK_H "rubix_cube_rank.h"
+
+#include "rubix_cube.h"
+#include "rubix_cube_cubie.h"
+#include "rubix_cube_facelet.h"
+
+#define RUBIX_CUBE_RANK_CORNER_PERMUTATION_COUNT 	40320UL
+#define RUBIX_CUBE_RANK_CORNER_ORIENTATION_COUNT 	2187UL
+#define RUBIX_CUBE_RANK_EDGE_PERMUTATION_COUNT 		479001600UL
+#define RUBIX_CUBE_RANK_EDGE_ORIENTATION_COUNT 		2048UL
+
+/* Rank one part of @pCubie, the solved cubie ranks 0 everywhere */
+unsigned long rubix_cube_rank_corner_permutation(const RubixCubeCubie * pCubie) ;
+unsigned long rubix_cube_rank_corner_orientation(const RubixCubeCubie * pCubie) ;
+unsigned long rubix_cube_rank_edge_permutation(const RubixCubeCubie * pCubie) ;
+unsigned long rubix_cube_rank_edge_orientation(const RubixCubeCubie * pCubie) ;
+
+/* Set one part of @pCubie from @rank, leaving the other parts alone */
+/* Permutation parities are not checked, so the result may not be reachable by face rotations */
+void rubix_cube_unrank_corner_permutation(RubixCubeCubie * pCubie, unsigned long rank) ;
+void rubix_cube_unrank_corner_orientation(RubixCubeCubie * pCubie, unsigned long rank) ;
+void rubix_cube_unrank_edge_permutation(RubixCubeCubie * pCubie, unsigned long rank) ;
+void rubix_cube_unrank_edge_orientation(RubixCubeCubie * pCubie, unsigned long rank) ;
+
+/* 64 bit hashes, equal states always hash equal */
+unsigned long long rubix_cube_hash(RubixCube * pRubix_cube) ;
+unsigned long long rubix_cube_facelets_hash(const RubixCubeFacelets * pFacelets) ;
+unsigned long long rubix_cube_cubie_hash(const RubixCubeCubie * pCubie) ;
+
+#endif // RUBIX_CUBE_RANK_H
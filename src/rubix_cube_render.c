@@ -0,0 +1,247 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+#include "rubix_cube_render.h"
+#include <string.h>
+#include <pthread.h>
+
+const char rubix_cube_face_format_string[] =
+ "+---+---+---+\n"
+ "| %c | %c | %c |\n"
+ "+---+---+---+\n"
+ "| %c | %c | %c |\n"
+ "+---+---+---+\n"
+ "| %c | %c | %c |\n"
+ "+---+---+---+\n" ;
+
+const char rubix_cube_half_cube_format_string[] =
+ " ====Rubix cube====\n"
+ "        +--+--+--+\n"
+ "  TOP  / %c/ %c/ %c/|\n"
+ "      +--+--+--+ |\n"
+ "     / %c/ %c/ %c/| |\n"
+ "    +--+--+--+ |%c|	\n"
+ "   / %c/ %c/ %c/|%c|/|   RIGHT\n"
+ "  +--+--+--+%c|/|%c/ \n"
+ "  | %c| %c| %c|/|%c|/|      	\n"
+ "  +--+--+--+%c|/|%c|      2 \n"
+ "  | %c| %c| %c|/|%c|/           _.\n"
+ "  +--+--+--+%c|/        1    /|\n"
+ "  | %c| %c| %c| /             /  \n"
+ "  +--+--+--+^         0   / Direction of array of rubix cube face arrays\n"
+ "      FRONT \n"
+ " \n"
+ " \n" ;
+
+const char rubix_cube_whole_cube_format_string[] =
+ " ==========================[The Rubix Cube]==========================\n"
+ "        +--+--+--+                       +--+--+--+                  \n"
+ "  TOP  / %c/ %c/ %c/|            BOTTOM    / %c/ %c/ %c/|            \n"
+ "      +--+--+--+ |                     +--+--+--+ |                  \n"
+ "     / %c/ %c/ %c/| |                    / %c/ %c/ %c/| |            \n"
+ "    +--+--+--+ |%c|	             +--+--+--+ |%c|	               \n"
+ "   / %c/ %c/ %c/|%c|/|   RIGHT          / %c/ %c/ %c/|%c|/|   BACK   \n"
+ "  +--+--+--+%c|/|%c/                 +--+--+--+%c|/|%c/              \n"
+ "  | %c| %c| %c|/|%c|/|      	   | %c| %c| %c|/|%c|/|      	       \n"
+ "  +--+--+--+%c|/|%c|      2          +--+--+--+%c|/|%c|              \n"
+ "  | %c| %c| %c|/|%c|/           _.     | %c| %c| %c|/|%c|/           \n"
+ "  +--+--+--+%c|/        1    /|     +--+--+--+%c|/                   \n"
+ "  | %c| %c| %c| /             /       | %c| %c| %c| /                \n"
+ "  +--+--+--+^         0   /        +--+--+--+^        0  1  2        \n"
+ "      FRONT                              LEFT       ------->         \n"
+ "                                                                     \n"
+ " ====================================================================\n"
+ "                                                                     \n" ;
+
+#define RUBIX_CUBE_RENDER_MAX_SQUARES 	(RUBIX_CUBE_SIDE_COUNT * RUBIX_CUBE_PIECES_PER_FACE)
+#define RUBIX_CUBE_RENDER_TEMPLATE_SIZE 	sizeof(rubix_cube_whole_cube_format_string)
+
+typedef struct rubix_cube_render_face_square {
+	unsigned char 			side ;
+	unsigned char 			square ;
+} RubixCubeRenderFaceSquare ;
+
+#define U(square) 	{ RUBIX_CUBE_SQUARE_TOP, square }
+#define F(square) 	{ RUBIX_CUBE_SQUARE_FRONT, square }
+#define R(square) 	{ RUBIX_CUBE_SQUARE_RIGHT, square }
+#define L(square) 	{ RUBIX_CUBE_SQUARE_LEFT, square }
+#define B(square) 	{ RUBIX_CUBE_SQUARE_BACK, square }
+#define D(square) 	{ RUBIX_CUBE_SQUARE_BOTTOM, square }
+
+/* Which face square each %c of the templates shows, in order */
+static const RubixCubeRenderFaceSquare rubix_cube_render_half_cube_order[] = {
+	U(0), U(1), U(2), U(3), U(4), U(5),
+	R(2), U(6), U(7), U(8), R(1), R(0), R(5),
+	F(0), F(1), F(2), R(4), R(3), R(8),
+	F(3), F(4), F(5), R(7), R(6),
+	F(6), F(7), F(8)
+} ;
+
+static const RubixCubeRenderFaceSquare rubix_cube_render_whole_cube_order[] = {
+	U(0), U(1), U(2), 	D(2), D(5), D(8),
+	U(3), U(4), U(5), 	D(1), D(4), D(7),
+	R(2), 			B(6),
+	U(6), U(7), U(8), R(1), D(0), D(3), D(6), B(1),
+	R(0), R(5), 		B(3), B(8),
+	F(0), F(1), F(2), R(4), L(8), L(7), L(6), B(4),
+	R(3), R(8), 		B(0), B(5),
+	F(3), F(4), F(5), R(7), L(5), L(4), L(3), B(5),
+	R(6), 			B(2),
+	F(6), F(7), F(8), 	L(2), L(1), L(0)
+} ;
+
+#undef U
+#undef F
+#undef R
+#undef L
+#undef B
+#undef D
+
+/* The pieces behind the squares of each face, as RUBIX_CUBE_GET_*_FACE() read them */
+static const RubixCubePieceReference rubix_cube_render_face_pieces[RUBIX_CUBE_SIDE_COUNT][RUBIX_CUBE_PIECES_PER_FACE] = {
+	/* TOP */ 	{ {2,0}, {2,1}, {2,2}, {1,0}, {1,1}, {1,2}, {0,0}, {0,1}, {0,2} },
+	/* FRONT */ 	{ {0,0}, {0,1}, {0,2}, {0,3}, {0,4}, {0,5}, {0,6}, {0,7}, {0,8} },
+	/* RIGHT */ 	{ {0,2}, {1,2}, {2,2}, {0,5}, {1,5}, {2,5}, {0,8}, {1,8}, {2,8} },
+	/* LEFT */ 	{ {2,0}, {1,0}, {0,0}, {2,3}, {1,3}, {0,3}, {2,6}, {1,6}, {0,6} },
+	/* BACK */ 	{ {2,2}, {2,1}, {2,0}, {2,5}, {2,4}, {2,3}, {2,8}, {2,7}, {2,6} },
+	/* BOTTOM */ 	{ {0,6}, {0,7}, {0,8}, {1,6}, {1,7}, {1,8}, {2,6}, {2,7}, {2,8} }
+} ;
+
+static const char * const rubix_cube_render_face_titles[RUBIX_CUBE_SIDE_COUNT] = {
+	"Top face:\n", "Front face:\n", "Right face:\n", "Left face:\n", "Back face:\n", "Bottom face:\n"
+} ;
+
+typedef struct rubix_cube_render_square {
+	unsigned short 			offset ;	/* in the rendered text */
+	unsigned short 			color ;		/* in the cube, taken as an array of RubixCubeColor */
+} RubixCubeRenderSquare ;
+
+typedef struct rubix_cube_render_template {
+	char 				text[RUBIX_CUBE_RENDER_TEMPLATE_SIZE] ;
+	size_t 				size ;
+	size_t 				number_of_squares ;
+	RubixCubeRenderSquare 		squares[RUBIX_CUBE_RENDER_MAX_SQUARES] ;
+} RubixCubeRenderTemplate ;
+
+static RubixCubeRenderTemplate rubix_cube_render_templates[RUBIX_CUBE_RENDER_LAYOUT_COUNT] ;
+static char rubix_cube_render_default_glyphs[RUBIX_CUBE_COLOR_YELLOW + 1] ;
+
+static pthread_once_t rubix_cube_render_templates_once = PTHREAD_ONCE_INIT ;
+static int rubix_cube_render_templates_ready ;
+
+/* Copy @format into @pTemplate with a placeholder for each %c, pointed at the squares in @order */
+static void rubix_cube_render_compile(RubixCubeRenderTemplate * pTemplate, const char * format, const RubixCubeRenderFaceSquare * order, size_t count) {
+	size_t squares = 0, size = 0 ;
+
+	for (const char * c = format; *c; ++c) {
+		if (c[0] == '%' && c[1] == 'c' && squares < count) {
+			const RubixCubeRenderFaceSquare * square = &order[squares] ;
+			const RubixCubePieceReference * piece = &rubix_cube_render_face_pieces[square->side][square->square] ;
+			pTemplate->squares[squares++] = (RubixCubeRenderSquare){
+				.offset 	= (unsigned short)size,
+				.color 		= (unsigned short)((piece->plane * RUBIX_CUBE_PIECES_PER_PLANE + piece->index) * RUBIX_CUBE_SIDE_COUNT + square->side)
+			} ;
+			pTemplate->text[size++] = ' ' ;
+			++c ;
+		}
+		else {
+			pTemplate->text[size++] = *c ;
+		}
+	}
+	pTemplate->size = size ;
+	pTemplate->number_of_squares = squares ;
+}
+
+static void rubix_cube_render_build_templates(void) {
+	RubixCubeRenderFaceSquare order[RUBIX_CUBE_PIECES_PER_FACE] ;
+
+	rubix_cube_render_compile(&rubix_cube_render_templates[RUBIX_CUBE_RENDER_HALF_CUBE],rubix_cube_half_cube_format_string,
+			rubix_cube_render_half_cube_order,sizeof(rubix_cube_render_half_cube_order) / sizeof(RubixCubeRenderFaceSquare)) ;
+	rubix_cube_render_compile(&rubix_cube_render_templates[RUBIX_CUBE_RENDER_WHOLE_CUBE],rubix_cube_whole_cube_format_string,
+			rubix_cube_render_whole_cube_order,sizeof(rubix_cube_render_whole_cube_order) / sizeof(RubixCubeRenderFaceSquare)) ;
+
+	for (size_t side = 0; side < RUBIX_CUBE_SIDE_COUNT; ++side) {
+		for (size_t square = 0; square < RUBIX_CUBE_PIECES_PER_FACE; ++square) {
+			order[square] = (RubixCubeRenderFaceSquare){ (unsigned char)side, (unsigned char)square } ;
+		}
+		rubix_cube_render_compile(&rubix_cube_render_templates[RUBIX_CUBE_RENDER_LAYOUT_FACE(side)],rubix_cube_face_format_string,
+				order,RUBIX_CUBE_PIECES_PER_FACE) ;
+	}
+
+	for (size_t color = 0; color < sizeof(rubix_cube_render_default_glyphs); ++color) {
+		rubix_cube_render_default_glyphs[color] = rubix_cube_get_char_of_color((RubixCubeColor)color) ;
+	}
+	__atomic_store_n(&rubix_cube_render_templates_ready,1,__ATOMIC_RELEASE) ;
+}
+
+/* Checked on every render, so skip the call into pthread_once once the templates exist */
+static inline void rubix_cube_render_init_templates(void) {
+	if (__builtin_expect(!__atomic_load_n(&rubix_cube_render_templates_ready,__ATOMIC_ACQUIRE),0)) {
+		pthread_once(&rubix_cube_render_templates_once,rubix_cube_render_build_templates) ;
+	}
+}
+
+size_t rubix_cube_render_size(RubixCubeRenderLayout layout) {
+	if ((size_t)layout >= RUBIX_CUBE_RENDER_LAYOUT_COUNT) return 0 ;
+	rubix_cube_render_init_templates() ;
+	return rubix_cube_render_templates[layout].size ;
+}
+
+static inline void rubix_cube_render_one(char * dest, const RubixCubeRenderTemplate * pTemplate, const RubixCube * pRubix_cube, const char * glyphs) {
+	const RubixCubeColor * colors = &pRubix_cube->planes[0][0].sides[0] ;
+
+	memcpy(dest,pTemplate->text,pTemplate->size) ;
+	for (size_t i = 0; i < pTemplate->number_of_squares; ++i) {
+		/* Out of range colors show as the null color rather than reading past @glyphs */
+		unsigned color = (unsigned)colors[pTemplate->squares[i].color] ;
+		dest[pTemplate->squares[i].offset] = glyphs[color <= RUBIX_CUBE_COLOR_YELLOW ? color : RUBIX_CUBE_COLOR_NULL] ;
+	}
+}
+
+size_t rubix_cube_render(char * dest, size_t size, RubixCubeRenderLayout layout, const RubixCube * pRubix_cube, const char * glyphs) {
+	return rubix_cube_render_batch(dest,size,layout,pRubix_cube,1,glyphs) ;
+}
+
+size_t rubix_cube_render_batch(char * dest, size_t size, RubixCubeRenderLayout layout, const RubixCube * cubes, size_t count, const char * glyphs) {
+	const RubixCubeRenderTemplate * pTemplate ;
+
+	if ((size_t)layout >= RUBIX_CUBE_RENDER_LAYOUT_COUNT) return 0 ;
+	rubix_cube_render_init_templates() ;
+	pTemplate = &rubix_cube_render_templates[layout] ;
+	if (!glyphs) glyphs = rubix_cube_render_default_glyphs ;
+	if (count > size / pTemplate->size) return 0 ;
+
+	for (size_t i = 0; i < count; ++i) rubix_cube_render_one(dest + i * pTemplate->size,pTemplate,&cubes[i],glyphs) ;
+	return count * pTemplate->size ;
+}
+
+size_t rubix_cube_render_all_faces(char * dest, size_t size, const RubixCube * pRubix_cube, const char * glyphs) {
+	size_t used = 0 ;
+
+	rubix_cube_render_init_templates() ;
+	if (!glyphs) glyphs = rubix_cube_render_default_glyphs ;
+	for (size_t side = 0; side < RUBIX_CUBE_SIDE_COUNT; ++side) {
+		const RubixCubeRenderTemplate * pTemplate = &rubix_cube_render_templates[RUBIX_CUBE_RENDER_LAYOUT_FACE(side)] ;
+		size_t title = strlen(rubix_cube_render_face_titles[side]) ;
+
+		if (size - used < title + pTemplate->size) return 0 ;
+		memcpy(dest + used,rubix_cube_render_face_titles[side],title) ;
+		rubix_cube_render_one(dest + used + title,pTemplate,pRubix_cube,glyphs) ;
+		used += title + pTemplate->size ;
+	}
+	return used ;
+}
@@ -0,0 +1,67 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+/*
+ * Rendering into buffers:
+ *
+ * The printf templates below are turned into plain text templates once, with one
+ * byte left for every %c, and a list of where each of those bytes goes and which
+ * piece side of the cube it shows. Rendering a cube is then a copy of the template
+ * and one table lookup per square, with no format string parsing and no faces built
+ * on the way. rubix_cube_print_ascii() and friends render this way too.
+ *
+ * Nothing is allocated, and nothing is NUL terminated: the functions return the number
+ * of bytes written, ready for a single fwrite() or write(), or 0 if @size is too small.
+ */
+
+#ifndef RUBIX_CUBE_RENDER_H
+#define RUBIX_CUBE_RENDER_H "rubix_cube_render.h"
+
+#include "rubix_cube.h"
+
+typedef enum rubix_cube_render_layout {
+	RUBIX_CUBE_RENDER_HALF_CUBE,	/* top, front and right, as rubix_cube_print_ascii() */
+	RUBIX_CUBE_RENDER_WHOLE_CUBE,	/* both halves side by side, as rubix_cube_print_ascii_double() */
+	RUBIX_CUBE_RENDER_FACE		/* + a square index, one face, as rubix_cube_print_face_ascii() */
+} RubixCubeRenderLayout ;
+
+#define RUBIX_CUBE_RENDER_LAYOUT_COUNT 	(RUBIX_CUBE_RENDER_FACE + RUBIX_CUBE_SIDE_COUNT)
+
+/* Face layout of square index @side */
+#define RUBIX_CUBE_RENDER_LAYOUT_FACE(side) 	((RubixCubeRenderLayout)(RUBIX_CUBE_RENDER_FACE + (side)))
+
+/* printf templates with one %c per square, in the order of the tables in rubix_cube_render.c */
+extern const char rubix_cube_face_format_string[] ;
+extern const char rubix_cube_half_cube_format_string[] ;
+extern const char rubix_cube_whole_cube_format_string[] ;
+
+/* Return the number of bytes one cube takes in @layout, 0 if there is no such layout */
+size_t rubix_cube_render_size(RubixCubeRenderLayout layout) ;
+
+/* Render @pRubix_cube in @layout into @dest, @glyphs maps each RubixCubeColor to a character, NULL for the usual letters */
+size_t rubix_cube_render(char * dest, size_t size, RubixCubeRenderLayout layout, const RubixCube * pRubix_cube, const char * glyphs) ;
+
+/* Render @count @cubes one after another into @dest, only if they all fit */
+size_t rubix_cube_render_batch(char * dest, size_t size, RubixCubeRenderLayout layout, const RubixCube * cubes, size_t count, const char * glyphs) ;
+
+/* Render every face with a title line over it, as rubix_cube_print_all_faces_ascii() */
+size_t rubix_cube_render_all_faces(char * dest, size_t size, const RubixCube * pRubix_cube, const char * glyphs) ;
+
+/* Largest rendering of a single cube, in any layout including all faces */
+#define RUBIX_CUBE_RENDER_MAX_SIZE 	8192
+
+#endif // RUBIX_CUBE_RENDER_H
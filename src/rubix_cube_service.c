@@ -0,0 +1,454 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+#define _GNU_SOURCE
+#include "rubix_cube_service.h"
+#include "rubix_cube_facelet.h"
+#include "rubix_cube_packed_scramble.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+
+/* Buckets below 8 ns are exact, past that each power of two is split in 8 */
+#define RUBIX_CUBE_SERVICE_SUB_BITS 		3
+#define RUBIX_CUBE_SERVICE_SUB_BUCKETS 		(1u << RUBIX_CUBE_SERVICE_SUB_BITS)
+
+/* Only the worker writes its counts, so a plain add published with a relaxed store is enough */
+#define RUBIX_CUBE_SERVICE_COUNT(counter, amount) \
+	__atomic_store_n(&(counter),(counter) + (amount),__ATOMIC_RELAXED)
+
+typedef struct rubix_cube_service_worker {
+	unsigned long long 		completed ;
+	unsigned long long 		batches ;
+	unsigned long long 		max ;
+	unsigned long long 		histogram[RUBIX_CUBE_SERVICE_HISTOGRAM_SIZE] ;
+	RubixCubeServiceRequest * 	requests ;	/* the batch being worked on */
+	RubixCubeFacelets * 		cubes ;		/* its moves, grouped by length */
+	unsigned char * 		codes ;
+	size_t * 			order ;
+	size_t 				index ;
+	RubixCubeService * 		pService ;
+	pthread_t 			thread ;
+} __attribute__((aligned(64))) RubixCubeServiceWorker ;
+
+struct rubix_cube_service {
+	RubixCubeServiceOptions 	options ;
+	pthread_mutex_t 		lock ;		/* around the queue and the counts kept with it */
+	pthread_cond_t 			ready ;
+	RubixCubeServiceRequest * 	queue ;
+	size_t 				head ;
+	size_t 				depth ;
+	size_t 				max_depth ;
+	unsigned long long 		submitted ;
+	unsigned long long 		rejected ;
+	int 				stopping ;
+	int 				joined ;	/* the workers are gone, see rubix_cube_service_drain() */
+	RubixCubeServiceWorker * 	workers ;
+	size_t 				number_of_workers ;
+} ;
+
+static unsigned long long rubix_cube_service_now(void) {
+	struct timespec now ;
+	clock_gettime(CLOCK_MONOTONIC,&now) ;
+	return (unsigned long long)now.tv_sec * 1000000000ull + (unsigned long long)now.tv_nsec ;
+}
+
+static inline size_t rubix_cube_service_bucket(unsigned long long nanoseconds) {
+	if (nanoseconds < RUBIX_CUBE_SERVICE_SUB_BUCKETS) return (size_t)nanoseconds ;
+	size_t power = 63 - (size_t)__builtin_clzll(nanoseconds) ;
+	return (power - RUBIX_CUBE_SERVICE_SUB_BITS + 1) * RUBIX_CUBE_SERVICE_SUB_BUCKETS +
+	       (size_t)((nanoseconds >> (power - RUBIX_CUBE_SERVICE_SUB_BITS)) & (RUBIX_CUBE_SERVICE_SUB_BUCKETS - 1)) ;
+}
+
+/* The largest latency that lands in @bucket */
+static inline unsigned long long rubix_cube_service_bucket_limit(size_t bucket) {
+	if (bucket < RUBIX_CUBE_SERVICE_SUB_BUCKETS) return bucket ;
+	size_t shift = bucket / RUBIX_CUBE_SERVICE_SUB_BUCKETS - 1 ;
+	unsigned long long low = (unsigned long long)(RUBIX_CUBE_SERVICE_SUB_BUCKETS + bucket % RUBIX_CUBE_SERVICE_SUB_BUCKETS) << shift ;
+	return low + ((1ull << shift) - 1) ;
+}
+
+static void rubix_cube_service_respond(RubixCubeServiceWorker * pWorker, const RubixCubeServiceRequest * pRequest, RubixCubeServiceResponse * pResponse) {
+	const RubixCubeServiceOptions * pOptions = &pWorker->pService->options ;
+	unsigned long long nanoseconds = rubix_cube_service_now() - pRequest->submitted ;
+	size_t bucket = rubix_cube_service_bucket(nanoseconds) ;
+
+	pResponse->id = pRequest->id ;
+	pResponse->kind = pRequest->kind ;
+	pResponse->owner = pRequest->owner ;
+	pResponse->nanoseconds = nanoseconds ;
+	RUBIX_CUBE_SERVICE_COUNT(pWorker->histogram[bucket],1) ;
+	if (nanoseconds > pWorker->max) __atomic_store_n(&pWorker->max,nanoseconds,__ATOMIC_RELAXED) ;
+	RUBIX_CUBE_SERVICE_COUNT(pWorker->completed,1) ;
+	pOptions->callback(pResponse,pOptions->context) ;
+}
+
+static void rubix_cube_service_solve(RubixCubeServiceWorker * pWorker, const RubixCubeServiceRequest * pRequest) {
+	RubixCubeTwoPhaseLimits limits = pWorker->pService->options.limits ;
+	RubixCubeServiceResponse response = { .status = RUBIX_CUBE_SERVICE_INVALID } ;
+	RubixCubeCubie cubie ;
+
+	if (pRequest->target_length) limits.target_length = pRequest->target_length ;
+	if (pRequest->microseconds && (double)pRequest->microseconds * 1e-6 < limits.seconds) limits.seconds = (double)pRequest->microseconds * 1e-6 ;
+
+	if (rubix_cube_unpack_cubie(&cubie,&pRequest->state)) {
+		RubixCubeScramble * pSolution = rubix_cube_two_phase_solve_cubie(&cubie,&limits) ;
+		response.status = RUBIX_CUBE_SERVICE_UNSOLVED ;
+		if (pSolution && pSolution->size <= RUBIX_CUBE_SERVICE_MAX_CODES) {
+			rubix_cube_moves_encode(response.codes,pSolution->moves,pSolution->size) ;
+			response.count = pSolution->size ;
+			response.status = RUBIX_CUBE_SERVICE_OK ;
+		}
+		if (pSolution) rubix_cube_scramble_free(pSolution) ;
+	}
+	rubix_cube_service_respond(pWorker,pRequest,&response) ;
+}
+
+static int rubix_cube_service_codes_valid(const RubixCubeServiceRequest * pRequest) {
+	if (pRequest->count > RUBIX_CUBE_SERVICE_MAX_CODES) return 0 ;
+	for (size_t i = 0; i < pRequest->count; ++i) {
+		if (pRequest->codes[i] >= RUBIX_CUBE_MOVE_COUNT) return 0 ;
+	}
+	return 1 ;
+}
+
+/* Apply the moves of the @count requests at @order, which all have the same number of them, in one call */
+static void rubix_cube_service_apply_rows(RubixCubeServiceWorker * pWorker, const size_t * order, size_t count) {
+	size_t moves = pWorker->requests[order[0]].count ;
+
+	for (size_t i = 0; i < count; ++i) {
+		const RubixCubeServiceRequest * pRequest = &pWorker->requests[order[i]] ;
+		RubixCubeCubie cubie ;
+		RubixCube cube ;
+
+		rubix_cube_unpack_cubie(&cubie,&pRequest->state) ;
+		cube = rubix_cube_cubie_to_cube(&cubie) ;
+		pWorker->cubes[i] = rubix_cube_facelets_from_cube(&cube) ;
+		memcpy(&pWorker->codes[i * moves],pRequest->codes,moves) ;
+	}
+	if (moves) rubix_cube_facelets_apply_codes_rows(pWorker->cubes,count,pWorker->codes,moves) ;
+
+	for (size_t i = 0; i < count; ++i) {
+		RubixCubeServiceResponse response = { .status = RUBIX_CUBE_SERVICE_OK } ;
+		RubixCube cube = rubix_cube_facelets_to_cube(&pWorker->cubes[i]) ;
+
+		rubix_cube_pack(&response.state,&cube) ;
+		rubix_cube_service_respond(pWorker,&pWorker->requests[order[i]],&response) ;
+	}
+}
+
+static void rubix_cube_service_process(RubixCubeServiceWorker * pWorker, size_t count) {
+	size_t applies = 0 ;
+
+	for (size_t i = 0; i < count; ++i) {
+		const RubixCubeServiceRequest * pRequest = &pWorker->requests[i] ;
+		RubixCubeServiceResponse response = { .status = RUBIX_CUBE_SERVICE_BAD_REQUEST } ;
+		RubixCubeCubie cubie ;
+
+		if (pRequest->kind == RUBIX_CUBE_SERVICE_SOLVE) {
+			rubix_cube_service_solve(pWorker,pRequest) ;
+			continue ;
+		}
+		if (pRequest->kind == RUBIX_CUBE_SERVICE_APPLY) {
+			if (rubix_cube_service_codes_valid(pRequest) && rubix_cube_unpack_cubie(&cubie,&pRequest->state)) {
+				/* Kept sorted by length, so equal lengths end up next to each other */
+				size_t j = applies++ ;
+				for (; j > 0 && pWorker->requests[pWorker->order[j - 1]].count > pRequest->count; --j) pWorker->order[j] = pWorker->order[j - 1] ;
+				pWorker->order[j] = i ;
+				continue ;
+			}
+			response.status = RUBIX_CUBE_SERVICE_INVALID ;
+		}
+		rubix_cube_service_respond(pWorker,pRequest,&response) ;
+	}
+
+	for (size_t begin = 0, end; begin < applies; begin = end) {
+		size_t moves = pWorker->requests[pWorker->order[begin]].count ;
+		for (end = begin + 1; end < applies && pWorker->requests[pWorker->order[end]].count == moves; ++end) ;
+		rubix_cube_service_apply_rows(pWorker,&pWorker->order[begin],end - begin) ;
+	}
+	RUBIX_CUBE_SERVICE_COUNT(pWorker->batches,1) ;
+}
+
+static void * rubix_cube_service_work(void * argument) {
+	RubixCubeServiceWorker * pWorker = (RubixCubeServiceWorker *)argument ;
+	RubixCubeService * pService = pWorker->pService ;
+
+	if (pService->options.pin) {
+		long online = sysconf(_SC_NPROCESSORS_ONLN) ;
+		cpu_set_t cpus ;
+
+		/* Best effort, a worker that cannot be pinned just runs wherever */
+		CPU_ZERO(&cpus) ;
+		CPU_SET((int)(pWorker->index % (size_t)(online > 0 ? online : 1)),&cpus) ;
+		pthread_setaffinity_np(pthread_self(),sizeof(cpus),&cpus) ;
+	}
+
+	for (;;) {
+		size_t count = 0 ;
+
+		pthread_mutex_lock(&pService->lock) ;
+		while (!pService->depth && !pService->stopping) pthread_cond_wait(&pService->ready,&pService->lock) ;
+		while (pService->depth && count < pService->options.batch) {
+			pWorker->requests[count++] = pService->queue[pService->head] ;
+			pService->head = (pService->head + 1) % pService->options.queue_capacity ;
+			--pService->depth ;
+		}
+		/* Leave the rest of a burst to the next worker instead of waiting for this batch */
+		if (pService->depth) pthread_cond_signal(&pService->ready) ;
+		pthread_mutex_unlock(&pService->lock) ;
+
+		if (!count) break ;
+		rubix_cube_service_process(pWorker,count) ;
+	}
+	return NULL ;
+}
+
+static void rubix_cube_service_free(RubixCubeService * pService) {
+	for (size_t i = 0; i < pService->number_of_workers; ++i) {
+		free(pService->workers[i].requests) ;
+		free(pService->workers[i].cubes) ;
+		free(pService->workers[i].codes) ;
+		free(pService->workers[i].order) ;
+	}
+	pthread_cond_destroy(&pService->ready) ;
+	pthread_mutex_destroy(&pService->lock) ;
+	free(pService->workers) ;
+	free(pService->queue) ;
+	free(pService) ;
+}
+
+/* Wake every worker and wait for the first @started of them to finish what is queued */
+static void rubix_cube_service_join(RubixCubeService * pService, size_t started) {
+	pthread_mutex_lock(&pService->lock) ;
+	pService->stopping = 1 ;
+	pthread_cond_broadcast(&pService->ready) ;
+	pthread_mutex_unlock(&pService->lock) ;
+	for (size_t i = 0; i < started; ++i) pthread_join(pService->workers[i].thread,NULL) ;
+}
+
+RubixCubeService * rubix_cube_service_start(const RubixCubeServiceOptions * pOptions) {
+	RubixCubeServiceOptions options = pOptions ? *pOptions : RUBIX_CUBE_SERVICE_DEFAULT_OPTIONS ;
+	RubixCubeService * pService ;
+	size_t started = 0 ;
+	int failed = 0 ;
+
+	if (!options.callback) return NULL ;
+	if (!options.queue_capacity) options.queue_capacity = RUBIX_CUBE_SERVICE_QUEUE_CAPACITY ;
+	if (!options.batch) options.batch = RUBIX_CUBE_SERVICE_BATCH ;
+	if (!options.limits.max_length) options.limits = RUBIX_CUBE_SERVICE_DEFAULT_OPTIONS.limits ;
+	if (!options.threads) {
+		long online = sysconf(_SC_NPROCESSORS_ONLN) ;
+		options.threads = online > 0 ? (size_t)online : 1 ;
+	}
+
+	if (!(pService = (RubixCubeService *)calloc(1,sizeof(RubixCubeService)))) return NULL ;
+	pService->options = options ;
+	pService->queue = (RubixCubeServiceRequest *)malloc(options.queue_capacity * sizeof(RubixCubeServiceRequest)) ;
+	if (posix_memalign((void **)&pService->workers,64,options.threads * sizeof(RubixCubeServiceWorker))) pService->workers = NULL ;
+	pthread_mutex_init(&pService->lock,NULL) ;
+	pthread_cond_init(&pService->ready,NULL) ;
+	if (!pService->queue || !pService->workers) {
+		rubix_cube_service_free(pService) ;
+		return NULL ;
+	}
+	memset(pService->workers,0,options.threads * sizeof(RubixCubeServiceWorker)) ;
+	pService->number_of_workers = options.threads ;
+
+	/* Built now, so the first requests do not wait for it */
+	rubix_cube_two_phase_init() ;
+
+	for (size_t i = 0; i < options.threads; ++i) {
+		RubixCubeServiceWorker * pWorker = &pService->workers[i] ;
+		pWorker->index = i ;
+		pWorker->pService = pService ;
+		pWorker->requests = (RubixCubeServiceRequest *)malloc(options.batch * sizeof(RubixCubeServiceRequest)) ;
+		pWorker->codes = (unsigned char *)malloc(options.batch * RUBIX_CUBE_SERVICE_MAX_CODES) ;
+		pWorker->order = (size_t *)malloc(options.batch * sizeof(size_t)) ;
+		if (posix_memalign((void **)&pWorker->cubes,RUBIX_CUBE_FACELET_STRIDE,options.batch * sizeof(RubixCubeFacelets))) pWorker->cubes = NULL ;
+		failed |= !pWorker->requests || !pWorker->codes || !pWorker->order || !pWorker->cubes ;
+	}
+	while (!failed && started < options.threads) {
+		if (pthread_create(&pService->workers[started].thread,NULL,rubix_cube_service_work,&pService->workers[started])) failed = 1 ;
+		else ++started ;
+	}
+	if (failed) {
+		rubix_cube_service_join(pService,started) ;
+		rubix_cube_service_free(pService) ;
+		return NULL ;
+	}
+	return pService ;
+}
+
+int rubix_cube_service_submit(RubixCubeService * pService, const RubixCubeServiceRequest * pRequest) {
+	int queued = 0 ;
+
+	pthread_mutex_lock(&pService->lock) ;
+	if (pService->stopping) {
+		/* not counted, the service is going away */
+	} else if (pService->depth == pService->options.queue_capacity) {
+		++pService->rejected ;
+	} else {
+		RubixCubeServiceRequest * pQueued = &pService->queue[(pService->head + pService->depth) % pService->options.queue_capacity] ;
+		*pQueued = *pRequest ;
+		pQueued->submitted = rubix_cube_service_now() ;
+		++pService->submitted ;
+		if (++pService->depth > pService->max_depth) pService->max_depth = pService->depth ;
+		pthread_cond_signal(&pService->ready) ;
+		queued = 1 ;
+	}
+	pthread_mutex_unlock(&pService->lock) ;
+	return queued ;
+}
+
+void rubix_cube_service_stats(RubixCubeService * pService, RubixCubeServiceStats * pStats) {
+	unsigned long long histogram[RUBIX_CUBE_SERVICE_HISTOGRAM_SIZE] = { 0 } ;
+	unsigned long long * percentiles[] = { &pStats->p50, &pStats->p90, &pStats->p99, &pStats->p999 } ;
+	const double quantiles[] = { 0.5, 0.9, 0.99, 0.999 } ;
+	unsigned long long total = 0 ;
+
+	memset(pStats,0,sizeof(*pStats)) ;
+	pthread_mutex_lock(&pService->lock) ;
+	pStats->submitted = pService->submitted ;
+	pStats->rejected = pService->rejected ;
+	pStats->queue_depth = pService->depth ;
+	pStats->max_queue_depth = pService->max_depth ;
+	pthread_mutex_unlock(&pService->lock) ;
+
+	for (size_t w = 0; w < pService->number_of_workers; ++w) {
+		RubixCubeServiceWorker * pWorker = &pService->workers[w] ;
+		unsigned long long max = __atomic_load_n(&pWorker->max,__ATOMIC_RELAXED) ;
+
+		pStats->completed += __atomic_load_n(&pWorker->completed,__ATOMIC_RELAXED) ;
+		pStats->batches += __atomic_load_n(&pWorker->batches,__ATOMIC_RELAXED) ;
+		pStats->max = max > pStats->max ? max : pStats->max ;
+		for (size_t i = 0; i < RUBIX_CUBE_SERVICE_HISTOGRAM_SIZE; ++i) histogram[i] += __atomic_load_n(&pWorker->histogram[i],__ATOMIC_RELAXED) ;
+	}
+	for (size_t i = 0; i < RUBIX_CUBE_SERVICE_HISTOGRAM_SIZE; ++i) total += histogram[i] ;
+
+	for (size_t p = 0; total && p < sizeof(quantiles) / sizeof(*quantiles); ++p) {
+		unsigned long long rank = (unsigned long long)(quantiles[p] * (double)total), seen = 0 ;
+		size_t bucket = 0 ;
+
+		if (rank < 1) rank = 1 ;
+		while ((seen += histogram[bucket]) < rank) ++bucket ;
+		*percentiles[p] = rubix_cube_service_bucket_limit(bucket) ;
+		if (*percentiles[p] > pStats->max) *percentiles[p] = pStats->max ;
+	}
+}
+
+void rubix_cube_service_drain(RubixCubeService * pService) {
+	if (!pService || pService->joined) return ;
+	rubix_cube_service_join(pService,pService->number_of_workers) ;
+	pService->joined = 1 ;
+}
+
+void rubix_cube_service_stop(RubixCubeService * pService) {
+	if (!pService) return ;
+	rubix_cube_service_drain(pService) ;
+	rubix_cube_service_free(pService) ;
+}
+
+static inline void rubix_cube_service_put(unsigned char * bytes, unsigned long long value, size_t size) {
+	for (size_t i = 0; i < size; ++i) bytes[i] = (unsigned char)(value >> (8 * i)) ;
+}
+
+static inline unsigned long long rubix_cube_service_get(const unsigned char * bytes, size_t size) {
+	unsigned long long value = 0 ;
+	for (size_t i = 0; i < size; ++i) value |= (unsigned long long)bytes[i] << (8 * i) ;
+	return value ;
+}
+
+size_t rubix_cube_service_decode_request(RubixCubeServiceRequest * pRequest, const unsigned char * bytes, size_t size) {
+	if (size < RUBIX_CUBE_SERVICE_REQUEST_SIZE || size < RUBIX_CUBE_SERVICE_REQUEST_SIZE + bytes[9]) return 0 ;
+
+	memset(pRequest,0,sizeof(*pRequest)) ;
+	pRequest->id = rubix_cube_service_get(bytes,8) ;
+	pRequest->kind = bytes[8] ;
+	pRequest->count = bytes[9] ;
+	pRequest->target_length = bytes[10] ;
+	pRequest->microseconds = (unsigned long)rubix_cube_service_get(&bytes[12],4) ;
+	memcpy(pRequest->state.bytes,&bytes[16],RUBIX_CUBE_PACKED_SIZE) ;
+	memcpy(pRequest->codes,&bytes[RUBIX_CUBE_SERVICE_REQUEST_SIZE],pRequest->count) ;
+	return RUBIX_CUBE_SERVICE_REQUEST_SIZE + pRequest->count ;
+}
+
+size_t rubix_cube_service_encode_request(unsigned char * bytes, const RubixCubeServiceRequest * pRequest) {
+	size_t count = pRequest->count < RUBIX_CUBE_SERVICE_MAX_CODES ? pRequest->count : RUBIX_CUBE_SERVICE_MAX_CODES ;
+
+	rubix_cube_service_put(bytes,pRequest->id,8) ;
+	bytes[8] = (unsigned char)pRequest->kind ;
+	bytes[9] = (unsigned char)count ;
+	bytes[10] = (unsigned char)(pRequest->target_length < 255 ? pRequest->target_length : 255) ;
+	bytes[11] = 0 ;
+	rubix_cube_service_put(&bytes[12],pRequest->microseconds < 0xffffffffUL ? pRequest->microseconds : 0xffffffffUL,4) ;
+	memcpy(&bytes[16],pRequest->state.bytes,RUBIX_CUBE_PACKED_SIZE) ;
+	memcpy(&bytes[RUBIX_CUBE_SERVICE_REQUEST_SIZE],pRequest->codes,count) ;
+	return RUBIX_CUBE_SERVICE_REQUEST_SIZE + count ;
+}
+
+static size_t rubix_cube_service_encode_header(unsigned char * bytes, unsigned long long id, unsigned kind, unsigned status,
+		size_t count, unsigned long long nanoseconds) {
+	unsigned long long microseconds = nanoseconds / 1000 ;
+
+	rubix_cube_service_put(bytes,id,8) ;
+	bytes[8] = (unsigned char)kind ;
+	bytes[9] = (unsigned char)status ;
+	bytes[10] = (unsigned char)count ;
+	bytes[11] = 0 ;
+	rubix_cube_service_put(&bytes[12],microseconds < 0xffffffffULL ? microseconds : 0xffffffffULL,4) ;
+	return RUBIX_CUBE_SERVICE_RESPONSE_SIZE + count ;
+}
+
+size_t rubix_cube_service_encode_response(unsigned char * bytes, const RubixCubeServiceResponse * pResponse) {
+	unsigned char * payload = &bytes[RUBIX_CUBE_SERVICE_RESPONSE_SIZE] ;
+	size_t count = 0 ;
+
+	if (pResponse->status == RUBIX_CUBE_SERVICE_OK && pResponse->kind == RUBIX_CUBE_SERVICE_APPLY) {
+		memcpy(payload,pResponse->state.bytes,RUBIX_CUBE_PACKED_SIZE) ;
+		count = RUBIX_CUBE_PACKED_SIZE ;
+	} else if (pResponse->status == RUBIX_CUBE_SERVICE_OK) {
+		count = pResponse->count < RUBIX_CUBE_SERVICE_MAX_CODES ? pResponse->count : RUBIX_CUBE_SERVICE_MAX_CODES ;
+		memcpy(payload,pResponse->codes,count) ;
+	}
+	return rubix_cube_service_encode_header(bytes,pResponse->id,pResponse->kind,pResponse->status,count,pResponse->nanoseconds) ;
+}
+
+size_t rubix_cube_service_encode_stats(unsigned char * bytes, unsigned long long id, const RubixCubeServiceStats * pStats) {
+	const unsigned long long * words = (const unsigned long long *)pStats ;
+
+	for (size_t i = 0; i < RUBIX_CUBE_SERVICE_STATS_WORDS; ++i) rubix_cube_service_put(&bytes[RUBIX_CUBE_SERVICE_RESPONSE_SIZE + 8 * i],words[i],8) ;
+	return rubix_cube_service_encode_header(bytes,id,RUBIX_CUBE_SERVICE_STATS,RUBIX_CUBE_SERVICE_OK,8 * RUBIX_CUBE_SERVICE_STATS_WORDS,0) ;
+}
+
+size_t rubix_cube_service_decode_response(RubixCubeServiceResponse * pResponse, const unsigned char * bytes, size_t size) {
+	if (size < RUBIX_CUBE_SERVICE_RESPONSE_SIZE || size < RUBIX_CUBE_SERVICE_RESPONSE_SIZE + bytes[10]) return 0 ;
+
+	memset(pResponse,0,sizeof(*pResponse)) ;
+	pResponse->id = rubix_cube_service_get(bytes,8) ;
+	pResponse->kind = bytes[8] ;
+	pResponse->status = bytes[9] ;
+	pResponse->count = bytes[10] ;
+	pResponse->nanoseconds = rubix_cube_service_get(&bytes[12],4) * 1000 ;
+	memcpy(pResponse->codes,&bytes[RUBIX_CUBE_SERVICE_RESPONSE_SIZE],pResponse->count) ;
+	if (pResponse->kind == RUBIX_CUBE_SERVICE_APPLY && pResponse->count == RUBIX_CUBE_PACKED_SIZE) memcpy(pResponse->state.bytes,pResponse->codes,RUBIX_CUBE_PACKED_SIZE) ;
+	return RUBIX_CUBE_SERVICE_RESPONSE_SIZE + pResponse->count ;
+}
@@ -0,0 +1,180 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+/*
+ * Solver service:
+ *
+ * Requests are queued from any thread and handled by a fixed pool of workers, one per
+ * online cpu unless told otherwise, each pinned to a cpu of its own. A worker that wakes
+ * up takes everything queued, up to @batch requests, so under a burst the cost of the
+ * lock and the wake up is shared by the whole batch:
+ *
+ * 	RUBIX_CUBE_SERVICE_SOLVE 	a two phase solve of the packed state, within the
+ * 					request's own time budget and target length
+ * 	RUBIX_CUBE_SERVICE_APPLY 	the request's move codes applied to the packed state,
+ * 					the batch's requests with the same number of moves
+ * 					going through rubix_cube_facelets_apply_codes_rows()
+ * 					together
+ *
+ * Each response goes to the callback from the worker that made it, as soon as its batch
+ * is done, so responses come back in no particular order and are matched to requests by
+ * @id. The service counts what it has done per worker, without locks, and keeps a
+ * latency histogram (8 buckets per power of two nanoseconds, so good to 12.5%) from
+ * which rubix_cube_service_stats() reads the percentiles.
+ *
+ * The wire format the daemon (src/rubixd.c) speaks is defined here too, so that
+ * clients can link the same code. Everything on the wire is little endian:
+ *
+ * 	request 	[ id 8 | kind 1 | count 1 | target length 1 | 0 | microseconds 4 | packed state 16 ] [ count move codes ]
+ * 	response 	[ id 8 | kind 1 | status 1 | count 1 | 0 | microseconds 4 ] [ count bytes ]
+ *
+ * where a response carries the solution's move codes, the new packed state, or for
+ * RUBIX_CUBE_SERVICE_STATS the RUBIX_CUBE_SERVICE_STATS_WORDS words of
+ * RubixCubeServiceStats in order, 8 bytes each. Its microseconds are how long the
+ * request took from submission, and a zero target length or time budget in a request
+ * means its default.
+ */
+
+#ifndef RUBIX_CUBE_SERVICE_H
+#define RUBIX_CUBE_SERVICE_H "rubix_cube_service.h"
+
+#include "rubix_cube.h"
+#include "rubix_cube_storage.h"
+#include "rubix_cube_two_phase.h"
+
+/* Request kinds */
+#define RUBIX_CUBE_SERVICE_SOLVE 		0
+#define RUBIX_CUBE_SERVICE_APPLY 		1
+#define RUBIX_CUBE_SERVICE_STATS 		2	/* answered by whoever reads the request, never queued */
+
+/* Response statuses */
+#define RUBIX_CUBE_SERVICE_OK 			0
+#define RUBIX_CUBE_SERVICE_INVALID 		1	/* not a reachable state, or a bad move code */
+#define RUBIX_CUBE_SERVICE_UNSOLVED 		2	/* no solution within the request's limits */
+#define RUBIX_CUBE_SERVICE_BUSY 		3	/* the queue was full */
+#define RUBIX_CUBE_SERVICE_BAD_REQUEST 		4	/* an unknown kind */
+
+#define RUBIX_CUBE_SERVICE_MAX_CODES 		255
+#define RUBIX_CUBE_SERVICE_REQUEST_SIZE 	32
+#define RUBIX_CUBE_SERVICE_RESPONSE_SIZE 	16
+
+/* Defaults for options left 0 */
+#define RUBIX_CUBE_SERVICE_QUEUE_CAPACITY 	4096
+#define RUBIX_CUBE_SERVICE_BATCH 		64
+#define RUBIX_CUBE_SERVICE_MICROSECONDS 	50000
+
+#define RUBIX_CUBE_SERVICE_HISTOGRAM_SIZE 	496
+
+typedef struct rubix_cube_service_request {
+	unsigned long long 		id ;
+	unsigned 			kind ;
+	RubixCubePacked 		state ;
+	size_t 				count ;					/* move codes for RUBIX_CUBE_SERVICE_APPLY */
+	unsigned char 			codes[RUBIX_CUBE_SERVICE_MAX_CODES] ;
+	size_t 				target_length ;				/* for RUBIX_CUBE_SERVICE_SOLVE, 0 for the default */
+	unsigned long 			microseconds ;				/* the same */
+	void * 				owner ;					/* handed back with the response */
+	unsigned long long 		submitted ;				/* set by rubix_cube_service_submit() */
+} RubixCubeServiceRequest ;
+
+typedef struct rubix_cube_service_response {
+	unsigned long long 		id ;
+	unsigned 			kind ;
+	unsigned 			status ;
+	RubixCubePacked 		state ;					/* the new state for RUBIX_CUBE_SERVICE_APPLY */
+	size_t 				count ;					/* and the solution for RUBIX_CUBE_SERVICE_SOLVE */
+	unsigned char 			codes[RUBIX_CUBE_SERVICE_MAX_CODES] ;
+	unsigned long long 		nanoseconds ;				/* since the request was submitted */
+	void * 				owner ;
+} RubixCubeServiceResponse ;
+
+/* Called from the worker threads, any number at a time */
+typedef void (*RubixCubeServiceCallback)(const RubixCubeServiceResponse * pResponse, void * context) ;
+
+typedef struct rubix_cube_service_options {
+	size_t 				threads ;	/* 0 for one per online cpu */
+	size_t 				queue_capacity ;
+	size_t 				batch ;		/* most requests a worker takes at once */
+	int 				pin ;		/* nonzero to pin worker i to cpu i */
+	RubixCubeTwoPhaseLimits 	limits ;	/* for solves, a request may lower @target_length and @seconds */
+	RubixCubeServiceCallback 	callback ;
+	void * 				context ;
+} RubixCubeServiceOptions ;
+
+#define RUBIX_CUBE_SERVICE_DEFAULT_OPTIONS \
+	(RubixCubeServiceOptions) { \
+		.pin 		= 1, \
+		.limits 	= { \
+			.max_length 	= RUBIX_CUBE_TWO_PHASE_MAX_LENGTH, \
+			.target_length 	= 22, \
+			.seconds 	= RUBIX_CUBE_SERVICE_MICROSECONDS * 1e-6 \
+		} \
+	}
+
+typedef struct rubix_cube_service_stats {
+	unsigned long long 		submitted ;
+	unsigned long long 		rejected ;	/* the queue was full */
+	unsigned long long 		completed ;
+	unsigned long long 		batches ;
+	unsigned long long 		queue_depth ;	/* right now */
+	unsigned long long 		max_queue_depth ;
+	unsigned long long 		p50 ;		/* latency percentiles in nanoseconds, from queueing to the callback */
+	unsigned long long 		p90 ;
+	unsigned long long 		p99 ;
+	unsigned long long 		p999 ;
+	unsigned long long 		max ;
+} RubixCubeServiceStats ;
+
+#define RUBIX_CUBE_SERVICE_STATS_WORDS 		(sizeof(RubixCubeServiceStats) / sizeof(unsigned long long))
+
+typedef struct rubix_cube_service RubixCubeService ;
+
+/* Build the solver tables if needed and start the workers, NULL for the default options */
+/* Return NULL if @pOptions has no callback or the workers could not be started */
+RubixCubeService * rubix_cube_service_start(const RubixCubeServiceOptions * pOptions) ;
+
+/* Queue a copy of @pRequest, return nonzero if it was queued, 0 if the queue is full or the service is stopping */
+/* Requests of an unknown kind are queued too, and answered with RUBIX_CUBE_SERVICE_BAD_REQUEST */
+int rubix_cube_service_submit(RubixCubeService * pService, const RubixCubeServiceRequest * pRequest) ;
+
+/* Fill @pStats with the counts and latencies so far */
+void rubix_cube_service_stats(RubixCubeService * pService, RubixCubeServiceStats * pStats) ;
+
+/* Answer everything still queued and stop the workers, submits fail from then on but the stats can still be read */
+void rubix_cube_service_drain(RubixCubeService * pService) ;
+
+/* Answer everything still queued, then stop the workers and free @pService */
+void rubix_cube_service_stop(RubixCubeService * pService) ;
+
+/* Read a request from the @size bytes at @bytes into @pRequest */
+/* Return the bytes it took, 0 if there are not enough yet */
+size_t rubix_cube_service_decode_request(RubixCubeServiceRequest * pRequest, const unsigned char * bytes, size_t size) ;
+
+/* Write @pRequest to @bytes, which must have room for RUBIX_CUBE_SERVICE_REQUEST_SIZE + @pRequest->count bytes, return the bytes written */
+size_t rubix_cube_service_encode_request(unsigned char * bytes, const RubixCubeServiceRequest * pRequest) ;
+
+/* Write @pResponse to @bytes, which must have room for RUBIX_CUBE_SERVICE_RESPONSE_SIZE + RUBIX_CUBE_SERVICE_MAX_CODES bytes */
+/* Return the bytes written */
+size_t rubix_cube_service_encode_response(unsigned char * bytes, const RubixCubeServiceResponse * pResponse) ;
+
+/* Write the answer to a RUBIX_CUBE_SERVICE_STATS request, the same room needed and returned */
+size_t rubix_cube_service_encode_stats(unsigned char * bytes, unsigned long long id, const RubixCubeServiceStats * pStats) ;
+
+/* Read a response, whatever its kind, into @pResponse, with the payload in @codes, return the bytes it took or 0 */
+size_t rubix_cube_service_decode_response(RubixCubeServiceResponse * pResponse, const unsigned char * bytes, size_t size) ;
+
+#endif // RUBIX_CUBE_SERVICE_H
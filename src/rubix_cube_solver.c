@@ -0,0 +1,214 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+#include "rubix_cube_solver.h"
+#include "rubix_cube_storage.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define RUBIX_CUBE_SOLVER_NO_SIDE 		RUBIX_CUBE_SIDE_COUNT
+
+#define RUBIX_CUBE_SOLVER_FOUND 		((unsigned)-1)
+
+typedef struct rubix_cube_solver_search {
+	RubixCubeSolver * 		pSolver ;
+	const RubixCubeCubie * 		moves[RUBIX_CUBE_MOVE_COUNT] ;
+	RubixCubeMove 			path[RUBIX_CUBE_SOLVER_MAX_DEPTH] ;
+	unsigned 			bound ;
+	unsigned 			length ;	/* of the solution, once found */
+} RubixCubeSolverSearch ;
+
+RubixCubeSolver * rubix_cube_solver_allocate(RubixCubePatternDatabase ** databases, size_t number_of_databases) {
+	RubixCubeSolver * pNew ;
+	if (number_of_databases > RUBIX_CUBE_SOLVER_MAX_DATABASES) return NULL ;
+	if (!(pNew = (RubixCubeSolver *)malloc(sizeof(RubixCubeSolver)))) return NULL ;
+
+	pNew->number_of_databases = number_of_databases ;
+	for (size_t i = 0; i < number_of_databases; ++i) pNew->databases[i] = databases[i] ;
+	pNew->nodes = 0 ;
+	pNew->pTransposition = NULL ;
+	return pNew ;
+}
+
+RubixCubeSolver * rubix_cube_solver_allocate_default(void) {
+	const unsigned char corners[] = {
+		RUBIX_CUBE_CORNER_URF, RUBIX_CUBE_CORNER_UFL, RUBIX_CUBE_CORNER_ULB, RUBIX_CUBE_CORNER_UBR,
+		RUBIX_CUBE_CORNER_DFR, RUBIX_CUBE_CORNER_DLF, RUBIX_CUBE_CORNER_DBL, RUBIX_CUBE_CORNER_DRB
+	} ;
+	const unsigned char first_edges[] = {
+		RUBIX_CUBE_EDGE_UR, RUBIX_CUBE_EDGE_UF, RUBIX_CUBE_EDGE_UL, RUBIX_CUBE_EDGE_UB, RUBIX_CUBE_EDGE_DR, RUBIX_CUBE_EDGE_DF
+	} ;
+	const unsigned char second_edges[] = {
+		RUBIX_CUBE_EDGE_DL, RUBIX_CUBE_EDGE_DB, RUBIX_CUBE_EDGE_FR, RUBIX_CUBE_EDGE_FL, RUBIX_CUBE_EDGE_BL, RUBIX_CUBE_EDGE_BR
+	} ;
+	RubixCubePatternDatabase * databases[3] = {
+		rubix_cube_pattern_allocate_empty(RUBIX_CUBE_PIECE_KIND_CORNER,corners,sizeof(corners)),
+		rubix_cube_pattern_allocate_empty(RUBIX_CUBE_PIECE_KIND_EDGE,first_edges,sizeof(first_edges)),
+		rubix_cube_pattern_allocate_empty(RUBIX_CUBE_PIECE_KIND_EDGE,second_edges,sizeof(second_edges))
+	} ;
+	RubixCubeSolver * pNew = rubix_cube_solver_map(NULL) ;
+
+	if (pNew) {
+		for (size_t i = 0; i < 3; ++i) rubix_cube_pattern_free(databases[i]) ;
+		return pNew ;
+	}
+
+	if (databases[0] && databases[1] && databases[2]) {
+		for (size_t i = 0; i < 3; ++i) rubix_cube_pattern_build_threads(databases[i],0) ;
+		pNew = rubix_cube_solver_allocate(databases,3) ;
+	}
+	if (!pNew) {
+		for (size_t i = 0; i < 3; ++i) rubix_cube_pattern_free(databases[i]) ;
+	}
+	return pNew ;
+}
+
+/* Name of the file holding database @index of a saved solver */
+static int rubix_cube_solver_table_path(char * dest, size_t size, const char * directory, size_t index) {
+	char name[64] ;
+	snprintf(name,sizeof(name),RUBIX_CUBE_SOLVER_TABLE_NAME,index) ;
+	return rubix_cube_table_path(dest,size,directory,name) ;
+}
+
+int rubix_cube_solver_save(const RubixCubeSolver * pSolver, const char * directory) {
+	char path[RUBIX_CUBE_SOLVER_PATH_SIZE] ;
+
+	for (size_t i = 0; i < pSolver->number_of_databases; ++i) {
+		if (!rubix_cube_solver_table_path(path,sizeof(path),directory,i)) return 0 ;
+		if (!rubix_cube_pattern_save(pSolver->databases[i],path)) return 0 ;
+	}
+	/* A longer solver saved here before must not have its extra databases picked up */
+	if (rubix_cube_solver_table_path(path,sizeof(path),directory,pSolver->number_of_databases)) remove(path) ;
+	return 1 ;
+}
+
+RubixCubeSolver * rubix_cube_solver_map(const char * directory) {
+	RubixCubePatternDatabase * databases[RUBIX_CUBE_SOLVER_MAX_DATABASES] ;
+	RubixCubeSolver * pNew = NULL ;
+	char path[RUBIX_CUBE_SOLVER_PATH_SIZE] ;
+	size_t count = 0 ;
+
+	while (count < RUBIX_CUBE_SOLVER_MAX_DATABASES && rubix_cube_solver_table_path(path,sizeof(path),directory,count)) {
+		if (!(databases[count] = rubix_cube_pattern_map(path))) break ;
+		++count ;
+	}
+
+	if (count) pNew = rubix_cube_solver_allocate(databases,count) ;
+	if (!pNew) {
+		for (size_t i = 0; i < count; ++i) rubix_cube_pattern_free(databases[i]) ;
+	}
+	return pNew ;
+}
+
+void rubix_cube_solver_free(RubixCubeSolver * pSolver) {
+	if (pSolver) {
+		for (size_t i = 0; i < pSolver->number_of_databases; ++i) rubix_cube_pattern_free(pSolver->databases[i]) ;
+		free(pSolver) ;
+	}
+}
+
+unsigned rubix_cube_solver_estimate(const RubixCubeSolver * pSolver, const RubixCubeCubie * pCubie) {
+	unsigned estimate = 0 ;
+	for (size_t i = 0; i < pSolver->number_of_databases; ++i) {
+		unsigned distance = rubix_cube_pattern_lookup(pSolver->databases[i],pCubie) ;
+		if (distance > estimate) estimate = distance ;
+	}
+	return estimate ;
+}
+
+/* Later bounds and smaller depths give smaller values, so KEEP_SMALLER keeps the entry that prunes the most */
+#define RUBIX_CUBE_SOLVER_TRANSPOSITION_VALUE(bound, depth) 	((uint32_t)(0xff - (bound)) << 8 | (uint32_t)(depth))
+
+/* Return nonzero if @pCubie was searched before at no greater depth under the current bound */
+static int rubix_cube_solver_transposed(RubixCubeSolverSearch * pSearch, const RubixCubeCubie * pCubie, unsigned depth) {
+	uint32_t value = RUBIX_CUBE_SOLVER_TRANSPOSITION_VALUE(pSearch->bound,depth), previous ;
+	RubixCubePacked packed ;
+
+	if (!rubix_cube_pack_cubie(&packed,pCubie)) return 0 ;
+	return rubix_cube_transposition_insert(pSearch->pSolver->pTransposition,&packed,value,&previous) == RUBIX_CUBE_TRANSPOSITION_FOUND &&
+		previous <= value ;
+}
+
+/* Return RUBIX_CUBE_SOLVER_FOUND, or the smallest f = g + h that went over the bound */
+static unsigned rubix_cube_solver_search(RubixCubeSolverSearch * pSearch, const RubixCubeCubie * pCubie, unsigned depth, size_t last_side) {
+	unsigned estimate = rubix_cube_solver_estimate(pSearch->pSolver,pCubie), next_bound = (unsigned)-2 ;
+
+	++pSearch->pSolver->nodes ;
+	if (depth + estimate > pSearch->bound) return depth + estimate ;
+	if (!estimate && rubix_cube_cubie_is_solved(pCubie)) {
+		pSearch->length = depth ;
+		return RUBIX_CUBE_SOLVER_FOUND ;
+	}
+	if (depth == pSearch->bound) return depth + 1 ;
+	/* Whatever went over the bound below here went into next_bound on the first visit already */
+	/* Nodes one move from the bound are cheaper to search than to look up */
+	if (pSearch->pSolver->pTransposition && depth + 1 < pSearch->bound && rubix_cube_solver_transposed(pSearch,pCubie,depth)) return next_bound ;
+
+	for (size_t side = 0; side < RUBIX_CUBE_SIDE_COUNT; ++side) {
+		if (side == last_side) continue ;
+		if (last_side != RUBIX_CUBE_SOLVER_NO_SIDE && side == RUBIX_CUBE_SQUARE_OPPOSITE(last_side) && side < last_side) continue ;
+
+		for (size_t rotation = 0; rotation < RUBIX_CUBE_FACE_ROTATION_COUNT; ++rotation) {
+			RubixCubeCubie child ;
+			rubix_cube_cubie_multiply(&child,pCubie,pSearch->moves[RUBIX_CUBE_MOVE_INDEX(side,rotation)]) ;
+			pSearch->path[depth] = (RubixCubeMove){ (RubixCubeSide)side, (RubixCubeFaceRotation)rotation } ;
+
+			unsigned result = rubix_cube_solver_search(pSearch,&child,depth + 1,side) ;
+			if (result == RUBIX_CUBE_SOLVER_FOUND) return result ;
+			if (result < next_bound) next_bound = result ;
+		}
+	}
+	return next_bound ;
+}
+
+RubixCubeScramble * rubix_cube_solver_solve_cubie(RubixCubeSolver * pSolver, const RubixCubeCubie * pCubie, size_t max_depth) {
+	RubixCubeSolverSearch search = { .pSolver = pSolver } ;
+	RubixCubeScramble * pNew ;
+
+	if (max_depth > RUBIX_CUBE_SOLVER_MAX_DEPTH) max_depth = RUBIX_CUBE_SOLVER_MAX_DEPTH ;
+	for (size_t m = 0; m < RUBIX_CUBE_MOVE_COUNT; ++m) {
+		search.moves[m] = rubix_cube_cubie_get_move(m / RUBIX_CUBE_FACE_ROTATION_COUNT,m % RUBIX_CUBE_FACE_ROTATION_COUNT) ;
+	}
+	pSolver->nodes = 0 ;
+	/* The last search of a solve stops halfway, what it put in the table was never searched through */
+	if (pSolver->pTransposition) rubix_cube_transposition_clear(pSolver->pTransposition) ;
+
+	search.bound = rubix_cube_solver_estimate(pSolver,pCubie) ;
+	while (search.bound <= max_depth) {
+		unsigned result = rubix_cube_solver_search(&search,pCubie,0,RUBIX_CUBE_SOLVER_NO_SIDE) ;
+		if (result == RUBIX_CUBE_SOLVER_FOUND) break ;
+		search.bound = result ;
+	}
+	if (search.bound > max_depth) return NULL ;
+
+	if (!(pNew = (RubixCubeScramble *)malloc(sizeof(RubixCubeScramble)))) return NULL ;
+	pNew->capacity = search.length ? search.length : 1 ;
+	if (!(pNew->moves = (RubixCubeMove *)malloc(sizeof(RubixCubeMove) * pNew->capacity))) {
+		free(pNew) ; return NULL ;
+	}
+	pNew->size = search.length ;
+	pNew->seed = 0 ;
+	for (size_t i = 0; i < pNew->size; ++i) pNew->moves[i] = search.path[i] ;
+
+	return pNew ;
+}
+
+RubixCubeScramble * rubix_cube_solver_solve(RubixCubeSolver * pSolver, RubixCube * pRubix_cube, size_t max_depth) {
+	RubixCubeCubie cubie ;
+	if (!rubix_cube_cubie_from_cube(&cubie,pRubix_cube)) return NULL ;
+	return rubix_cube_solver_solve_cubie(pSolver,&cubie,max_depth) ;
+}
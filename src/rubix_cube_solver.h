@@ -0,0 +1,90 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Optimal solver:
+ *
+ * Iterative deepening A*: depth first searches with a growing bound on
+ * moves so far + estimated moves left, where the estimate is the largest
+ * distance any of the solver's pattern databases reports. Every database is
+ * admissible, so the first solution found is as short as possible.
+ *
+ * Sequences that can never be part of a shortest solution are skipped: the same
+ * face twice in a row, and for two opposite (commuting) faces in a row only one
+ * of the two orders is tried.
+ *
+ * With a transposition table set, states reached again at no greater depth under the
+ * same bound are not searched twice. A state goes in the table when its search starts,
+ * so the table is only right for the solve that filled it: it is emptied at the start
+ * of every solve and can not be used by two solves at the same time.
+ */
+
+#ifndef RUBIX_CUBE_SOLVER_H
+#define RUBIX_CUBE_SOLVER_H "rubix_cube_solver.h"
+
+#include "rubix_cube.h"
+#include "rubix_cube_cubie.h"
+#include "rubix_cube_pattern.h"
+#include "rubix_cube_transposition.h"
+
+/* God's number in the face turn metric, no cube needs more */
+#define RUBIX_CUBE_SOLVER_MAX_DEPTH 	20
+
+#define RUBIX_CUBE_SOLVER_MAX_DATABASES 	8
+
+/* Saved solvers keep database i in this file */
+#define RUBIX_CUBE_SOLVER_TABLE_NAME 		"rubix_cube_pattern_%zu.table"
+#define RUBIX_CUBE_SOLVER_PATH_SIZE 		4096
+
+typedef struct rubix_cube_solver {
+	size_t 				number_of_databases ;
+	RubixCubePatternDatabase * 	databases[RUBIX_CUBE_SOLVER_MAX_DATABASES] ;
+	unsigned long long 		nodes ;		/* nodes visited by the last solve */
+	RubixCubeTranspositionTable * 	pTransposition ;	/* optional, best with RUBIX_CUBE_TRANSPOSITION_KEEP_SMALLER, not owned */
+} RubixCubeSolver ;
+
+/* Return a pointer to a freshly allocated solver using @number_of_databases @databases */
+/* The solver takes ownership of the databases and frees them with itself */
+RubixCubeSolver * rubix_cube_solver_allocate(RubixCubePatternDatabase ** databases, size_t number_of_databases) ;
+
+/* Return a pointer to a freshly allocated solver using all corners and two disjoint sets of 6 edges */
+/* Its databases are mapped from $RUBIX_CUBE_TABLES when saved there, else built on every cpu, which takes a while and about 82 MiB */
+RubixCubeSolver * rubix_cube_solver_allocate_default() ;
+
+/* Save the databases of @pSolver into @directory, or $RUBIX_CUBE_TABLES if @directory is NULL */
+/* Return nonzero on success */
+int rubix_cube_solver_save(const RubixCubeSolver * pSolver, const char * directory) ;
+
+/* Return a pointer to a freshly allocated solver over the databases saved in @directory, mapped read only */
+/* If @directory is NULL look in $RUBIX_CUBE_TABLES, return NULL if no databases are found */
+RubixCubeSolver * rubix_cube_solver_map(const char * directory) ;
+
+/* Free all memory associated with a RubixCubeSolver object */
+void rubix_cube_solver_free(RubixCubeSolver * pSolver) ;
+
+/* Get a lower bound on the number of face rotations needed to solve @pCubie */
+unsigned rubix_cube_solver_estimate(const RubixCubeSolver * pSolver, const RubixCubeCubie * pCubie) ;
+
+/* Find a shortest sequence of at most @max_depth moves solving @pRubix_cube */
+/* Return it as a freshly allocated RubixCubeScramble, or NULL if @pRubix_cube is not a valid cube or needs more moves */
+RubixCubeScramble * rubix_cube_solver_solve(RubixCubeSolver * pSolver, RubixCube * pRubix_cube, size_t max_depth) ;
+
+/* Same as rubix_cube_solver_solve(), on a cubie */
+RubixCubeScramble * rubix_cube_solver_solve_cubie(RubixCubeSolver * pSolver, const RubixCubeCubie * pCubie, size_t max_depth) ;
+
+#endif // RUBIX_CUBE_SOLVER_H
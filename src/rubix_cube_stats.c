@@ -0,0 +1,136 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+#include "rubix_cube_stats.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#ifdef RUBIX_CUBE_STATS
+
+/* Every thread that has counted something, linked so that a snapshot can find them */
+typedef struct rubix_cube_stats_thread {
+	RubixCubeStats 				stats ;
+	struct rubix_cube_stats_thread * 	pNext ;
+	struct rubix_cube_stats_thread * 	pPrevious ;
+} RubixCubeStatsThread ;
+
+__thread RubixCubeStats * rubix_cube_stats_local_pointer ;
+int rubix_cube_stats_timers_enabled ;
+
+static pthread_mutex_t rubix_cube_stats_lock = PTHREAD_MUTEX_INITIALIZER ;
+static pthread_once_t rubix_cube_stats_key_once = PTHREAD_ONCE_INIT ;
+static pthread_key_t rubix_cube_stats_key ;
+static RubixCubeStatsThread * rubix_cube_stats_threads ;
+static RubixCubeStats rubix_cube_stats_exited ;		/* totals of threads that are gone */
+static RubixCubeStats rubix_cube_stats_baseline ;	/* totals at the last reset */
+
+/* Where a thread counts if its own counters could not be allocated, shared and so only roughly right */
+static RubixCubeStats rubix_cube_stats_overflow ;
+
+static void rubix_cube_stats_add(RubixCubeStats * dest, const RubixCubeStats * src) {
+	unsigned long long * to = (unsigned long long *)dest ;
+	const unsigned long long * from = (const unsigned long long *)src ;
+	for (size_t i = 0; i < RUBIX_CUBE_STATS_FIELD_COUNT; ++i) to[i] += __atomic_load_n(&from[i],__ATOMIC_RELAXED) ;
+}
+
+/* Fold the counters of an exiting thread into the exited totals */
+static void rubix_cube_stats_thread_exit(void * pArgument) {
+	RubixCubeStatsThread * pThread = (RubixCubeStatsThread *)pArgument ;
+
+	pthread_mutex_lock(&rubix_cube_stats_lock) ;
+	rubix_cube_stats_add(&rubix_cube_stats_exited,&pThread->stats) ;
+	if (pThread->pPrevious) pThread->pPrevious->pNext = pThread->pNext ;
+	else rubix_cube_stats_threads = pThread->pNext ;
+	if (pThread->pNext) pThread->pNext->pPrevious = pThread->pPrevious ;
+	pthread_mutex_unlock(&rubix_cube_stats_lock) ;
+
+	free(pThread) ;
+}
+
+static void rubix_cube_stats_create_key(void) {
+	pthread_key_create(&rubix_cube_stats_key,rubix_cube_stats_thread_exit) ;
+}
+
+RubixCubeStats * rubix_cube_stats_register(void) {
+	RubixCubeStatsThread * pThread ;
+
+	pthread_once(&rubix_cube_stats_key_once,rubix_cube_stats_create_key) ;
+	if (!(pThread = (RubixCubeStatsThread *)calloc(1,sizeof(RubixCubeStatsThread)))) return &rubix_cube_stats_overflow ;
+
+	pthread_mutex_lock(&rubix_cube_stats_lock) ;
+	pThread->pNext = rubix_cube_stats_threads ;
+	if (rubix_cube_stats_threads) rubix_cube_stats_threads->pPrevious = pThread ;
+	rubix_cube_stats_threads = pThread ;
+	pthread_mutex_unlock(&rubix_cube_stats_lock) ;
+
+	pthread_setspecific(rubix_cube_stats_key,pThread) ;
+	return rubix_cube_stats_local_pointer = &pThread->stats ;
+}
+
+/* Totals of every thread ever, with the lock held */
+static void rubix_cube_stats_total(RubixCubeStats * dest) {
+	*dest = rubix_cube_stats_exited ;
+	rubix_cube_stats_add(dest,&rubix_cube_stats_overflow) ;
+	for (RubixCubeStatsThread * pThread = rubix_cube_stats_threads; pThread; pThread = pThread->pNext) {
+		rubix_cube_stats_add(dest,&pThread->stats) ;
+	}
+}
+
+int rubix_cube_stats_enabled(void) {
+	return 1 ;
+}
+
+void rubix_cube_stats_enable_timers(int enable) {
+	__atomic_store_n(&rubix_cube_stats_timers_enabled,!!enable,__ATOMIC_RELAXED) ;
+}
+
+void rubix_cube_stats_snapshot(RubixCubeStats * dest) {
+	unsigned long long * to = (unsigned long long *)dest ;
+	const unsigned long long * baseline = (const unsigned long long *)&rubix_cube_stats_baseline ;
+
+	pthread_mutex_lock(&rubix_cube_stats_lock) ;
+	rubix_cube_stats_total(dest) ;
+	for (size_t i = 0; i < RUBIX_CUBE_STATS_FIELD_COUNT; ++i) to[i] -= baseline[i] ;
+	pthread_mutex_unlock(&rubix_cube_stats_lock) ;
+}
+
+/* Other threads' counters are theirs to write, so a reset only moves the baseline */
+void rubix_cube_stats_reset(void) {
+	pthread_mutex_lock(&rubix_cube_stats_lock) ;
+	rubix_cube_stats_total(&rubix_cube_stats_baseline) ;
+	pthread_mutex_unlock(&rubix_cube_stats_lock) ;
+}
+
+#else
+
+int rubix_cube_stats_enabled(void) {
+	return 0 ;
+}
+
+void rubix_cube_stats_enable_timers(int enable) {
+	(void)enable ;
+}
+
+void rubix_cube_stats_snapshot(RubixCubeStats * dest) {
+	memset(dest,0,sizeof(RubixCubeStats)) ;
+}
+
+void rubix_cube_stats_reset(void) {
+}
+
+#endif // RUBIX_CUBE_STATS
@@ -0,0 +1,121 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Hot path statistics:
+ *
+ * Built with -DRUBIX_CUBE_STATS (make STATS=1) the library counts, per thread, the
+ * face rotations it does for each side, piece quadset rotations, scramble applications
+ * and the moves in them, and allocations. With rubix_cube_stats_enable_timers() it
+ * also adds up the cycles (cpu timestamp ticks) spent in face rotations and scrambles.
+ *
+ * Each thread only ever writes its own counters, so counting is a plain increment and
+ * never contends. rubix_cube_stats_snapshot() adds up every thread's counters, those
+ * of threads that have exited included.
+ *
+ * Built without it all of the hooks below expand to nothing and a snapshot is all zeros.
+ */
+
+#ifndef RUBIX_CUBE_STATS_H
+#define RUBIX_CUBE_STATS_H "rubix_cube_stats.h"
+
+#include "rubix_cube.h"
+
+/* Every field is an unsigned long long, so the struct can be treated as an array of them */
+typedef struct rubix_cube_stats {
+	unsigned long long 		rotate_face 		[RUBIX_CUBE_SIDE_COUNT] ;	/* by RubixCubeSquare */
+	unsigned long long 		rotate_face_cycles 	[RUBIX_CUBE_SIDE_COUNT] ;
+	unsigned long long 		rotate_piece_quadset ;				/* the generic turns only, see rubix_cube_unrolled.h */
+	unsigned long long 		apply_scramble ;
+	unsigned long long 		apply_scramble_moves ;
+	unsigned long long 		apply_scramble_cycles ;
+	unsigned long long 		unapply_scramble ;
+	unsigned long long 		unapply_scramble_moves ;
+	unsigned long long 		unapply_scramble_cycles ;
+	unsigned long long 		allocations ;
+	unsigned long long 		allocation_bytes ;
+} RubixCubeStats ;
+
+#define RUBIX_CUBE_STATS_FIELD_COUNT 	(sizeof(RubixCubeStats) / sizeof(unsigned long long))
+
+/* Return nonzero if the library was built with RUBIX_CUBE_STATS */
+int rubix_cube_stats_enabled() ;
+
+/* Turn the cycle timers on or off, they are off to begin with */
+void rubix_cube_stats_enable_timers(int enable) ;
+
+/* Set @dest to the totals of every thread since the last rubix_cube_stats_reset() */
+void rubix_cube_stats_snapshot(RubixCubeStats * dest) ;
+
+/* Start counting from zero again */
+void rubix_cube_stats_reset() ;
+
+#ifdef RUBIX_CUBE_STATS
+
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+extern __thread RubixCubeStats * rubix_cube_stats_local_pointer ;
+extern int rubix_cube_stats_timers_enabled ;
+
+/* Set up the counters of the calling thread */
+RubixCubeStats * rubix_cube_stats_register() ;
+
+static inline RubixCubeStats * rubix_cube_stats_local(void) {
+	RubixCubeStats * pStats = rubix_cube_stats_local_pointer ;
+	return pStats ? pStats : rubix_cube_stats_register() ;
+}
+
+static inline unsigned long long rubix_cube_stats_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc() ;
+#elif defined(__aarch64__)
+	unsigned long long ticks ;
+	__asm__ volatile("mrs %0, cntvct_el0" : "=r"(ticks)) ;
+	return ticks ;
+#else
+	struct timespec now ;
+	clock_gettime(CLOCK_MONOTONIC,&now) ;
+	return (unsigned long long)now.tv_sec * 1000000000ULL + (unsigned long long)now.tv_nsec ;
+#endif
+}
+
+/* Stores are atomic only so that a snapshot running in another thread never reads a torn value */
+#define RUBIX_CUBE_STATS_ADD(field,amount) \
+	do { \
+		RubixCubeStats * pStats_ = rubix_cube_stats_local() ; \
+		__atomic_store_n(&pStats_->field,pStats_->field + (amount),__ATOMIC_RELAXED) ; \
+	} while (0)
+
+#define RUBIX_CUBE_STATS_TIMER_START(name) \
+	unsigned long long name = __atomic_load_n(&rubix_cube_stats_timers_enabled,__ATOMIC_RELAXED) ? rubix_cube_stats_cycles() : 0
+
+#define RUBIX_CUBE_STATS_TIMER_STOP(name,field) \
+	do { if (name) RUBIX_CUBE_STATS_ADD(field,rubix_cube_stats_cycles() - name) ; } while (0)
+
+#else
+
+#define RUBIX_CUBE_STATS_ADD(field,amount) 	do { } while (0)
+#define RUBIX_CUBE_STATS_TIMER_START(name) 	do { } while (0)
+#define RUBIX_CUBE_STATS_TIMER_STOP(name,field) do { } while (0)
+
+#endif // RUBIX_CUBE_STATS
+
+#endif // RUBIX_CUBE_STATS_H
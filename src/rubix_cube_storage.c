@@ -0,0 +1,268 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+#include "rubix_cube_storage.h"
+#include "rubix_cube_rank.h"
+#include "rubix_cube_table.h"
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* Return 1 for an odd permutation of @count pieces */
+static unsigned rubix_cube_storage_parity(const unsigned char * permutation, size_t count) {
+	unsigned parity = 0 ;
+	for (size_t i = 0; i < count; ++i) {
+		for (size_t j = i + 1; j < count; ++j) parity ^= permutation[j] < permutation[i] ;
+	}
+	return parity ;
+}
+
+int rubix_cube_pack_cubie(RubixCubePacked * dest, const RubixCubeCubie * pCubie) {
+	uint64_t edges = rubix_cube_rank_edge_permutation(pCubie) ;
+	uint64_t low = rubix_cube_rank_corner_permutation(pCubie) |
+		       (uint64_t)rubix_cube_rank_corner_orientation(pCubie) << 16 |
+		       (uint64_t)rubix_cube_rank_edge_orientation(pCubie) << 28 |
+		       (edges & 0xffffff) << 40 ;
+	uint64_t high = edges >> 24 ;
+
+	for (size_t i = 0; i < 8; ++i) {
+		dest->bytes[i] = (unsigned char)(low >> (8 * i)) ;
+		dest->bytes[i + 8] = (unsigned char)(high >> (8 * i)) ;
+	}
+	return 1 ;
+}
+
+int rubix_cube_pack(RubixCubePacked * dest, RubixCube * pRubix_cube) {
+	RubixCubeCubie cubie ;
+	if (!rubix_cube_cubie_from_cube(&cubie,pRubix_cube)) return 0 ;
+	return rubix_cube_pack_cubie(dest,&cubie) ;
+}
+
+int rubix_cube_unpack_cubie(RubixCubeCubie * dest, const RubixCubePacked * pPacked) {
+	uint64_t low = 0, high = 0 ;
+
+	for (size_t i = 0; i < 8; ++i) {
+		low |= (uint64_t)pPacked->bytes[i] << (8 * i) ;
+		high |= (uint64_t)pPacked->bytes[i + 8] << (8 * i) ;
+	}
+
+	unsigned long corners = low & 0xffff ;
+	unsigned long twist = (low >> 16) & 0xfff ;
+	unsigned long flip = (low >> 28) & 0xfff ;
+	unsigned long edges = (unsigned long)((low >> 40) | (high << 24)) ;
+
+	if (high >> 8 || corners >= RUBIX_CUBE_RANK_CORNER_PERMUTATION_COUNT || twist >= RUBIX_CUBE_RANK_CORNER_ORIENTATION_COUNT ||
+	    flip >= RUBIX_CUBE_RANK_EDGE_ORIENTATION_COUNT || edges >= RUBIX_CUBE_RANK_EDGE_PERMUTATION_COUNT) return 0 ;
+
+	*dest = rubix_cube_cubie_generate_solved() ;
+	rubix_cube_unrank_corner_permutation(dest,corners) ;
+	rubix_cube_unrank_corner_orientation(dest,twist) ;
+	rubix_cube_unrank_edge_permutation(dest,edges) ;
+	rubix_cube_unrank_edge_orientation(dest,flip) ;
+
+	/* Face rotations always swap an even number of pieces overall */
+	return rubix_cube_storage_parity(dest->corner_permutation,RUBIX_CUBE_CORNER_COUNT) ==
+	       rubix_cube_storage_parity(dest->edge_permutation,RUBIX_CUBE_EDGE_COUNT) ;
+}
+
+int rubix_cube_unpack(RubixCube * dest, const RubixCubePacked * pPacked) {
+	RubixCubeCubie cubie ;
+	if (!rubix_cube_unpack_cubie(&cubie,pPacked)) return 0 ;
+	*dest = rubix_cube_cubie_to_cube(&cubie) ;
+	return 1 ;
+}
+
+static inline size_t rubix_cube_storage_chunk_size(size_t chunk_capacity) {
+	return sizeof(RubixCubeStateChunkHeader) + chunk_capacity * sizeof(RubixCubePacked) ;
+}
+
+RubixCubeStateWriter * rubix_cube_state_writer_open(const char * path, size_t chunk_capacity, unsigned flags) {
+	RubixCubeStateWriter * pNew ;
+
+	if (!chunk_capacity) chunk_capacity = RUBIX_CUBE_STATE_FILE_CHUNK_CAPACITY ;
+	if (chunk_capacity > UINT32_MAX) return NULL ;
+	if (!(pNew = (RubixCubeStateWriter *)malloc(sizeof(RubixCubeStateWriter)))) return NULL ;
+	if (!(pNew->chunk = (RubixCubePacked *)malloc(chunk_capacity * sizeof(RubixCubePacked)))) {
+		free(pNew) ; return NULL ;
+	}
+
+	memset(&pNew->header,0,sizeof(pNew->header)) ;
+	memcpy(pNew->header.magic,RUBIX_CUBE_STATE_FILE_MAGIC,sizeof(pNew->header.magic)) ;
+	pNew->header.version = RUBIX_CUBE_STATE_FILE_VERSION ;
+	pNew->header.flags = flags ;
+	pNew->header.chunk_capacity = chunk_capacity ;
+	pNew->pending = 0 ;
+	pNew->failed = 0 ;
+
+	/* The count stays 0 on disk until the writer is closed */
+	if (!(pNew->file = fopen(path,"wb")) || fwrite(&pNew->header,sizeof(pNew->header),1,pNew->file) != 1) {
+		if (pNew->file) fclose(pNew->file) ;
+		free(pNew->chunk) ;
+		free(pNew) ;
+		return NULL ;
+	}
+	return pNew ;
+}
+
+static void rubix_cube_state_writer_flush(RubixCubeStateWriter * pWriter) {
+	RubixCubeStateChunkHeader header ;
+
+	memset(&header,0,sizeof(header)) ;
+	header.count = (uint32_t)pWriter->pending ;
+	if (pWriter->header.flags & RUBIX_CUBE_STATE_FILE_CHECKSUMS) {
+		header.checksum = rubix_cube_table_checksum(RUBIX_CUBE_TABLE_CHECKSUM_SEED,pWriter->chunk,pWriter->pending * sizeof(RubixCubePacked)) ;
+	}
+
+	if (!pWriter->failed) {
+		pWriter->failed = fwrite(&header,sizeof(header),1,pWriter->file) != 1 ||
+				  fwrite(pWriter->chunk,sizeof(RubixCubePacked),pWriter->pending,pWriter->file) != pWriter->pending ;
+	}
+	pWriter->header.count += pWriter->pending ;
+	pWriter->pending = 0 ;
+}
+
+int rubix_cube_state_writer_write(RubixCubeStateWriter * pWriter, const RubixCubePacked * states, size_t count) {
+	while (count) {
+		size_t room = pWriter->header.chunk_capacity - pWriter->pending ;
+		size_t taken = count < room ? count : room ;
+
+		memcpy(pWriter->chunk + pWriter->pending,states,taken * sizeof(RubixCubePacked)) ;
+		pWriter->pending += taken ;
+		states += taken ;
+		count -= taken ;
+		if (pWriter->pending == pWriter->header.chunk_capacity) rubix_cube_state_writer_flush(pWriter) ;
+	}
+	return !pWriter->failed ;
+}
+
+int rubix_cube_state_writer_write_cube(RubixCubeStateWriter * pWriter, RubixCube * pRubix_cube) {
+	RubixCubePacked packed ;
+	if (!rubix_cube_pack(&packed,pRubix_cube)) return 0 ;
+	return rubix_cube_state_writer_write(pWriter,&packed,1) ;
+}
+
+int rubix_cube_state_writer_write_cubie(RubixCubeStateWriter * pWriter, const RubixCubeCubie * pCubie) {
+	RubixCubePacked packed ;
+	if (!rubix_cube_pack_cubie(&packed,pCubie)) return 0 ;
+	return rubix_cube_state_writer_write(pWriter,&packed,1) ;
+}
+
+int rubix_cube_state_writer_close(RubixCubeStateWriter * pWriter) {
+	int success ;
+
+	if (pWriter->pending) rubix_cube_state_writer_flush(pWriter) ;
+	success = !pWriter->failed ;
+	success &= !fseek(pWriter->file,0,SEEK_SET) ;
+	success &= fwrite(&pWriter->header,sizeof(pWriter->header),1,pWriter->file) == 1 ;
+	success &= !fclose(pWriter->file) ;
+
+	free(pWriter->chunk) ;
+	free(pWriter) ;
+	return success ;
+}
+
+static inline const unsigned char * rubix_cube_state_file_chunk_address(const RubixCubeStateFile * pFile, size_t chunk) {
+	return (const unsigned char *)pFile->address + sizeof(RubixCubeStateFileHeader) + chunk * rubix_cube_storage_chunk_size(pFile->header->chunk_capacity) ;
+}
+
+RubixCubeStateFile * rubix_cube_state_file_map(const char * path) {
+	RubixCubeStateFile * pNew ;
+	const RubixCubeStateFileHeader * header ;
+	struct stat status ;
+	void * address ;
+	int descriptor ;
+
+	if ((descriptor = open(path,O_RDONLY)) < 0) return NULL ;
+	if (fstat(descriptor,&status) || (size_t)status.st_size < sizeof(RubixCubeStateFileHeader)) {
+		close(descriptor) ; return NULL ;
+	}
+	address = mmap(NULL,(size_t)status.st_size,PROT_READ,MAP_SHARED,descriptor,0) ;
+	close(descriptor) ;
+	if (address == MAP_FAILED) return NULL ;
+
+	header = (const RubixCubeStateFileHeader *)address ;
+	if (memcmp(header->magic,RUBIX_CUBE_STATE_FILE_MAGIC,sizeof(header->magic)) || header->version != RUBIX_CUBE_STATE_FILE_VERSION ||
+	    !header->chunk_capacity || header->chunk_capacity > UINT32_MAX || !(pNew = (RubixCubeStateFile *)malloc(sizeof(RubixCubeStateFile)))) {
+		munmap(address,(size_t)status.st_size) ;
+		return NULL ;
+	}
+
+	pNew->address = address ;
+	pNew->size = (size_t)status.st_size ;
+	pNew->header = header ;
+
+	/* Full chunks, then maybe one short one, then maybe the torn end of a write that never finished */
+	size_t chunk_size = rubix_cube_storage_chunk_size(header->chunk_capacity) ;
+	size_t payload = pNew->size - sizeof(RubixCubeStateFileHeader) ;
+	size_t rest = payload % chunk_size ;
+
+	pNew->number_of_chunks = payload / chunk_size ;
+	pNew->count = pNew->number_of_chunks * header->chunk_capacity ;
+	if (rest >= sizeof(RubixCubeStateChunkHeader)) {
+		const RubixCubeStateChunkHeader * last = (const RubixCubeStateChunkHeader *)rubix_cube_state_file_chunk_address(pNew,pNew->number_of_chunks) ;
+		if (last->count && rest >= rubix_cube_storage_chunk_size(last->count)) {
+			pNew->count += last->count ;
+			++pNew->number_of_chunks ;
+		}
+	}
+
+	/* A closed file must hold exactly what its writer put in */
+	if (header->count && header->count != pNew->count) {
+		rubix_cube_state_file_unmap(pNew) ;
+		return NULL ;
+	}
+	return pNew ;
+}
+
+void rubix_cube_state_file_unmap(RubixCubeStateFile * pFile) {
+	if (pFile) {
+		munmap(pFile->address,pFile->size) ;
+		free(pFile) ;
+	}
+}
+
+const RubixCubePacked * rubix_cube_state_file_get(const RubixCubeStateFile * pFile, size_t index) {
+	size_t capacity = pFile->header->chunk_capacity ;
+	if (index >= pFile->count) return NULL ;
+
+	const unsigned char * chunk = rubix_cube_state_file_chunk_address(pFile,index / capacity) ;
+	return (const RubixCubePacked *)(chunk + sizeof(RubixCubeStateChunkHeader)) + index % capacity ;
+}
+
+size_t rubix_cube_state_file_chunk(const RubixCubeStateFile * pFile, size_t chunk, const RubixCubePacked ** states) {
+	size_t capacity = pFile->header->chunk_capacity ;
+	if (chunk >= pFile->number_of_chunks) return 0 ;
+
+	*states = (const RubixCubePacked *)(rubix_cube_state_file_chunk_address(pFile,chunk) + sizeof(RubixCubeStateChunkHeader)) ;
+	return chunk + 1 < pFile->number_of_chunks ? capacity : pFile->count - chunk * capacity ;
+}
+
+int rubix_cube_state_file_verify(const RubixCubeStateFile * pFile) {
+	for (size_t chunk = 0; chunk < pFile->number_of_chunks; ++chunk) {
+		const RubixCubeStateChunkHeader * header = (const RubixCubeStateChunkHeader *)rubix_cube_state_file_chunk_address(pFile,chunk) ;
+		const RubixCubePacked * states ;
+		size_t count = rubix_cube_state_file_chunk(pFile,chunk,&states) ;
+
+		if (header->count != count) return 0 ;
+		if (pFile->header->flags & RUBIX_CUBE_STATE_FILE_CHECKSUMS &&
+		    rubix_cube_table_checksum(RUBIX_CUBE_TABLE_CHECKSUM_SEED,states,count * sizeof(RubixCubePacked)) != header->checksum) return 0 ;
+	}
+	return 1 ;
+}
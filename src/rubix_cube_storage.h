@@ -0,0 +1,139 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Saving cube states:
+ *
+ * A cube packs into 16 bytes using its cubie ranks (see rubix_cube_rank.h), stored
+ * little endian whatever the machine:
+ *
+ * 	bits 0 to 15 	corner permutation 	< 40320
+ * 	bits 16 to 27 	corner orientation 	< 2187
+ * 	bits 28 to 39 	edge orientation 	< 2048
+ * 	bits 40 to 71 	edge permutation 	< 479001600
+ * 	bits 72 to 127 	zero
+ *
+ * A state file holds any number of packed cubes in fixed size chunks:
+ *
+ * 	[ file header, 64 bytes ][ chunk header, 16 bytes | capacity states ] ... [ last chunk, maybe short ]
+ *
+ * Every chunk but the last is full, so state i is found without reading anything else,
+ * and a file whose writer never got to close it can still be read up to its last
+ * complete chunk. With RUBIX_CUBE_STATE_FILE_CHECKSUMS every chunk header also carries
+ * a checksum of its states.
+ *
+ * Files are read by mapping them, and states are handed out as pointers into the
+ * mapping, so reading millions of them copies nothing until they are unpacked.
+ */
+
+#ifndef RUBIX_CUBE_STORAGE_H
+#define RUBIX_CUBE_STORAGE_H "rubix_cube_storage.h"
+
+#include "rubix_cube.h"
+#include "rubix_cube_cubie.h"
+#include <stdio.h>
+#include <stdint.h>
+
+#define RUBIX_CUBE_PACKED_SIZE 			16
+
+#define RUBIX_CUBE_STATE_FILE_MAGIC 		"RUBIXCUB"
+#define RUBIX_CUBE_STATE_FILE_VERSION 		1
+#define RUBIX_CUBE_STATE_FILE_CHUNK_CAPACITY 	4096
+
+/* Flags for rubix_cube_state_writer_open() */
+#define RUBIX_CUBE_STATE_FILE_CHECKSUMS 	0x1
+
+typedef struct rubix_cube_packed {
+	unsigned char 			bytes[RUBIX_CUBE_PACKED_SIZE] ;
+} RubixCubePacked ;
+
+typedef struct rubix_cube_state_file_header {
+	char 				magic[8] ;
+	uint32_t 			version ;
+	uint32_t 			flags ;
+	uint64_t 			chunk_capacity ;	/* states per chunk */
+	uint64_t 			count ;			/* states in the file, 0 until the writer is closed */
+	unsigned char 			reserved[32] ;
+} RubixCubeStateFileHeader ;
+
+typedef struct rubix_cube_state_chunk_header {
+	uint32_t 			count ;
+	uint32_t 			reserved ;
+	uint64_t 			checksum ;		/* of the states, 0 without RUBIX_CUBE_STATE_FILE_CHECKSUMS */
+} RubixCubeStateChunkHeader ;
+
+typedef struct rubix_cube_state_writer {
+	FILE * 				file ;
+	RubixCubeStateFileHeader 	header ;
+	RubixCubePacked * 		chunk ;			/* states not written out yet */
+	size_t 				pending ;
+	int 				failed ;
+} RubixCubeStateWriter ;
+
+typedef struct rubix_cube_state_file {
+	void * 				address ;
+	size_t 				size ;
+	const RubixCubeStateFileHeader * header ;
+	size_t 				count ;
+	size_t 				number_of_chunks ;
+} RubixCubeStateFile ;
+
+/* Pack @pCubie into @dest, return nonzero on success */
+int rubix_cube_pack_cubie(RubixCubePacked * dest, const RubixCubeCubie * pCubie) ;
+
+/* Pack @pRubix_cube into @dest, return 0 if the colors do not describe a cube reachable by face rotations */
+int rubix_cube_pack(RubixCubePacked * dest, RubixCube * pRubix_cube) ;
+
+/* Unpack @pPacked into @dest, return 0 if it is not a valid packed cube */
+int rubix_cube_unpack_cubie(RubixCubeCubie * dest, const RubixCubePacked * pPacked) ;
+int rubix_cube_unpack(RubixCube * dest, const RubixCubePacked * pPacked) ;
+
+/* Return a pointer to a freshly allocated writer of a new state file at @path */
+/* @chunk_capacity of 0 means RUBIX_CUBE_STATE_FILE_CHUNK_CAPACITY, @flags is RUBIX_CUBE_STATE_FILE_* values or 0 */
+/* Return NULL if the file can not be created */
+RubixCubeStateWriter * rubix_cube_state_writer_open(const char * path, size_t chunk_capacity, unsigned flags) ;
+
+/* Append @count @states to the file, return nonzero on success */
+int rubix_cube_state_writer_write(RubixCubeStateWriter * pWriter, const RubixCubePacked * states, size_t count) ;
+
+/* Pack and append a single cube, return 0 on an I/O error or if @pRubix_cube is not a valid cube */
+int rubix_cube_state_writer_write_cube(RubixCubeStateWriter * pWriter, RubixCube * pRubix_cube) ;
+int rubix_cube_state_writer_write_cubie(RubixCubeStateWriter * pWriter, const RubixCubeCubie * pCubie) ;
+
+/* Write out whatever is left, finish the header and free @pWriter */
+/* Return nonzero if every state made it to disk */
+int rubix_cube_state_writer_close(RubixCubeStateWriter * pWriter) ;
+
+/* Return a pointer to a freshly allocated, read only mapping of the state file at @path */
+/* Return NULL if the file is missing or is not a state file of this version */
+RubixCubeStateFile * rubix_cube_state_file_map(const char * path) ;
+
+/* Unmap a state file and free all memory associated with it */
+void rubix_cube_state_file_unmap(RubixCubeStateFile * pFile) ;
+
+/* Get a view of state @index, NULL if @index is out of range */
+/* Only valid until @pFile is unmapped */
+const RubixCubePacked * rubix_cube_state_file_get(const RubixCubeStateFile * pFile, size_t index) ;
+
+/* Point @states at the states of chunk @chunk and return how many there are, 0 if @chunk is out of range */
+size_t rubix_cube_state_file_chunk(const RubixCubeStateFile * pFile, size_t chunk, const RubixCubePacked ** states) ;
+
+/* Return nonzero if every chunk is consistent and, for files written with checksums, matches its checksum */
+int rubix_cube_state_file_verify(const RubixCubeStateFile * pFile) ;
+
+#endif // RUBIX_CUBE_STORAGE_H
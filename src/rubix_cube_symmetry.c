@@ -0,0 +1,202 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+#include "rubix_cube_symmetry.h"
+#include "rubix_cube_nxn.h"
+#include <assert.h>
+#include <pthread.h>
+#include <string.h>
+
+#define RUBIX_CUBE_SYMMETRY_COLOR_COUNT 	(RUBIX_CUBE_SIDE_COUNT + 1)
+
+/* Signed permutation matrices in the (x, y, z) coordinates of rubix_cube_nxn.c, rotations first */
+static int rubix_cube_symmetry_matrices[RUBIX_CUBE_SYMMETRY_COUNT][3][3] ;
+
+static RubixCubeFaceletPermutation rubix_cube_symmetry_permutations[RUBIX_CUBE_SYMMETRY_COUNT] ;
+static unsigned char rubix_cube_symmetry_color_table[RUBIX_CUBE_SYMMETRY_COUNT][RUBIX_CUBE_SYMMETRY_COLOR_COUNT] ;
+static RubixCubeSymmetry rubix_cube_symmetry_products[RUBIX_CUBE_SYMMETRY_COUNT][RUBIX_CUBE_SYMMETRY_COUNT] ;
+static RubixCubeSymmetry rubix_cube_symmetry_inverses[RUBIX_CUBE_SYMMETRY_COUNT] ;
+static unsigned char rubix_cube_symmetry_moves[RUBIX_CUBE_SYMMETRY_COUNT][RUBIX_CUBE_MOVE_COUNT] ;
+
+static pthread_once_t rubix_cube_symmetry_tables_once = PTHREAD_ONCE_INIT ;
+static int rubix_cube_symmetry_tables_ready ;
+
+/* The permutations of three axes, identity first, and their signs */
+static const unsigned char rubix_cube_symmetry_axes[6][3] = {
+	{ 0, 1, 2 }, { 0, 2, 1 }, { 1, 0, 2 }, { 1, 2, 0 }, { 2, 0, 1 }, { 2, 1, 0 }
+} ;
+static const int rubix_cube_symmetry_axes_sign[6] = { 1, -1, -1, 1, 1, -1 } ;
+
+static inline void rubix_cube_symmetry_transform(RubixCubeFacelets * dest, const RubixCubeFacelets * src, RubixCubeSymmetry symmetry) {
+	const unsigned char * map = rubix_cube_symmetry_permutations[symmetry].map ;
+	const unsigned char * colors = rubix_cube_symmetry_color_table[symmetry] ;
+	RubixCubeFacelets moved ;
+
+	for (size_t i = 0; i < RUBIX_CUBE_FACELET_STRIDE; ++i) moved.facelets[i] = colors[src->facelets[map[i]]] ;
+	*dest = moved ;
+}
+
+static void rubix_cube_symmetry_build_tables(void) {
+	unsigned short destination[RUBIX_CUBE_FACELET_COUNT] ;
+	unsigned char sides[RUBIX_CUBE_SIDE_COUNT] ;
+	size_t rotations = 0, reflections = RUBIX_CUBE_SYMMETRY_ROTATIONS ;
+
+	for (size_t axes = 0; axes < 6; ++axes) {
+		for (unsigned signs = 0; signs < 8; ++signs) {
+			int determinant = rubix_cube_symmetry_axes_sign[axes] ;
+			int (*matrix)[3] ;
+
+			for (size_t i = 0; i < 3; ++i) determinant *= signs & (1u << i) ? -1 : 1 ;
+			matrix = rubix_cube_symmetry_matrices[determinant > 0 ? rotations++ : reflections++] ;
+			memset(matrix,0,sizeof(int[3][3])) ;
+			for (size_t i = 0; i < 3; ++i) matrix[i][rubix_cube_symmetry_axes[axes][i]] = signs & (1u << i) ? -1 : 1 ;
+		}
+	}
+	assert(rotations == RUBIX_CUBE_SYMMETRY_ROTATIONS && reflections == RUBIX_CUBE_SYMMETRY_COUNT) ;
+
+	for (size_t s = 0; s < RUBIX_CUBE_SYMMETRY_COUNT; ++s) {
+		/* Gather form: the facelet ending up at destination[i] comes from i */
+		rubix_cube_symmetry_permutations[s] = rubix_cube_facelet_permutation_identity() ;
+		rubix_cube_nxn_build_transform(3,(const int (*)[3])rubix_cube_symmetry_matrices[s],destination,sides) ;
+		for (size_t i = 0; i < RUBIX_CUBE_FACELET_COUNT; ++i) rubix_cube_symmetry_permutations[s].map[destination[i]] = (unsigned char)i ;
+
+		/* Side f has color f + 1 when solved, so a center moved from f to sides[f] renames f + 1 to sides[f] + 1 */
+		rubix_cube_symmetry_color_table[s][RUBIX_CUBE_COLOR_NULL] = RUBIX_CUBE_COLOR_NULL ;
+		for (size_t side = 0; side < RUBIX_CUBE_SIDE_COUNT; ++side) rubix_cube_symmetry_color_table[s][side + 1] = (unsigned char)(sides[side] + 1) ;
+	}
+
+	for (size_t first = 0; first < RUBIX_CUBE_SYMMETRY_COUNT; ++first) {
+		for (size_t second = 0; second < RUBIX_CUBE_SYMMETRY_COUNT; ++second) {
+			int product[3][3] ;
+			size_t s ;
+
+			for (size_t i = 0; i < 3; ++i) {
+				for (size_t j = 0; j < 3; ++j) {
+					product[i][j] = 0 ;
+					for (size_t k = 0; k < 3; ++k) product[i][j] += rubix_cube_symmetry_matrices[second][i][k] * rubix_cube_symmetry_matrices[first][k][j] ;
+				}
+			}
+			for (s = 0; memcmp(product,rubix_cube_symmetry_matrices[s],sizeof(product)); ++s) assert(s + 1 < RUBIX_CUBE_SYMMETRY_COUNT) ;
+			rubix_cube_symmetry_products[first][second] = (RubixCubeSymmetry)s ;
+			if (!s) rubix_cube_symmetry_inverses[first] = (RubixCubeSymmetry)second ;
+		}
+	}
+
+	/* A face turn moved by a symmetry is the turn of the side its face went to, the other way round in a mirror */
+	RubixCubeFacelets solved = rubix_cube_facelets_generate_solved() ;
+	for (size_t s = 0; s < RUBIX_CUBE_SYMMETRY_COUNT; ++s) {
+		for (size_t code = 0; code < RUBIX_CUBE_MOVE_COUNT; ++code) {
+			RubixCubeFacelets moved, expected ;
+			size_t image ;
+
+			rubix_cube_facelets_permute(&moved,&solved,rubix_cube_facelet_get_move(code / RUBIX_CUBE_FACE_ROTATION_COUNT,code % RUBIX_CUBE_FACE_ROTATION_COUNT)) ;
+			rubix_cube_symmetry_transform(&moved,&moved,(RubixCubeSymmetry)s) ;
+			for (image = 0; image < RUBIX_CUBE_MOVE_COUNT; ++image) {
+				rubix_cube_facelets_permute(&expected,&solved,rubix_cube_facelet_get_move(image / RUBIX_CUBE_FACE_ROTATION_COUNT,image % RUBIX_CUBE_FACE_ROTATION_COUNT)) ;
+				if (rubix_cube_facelets_equivelence_check(&moved,&expected)) break ;
+			}
+			assert(image < RUBIX_CUBE_MOVE_COUNT) ;
+			rubix_cube_symmetry_moves[s][code] = (unsigned char)image ;
+		}
+	}
+
+	__atomic_store_n(&rubix_cube_symmetry_tables_ready,1,__ATOMIC_RELEASE) ;
+}
+
+static inline void rubix_cube_symmetry_init_tables(void) {
+	if (__builtin_expect(!__atomic_load_n(&rubix_cube_symmetry_tables_ready,__ATOMIC_ACQUIRE),0)) {
+		pthread_once(&rubix_cube_symmetry_tables_once,rubix_cube_symmetry_build_tables) ;
+	}
+}
+
+void rubix_cube_symmetry_apply(RubixCubeFacelets * dest, const RubixCubeFacelets * src, RubixCubeSymmetry symmetry) {
+	rubix_cube_symmetry_init_tables() ;
+	rubix_cube_symmetry_transform(dest,src,symmetry) ;
+}
+
+RubixCubeSymmetry rubix_cube_symmetry_canonicalize(RubixCubeFacelets * dest, const RubixCubeFacelets * src, size_t count) {
+	RubixCubeFacelets cube = *src, best = *src ;
+	RubixCubeSymmetry used = 0 ;
+
+	rubix_cube_symmetry_init_tables() ;
+	if (count > RUBIX_CUBE_SYMMETRY_COUNT) count = RUBIX_CUBE_SYMMETRY_COUNT ;
+
+	/* Most symmetries lose to the best so far within the first few facelets, so each one is only worked out that far */
+	for (size_t s = 1; s < count; ++s) {
+		const unsigned char * map = rubix_cube_symmetry_permutations[s].map ;
+		const unsigned char * colors = rubix_cube_symmetry_color_table[s] ;
+		size_t i ;
+
+		for (i = 0; i < RUBIX_CUBE_FACELET_COUNT; ++i) {
+			unsigned char color = colors[cube.facelets[map[i]]] ;
+			if (color == best.facelets[i]) continue ;
+			if (color > best.facelets[i]) break ;
+
+			for (best.facelets[i++] = color; i < RUBIX_CUBE_FACELET_COUNT; ++i) best.facelets[i] = colors[cube.facelets[map[i]]] ;
+			used = (RubixCubeSymmetry)s ;
+		}
+	}
+
+	*dest = best ;
+	return used ;
+}
+
+RubixCubeSymmetry rubix_cube_symmetry_canonicalize_cube(RubixCube * dest, RubixCube * src, size_t count) {
+	RubixCubeFacelets facelets = rubix_cube_facelets_from_cube(src) ;
+	RubixCubeSymmetry used = rubix_cube_symmetry_canonicalize(&facelets,&facelets,count) ;
+
+	*dest = rubix_cube_facelets_to_cube(&facelets) ;
+	return used ;
+}
+
+size_t rubix_cube_symmetry_stabilizer(const RubixCubeFacelets * pFacelets, size_t count) {
+	size_t same = 0 ;
+
+	rubix_cube_symmetry_init_tables() ;
+	if (count > RUBIX_CUBE_SYMMETRY_COUNT) count = RUBIX_CUBE_SYMMETRY_COUNT ;
+	for (size_t s = 0; s < count; ++s) {
+		RubixCubeFacelets moved ;
+		rubix_cube_symmetry_transform(&moved,pFacelets,(RubixCubeSymmetry)s) ;
+		same += rubix_cube_facelets_equivelence_check(&moved,pFacelets) ;
+	}
+	return same ;
+}
+
+RubixCubeSymmetry rubix_cube_symmetry_inverse(RubixCubeSymmetry symmetry) {
+	rubix_cube_symmetry_init_tables() ;
+	return rubix_cube_symmetry_inverses[symmetry] ;
+}
+
+RubixCubeSymmetry rubix_cube_symmetry_compose(RubixCubeSymmetry first, RubixCubeSymmetry second) {
+	rubix_cube_symmetry_init_tables() ;
+	return rubix_cube_symmetry_products[first][second] ;
+}
+
+unsigned char rubix_cube_symmetry_move(RubixCubeSymmetry symmetry, unsigned char code) {
+	rubix_cube_symmetry_init_tables() ;
+	return rubix_cube_symmetry_moves[symmetry][code] ;
+}
+
+const RubixCubeFaceletPermutation * rubix_cube_symmetry_get_permutation(RubixCubeSymmetry symmetry) {
+	rubix_cube_symmetry_init_tables() ;
+	return &rubix_cube_symmetry_permutations[symmetry] ;
+}
+
+const unsigned char * rubix_cube_symmetry_colors(RubixCubeSymmetry symmetry) {
+	rubix_cube_symmetry_init_tables() ;
+	return rubix_cube_symmetry_color_table[symmetry] ;
+}
@@ -0,0 +1,76 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+/*
+ * Symmetries:
+ *
+ * Turning the whole cube around, or looking at it in a mirror, changes which colors
+ * are on which side but not how far the cube is from solved. Two cubes one of those 48
+ * symmetries apart (24 rotations, each with or without a reflection) count as the same
+ * state for dedup and pruning tables, so each class of them is kept as one state: its
+ * canonical form, the smallest of the 48 in facelet byte order.
+ *
+ * Symmetry s moves the facelets with a permutation and then renames every color so the
+ * centers are back where they belong, which makes it conjugation by s: solved stays
+ * solved, and a cube d moves from solved becomes another d moves from solved. Symmetry
+ * 0 is the identity, 1 to 23 are the other rotations and 24 to 47 the reflections, so
+ * passing RUBIX_CUBE_SYMMETRY_ROTATIONS instead of RUBIX_CUBE_SYMMETRY_COUNT keeps
+ * mirror images apart.
+ */
+
+#ifndef RUBIX_CUBE_SYMMETRY_H
+#define RUBIX_CUBE_SYMMETRY_H "rubix_cube_symmetry.h"
+
+#include "rubix_cube.h"
+#include "rubix_cube_facelet.h"
+
+#define RUBIX_CUBE_SYMMETRY_COUNT 	48
+#define RUBIX_CUBE_SYMMETRY_ROTATIONS 	24
+
+/* Return nonzero if symmetry @symmetry is a reflection */
+#define RUBIX_CUBE_SYMMETRY_IS_REFLECTION(symmetry) 	((symmetry) >= RUBIX_CUBE_SYMMETRY_ROTATIONS)
+
+typedef unsigned char RubixCubeSymmetry ;
+
+/* Set @dest to @src moved by @symmetry, @dest may alias @src */
+void rubix_cube_symmetry_apply(RubixCubeFacelets * dest, const RubixCubeFacelets * src, RubixCubeSymmetry symmetry) ;
+
+/* Set @dest to the canonical form of @src under the first @count symmetries, and return the one that makes it */
+/* out of @src. @count is RUBIX_CUBE_SYMMETRY_COUNT or RUBIX_CUBE_SYMMETRY_ROTATIONS, @dest may alias @src */
+RubixCubeSymmetry rubix_cube_symmetry_canonicalize(RubixCubeFacelets * dest, const RubixCubeFacelets * src, size_t count) ;
+
+/* Same as rubix_cube_symmetry_canonicalize(), on a RubixCube */
+RubixCubeSymmetry rubix_cube_symmetry_canonicalize_cube(RubixCube * dest, RubixCube * src, size_t count) ;
+
+/* Return the number of the first @count symmetries that leave @pFacelets as it is, 1 for most cubes */
+size_t rubix_cube_symmetry_stabilizer(const RubixCubeFacelets * pFacelets, size_t count) ;
+
+/* Return the symmetry undoing @symmetry, and the one doing @first then @second */
+RubixCubeSymmetry rubix_cube_symmetry_inverse(RubixCubeSymmetry symmetry) ;
+RubixCubeSymmetry rubix_cube_symmetry_compose(RubixCubeSymmetry first, RubixCubeSymmetry second) ;
+
+/* Return the move code (see rubix_cube_packed_scramble.h) @code becomes under @symmetry: moving a cube by @symmetry */
+/* after @code is the same as moving it by @symmetry before the returned code */
+unsigned char rubix_cube_symmetry_move(RubixCubeSymmetry symmetry, unsigned char code) ;
+
+/* Get the facelet permutation of @symmetry, before its colors are renamed with rubix_cube_symmetry_colors() */
+const RubixCubeFaceletPermutation * rubix_cube_symmetry_get_permutation(RubixCubeSymmetry symmetry) ;
+
+/* Get the color each color is renamed to by @symmetry, indexed by RubixCubeColor */
+const unsigned char * rubix_cube_symmetry_colors(RubixCubeSymmetry symmetry) ;
+
+#endif // RUBIX_CUBE_SYMMETRY_H
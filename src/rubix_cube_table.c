@@ -0,0 +1,151 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+#include "rubix_cube_table.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define RUBIX_CUBE_TABLE_FNV_PRIME 	0x100000001b3ULL
+
+uint64_t rubix_cube_table_checksum(uint64_t hash, const void * pData, size_t size) {
+	const unsigned char * data = (const unsigned char *)pData ;
+	for (size_t i = 0; i < size; i += sizeof(uint64_t)) {
+		uint64_t word ;
+		memcpy(&word,data + i,sizeof(word)) ;
+		hash = (hash ^ word) * RUBIX_CUBE_TABLE_FNV_PRIME ;
+	}
+	return hash ;
+}
+
+size_t rubix_cube_table_padded_size(size_t size) {
+	return (size + RUBIX_CUBE_TABLE_ALIGNMENT - 1) / RUBIX_CUBE_TABLE_ALIGNMENT * RUBIX_CUBE_TABLE_ALIGNMENT ;
+}
+
+/* Hand a section to @file and the checksum, padding it out with zeros */
+static int rubix_cube_table_write_section(FILE * file, uint64_t * hash, const void * section, size_t size) {
+	size_t whole = size / RUBIX_CUBE_TABLE_ALIGNMENT * RUBIX_CUBE_TABLE_ALIGNMENT ;
+	unsigned char tail[RUBIX_CUBE_TABLE_ALIGNMENT] = { 0 } ;
+
+	if (fwrite(section,1,whole,file) != whole) return 0 ;
+	*hash = rubix_cube_table_checksum(*hash,(const unsigned char *)section,whole) ;
+	if (whole == size) return 1 ;
+
+	memcpy(tail,(const unsigned char *)section + whole,size - whole) ;
+	if (fwrite(tail,1,sizeof(tail),file) != sizeof(tail)) return 0 ;
+	*hash = rubix_cube_table_checksum(*hash,tail,sizeof(tail)) ;
+	return 1 ;
+}
+
+int rubix_cube_table_write(const char * path, RubixCubeTableKind kind, const void * parameters, size_t parameters_size,
+			   const void * const * sections, const size_t * section_sizes, size_t number_of_sections) {
+	RubixCubeTableHeader header ;
+	char temporary[PATH_MAX] ;
+	FILE * file ;
+	int success = 1 ;
+
+	if (parameters_size > RUBIX_CUBE_TABLE_PARAMETERS_SIZE) return 0 ;
+	if ((size_t)snprintf(temporary,sizeof(temporary),"%s.tmp.%ld",path,(long)getpid()) >= sizeof(temporary)) return 0 ;
+
+	memset(&header,0,sizeof(header)) ;
+	memcpy(header.magic,RUBIX_CUBE_TABLE_MAGIC,sizeof(header.magic)) ;
+	header.version = RUBIX_CUBE_TABLE_VERSION ;
+	header.kind = kind ;
+	header.checksum = RUBIX_CUBE_TABLE_CHECKSUM_SEED ;
+	if (parameters) memcpy(header.parameters,parameters,parameters_size) ;
+	for (size_t i = 0; i < number_of_sections; ++i) header.payload_size += rubix_cube_table_padded_size(section_sizes[i]) ;
+
+	/* Truncating @path in place would pull the pages out from under anyone who has it mapped,
+	 * so the table is written beside it and renamed over it once it is whole on disk */
+	if (!(file = fopen(temporary,"wb"))) return 0 ;
+
+	/* The checksum is only known at the end, so the header goes in twice */
+	success &= fwrite(&header,sizeof(header),1,file) == 1 ;
+	for (size_t i = 0; success && i < number_of_sections; ++i) {
+		success &= rubix_cube_table_write_section(file,&header.checksum,sections[i],section_sizes[i]) ;
+	}
+	success &= !fseek(file,0,SEEK_SET) ;
+	success &= fwrite(&header,sizeof(header),1,file) == 1 ;
+	success &= !fflush(file) && !fsync(fileno(file)) ;
+	success &= !fclose(file) ;
+	success = success && !rename(temporary,path) ;
+
+	if (!success) remove(temporary) ;
+	return success ;
+}
+
+int rubix_cube_table_map(RubixCubeTableMapping * pMapping, const char * path, RubixCubeTableKind kind,
+			 const void * parameters, size_t parameters_size) {
+	struct stat status ;
+	const RubixCubeTableHeader * header ;
+	void * address ;
+	int descriptor ;
+
+	memset(pMapping,0,sizeof(RubixCubeTableMapping)) ;
+	if (parameters_size > RUBIX_CUBE_TABLE_PARAMETERS_SIZE) return 0 ;
+	if ((descriptor = open(path,O_RDONLY)) < 0) return 0 ;
+
+	if (fstat(descriptor,&status) || (size_t)status.st_size < sizeof(RubixCubeTableHeader)) {
+		close(descriptor) ; return 0 ;
+	}
+	address = mmap(NULL,(size_t)status.st_size,PROT_READ,MAP_SHARED,descriptor,0) ;
+	close(descriptor) ;
+	if (address == MAP_FAILED) return 0 ;
+
+	header = (const RubixCubeTableHeader *)address ;
+	if (	memcmp(header->magic,RUBIX_CUBE_TABLE_MAGIC,sizeof(header->magic)) ||
+		header->version != RUBIX_CUBE_TABLE_VERSION ||
+		header->kind != (uint32_t)kind ||
+		header->payload_size != (uint64_t)status.st_size - sizeof(RubixCubeTableHeader) ||
+		(parameters && memcmp(header->parameters,parameters,parameters_size))) {
+		munmap(address,(size_t)status.st_size) ;
+		return 0 ;
+	}
+
+	pMapping->address = address ;
+	pMapping->size = (size_t)status.st_size ;
+	pMapping->header = header ;
+	pMapping->payload = (const unsigned char *)address + sizeof(RubixCubeTableHeader) ;
+	return 1 ;
+}
+
+int rubix_cube_table_verify(const RubixCubeTableMapping * pMapping) {
+	if (!pMapping->address) return 0 ;
+	return rubix_cube_table_checksum(RUBIX_CUBE_TABLE_CHECKSUM_SEED,pMapping->payload,pMapping->header->payload_size) == pMapping->header->checksum ;
+}
+
+void rubix_cube_table_unmap(RubixCubeTableMapping * pMapping) {
+	if (pMapping->address) munmap(pMapping->address,pMapping->size) ;
+	memset(pMapping,0,sizeof(RubixCubeTableMapping)) ;
+}
+
+const void * rubix_cube_table_section(const RubixCubeTableMapping * pMapping, size_t offset) {
+	return pMapping->payload + offset ;
+}
+
+int rubix_cube_table_path(char * dest, size_t size, const char * directory, const char * name) {
+	if (!directory) directory = getenv(RUBIX_CUBE_TABLE_DIRECTORY_VARIABLE) ;
+	if (!directory || !*directory) return 0 ;
+
+	int length = snprintf(dest,size,"%s/%s",directory,name) ;
+	return length > 0 && (size_t)length < size ;
+}
@@ -0,0 +1,110 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Table files:
+ *
+ * Solver tables are expensive to build and never change, so they can be written to disk
+ * once and memory mapped read only by every process that needs them afterwards. All
+ * processes then share the one copy in the page cache and opening a table costs a few
+ * system calls.
+ *
+ * A table file is a 64 byte header followed by the payload:
+ *
+ * 	magic 		"RUBIXTBL"
+ * 	version 	RUBIX_CUBE_TABLE_VERSION, files from other versions are refused
+ * 	kind 		RubixCubeTableKind
+ * 	payload_size 	in bytes, always a multiple of RUBIX_CUBE_TABLE_ALIGNMENT
+ * 	checksum 	FNV-1a over the payload taken as 64 bit words
+ * 	parameters 	kind specific, what the table was built for
+ *
+ * The payload is made of sections, each padded to RUBIX_CUBE_TABLE_ALIGNMENT bytes.
+ * Fields are stored in native byte order, a file from a machine of the other byte
+ * order fails the version check.
+ */
+
+#ifndef RUBIX_CUBE_TABLE_H
+#define RUBIX_CUBE_TABLE_H "rubix_cube_table.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define RUBIX_CUBE_TABLE_MAGIC 			"RUBIXTBL"
+#define RUBIX_CUBE_TABLE_VERSION 		1
+#define RUBIX_CUBE_TABLE_ALIGNMENT 		64
+#define RUBIX_CUBE_TABLE_PARAMETERS_SIZE 	32
+
+/* FNV-1a offset basis, what every checksum starts from */
+#define RUBIX_CUBE_TABLE_CHECKSUM_SEED 		0xcbf29ce484222325ULL
+
+/* Tables are looked for here when a directory is not given explicitly */
+#define RUBIX_CUBE_TABLE_DIRECTORY_VARIABLE 	"RUBIX_CUBE_TABLES"
+
+typedef enum rubix_cube_table_kind {
+	RUBIX_CUBE_TABLE_KIND_PATTERN = 1,
+	RUBIX_CUBE_TABLE_KIND_TWO_PHASE = 2
+} RubixCubeTableKind ;
+
+typedef struct rubix_cube_table_header {
+	char 				magic[8] ;
+	uint32_t 			version ;
+	uint32_t 			kind ;
+	uint64_t 			payload_size ;
+	uint64_t 			checksum ;
+	unsigned char 			parameters[RUBIX_CUBE_TABLE_PARAMETERS_SIZE] ;
+} RubixCubeTableHeader ;
+
+typedef struct rubix_cube_table_mapping {
+	void * 				address ;	/* NULL when nothing is mapped */
+	size_t 				size ;
+	const RubixCubeTableHeader * 	header ;
+	const unsigned char * 		payload ;
+} RubixCubeTableMapping ;
+
+/* Continue the checksum @hash over @size bytes of @pData, @size must be a multiple of 8 */
+uint64_t rubix_cube_table_checksum(uint64_t hash, const void * pData, size_t size) ;
+
+/* Size of a section once padded */
+size_t rubix_cube_table_padded_size(size_t size) ;
+
+/* Write @number_of_sections @sections of @section_sizes bytes to a new table file at @path */
+/* An existing file at @path is replaced atomically, so current mappings of it keep the old table */
+/* Return nonzero on success, 0 on any I/O error */
+int rubix_cube_table_write(const char * path, RubixCubeTableKind kind, const void * parameters, size_t parameters_size,
+			   const void * const * sections, const size_t * section_sizes, size_t number_of_sections) ;
+
+/* Map the table file at @path read only into @pMapping, checking the header and size, but not the checksum */
+/* If @parameters is not NULL the file must have been built with exactly those @parameters_size bytes of parameters */
+/* Return nonzero on success, on failure nothing is left mapped */
+int rubix_cube_table_map(RubixCubeTableMapping * pMapping, const char * path, RubixCubeTableKind kind,
+			 const void * parameters, size_t parameters_size) ;
+
+/* Return nonzero if the payload of @pMapping matches its checksum, this reads the whole file */
+int rubix_cube_table_verify(const RubixCubeTableMapping * pMapping) ;
+
+/* Unmap @pMapping, safe to call on a mapping that holds nothing */
+void rubix_cube_table_unmap(RubixCubeTableMapping * pMapping) ;
+
+/* Get the section of @pMapping starting @offset bytes into the payload */
+const void * rubix_cube_table_section(const RubixCubeTableMapping * pMapping, size_t offset) ;
+
+/* Set @dest to @directory/@name, or to $RUBIX_CUBE_TABLES/@name if @directory is NULL */
+/* Return nonzero on success, 0 if there is no directory or the path does not fit in @size bytes */
+int rubix_cube_table_path(char * dest, size_t size, const char * directory, const char * name) ;
+
+#endif // RUBIX_CUBE_TABLE_H
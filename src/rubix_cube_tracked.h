@@ -0,0 +1,81 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+/*
+ * Tracked cubes:
+ *
+ * A RubixCubeTracked is a RubixCube that also keeps count of how many of its pieces
+ * differ from the solved cube, and which ones (one bit per piece, plane * 9 + index).
+ * A face rotation only moves the 4 corner and 4 side pieces of its quadsets, so only
+ * those 8 pieces are compared after the rotation to keep the count right, and
+ * checking whether the cube is solved is then a single compare instead of a walk
+ * over the whole cube. The Zobrist hash of the cube (see rubix_cube_zobrist.h) is
+ * kept up to date the same way, from the same 8 pieces.
+ *
+ * Change the cube only through the functions below, or call
+ * rubix_cube_tracked_recount() after changing @cube directly.
+ */
+
+#ifndef RUBIX_CUBE_TRACKED_H
+#define RUBIX_CUBE_TRACKED_H "rubix_cube_tracked.h"
+
+#include "rubix_cube.h"
+#include "rubix_cube_zobrist.h"
+
+typedef struct rubix_cube_tracked {
+	RubixCube 		cube ;
+	unsigned 		pieces ;	/* bit set for each piece that does not match the solved cube */
+	unsigned 		misplaced ;	/* bits set in @pieces */
+	RubixCubeHash 		hash ;		/* rubix_cube_zobrist_hash() of @cube */
+} RubixCubeTracked ;
+
+/* Return a tracked copy of @pRubix_cube */
+RubixCubeTracked rubix_cube_tracked_from_cube(const RubixCube * pRubix_cube) ;
+
+/* Return a tracked solved cube */
+RubixCubeTracked rubix_cube_tracked_generate_solved(void) ;
+
+/* Count the misplaced pieces and hash @pTracked->cube from scratch, e.g. after changing it directly */
+void rubix_cube_tracked_recount(RubixCubeTracked * pTracked) ;
+
+/* Same as rubix_cube_rotate_face() but keeps the misplaced count and hash up to date */
+void rubix_cube_tracked_rotate_face(RubixCubeTracked * pTracked, RubixCubeSide side, RubixCubeFaceRotation face_rotation) ;
+
+/* Apply a move, or the reverse of it, keeping the misplaced count up to date */
+void rubix_cube_tracked_apply_move(RubixCubeTracked * pTracked, const RubixCubeMove * move) ;
+void rubix_cube_tracked_unapply_move(RubixCubeTracked * pTracked, const RubixCubeMove * move) ;
+
+/* Apply / unapply all moves in a @pScramble, keeping the misplaced count up to date */
+void rubix_cube_tracked_apply_scramble(RubixCubeTracked * pTracked, const RubixCubeScramble * pScramble) ;
+void rubix_cube_tracked_unapply_scramble(RubixCubeTracked * pTracked, const RubixCubeScramble * pScramble) ;
+
+/* Return 0 if the cube is not solved, else return nonzero value */
+static inline int rubix_cube_tracked_is_solved(const RubixCubeTracked * pTracked) {
+	return !pTracked->misplaced ;
+}
+
+/* Return the number of pieces of the cube that do not match the solved cube */
+static inline unsigned rubix_cube_tracked_misplaced(const RubixCubeTracked * pTracked) {
+	return pTracked->misplaced ;
+}
+
+/* Return the Zobrist hash of the cube */
+static inline RubixCubeHash rubix_cube_tracked_hash(const RubixCubeTracked * pTracked) {
+	return pTracked->hash ;
+}
+
+#endif // RUBIX_CUBE_TRACKED_H
@@ -0,0 +1,235 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+#include "rubix_cube_transposition.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#define RUBIX_CUBE_TRANSPOSITION_HUGE_PAGE_SIZE 	((size_t)2 << 20)
+
+#define RUBIX_CUBE_TRANSPOSITION_WORD(tag, value) 	(((uint64_t)(tag) << 32) | (uint64_t)(value))
+#define RUBIX_CUBE_TRANSPOSITION_TAG(word) 		((uint32_t)((word) >> 32))
+#define RUBIX_CUBE_TRANSPOSITION_VALUE(word) 		((uint32_t)(word))
+
+/* Through rubix_cube_mix64(), the low bits of a packed state alone hash badly */
+static inline uint64_t rubix_cube_transposition_hash(const uint64_t key[2]) {
+	return rubix_cube_mix64(key[0] ^ rubix_cube_mix64(key[1] + RUBIX_CUBE_RANDOM_GAMMA)) ;
+}
+
+/* Tags are the high half of the hash, the slot index comes from the low half */
+static inline uint32_t rubix_cube_transposition_tag(uint64_t hash) {
+	uint32_t tag = (uint32_t)(hash >> 32) ;
+	return tag > RUBIX_CUBE_TRANSPOSITION_BUSY ? tag : tag + 2 ;
+}
+
+static inline void rubix_cube_transposition_pause(void) {
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause() ;
+#elif defined(__aarch64__)
+	__asm__ volatile("yield") ;
+#endif
+}
+
+/* Load the word of @pSlot, waiting while another thread is writing the slot */
+static inline uint64_t rubix_cube_transposition_load(const RubixCubeTranspositionSlot * pSlot) {
+	uint64_t word = __atomic_load_n(&pSlot->word,__ATOMIC_ACQUIRE) ;
+	while (RUBIX_CUBE_TRANSPOSITION_TAG(word) == RUBIX_CUBE_TRANSPOSITION_BUSY) {
+		rubix_cube_transposition_pause() ;
+		word = __atomic_load_n(&pSlot->word,__ATOMIC_ACQUIRE) ;
+	}
+	return word ;
+}
+
+/* Compare the state in @pSlot with @key, return -1 if the slot changed under us since @word was loaded */
+static inline int rubix_cube_transposition_matches(const RubixCubeTranspositionSlot * pSlot, uint64_t word, const uint64_t key[2]) {
+	uint64_t first = __atomic_load_n(&pSlot->key[0],__ATOMIC_RELAXED) ;
+	uint64_t second = __atomic_load_n(&pSlot->key[1],__ATOMIC_RELAXED) ;
+
+	__atomic_thread_fence(__ATOMIC_ACQUIRE) ;
+	if (RUBIX_CUBE_TRANSPOSITION_TAG(__atomic_load_n(&pSlot->word,__ATOMIC_RELAXED)) != RUBIX_CUBE_TRANSPOSITION_TAG(word)) return -1 ;
+	return first == key[0] && second == key[1] ;
+}
+
+/* Write @key and @value into @pSlot, which this thread has marked busy */
+static inline void rubix_cube_transposition_publish(RubixCubeTranspositionSlot * pSlot, uint32_t tag, const uint64_t key[2], uint32_t value) {
+	__atomic_store_n(&pSlot->key[0],key[0],__ATOMIC_RELAXED) ;
+	__atomic_store_n(&pSlot->key[1],key[1],__ATOMIC_RELAXED) ;
+	__atomic_store_n(&pSlot->word,RUBIX_CUBE_TRANSPOSITION_WORD(tag,value),__ATOMIC_RELEASE) ;
+}
+
+/* Apply the table's policy to the value of a state found in @pSlot, return 0 if the slot changed under us */
+static int rubix_cube_transposition_update(RubixCubeTranspositionTable * pTable, RubixCubeTranspositionSlot * pSlot, uint64_t word, uint32_t value, uint32_t * previous) {
+	uint32_t tag = RUBIX_CUBE_TRANSPOSITION_TAG(word) ;
+
+	for (;;) {
+		uint32_t old = RUBIX_CUBE_TRANSPOSITION_VALUE(word) ;
+		int keep = pTable->policy == RUBIX_CUBE_TRANSPOSITION_KEEP_FIRST ||
+			(pTable->policy == RUBIX_CUBE_TRANSPOSITION_KEEP_SMALLER && old <= value) ;
+
+		if (keep || __atomic_compare_exchange_n(&pSlot->word,&word,RUBIX_CUBE_TRANSPOSITION_WORD(tag,value),
+							0,__ATOMIC_ACQ_REL,__ATOMIC_ACQUIRE)) {
+			if (previous) *previous = old ;
+			return 1 ;
+		}
+		if (RUBIX_CUBE_TRANSPOSITION_TAG(word) != tag) return 0 ;
+	}
+}
+
+RubixCubeTranspositionTable * rubix_cube_transposition_allocate(size_t capacity, RubixCubeTranspositionPolicy policy, unsigned flags) {
+	RubixCubeTranspositionTable * pNew ;
+	size_t slots = RUBIX_CUBE_TRANSPOSITION_PROBES, size ;
+	void * address = MAP_FAILED ;
+
+	if (capacity > ((size_t)-1 >> 1) / sizeof(RubixCubeTranspositionSlot)) return NULL ;
+	while (slots < capacity) slots <<= 1 ;
+	size = slots * sizeof(RubixCubeTranspositionSlot) ;
+
+	if (!(pNew = (RubixCubeTranspositionTable *)malloc(sizeof(RubixCubeTranspositionTable)))) return NULL ;
+	memset(pNew,0,sizeof(RubixCubeTranspositionTable)) ;
+
+#ifdef MAP_HUGETLB
+	if (flags & RUBIX_CUBE_TRANSPOSITION_HUGE_PAGES) {
+		size_t huge = (size + RUBIX_CUBE_TRANSPOSITION_HUGE_PAGE_SIZE - 1) & ~(RUBIX_CUBE_TRANSPOSITION_HUGE_PAGE_SIZE - 1) ;
+		address = mmap(NULL,huge,PROT_READ | PROT_WRITE,MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,-1,0) ;
+		if (address != MAP_FAILED) {
+			size = huge ;
+			pNew->huge_pages = 1 ;
+		}
+	}
+#endif
+	if (address == MAP_FAILED) {
+		address = mmap(NULL,size,PROT_READ | PROT_WRITE,MAP_PRIVATE | MAP_ANONYMOUS,-1,0) ;
+		if (address == MAP_FAILED) {
+			free(pNew) ;
+			return NULL ;
+		}
+#ifdef MADV_HUGEPAGE
+		if (flags & RUBIX_CUBE_TRANSPOSITION_HUGE_PAGES) madvise(address,size,MADV_HUGEPAGE) ;
+#endif
+	}
+
+	pNew->slots = (RubixCubeTranspositionSlot *)address ;
+	pNew->capacity = slots ;
+	pNew->mapped_size = size ;
+	pNew->policy = policy ;
+	return pNew ;
+}
+
+void rubix_cube_transposition_free(RubixCubeTranspositionTable * pTable) {
+	if (pTable) {
+		munmap(pTable->slots,pTable->mapped_size) ;
+		free(pTable) ;
+	}
+}
+
+void rubix_cube_transposition_clear(RubixCubeTranspositionTable * pTable) {
+	memset(pTable->slots,0,pTable->capacity * sizeof(RubixCubeTranspositionSlot)) ;
+	pTable->count = 0 ;
+	pTable->evictions = 0 ;
+}
+
+RubixCubeTranspositionResult rubix_cube_transposition_insert(RubixCubeTranspositionTable * pTable, const RubixCubePacked * pKey, uint32_t value, uint32_t * previous) {
+	uint64_t key[2], hash ;
+	uint32_t tag ;
+	size_t mask = pTable->capacity - 1 ;
+
+	memcpy(key,pKey->bytes,sizeof(key)) ;
+	hash = rubix_cube_transposition_hash(key) ;
+	tag = rubix_cube_transposition_tag(hash) ;
+
+	for (;;) {
+		RubixCubeTranspositionSlot * pVictim = NULL ;
+		uint64_t victim_word = 0 ;
+
+		for (size_t probe = 0; probe < RUBIX_CUBE_TRANSPOSITION_PROBES; ++probe) {
+			RubixCubeTranspositionSlot * pSlot = &pTable->slots[(hash + probe) & mask] ;
+			uint64_t word = rubix_cube_transposition_load(pSlot) ;
+
+			if (RUBIX_CUBE_TRANSPOSITION_TAG(word) == RUBIX_CUBE_TRANSPOSITION_EMPTY) {
+				if (__atomic_compare_exchange_n(&pSlot->word,&word,RUBIX_CUBE_TRANSPOSITION_WORD(RUBIX_CUBE_TRANSPOSITION_BUSY,0),
+								0,__ATOMIC_ACQ_REL,__ATOMIC_ACQUIRE)) {
+					rubix_cube_transposition_publish(pSlot,tag,key,value) ;
+					__atomic_add_fetch(&pTable->count,1,__ATOMIC_RELAXED) ;
+					return RUBIX_CUBE_TRANSPOSITION_INSERTED ;
+				}
+				--probe ;	/* someone else took it, look at what they put there */
+				continue ;
+			}
+
+			if (RUBIX_CUBE_TRANSPOSITION_TAG(word) == tag) {
+				int match = rubix_cube_transposition_matches(pSlot,word,key) ;
+				if (match < 0) { --probe ; continue ; }
+				if (match) {
+					if (rubix_cube_transposition_update(pTable,pSlot,word,value,previous)) return RUBIX_CUBE_TRANSPOSITION_FOUND ;
+					--probe ;
+					continue ;
+				}
+			}
+
+			if (pTable->policy == RUBIX_CUBE_TRANSPOSITION_REPLACE && !pVictim) {
+				pVictim = pSlot ;
+				victim_word = word ;
+			}
+			else
+			if (pTable->policy == RUBIX_CUBE_TRANSPOSITION_KEEP_SMALLER && RUBIX_CUBE_TRANSPOSITION_VALUE(word) > value &&
+					(!pVictim || RUBIX_CUBE_TRANSPOSITION_VALUE(word) > RUBIX_CUBE_TRANSPOSITION_VALUE(victim_word))) {
+				pVictim = pSlot ;
+				victim_word = word ;
+			}
+		}
+
+		if (!pVictim) return RUBIX_CUBE_TRANSPOSITION_FULL ;
+		if (__atomic_compare_exchange_n(&pVictim->word,&victim_word,RUBIX_CUBE_TRANSPOSITION_WORD(RUBIX_CUBE_TRANSPOSITION_BUSY,0),
+						0,__ATOMIC_ACQ_REL,__ATOMIC_ACQUIRE)) {
+			rubix_cube_transposition_publish(pVictim,tag,key,value) ;
+			__atomic_add_fetch(&pTable->evictions,1,__ATOMIC_RELAXED) ;
+			return RUBIX_CUBE_TRANSPOSITION_INSERTED ;
+		}
+		/* The window changed while we looked, go through it again */
+	}
+}
+
+int rubix_cube_transposition_lookup(const RubixCubeTranspositionTable * pTable, const RubixCubePacked * pKey, uint32_t * value) {
+	uint64_t key[2], hash ;
+	uint32_t tag ;
+	size_t mask = pTable->capacity - 1 ;
+
+	memcpy(key,pKey->bytes,sizeof(key)) ;
+	hash = rubix_cube_transposition_hash(key) ;
+	tag = rubix_cube_transposition_tag(hash) ;
+
+	for (size_t probe = 0; probe < RUBIX_CUBE_TRANSPOSITION_PROBES; ++probe) {
+		const RubixCubeTranspositionSlot * pSlot = &pTable->slots[(hash + probe) & mask] ;
+		uint64_t word = rubix_cube_transposition_load(pSlot) ;
+
+		if (RUBIX_CUBE_TRANSPOSITION_TAG(word) == RUBIX_CUBE_TRANSPOSITION_EMPTY) return 0 ;
+		if (RUBIX_CUBE_TRANSPOSITION_TAG(word) != tag) continue ;
+
+		int match = rubix_cube_transposition_matches(pSlot,word,key) ;
+		if (match < 0) { --probe ; continue ; }
+		if (match) {
+			if (value) *value = RUBIX_CUBE_TRANSPOSITION_VALUE(__atomic_load_n(&pSlot->word,__ATOMIC_ACQUIRE)) ;
+			return 1 ;
+		}
+	}
+	return 0 ;
+}
+
+size_t rubix_cube_transposition_count(const RubixCubeTranspositionTable * pTable) {
+	return __atomic_load_n(&pTable->count,__ATOMIC_RELAXED) ;
+}
@@ -0,0 +1,107 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+/*
+ * Transposition tables:
+ *
+ * A fixed capacity hash table from packed cube states (see rubix_cube_storage.h) to a
+ * 32 bit value, shared by any number of threads without a lock. Slots are found by
+ * linear probing from the hash of the state, at most RUBIX_CUBE_TRANSPOSITION_PROBES
+ * of them:
+ *
+ * 	slot: [ tag, 4 bytes | value, 4 | reserved, 8 | packed state, 16 ]
+ *
+ * The tag (32 bits of the hash of the state) and the value share one 64 bit word, so
+ * every change to a slot is a single compare and swap that fails if another thread
+ * got to the slot first. An empty slot has tag 0. An insert claims one by swapping in
+ * RUBIX_CUBE_TRANSPOSITION_BUSY, writes the state, then publishes the tag and value,
+ * so a reader never takes half a state for a real one, and one that finds a busy slot
+ * waits out the few stores it takes to publish it. Values of states already in the
+ * table are updated following the table's policy, which also picks the state to
+ * evict when every slot in the probe window is taken.
+ *
+ * The slots are mapped anonymous memory, from huge pages if asked for and the system
+ * has some free, else from normal pages with transparent huge pages requested.
+ */
+
+#ifndef RUBIX_CUBE_TRANSPOSITION_H
+#define RUBIX_CUBE_TRANSPOSITION_H "rubix_cube_transposition.h"
+
+#include "rubix_cube.h"
+#include "rubix_cube_storage.h"
+#include <stdint.h>
+
+/* Slots looked at per insert or lookup before the table counts as full there */
+#define RUBIX_CUBE_TRANSPOSITION_PROBES 	16
+
+/* Tags of slots with no state, or one being written, every other tag is the hash of a state */
+#define RUBIX_CUBE_TRANSPOSITION_EMPTY 		0
+#define RUBIX_CUBE_TRANSPOSITION_BUSY 		1
+
+/* Flags for rubix_cube_transposition_allocate() */
+#define RUBIX_CUBE_TRANSPOSITION_HUGE_PAGES 	0x1
+
+/* What an insert does to a state that is already in the table, and when the probe window is full */
+typedef enum rubix_cube_transposition_policy {
+	RUBIX_CUBE_TRANSPOSITION_KEEP_FIRST,	/* keep the old value, never evict */
+	RUBIX_CUBE_TRANSPOSITION_REPLACE,	/* take the new value, evict the first slot of the window */
+	RUBIX_CUBE_TRANSPOSITION_KEEP_SMALLER	/* keep the smaller value, evict the largest one if larger than the new one */
+} RubixCubeTranspositionPolicy ;
+
+typedef enum rubix_cube_transposition_result {
+	RUBIX_CUBE_TRANSPOSITION_FULL,		/* nothing was stored */
+	RUBIX_CUBE_TRANSPOSITION_INSERTED,	/* the state is new (maybe in place of an evicted one) */
+	RUBIX_CUBE_TRANSPOSITION_FOUND		/* the state was there already */
+} RubixCubeTranspositionResult ;
+
+typedef struct rubix_cube_transposition_slot {
+	uint64_t 			word ;		/* tag << 32 | value */
+	uint64_t 			reserved ;
+	uint64_t 			key[2] ;	/* the RubixCubePacked bytes */
+} RubixCubeTranspositionSlot ;
+
+typedef struct rubix_cube_transposition_table {
+	RubixCubeTranspositionSlot * 	slots ;
+	size_t 				capacity ;	/* a power of two */
+	size_t 				mapped_size ;
+	RubixCubeTranspositionPolicy 	policy ;
+	int 				huge_pages ;	/* nonzero if the slots are on (explicit) huge pages */
+	size_t 				count ;		/* states stored, updated atomically */
+	size_t 				evictions ;
+} RubixCubeTranspositionTable ;
+
+/* Return a pointer to a freshly allocated empty table of at least @capacity slots */
+/* @flags is RUBIX_CUBE_TRANSPOSITION_* flags or 0, return NULL if the memory can not be had */
+RubixCubeTranspositionTable * rubix_cube_transposition_allocate(size_t capacity, RubixCubeTranspositionPolicy policy, unsigned flags) ;
+
+/* Free all memory associated with a RubixCubeTranspositionTable object */
+void rubix_cube_transposition_free(RubixCubeTranspositionTable * pTable) ;
+
+/* Empty @pTable, no other thread may be using it */
+void rubix_cube_transposition_clear(RubixCubeTranspositionTable * pTable) ;
+
+/* Store @value for @pKey following the table's policy, safe to call from many threads at once */
+/* If @previous is not NULL and the state was there already, set it to the value it had */
+RubixCubeTranspositionResult rubix_cube_transposition_insert(RubixCubeTranspositionTable * pTable, const RubixCubePacked * pKey, uint32_t value, uint32_t * previous) ;
+
+/* Return nonzero and set @value (if not NULL) if @pKey is in the table */
+int rubix_cube_transposition_lookup(const RubixCubeTranspositionTable * pTable, const RubixCubePacked * pKey, uint32_t * value) ;
+
+/* Return the number of states in the table */
+size_t rubix_cube_transposition_count(const RubixCubeTranspositionTable * pTable) ;
+
+#endif // RUBIX_CUBE_TRANSPOSITION_H
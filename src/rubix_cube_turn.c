@@ -0,0 +1,334 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+#include "rubix_cube_turn.h"
+#include "rubix_cube_stats.h"
+#include "rubix_cube_unrolled.h"
+#include <string.h>
+#include <pthread.h>
+
+const RubixCubeFrame rubix_cube_frame_identity = { { 0, 1, 2, 3, 4, 5 } } ;
+
+/* A clockwise quarter rotation about an axis brings the side at [i + 1] to where [i] was, as in rubix_cube_notation.c */
+static const unsigned char rubix_cube_turn_axis_cycles[RUBIX_CUBE_AXIS_COUNT][4] = {
+	{ RUBIX_CUBE_SQUARE_TOP, RUBIX_CUBE_SQUARE_FRONT, RUBIX_CUBE_SQUARE_BOTTOM, RUBIX_CUBE_SQUARE_BACK },
+	{ RUBIX_CUBE_SQUARE_FRONT, RUBIX_CUBE_SQUARE_RIGHT, RUBIX_CUBE_SQUARE_BACK, RUBIX_CUBE_SQUARE_LEFT },
+	{ RUBIX_CUBE_SQUARE_TOP, RUBIX_CUBE_SQUARE_LEFT, RUBIX_CUBE_SQUARE_BOTTOM, RUBIX_CUBE_SQUARE_RIGHT }
+} ;
+
+/* The axis each side turns about, and whether its clockwise is the axis' own (R U F) or the other way (L D B) */
+static const struct {
+	unsigned char 			axis ;
+	unsigned char 			reversed ;
+} rubix_cube_turn_side_axes[RUBIX_CUBE_SIDE_COUNT] = {
+	[RUBIX_CUBE_SQUARE_TOP] 	= { RUBIX_CUBE_AXIS_Y, 0 },
+	[RUBIX_CUBE_SQUARE_FRONT] 	= { RUBIX_CUBE_AXIS_Z, 0 },
+	[RUBIX_CUBE_SQUARE_RIGHT] 	= { RUBIX_CUBE_AXIS_X, 0 },
+	[RUBIX_CUBE_SQUARE_LEFT] 	= { RUBIX_CUBE_AXIS_X, 1 },
+	[RUBIX_CUBE_SQUARE_BACK] 	= { RUBIX_CUBE_AXIS_Z, 1 },
+	[RUBIX_CUBE_SQUARE_BOTTOM] 	= { RUBIX_CUBE_AXIS_Y, 1 }
+} ;
+
+/* The slice about each side's axis, and whether it turns the way that side does */
+static const struct {
+	unsigned char 			slice ;
+	unsigned char 			reversed ;
+} rubix_cube_turn_side_slices[RUBIX_CUBE_SIDE_COUNT] = {
+	[RUBIX_CUBE_SQUARE_TOP] 	= { RUBIX_CUBE_SLICE_E, 1 },
+	[RUBIX_CUBE_SQUARE_FRONT] 	= { RUBIX_CUBE_SLICE_S, 0 },
+	[RUBIX_CUBE_SQUARE_RIGHT] 	= { RUBIX_CUBE_SLICE_M, 1 },
+	[RUBIX_CUBE_SQUARE_LEFT] 	= { RUBIX_CUBE_SLICE_M, 0 },
+	[RUBIX_CUBE_SQUARE_BACK] 	= { RUBIX_CUBE_SLICE_S, 1 },
+	[RUBIX_CUBE_SQUARE_BOTTOM] 	= { RUBIX_CUBE_SLICE_E, 0 }
+} ;
+
+/* The face each slice turns like, in the frame it is held in */
+static const unsigned char rubix_cube_turn_slice_sides[RUBIX_CUBE_SLICE_COUNT] = {
+	RUBIX_CUBE_SQUARE_LEFT, RUBIX_CUBE_SQUARE_BOTTOM, RUBIX_CUBE_SQUARE_FRONT
+} ;
+
+/* Where the center of each side is */
+static const RubixCubePieceReference rubix_cube_turn_centers[RUBIX_CUBE_SIDE_COUNT] = {
+	[RUBIX_CUBE_SQUARE_TOP] 	= { 1, 1 },
+	[RUBIX_CUBE_SQUARE_FRONT] 	= { 0, 4 },
+	[RUBIX_CUBE_SQUARE_RIGHT] 	= { 1, 5 },
+	[RUBIX_CUBE_SQUARE_LEFT] 	= { 1, 3 },
+	[RUBIX_CUBE_SQUARE_BACK] 	= { 2, 4 },
+	[RUBIX_CUBE_SQUARE_BOTTOM] 	= { 1, 7 }
+} ;
+
+static const unsigned char rubix_cube_turn_quarters[RUBIX_CUBE_FACE_ROTATION_COUNT] = { 1, 3, 2 } ;
+
+static inline RubixCubeFaceRotation rubix_cube_turn_reverse(RubixCubeFaceRotation face_rotation, unsigned reversed) {
+	return reversed ? (RubixCubeFaceRotation)RUBIX_CUBE_MOVE_INDEX_INVERSE(face_rotation) : face_rotation ;
+}
+
+void rubix_cube_frame_rotate(RubixCubeFrame * pFrame, RubixCubeAxis axis, RubixCubeFaceRotation face_rotation) {
+	const unsigned char * cycle = rubix_cube_turn_axis_cycles[axis] ;
+	unsigned char * sides = pFrame->sides ;
+
+	unsigned q = rubix_cube_turn_quarters[face_rotation] ;
+	const unsigned char moved[4] = { sides[cycle[0]], sides[cycle[1]], sides[cycle[2]], sides[cycle[3]] } ;
+
+	/* All the quarters at once, each side of the cycle takes the one q places on */
+	for (unsigned i = 0; i < 4; ++i) sides[cycle[i]] = moved[(i + q) & 3] ;
+}
+
+/* The cube was turned about @axis for real, so every side in the frame is now where that turn took it */
+static void rubix_cube_frame_follow(RubixCubeFrame * pFrame, RubixCubeAxis axis, RubixCubeFaceRotation face_rotation) {
+	const unsigned char * cycle = rubix_cube_turn_axis_cycles[axis] ;
+	unsigned quarters = rubix_cube_turn_quarters[face_rotation] ;
+
+	for (size_t side = 0; side < RUBIX_CUBE_SIDE_COUNT; ++side) {
+		for (size_t i = 0; i < 4; ++i) {
+			if (pFrame->sides[side] != cycle[i]) continue ;
+			pFrame->sides[side] = cycle[(i + 4 - quarters) % 4] ;
+			break ;
+		}
+	}
+}
+
+void rubix_cube_rotate_cube(RubixCube * pRubix_cube, RubixCubeAxis axis, RubixCubeFaceRotation face_rotation) {
+	static const unsigned char sides[RUBIX_CUBE_AXIS_COUNT][2] = {
+		{ RUBIX_CUBE_SQUARE_RIGHT, RUBIX_CUBE_SQUARE_LEFT },
+		{ RUBIX_CUBE_SQUARE_TOP, RUBIX_CUBE_SQUARE_BOTTOM },
+		{ RUBIX_CUBE_SQUARE_FRONT, RUBIX_CUBE_SQUARE_BACK }
+	} ;
+
+	if (axis >= RUBIX_CUBE_AXIS_COUNT || face_rotation >= RUBIX_CUBE_FACE_ROTATION_COUNT) return ;
+	rubix_cube_rotate_face(pRubix_cube,sides[axis][0],face_rotation) ;
+	rubix_cube_rotate_slice(pRubix_cube,rubix_cube_turn_side_slices[sides[axis][0]].slice,
+			rubix_cube_turn_reverse(face_rotation,rubix_cube_turn_side_slices[sides[axis][0]].reversed)) ;
+	rubix_cube_rotate_face(pRubix_cube,sides[axis][1],rubix_cube_turn_reverse(face_rotation,1)) ;
+}
+
+/* rubix_cube_apply_turn() for a @code known to be in range, inlined into the loops over whole sequences */
+static inline void rubix_cube_turn_apply(RubixCube * pRubix_cube, RubixCubeFrame * pFrame, unsigned char code) {
+	RubixCubeFaceRotation face_rotation = (RubixCubeFaceRotation)(code % RUBIX_CUBE_FACE_ROTATION_COUNT) ;
+	size_t which ;
+	unsigned char side ;
+
+	if (code < RUBIX_CUBE_TURN_WIDE_FIRST) {
+		rubix_cube_rotate_face(pRubix_cube,pFrame->sides[code / RUBIX_CUBE_FACE_ROTATION_COUNT],face_rotation) ;
+	} else if (code < RUBIX_CUBE_TURN_SLICE_FIRST) {
+		/* Both inner layers of a side are the opposite face staying put while the whole cube turns, r = L x */
+		which = (code - RUBIX_CUBE_TURN_WIDE_FIRST) / RUBIX_CUBE_FACE_ROTATION_COUNT ;
+		rubix_cube_rotate_face(pRubix_cube,pFrame->sides[RUBIX_CUBE_SIDE_COUNT - 1 - which],face_rotation) ;
+		rubix_cube_frame_rotate(pFrame,rubix_cube_turn_side_axes[which].axis,
+				rubix_cube_turn_reverse(face_rotation,rubix_cube_turn_side_axes[which].reversed)) ;
+	} else if (code < RUBIX_CUBE_TURN_ROTATION_FIRST) {
+		which = (code - RUBIX_CUBE_TURN_SLICE_FIRST) / RUBIX_CUBE_FACE_ROTATION_COUNT ;
+		side = pFrame->sides[rubix_cube_turn_slice_sides[which]] ;
+		/* In range by construction, so straight to the unrolled turn without rubix_cube_rotate_slice()'s checks */
+		rubix_cube_unrolled_rotate_slice(pRubix_cube,rubix_cube_turn_side_slices[side].slice,
+				rubix_cube_turn_reverse(face_rotation,rubix_cube_turn_side_slices[side].reversed)) ;
+	} else {
+		which = (code - RUBIX_CUBE_TURN_ROTATION_FIRST) / RUBIX_CUBE_FACE_ROTATION_COUNT ;
+		rubix_cube_frame_rotate(pFrame,(RubixCubeAxis)which,face_rotation) ;
+	}
+}
+
+int rubix_cube_apply_turn(RubixCube * pRubix_cube, RubixCubeFrame * pFrame, unsigned char code) {
+	if (code >= RUBIX_CUBE_TURN_COUNT) return 0 ;
+	rubix_cube_turn_apply(pRubix_cube,pFrame,code) ;
+	return 1 ;
+}
+
+/*
+ * A frame can only be one of the 24 ways to hold a cube, so the loops over whole
+ * sequences keep it as an index into rubix_cube_turn_frames. For each of those and
+ * each code the tables hold the unrolled turn to make, if any, and the frame after
+ * it: a face or slice code is then one call, and x, y, z or a wide turn one lookup,
+ * instead of going through the sides of the frame every time.
+ */
+#define RUBIX_CUBE_TURN_FRAME_COUNT 	24
+#define RUBIX_CUBE_TURN_FRAME_NONE 	0xff
+
+static RubixCubeFrame rubix_cube_turn_frames[RUBIX_CUBE_TURN_FRAME_COUNT] ;
+static unsigned char rubix_cube_turn_frame_index[RUBIX_CUBE_SIDE_COUNT][RUBIX_CUBE_SIDE_COUNT] ;	/* by the sides of U and F */
+static RubixCubeUnrolledTurn rubix_cube_turn_frame_turns[RUBIX_CUBE_TURN_FRAME_COUNT][RUBIX_CUBE_TURN_COUNT] ;
+static unsigned char rubix_cube_turn_frame_next[RUBIX_CUBE_TURN_FRAME_COUNT][RUBIX_CUBE_TURN_COUNT] ;
+
+static pthread_once_t rubix_cube_turn_tables_once = PTHREAD_ONCE_INIT ;
+static int rubix_cube_turn_tables_ready ;
+
+/* The index of @pFrame, RUBIX_CUBE_TURN_FRAME_NONE if it is not a way to hold a cube */
+static unsigned rubix_cube_turn_frame_find(const RubixCubeFrame * pFrame) {
+	unsigned index ;
+
+	if (pFrame->sides[RUBIX_CUBE_SQUARE_TOP] >= RUBIX_CUBE_SIDE_COUNT || pFrame->sides[RUBIX_CUBE_SQUARE_FRONT] >= RUBIX_CUBE_SIDE_COUNT) {
+		return RUBIX_CUBE_TURN_FRAME_NONE ;
+	}
+	index = rubix_cube_turn_frame_index[pFrame->sides[RUBIX_CUBE_SQUARE_TOP]][pFrame->sides[RUBIX_CUBE_SQUARE_FRONT]] ;
+	if (index == RUBIX_CUBE_TURN_FRAME_NONE || memcmp(&rubix_cube_turn_frames[index],pFrame,sizeof(RubixCubeFrame))) {
+		return RUBIX_CUBE_TURN_FRAME_NONE ;
+	}
+	return index ;
+}
+
+static void rubix_cube_turn_build_tables(void) {
+	size_t count = 1 ;
+
+	memset(rubix_cube_turn_frame_index,RUBIX_CUBE_TURN_FRAME_NONE,sizeof(rubix_cube_turn_frame_index)) ;
+	rubix_cube_turn_frames[0] = rubix_cube_frame_identity ;
+	rubix_cube_turn_frame_index[RUBIX_CUBE_SQUARE_TOP][RUBIX_CUBE_SQUARE_FRONT] = 0 ;
+
+	/* Every frame the rotations reach from the identity, each new one is tried in turn */
+	for (size_t i = 0; i < count; ++i) {
+		for (size_t axis = 0; axis < RUBIX_CUBE_AXIS_COUNT; ++axis) {
+			RubixCubeFrame frame = rubix_cube_turn_frames[i] ;
+			unsigned char * index ;
+
+			rubix_cube_frame_rotate(&frame,(RubixCubeAxis)axis,RUBIX_CUBE_FACE_ROTATION_CLOCKWISE) ;
+			index = &rubix_cube_turn_frame_index[frame.sides[RUBIX_CUBE_SQUARE_TOP]][frame.sides[RUBIX_CUBE_SQUARE_FRONT]] ;
+			if (*index != RUBIX_CUBE_TURN_FRAME_NONE) continue ;
+			*index = (unsigned char)count ;
+			rubix_cube_turn_frames[count++] = frame ;
+		}
+	}
+
+	for (size_t i = 0; i < RUBIX_CUBE_TURN_FRAME_COUNT; ++i) {
+		const unsigned char * sides = rubix_cube_turn_frames[i].sides ;
+
+		for (size_t code = 0; code < RUBIX_CUBE_TURN_COUNT; ++code) {
+			RubixCubeFaceRotation face_rotation = (RubixCubeFaceRotation)(code % RUBIX_CUBE_FACE_ROTATION_COUNT) ;
+			RubixCubeFrame frame = rubix_cube_turn_frames[i] ;
+			RubixCubeUnrolledTurn turn = NULL ;
+			size_t which ;
+
+			/* As rubix_cube_turn_apply() does them */
+			if (code < RUBIX_CUBE_TURN_WIDE_FIRST) {
+				turn = rubix_cube_unrolled_turns[RUBIX_CUBE_MOVE_INDEX(sides[code / RUBIX_CUBE_FACE_ROTATION_COUNT],face_rotation)] ;
+			} else if (code < RUBIX_CUBE_TURN_SLICE_FIRST) {
+				which = (code - RUBIX_CUBE_TURN_WIDE_FIRST) / RUBIX_CUBE_FACE_ROTATION_COUNT ;
+				turn = rubix_cube_unrolled_turns[RUBIX_CUBE_MOVE_INDEX(sides[RUBIX_CUBE_SIDE_COUNT - 1 - which],face_rotation)] ;
+				rubix_cube_frame_rotate(&frame,rubix_cube_turn_side_axes[which].axis,
+						rubix_cube_turn_reverse(face_rotation,rubix_cube_turn_side_axes[which].reversed)) ;
+			} else if (code < RUBIX_CUBE_TURN_ROTATION_FIRST) {
+				unsigned char side = sides[rubix_cube_turn_slice_sides[(code - RUBIX_CUBE_TURN_SLICE_FIRST) / RUBIX_CUBE_FACE_ROTATION_COUNT]] ;
+				turn = rubix_cube_unrolled_slice_turns[(size_t)rubix_cube_turn_side_slices[side].slice * RUBIX_CUBE_FACE_ROTATION_COUNT +
+						rubix_cube_turn_reverse(face_rotation,rubix_cube_turn_side_slices[side].reversed)] ;
+			} else {
+				which = (code - RUBIX_CUBE_TURN_ROTATION_FIRST) / RUBIX_CUBE_FACE_ROTATION_COUNT ;
+				rubix_cube_frame_rotate(&frame,(RubixCubeAxis)which,face_rotation) ;
+			}
+			rubix_cube_turn_frame_turns[i][code] = turn ;
+			rubix_cube_turn_frame_next[i][code] = rubix_cube_turn_frame_index[frame.sides[RUBIX_CUBE_SQUARE_TOP]][frame.sides[RUBIX_CUBE_SQUARE_FRONT]] ;
+		}
+	}
+	__atomic_store_n(&rubix_cube_turn_tables_ready,1,__ATOMIC_RELEASE) ;
+}
+
+static inline void rubix_cube_turn_init_tables(void) {
+	if (__builtin_expect(!__atomic_load_n(&rubix_cube_turn_tables_ready,__ATOMIC_ACQUIRE),0)) {
+		pthread_once(&rubix_cube_turn_tables_once,rubix_cube_turn_build_tables) ;
+	}
+}
+
+/* Make @code from frame @frame, return the frame after it */
+static inline unsigned rubix_cube_turn_step(RubixCube * pRubix_cube, unsigned frame, unsigned char code) {
+	RubixCubeUnrolledTurn turn = rubix_cube_turn_frame_turns[frame][code] ;
+
+	/* The face turns of face and wide codes count as rubix_cube_rotate_face() ones */
+	if (code < RUBIX_CUBE_TURN_SLICE_FIRST) {
+		RUBIX_CUBE_STATS_ADD(rotate_face[rubix_cube_turn_frames[frame].sides[code < RUBIX_CUBE_TURN_WIDE_FIRST ?
+				code / RUBIX_CUBE_FACE_ROTATION_COUNT :
+				RUBIX_CUBE_SIDE_COUNT - 1 - (code - RUBIX_CUBE_TURN_WIDE_FIRST) / RUBIX_CUBE_FACE_ROTATION_COUNT]],1) ;
+	}
+	if (turn) turn(pRubix_cube) ;
+	return rubix_cube_turn_frame_next[frame][code] ;
+}
+
+static int rubix_cube_turn_codes_valid(const unsigned char * codes, size_t count) {
+	for (size_t i = 0; i < count; ++i) {
+		if (codes[i] >= RUBIX_CUBE_TURN_COUNT) return 0 ;
+	}
+	return 1 ;
+}
+
+int rubix_cube_apply_turn_codes(RubixCube * pRubix_cube, RubixCubeFrame * pFrame, const unsigned char * codes, size_t count) {
+	unsigned frame ;
+
+	if (!rubix_cube_turn_codes_valid(codes,count)) return 0 ;
+	rubix_cube_turn_init_tables() ;
+	if ((frame = rubix_cube_turn_frame_find(pFrame)) == RUBIX_CUBE_TURN_FRAME_NONE) {
+		for (size_t i = 0; i < count; ++i) rubix_cube_turn_apply(pRubix_cube,pFrame,codes[i]) ;
+		return 1 ;
+	}
+	for (size_t i = 0; i < count; ++i) frame = rubix_cube_turn_step(pRubix_cube,frame,codes[i]) ;
+	*pFrame = rubix_cube_turn_frames[frame] ;
+	return 1 ;
+}
+
+int rubix_cube_unapply_turn_codes(RubixCube * pRubix_cube, RubixCubeFrame * pFrame, const unsigned char * codes, size_t count) {
+	unsigned frame ;
+
+	if (!rubix_cube_turn_codes_valid(codes,count)) return 0 ;
+	rubix_cube_turn_init_tables() ;
+	if ((frame = rubix_cube_turn_frame_find(pFrame)) == RUBIX_CUBE_TURN_FRAME_NONE) {
+		for (size_t i = count; i > 0; --i) {
+			rubix_cube_turn_apply(pRubix_cube,pFrame,(unsigned char)RUBIX_CUBE_MOVE_INDEX_INVERSE(codes[i-1])) ;
+		}
+		return 1 ;
+	}
+	for (size_t i = count; i > 0; --i) {
+		frame = rubix_cube_turn_step(pRubix_cube,frame,(unsigned char)RUBIX_CUBE_MOVE_INDEX_INVERSE(codes[i-1])) ;
+	}
+	*pFrame = rubix_cube_turn_frames[frame] ;
+	return 1 ;
+}
+
+/* The side whose center has the color of @square's, looked for among @count @candidates */
+static unsigned char rubix_cube_turn_find_center(const RubixCube * pRubix_cube, unsigned char square, const unsigned char * candidates, size_t count) {
+	const RubixCubePieceReference * home = &rubix_cube_turn_centers[square] ;
+	RubixCubeColor color = rubix_cube_solved.planes[home->plane][home->index].sides[square] ;
+
+	for (size_t i = 0; i < count; ++i) {
+		const RubixCubePieceReference * ref = &rubix_cube_turn_centers[candidates[i]] ;
+		if (pRubix_cube->planes[ref->plane][ref->index].sides[candidates[i]] == color) return candidates[i] ;
+	}
+	return square ;
+}
+
+/* Turn the whole cube, and the frame along with it, if any */
+static inline void rubix_cube_turn_whole(RubixCube * pRubix_cube, RubixCubeFrame * pFrame, RubixCubeAxis axis, RubixCubeFaceRotation face_rotation) {
+	rubix_cube_rotate_cube(pRubix_cube,axis,face_rotation) ;
+	if (pFrame) rubix_cube_frame_follow(pFrame,axis,face_rotation) ;
+}
+
+void rubix_cube_recenter(RubixCube * pRubix_cube, RubixCubeFrame * pFrame) {
+	static const unsigned char all[RUBIX_CUBE_SIDE_COUNT] = { 0, 1, 2, 3, 4, 5 } ;
+	static const unsigned char around[4] = {
+		RUBIX_CUBE_SQUARE_FRONT, RUBIX_CUBE_SQUARE_RIGHT, RUBIX_CUBE_SQUARE_BACK, RUBIX_CUBE_SQUARE_LEFT
+	} ;
+
+	/* The top center goes home first with an x or z, which leaves at most a y for the front one */
+	switch (rubix_cube_turn_find_center(pRubix_cube,RUBIX_CUBE_SQUARE_TOP,all,RUBIX_CUBE_SIDE_COUNT)) {
+	case RUBIX_CUBE_SQUARE_FRONT: 	rubix_cube_turn_whole(pRubix_cube,pFrame,RUBIX_CUBE_AXIS_X,RUBIX_CUBE_FACE_ROTATION_CLOCKWISE) ; break ;
+	case RUBIX_CUBE_SQUARE_BOTTOM: 	rubix_cube_turn_whole(pRubix_cube,pFrame,RUBIX_CUBE_AXIS_X,RUBIX_CUBE_FACE_ROTATION_DOUBLE) ; break ;
+	case RUBIX_CUBE_SQUARE_BACK: 	rubix_cube_turn_whole(pRubix_cube,pFrame,RUBIX_CUBE_AXIS_X,RUBIX_CUBE_FACE_ROTATION_COUNTERCLOCKWISE) ; break ;
+	case RUBIX_CUBE_SQUARE_LEFT: 	rubix_cube_turn_whole(pRubix_cube,pFrame,RUBIX_CUBE_AXIS_Z,RUBIX_CUBE_FACE_ROTATION_CLOCKWISE) ; break ;
+	case RUBIX_CUBE_SQUARE_RIGHT: 	rubix_cube_turn_whole(pRubix_cube,pFrame,RUBIX_CUBE_AXIS_Z,RUBIX_CUBE_FACE_ROTATION_COUNTERCLOCKWISE) ; break ;
+	default: break ;
+	}
+	switch (rubix_cube_turn_find_center(pRubix_cube,RUBIX_CUBE_SQUARE_FRONT,around,4)) {
+	case RUBIX_CUBE_SQUARE_RIGHT: 	rubix_cube_turn_whole(pRubix_cube,pFrame,RUBIX_CUBE_AXIS_Y,RUBIX_CUBE_FACE_ROTATION_CLOCKWISE) ; break ;
+	case RUBIX_CUBE_SQUARE_BACK: 	rubix_cube_turn_whole(pRubix_cube,pFrame,RUBIX_CUBE_AXIS_Y,RUBIX_CUBE_FACE_ROTATION_DOUBLE) ; break ;
+	case RUBIX_CUBE_SQUARE_LEFT: 	rubix_cube_turn_whole(pRubix_cube,pFrame,RUBIX_CUBE_AXIS_Y,RUBIX_CUBE_FACE_ROTATION_COUNTERCLOCKWISE) ; break ;
+	default: break ;
+	}
+}
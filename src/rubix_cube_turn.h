@@ -0,0 +1,87 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+/*
+ * Turns:
+ *
+ * A RubixCubeMove only turns one of the six faces, so a slice, wide or whole cube
+ * move used to cost two or three face turns (see rubix_cube_notation.h). Turn codes
+ * add them as moves of their own, one byte each like the move codes of
+ * rubix_cube_packed_scramble.h, which they extend:
+ *
+ * 	 0 to 17 	faces, 	side * 3 + rotation 	(the move codes as they are)
+ * 	18 to 35 	wide, 	18 + side * 3 + rotation
+ * 	36 to 44 	slices, 36 + slice * 3 + rotation 	(M as L, E as D, S as F)
+ * 	45 to 53 	whole cube rotations, 45 + axis * 3 + rotation 	(x as R, y as U, z as F)
+ *
+ * Slices are one quadset pass on the middle layer, no matter what the centers do. A
+ * whole cube rotation moves no pieces at all: a RubixCubeFrame keeps how the cube is
+ * held, which physical side each face letter means, and is all that changes. A wide
+ * turn is then the opposite face and a rotation of the frame, so r is one face turn.
+ * rubix_cube_recenter() turns the whole cube for real when the centers have to be
+ * home again, which gives the same cube rubix_cube_notation_parse() makes.
+ */
+
+#ifndef RUBIX_CUBE_TURN_H
+#define RUBIX_CUBE_TURN_H "rubix_cube_turn.h"
+
+#include "rubix_cube.h"
+
+/* The axes of whole cube rotations, each turning the way its face does */
+typedef enum rubix_cube_axis {
+	RUBIX_CUBE_AXIS_X,	/* as R */
+	RUBIX_CUBE_AXIS_Y,	/* as U */
+	RUBIX_CUBE_AXIS_Z	/* as F */
+} RubixCubeAxis ;
+#define RUBIX_CUBE_AXIS_COUNT 		3
+
+#define RUBIX_CUBE_TURN_WIDE_FIRST 	RUBIX_CUBE_MOVE_COUNT
+#define RUBIX_CUBE_TURN_SLICE_FIRST 	(RUBIX_CUBE_TURN_WIDE_FIRST + RUBIX_CUBE_MOVE_COUNT)
+#define RUBIX_CUBE_TURN_ROTATION_FIRST 	(RUBIX_CUBE_TURN_SLICE_FIRST + RUBIX_CUBE_SLICE_COUNT * RUBIX_CUBE_FACE_ROTATION_COUNT)
+#define RUBIX_CUBE_TURN_COUNT 		(RUBIX_CUBE_TURN_ROTATION_FIRST + RUBIX_CUBE_AXIS_COUNT * RUBIX_CUBE_FACE_ROTATION_COUNT)
+
+/* Turn codes, a face turn is RUBIX_CUBE_MOVE_INDEX() and RUBIX_CUBE_MOVE_INDEX_INVERSE() undoes any of them */
+#define RUBIX_CUBE_TURN_FACE(side, rotation) 		RUBIX_CUBE_MOVE_INDEX(side,rotation)
+#define RUBIX_CUBE_TURN_WIDE(side, rotation) 		(RUBIX_CUBE_TURN_WIDE_FIRST + RUBIX_CUBE_MOVE_INDEX(side,rotation))
+#define RUBIX_CUBE_TURN_SLICE(slice, rotation) 		(RUBIX_CUBE_TURN_SLICE_FIRST + RUBIX_CUBE_MOVE_INDEX(slice,rotation))
+#define RUBIX_CUBE_TURN_ROTATION(axis, rotation) 	(RUBIX_CUBE_TURN_ROTATION_FIRST + RUBIX_CUBE_MOVE_INDEX(axis,rotation))
+
+/* How a cube is held: @sides[square] is the physical side that face letter turns */
+typedef struct rubix_cube_frame {
+	unsigned char 			sides[RUBIX_CUBE_SIDE_COUNT] ;
+} RubixCubeFrame ;
+
+/* The frame a cube starts out held in, every side where it is */
+extern const RubixCubeFrame rubix_cube_frame_identity ;
+
+/* Turn the frame @pFrame like the whole cube rotation about @axis */
+void rubix_cube_frame_rotate(RubixCubeFrame * pFrame, RubixCubeAxis axis, RubixCubeFaceRotation face_rotation) ;
+
+/* Turn the whole cube for real, all three layers about @axis */
+void rubix_cube_rotate_cube(RubixCube * pRubix_cube, RubixCubeAxis axis, RubixCubeFaceRotation face_rotation) ;
+
+/* Make turn @code on a cube held in @pFrame, which is updated by rotations and wide turns. 0 if it is not a turn code */
+int rubix_cube_apply_turn(RubixCube * pRubix_cube, RubixCubeFrame * pFrame, unsigned char code) ;
+
+/* Make @count turns in order, or undo them in reverse. 0 and nothing done if one of them is not a turn code */
+int rubix_cube_apply_turn_codes(RubixCube * pRubix_cube, RubixCubeFrame * pFrame, const unsigned char * codes, size_t count) ;
+int rubix_cube_unapply_turn_codes(RubixCube * pRubix_cube, RubixCubeFrame * pFrame, const unsigned char * codes, size_t count) ;
+
+/* Turn the whole cube so its centers are home, and @pFrame (if not NULL) with it so that it still turns the same layers */
+void rubix_cube_recenter(RubixCube * pRubix_cube, RubixCubeFrame * pFrame) ;
+
+#endif // RUBIX_CUBE_TURN_H
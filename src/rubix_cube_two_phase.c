@@ -0,0 +1,497 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+#include "rubix_cube_two_phase.h"
+#include "rubix_cube_rank.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdint.h>
+
+/*
+ * Coordinates:
+ *
+ * phase 1	twist 		corner orientations 				2187
+ * 		flip 		edge orientations 				2048
+ * 		slice 		which positions hold the middle layer edges 	495
+ * phase 2 	corners 	corner permutation 				40320
+ * 		edges 		permutation of the 8 top and bottom edges 	40320
+ * 		slice_order 	permutation of the 4 middle layer edges 	24
+ *
+ * Every coordinate is 0 on the solved cube.
+ */
+#define RUBIX_CUBE_TWO_PHASE_TWISTS 		2187
+#define RUBIX_CUBE_TWO_PHASE_FLIPS 		2048
+#define RUBIX_CUBE_TWO_PHASE_SLICES 		495
+#define RUBIX_CUBE_TWO_PHASE_CORNERS 		40320
+#define RUBIX_CUBE_TWO_PHASE_EDGES 		40320
+#define RUBIX_CUBE_TWO_PHASE_SLICE_ORDERS 	24
+
+/* Edges RUBIX_CUBE_EDGE_FR to RUBIX_CUBE_EDGE_BR are the middle layer */
+#define RUBIX_CUBE_TWO_PHASE_SLICE_EDGE(edge) 	((edge) >= RUBIX_CUBE_EDGE_FR)
+
+#define RUBIX_CUBE_TWO_PHASE_UNKNOWN 		0xff
+#define RUBIX_CUBE_TWO_PHASE_NO_SIDE 		RUBIX_CUBE_SIDE_COUNT
+#define RUBIX_CUBE_TWO_PHASE_CLOCK_INTERVAL 	4096
+
+/* Every table the search reads, kept together so that they can be saved and mapped as one block */
+typedef struct rubix_cube_two_phase_tables {
+	unsigned short 		twist_moves 		[RUBIX_CUBE_TWO_PHASE_TWISTS][RUBIX_CUBE_MOVE_COUNT] ;
+	unsigned short 		flip_moves 		[RUBIX_CUBE_TWO_PHASE_FLIPS][RUBIX_CUBE_MOVE_COUNT] ;
+	unsigned short 		slice_moves 		[RUBIX_CUBE_TWO_PHASE_SLICES][RUBIX_CUBE_MOVE_COUNT] ;
+	unsigned short 		corner_moves 		[RUBIX_CUBE_TWO_PHASE_CORNERS][RUBIX_CUBE_MOVE_COUNT] ;
+	unsigned short 		edge_moves 		[RUBIX_CUBE_TWO_PHASE_EDGES][RUBIX_CUBE_MOVE_COUNT] ;
+	unsigned short 		slice_order_moves 	[RUBIX_CUBE_TWO_PHASE_SLICE_ORDERS][RUBIX_CUBE_MOVE_COUNT] ;
+
+	/* Distances to the goal of each phase over pairs of coordinates, indexed slice * count + other */
+	unsigned char 		slice_twist_prune 	[RUBIX_CUBE_TWO_PHASE_SLICES * RUBIX_CUBE_TWO_PHASE_TWISTS] ;
+	unsigned char 		slice_flip_prune 	[RUBIX_CUBE_TWO_PHASE_SLICES * RUBIX_CUBE_TWO_PHASE_FLIPS] ;
+	unsigned char 		corner_prune 		[RUBIX_CUBE_TWO_PHASE_SLICE_ORDERS * RUBIX_CUBE_TWO_PHASE_CORNERS] ;
+	unsigned char 		edge_prune 		[RUBIX_CUBE_TWO_PHASE_SLICE_ORDERS * RUBIX_CUBE_TWO_PHASE_EDGES] ;
+} RubixCubeTwoPhaseTables ;
+
+/* What a two phase table file was built for, a file from a build with other coordinates is refused */
+static const uint32_t rubix_cube_two_phase_parameters[] = {
+	RUBIX_CUBE_TWO_PHASE_TWISTS, RUBIX_CUBE_TWO_PHASE_FLIPS, RUBIX_CUBE_TWO_PHASE_SLICES,
+	RUBIX_CUBE_TWO_PHASE_CORNERS, RUBIX_CUBE_TWO_PHASE_EDGES, RUBIX_CUBE_TWO_PHASE_SLICE_ORDERS,
+	RUBIX_CUBE_MOVE_COUNT, sizeof(RubixCubeTwoPhaseTables)
+} ;
+
+/* Set once, either to the built tables or to a mapped file, and never changed after */
+static const RubixCubeTwoPhaseTables * rubix_cube_two_phase_tables ;
+static RubixCubeTwoPhaseTables rubix_cube_two_phase_built ;
+static RubixCubeTableMapping rubix_cube_two_phase_mapping ;
+static pthread_mutex_t rubix_cube_two_phase_tables_lock = PTHREAD_MUTEX_INITIALIZER ;
+
+/* Moves allowed in phase 2, as RUBIX_CUBE_MOVE_INDEX() values */
+static unsigned char rubix_cube_two_phase_phase2_moves[RUBIX_CUBE_MOVE_COUNT] ;
+static size_t rubix_cube_two_phase_phase2_move_count ;
+static unsigned char rubix_cube_two_phase_is_phase2_move[RUBIX_CUBE_MOVE_COUNT] ;
+
+/* n choose k for n < 12 */
+static unsigned rubix_cube_two_phase_choose(unsigned n, unsigned k) {
+	unsigned result = 1 ;
+	if (k > n) return 0 ;
+	for (unsigned i = 0; i < k; ++i) result = result * (n - i) / (i + 1) ;
+	return result ;
+}
+
+/* Rank a permutation of @count small values by Lehmer code */
+static unsigned rubix_cube_two_phase_rank_order(const unsigned char * values, size_t count) {
+	unsigned rank = 0 ;
+	for (size_t i = 0; i < count; ++i) {
+		unsigned smaller = 0 ;
+		for (size_t j = i + 1; j < count; ++j) smaller += values[j] < values[i] ;
+		rank = rank * (unsigned)(count - i) + smaller ;
+	}
+	return rank ;
+}
+
+static void rubix_cube_two_phase_unrank_order(unsigned char * values, size_t count, unsigned rank, unsigned char first) {
+	unsigned char digits[RUBIX_CUBE_EDGE_COUNT], left[RUBIX_CUBE_EDGE_COUNT] ;
+	for (size_t i = count; i > 0; --i) {
+		digits[i - 1] = (unsigned char)(rank % (count - (i - 1))) ;
+		rank /= count - (i - 1) ;
+	}
+	for (size_t i = 0; i < count; ++i) left[i] = (unsigned char)(first + i) ;
+	for (size_t i = 0; i < count; ++i) {
+		values[i] = left[digits[i]] ;
+		for (size_t j = digits[i]; j + 1 < count - i; ++j) left[j] = left[j + 1] ;
+	}
+}
+
+/* Positions counted from the back so that the solved slice (positions 8 to 11) ranks 0 */
+static unsigned rubix_cube_two_phase_get_slice(const RubixCubeCubie * pCubie) {
+	unsigned rank = 0, k = 0 ;
+	for (unsigned q = 0; q < RUBIX_CUBE_EDGE_COUNT; ++q) {
+		if (RUBIX_CUBE_TWO_PHASE_SLICE_EDGE(pCubie->edge_permutation[RUBIX_CUBE_EDGE_COUNT - 1 - q])) {
+			rank += rubix_cube_two_phase_choose(q,++k) ;
+		}
+	}
+	return rank ;
+}
+
+static void rubix_cube_two_phase_set_slice(RubixCubeCubie * pCubie, unsigned rank) {
+	unsigned char slice = RUBIX_CUBE_EDGE_FR, other = RUBIX_CUBE_EDGE_UR ;
+	unsigned k = 4 ;
+	for (unsigned q = RUBIX_CUBE_EDGE_COUNT; q > 0; --q) {
+		unsigned char * edge = &pCubie->edge_permutation[RUBIX_CUBE_EDGE_COUNT - q] ;
+		if (k && rank >= rubix_cube_two_phase_choose(q - 1,k)) {
+			rank -= rubix_cube_two_phase_choose(q - 1,k--) ;
+			*edge = slice++ ;
+		} else {
+			*edge = other++ ;
+		}
+	}
+	memset(pCubie->edge_orientation,0,sizeof(pCubie->edge_orientation)) ;
+}
+
+static unsigned rubix_cube_two_phase_get_edges(const RubixCubeCubie * pCubie) {
+	return rubix_cube_two_phase_rank_order(pCubie->edge_permutation,RUBIX_CUBE_EDGE_FR) ;
+}
+
+static void rubix_cube_two_phase_set_edges(RubixCubeCubie * pCubie, unsigned rank) {
+	rubix_cube_two_phase_unrank_order(pCubie->edge_permutation,RUBIX_CUBE_EDGE_FR,rank,RUBIX_CUBE_EDGE_UR) ;
+}
+
+static unsigned rubix_cube_two_phase_get_slice_order(const RubixCubeCubie * pCubie) {
+	return rubix_cube_two_phase_rank_order(&pCubie->edge_permutation[RUBIX_CUBE_EDGE_FR],RUBIX_CUBE_EDGE_COUNT - RUBIX_CUBE_EDGE_FR) ;
+}
+
+static void rubix_cube_two_phase_set_slice_order(RubixCubeCubie * pCubie, unsigned rank) {
+	rubix_cube_two_phase_unrank_order(&pCubie->edge_permutation[RUBIX_CUBE_EDGE_FR],RUBIX_CUBE_EDGE_COUNT - RUBIX_CUBE_EDGE_FR,rank,RUBIX_CUBE_EDGE_FR) ;
+}
+
+static unsigned rubix_cube_two_phase_get_twist(const RubixCubeCubie * pCubie) {
+	return (unsigned)rubix_cube_rank_corner_orientation(pCubie) ;
+}
+
+static void rubix_cube_two_phase_set_twist(RubixCubeCubie * pCubie, unsigned rank) {
+	rubix_cube_unrank_corner_orientation(pCubie,rank) ;
+}
+
+static unsigned rubix_cube_two_phase_get_flip(const RubixCubeCubie * pCubie) {
+	return (unsigned)rubix_cube_rank_edge_orientation(pCubie) ;
+}
+
+static void rubix_cube_two_phase_set_flip(RubixCubeCubie * pCubie, unsigned rank) {
+	rubix_cube_unrank_edge_orientation(pCubie,rank) ;
+}
+
+static unsigned rubix_cube_two_phase_get_corners(const RubixCubeCubie * pCubie) {
+	return (unsigned)rubix_cube_rank_corner_permutation(pCubie) ;
+}
+
+static void rubix_cube_two_phase_set_corners(RubixCubeCubie * pCubie, unsigned rank) {
+	rubix_cube_unrank_corner_permutation(pCubie,rank) ;
+}
+
+typedef unsigned (*RubixCubeTwoPhaseGet)(const RubixCubeCubie * pCubie) ;
+typedef void (*RubixCubeTwoPhaseSet)(RubixCubeCubie * pCubie, unsigned rank) ;
+
+/* Fill a coordinate move table by setting up a cubie for each value and turning it, skipping moves @only doesn't allow */
+static void rubix_cube_two_phase_build_moves(unsigned short (*table)[RUBIX_CUBE_MOVE_COUNT], size_t count,
+					     RubixCubeTwoPhaseGet get, RubixCubeTwoPhaseSet set, const unsigned char * only) {
+	for (size_t value = 0; value < count; ++value) {
+		RubixCubeCubie cubie = rubix_cube_cubie_generate_solved(), moved ;
+		set(&cubie,(unsigned)value) ;
+		for (size_t m = 0; m < RUBIX_CUBE_MOVE_COUNT; ++m) {
+			if (only && !only[m]) {
+				table[value][m] = 0 ;
+				continue ;
+			}
+			rubix_cube_cubie_multiply(&moved,&cubie,rubix_cube_cubie_get_move(m / RUBIX_CUBE_FACE_ROTATION_COUNT,m % RUBIX_CUBE_FACE_ROTATION_COUNT)) ;
+			table[value][m] = (unsigned short)get(&moved) ;
+		}
+	}
+}
+
+/* Breadth first search from 0 over pairs (slice-like coordinate, other coordinate) */
+static void rubix_cube_two_phase_build_prune(unsigned char * table, const unsigned short (*first_moves)[RUBIX_CUBE_MOVE_COUNT], size_t first_count,
+					     const unsigned short (*second_moves)[RUBIX_CUBE_MOVE_COUNT], size_t second_count,
+					     const unsigned char * moves, size_t number_of_moves) {
+	size_t size = first_count * second_count, found = 1 ;
+
+	memset(table,RUBIX_CUBE_TWO_PHASE_UNKNOWN,size) ;
+	table[0] = 0 ;
+
+	for (unsigned depth = 0; found; ++depth) {
+		found = 0 ;
+		for (size_t index = 0; index < size; ++index) {
+			if (table[index] != depth) continue ;
+			size_t first = index / second_count, second = index % second_count ;
+			for (size_t i = 0; i < number_of_moves; ++i) {
+				size_t next = (size_t)first_moves[first][moves[i]] * second_count + second_moves[second][moves[i]] ;
+				if (table[next] == RUBIX_CUBE_TWO_PHASE_UNKNOWN) {
+					table[next] = (unsigned char)(depth + 1) ;
+					++found ;
+				}
+			}
+		}
+	}
+}
+
+static void rubix_cube_two_phase_build_move_lists(void) {
+	rubix_cube_two_phase_phase2_move_count = 0 ;
+	for (size_t m = 0; m < RUBIX_CUBE_MOVE_COUNT; ++m) {
+		size_t side = m / RUBIX_CUBE_FACE_ROTATION_COUNT, rotation = m % RUBIX_CUBE_FACE_ROTATION_COUNT ;
+		rubix_cube_two_phase_is_phase2_move[m] = side == (RUBIX_CUBE_SQUARE_TOP) || side == (RUBIX_CUBE_SQUARE_BOTTOM) ||
+			rotation == RUBIX_CUBE_FACE_ROTATION_DOUBLE ;
+		if (rubix_cube_two_phase_is_phase2_move[m]) rubix_cube_two_phase_phase2_moves[rubix_cube_two_phase_phase2_move_count++] = (unsigned char)m ;
+	}
+}
+
+static void rubix_cube_two_phase_build_tables(RubixCubeTwoPhaseTables * pTables) {
+	unsigned char all_moves[RUBIX_CUBE_MOVE_COUNT] ;
+
+	for (size_t m = 0; m < RUBIX_CUBE_MOVE_COUNT; ++m) all_moves[m] = (unsigned char)m ;
+
+	rubix_cube_two_phase_build_moves(pTables->twist_moves,RUBIX_CUBE_TWO_PHASE_TWISTS,
+					 rubix_cube_two_phase_get_twist,rubix_cube_two_phase_set_twist,NULL) ;
+	rubix_cube_two_phase_build_moves(pTables->flip_moves,RUBIX_CUBE_TWO_PHASE_FLIPS,
+					 rubix_cube_two_phase_get_flip,rubix_cube_two_phase_set_flip,NULL) ;
+	rubix_cube_two_phase_build_moves(pTables->slice_moves,RUBIX_CUBE_TWO_PHASE_SLICES,
+					 rubix_cube_two_phase_get_slice,rubix_cube_two_phase_set_slice,NULL) ;
+	rubix_cube_two_phase_build_moves(pTables->corner_moves,RUBIX_CUBE_TWO_PHASE_CORNERS,
+					 rubix_cube_two_phase_get_corners,rubix_cube_two_phase_set_corners,rubix_cube_two_phase_is_phase2_move) ;
+	rubix_cube_two_phase_build_moves(pTables->edge_moves,RUBIX_CUBE_TWO_PHASE_EDGES,
+					 rubix_cube_two_phase_get_edges,rubix_cube_two_phase_set_edges,rubix_cube_two_phase_is_phase2_move) ;
+	rubix_cube_two_phase_build_moves(pTables->slice_order_moves,RUBIX_CUBE_TWO_PHASE_SLICE_ORDERS,
+					 rubix_cube_two_phase_get_slice_order,rubix_cube_two_phase_set_slice_order,rubix_cube_two_phase_is_phase2_move) ;
+
+	rubix_cube_two_phase_build_prune(pTables->slice_twist_prune,
+					 (const unsigned short (*)[RUBIX_CUBE_MOVE_COUNT])pTables->slice_moves,RUBIX_CUBE_TWO_PHASE_SLICES,
+					 (const unsigned short (*)[RUBIX_CUBE_MOVE_COUNT])pTables->twist_moves,RUBIX_CUBE_TWO_PHASE_TWISTS,
+					 all_moves,RUBIX_CUBE_MOVE_COUNT) ;
+	rubix_cube_two_phase_build_prune(pTables->slice_flip_prune,
+					 (const unsigned short (*)[RUBIX_CUBE_MOVE_COUNT])pTables->slice_moves,RUBIX_CUBE_TWO_PHASE_SLICES,
+					 (const unsigned short (*)[RUBIX_CUBE_MOVE_COUNT])pTables->flip_moves,RUBIX_CUBE_TWO_PHASE_FLIPS,
+					 all_moves,RUBIX_CUBE_MOVE_COUNT) ;
+	rubix_cube_two_phase_build_prune(pTables->corner_prune,
+					 (const unsigned short (*)[RUBIX_CUBE_MOVE_COUNT])pTables->slice_order_moves,RUBIX_CUBE_TWO_PHASE_SLICE_ORDERS,
+					 (const unsigned short (*)[RUBIX_CUBE_MOVE_COUNT])pTables->corner_moves,RUBIX_CUBE_TWO_PHASE_CORNERS,
+					 rubix_cube_two_phase_phase2_moves,rubix_cube_two_phase_phase2_move_count) ;
+	rubix_cube_two_phase_build_prune(pTables->edge_prune,
+					 (const unsigned short (*)[RUBIX_CUBE_MOVE_COUNT])pTables->slice_order_moves,RUBIX_CUBE_TWO_PHASE_SLICE_ORDERS,
+					 (const unsigned short (*)[RUBIX_CUBE_MOVE_COUNT])pTables->edge_moves,RUBIX_CUBE_TWO_PHASE_EDGES,
+					 rubix_cube_two_phase_phase2_moves,rubix_cube_two_phase_phase2_move_count) ;
+}
+
+/* Map @path as the tables, with the lock held and no tables set yet */
+static int rubix_cube_two_phase_map_locked(const char * path) {
+	if (!rubix_cube_table_map(&rubix_cube_two_phase_mapping,path,RUBIX_CUBE_TABLE_KIND_TWO_PHASE,
+				  rubix_cube_two_phase_parameters,sizeof(rubix_cube_two_phase_parameters))) return 0 ;
+	if (rubix_cube_two_phase_mapping.header->payload_size != rubix_cube_table_padded_size(sizeof(RubixCubeTwoPhaseTables))) {
+		rubix_cube_table_unmap(&rubix_cube_two_phase_mapping) ;
+		return 0 ;
+	}
+	rubix_cube_two_phase_build_move_lists() ;
+	__atomic_store_n(&rubix_cube_two_phase_tables,rubix_cube_table_section(&rubix_cube_two_phase_mapping,0),__ATOMIC_RELEASE) ;
+	return 1 ;
+}
+
+void rubix_cube_two_phase_init(void) {
+	char path[RUBIX_CUBE_TWO_PHASE_PATH_SIZE] ;
+
+	if (__atomic_load_n(&rubix_cube_two_phase_tables,__ATOMIC_ACQUIRE)) return ;
+
+	pthread_mutex_lock(&rubix_cube_two_phase_tables_lock) ;
+	if (!rubix_cube_two_phase_tables) {
+		if (!rubix_cube_table_path(path,sizeof(path),NULL,RUBIX_CUBE_TWO_PHASE_TABLE_NAME) || !rubix_cube_two_phase_map_locked(path)) {
+			rubix_cube_two_phase_build_move_lists() ;
+			rubix_cube_two_phase_build_tables(&rubix_cube_two_phase_built) ;
+			__atomic_store_n(&rubix_cube_two_phase_tables,&rubix_cube_two_phase_built,__ATOMIC_RELEASE) ;
+		}
+	}
+	pthread_mutex_unlock(&rubix_cube_two_phase_tables_lock) ;
+}
+
+int rubix_cube_two_phase_map(const char * path) {
+	int success = 0 ;
+
+	pthread_mutex_lock(&rubix_cube_two_phase_tables_lock) ;
+	if (!rubix_cube_two_phase_tables) success = rubix_cube_two_phase_map_locked(path) ;
+	else success = rubix_cube_two_phase_tables != &rubix_cube_two_phase_built ;
+	pthread_mutex_unlock(&rubix_cube_two_phase_tables_lock) ;
+	return success ;
+}
+
+int rubix_cube_two_phase_save(const char * path) {
+	size_t size = sizeof(RubixCubeTwoPhaseTables) ;
+	const void * sections[1] ;
+
+	rubix_cube_two_phase_init() ;
+	sections[0] = rubix_cube_two_phase_tables ;
+	return rubix_cube_table_write(path,RUBIX_CUBE_TABLE_KIND_TWO_PHASE,rubix_cube_two_phase_parameters,sizeof(rubix_cube_two_phase_parameters),
+				      sections,&size,1) ;
+}
+
+typedef struct rubix_cube_two_phase_search {
+	RubixCubeCubie 			start ;
+	RubixCubeTwoPhaseLimits 	limits ;
+	struct timespec 		deadline ;
+	unsigned long long 		nodes ;
+	int 				stop ;
+
+	unsigned char 			path[RUBIX_CUBE_TWO_PHASE_MAX_LENGTH] ;		/* RUBIX_CUBE_MOVE_INDEX() values */
+	unsigned char 			best[RUBIX_CUBE_TWO_PHASE_MAX_LENGTH] ;
+	size_t 				best_length ;					/* 0 and !found means nothing yet */
+	int 				found ;
+	size_t 				phase1_length ;
+} RubixCubeTwoPhaseSearch ;
+
+/* Same face twice, or opposite faces out of order, can always be written shorter or was already tried */
+static inline int rubix_cube_two_phase_redundant(size_t side, size_t last_side) {
+	if (last_side == RUBIX_CUBE_TWO_PHASE_NO_SIDE) return 0 ;
+	return side == last_side || (side == RUBIX_CUBE_SQUARE_OPPOSITE(last_side) && side < last_side) ;
+}
+
+static int rubix_cube_two_phase_out_of_time(RubixCubeTwoPhaseSearch * pSearch) {
+	if (pSearch->stop) return 1 ;
+	if (pSearch->limits.seconds <= 0 || ++pSearch->nodes % RUBIX_CUBE_TWO_PHASE_CLOCK_INTERVAL) return 0 ;
+
+	struct timespec now ;
+	clock_gettime(CLOCK_MONOTONIC,&now) ;
+	if (now.tv_sec > pSearch->deadline.tv_sec || (now.tv_sec == pSearch->deadline.tv_sec && now.tv_nsec >= pSearch->deadline.tv_nsec)) {
+		pSearch->stop = 1 ;
+	}
+	return pSearch->stop ;
+}
+
+static inline unsigned rubix_cube_two_phase_phase2_estimate(unsigned corners, unsigned edges, unsigned slice_order) {
+	unsigned a = rubix_cube_two_phase_tables->corner_prune[slice_order * RUBIX_CUBE_TWO_PHASE_CORNERS + corners] ;
+	unsigned b = rubix_cube_two_phase_tables->edge_prune[slice_order * RUBIX_CUBE_TWO_PHASE_EDGES + edges] ;
+	return a > b ? a : b ;
+}
+
+static inline unsigned rubix_cube_two_phase_phase1_estimate(unsigned twist, unsigned flip, unsigned slice) {
+	unsigned a = rubix_cube_two_phase_tables->slice_twist_prune[slice * RUBIX_CUBE_TWO_PHASE_TWISTS + twist] ;
+	unsigned b = rubix_cube_two_phase_tables->slice_flip_prune[slice * RUBIX_CUBE_TWO_PHASE_FLIPS + flip] ;
+	return a > b ? a : b ;
+}
+
+/* Depth first phase 2 search with exactly @togo moves left, return nonzero when solved */
+static int rubix_cube_two_phase_search2(RubixCubeTwoPhaseSearch * pSearch, unsigned corners, unsigned edges, unsigned slice_order,
+					size_t depth, size_t togo, size_t last_side) {
+	if (!togo) return !corners && !edges && !slice_order ;
+	if (rubix_cube_two_phase_out_of_time(pSearch)) return 0 ;
+
+	for (size_t i = 0; i < rubix_cube_two_phase_phase2_move_count; ++i) {
+		size_t m = rubix_cube_two_phase_phase2_moves[i], side = m / RUBIX_CUBE_FACE_ROTATION_COUNT ;
+		if (rubix_cube_two_phase_redundant(side,last_side)) continue ;
+
+		unsigned next_corners = rubix_cube_two_phase_tables->corner_moves[corners][m] ;
+		unsigned next_edges = rubix_cube_two_phase_tables->edge_moves[edges][m] ;
+		unsigned next_slice_order = rubix_cube_two_phase_tables->slice_order_moves[slice_order][m] ;
+		if (rubix_cube_two_phase_phase2_estimate(next_corners,next_edges,next_slice_order) >= togo) continue ;
+
+		pSearch->path[depth] = (unsigned char)m ;
+		if (rubix_cube_two_phase_search2(pSearch,next_corners,next_edges,next_slice_order,depth + 1,togo - 1,side)) return 1 ;
+	}
+	return 0 ;
+}
+
+/* Called at the end of every phase 1 solution, try to finish it shorter than the best so far */
+static int rubix_cube_two_phase_start_phase2(RubixCubeTwoPhaseSearch * pSearch, size_t last_side) {
+	RubixCubeCubie cubie = pSearch->start ;
+	size_t phase1 = pSearch->phase1_length, limit ;
+
+	for (size_t i = 0; i < phase1; ++i) {
+		size_t m = pSearch->path[i] ;
+		rubix_cube_cubie_multiply(&cubie,&cubie,rubix_cube_cubie_get_move(m / RUBIX_CUBE_FACE_ROTATION_COUNT,m % RUBIX_CUBE_FACE_ROTATION_COUNT)) ;
+	}
+	unsigned corners = rubix_cube_two_phase_get_corners(&cubie) ;
+	unsigned edges = rubix_cube_two_phase_get_edges(&cubie) ;
+	unsigned slice_order = rubix_cube_two_phase_get_slice_order(&cubie) ;
+
+	limit = pSearch->found ? pSearch->best_length - 1 : pSearch->limits.max_length ;
+	if (limit < phase1) return 0 ;
+	limit -= phase1 ;
+	if (limit > RUBIX_CUBE_TWO_PHASE_MAX_PHASE2) limit = RUBIX_CUBE_TWO_PHASE_MAX_PHASE2 ;
+
+	for (size_t togo = rubix_cube_two_phase_phase2_estimate(corners,edges,slice_order); togo <= limit; ++togo) {
+		if (rubix_cube_two_phase_search2(pSearch,corners,edges,slice_order,phase1,togo,last_side)) {
+			pSearch->best_length = phase1 + togo ;
+			memcpy(pSearch->best,pSearch->path,pSearch->best_length) ;
+			pSearch->found = 1 ;
+			return pSearch->best_length <= pSearch->limits.target_length ;
+		}
+		if (pSearch->stop) break ;
+	}
+	return 0 ;
+}
+
+/* Depth first phase 1 search with exactly @togo moves left, return nonzero when the whole search is done */
+static int rubix_cube_two_phase_search1(RubixCubeTwoPhaseSearch * pSearch, unsigned twist, unsigned flip, unsigned slice,
+					size_t depth, size_t togo, size_t last_side) {
+	if (!togo) {
+		/* A phase 1 solution ending in a phase 2 move was already found one move shorter */
+		if (!twist && !flip && !slice && (!depth || !rubix_cube_two_phase_is_phase2_move[pSearch->path[depth - 1]])) {
+			return rubix_cube_two_phase_start_phase2(pSearch,last_side) ;
+		}
+		return 0 ;
+	}
+	if (rubix_cube_two_phase_out_of_time(pSearch)) return 1 ;
+
+	for (size_t m = 0; m < RUBIX_CUBE_MOVE_COUNT; ++m) {
+		size_t side = m / RUBIX_CUBE_FACE_ROTATION_COUNT ;
+		if (rubix_cube_two_phase_redundant(side,last_side)) continue ;
+
+		unsigned next_twist = rubix_cube_two_phase_tables->twist_moves[twist][m] ;
+		unsigned next_flip = rubix_cube_two_phase_tables->flip_moves[flip][m] ;
+		unsigned next_slice = rubix_cube_two_phase_tables->slice_moves[slice][m] ;
+		if (rubix_cube_two_phase_phase1_estimate(next_twist,next_flip,next_slice) >= togo) continue ;
+
+		pSearch->path[depth] = (unsigned char)m ;
+		if (rubix_cube_two_phase_search1(pSearch,next_twist,next_flip,next_slice,depth + 1,togo - 1,side)) return 1 ;
+	}
+	return 0 ;
+}
+
+RubixCubeScramble * rubix_cube_two_phase_solve_cubie(const RubixCubeCubie * pCubie, const RubixCubeTwoPhaseLimits * pLimits) {
+	RubixCubeTwoPhaseSearch search ;
+	RubixCubeScramble * pNew ;
+
+	rubix_cube_two_phase_init() ;
+
+	memset(&search,0,sizeof(search)) ;
+	search.start = *pCubie ;
+	search.limits = pLimits ? *pLimits : RUBIX_CUBE_TWO_PHASE_DEFAULT_LIMITS ;
+	if (search.limits.max_length > RUBIX_CUBE_TWO_PHASE_MAX_LENGTH) search.limits.max_length = RUBIX_CUBE_TWO_PHASE_MAX_LENGTH ;
+	if (search.limits.seconds > 0) {
+		clock_gettime(CLOCK_MONOTONIC,&search.deadline) ;
+		search.deadline.tv_sec += (time_t)search.limits.seconds ;
+		search.deadline.tv_nsec += (long)((search.limits.seconds - (time_t)search.limits.seconds) * 1e9) ;
+		if (search.deadline.tv_nsec >= 1000000000L) {
+			search.deadline.tv_sec += 1 ;
+			search.deadline.tv_nsec -= 1000000000L ;
+		}
+	}
+
+	unsigned twist = rubix_cube_two_phase_get_twist(pCubie) ;
+	unsigned flip = rubix_cube_two_phase_get_flip(pCubie) ;
+	unsigned slice = rubix_cube_two_phase_get_slice(pCubie) ;
+
+	for (size_t togo = rubix_cube_two_phase_phase1_estimate(twist,flip,slice); togo <= RUBIX_CUBE_TWO_PHASE_MAX_PHASE1; ++togo) {
+		if (search.found && togo >= search.best_length) break ;
+		search.phase1_length = togo ;
+		if (rubix_cube_two_phase_search1(&search,twist,flip,slice,0,togo,RUBIX_CUBE_TWO_PHASE_NO_SIDE)) break ;
+	}
+	if (!search.found) return NULL ;
+
+	if (!(pNew = (RubixCubeScramble *)malloc(sizeof(RubixCubeScramble)))) return NULL ;
+	pNew->capacity = search.best_length ? search.best_length : 1 ;
+	if (!(pNew->moves = (RubixCubeMove *)malloc(sizeof(RubixCubeMove) * pNew->capacity))) {
+		free(pNew) ; return NULL ;
+	}
+	pNew->size = search.best_length ;
+	pNew->seed = 0 ;
+	for (size_t i = 0; i < pNew->size; ++i) {
+		pNew->moves[i] = (RubixCubeMove){
+			.side 		= (RubixCubeSide)(search.best[i] / RUBIX_CUBE_FACE_ROTATION_COUNT),
+			.rotation 	= (RubixCubeFaceRotation)(search.best[i] % RUBIX_CUBE_FACE_ROTATION_COUNT)
+		} ;
+	}
+	return pNew ;
+}
+
+RubixCubeScramble * rubix_cube_two_phase_solve(RubixCube * pRubix_cube, const RubixCubeTwoPhaseLimits * pLimits) {
+	RubixCubeCubie cubie ;
+	if (!rubix_cube_cubie_from_cube(&cubie,pRubix_cube)) return NULL ;
+	return rubix_cube_two_phase_solve_cubie(&cubie,pLimits) ;
+}
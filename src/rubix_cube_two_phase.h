@@ -0,0 +1,86 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Two phase solver:
+ *
+ * Phase 1 brings the cube into the subgroup generated by
+ *
+ * 	top, bottom (any rotation) and front, back, right, left (double rotations only)
+ *
+ * which is exactly the set of cubes with no twisted corners, no flipped edges and the
+ * four middle layer edges (FR, FL, BL, BR) somewhere in the middle layer. Phase 2 then
+ * solves the cube using only those 10 moves. Each phase is an IDA* search over small
+ * coordinates with move and pruning tables, and the search keeps looking for longer
+ * phase 1 solutions with shorter phase 2 completions until its budget runs out, so the
+ * result is usually close to optimal but not guaranteed to be.
+ *
+ * The tables (about 7 MiB) are set up once, the first time they are needed or on
+ * rubix_cube_two_phase_init(), and only read after that, so any number of threads may
+ * solve at the same time. Building them takes a moment, so they can be saved with
+ * rubix_cube_two_phase_save() and are then mapped from $RUBIX_CUBE_TABLES (see
+ * rubix_cube_table.h) instead, or from anywhere with rubix_cube_two_phase_map().
+ */
+
+#ifndef RUBIX_CUBE_TWO_PHASE_H
+#define RUBIX_CUBE_TWO_PHASE_H "rubix_cube_two_phase.h"
+
+#include "rubix_cube.h"
+#include "rubix_cube_cubie.h"
+#include "rubix_cube_table.h"
+
+#define RUBIX_CUBE_TWO_PHASE_MAX_PHASE1 	12
+#define RUBIX_CUBE_TWO_PHASE_MAX_PHASE2 	18
+#define RUBIX_CUBE_TWO_PHASE_MAX_LENGTH 	(RUBIX_CUBE_TWO_PHASE_MAX_PHASE1 + RUBIX_CUBE_TWO_PHASE_MAX_PHASE2)
+
+/* Name of the saved tables in a table directory */
+#define RUBIX_CUBE_TWO_PHASE_TABLE_NAME 	"rubix_cube_two_phase.table"
+#define RUBIX_CUBE_TWO_PHASE_PATH_SIZE 		4096
+
+typedef struct rubix_cube_two_phase_limits {
+	size_t 				max_length ;	/* never return anything longer */
+	size_t 				target_length ;	/* stop as soon as a solution this short is found */
+	double 				seconds ;	/* stop after this long and return the best so far, 0 for no limit */
+} RubixCubeTwoPhaseLimits ;
+
+#define RUBIX_CUBE_TWO_PHASE_DEFAULT_LIMITS \
+	(RubixCubeTwoPhaseLimits) { \
+		.max_length 	= RUBIX_CUBE_TWO_PHASE_MAX_LENGTH, \
+		.target_length 	= 22, \
+		.seconds 	= 1.0 \
+	}
+
+/* Set up the move and pruning tables now instead of on the first solve */
+/* They are mapped from $RUBIX_CUBE_TABLES if saved there, else built */
+void rubix_cube_two_phase_init() ;
+
+/* Use the tables saved at @path, mapped read only, instead of building them */
+/* Return nonzero if the tables now come from a file, 0 if @path is not a matching table file or the tables were already built */
+int rubix_cube_two_phase_map(const char * path) ;
+
+/* Write the tables, building them first if needed, to a table file at @path, return nonzero on success */
+int rubix_cube_two_phase_save(const char * path) ;
+
+/* Find a short sequence of moves solving @pRubix_cube within @pLimits (NULL for the defaults) */
+/* Return the best one found as a freshly allocated RubixCubeScramble, or NULL if @pRubix_cube is not a valid cube or nothing was found */
+RubixCubeScramble * rubix_cube_two_phase_solve(RubixCube * pRubix_cube, const RubixCubeTwoPhaseLimits * pLimits) ;
+
+/* Same as rubix_cube_two_phase_solve(), on a cubie */
+RubixCubeScramble * rubix_cube_two_phase_solve_cubie(const RubixCubeCubie * pCubie, const RubixCubeTwoPhaseLimits * pLimits) ;
+
+#endif // RUBIX_CUBE_TWO_PHASE_H
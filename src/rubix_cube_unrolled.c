@@ -0,0 +1,31 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+#include "rubix_cube_unrolled.h"
+
+#define RUBIX_CUBE_UNROLLED_TURNS(name, corners, sides, clockwise, counterclockwise, half) \
+	rubix_cube_unrolled_##name##_clockwise, \
+	rubix_cube_unrolled_##name##_counterclockwise, \
+	rubix_cube_unrolled_##name##_double,
+
+const RubixCubeUnrolledTurn rubix_cube_unrolled_turns[RUBIX_CUBE_MOVE_COUNT] = {
+	RUBIX_CUBE_FACE_ROTATIONS(RUBIX_CUBE_UNROLLED_TURNS)
+} ;
+
+const RubixCubeUnrolledTurn rubix_cube_unrolled_slice_turns[RUBIX_CUBE_SLICE_COUNT * RUBIX_CUBE_FACE_ROTATION_COUNT] = {
+	RUBIX_CUBE_SLICE_ROTATIONS(RUBIX_CUBE_UNROLLED_TURNS)
+} ;
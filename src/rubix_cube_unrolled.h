@@ -0,0 +1,129 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+/*
+ * Unrolled face and slice turns:
+ *
+ * rubix_cube_rotate_face() used to read its quadsets out of rubix_cube_rotation_table
+ * and turn them with the swap chains of rubix_cube_rotate_piece_quadset() on every
+ * call. Here each of the 18 turns (side x rotation) is a function of its own, made
+ * by the macros below from RUBIX_CUBE_FACE_ROTATIONS(), the data the table is built
+ * from: the eight pieces are loaded, and stored back one place along their cycle with
+ * the stickers already permuted, so there are no branches, no pointer arrays and no
+ * swaps left.
+ *
+ * They are static inline so that code built against the library can have them
+ * inlined, rubix_cube_unrolled_turns holds them by move index for a turn that is
+ * only known at runtime, which is how rubix_cube_rotate_face() makes its turns now.
+ * The middle layers of RUBIX_CUBE_SLICE_ROTATIONS() get the same treatment for
+ * rubix_cube_rotate_slice(), and through it slice turns and whole cube rotations.
+ */
+
+#ifndef RUBIX_CUBE_UNROLLED_H
+#define RUBIX_CUBE_UNROLLED_H "rubix_cube_unrolled.h"
+#include "rubix_cube.h"
+
+/* The sides of a piece after a RubixCubeRotation, as an initializer read from the sides @s of the piece before */
+#define RUBIX_CUBE_UNROLLED_PIECE_UP(s) 		{ (s)[RUBIX_CUBE_SQUARE_FRONT], (s)[RUBIX_CUBE_SQUARE_BOTTOM], (s)[RUBIX_CUBE_SQUARE_RIGHT], (s)[RUBIX_CUBE_SQUARE_LEFT], (s)[RUBIX_CUBE_SQUARE_TOP], (s)[RUBIX_CUBE_SQUARE_BACK] }
+#define RUBIX_CUBE_UNROLLED_PIECE_DOWN(s) 		{ (s)[RUBIX_CUBE_SQUARE_BACK], (s)[RUBIX_CUBE_SQUARE_TOP], (s)[RUBIX_CUBE_SQUARE_RIGHT], (s)[RUBIX_CUBE_SQUARE_LEFT], (s)[RUBIX_CUBE_SQUARE_BOTTOM], (s)[RUBIX_CUBE_SQUARE_FRONT] }
+#define RUBIX_CUBE_UNROLLED_PIECE_RIGHT(s) 		{ (s)[RUBIX_CUBE_SQUARE_TOP], (s)[RUBIX_CUBE_SQUARE_LEFT], (s)[RUBIX_CUBE_SQUARE_FRONT], (s)[RUBIX_CUBE_SQUARE_BACK], (s)[RUBIX_CUBE_SQUARE_RIGHT], (s)[RUBIX_CUBE_SQUARE_BOTTOM] }
+#define RUBIX_CUBE_UNROLLED_PIECE_LEFT(s) 		{ (s)[RUBIX_CUBE_SQUARE_TOP], (s)[RUBIX_CUBE_SQUARE_RIGHT], (s)[RUBIX_CUBE_SQUARE_BACK], (s)[RUBIX_CUBE_SQUARE_FRONT], (s)[RUBIX_CUBE_SQUARE_LEFT], (s)[RUBIX_CUBE_SQUARE_BOTTOM] }
+#define RUBIX_CUBE_UNROLLED_PIECE_CLOCKWISE(s) 		{ (s)[RUBIX_CUBE_SQUARE_LEFT], (s)[RUBIX_CUBE_SQUARE_FRONT], (s)[RUBIX_CUBE_SQUARE_TOP], (s)[RUBIX_CUBE_SQUARE_BOTTOM], (s)[RUBIX_CUBE_SQUARE_BACK], (s)[RUBIX_CUBE_SQUARE_RIGHT] }
+#define RUBIX_CUBE_UNROLLED_PIECE_COUNTERCLOCKWISE(s) 	{ (s)[RUBIX_CUBE_SQUARE_RIGHT], (s)[RUBIX_CUBE_SQUARE_FRONT], (s)[RUBIX_CUBE_SQUARE_BOTTOM], (s)[RUBIX_CUBE_SQUARE_TOP], (s)[RUBIX_CUBE_SQUARE_BACK], (s)[RUBIX_CUBE_SQUARE_LEFT] }
+
+/* The same rotation twice, which a half turn does to its pieces: one half turn per axis, whichever way it is named */
+#define RUBIX_CUBE_UNROLLED_PIECE_UP_TWICE(s) 		{ (s)[RUBIX_CUBE_SQUARE_BOTTOM], (s)[RUBIX_CUBE_SQUARE_BACK], (s)[RUBIX_CUBE_SQUARE_RIGHT], (s)[RUBIX_CUBE_SQUARE_LEFT], (s)[RUBIX_CUBE_SQUARE_FRONT], (s)[RUBIX_CUBE_SQUARE_TOP] }
+#define RUBIX_CUBE_UNROLLED_PIECE_RIGHT_TWICE(s) 	{ (s)[RUBIX_CUBE_SQUARE_TOP], (s)[RUBIX_CUBE_SQUARE_BACK], (s)[RUBIX_CUBE_SQUARE_LEFT], (s)[RUBIX_CUBE_SQUARE_RIGHT], (s)[RUBIX_CUBE_SQUARE_FRONT], (s)[RUBIX_CUBE_SQUARE_BOTTOM] }
+#define RUBIX_CUBE_UNROLLED_PIECE_CLOCKWISE_TWICE(s) 	{ (s)[RUBIX_CUBE_SQUARE_BOTTOM], (s)[RUBIX_CUBE_SQUARE_FRONT], (s)[RUBIX_CUBE_SQUARE_LEFT], (s)[RUBIX_CUBE_SQUARE_RIGHT], (s)[RUBIX_CUBE_SQUARE_BACK], (s)[RUBIX_CUBE_SQUARE_TOP] }
+#define RUBIX_CUBE_UNROLLED_PIECE_DOWN_TWICE 			RUBIX_CUBE_UNROLLED_PIECE_UP_TWICE
+#define RUBIX_CUBE_UNROLLED_PIECE_LEFT_TWICE 			RUBIX_CUBE_UNROLLED_PIECE_RIGHT_TWICE
+#define RUBIX_CUBE_UNROLLED_PIECE_COUNTERCLOCKWISE_TWICE 	RUBIX_CUBE_UNROLLED_PIECE_CLOCKWISE_TWICE
+
+/* Store piece @q at (@plane, @index) with its sides turned by @piece */
+#define RUBIX_CUBE_UNROLLED_STORE(pCube, piece, plane, index, q) \
+	((pCube)->planes[plane][index] = (RubixCubePiece){ .sides = RUBIX_CUBE_UNROLLED_PIECE_##piece((q).sides) })
+
+/* Where a RubixCubeRotationQuadset moves the pieces 0 to 3 of a quadset, as in rubix_cube_rotate_piece_quadset() */
+#define RUBIX_CUBE_UNROLLED_SET_RIGHT(pCube, piece, p0, i0, p1, i1, p2, i2, p3, i3) \
+	RUBIX_CUBE_UNROLLED_STORE(pCube,piece,p0,i0,q2) ; \
+	RUBIX_CUBE_UNROLLED_STORE(pCube,piece,p1,i1,q0) ; \
+	RUBIX_CUBE_UNROLLED_STORE(pCube,piece,p2,i2,q3) ; \
+	RUBIX_CUBE_UNROLLED_STORE(pCube,piece,p3,i3,q1)
+#define RUBIX_CUBE_UNROLLED_SET_LEFT(pCube, piece, p0, i0, p1, i1, p2, i2, p3, i3) \
+	RUBIX_CUBE_UNROLLED_STORE(pCube,piece,p0,i0,q1) ; \
+	RUBIX_CUBE_UNROLLED_STORE(pCube,piece,p1,i1,q3) ; \
+	RUBIX_CUBE_UNROLLED_STORE(pCube,piece,p2,i2,q0) ; \
+	RUBIX_CUBE_UNROLLED_STORE(pCube,piece,p3,i3,q2)
+#define RUBIX_CUBE_UNROLLED_SET_FULL(pCube, piece, p0, i0, p1, i1, p2, i2, p3, i3) \
+	RUBIX_CUBE_UNROLLED_STORE(pCube,piece,p0,i0,q3) ; \
+	RUBIX_CUBE_UNROLLED_STORE(pCube,piece,p1,i1,q2) ; \
+	RUBIX_CUBE_UNROLLED_STORE(pCube,piece,p2,i2,q1) ; \
+	RUBIX_CUBE_UNROLLED_STORE(pCube,piece,p3,i3,q0)
+
+/* Turn one quadset, @refs being its four (plane, index) pairs in parentheses like a row of rubix_cube_rotation_table */
+#define RUBIX_CUBE_UNROLLED_UNPACK(...) 	__VA_ARGS__
+#define RUBIX_CUBE_UNROLLED_QUADSET(pCube, set, piece, refs) \
+	RUBIX_CUBE_UNROLLED_QUADSET_(pCube,set,piece,RUBIX_CUBE_UNROLLED_UNPACK refs)
+#define RUBIX_CUBE_UNROLLED_QUADSET_(...) 	RUBIX_CUBE_UNROLLED_QUADSET__(__VA_ARGS__)
+#define RUBIX_CUBE_UNROLLED_QUADSET__(pCube, set, piece, p0, i0, p1, i1, p2, i2, p3, i3) do { \
+	const RubixCubePiece q0 = (pCube)->planes[p0][i0] ; \
+	const RubixCubePiece q1 = (pCube)->planes[p1][i1] ; \
+	const RubixCubePiece q2 = (pCube)->planes[p2][i2] ; \
+	const RubixCubePiece q3 = (pCube)->planes[p3][i3] ; \
+	RUBIX_CUBE_UNROLLED_SET_##set(pCube,piece,p0,i0,p1,i1,p2,i2,p3,i3) ; \
+} while (0)
+
+/* The three turns of a face, from its corners, its edges and the piece rotation of each turn */
+#define RUBIX_CUBE_UNROLLED_FACE(name, corners, edges, clockwise, counterclockwise, half) \
+static inline void rubix_cube_unrolled_##name##_clockwise(RubixCube * pRubix_cube) { \
+	RUBIX_CUBE_UNROLLED_QUADSET(pRubix_cube,RIGHT,clockwise,corners) ; \
+	RUBIX_CUBE_UNROLLED_QUADSET(pRubix_cube,RIGHT,clockwise,edges) ; \
+} \
+static inline void rubix_cube_unrolled_##name##_counterclockwise(RubixCube * pRubix_cube) { \
+	RUBIX_CUBE_UNROLLED_QUADSET(pRubix_cube,LEFT,counterclockwise,corners) ; \
+	RUBIX_CUBE_UNROLLED_QUADSET(pRubix_cube,LEFT,counterclockwise,edges) ; \
+} \
+static inline void rubix_cube_unrolled_##name##_double(RubixCube * pRubix_cube) { \
+	RUBIX_CUBE_UNROLLED_QUADSET(pRubix_cube,FULL,half##_TWICE,corners) ; \
+	RUBIX_CUBE_UNROLLED_QUADSET(pRubix_cube,FULL,half##_TWICE,edges) ; \
+}
+
+/* rubix_cube_unrolled_top_clockwise() and the rest, from the same data as rubix_cube_rotation_table */
+RUBIX_CUBE_FACE_ROTATIONS(RUBIX_CUBE_UNROLLED_FACE)
+
+/* And rubix_cube_unrolled_slice_m_clockwise() to rubix_cube_unrolled_slice_s_double() from rubix_cube_slice_rotation_table's */
+RUBIX_CUBE_SLICE_ROTATIONS(RUBIX_CUBE_UNROLLED_FACE)
+
+typedef void (* RubixCubeUnrolledTurn)(RubixCube * pRubix_cube) ;
+
+/* The functions above by RUBIX_CUBE_MOVE_INDEX() */
+extern const RubixCubeUnrolledTurn rubix_cube_unrolled_turns[RUBIX_CUBE_MOVE_COUNT] ;
+
+/* Turn @side by @face_rotation through rubix_cube_unrolled_turns, without the stats of rubix_cube_rotate_face() */
+static inline void rubix_cube_unrolled_rotate_face(RubixCube * pRubix_cube, RubixCubeSide side, RubixCubeFaceRotation face_rotation) {
+	rubix_cube_unrolled_turns[RUBIX_CUBE_MOVE_INDEX(side,face_rotation)](pRubix_cube) ;
+}
+
+/* The slice turns by RubixCubeSlice * 3 + RubixCubeFaceRotation */
+extern const RubixCubeUnrolledTurn rubix_cube_unrolled_slice_turns[RUBIX_CUBE_SLICE_COUNT * RUBIX_CUBE_FACE_ROTATION_COUNT] ;
+
+/* Turn @slice by @face_rotation through rubix_cube_unrolled_slice_turns, both in range */
+static inline void rubix_cube_unrolled_rotate_slice(RubixCube * pRubix_cube, RubixCubeSlice slice, RubixCubeFaceRotation face_rotation) {
+	rubix_cube_unrolled_slice_turns[(size_t)slice * RUBIX_CUBE_FACE_ROTATION_COUNT + (size_t)face_rotation](pRubix_cube) ;
+}
+
+#endif // RUBIX_CUBE_UNROLLED_H
@@ -0,0 +1,92 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+#include "rubix_cube_zobrist.h"
+#include <pthread.h>
+
+#define RUBIX_CUBE_ZOBRIST_POSITIONS 	(RUBIX_CUBE_PLANE_COUNT * RUBIX_CUBE_PIECES_PER_PLANE)
+#define RUBIX_CUBE_ZOBRIST_COLORS 	(RUBIX_CUBE_COLOR_YELLOW + 1)
+
+/* Keys for the null color stay 0, so the blank sides of a piece do not change the hash */
+static RubixCubeHash rubix_cube_zobrist_keys[RUBIX_CUBE_ZOBRIST_POSITIONS][RUBIX_CUBE_SIDE_COUNT][RUBIX_CUBE_ZOBRIST_COLORS] ;
+
+static pthread_once_t rubix_cube_zobrist_keys_once = PTHREAD_ONCE_INIT ;
+static int rubix_cube_zobrist_keys_ready ;
+
+static void rubix_cube_zobrist_build_keys(void) {
+	RubixCubeRandom random = rubix_cube_random_generate(RUBIX_CUBE_ZOBRIST_SEED) ;
+
+	for (size_t position = 0; position < RUBIX_CUBE_ZOBRIST_POSITIONS; ++position) {
+		for (size_t side = 0; side < RUBIX_CUBE_SIDE_COUNT; ++side) {
+			for (size_t color = RUBIX_CUBE_COLOR_WHITE; color < RUBIX_CUBE_ZOBRIST_COLORS; ++color) {
+				rubix_cube_zobrist_keys[position][side][color] = rubix_cube_random_next(&random) ;
+			}
+		}
+	}
+	__atomic_store_n(&rubix_cube_zobrist_keys_ready,1,__ATOMIC_RELEASE) ;
+}
+
+/* Checked on every move, so skip the call into pthread_once once the keys exist */
+static inline void rubix_cube_zobrist_init_keys(void) {
+	if (__builtin_expect(!__atomic_load_n(&rubix_cube_zobrist_keys_ready,__ATOMIC_ACQUIRE),0)) {
+		pthread_once(&rubix_cube_zobrist_keys_once,rubix_cube_zobrist_build_keys) ;
+	}
+}
+
+static inline RubixCubeHash rubix_cube_zobrist_piece(const RubixCube * pRubix_cube, size_t plane, size_t index) {
+	const RubixCubeHash (*keys)[RUBIX_CUBE_ZOBRIST_COLORS] = rubix_cube_zobrist_keys[plane * RUBIX_CUBE_PIECES_PER_PLANE + index] ;
+	const RubixCubeColor * colors = pRubix_cube->planes[plane][index].sides ;
+	RubixCubeHash hash = 0 ;
+
+	for (size_t side = 0; side < RUBIX_CUBE_SIDE_COUNT; ++side) hash ^= keys[side][colors[side]] ;
+	return hash ;
+}
+
+RubixCubeHash rubix_cube_zobrist_hash(const RubixCube * pRubix_cube) {
+	RubixCubeHash hash = 0 ;
+
+	rubix_cube_zobrist_init_keys() ;
+	for (size_t plane = 0; plane < RUBIX_CUBE_PLANE_COUNT; ++plane) {
+		for (size_t index = 0; index < RUBIX_CUBE_PIECES_PER_PLANE; ++index) {
+			hash ^= rubix_cube_zobrist_piece(pRubix_cube,plane,index) ;
+		}
+	}
+	return hash ;
+}
+
+RubixCubeHash rubix_cube_zobrist_moved(const RubixCube * pRubix_cube, RubixCubeSide side) {
+	const RubixCubeFaceRotationData * data = &rubix_cube_rotation_table[side] ;
+	RubixCubeHash hash = 0 ;
+
+	rubix_cube_zobrist_init_keys() ;
+	for (size_t i = 0; i < RUBIX_CUBE_PIECES_PER_QUADSET; ++i) {
+		hash ^= rubix_cube_zobrist_piece(pRubix_cube,data->corner_quadset[i].plane,data->corner_quadset[i].index) ;
+		hash ^= rubix_cube_zobrist_piece(pRubix_cube,data->side_quadset[i].plane,data->side_quadset[i].index) ;
+	}
+	return hash ;
+}
+
+RubixCubeHash rubix_cube_zobrist_rotate_face(RubixCube * pRubix_cube, RubixCubeHash hash, RubixCubeSide side, RubixCubeFaceRotation face_rotation) {
+	hash ^= rubix_cube_zobrist_moved(pRubix_cube,side) ;
+	rubix_cube_rotate_face(pRubix_cube,side,face_rotation) ;
+	return hash ^ rubix_cube_zobrist_moved(pRubix_cube,side) ;
+}
+
+RubixCubeHash rubix_cube_zobrist_apply_move(RubixCube * pRubix_cube, RubixCubeHash hash, const RubixCubeMove * move) {
+	if (!move) return hash ;
+	return rubix_cube_zobrist_rotate_face(pRubix_cube,hash,move->side,move->rotation) ;
+}
@@ -0,0 +1,53 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+/*
+ * Zobrist hashing:
+ *
+ * Every (piece position, side, color) gets a fixed random 64 bit key, and the hash of
+ * a cube is the XOR of the keys of what every one of its 27 pieces shows. Since XOR is
+ * its own inverse, a face rotation can update the hash by XORing out the keys of the
+ * 8 pieces it moves, rotating, then XORing their new keys back in. The other 19
+ * pieces are never looked at.
+ *
+ * The keys come from a fixed seed, so a hash means the same thing in every process
+ * and can be stored. For a hash kept next to the cube by every move, see
+ * RubixCubeTracked in rubix_cube_tracked.h
+ */
+
+#ifndef RUBIX_CUBE_ZOBRIST_H
+#define RUBIX_CUBE_ZOBRIST_H "rubix_cube_zobrist.h"
+
+#include "rubix_cube.h"
+
+#define RUBIX_CUBE_ZOBRIST_SEED 	0x5a0b15751c0be5ULL
+
+typedef unsigned long long RubixCubeHash ;
+
+/* Return the hash of @pRubix_cube, computed from all of its pieces */
+RubixCubeHash rubix_cube_zobrist_hash(const RubixCube * pRubix_cube) ;
+
+/* Return the XOR of the keys of the 8 pieces a rotation of @side moves, as they are now */
+RubixCubeHash rubix_cube_zobrist_moved(const RubixCube * pRubix_cube, RubixCubeSide side) ;
+
+/* Rotate a face of @pRubix_cube, return @hash (the hash of the cube before) updated to match */
+RubixCubeHash rubix_cube_zobrist_rotate_face(RubixCube * pRubix_cube, RubixCubeHash hash, RubixCubeSide side, RubixCubeFaceRotation face_rotation) ;
+
+/* Same as rubix_cube_apply_move() but also returns @hash updated to match */
+RubixCubeHash rubix_cube_zobrist_apply_move(RubixCube * pRubix_cube, RubixCubeHash hash, const RubixCubeMove * move) ;
+
+#endif // RUBIX_CUBE_ZOBRIST_H
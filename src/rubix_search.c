@@ -0,0 +1,139 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+/*
+ * Distributed optimal solves and enumerations (see rubix_cube_distributed.h):
+ *
+ * 	rubix_search coordinate <port> solve "<moves>" [max depth]
+ * 	rubix_search coordinate <port> enumerate <depth> [prefix length]
+ * 	rubix_search work <host> <port> [threads]
+ *
+ * The coordinator solves the state the moves lead to, or goes through every sequence of
+ * <depth> moves from solved, on whatever workers connect, then tells them to quit.
+ * Workers map the pattern databases from $RUBIX_CUBE_TABLES (see make tables), or
+ * build them if there are none, which takes a while.
+ */
+
+#include "rubix_cube_distributed.h"
+#include "rubix_cube_notation.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double rubix_search_seconds(const struct timespec * start) {
+	struct timespec now ;
+	clock_gettime(CLOCK_MONOTONIC,&now) ;
+	return (double)(now.tv_sec - start->tv_sec) + (double)(now.tv_nsec - start->tv_nsec) / 1e9 ;
+}
+
+static void rubix_search_print_stats(const RubixCubeDistributedStats * pStats, const struct timespec * start) {
+	fprintf(stderr,"rubix_search: %llu nodes in %.2fs over %zu workers, %zu rounds, %llu subtrees of which %llu given away\n",
+		pStats->nodes,rubix_search_seconds(start),pStats->workers,pStats->rounds,pStats->subtrees,pStats->splits) ;
+}
+
+static int rubix_search_solve(RubixCubeDistributed * pDistributed, const char * text, size_t max_depth) {
+	RubixCubeCubie cubie = rubix_cube_cubie_generate_solved() ;
+	RubixCubeNotationStatus status ;
+	RubixCubeScramble * pScramble = rubix_cube_notation_parse(text,strlen(text),0,&status), * pSolution ;
+	char formatted[RUBIX_CUBE_NOTATION_FORMAT_SIZE(RUBIX_CUBE_SOLVER_MAX_DEPTH) + 1] ;
+	RubixCubeDistributedStats stats ;
+	struct timespec start ;
+	size_t size ;
+
+	if (!pScramble) {
+		fprintf(stderr,"rubix_search: %s at %zu\n",status.error,status.offset) ;
+		return 0 ;
+	}
+	rubix_cube_cubie_apply_scramble(&cubie,pScramble) ;
+	rubix_cube_scramble_free(pScramble) ;
+
+	clock_gettime(CLOCK_MONOTONIC,&start) ;
+	pSolution = rubix_cube_distributed_solve(pDistributed,&cubie,max_depth,&stats) ;
+	rubix_search_print_stats(&stats,&start) ;
+	if (!pSolution) {
+		printf("no solution in %zu moves\n",max_depth) ;
+		return 0 ;
+	}
+	size = rubix_cube_notation_format(formatted,sizeof(formatted) - 1,pSolution->moves,pSolution->size,0) ;
+	formatted[size] = '\0' ;
+	printf("%s (%zu moves)\n",formatted,pSolution->size) ;
+	rubix_cube_scramble_free(pSolution) ;
+	return 1 ;
+}
+
+static int rubix_search_enumerate(RubixCubeDistributed * pDistributed, size_t depth) {
+	RubixCubeDistributedStats stats ;
+	struct timespec start ;
+	int success ;
+
+	clock_gettime(CLOCK_MONOTONIC,&start) ;
+	success = rubix_cube_distributed_enumerate(pDistributed,NULL,depth,&stats) ;
+	rubix_search_print_stats(&stats,&start) ;
+	if (success) printf("%llu sequences of %zu moves, %llu of them back at solved\n",stats.sequences,depth,stats.solved) ;
+	else fprintf(stderr,"rubix_search: a worker was lost, the counts are incomplete\n") ;
+	return success ;
+}
+
+static int rubix_search_coordinate(int argc, char ** argv) {
+	RubixCubeDistributed * pDistributed = rubix_cube_distributed_listen((unsigned)strtoul(argv[2],NULL,10)) ;
+	int success = 0 ;
+
+	if (!pDistributed) {
+		fprintf(stderr,"rubix_search: can not listen on port %s\n",argv[2]) ;
+		return 0 ;
+	}
+	fprintf(stderr,"rubix_search: waiting for workers on port %u\n",rubix_cube_distributed_port(pDistributed)) ;
+	if (!strcmp(argv[3],"solve")) {
+		success = rubix_search_solve(pDistributed,argv[4],argc > 5 ? strtoul(argv[5],NULL,10) : RUBIX_CUBE_SOLVER_MAX_DEPTH) ;
+	} else if (!strcmp(argv[3],"enumerate")) {
+		if (argc > 5) rubix_cube_distributed_set_prefix_length(pDistributed,strtoul(argv[5],NULL,10)) ;
+		success = rubix_search_enumerate(pDistributed,strtoul(argv[4],NULL,10)) ;
+	} else {
+		fprintf(stderr,"rubix_search: unknown search %s\n",argv[3]) ;
+	}
+	rubix_cube_distributed_close(pDistributed) ;
+	return success ;
+}
+
+static int rubix_search_work(int argc, char ** argv) {
+	RubixCubeSolver * pSolver = rubix_cube_solver_map(NULL) ;
+	int success ;
+
+	if (!pSolver) {
+		fprintf(stderr,"rubix_search: no tables in $RUBIX_CUBE_TABLES, building them\n") ;
+		pSolver = rubix_cube_solver_allocate_default() ;
+	}
+	if (!pSolver) {
+		fprintf(stderr,"rubix_search: could not set up the solver\n") ;
+		return 0 ;
+	}
+	success = rubix_cube_distributed_work(argv[2],(unsigned)strtoul(argv[3],NULL,10),pSolver,argc > 4 ? strtoul(argv[4],NULL,10) : 0) ;
+	if (!success) fprintf(stderr,"rubix_search: could not connect to %s:%s\n",argv[2],argv[3]) ;
+	rubix_cube_solver_free(pSolver) ;
+	return success ;
+}
+
+int main(int argc, char ** argv) {
+	if (argc >= 5 && !strcmp(argv[1],"coordinate")) return rubix_search_coordinate(argc,argv) ? EXIT_SUCCESS : EXIT_FAILURE ;
+	if (argc >= 4 && !strcmp(argv[1],"work")) return rubix_search_work(argc,argv) ? EXIT_SUCCESS : EXIT_FAILURE ;
+
+	fprintf(stderr,"usage: %s coordinate <port> solve \"<moves>\" [max depth]\n"
+		       "       %s coordinate <port> enumerate <depth> [prefix length]\n"
+		       "       %s work <host> <port> [threads]\n",argv[0],argv[0],argv[0]) ;
+	return EXIT_FAILURE ;
+}
@@ -0,0 +1,398 @@
+/*
+    A simple rubix cube simulator.
+    Copyright (C) 2019 Joel Savitz <joelsavitz@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    A copy of the GNU General Public License can be found in the file
+    LICENSE, but if you prefer, see <https://www.gnu.org/licenses/>.
+*/
+/*
+ * rubixd, the solver service (see rubix_cube_service.h) behind a socket:
+ *
+ * 	rubixd [--socket <path>] [--port <port>] [--threads <n>] [--batch <n>] [--queue <n>] [--pin <0|1>]
+ *
+ * listens on a unix socket (rubixd.sock by default) or on a TCP port, reads requests
+ * in the service's wire format from any number of connections and writes each response
+ * back to the connection its request came from as soon as a worker has it, so a client
+ * can keep as many requests in flight as it likes. One thread does all the socket work
+ * with poll(), the workers only append to a connection's output and wake it through a
+ * pipe. A full queue is answered with RUBIX_CUBE_SERVICE_BUSY right away, and a client
+ * with more than RUBIXD_OUTPUT_HIGH_WATER bytes of answers it has not read is not read
+ * from until it catches up.
+ *
+ * SIGINT or SIGTERM stops accepting, answers what is queued, prints the stats and exits.
+ */
+
+#include "rubix_cube_service.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define RUBIXD_DEFAULT_SOCKET 		"rubixd.sock"
+#define RUBIXD_MAX_CONNECTIONS 		1024
+#define RUBIXD_READ_SIZE 		65536
+#define RUBIXD_BUFFER_SIZE 		4096
+#define RUBIXD_MAX_RESPONSE 		(RUBIX_CUBE_SERVICE_RESPONSE_SIZE + RUBIX_CUBE_SERVICE_MAX_CODES)
+#define RUBIXD_OUTPUT_HIGH_WATER 	(1 << 20)	/* a connection with this much unread output is not read from */
+#define RUBIXD_FLUSH_TIMEOUT 		1000		/* ms to wait for a peer to take its last answers */
+
+typedef struct rubixd_buffer {
+	unsigned char * 		bytes ;
+	size_t 				size ;
+	size_t 				capacity ;
+} RubixdBuffer ;
+
+/* Freed by whoever is last, the poll loop closing it or the worker answering its last request */
+typedef struct rubixd_connection {
+	int 				fd ;
+	RubixdBuffer 			input ;
+	int 				eof ;		/* the peer is done sending, close once it has every answer */
+	pthread_mutex_t 		lock ;		/* around everything below */
+	RubixdBuffer 			output ;
+	size_t 				pending ;	/* requests queued and not answered yet */
+	int 				closed ;
+} RubixdConnection ;
+
+typedef struct rubixd_options {
+	const char * 			socket_path ;
+	unsigned 			port ;
+	RubixCubeServiceOptions 	service ;
+} RubixdOptions ;
+
+static volatile sig_atomic_t rubixd_stopping = 0 ;
+static int rubixd_wake[2] = { -1, -1 } ;
+
+/* The flag alone would wait for the next socket event if the signal lands between its check and poll(), so wake poll() too */
+static void rubixd_stop(int signal_number) {
+	int saved_errno = errno ;
+	ssize_t written ;
+
+	(void)signal_number ;
+	rubixd_stopping = 1 ;
+	written = write(rubixd_wake[1],"",1) ;
+	(void)written ;	/* a full pipe already has the poll loop awake */
+	errno = saved_errno ;
+}
+
+static int rubixd_buffer_append(RubixdBuffer * pBuffer, const unsigned char * bytes, size_t size) {
+	if (pBuffer->size + size > pBuffer->capacity) {
+		size_t capacity = pBuffer->capacity ? pBuffer->capacity : RUBIXD_BUFFER_SIZE ;
+		unsigned char * grown ;
+
+		while (capacity < pBuffer->size + size) capacity *= 2 ;
+		if (!(grown = (unsigned char *)realloc(pBuffer->bytes,capacity))) return 0 ;
+		pBuffer->bytes = grown ;
+		pBuffer->capacity = capacity ;
+	}
+	memcpy(&pBuffer->bytes[pBuffer->size],bytes,size) ;
+	pBuffer->size += size ;
+	return 1 ;
+}
+
+static void rubixd_buffer_consume(RubixdBuffer * pBuffer, size_t size) {
+	memmove(pBuffer->bytes,&pBuffer->bytes[size],pBuffer->size - size) ;
+	pBuffer->size -= size ;
+}
+
+static void rubixd_connection_free(RubixdConnection * pConnection) {
+	pthread_mutex_destroy(&pConnection->lock) ;
+	free(pConnection->input.bytes) ;
+	free(pConnection->output.bytes) ;
+	free(pConnection) ;
+}
+
+/* Queue an encoded response on @pConnection, with its lock held, and wake the poll loop if it had nothing to write */
+static void rubixd_connection_send(RubixdConnection * pConnection, const unsigned char * bytes, size_t size) {
+	int was_empty = !pConnection->output.size ;
+
+	if (pConnection->closed || !rubixd_buffer_append(&pConnection->output,bytes,size)) return ;
+	if (was_empty) {
+		ssize_t written = write(rubixd_wake[1],"",1) ;
+		(void)written ;	/* a full pipe already has the poll loop awake */
+	}
+}
+
+static void rubixd_respond(const RubixCubeServiceResponse * pResponse, void * context) {
+	RubixdConnection * pConnection = (RubixdConnection *)pResponse->owner ;
+	unsigned char bytes[RUBIXD_MAX_RESPONSE] ;
+	size_t size = rubix_cube_service_encode_response(bytes,pResponse) ;
+	int last ;
+
+	(void)context ;
+	pthread_mutex_lock(&pConnection->lock) ;
+	rubixd_connection_send(pConnection,bytes,size) ;
+	last = !--pConnection->pending && pConnection->closed ;
+	pthread_mutex_unlock(&pConnection->lock) ;
+	if (last) rubixd_connection_free(pConnection) ;
+}
+
+static void rubixd_connection_close(RubixdConnection * pConnection) {
+	int last ;
+
+	close(pConnection->fd) ;
+	pthread_mutex_lock(&pConnection->lock) ;
+	pConnection->closed = 1 ;
+	last = !pConnection->pending ;
+	pthread_mutex_unlock(&pConnection->lock) ;
+	if (last) rubixd_connection_free(pConnection) ;
+}
+
+/* Hand every whole request read so far to the service */
+static void rubixd_connection_dispatch(RubixCubeService * pService, RubixdConnection * pConnection) {
+	unsigned char bytes[RUBIXD_MAX_RESPONSE] ;
+	RubixCubeServiceRequest request ;
+	size_t used = 0, size ;
+
+	while ((size = rubix_cube_service_decode_request(&request,&pConnection->input.bytes[used],pConnection->input.size - used))) {
+		used += size ;
+		request.owner = pConnection ;
+
+		pthread_mutex_lock(&pConnection->lock) ;
+		if (request.kind == RUBIX_CUBE_SERVICE_STATS) {
+			RubixCubeServiceStats stats ;
+			rubix_cube_service_stats(pService,&stats) ;
+			rubixd_connection_send(pConnection,bytes,rubix_cube_service_encode_stats(bytes,request.id,&stats)) ;
+		} else if (rubix_cube_service_submit(pService,&request)) {
+			++pConnection->pending ;
+		} else {
+			RubixCubeServiceResponse busy = { .id = request.id, .kind = request.kind, .status = RUBIX_CUBE_SERVICE_BUSY } ;
+			rubixd_connection_send(pConnection,bytes,rubix_cube_service_encode_response(bytes,&busy)) ;
+		}
+		pthread_mutex_unlock(&pConnection->lock) ;
+	}
+	rubixd_buffer_consume(&pConnection->input,used) ;
+}
+
+/* Read and dispatch one buffer, return 0 once the peer is gone, the poll loop comes back for the rest */
+/* So the input never holds more than that and part of a request */
+/* A peer that only shut down its side still gets the answers to everything it sent before */
+static int rubixd_connection_read(RubixCubeService * pService, RubixdConnection * pConnection) {
+	unsigned char bytes[RUBIXD_READ_SIZE] ;
+	ssize_t size = read(pConnection->fd,bytes,sizeof(bytes)) ;
+
+	if (size > 0) {
+		if (!rubixd_buffer_append(&pConnection->input,bytes,(size_t)size)) return 0 ;
+		rubixd_connection_dispatch(pService,pConnection) ;
+		return 1 ;
+	}
+	pConnection->eof = size == 0 ;
+	return pConnection->eof || errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ;
+}
+
+/* Nonzero once a peer that is done sending has all of its answers */
+static int rubixd_connection_finished(RubixdConnection * pConnection) {
+	int finished ;
+
+	if (!pConnection->eof) return 0 ;
+	pthread_mutex_lock(&pConnection->lock) ;
+	finished = !pConnection->pending && !pConnection->output.size ;
+	pthread_mutex_unlock(&pConnection->lock) ;
+	return finished ;
+}
+
+/* Write out as much of the pending output as the socket takes, return 0 once the peer is gone */
+static int rubixd_connection_write(RubixdConnection * pConnection) {
+	int alive = 1 ;
+
+	pthread_mutex_lock(&pConnection->lock) ;
+	while (pConnection->output.size) {
+		ssize_t written = send(pConnection->fd,pConnection->output.bytes,pConnection->output.size,MSG_NOSIGNAL) ;
+		if (written < 0) {
+			alive = errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ;
+			break ;
+		}
+		rubixd_buffer_consume(&pConnection->output,(size_t)written) ;
+	}
+	pthread_mutex_unlock(&pConnection->lock) ;
+	return alive ;
+}
+
+static int rubixd_listen(const RubixdOptions * pOptions) {
+	int fd ;
+
+	if (pOptions->port) {
+		struct sockaddr_in address = { .sin_family = AF_INET, .sin_port = htons((uint16_t)pOptions->port), .sin_addr.s_addr = htonl(INADDR_ANY) } ;
+		int yes = 1 ;
+
+		if ((fd = socket(AF_INET,SOCK_STREAM,0)) < 0) return -1 ;
+		setsockopt(fd,SOL_SOCKET,SO_REUSEADDR,&yes,sizeof(yes)) ;
+		if (bind(fd,(struct sockaddr *)&address,sizeof(address)) || listen(fd,SOMAXCONN)) {
+			close(fd) ;
+			return -1 ;
+		}
+	} else {
+		struct sockaddr_un address = { .sun_family = AF_UNIX } ;
+
+		if (strlen(pOptions->socket_path) >= sizeof(address.sun_path) || (fd = socket(AF_UNIX,SOCK_STREAM,0)) < 0) return -1 ;
+		strcpy(address.sun_path,pOptions->socket_path) ;
+		unlink(pOptions->socket_path) ;
+		if (bind(fd,(struct sockaddr *)&address,sizeof(address)) || listen(fd,SOMAXCONN)) {
+			close(fd) ;
+			return -1 ;
+		}
+	}
+	fcntl(fd,F_SETFL,fcntl(fd,F_GETFL) | O_NONBLOCK) ;
+	return fd ;
+}
+
+static void rubixd_accept(int listener, RubixdConnection ** connections, size_t * pCount, int tcp) {
+	int fd, yes = 1 ;
+
+	while ((fd = accept(listener,NULL,NULL)) >= 0) {
+		RubixdConnection * pConnection ;
+
+		if (*pCount == RUBIXD_MAX_CONNECTIONS || !(pConnection = (RubixdConnection *)calloc(1,sizeof(RubixdConnection)))) {
+			close(fd) ;
+			continue ;
+		}
+		fcntl(fd,F_SETFL,fcntl(fd,F_GETFL) | O_NONBLOCK) ;
+		if (tcp) setsockopt(fd,IPPROTO_TCP,TCP_NODELAY,&yes,sizeof(yes)) ;
+		pConnection->fd = fd ;
+		pthread_mutex_init(&pConnection->lock,NULL) ;
+		connections[(*pCount)++] = pConnection ;
+	}
+}
+
+/* Write out what the connections still have, for as long as their peers keep taking it */
+static void rubixd_flush(RubixdConnection ** connections, size_t count) {
+	static struct pollfd fds[RUBIXD_MAX_CONNECTIONS] ;
+
+	for (;;) {
+		size_t waiting = 0 ;
+
+		for (size_t i = 0; i < count; ++i) {
+			if (!rubixd_connection_write(connections[i])) connections[i]->output.size = 0 ;	/* the workers are gone, no lock needed */
+			if (connections[i]->output.size) fds[waiting++] = (struct pollfd){ .fd = connections[i]->fd, .events = POLLOUT } ;
+		}
+		if (!waiting || poll(fds,waiting,RUBIXD_FLUSH_TIMEOUT) <= 0) return ;
+	}
+}
+
+static void rubixd_serve(RubixCubeService * pService, int listener, int tcp) {
+	static RubixdConnection * connections[RUBIXD_MAX_CONNECTIONS] ;
+	static struct pollfd fds[RUBIXD_MAX_CONNECTIONS + 2] ;
+	size_t count = 0 ;
+
+	while (!rubixd_stopping) {
+		fds[0] = (struct pollfd){ .fd = listener, .events = POLLIN } ;
+		fds[1] = (struct pollfd){ .fd = rubixd_wake[0], .events = POLLIN } ;
+		for (size_t i = 0; i < count; ++i) {
+			size_t output ;
+
+			pthread_mutex_lock(&connections[i]->lock) ;
+			output = connections[i]->output.size ;
+			pthread_mutex_unlock(&connections[i]->lock) ;
+			/* A client that does not read its answers is not read from either, until it catches up */
+			fds[i + 2] = (struct pollfd){ .fd = connections[i]->fd,
+				.events = (connections[i]->eof || output >= RUBIXD_OUTPUT_HIGH_WATER ? 0 : POLLIN) | (output ? POLLOUT : 0) } ;
+		}
+		if (poll(fds,count + 2,-1) < 0) continue ;
+
+		if (fds[1].revents & POLLIN) {
+			char drain[256] ;
+			while (read(rubixd_wake[0],drain,sizeof(drain)) > 0) ;
+		}
+		/* Everyone with output gets a try, a response may have come in since the poll */
+		for (size_t i = 0; i < count; ++i) {
+			short events = fds[i + 2].revents ;
+			int alive = !(events & (POLLERR | POLLNVAL)) && !(connections[i]->eof && events & POLLHUP) ;
+
+			if (alive && !connections[i]->eof && events & (POLLIN | POLLHUP)) alive = rubixd_connection_read(pService,connections[i]) ;
+			if (alive) alive = rubixd_connection_write(connections[i]) && !rubixd_connection_finished(connections[i]) ;
+			if (!alive) {
+				rubixd_connection_close(connections[i]) ;
+				connections[i] = connections[--count] ;
+				fds[i + 2] = fds[count + 2] ;
+				--i ;
+			}
+		}
+		if (fds[0].revents & POLLIN) rubixd_accept(listener,connections,&count,tcp) ;
+	}
+
+	/* Stop accepting, answer everything queued and write it out, then close */
+	close(listener) ;
+	rubix_cube_service_drain(pService) ;
+	rubixd_flush(connections,count) ;
+	for (size_t i = 0; i < count; ++i) rubixd_connection_close(connections[i]) ;
+}
+
+static int rubixd_parse_options(RubixdOptions * pOptions, int argc, char ** argv) {
+	pOptions->socket_path = RUBIXD_DEFAULT_SOCKET ;
+	pOptions->port = 0 ;
+	pOptions->service = RUBIX_CUBE_SERVICE_DEFAULT_OPTIONS ;
+
+	for (int i = 1; i < argc; ++i) {
+		if (i + 1 == argc) return 0 ;
+		if (!strcmp(argv[i],"--socket")) pOptions->socket_path = argv[++i] ;
+		else if (!strcmp(argv[i],"--port")) pOptions->port = (unsigned)strtoul(argv[++i],NULL,10) ;
+		else if (!strcmp(argv[i],"--threads")) pOptions->service.threads = strtoul(argv[++i],NULL,10) ;
+		else if (!strcmp(argv[i],"--batch")) pOptions->service.batch = strtoul(argv[++i],NULL,10) ;
+		else if (!strcmp(argv[i],"--queue")) pOptions->service.queue_capacity = strtoul(argv[++i],NULL,10) ;
+		else if (!strcmp(argv[i],"--pin")) pOptions->service.pin = atoi(argv[++i]) ;
+		else return 0 ;
+	}
+	return pOptions->port < 65536 ;
+}
+
+int main(int argc, char ** argv) {
+	struct sigaction action = { .sa_handler = rubixd_stop } ;
+	RubixCubeService * pService ;
+	RubixCubeServiceStats stats ;
+	RubixdOptions options ;
+	int listener ;
+
+	if (!rubixd_parse_options(&options,argc,argv)) {
+		fprintf(stderr,"usage: %s [--socket <path>] [--port <port>] [--threads <n>] [--batch <n>] [--queue <n>] [--pin <0|1>]\n",argv[0]) ;
+		return EXIT_FAILURE ;
+	}
+	options.service.callback = rubixd_respond ;
+
+	if (pipe(rubixd_wake)) {
+		perror("rubixd: pipe") ;
+		return EXIT_FAILURE ;
+	}
+	fcntl(rubixd_wake[0],F_SETFL,fcntl(rubixd_wake[0],F_GETFL) | O_NONBLOCK) ;
+	fcntl(rubixd_wake[1],F_SETFL,fcntl(rubixd_wake[1],F_GETFL) | O_NONBLOCK) ;
+	if ((listener = rubixd_listen(&options)) < 0) {
+		perror("rubixd: listen") ;
+		return EXIT_FAILURE ;
+	}
+	if (!(pService = rubix_cube_service_start(&options.service))) {
+		fprintf(stderr,"rubixd: could not start the workers\n") ;
+		return EXIT_FAILURE ;
+	}
+	sigaction(SIGINT,&action,NULL) ;
+	sigaction(SIGTERM,&action,NULL) ;
+	signal(SIGPIPE,SIG_IGN) ;
+	if (options.port) fprintf(stderr,"rubixd: listening on port %u\n",options.port) ;
+	else fprintf(stderr,"rubixd: listening on %s\n",options.socket_path) ;
+
+	rubixd_serve(pService,listener,options.port != 0) ;
+
+	if (!options.port) unlink(options.socket_path) ;
+	rubix_cube_service_stats(pService,&stats) ;
+	rubix_cube_service_stop(pService) ;
+	fprintf(stderr,"rubixd: %llu requests, %llu rejected, %llu batches, latency p50 %llu us p99 %llu us p99.9 %llu us max %llu us\n",
+		stats.completed,stats.rejected,stats.batches,stats.p50 / 1000,stats.p99 / 1000,stats.p999 / 1000,stats.max / 1000) ;
+	return EXIT_SUCCESS ;
+}
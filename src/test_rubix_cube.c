@@ -1,7 +1,68 @@
 #include "rubix_cube.h"
+#include "rubix_cube_cubie.h"
+#include "rubix_cube_facelet.h"
+#include "rubix_cube_batch.h"
+#include "rubix_cube_compiled.h"
+#include "rubix_cube_engine.h"
+#include "rubix_cube_rank.h"
+#include "rubix_cube_solver.h"
+#include "rubix_cube_two_phase.h"
+#include "rubix_cube_table.h"
+#include "rubix_cube_storage.h"
+#include "rubix_cube_packed_scramble.h"
+#include "rubix_cube_stats.h"
+#include "rubix_cube_tracked.h"
+#include "rubix_cube_zobrist.h"
+#include "rubix_cube_transposition.h"
+#include "rubix_cube_render.h"
+#include "rubix_cube_notation.h"
+#include "rubix_cube_nxn.h"
+#include "rubix_cube_pool.h"
+#include "rubix_cube_journal.h"
+#include "rubix_cube_symmetry.h"
+#include "rubix_cube_turn.h"
+#include "rubix_cube_optimize.h"
+#include "rubix_cube_monkeys.h"
+#include "rubix_cube_service.h"
+#include "rubix_cube_distributed.h"
+#include "rubix_cube_unrolled.h"
 #include "../lil_test/src/lil_test.h"
 #include <time.h>
-
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+
+static void count_engine_results(const RubixCubeEngineResult * pResult, void * context) {
+	if (pResult->verified) __atomic_add_fetch((size_t *)context,1,__ATOMIC_RELAXED) ;
+}
+
+/* Small databases over 4 corners and two sets of 4 edges, quick to build but good enough for short solves */
+static RubixCubeSolver * allocate_small_solver(void) {
+	const unsigned char corners[] = { RUBIX_CUBE_CORNER_URF, RUBIX_CUBE_CORNER_UFL, RUBIX_CUBE_CORNER_ULB, RUBIX_CUBE_CORNER_UBR } ;
+	const unsigned char top_edges[] = { RUBIX_CUBE_EDGE_UR, RUBIX_CUBE_EDGE_UF, RUBIX_CUBE_EDGE_UL, RUBIX_CUBE_EDGE_UB } ;
+	const unsigned char slice_edges[] = { RUBIX_CUBE_EDGE_FR, RUBIX_CUBE_EDGE_FL, RUBIX_CUBE_EDGE_BL, RUBIX_CUBE_EDGE_BR } ;
+	RubixCubePatternDatabase * databases[] = {
+		rubix_cube_pattern_allocate(RUBIX_CUBE_PIECE_KIND_CORNER,corners,4),
+		rubix_cube_pattern_allocate(RUBIX_CUBE_PIECE_KIND_EDGE,top_edges,4),
+		rubix_cube_pattern_allocate(RUBIX_CUBE_PIECE_KIND_EDGE,slice_edges,4)
+	} ;
+	return rubix_cube_solver_allocate(databases,3) ;
+}
+
+/* Overwrite one byte of the file at @path */
+static void corrupt_byte(const char * path, long offset) {
+	FILE * file = fopen(path,"r+b") ;
+	int byte ;
+	if (!file) return ;
+	fseek(file,offset,SEEK_SET) ;
+	byte = fgetc(file) ;
+	fseek(file,offset,SEEK_SET) ;
+	fputc(byte ^ 0x5a,file) ;
+	fclose(file) ;
+}
 
 TEST_SET(create_destroy,
 	TEST_CASE(on_stack,
@@ -312,6 +373,40 @@ TEST_SET(scrambling,
 		ASSERT(rubix_cube_is_solved(&a)) ;
 
 	) ;
+
+	TEST_CASE(random_access,
+		RubixCubeSeed seed = time(0) ;
+		RubixCubeMove moves[RUBIX_CUBE_SCRAMBLE_INTENSITY] ;
+		rubix_cube_generate_moves_from_seed(seed,RUBIX_CUBE_SCRAMBLE_INTENSITY,moves) ;
+
+		for (size_t k = 0; k < RUBIX_CUBE_SCRAMBLE_INTENSITY; ++k) {
+			RubixCubeMove move = rubix_cube_generate_move_from_seed(seed,k) ;
+			ASSERT(move.side == moves[k].side && move.rotation == moves[k].rotation) ;
+			ASSERT((size_t)move.side < RUBIX_CUBE_SIDE_COUNT && (size_t)move.rotation < RUBIX_CUBE_FACE_ROTATION_COUNT) ;
+		}
+
+		RubixCubeRandom random = rubix_cube_random_generate(seed) ;
+		rubix_cube_random_seek(&random,RUBIX_CUBE_SCRAMBLE_INTENSITY / 2) ;
+		RubixCubeMove move = rubix_cube_generate_random_move_r(&random) ;
+		ASSERT(move.side == moves[RUBIX_CUBE_SCRAMBLE_INTENSITY / 2].side) ;
+		ASSERT(move.rotation == moves[RUBIX_CUBE_SCRAMBLE_INTENSITY / 2].rotation) ;
+	) ;
+
+	TEST_CASE(independent_generators,
+		RubixCubeMove expected_a[RUBIX_CUBE_SCRAMBLE_INTENSITY], expected_b[RUBIX_CUBE_SCRAMBLE_INTENSITY] ;
+		rubix_cube_generate_moves_from_seed(1,RUBIX_CUBE_SCRAMBLE_INTENSITY,expected_a) ;
+		rubix_cube_generate_moves_from_seed(2,RUBIX_CUBE_SCRAMBLE_INTENSITY,expected_b) ;
+
+		/* Interleaving two generators (and rand()) must not disturb either sequence */
+		RubixCubeRandom a = rubix_cube_random_generate(1), b = rubix_cube_random_generate(2) ;
+		for (size_t k = 0; k < RUBIX_CUBE_SCRAMBLE_INTENSITY; ++k) {
+			RubixCubeMove move_a = rubix_cube_generate_random_move_r(&a) ;
+			srand(k) ; (void)rubix_cube_generate_random_move() ;
+			RubixCubeMove move_b = rubix_cube_generate_random_move_r(&b) ;
+			ASSERT(move_a.side == expected_a[k].side && move_a.rotation == expected_a[k].rotation) ;
+			ASSERT(move_b.side == expected_b[k].side && move_b.rotation == expected_b[k].rotation) ;
+		}
+	) ;
 )
 
 TEST_SET(double_print,
@@ -326,5 +421,2248 @@ TEST_SET(double_print,
 	) ;	
 ) ;
 
+TEST_SET(cubie,
+	TEST_CASE(solved_round_trip,
+		RubixCube cube = rubix_cube_generate_solved() ;
+		RubixCubeCubie cubie ;
+		ASSERT(rubix_cube_cubie_from_cube(&cubie,&cube)) ;
+		ASSERT(rubix_cube_cubie_is_solved(&cubie)) ;
+		RubixCube back = rubix_cube_cubie_to_cube(&cubie) ;
+		ASSERT(rubix_cube_equivelence_check(&cube,&back)) ;
+		ASSERT(sizeof(RubixCubeCubie) <= 40) ;
+	) ;
+
+	TEST_CASE(every_move_matches,
+		for (size_t side = 0; side < RUBIX_CUBE_SIDE_COUNT; ++side) {
+			for (size_t rotation = 0; rotation < RUBIX_CUBE_FACE_ROTATION_COUNT; ++rotation) {
+				RubixCube cube = rubix_cube_generate_solved() ;
+				RubixCubeCubie cubie = rubix_cube_cubie_generate_solved() ;
+				rubix_cube_rotate_face(&cube,side,rotation) ;
+				rubix_cube_cubie_rotate_face(&cubie,side,rotation) ;
+				RubixCube back = rubix_cube_cubie_to_cube(&cubie) ;
+				ASSERT(rubix_cube_equivelence_check(&cube,&back)) ;
+			}
+		}
+	) ;
+
+	TEST_CASE(scrambled_round_trip,
+		RubixCubeSeed seed = time(0) ;
+		RubixCube cube = rubix_cube_generate_scrambled(seed) ;
+		RubixCubeCubie cubie = rubix_cube_cubie_generate_solved() ;
+		RubixCubeMove moves[RUBIX_CUBE_SCRAMBLE_INTENSITY] ;
+		rubix_cube_generate_moves_from_seed(seed,RUBIX_CUBE_SCRAMBLE_INTENSITY,moves) ;
+		for (size_t i = 0; i < RUBIX_CUBE_SCRAMBLE_INTENSITY; ++i) rubix_cube_cubie_apply_move(&cubie,&moves[i]) ;
+
+		RubixCubeCubie converted ;
+		ASSERT(rubix_cube_cubie_from_cube(&converted,&cube)) ;
+		ASSERT(rubix_cube_cubie_equivelence_check(&cubie,&converted)) ;
+		RubixCube back = rubix_cube_cubie_to_cube(&cubie) ;
+		ASSERT(rubix_cube_equivelence_check(&cube,&back)) ;
+	) ;
+
+	TEST_CASE(rejects_impossible,
+		RubixCube cube = rubix_cube_generate_solved() ;
+		RubixCubeCubie cubie ;
+		/* flip a single edge in place */
+		RubixCubeColor tmp = cube.planes[0][1].sides[RUBIX_CUBE_SQUARE_TOP] ;
+		cube.planes[0][1].sides[RUBIX_CUBE_SQUARE_TOP] = cube.planes[0][1].sides[RUBIX_CUBE_SQUARE_FRONT] ;
+		cube.planes[0][1].sides[RUBIX_CUBE_SQUARE_FRONT] = tmp ;
+		ASSERT(!rubix_cube_cubie_from_cube(&cubie,&cube)) ;
+	) ;
+) ;
+
+TEST_SET(facelet,
+	TEST_CASE(solved_round_trip,
+		RubixCube cube = rubix_cube_generate_solved() ;
+		RubixCubeFacelets facelets = rubix_cube_facelets_from_cube(&cube) ;
+		ASSERT(rubix_cube_facelets_is_solved(&facelets)) ;
+		RubixCube back = rubix_cube_facelets_to_cube(&facelets) ;
+		ASSERT(rubix_cube_equivelence_check(&cube,&back)) ;
+	) ;
+
+	TEST_CASE(every_kernel_matches,
+		printf("Default facelet kernel: %s\n",rubix_cube_facelet_get_kernel_string(rubix_cube_facelet_get_kernel())) ;
+		for (size_t kernel = RUBIX_CUBE_FACELET_KERNEL_SCALAR; kernel < RUBIX_CUBE_FACELET_KERNEL_COUNT; ++kernel) {
+			if (!rubix_cube_facelet_select_kernel(kernel)) continue ;
+			printf("Checking facelet kernel: %s\n",rubix_cube_facelet_get_kernel_string(kernel)) ;
+
+			for (size_t side = 0; side < RUBIX_CUBE_SIDE_COUNT; ++side) {
+				for (size_t rotation = 0; rotation < RUBIX_CUBE_FACE_ROTATION_COUNT; ++rotation) {
+					RubixCube cube = rubix_cube_generate_solved() ;
+					RubixCubeFacelets facelets = rubix_cube_facelets_generate_solved() ;
+					rubix_cube_rotate_face(&cube,side,rotation) ;
+					rubix_cube_facelets_rotate_face(&facelets,side,rotation) ;
+					RubixCube back = rubix_cube_facelets_to_cube(&facelets) ;
+					ASSERT(rubix_cube_equivelence_check(&cube,&back)) ;
+				}
+			}
+
+			srand(time(0)) ;
+			RubixCube cube = rubix_cube_generate_solved() ;
+			RubixCubeFacelets facelets = rubix_cube_facelets_generate_solved() ;
+			for (size_t i = 0; i < 100; ++i) {
+				RubixCubeMove move = rubix_cube_generate_random_move() ;
+				rubix_cube_apply_move(&cube,&move) ;
+				rubix_cube_facelets_apply_move(&facelets,&move) ;
+			}
+			RubixCubeFacelets expected = rubix_cube_facelets_from_cube(&cube) ;
+			ASSERT(rubix_cube_facelets_equivelence_check(&facelets,&expected)) ;
+		}
+		ASSERT(rubix_cube_facelet_select_kernel(RUBIX_CUBE_FACELET_KERNEL_AUTO)) ;
+	) ;
+) ;
+
+TEST_SET(batch,
+	TEST_CASE(same_moves_for_all,
+		RubixCubeScramble * pScramble = rubix_cube_scramble_allocate(rubix_cube_generate_seed(),RUBIX_CUBE_SCRAMBLE_INTENSITY) ;
+		size_t count = 300 ;
+		RubixCubeBatch * pBatch = rubix_cube_batch_allocate(count) ;
+		RubixCubeFacelets * cubes = (RubixCubeFacelets *)aligned_alloc(RUBIX_CUBE_FACELET_STRIDE,count * sizeof(RubixCubeFacelets)) ;
+		ASSERT(pBatch && cubes) ;
+		ASSERT(rubix_cube_batch_count_solved(pBatch,NULL) == count) ;
+
+		for (size_t i = 0; i < count; ++i) {
+			RubixCube cube = rubix_cube_generate_scrambled(i) ;
+			rubix_cube_batch_store_cube(pBatch,i,&cube) ;
+			cubes[i] = rubix_cube_facelets_from_cube(&cube) ;
+		}
+		rubix_cube_batch_apply_scramble(pBatch,pScramble) ;
+		rubix_cube_facelets_apply_moves_all(cubes,count,pScramble->moves,pScramble->size) ;
+
+		for (size_t i = 0; i < count; ++i) {
+			RubixCube cube = rubix_cube_generate_scrambled(i) ;
+			rubix_cube_apply_scramble(&cube,pScramble) ;
+			RubixCube from_batch = rubix_cube_batch_load_cube(pBatch,i) ;
+			RubixCube from_array = rubix_cube_facelets_to_cube(&cubes[i]) ;
+			ASSERT(rubix_cube_equivelence_check(&cube,&from_batch)) ;
+			ASSERT(rubix_cube_equivelence_check(&cube,&from_array)) ;
+		}
+
+		free(cubes) ;
+		rubix_cube_batch_free(pBatch) ;
+		rubix_cube_scramble_free(pScramble) ;
+	) ;
+
+	TEST_CASE(one_move_each,
+		size_t count = 300 ;
+		RubixCubeBatch * pBatch = rubix_cube_batch_allocate(count) ;
+		RubixCubeFacelets * cubes = (RubixCubeFacelets *)aligned_alloc(RUBIX_CUBE_FACELET_STRIDE,count * sizeof(RubixCubeFacelets)) ;
+		RubixCubeMove * moves = (RubixCubeMove *)malloc(count * sizeof(RubixCubeMove)) ;
+		ASSERT(pBatch && cubes && moves) ;
+
+		srand(time(0)) ;
+		for (size_t i = 0; i < count; ++i) {
+			cubes[i] = rubix_cube_facelets_generate_solved() ;
+			moves[i] = rubix_cube_generate_random_move() ;
+		}
+		rubix_cube_batch_apply_each(pBatch,moves) ;
+		rubix_cube_facelets_apply_moves_each(cubes,moves,count) ;
+
+		unsigned char solved[300] ;
+		ASSERT(rubix_cube_batch_count_solved(pBatch,solved) == 0) ;
+		for (size_t i = 0; i < count; ++i) {
+			RubixCube cube = rubix_cube_generate_solved() ;
+			rubix_cube_apply_move(&cube,&moves[i]) ;
+			RubixCube from_batch = rubix_cube_batch_load_cube(pBatch,i) ;
+			RubixCube from_array = rubix_cube_facelets_to_cube(&cubes[i]) ;
+			ASSERT(!solved[i]) ;
+			ASSERT(rubix_cube_equivelence_check(&cube,&from_batch)) ;
+			ASSERT(rubix_cube_equivelence_check(&cube,&from_array)) ;
+		}
+
+		free(moves) ;
+		free(cubes) ;
+		rubix_cube_batch_free(pBatch) ;
+	) ;
+) ;
+
+TEST_SET(compiled,
+	TEST_CASE(matches_replay,
+		RubixCubeScramble * pScramble = rubix_cube_scramble_allocate(rubix_cube_generate_seed(),RUBIX_CUBE_SCRAMBLE_INTENSITY) ;
+		RubixCubeCompiledScramble compiled = rubix_cube_compile_scramble(pScramble) ;
+		ASSERT(compiled.size == pScramble->size) ;
+
+		RubixCube expected = rubix_cube_generate_scrambled(42) ;
+		RubixCube cube = expected ;
+		rubix_cube_apply_scramble(&expected,pScramble) ;
+		rubix_cube_compiled_scramble_apply(&cube,&compiled) ;
+		ASSERT(rubix_cube_equivelence_check(&cube,&expected)) ;
+
+		RubixCubeCubie cubie = rubix_cube_cubie_generate_solved(), expected_cubie ;
+		rubix_cube_compiled_scramble_apply_cubie(&cubie,&compiled) ;
+		RubixCube solved = rubix_cube_generate_solved() ;
+		rubix_cube_apply_scramble(&solved,pScramble) ;
+		ASSERT(rubix_cube_cubie_from_cube(&expected_cubie,&solved)) ;
+		ASSERT(rubix_cube_cubie_equivelence_check(&cubie,&expected_cubie)) ;
+
+		RubixCubeBatch * pBatch = rubix_cube_batch_allocate(100) ;
+		ASSERT(pBatch) ;
+		rubix_cube_compiled_scramble_apply_batch(pBatch,&compiled) ;
+		for (size_t i = 0; i < pBatch->count; ++i) {
+			RubixCube from_batch = rubix_cube_batch_load_cube(pBatch,i) ;
+			ASSERT(rubix_cube_equivelence_check(&from_batch,&solved)) ;
+		}
+
+		rubix_cube_batch_free(pBatch) ;
+		rubix_cube_scramble_free(pScramble) ;
+	) ;
+
+	TEST_CASE(power_and_order,
+		/* R U R' U' has order 6 */
+		RubixCubeMove sexy[] = {
+			{ RUBIX_CUBE_SQUARE_RIGHT, RUBIX_CUBE_FACE_ROTATION_CLOCKWISE },
+			{ RUBIX_CUBE_SQUARE_TOP, RUBIX_CUBE_FACE_ROTATION_CLOCKWISE },
+			{ RUBIX_CUBE_SQUARE_RIGHT, RUBIX_CUBE_FACE_ROTATION_COUNTERCLOCKWISE },
+			{ RUBIX_CUBE_SQUARE_TOP, RUBIX_CUBE_FACE_ROTATION_COUNTERCLOCKWISE },
+		} ;
+		RubixCubeCompiledScramble compiled = rubix_cube_compile_moves(sexy,4), powered ;
+		ASSERT(rubix_cube_compiled_scramble_order(&compiled) == 6) ;
+
+		/* R U has order 105 */
+		RubixCubeCompiledScramble ru = rubix_cube_compile_moves(sexy,2) ;
+		ASSERT(rubix_cube_compiled_scramble_order(&ru) == 105) ;
+
+		RubixCube cube = rubix_cube_generate_solved(), powered_cube = cube ;
+		for (size_t k = 0; k < 10; ++k) {
+			rubix_cube_compiled_scramble_power(&powered,&ru,k) ;
+			powered_cube = rubix_cube_generate_solved() ;
+			rubix_cube_compiled_scramble_apply(&powered_cube,&powered) ;
+			ASSERT(rubix_cube_equivelence_check(&cube,&powered_cube)) ;
+			ASSERT(powered.size == 2 * k) ;
+			for (size_t i = 0; i < 2; ++i) rubix_cube_apply_move(&cube,&sexy[i]) ;
+		}
+
+		rubix_cube_compiled_scramble_power(&powered,&ru,105 * 1000) ;
+		RubixCubeFacelets facelets = rubix_cube_facelets_generate_solved() ;
+		rubix_cube_compiled_scramble_apply_facelets(&facelets,&powered) ;
+		ASSERT(rubix_cube_facelets_is_solved(&facelets)) ;
+		ASSERT(rubix_cube_cubie_is_solved(&powered.cubie)) ;
+	) ;
+) ;
+
+TEST_SET(engine,
+	TEST_CASE(matches_serial_scrambles,
+		size_t count = 1000 ;
+		RubixCubeEngineResult * results = (RubixCubeEngineResult *)malloc(count * sizeof(RubixCubeEngineResult)) ;
+		RubixCubeEngineJob job = {
+			.first_seed 	= time(0),
+			.count 		= count,
+			.intensity 	= RUBIX_CUBE_SCRAMBLE_INTENSITY,
+			.threads 	= 4,
+			.results 	= results
+		} ;
+		RubixCubeEngineSummary summary ;
+		ASSERT(results) ;
+		ASSERT(rubix_cube_engine_run(&job,&summary)) ;
+		ASSERT(summary.processed == count && summary.failures == 0) ;
+
+		unsigned long long checksum = 0 ;
+		for (size_t i = 0; i < count; ++i) {
+			RubixCube expected = rubix_cube_generate_scrambled(job.first_seed + i) ;
+			ASSERT(results[i].seed == job.first_seed + i) ;
+			ASSERT(results[i].verified) ;
+			ASSERT(rubix_cube_equivelence_check(&results[i].cube,&expected)) ;
+			ASSERT(results[i].checksum == rubix_cube_engine_checksum(&expected)) ;
+			checksum += results[i].checksum ;
+		}
+		ASSERT(summary.checksum == checksum) ;
+		free(results) ;
+	) ;
+
+	TEST_CASE(same_summary_any_thread_count,
+		size_t verified = 0 ;
+		RubixCubeEngineJob job = {
+			.first_seed 	= 1,
+			.count 		= 777,
+			.intensity 	= 20,
+			.threads 	= 1,
+			.callback 	= count_engine_results,
+			.context 	= &verified
+		} ;
+		RubixCubeEngineSummary serial, parallel ;
+		ASSERT(rubix_cube_engine_run(&job,&serial)) ;
+		ASSERT(verified == job.count) ;
+
+		job.threads = 0 ;
+		ASSERT(rubix_cube_engine_run(&job,&parallel)) ;
+		ASSERT(verified == 2 * job.count) ;
+		ASSERT(serial.processed == parallel.processed && serial.checksum == parallel.checksum) ;
+	) ;
+) ;
+
+TEST_SET(rank,
+	TEST_CASE(solved_is_zero,
+		RubixCubeCubie cubie = rubix_cube_cubie_generate_solved() ;
+		ASSERT(rubix_cube_rank_corner_permutation(&cubie) == 0) ;
+		ASSERT(rubix_cube_rank_corner_orientation(&cubie) == 0) ;
+		ASSERT(rubix_cube_rank_edge_permutation(&cubie) == 0) ;
+		ASSERT(rubix_cube_rank_edge_orientation(&cubie) == 0) ;
+	) ;
+
+	TEST_CASE(every_corner_rank_round_trips,
+		RubixCubeCubie cubie = rubix_cube_cubie_generate_solved() ;
+		int ok = 1 ;
+		for (unsigned long rank = 0; rank < RUBIX_CUBE_RANK_CORNER_PERMUTATION_COUNT; ++rank) {
+			rubix_cube_unrank_corner_permutation(&cubie,rank) ;
+			ok &= rubix_cube_rank_corner_permutation(&cubie) == rank ;
+		}
+		for (unsigned long rank = 0; rank < RUBIX_CUBE_RANK_CORNER_ORIENTATION_COUNT; ++rank) {
+			rubix_cube_unrank_corner_orientation(&cubie,rank) ;
+			unsigned twist = 0 ;
+			for (size_t i = 0; i < RUBIX_CUBE_CORNER_COUNT; ++i) twist += cubie.corner_orientation[i] ;
+			ok &= rubix_cube_rank_corner_orientation(&cubie) == rank && twist % 3 == 0 ;
+		}
+		for (unsigned long rank = 0; rank < RUBIX_CUBE_RANK_EDGE_ORIENTATION_COUNT; ++rank) {
+			rubix_cube_unrank_edge_orientation(&cubie,rank) ;
+			ok &= rubix_cube_rank_edge_orientation(&cubie) == rank ;
+		}
+		ASSERT(ok) ;
+	) ;
+
+	TEST_CASE(scrambled_round_trip,
+		for (RubixCubeSeed seed = 1; seed <= 200; ++seed) {
+			RubixCube cube = rubix_cube_generate_scrambled(seed) ;
+			RubixCubeCubie cubie, rebuilt = rubix_cube_cubie_generate_solved() ;
+			ASSERT(rubix_cube_cubie_from_cube(&cubie,&cube)) ;
+
+			unsigned long ep = rubix_cube_rank_edge_permutation(&cubie) ;
+			ASSERT(ep < RUBIX_CUBE_RANK_EDGE_PERMUTATION_COUNT) ;
+			rubix_cube_unrank_corner_permutation(&rebuilt,rubix_cube_rank_corner_permutation(&cubie)) ;
+			rubix_cube_unrank_corner_orientation(&rebuilt,rubix_cube_rank_corner_orientation(&cubie)) ;
+			rubix_cube_unrank_edge_permutation(&rebuilt,ep) ;
+			rubix_cube_unrank_edge_orientation(&rebuilt,rubix_cube_rank_edge_orientation(&cubie)) ;
+			ASSERT(rubix_cube_cubie_equivelence_check(&cubie,&rebuilt)) ;
+		}
+	) ;
+
+	TEST_CASE(hash,
+		size_t count = 500 ;
+		unsigned long long hashes[500] ;
+		for (size_t i = 0; i < count; ++i) {
+			RubixCube cube = rubix_cube_generate_scrambled(i + 1), copy = cube ;
+			RubixCubeCubie cubie, other ;
+			hashes[i] = rubix_cube_hash(&cube) ;
+			ASSERT(hashes[i] == rubix_cube_hash(&copy)) ;
+			ASSERT(rubix_cube_cubie_from_cube(&cubie,&cube)) ;
+			other = cubie ;
+			ASSERT(rubix_cube_cubie_hash(&cubie) == rubix_cube_cubie_hash(&other)) ;
+			rubix_cube_rotate_face(&copy,RUBIX_CUBE_SQUARE_FRONT,RUBIX_CUBE_FACE_ROTATION_CLOCKWISE) ;
+			ASSERT(hashes[i] != rubix_cube_hash(&copy)) ;
+		}
+
+		int distinct = 1 ;
+		for (size_t i = 0; i < count; ++i) {
+			for (size_t j = i + 1; j < count; ++j) distinct &= hashes[i] != hashes[j] ;
+		}
+		ASSERT(distinct) ;
+	) ;
+) ;
+
+TEST_SET(solver,
+	TEST_CASE(pattern_database_is_complete,
+		const unsigned char corners[] = { RUBIX_CUBE_CORNER_URF, RUBIX_CUBE_CORNER_DRB, RUBIX_CUBE_CORNER_DLF } ;
+		RubixCubePatternDatabase * pDatabase = rubix_cube_pattern_allocate(RUBIX_CUBE_PIECE_KIND_CORNER,corners,3) ;
+		ASSERT(pDatabase) ;
+		ASSERT(pDatabase->size == rubix_cube_pattern_size(RUBIX_CUBE_PIECE_KIND_CORNER,3)) ;
+		ASSERT(pDatabase->size == 8 * 7 * 6 * 27) ;
+
+		int complete = 1 ;
+		for (size_t i = 0; i < pDatabase->size; ++i) complete &= rubix_cube_pattern_get(pDatabase,i) != RUBIX_CUBE_PATTERN_UNKNOWN ;
+		ASSERT(complete) ;
+		rubix_cube_pattern_free(pDatabase) ;
+
+		const unsigned char duplicate[] = { RUBIX_CUBE_CORNER_URF, RUBIX_CUBE_CORNER_URF } ;
+		ASSERT(!rubix_cube_pattern_allocate(RUBIX_CUBE_PIECE_KIND_CORNER,duplicate,2)) ;
+	) ;
+
+	TEST_CASE(estimate_is_admissible,
+		RubixCubeSolver * pSolver = allocate_small_solver() ;
+		ASSERT(pSolver) ;
+		for (RubixCubeSeed seed = 1; seed <= 100; ++seed) {
+			RubixCubeCubie cubie = rubix_cube_cubie_generate_solved() ;
+			for (size_t k = 0; k < 8; ++k) {
+				RubixCubeMove move = rubix_cube_generate_move_from_seed(seed,k) ;
+				rubix_cube_cubie_apply_move(&cubie,&move) ;
+				ASSERT(rubix_cube_solver_estimate(pSolver,&cubie) <= k + 1) ;
+			}
+		}
+		rubix_cube_solver_free(pSolver) ;
+	) ;
+
+	TEST_CASE(solves_short_scrambles,
+		RubixCubeSolver * pSolver = allocate_small_solver() ;
+		ASSERT(pSolver) ;
+
+		RubixCube cube = rubix_cube_generate_solved() ;
+		RubixCubeScramble * pSolution = rubix_cube_solver_solve(pSolver,&cube,RUBIX_CUBE_SOLVER_MAX_DEPTH) ;
+		ASSERT(pSolution && pSolution->size == 0) ;
+		rubix_cube_scramble_free(pSolution) ;
+
+		/* R U F D needs all four moves */
+		RubixCubeMove moves[] = {
+			{ RUBIX_CUBE_SQUARE_RIGHT, RUBIX_CUBE_FACE_ROTATION_CLOCKWISE },
+			{ RUBIX_CUBE_SQUARE_TOP, RUBIX_CUBE_FACE_ROTATION_CLOCKWISE },
+			{ RUBIX_CUBE_SQUARE_FRONT, RUBIX_CUBE_FACE_ROTATION_CLOCKWISE },
+			{ RUBIX_CUBE_SQUARE_BOTTOM, RUBIX_CUBE_FACE_ROTATION_CLOCKWISE },
+		} ;
+		for (size_t i = 0; i < 4; ++i) rubix_cube_apply_move(&cube,&moves[i]) ;
+		ASSERT(!rubix_cube_solver_solve(pSolver,&cube,3)) ;
+		pSolution = rubix_cube_solver_solve(pSolver,&cube,RUBIX_CUBE_SOLVER_MAX_DEPTH) ;
+		ASSERT(pSolution && pSolution->size == 4) ;
+		rubix_cube_apply_scramble(&cube,pSolution) ;
+		ASSERT(rubix_cube_is_solved(&cube)) ;
+		rubix_cube_scramble_free(pSolution) ;
+
+		for (RubixCubeSeed seed = 1; seed <= 10; ++seed) {
+			RubixCubeMove scramble[6] ;
+			cube = rubix_cube_generate_solved() ;
+			rubix_cube_generate_moves_from_seed(seed,6,scramble) ;
+			for (size_t i = 0; i < 6; ++i) rubix_cube_apply_move(&cube,&scramble[i]) ;
+
+			pSolution = rubix_cube_solver_solve(pSolver,&cube,RUBIX_CUBE_SOLVER_MAX_DEPTH) ;
+			ASSERT(pSolution && pSolution->size <= 6) ;
+			rubix_cube_apply_scramble(&cube,pSolution) ;
+			ASSERT(rubix_cube_is_solved(&cube)) ;
+			rubix_cube_scramble_free(pSolution) ;
+		}
+		rubix_cube_solver_free(pSolver) ;
+	) ;
+) ;
+
+TEST_SET(two_phase,
+	TEST_CASE(solved_needs_nothing,
+		RubixCube cube = rubix_cube_generate_solved() ;
+		RubixCubeScramble * pSolution = rubix_cube_two_phase_solve(&cube,NULL) ;
+		ASSERT(pSolution && pSolution->size == 0) ;
+		rubix_cube_scramble_free(pSolution) ;
+	) ;
+
+	TEST_CASE(solves_scrambles,
+		RubixCubeTwoPhaseLimits limits = RUBIX_CUBE_TWO_PHASE_DEFAULT_LIMITS ;
+		limits.seconds = 10.0 ;
+		for (RubixCubeSeed seed = 1; seed <= 20; ++seed) {
+			RubixCube cube = rubix_cube_generate_scrambled(seed) ;
+			RubixCubeScramble * pSolution = rubix_cube_two_phase_solve(&cube,&limits) ;
+			ASSERT(pSolution) ;
+			ASSERT(pSolution->size <= limits.max_length) ;
+			rubix_cube_apply_scramble(&cube,pSolution) ;
+			ASSERT(rubix_cube_is_solved(&cube)) ;
+			rubix_cube_scramble_free(pSolution) ;
+		}
+	) ;
+
+	TEST_CASE(respects_max_length,
+		RubixCubeTwoPhaseLimits limits = RUBIX_CUBE_TWO_PHASE_DEFAULT_LIMITS ;
+		RubixCube cube = rubix_cube_generate_solved() ;
+		RubixCubeMove moves[] = {
+			{ RUBIX_CUBE_SQUARE_RIGHT, RUBIX_CUBE_FACE_ROTATION_CLOCKWISE },
+			{ RUBIX_CUBE_SQUARE_TOP, RUBIX_CUBE_FACE_ROTATION_CLOCKWISE },
+			{ RUBIX_CUBE_SQUARE_FRONT, RUBIX_CUBE_FACE_ROTATION_CLOCKWISE },
+		} ;
+		for (size_t i = 0; i < 3; ++i) rubix_cube_apply_move(&cube,&moves[i]) ;
+
+		limits.max_length = 2 ;
+		ASSERT(!rubix_cube_two_phase_solve(&cube,&limits)) ;
+
+		limits.max_length = 3 ;
+		limits.target_length = 3 ;
+		RubixCubeScramble * pSolution = rubix_cube_two_phase_solve(&cube,&limits) ;
+		ASSERT(pSolution && pSolution->size == 3) ;
+		rubix_cube_apply_scramble(&cube,pSolution) ;
+		ASSERT(rubix_cube_is_solved(&cube)) ;
+		rubix_cube_scramble_free(pSolution) ;
+	) ;
+) ;
+
+TEST_SET(tables,
+	TEST_CASE(threaded_build_matches_serial,
+		const unsigned char edges[] = { RUBIX_CUBE_EDGE_UF, RUBIX_CUBE_EDGE_DB, RUBIX_CUBE_EDGE_FL, RUBIX_CUBE_EDGE_BR } ;
+		RubixCubePatternDatabase * pSerial = rubix_cube_pattern_allocate(RUBIX_CUBE_PIECE_KIND_EDGE,edges,4) ;
+		RubixCubePatternDatabase * pThreaded = rubix_cube_pattern_allocate_empty(RUBIX_CUBE_PIECE_KIND_EDGE,edges,4) ;
+		ASSERT(pSerial && pThreaded) ;
+		rubix_cube_pattern_build_threads(pThreaded,4) ;
+		ASSERT(pThreaded->depth == pSerial->depth) ;
+		ASSERT(!memcmp(pThreaded->table,pSerial->table,(pSerial->size + 1) / 2)) ;
+		rubix_cube_pattern_free(pSerial) ;
+		rubix_cube_pattern_free(pThreaded) ;
+	) ;
+
+	TEST_CASE(pattern_round_trip,
+		const char * path = "/tmp/rubix_cube_test_pattern.table" ;
+		const unsigned char corners[] = { RUBIX_CUBE_CORNER_URF, RUBIX_CUBE_CORNER_DRB, RUBIX_CUBE_CORNER_DLF } ;
+		RubixCubePatternDatabase * pDatabase = rubix_cube_pattern_allocate(RUBIX_CUBE_PIECE_KIND_CORNER,corners,3) ;
+		RubixCubeTableMapping mapping ;
+		ASSERT(pDatabase) ;
+		ASSERT(rubix_cube_pattern_save(pDatabase,path)) ;
+
+		RubixCubePatternDatabase * pMapped = rubix_cube_pattern_map(path) ;
+		ASSERT(pMapped) ;
+		ASSERT(pMapped->kind == pDatabase->kind && pMapped->count == 3 && pMapped->size == pDatabase->size) ;
+		ASSERT(pMapped->depth == pDatabase->depth) ;
+		ASSERT(!memcmp(pMapped->pieces,corners,3)) ;
+		ASSERT(!memcmp(pMapped->table,pDatabase->table,(pDatabase->size + 1) / 2)) ;
+		ASSERT(pMapped->mapping.address && rubix_cube_table_verify(&pMapped->mapping)) ;
+
+		/* Saving over a table that is mapped, here from that very mapping, leaves the mapping with the old file, whole */
+		ASSERT(rubix_cube_pattern_save(pMapped,path)) ;
+		ASSERT(rubix_cube_table_verify(&pMapped->mapping)) ;
+		ASSERT(!memcmp(pMapped->table,pDatabase->table,(pDatabase->size + 1) / 2)) ;
+		rubix_cube_pattern_free(pMapped) ;
+		ASSERT((pMapped = rubix_cube_pattern_map(path)) && rubix_cube_table_verify(&pMapped->mapping)) ;
+		rubix_cube_pattern_free(pMapped) ;
+
+		/* Wrong kind of table, then a damaged payload, then a damaged header */
+		ASSERT(!rubix_cube_table_map(&mapping,path,RUBIX_CUBE_TABLE_KIND_TWO_PHASE,NULL,0)) ;
+		ASSERT(!mapping.address) ;
+		corrupt_byte(path,sizeof(RubixCubeTableHeader) + 1) ;
+		ASSERT(rubix_cube_table_map(&mapping,path,RUBIX_CUBE_TABLE_KIND_PATTERN,NULL,0)) ;
+		ASSERT(!rubix_cube_table_verify(&mapping)) ;
+		rubix_cube_table_unmap(&mapping) ;
+		corrupt_byte(path,0) ;
+		ASSERT(!rubix_cube_pattern_map(path)) ;
+		ASSERT(!rubix_cube_pattern_map("/tmp/rubix_cube_test_missing.table")) ;
+
+		rubix_cube_pattern_free(pDatabase) ;
+		remove(path) ;
+	) ;
+
+	TEST_CASE(solver_round_trip,
+		char directory[] = "/tmp/rubix_cube_test_XXXXXX" ;
+		char path[RUBIX_CUBE_SOLVER_PATH_SIZE] ;
+		RubixCubeSolver * pSolver = allocate_small_solver() ;
+		ASSERT(pSolver && mkdtemp(directory)) ;
+		ASSERT(rubix_cube_solver_save(pSolver,directory)) ;
+
+		RubixCubeSolver * pMapped = rubix_cube_solver_map(directory) ;
+		ASSERT(pMapped && pMapped->number_of_databases == pSolver->number_of_databases) ;
+		for (RubixCubeSeed seed = 1; seed <= 20; ++seed) {
+			RubixCubeCubie cubie = rubix_cube_cubie_generate_solved() ;
+			for (size_t k = 0; k < 10; ++k) {
+				RubixCubeMove move = rubix_cube_generate_move_from_seed(seed,k) ;
+				rubix_cube_cubie_apply_move(&cubie,&move) ;
+			}
+			ASSERT(rubix_cube_solver_estimate(pMapped,&cubie) == rubix_cube_solver_estimate(pSolver,&cubie)) ;
+		}
+		rubix_cube_solver_free(pMapped) ;
+		rubix_cube_solver_free(pSolver) ;
+
+		for (size_t i = 0; i < 3; ++i) {
+			snprintf(path,sizeof(path),"%s/" RUBIX_CUBE_SOLVER_TABLE_NAME,directory,i) ;
+			remove(path) ;
+		}
+		ASSERT(!rubix_cube_solver_map(directory)) ;
+		rmdir(directory) ;
+	) ;
+
+	TEST_CASE(two_phase_round_trip,
+		const char * path = "/tmp/rubix_cube_test_two_phase.table" ;
+		RubixCubeTableMapping mapping ;
+		ASSERT(rubix_cube_two_phase_save(path)) ;
+		ASSERT(rubix_cube_table_map(&mapping,path,RUBIX_CUBE_TABLE_KIND_TWO_PHASE,NULL,0)) ;
+		ASSERT(rubix_cube_table_verify(&mapping)) ;
+		ASSERT(mapping.header->payload_size % RUBIX_CUBE_TABLE_ALIGNMENT == 0) ;
+		rubix_cube_table_unmap(&mapping) ;
+
+		/* Whether or not this replaces the tables in use, solving has to keep working */
+		rubix_cube_two_phase_map(path) ;
+		RubixCube cube = rubix_cube_generate_solved() ;
+		RubixCubeMove scramble[12] ;
+		rubix_cube_generate_moves_from_seed(3,12,scramble) ;
+		for (size_t i = 0; i < 12; ++i) rubix_cube_apply_move(&cube,&scramble[i]) ;
+		RubixCubeScramble * pSolution = rubix_cube_two_phase_solve(&cube,NULL) ;
+		ASSERT(pSolution) ;
+		rubix_cube_apply_scramble(&cube,pSolution) ;
+		ASSERT(rubix_cube_is_solved(&cube)) ;
+		rubix_cube_scramble_free(pSolution) ;
+		remove(path) ;
+	) ;
+) ;
+
+TEST_SET(storage,
+	TEST_CASE(pack_round_trip,
+		RubixCube cube = rubix_cube_generate_solved(), unpacked ;
+		RubixCubePacked packed ;
+		ASSERT(rubix_cube_pack(&packed,&cube)) ;
+		for (size_t i = 0; i < RUBIX_CUBE_PACKED_SIZE; ++i) ASSERT(!packed.bytes[i]) ;
+
+		for (RubixCubeSeed seed = 1; seed <= 200; ++seed) {
+			RubixCubeScramble * pScramble = rubix_cube_scramble_allocate(seed,RUBIX_CUBE_SCRAMBLE_INTENSITY) ;
+			cube = rubix_cube_generate_solved() ;
+			rubix_cube_apply_scramble(&cube,pScramble) ;
+			ASSERT(rubix_cube_pack(&packed,&cube)) ;
+			ASSERT(rubix_cube_unpack(&unpacked,&packed)) ;
+			ASSERT(rubix_cube_equivelence_check(&cube,&unpacked)) ;
+			rubix_cube_scramble_free(pScramble) ;
+		}
+	) ;
+
+	TEST_CASE(rejects_impossible_states,
+		RubixCubeCubie cubie = rubix_cube_cubie_generate_solved() ;
+		RubixCubePacked packed ;
+
+		/* Two edges swapped on their own can not be reached by face rotations */
+		cubie.edge_permutation[0] = 1 ;
+		cubie.edge_permutation[1] = 0 ;
+		ASSERT(rubix_cube_pack_cubie(&packed,&cubie)) ;
+		ASSERT(!rubix_cube_unpack_cubie(&cubie,&packed)) ;
+
+		memset(&packed,0,sizeof(packed)) ;
+		packed.bytes[15] = 1 ;
+		ASSERT(!rubix_cube_unpack_cubie(&cubie,&packed)) ;
+		memset(&packed,0xff,sizeof(packed)) ;
+		ASSERT(!rubix_cube_unpack_cubie(&cubie,&packed)) ;
+	) ;
+
+	TEST_CASE(state_file_round_trip,
+		const char * path = "/tmp/rubix_cube_test_states.bin" ;
+		const size_t count = 1000 ;
+		RubixCubeStateWriter * pWriter = rubix_cube_state_writer_open(path,64,RUBIX_CUBE_STATE_FILE_CHECKSUMS) ;
+		RubixCubeCubie expected[1000] ;
+		ASSERT(pWriter) ;
+
+		for (size_t i = 0; i < count; ++i) {
+			expected[i] = rubix_cube_cubie_generate_solved() ;
+			for (size_t k = 0; k < 20; ++k) {
+				RubixCubeMove move = rubix_cube_generate_move_from_seed(i + 1,k) ;
+				rubix_cube_cubie_apply_move(&expected[i],&move) ;
+			}
+			ASSERT(rubix_cube_state_writer_write_cubie(pWriter,&expected[i])) ;
+		}
+		ASSERT(rubix_cube_state_writer_close(pWriter)) ;
+
+		RubixCubeStateFile * pFile = rubix_cube_state_file_map(path) ;
+		ASSERT(pFile && pFile->count == count) ;
+		ASSERT(pFile->number_of_chunks == (count + 63) / 64) ;
+		ASSERT(rubix_cube_state_file_verify(pFile)) ;
+		ASSERT(!rubix_cube_state_file_get(pFile,count)) ;
+
+		int all_match = 1 ;
+		for (size_t i = 0; i < count; ++i) {
+			RubixCubeCubie cubie ;
+			all_match &= rubix_cube_unpack_cubie(&cubie,rubix_cube_state_file_get(pFile,i)) && rubix_cube_cubie_equivelence_check(&cubie,&expected[i]) ;
+		}
+		ASSERT(all_match) ;
+
+		const RubixCubePacked * states ;
+		size_t seen = 0 ;
+		for (size_t chunk = 0; chunk < pFile->number_of_chunks; ++chunk) {
+			size_t size = rubix_cube_state_file_chunk(pFile,chunk,&states) ;
+			ASSERT(states == rubix_cube_state_file_get(pFile,seen)) ;
+			seen += size ;
+		}
+		ASSERT(seen == count) ;
+		rubix_cube_state_file_unmap(pFile) ;
+
+		/* A flipped bit in the states is caught by the checksum, a shortened file by the header count */
+		corrupt_byte(path,sizeof(RubixCubeStateFileHeader) + sizeof(RubixCubeStateChunkHeader) + 3) ;
+		ASSERT((pFile = rubix_cube_state_file_map(path))) ;
+		ASSERT(!rubix_cube_state_file_verify(pFile)) ;
+		rubix_cube_state_file_unmap(pFile) ;
+		ASSERT(!truncate(path,sizeof(RubixCubeStateFileHeader) + 64 * 16 + 16)) ;
+		ASSERT(!rubix_cube_state_file_map(path)) ;
+		remove(path) ;
+	) ;
+
+	TEST_CASE(unfinished_file_keeps_whole_chunks,
+		const char * path = "/tmp/rubix_cube_test_unfinished.bin" ;
+		RubixCubeStateWriter * pWriter = rubix_cube_state_writer_open(path,16,0) ;
+		RubixCubePacked packed ;
+		RubixCube cube = rubix_cube_generate_solved() ;
+		ASSERT(pWriter && rubix_cube_pack(&packed,&cube)) ;
+		for (size_t i = 0; i < 40; ++i) rubix_cube_state_writer_write(pWriter,&packed,1) ;
+		fflush(pWriter->file) ;
+
+		/* Nothing closed yet, and the last 8 states have not even left the writer */
+		RubixCubeStateFile * pFile = rubix_cube_state_file_map(path) ;
+		ASSERT(pFile && pFile->count == 32) ;
+		ASSERT(rubix_cube_state_file_verify(pFile)) ;
+		rubix_cube_state_file_unmap(pFile) ;
+
+		ASSERT(rubix_cube_state_writer_close(pWriter)) ;
+		ASSERT((pFile = rubix_cube_state_file_map(path)) && pFile->count == 40) ;
+		rubix_cube_state_file_unmap(pFile) ;
+		remove(path) ;
+	) ;
+) ;
+
+TEST_SET(packed_scramble,
+	TEST_CASE(pack_round_trip,
+		RubixCubeMove moves[41], unpacked[41] ;
+		unsigned char codes[41], bits[RUBIX_CUBE_PACKED_MOVES_SIZE(41)] ;
+		rubix_cube_generate_moves_from_seed(12,41,moves) ;
+
+		ASSERT(RUBIX_CUBE_PACKED_MOVES_SIZE(8) == 5) ;
+		for (size_t count = 0; count <= 41; ++count) {
+			memset(unpacked,0,sizeof(unpacked)) ;
+			rubix_cube_moves_pack(bits,moves,count) ;
+			ASSERT(rubix_cube_moves_unpack(unpacked,bits,count)) ;
+			ASSERT(!memcmp(unpacked,moves,count * sizeof(RubixCubeMove))) ;
+		}
+
+		rubix_cube_moves_encode(codes,moves,41) ;
+		for (size_t i = 0; i < 41; ++i) ASSERT(codes[i] < RUBIX_CUBE_MOVE_COUNT) ;
+		ASSERT(rubix_cube_moves_decode(unpacked,codes,41)) ;
+		ASSERT(!memcmp(unpacked,moves,sizeof(moves))) ;
+
+		codes[7] = RUBIX_CUBE_MOVE_COUNT ;
+		ASSERT(!rubix_cube_moves_decode(unpacked,codes,41)) ;
+		memset(bits,0xff,sizeof(bits)) ;
+		ASSERT(!rubix_cube_moves_unpack(unpacked,bits,3)) ;
+	) ;
+
+	TEST_CASE(matches_scramble,
+		for (RubixCubeSeed seed = 1; seed <= 20; ++seed) {
+			RubixCubeScramble * pScramble = rubix_cube_scramble_allocate(seed,RUBIX_CUBE_SCRAMBLE_INTENSITY + seed) ;
+			RubixCubePackedScramble * pPacked = rubix_cube_packed_scramble_allocate(seed,RUBIX_CUBE_SCRAMBLE_INTENSITY + seed) ;
+			RubixCubePackedScramble * pCopy = rubix_cube_packed_scramble_from_scramble(pScramble) ;
+			ASSERT(pScramble && pPacked && pCopy) ;
+			ASSERT(pPacked->size == pScramble->size && pPacked->seed == seed) ;
+			ASSERT(!memcmp(pPacked->bits,pCopy->bits,RUBIX_CUBE_PACKED_MOVES_SIZE(pPacked->size))) ;
+
+			int same = 1 ;
+			for (size_t i = 0; i < pScramble->size; ++i) {
+				RubixCubeMove move = rubix_cube_packed_scramble_get(pPacked,i) ;
+				same &= move.side == pScramble->moves[i].side && move.rotation == pScramble->moves[i].rotation ;
+			}
+			ASSERT(same) ;
+
+			RubixCube expected = rubix_cube_generate_solved(), cube = rubix_cube_generate_solved() ;
+			rubix_cube_apply_scramble(&expected,pScramble) ;
+			rubix_cube_apply_packed_scramble(&cube,pPacked) ;
+			ASSERT(rubix_cube_equivelence_check(&cube,&expected)) ;
+			rubix_cube_unapply_packed_scramble(&cube,pPacked) ;
+			ASSERT(rubix_cube_is_solved(&cube)) ;
+
+			RubixCubeScramble * pUnpacked = rubix_cube_packed_scramble_to_scramble(pPacked) ;
+			ASSERT(pUnpacked && pUnpacked->size == pScramble->size) ;
+			ASSERT(!memcmp(pUnpacked->moves,pScramble->moves,pScramble->size * sizeof(RubixCubeMove))) ;
+
+			rubix_cube_scramble_free(pUnpacked) ;
+			rubix_cube_packed_scramble_free(pCopy) ;
+			rubix_cube_packed_scramble_free(pPacked) ;
+			rubix_cube_scramble_free(pScramble) ;
+		}
+	) ;
+
+	TEST_CASE(append_and_log,
+		RubixCubePackedScramble * pPacked = rubix_cube_packed_scramble_allocate(5,0) ;
+		RubixCubeMove moves[200] ;
+		ASSERT(pPacked && pPacked->size == 0) ;
+		rubix_cube_generate_moves_from_seed(5,200,moves) ;
+		for (size_t i = 0; i < 200; ++i) ASSERT(rubix_cube_packed_scramble_append(pPacked,&moves[i])) ;
+		ASSERT(pPacked->size == 200) ;
+
+		RubixCubePackedScramble * pExpected = rubix_cube_packed_scramble_allocate(5,200) ;
+		ASSERT(!memcmp(pPacked->bits,pExpected->bits,RUBIX_CUBE_PACKED_MOVES_SIZE(200))) ;
+
+		FILE * file = tmpfile() ;
+		ASSERT(file) ;
+		ASSERT(rubix_cube_packed_scramble_write(pPacked,file)) ;
+		ASSERT(rubix_cube_packed_scramble_write(pExpected,file)) ;
+		ASSERT(ftell(file) == 2 * (12 + RUBIX_CUBE_PACKED_MOVES_SIZE(200))) ;
+		rewind(file) ;
+		for (size_t record = 0; record < 2; ++record) {
+			RubixCubePackedScramble * pRead = rubix_cube_packed_scramble_read(file) ;
+			ASSERT(pRead && pRead->size == 200 && pRead->seed == 5) ;
+			ASSERT(!memcmp(pRead->bits,pExpected->bits,RUBIX_CUBE_PACKED_MOVES_SIZE(200))) ;
+			rubix_cube_packed_scramble_free(pRead) ;
+		}
+		ASSERT(!rubix_cube_packed_scramble_read(file)) ;
+
+		/* A size over the limit is refused before anything is allocated for it, and never written */
+		static const unsigned char huge[12] = { 5, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff, 0xff, 0xff } ;
+		long end = ftell(file) ;
+		ASSERT(fwrite(huge,sizeof(huge),1,file) == 1) ;
+		fseek(file,end,SEEK_SET) ;
+		ASSERT(!rubix_cube_packed_scramble_read(file)) ;
+		pPacked->size = RUBIX_CUBE_PACKED_SCRAMBLE_MAX_MOVES + 1 ;
+		ASSERT(!rubix_cube_packed_scramble_write(pPacked,file)) ;
+		pPacked->size = 200 ;
+		fclose(file) ;
+
+		rubix_cube_packed_scramble_free(pExpected) ;
+		rubix_cube_packed_scramble_free(pPacked) ;
+	) ;
+) ;
+
+static void * rotate_top_three_times(void * pArgument) {
+	RubixCube cube = rubix_cube_generate_solved() ;
+	for (size_t i = 0; i < 3; ++i) rubix_cube_rotate_face(&cube,RUBIX_CUBE_SQUARE_TOP,RUBIX_CUBE_FACE_ROTATION_CLOCKWISE) ;
+	return pArgument ;
+}
+
+TEST_SET(stats,
+	TEST_CASE(counts_hot_paths,
+		RubixCubeStats stats ;
+		RubixCube cube = rubix_cube_generate_solved() ;
+		RubixCubeScramble * pScramble = rubix_cube_scramble_allocate(7,10) ;
+		unsigned long long expected = rubix_cube_stats_enabled() ? 1 : 0 ;
+
+		rubix_cube_stats_enable_timers(1) ;
+		rubix_cube_stats_reset() ;
+		rubix_cube_rotate_face(&cube,RUBIX_CUBE_SQUARE_FRONT,RUBIX_CUBE_FACE_ROTATION_DOUBLE) ;
+		rubix_cube_apply_scramble(&cube,pScramble) ;
+		rubix_cube_unapply_scramble(&cube,pScramble) ;
+		rubix_cube_stats_snapshot(&stats) ;
+		rubix_cube_stats_enable_timers(0) ;
+
+		unsigned long long rotations = 0 ;
+		for (size_t side = 0; side < RUBIX_CUBE_SIDE_COUNT; ++side) rotations += stats.rotate_face[side] ;
+		ASSERT(rotations == expected * 21) ;
+		ASSERT(stats.rotate_face[RUBIX_CUBE_SQUARE_FRONT] >= expected) ;
+		/* Only the generic turns go through rubix_cube_rotate_piece_quadset() */
+		ASSERT(stats.rotate_piece_quadset == 0) ;
+		ASSERT(stats.apply_scramble == expected && stats.apply_scramble_moves == expected * 10) ;
+		ASSERT(stats.unapply_scramble == expected && stats.unapply_scramble_moves == expected * 10) ;
+		ASSERT(!expected || stats.apply_scramble_cycles) ;
+		ASSERT(stats.allocations == 0) ;
+		rubix_cube_stats_reset() ;
+		rubix_cube_rotate_face_generic(&cube,RUBIX_CUBE_SQUARE_FRONT,RUBIX_CUBE_FACE_ROTATION_DOUBLE) ;
+		rubix_cube_stats_snapshot(&stats) ;
+		ASSERT(stats.rotate_piece_quadset == expected * 2) ;
+		rubix_cube_scramble_free(pScramble) ;
+	) ;
+
+	TEST_CASE(adds_up_threads,
+		RubixCubeStats stats ;
+		pthread_t threads[4] ;
+		unsigned long long expected = rubix_cube_stats_enabled() ? 1 : 0 ;
+
+		rubix_cube_stats_reset() ;
+		RubixCube * pCube = rubix_cube_allocate_solved() ;
+		for (size_t i = 0; i < 4; ++i) pthread_create(&threads[i],NULL,rotate_top_three_times,NULL) ;
+		for (size_t i = 0; i < 4; ++i) pthread_join(threads[i],NULL) ;
+		rubix_cube_stats_snapshot(&stats) ;
+
+		ASSERT(stats.rotate_face[RUBIX_CUBE_SQUARE_TOP] == expected * 12) ;
+		ASSERT(stats.allocations == expected && stats.allocation_bytes == expected * sizeof(RubixCube)) ;
+		rubix_cube_free(pCube) ;
+
+		rubix_cube_stats_reset() ;
+		rubix_cube_stats_snapshot(&stats) ;
+		ASSERT(stats.rotate_face[RUBIX_CUBE_SQUARE_TOP] == 0) ;
+	) ;
+) ;
+
+TEST_SET(tracked,
+	TEST_CASE(matches_full_check,
+		RubixCubeTracked tracked = rubix_cube_tracked_generate_solved() ;
+		RubixCubeRandom random = rubix_cube_random_generate(15) ;
+		int same = 1, counts = 1 ;
+
+		RubixCube identity = RUBIX_CUBE_IDENTITY ;
+		ASSERT(!memcmp(&rubix_cube_solved,&identity,sizeof(RubixCube))) ;
+		ASSERT(rubix_cube_tracked_is_solved(&tracked)) ;
+		ASSERT(rubix_cube_is_solved(&tracked.cube)) ;
+		for (size_t i = 0; i < 2000; ++i) {
+			RubixCubeMove move = rubix_cube_generate_random_move_r(&random) ;
+			if (i % 7 == 3) rubix_cube_tracked_unapply_move(&tracked,&move) ;
+			else rubix_cube_tracked_apply_move(&tracked,&move) ;
+
+			RubixCubeTracked fresh = rubix_cube_tracked_from_cube(&tracked.cube) ;
+			counts &= fresh.misplaced == tracked.misplaced && tracked.misplaced <= 20 ;
+			same &= !rubix_cube_tracked_is_solved(&tracked) == !rubix_cube_is_solved(&tracked.cube) ;
+		}
+		ASSERT(counts) ;
+		ASSERT(same) ;
+	) ;
+
+	TEST_CASE(scramble_round_trip,
+		RubixCubeScramble * pScramble = rubix_cube_scramble_allocate(16,RUBIX_CUBE_SCRAMBLE_INTENSITY) ;
+		RubixCubeTracked tracked = rubix_cube_tracked_generate_solved() ;
+		ASSERT(pScramble) ;
+
+		rubix_cube_tracked_rotate_face(&tracked,RUBIX_CUBE_FACE_TOP,RUBIX_CUBE_FACE_ROTATION_CLOCKWISE) ;
+		ASSERT(rubix_cube_tracked_misplaced(&tracked) == 8) ;
+		rubix_cube_tracked_rotate_face(&tracked,RUBIX_CUBE_FACE_TOP,RUBIX_CUBE_FACE_ROTATION_COUNTERCLOCKWISE) ;
+		ASSERT(rubix_cube_tracked_is_solved(&tracked)) ;
+
+		rubix_cube_tracked_apply_scramble(&tracked,pScramble) ;
+		ASSERT(!rubix_cube_tracked_is_solved(&tracked)) ;
+		rubix_cube_tracked_unapply_scramble(&tracked,pScramble) ;
+		ASSERT(rubix_cube_tracked_is_solved(&tracked)) ;
+		ASSERT(rubix_cube_is_solved(&tracked.cube)) ;
+		rubix_cube_scramble_free(pScramble) ;
+	) ;
+) ;
+
+TEST_SET(zobrist,
+	TEST_CASE(incremental_matches_full,
+		RubixCube cube = rubix_cube_generate_solved() ;
+		RubixCubeHash hash = rubix_cube_zobrist_hash(&cube), solved = hash ;
+		RubixCubeTracked tracked = rubix_cube_tracked_generate_solved() ;
+		RubixCubeRandom random = rubix_cube_random_generate(16) ;
+		int same = 1 ;
+
+		ASSERT(rubix_cube_tracked_hash(&tracked) == solved) ;
+		for (size_t i = 0; i < 2000; ++i) {
+			RubixCubeMove move = rubix_cube_generate_random_move_r(&random) ;
+			hash = rubix_cube_zobrist_apply_move(&cube,hash,&move) ;
+			rubix_cube_tracked_apply_move(&tracked,&move) ;
+			same &= hash == rubix_cube_zobrist_hash(&cube) && hash == rubix_cube_tracked_hash(&tracked) ;
+		}
+		ASSERT(same) ;
+		ASSERT(hash != solved) ;
+
+		cube = rubix_cube_generate_solved() ;
+		hash = rubix_cube_zobrist_rotate_face(&cube,solved,RUBIX_CUBE_FACE_RIGHT,RUBIX_CUBE_FACE_ROTATION_DOUBLE) ;
+		hash = rubix_cube_zobrist_rotate_face(&cube,hash,RUBIX_CUBE_FACE_RIGHT,RUBIX_CUBE_FACE_ROTATION_DOUBLE) ;
+		ASSERT(hash == solved) ;
+	) ;
+
+	TEST_CASE(distinct_states,
+		/* Every state one and two moves from solved is different, so should every hash be */
+		RubixCubeHash hashes[RUBIX_CUBE_MOVE_COUNT * (RUBIX_CUBE_MOVE_COUNT + 1)] ;
+		size_t count = 0, collisions = 0 ;
+
+		for (size_t first = 0; first < RUBIX_CUBE_MOVE_COUNT; ++first) {
+			RubixCube cube = rubix_cube_generate_solved() ;
+			RubixCubeHash hash = rubix_cube_zobrist_hash(&cube) ;
+			hash = rubix_cube_zobrist_rotate_face(&cube,hash,first / RUBIX_CUBE_FACE_ROTATION_COUNT,first % RUBIX_CUBE_FACE_ROTATION_COUNT) ;
+			hashes[count++] = hash ;
+			for (size_t second = 0; second < RUBIX_CUBE_MOVE_COUNT; ++second) {
+				if (second / RUBIX_CUBE_FACE_ROTATION_COUNT <= first / RUBIX_CUBE_FACE_ROTATION_COUNT) continue ;
+				RubixCube next = cube ;
+				hashes[count++] = rubix_cube_zobrist_rotate_face(&next,hash,second / RUBIX_CUBE_FACE_ROTATION_COUNT,second % RUBIX_CUBE_FACE_ROTATION_COUNT) ;
+			}
+		}
+		for (size_t i = 0; i < count; ++i) {
+			for (size_t j = i + 1; j < count; ++j) collisions += hashes[i] == hashes[j] ;
+		}
+		ASSERT(count > RUBIX_CUBE_MOVE_COUNT) ;
+		ASSERT(collisions == 0) ;
+	) ;
+) ;
+
+/* Packed state of the cube @moves moves from solved along the sequence for @seed */
+static RubixCubePacked packed_after_moves(RubixCubeSeed seed, size_t moves) {
+	RubixCubeCubie cubie = rubix_cube_cubie_generate_solved() ;
+	RubixCubePacked packed ;
+	for (size_t k = 0; k < moves; ++k) {
+		RubixCubeMove move = rubix_cube_generate_move_from_seed(seed,k) ;
+		rubix_cube_cubie_apply_move(&cubie,&move) ;
+	}
+	rubix_cube_pack_cubie(&packed,&cubie) ;
+	return packed ;
+}
+
+typedef struct transposition_worker {
+	RubixCubeTranspositionTable * 	pTable ;
+	size_t 				first ;
+	size_t 				inserted ;
+} TranspositionWorker ;
+
+/* Every worker inserts the same 2000 states, starting at a different one */
+static void * insert_states(void * argument) {
+	TranspositionWorker * pWorker = (TranspositionWorker *)argument ;
+	for (size_t i = 0; i < 2000; ++i) {
+		RubixCubePacked packed = packed_after_moves(1 + (pWorker->first + i) % 2000,12) ;
+		pWorker->inserted += rubix_cube_transposition_insert(pWorker->pTable,&packed,1,NULL) == RUBIX_CUBE_TRANSPOSITION_INSERTED ;
+	}
+	return NULL ;
+}
+
+TEST_SET(transposition,
+	TEST_CASE(insert_and_lookup,
+		RubixCubeTranspositionTable * pTable = rubix_cube_transposition_allocate(1000,RUBIX_CUBE_TRANSPOSITION_KEEP_SMALLER,RUBIX_CUBE_TRANSPOSITION_HUGE_PAGES) ;
+		uint32_t value = 0, previous = 0 ;
+		ASSERT(pTable) ;
+		ASSERT(pTable->capacity == 1024) ;
+
+		RubixCubePacked first = packed_after_moves(1,10), second = packed_after_moves(2,10) ;
+		ASSERT(!rubix_cube_transposition_lookup(pTable,&first,&value)) ;
+		ASSERT(rubix_cube_transposition_insert(pTable,&first,7,NULL) == RUBIX_CUBE_TRANSPOSITION_INSERTED) ;
+		ASSERT(rubix_cube_transposition_lookup(pTable,&first,&value) && value == 7) ;
+		ASSERT(!rubix_cube_transposition_lookup(pTable,&second,NULL)) ;
+
+		ASSERT(rubix_cube_transposition_insert(pTable,&first,9,&previous) == RUBIX_CUBE_TRANSPOSITION_FOUND && previous == 7) ;
+		ASSERT(rubix_cube_transposition_lookup(pTable,&first,&value) && value == 7) ;
+		ASSERT(rubix_cube_transposition_insert(pTable,&first,3,&previous) == RUBIX_CUBE_TRANSPOSITION_FOUND && previous == 7) ;
+		ASSERT(rubix_cube_transposition_lookup(pTable,&first,&value) && value == 3) ;
+		ASSERT(rubix_cube_transposition_count(pTable) == 1) ;
+
+		rubix_cube_transposition_clear(pTable) ;
+		ASSERT(!rubix_cube_transposition_lookup(pTable,&first,NULL)) ;
+		ASSERT(rubix_cube_transposition_count(pTable) == 0) ;
+		rubix_cube_transposition_free(pTable) ;
+	) ;
+
+	TEST_CASE(policies_when_full,
+		/* A table of one probe window fills up after RUBIX_CUBE_TRANSPOSITION_PROBES states */
+		RubixCubeTranspositionTable * pKeep = rubix_cube_transposition_allocate(1,RUBIX_CUBE_TRANSPOSITION_KEEP_FIRST,0) ;
+		RubixCubeTranspositionTable * pReplace = rubix_cube_transposition_allocate(1,RUBIX_CUBE_TRANSPOSITION_REPLACE,0) ;
+		RubixCubeTranspositionTable * pSmaller = rubix_cube_transposition_allocate(1,RUBIX_CUBE_TRANSPOSITION_KEEP_SMALLER,0) ;
+		ASSERT(pKeep && pReplace && pSmaller) ;
+		ASSERT(pKeep->capacity == RUBIX_CUBE_TRANSPOSITION_PROBES) ;
+
+		for (size_t i = 0; i < RUBIX_CUBE_TRANSPOSITION_PROBES; ++i) {
+			RubixCubePacked packed = packed_after_moves(100 + i,8) ;
+			ASSERT(rubix_cube_transposition_insert(pKeep,&packed,10 + i,NULL) == RUBIX_CUBE_TRANSPOSITION_INSERTED) ;
+			ASSERT(rubix_cube_transposition_insert(pReplace,&packed,10 + i,NULL) == RUBIX_CUBE_TRANSPOSITION_INSERTED) ;
+			ASSERT(rubix_cube_transposition_insert(pSmaller,&packed,10 + i,NULL) == RUBIX_CUBE_TRANSPOSITION_INSERTED) ;
+		}
+		RubixCubePacked extra = packed_after_moves(99,8), largest = packed_after_moves(100 + RUBIX_CUBE_TRANSPOSITION_PROBES - 1,8) ;
+		ASSERT(rubix_cube_transposition_insert(pKeep,&extra,1,NULL) == RUBIX_CUBE_TRANSPOSITION_FULL) ;
+		ASSERT(rubix_cube_transposition_insert(pSmaller,&extra,100,NULL) == RUBIX_CUBE_TRANSPOSITION_FULL) ;
+		ASSERT(rubix_cube_transposition_insert(pSmaller,&extra,1,NULL) == RUBIX_CUBE_TRANSPOSITION_INSERTED) ;
+		ASSERT(!rubix_cube_transposition_lookup(pSmaller,&largest,NULL)) ;
+		ASSERT(rubix_cube_transposition_insert(pReplace,&extra,1,NULL) == RUBIX_CUBE_TRANSPOSITION_INSERTED) ;
+		ASSERT(rubix_cube_transposition_lookup(pReplace,&extra,NULL)) ;
+		ASSERT(pReplace->evictions == 1 && pSmaller->evictions == 1) ;
+
+		rubix_cube_transposition_free(pKeep) ;
+		rubix_cube_transposition_free(pReplace) ;
+		rubix_cube_transposition_free(pSmaller) ;
+	) ;
+
+	TEST_CASE(concurrent_inserts,
+		RubixCubeTranspositionTable * pTable = rubix_cube_transposition_allocate(1 << 14,RUBIX_CUBE_TRANSPOSITION_KEEP_FIRST,0) ;
+		TranspositionWorker workers[4] ;
+		pthread_t threads[4] ;
+		size_t inserted = 0 ;
+		ASSERT(pTable) ;
+
+		for (size_t i = 0; i < 4; ++i) {
+			workers[i] = (TranspositionWorker){ pTable, i * 500, 0 } ;
+			ASSERT(!pthread_create(&threads[i],NULL,insert_states,&workers[i])) ;
+		}
+		for (size_t i = 0; i < 4; ++i) {
+			pthread_join(threads[i],NULL) ;
+			inserted += workers[i].inserted ;
+		}
+		/* Each state went in exactly once, whichever thread got there first */
+		ASSERT(rubix_cube_transposition_count(pTable) == inserted) ;
+		ASSERT(inserted <= 2000 && inserted > 1900) ;
+		rubix_cube_transposition_free(pTable) ;
+	) ;
+
+	TEST_CASE(engine_and_solver,
+		RubixCubeTranspositionTable * pVisited = rubix_cube_transposition_allocate(4096,RUBIX_CUBE_TRANSPOSITION_KEEP_SMALLER,0) ;
+		RubixCubeEngineJob job = {
+			.first_seed 	= 1,
+			.count 		= 500,
+			.intensity 	= 2,
+			.threads 	= 3,
+			.pVisited 	= pVisited
+		} ;
+		RubixCubeEngineSummary summary ;
+		ASSERT(pVisited) ;
+		/* There are only 18 * 18 two move scrambles, and fewer states */
+		ASSERT(rubix_cube_engine_run(&job,&summary)) ;
+		ASSERT(summary.duplicates == summary.processed - rubix_cube_transposition_count(pVisited)) ;
+		ASSERT(rubix_cube_transposition_count(pVisited) < 18 * 18) ;
+		rubix_cube_transposition_free(pVisited) ;
+
+		RubixCubeSolver * pSolver = allocate_small_solver() ;
+		ASSERT(pSolver) ;
+		pSolver->pTransposition = rubix_cube_transposition_allocate(1 << 16,RUBIX_CUBE_TRANSPOSITION_KEEP_SMALLER,0) ;
+		ASSERT(pSolver->pTransposition) ;
+		int shortest = 1 ;
+		for (RubixCubeSeed seed = 1; seed <= 5; ++seed) {
+			RubixCube cube = rubix_cube_generate_solved() ;
+			RubixCubeScramble * pScramble = rubix_cube_scramble_allocate(seed,6), * pPlain, * pTransposed ;
+			rubix_cube_apply_scramble(&cube,pScramble) ;
+
+			RubixCubeTranspositionTable * pTable = pSolver->pTransposition ;
+			pSolver->pTransposition = NULL ;
+			pPlain = rubix_cube_solver_solve(pSolver,&cube,RUBIX_CUBE_SOLVER_MAX_DEPTH) ;
+			pSolver->pTransposition = pTable ;
+			pTransposed = rubix_cube_solver_solve(pSolver,&cube,RUBIX_CUBE_SOLVER_MAX_DEPTH) ;
+
+			shortest &= pPlain && pTransposed && pPlain->size == pTransposed->size ;
+			if (pTransposed) {
+				rubix_cube_apply_scramble(&cube,pTransposed) ;
+				shortest &= rubix_cube_is_solved(&cube) ;
+			}
+			rubix_cube_scramble_free(pScramble) ;
+			rubix_cube_scramble_free(pPlain) ;
+			rubix_cube_scramble_free(pTransposed) ;
+		}
+		ASSERT(shortest) ;
+		ASSERT(rubix_cube_transposition_count(pSolver->pTransposition) > 0) ;
+		rubix_cube_transposition_free(pSolver->pTransposition) ;
+		rubix_cube_solver_free(pSolver) ;
+	) ;
+) ;
+
+/* FNV-1a over bytes, to pin down renderings without pasting them in here */
+static unsigned long long fnv1a(const char * data, size_t size) {
+	unsigned long long hash = 0xcbf29ce484222325ULL ;
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= (unsigned char)data[i] ;
+		hash *= 0x100000001b3ULL ;
+	}
+	return hash ;
+}
+
+TEST_SET(render,
+	TEST_CASE(matches_printf_templates,
+		/* Taken from the printf based printing, for the solved cube then scrambled cubes 1 to 5 */
+		const unsigned long long expected[RUBIX_CUBE_RENDER_LAYOUT_COUNT] = {
+			0xe425c810b7869200ULL, 0x2189b0ece87ac334ULL,
+			0x78215a0f2c2e3d14ULL, 0x7f38096ccaab9949ULL, 0x186107cb0d963fb7ULL,
+			0x3826a1a39cca22afULL, 0x01618826c7c1bd7fULL, 0x7617c410de4681caULL
+		} ;
+		static char buffer[6 * RUBIX_CUBE_RENDER_MAX_SIZE] ;
+		RubixCube cubes[6] ;
+		int same = 1 ;
+
+		cubes[0] = rubix_cube_generate_solved() ;
+		for (size_t i = 1; i < 6; ++i) cubes[i] = rubix_cube_generate_scrambled(i) ;
+		for (size_t layout = 0; layout < RUBIX_CUBE_RENDER_LAYOUT_COUNT; ++layout) {
+			size_t size = rubix_cube_render_batch(buffer,sizeof(buffer),(RubixCubeRenderLayout)layout,cubes,6,NULL) ;
+			same &= size == 6 * rubix_cube_render_size((RubixCubeRenderLayout)layout) && fnv1a(buffer,size) == expected[layout] ;
+		}
+		ASSERT(same) ;
+		ASSERT(rubix_cube_render_size(RUBIX_CUBE_RENDER_WHOLE_CUBE) == 1198) ;
+		ASSERT(!rubix_cube_render_size(RUBIX_CUBE_RENDER_LAYOUT_COUNT)) ;
+		ASSERT(!rubix_cube_render_batch(buffer,5 * rubix_cube_render_size(RUBIX_CUBE_RENDER_HALF_CUBE) + 1,RUBIX_CUBE_RENDER_HALF_CUBE,cubes,6,NULL)) ;
+	) ;
+
+	TEST_CASE(glyphs_and_files,
+		const char glyphs[] = "_urbglo" ;
+		RubixCube cube = rubix_cube_generate_solved() ;
+		char buffer[RUBIX_CUBE_RENDER_MAX_SIZE], printed[RUBIX_CUBE_RENDER_MAX_SIZE] ;
+
+		size_t size = rubix_cube_render(buffer,sizeof(buffer),RUBIX_CUBE_RENDER_LAYOUT_FACE(RUBIX_CUBE_SQUARE_FRONT),&cube,glyphs) ;
+		ASSERT(size == rubix_cube_render_size(RUBIX_CUBE_RENDER_FACE)) ;
+		ASSERT(!memcmp(buffer,"+---+---+---+\n| r | r | r |\n",28)) ;
+
+		/* The faces go to the file they are asked to, not stdout */
+		FILE * file = tmpfile() ;
+		ASSERT(file) ;
+		rubix_cube_print_all_faces_ascii(file,&cube) ;
+		size = rubix_cube_render_all_faces(buffer,sizeof(buffer),&cube,NULL) ;
+		ASSERT(size && (size_t)ftell(file) == size) ;
+		rewind(file) ;
+		ASSERT(fread(printed,1,size,file) == size && !memcmp(printed,buffer,size)) ;
+		ASSERT(!memcmp(buffer,"Top face:\n+---+",15)) ;
+		fclose(file) ;
+	) ;
+) ;
+
+TEST_SET(move_codes,
+	TEST_CASE(inverse_index,
+		for (size_t code = 0; code < RUBIX_CUBE_MOVE_COUNT; ++code) {
+			RubixCube cube = rubix_cube_generate_solved() ;
+			size_t inverse = RUBIX_CUBE_MOVE_INDEX_INVERSE(code) ;
+			ASSERT(inverse / RUBIX_CUBE_FACE_ROTATION_COUNT == code / RUBIX_CUBE_FACE_ROTATION_COUNT) ;
+			rubix_cube_rotate_face(&cube,code / RUBIX_CUBE_FACE_ROTATION_COUNT,code % RUBIX_CUBE_FACE_ROTATION_COUNT) ;
+			rubix_cube_rotate_face(&cube,inverse / RUBIX_CUBE_FACE_ROTATION_COUNT,inverse % RUBIX_CUBE_FACE_ROTATION_COUNT) ;
+			ASSERT(rubix_cube_is_solved(&cube)) ;
+		}
+	) ;
+
+	TEST_CASE(plane_model,
+		RubixCubeSeed seeds[8] = { 1, 2, 3, 4, 5, 6, 7, 0 } ;
+		unsigned char codes[8 * 30], results[8] ;
+		RubixCube cubes[8] ;
+
+		rubix_cube_generate_move_codes(codes,seeds,8,30) ;
+		ASSERT(seeds[7]) ;
+		for (size_t i = 0; i < 8; ++i) {
+			RubixCube expected = rubix_cube_generate_solved() ;
+			RubixCubeScramble * pScramble = rubix_cube_scramble_allocate(seeds[i],30) ;
+			ASSERT(pScramble) ;
+			rubix_cube_apply_scramble(&expected,pScramble) ;
+			rubix_cube_scramble_free(pScramble) ;
+
+			cubes[i] = rubix_cube_generate_solved() ;
+			ASSERT(rubix_cube_apply_move_codes(&cubes[i],codes + 30 * i,30)) ;
+			ASSERT(rubix_cube_equivelence_check(&cubes[i],&expected)) ;
+		}
+		ASSERT(rubix_cube_count_solved(cubes,8,results) == 0) ;
+		ASSERT(rubix_cube_unapply_move_codes(&cubes[2],codes + 60,30)) ;
+		ASSERT(rubix_cube_count_solved(cubes,8,results) == 1 && results[2] && !results[3]) ;
+
+		/* A bad code anywhere means nothing is applied */
+		RubixCube before = cubes[0] ;
+		codes[29] = RUBIX_CUBE_MOVE_COUNT ;
+		ASSERT(!rubix_cube_apply_move_codes(&cubes[0],codes,30)) ;
+		ASSERT(!rubix_cube_unapply_move_codes(&cubes[0],codes,30)) ;
+		ASSERT(rubix_cube_equivelence_check(&cubes[0],&before)) ;
+	) ;
+
+	TEST_CASE(facelet_buffers,
+		static RubixCubeFacelets cubes[100] ;
+		RubixCubeSeed seeds[100] ;
+		RubixCubeMove moves[20] ;
+		unsigned char codes[100 * 20], results[100] ;
+		int same = 1 ;
+
+		for (size_t i = 0; i < 100; ++i) seeds[i] = 1000 + i ;
+		rubix_cube_generate_move_codes(codes,seeds,100,20) ;
+		rubix_cube_facelets_fill_solved(cubes,100) ;
+		ASSERT(rubix_cube_facelets_count_solved(cubes,100,NULL) == 100) ;
+
+		/* Row i is the scramble from seed i */
+		ASSERT(rubix_cube_facelets_apply_codes_rows(cubes,100,codes,20)) ;
+		for (size_t i = 0; i < 100; ++i) {
+			RubixCube cube = rubix_cube_generate_solved() ;
+			rubix_cube_generate_moves_from_seed(seeds[i],20,moves) ;
+			for (size_t j = 0; j < 20; ++j) rubix_cube_apply_move(&cube,&moves[j]) ;
+			RubixCubeFacelets expected = rubix_cube_facelets_from_cube(&cube) ;
+			same &= rubix_cube_facelets_equivelence_check(&cubes[i],&expected) ;
+		}
+		ASSERT(same) ;
+		ASSERT(rubix_cube_facelets_count_solved(cubes,100,results) == 0 && !results[0]) ;
+
+		/* One stream for every cube, here row 0, then undo everything */
+		RubixCubeFacelets first = cubes[0] ;
+		ASSERT(rubix_cube_facelets_apply_codes_all(cubes,100,codes,20)) ;
+		ASSERT(rubix_cube_facelets_unapply_codes_rows(cubes,1,codes,20)) ;
+		ASSERT(rubix_cube_facelets_equivelence_check(&cubes[0],&first)) ;
+		ASSERT(rubix_cube_facelets_unapply_codes_rows(cubes,1,codes,20)) ;
+		ASSERT(rubix_cube_facelets_count_solved(cubes,100,results) == 1 && results[0] && !results[1]) ;
+
+		codes[150] = 0xff ;
+		ASSERT(!rubix_cube_facelets_apply_codes_all(cubes,100,codes,200)) ;
+		ASSERT(!rubix_cube_facelets_apply_codes_rows(cubes,100,codes,20)) ;
+		ASSERT(rubix_cube_facelets_is_solved(&cubes[0])) ;
+	) ;
+) ;
+
+/* Number of pieces out of place after @text, -1 if it does not parse */
+static int notation_misplaced(const char * text) {
+	RubixCubeScramble * pScramble = rubix_cube_notation_parse(text,strlen(text),RUBIX_CUBE_NOTATION_EXTENDED,NULL) ;
+	RubixCubeTracked tracked = rubix_cube_tracked_generate_solved() ;
+
+	if (!pScramble) return -1 ;
+	rubix_cube_tracked_apply_scramble(&tracked,pScramble) ;
+	rubix_cube_scramble_free(pScramble) ;
+	return (int)tracked.misplaced ;
+}
+
+TEST_SET(notation,
+	TEST_CASE(format_parse_round_trip,
+		static char text[RUBIX_CUBE_NOTATION_FORMAT_SIZE(500)] ;
+		RubixCubeScramble parsed = { 0 } ;
+		int same = 1 ;
+
+		for (RubixCubeSeed seed = 1; seed <= 50; ++seed) {
+			RubixCubeScramble * pScramble = rubix_cube_scramble_allocate(seed,10 * seed) ;
+			size_t size = rubix_cube_notation_format(text,sizeof(text),pScramble->moves,pScramble->size,0) ;
+			same &= size > 0 && size <= RUBIX_CUBE_NOTATION_FORMAT_SIZE(pScramble->size) && !memchr(text,'\0',size) ;
+			same &= rubix_cube_notation_parse_into(&parsed,text,size,0,NULL) && parsed.size == pScramble->size ;
+			same &= !memcmp(parsed.moves,pScramble->moves,pScramble->size * sizeof(RubixCubeMove)) ;
+			rubix_cube_scramble_free(pScramble) ;
+		}
+		ASSERT(same) ;
+		free(parsed.moves) ;
+
+		RubixCubeMove moves[5] ;
+		ASSERT(rubix_cube_notation_parse_codes((unsigned char *)text,5,"R U R' U2 F'",12,0,NULL) == 5) ;
+		ASSERT(rubix_cube_moves_decode(moves,(unsigned char *)text,5)) ;
+		ASSERT(rubix_cube_notation_format(text,12,moves,5,0) == 12 && !memcmp(text,"R U R' U2 F'",12)) ;
+		ASSERT(rubix_cube_notation_format(text,12,moves,5,RUBIX_CUBE_NOTATION_INVERSE) == 12 && !memcmp(text,"F U2 R U' R'",12)) ;
+		ASSERT(!rubix_cube_notation_format(text,11,moves,5,0)) ;
+	) ;
+
+	TEST_CASE(tokens_and_errors,
+		RubixCubeNotationStatus status ;
+		unsigned char codes[16] ;
+
+		/* Spacing is optional, counts are taken mod 4 */
+		ASSERT(rubix_cube_notation_parse_codes(codes,16,"RUR'U'  D3\tB2' L10 F4",21,0,&status) == 7 && !status.error && status.offset == 21) ;
+		ASSERT(codes[4] == RUBIX_CUBE_MOVE_INDEX(RUBIX_CUBE_SQUARE_BOTTOM,RUBIX_CUBE_FACE_ROTATION_COUNTERCLOCKWISE)) ;
+		ASSERT(codes[5] == RUBIX_CUBE_MOVE_INDEX(RUBIX_CUBE_SQUARE_BACK,RUBIX_CUBE_FACE_ROTATION_DOUBLE)) ;
+		ASSERT(codes[6] == RUBIX_CUBE_MOVE_INDEX(RUBIX_CUBE_SQUARE_LEFT,RUBIX_CUBE_FACE_ROTATION_DOUBLE)) ;
+
+		ASSERT(!rubix_cube_notation_parse_codes(codes,16,"R U Q",5,0,&status) && status.offset == 4 && status.error) ;
+		ASSERT(!rubix_cube_notation_parse_codes(codes,16,"R 'U",4,0,&status) && status.offset == 2) ;
+		ASSERT(!rubix_cube_notation_parse_codes(codes,16,"R M",3,0,&status) && status.offset == 2) ;
+		ASSERT(!rubix_cube_notation_parse_codes(codes,16,"U Rw",4,0,&status) && status.offset == 2) ;
+		ASSERT(!rubix_cube_notation_parse_codes(codes,2,"R U F",5,0,&status) && status.offset == 4) ;
+		ASSERT(!rubix_cube_notation_parse(" R3x",4,0,&status) && status.offset == 3) ;
+	) ;
+
+	TEST_CASE(one_sequence_per_line,
+		const char text[] = "R U R' U'\r\n\nF2 B2\nL" ;
+		size_t expected[] = { 4, 0, 2, 1 }, offset = 0 ;
+		RubixCubeScramble scramble = { 0 } ;
+		RubixCubeNotationStatus status ;
+
+		for (size_t line = 0; line < 4; ++line) {
+			ASSERT(rubix_cube_notation_parse_into(&scramble,text + offset,sizeof(text) - 1 - offset,0,&status)) ;
+			ASSERT(scramble.size == expected[line]) ;
+			offset += status.offset ;
+		}
+		ASSERT(offset == sizeof(text) - 1) ;
+		free(scramble.moves) ;
+	) ;
+
+	TEST_CASE(wide_slice_and_rotations,
+		unsigned char codes[8] ;
+		char text[32] ;
+
+		/* PLLs only move the pieces they are known to */
+		ASSERT(notation_misplaced("M2 U M2 U2 M2 U M2") == 4) ;
+		ASSERT(notation_misplaced("M2 U M U2 M' U M2") == 3) ;
+		ASSERT(notation_misplaced("M M2 M E S2 S2 E'") == 0) ;
+		ASSERT(notation_misplaced("x y z z' y' x'") == 0) ;
+		ASSERT(notation_misplaced("r U r' R U' R' r' U' r") == notation_misplaced("L F L' R U' R' L' B' L")) ;
+
+		/* Face letters after a rotation turn the faces they now mean */
+		size_t count = rubix_cube_notation_parse_codes(codes,8,"x U y R z' Lw E",15,RUBIX_CUBE_NOTATION_EXTENDED,NULL) ;
+		ASSERT(count == 5) ;
+		ASSERT(rubix_cube_notation_format_codes(text,sizeof(text),codes,count,0) == 10 && !memcmp(text,"F U B L R'",10)) ;
+		ASSERT(!rubix_cube_notation_parse_codes(codes,8,"x U",3,0,NULL)) ;
+	) ;
+
+	TEST_CASE(rotate_face_strings,
+		RubixCube cube = rubix_cube_generate_solved(), expected = rubix_cube_generate_solved() ;
+
+		ASSERT(rubix_cube_rotate_face_strings(&cube,"R","'")) ;
+		ASSERT(rubix_cube_rotate_face_strings(&cube,"top","Double")) ;
+		ASSERT(!rubix_cube_rotate_face_strings(&cube,"middle","")) ;
+		ASSERT(!rubix_cube_rotate_face_strings(&cube,"F","3")) ;
+		rubix_cube_rotate_face(&expected,RUBIX_CUBE_SQUARE_RIGHT,RUBIX_CUBE_FACE_ROTATION_COUNTERCLOCKWISE) ;
+		rubix_cube_rotate_face(&expected,RUBIX_CUBE_SQUARE_TOP,RUBIX_CUBE_FACE_ROTATION_DOUBLE) ;
+		ASSERT(rubix_cube_equivelence_check(&cube,&expected)) ;
+	) ;
+) ;
+
+/* Checks that hold for cubes of every size, as a function per size */
+#define NXN_CHECK(n) \
+static int nxn_check_##n(void) { \
+	RubixCube##n##x##n cube = rubix_cube_##n##x##n##_generate_solved(), other ; \
+	RubixCubeRandom random = rubix_cube_random_generate(n) ; \
+	RubixCubeNxNMove moves[200] ; \
+	int ok = sizeof(cube) == RUBIX_CUBE_NXN_FACELET_COUNT(n) && rubix_cube_##n##x##n##_is_solved(&cube) ; \
+	\
+	/* Turning every layer of the right side is a rotation of the whole cube, the front comes up */ \
+	rubix_cube_##n##x##n##_rotate_wide(&cube,RUBIX_CUBE_SQUARE_RIGHT,n,RUBIX_CUBE_FACE_ROTATION_CLOCKWISE) ; \
+	for (size_t i = 0; i < n * n; ++i) ok &= cube.facelets[i] == RUBIX_CUBE_COLOR_RED ; \
+	rubix_cube_##n##x##n##_rotate_wide(&cube,RUBIX_CUBE_SQUARE_LEFT,n,RUBIX_CUBE_FACE_ROTATION_CLOCKWISE) ; \
+	ok &= rubix_cube_##n##x##n##_is_solved(&cube) ; \
+	\
+	/* A layer seen from the other side turns the other way */ \
+	for (size_t side = 0; side < RUBIX_CUBE_SIDE_COUNT; ++side) { \
+		for (unsigned layer = 0; layer < n; ++layer) { \
+			cube = rubix_cube_##n##x##n##_generate_solved() ; \
+			rubix_cube_##n##x##n##_rotate_layer(&cube,RUBIX_CUBE_SQUARE_FRONT,n / 2,RUBIX_CUBE_FACE_ROTATION_CLOCKWISE) ; \
+			other = cube ; \
+			rubix_cube_##n##x##n##_rotate_layer(&cube,side,layer,RUBIX_CUBE_FACE_ROTATION_CLOCKWISE) ; \
+			rubix_cube_##n##x##n##_rotate_layer(&other,RUBIX_CUBE_SQUARE_OPPOSITE(side),n - 1 - layer,RUBIX_CUBE_FACE_ROTATION_COUNTERCLOCKWISE) ; \
+			ok &= !memcmp(&cube,&other,sizeof(cube)) ; \
+			rubix_cube_##n##x##n##_rotate_layer(&cube,side,layer,RUBIX_CUBE_FACE_ROTATION_DOUBLE) ; \
+			rubix_cube_##n##x##n##_rotate_layer(&cube,side,layer,RUBIX_CUBE_FACE_ROTATION_CLOCKWISE) ; \
+			rubix_cube_##n##x##n##_rotate_layer(&cube,RUBIX_CUBE_SQUARE_FRONT,n / 2,RUBIX_CUBE_FACE_ROTATION_COUNTERCLOCKWISE) ; \
+			ok &= rubix_cube_##n##x##n##_is_solved(&cube) ; \
+		} \
+	} \
+	\
+	for (size_t i = 0; i < 200; ++i) { \
+		unsigned long long value = rubix_cube_random_next(&random) ; \
+		moves[i] = (RubixCubeNxNMove){ (RubixCubeSide)(value % 6), (unsigned)((value >> 8) % n), (RubixCubeFaceRotation)((value >> 16) % 3) } ; \
+	} \
+	cube = rubix_cube_##n##x##n##_generate_solved() ; \
+	rubix_cube_##n##x##n##_apply_moves(&cube,moves,200) ; \
+	ok &= !rubix_cube_##n##x##n##_is_solved(&cube) ; \
+	/* Colors are only moved around, never lost */ \
+	size_t counts[RUBIX_CUBE_SIDE_COUNT + 1] = { 0 } ; \
+	for (size_t i = 0; i < sizeof(cube); ++i) ++counts[cube.facelets[i]] ; \
+	for (size_t color = 1; color <= RUBIX_CUBE_SIDE_COUNT; ++color) ok &= counts[color] == n * n ; \
+	rubix_cube_##n##x##n##_unapply_moves(&cube,moves,200) ; \
+	ok &= rubix_cube_##n##x##n##_is_solved(&cube) ; \
+	return ok ; \
+}
+
+NXN_CHECK(2)
+NXN_CHECK(3)
+NXN_CHECK(4)
+NXN_CHECK(5)
+NXN_CHECK(6)
+NXN_CHECK(7)
+
+TEST_SET(nxn,
+	TEST_CASE(same_as_facelets,
+		RubixCubeMove moves[100] ;
+		int same = 1 ;
+
+		for (size_t code = 0; code < RUBIX_CUBE_MOVE_COUNT; ++code) {
+			RubixCubeFacelets facelets = rubix_cube_facelets_generate_solved() ;
+			RubixCube3x3 cube = rubix_cube_3x3_generate_solved() ;
+			ASSERT(!memcmp(cube.facelets,facelets.facelets,sizeof(cube))) ;
+			rubix_cube_generate_moves_from_seed(code + 1,100,moves) ;
+			for (size_t i = 0; i < 100; ++i) {
+				rubix_cube_facelets_apply_move(&facelets,&moves[i]) ;
+				rubix_cube_3x3_rotate_layer(&cube,moves[i].side,0,moves[i].rotation) ;
+				same &= !memcmp(cube.facelets,facelets.facelets,sizeof(cube)) ;
+			}
+		}
+		ASSERT(same) ;
+
+		/* The middle layer of the right side is M' */
+		RubixCube3x3 slice = rubix_cube_3x3_generate_solved() ;
+		rubix_cube_3x3_rotate_layer(&slice,RUBIX_CUBE_SQUARE_RIGHT,1,RUBIX_CUBE_FACE_ROTATION_CLOCKWISE) ;
+		ASSERT(slice.facelets[RUBIX_CUBE_NXN_FACELET_INDEX(3,RUBIX_CUBE_SQUARE_TOP,0,1)] == RUBIX_CUBE_COLOR_RED) ;
+		ASSERT(slice.facelets[RUBIX_CUBE_NXN_FACELET_INDEX(3,RUBIX_CUBE_SQUARE_TOP,0,0)] == RUBIX_CUBE_COLOR_WHITE) ;
+		ASSERT(slice.facelets[RUBIX_CUBE_NXN_FACELET_INDEX(3,RUBIX_CUBE_SQUARE_FRONT,1,1)] == RUBIX_CUBE_COLOR_YELLOW) ;
+	) ;
+
+	TEST_CASE(every_size,
+		ASSERT(nxn_check_2()) ;
+		ASSERT(nxn_check_3()) ;
+		ASSERT(nxn_check_4()) ;
+		ASSERT(nxn_check_5()) ;
+		ASSERT(nxn_check_6()) ;
+		ASSERT(nxn_check_7()) ;
+	) ;
+
+	TEST_CASE(out_of_range,
+		RubixCube4x4 cube = rubix_cube_4x4_generate_solved() ;
+		rubix_cube_4x4_rotate_layer(&cube,RUBIX_CUBE_SIDE_COUNT,0,RUBIX_CUBE_FACE_ROTATION_CLOCKWISE) ;
+		rubix_cube_4x4_rotate_layer(&cube,RUBIX_CUBE_SQUARE_TOP,4,RUBIX_CUBE_FACE_ROTATION_CLOCKWISE) ;
+		ASSERT(rubix_cube_4x4_is_solved(&cube)) ;
+	) ;
+) ;
+
+TEST_SET(pool,
+	TEST_CASE(cubes,
+		RubixCubePool * pPool = rubix_cube_pool_allocate(0) ;
+		ASSERT(pPool) ;
+
+		RubixCube * a = rubix_cube_pool_cube_solved(pPool) ;
+		RubixCube * b = rubix_cube_pool_cube_scrambled(pPool,1234) ;
+		RubixCube scrambled = rubix_cube_generate_scrambled(1234) ;
+		ASSERT(a && b && a != b) ;
+		ASSERT(rubix_cube_is_solved(a)) ;
+		ASSERT(rubix_cube_equivelence_check(b,&scrambled)) ;
+		ASSERT((uintptr_t)a % RUBIX_CUBE_POOL_ALIGNMENT == 0) ;
+		ASSERT((uintptr_t)b % RUBIX_CUBE_POOL_ALIGNMENT == 0) ;
+
+		/* A released cube is the next one handed out, solved again */
+		rubix_cube_pool_cube_release(pPool,b) ;
+		RubixCube * c = rubix_cube_pool_cube_solved(pPool) ;
+		ASSERT(c == b) ;
+		ASSERT(rubix_cube_is_solved(c)) ;
+		ASSERT(pPool->slab_count == 1) ;
+
+		RubixCube * array = rubix_cube_pool_cubes(pPool,100) ;
+		ASSERT(array) ;
+		ASSERT((uintptr_t)array % RUBIX_CUBE_POOL_ALIGNMENT == 0) ;
+		ASSERT(rubix_cube_count_solved(array,100,NULL) == 100) ;
+
+		RubixCubeFacelets * facelets = rubix_cube_pool_facelets(pPool,64) ;
+		ASSERT(facelets) ;
+		ASSERT(rubix_cube_facelets_count_solved(facelets,64,NULL) == 64) ;
+		rubix_cube_pool_free(pPool) ;
+	) ;
+
+	TEST_CASE(scrambles,
+		RubixCubePool * pPool = rubix_cube_pool_allocate(0) ;
+		RubixCubeScramble * pExpected = rubix_cube_scramble_allocate(99,RUBIX_CUBE_SCRAMBLE_INTENSITY) ;
+		RubixCubeScramble * pScramble = rubix_cube_pool_scramble(pPool,99,RUBIX_CUBE_SCRAMBLE_INTENSITY) ;
+
+		ASSERT(pScramble && pExpected) ;
+		ASSERT(pScramble->size == pExpected->size) ;
+		ASSERT(pScramble->seed == 99) ;
+		ASSERT(!memcmp(pScramble->moves,pExpected->moves,sizeof(RubixCubeMove) * pExpected->size)) ;
+		ASSERT((char *)pScramble->moves > (char *)pScramble) ;
+
+		/* Reused by anything that fits, and not by what does not */
+		rubix_cube_pool_scramble_release(pPool,pScramble) ;
+		RubixCubeScramble * pLarger = rubix_cube_pool_scramble(pPool,7,RUBIX_CUBE_SCRAMBLE_INTENSITY * 2) ;
+		RubixCubeScramble * pSmaller = rubix_cube_pool_scramble(pPool,7,10) ;
+		ASSERT(pLarger != pScramble) ;
+		ASSERT(pSmaller == pScramble) ;
+		ASSERT(pSmaller->size == 10 && pSmaller->capacity == RUBIX_CUBE_SCRAMBLE_INTENSITY) ;
+		ASSERT(!memcmp(pSmaller->moves,pLarger->moves,sizeof(RubixCubeMove) * 10)) ;
+
+		rubix_cube_scramble_free(pExpected) ;
+		rubix_cube_pool_free(pPool) ;
+	) ;
+
+	TEST_CASE(slabs_and_reset,
+		RubixCubePool * pPool = rubix_cube_pool_allocate(4096) ;
+		RubixCube * first = rubix_cube_pool_cube_solved(pPool) ;
+
+		/* Five cubes, each padded to a cache line, fill the first slab and the sixth needs a second one */
+		for (size_t i = 1; i < 6; ++i) ASSERT(rubix_cube_pool_cube_solved(pPool)) ;
+		ASSERT(pPool->slab_count == 2) ;
+
+		/* Bigger than a slab, in one of its own, and the second slab is still used after it */
+		RubixCube * array = rubix_cube_pool_cubes(pPool,20) ;
+		ASSERT(array && pPool->slab_count == 3) ;
+		ASSERT(rubix_cube_count_solved(array,20,NULL) == 20) ;
+		ASSERT(rubix_cube_pool_cube_solved(pPool) && pPool->slab_count == 3) ;
+
+		rubix_cube_pool_reset(pPool) ;
+		ASSERT(pPool->bytes_used == 0) ;
+		ASSERT(rubix_cube_pool_cube_solved(pPool) == first) ;
+		/* All three slabs are used again, 5 + 18 + 5 cubes, before a fourth one is needed */
+		for (size_t i = 1; i < 28; ++i) ASSERT(rubix_cube_pool_cube_solved(pPool)) ;
+		ASSERT(pPool->slab_count == 3) ;
+		ASSERT(rubix_cube_pool_cube_solved(pPool) && pPool->slab_count == 4) ;
+
+		ASSERT(!rubix_cube_pool_carve(pPool,16,3)) ;
+		ASSERT(!rubix_cube_pool_cubes(pPool,SIZE_MAX / 2)) ;
+		rubix_cube_pool_free(pPool) ;
+	) ;
+) ;
+
+TEST_SET(journal,
+	TEST_CASE(const_unapply,
+		RubixCubeScramble * pScramble = rubix_cube_scramble_allocate(11,RUBIX_CUBE_SCRAMBLE_INTENSITY) ;
+		RubixCubeMove saved[RUBIX_CUBE_SCRAMBLE_INTENSITY] ;
+		RubixCube cube = rubix_cube_generate_solved() ;
+
+		memcpy(saved,pScramble->moves,sizeof(saved)) ;
+		rubix_cube_apply_scramble(&cube,pScramble) ;
+		rubix_cube_unapply_scramble(&cube,pScramble) ;
+		ASSERT(rubix_cube_is_solved(&cube)) ;
+		ASSERT(!memcmp(saved,pScramble->moves,sizeof(saved))) ;
+
+		/* Undone twice over it is the inverse twice, not back and forth */
+		rubix_cube_unapply_scramble(&cube,pScramble) ;
+		rubix_cube_apply_scramble(&cube,pScramble) ;
+		ASSERT(rubix_cube_is_solved(&cube)) ;
+
+		RubixCubeMove move = { RUBIX_CUBE_SQUARE_LEFT, RUBIX_CUBE_FACE_ROTATION_CLOCKWISE } ;
+		RubixCubeMove inverse = rubix_cube_move_inverse(&move) ;
+		ASSERT(inverse.side == RUBIX_CUBE_SQUARE_LEFT && inverse.rotation == RUBIX_CUBE_FACE_ROTATION_COUNTERCLOCKWISE) ;
+		move.rotation = RUBIX_CUBE_FACE_ROTATION_DOUBLE ;
+		ASSERT(rubix_cube_move_inverse(&move).rotation == RUBIX_CUBE_FACE_ROTATION_DOUBLE) ;
+		rubix_cube_scramble_free(pScramble) ;
+	) ;
+
+	TEST_CASE(rewind_anywhere,
+		RubixCube cube = rubix_cube_generate_solved() ;
+		RubixCube * states = (RubixCube *)malloc(sizeof(RubixCube) * 1001) ;
+		RubixCubeJournal * pJournal = rubix_cube_journal_allocate(&cube,250,16) ;
+		RubixCubeRandom random = rubix_cube_random_generate(17) ;
+		int same = 1 ;
+
+		ASSERT(pJournal && states) ;
+		ASSERT(pJournal->capacity == 256) ;
+		states[0] = cube ;
+		for (size_t i = 1; i <= 1000; ++i) {
+			RubixCubeMove move = rubix_cube_generate_random_move_r(&random) ;
+			rubix_cube_journal_apply_move(pJournal,&move) ;
+			states[i] = cube ;
+		}
+		ASSERT(rubix_cube_journal_position(pJournal) == 1000) ;
+		ASSERT(rubix_cube_journal_oldest(pJournal) % 16 == 0) ;
+		ASSERT(rubix_cube_journal_oldest(pJournal) >= 1000 - 256) ;
+		ASSERT(rubix_cube_journal_oldest(pJournal) < 1000 - 256 + 16) ;
+
+		/* Down from the end by odd steps, then back up by replaying what was recorded */
+		for (size_t p = 1000; p >= rubix_cube_journal_oldest(pJournal) + 7; p -= 7) {
+			same &= rubix_cube_journal_rewind(pJournal,p) ;
+			same &= rubix_cube_equivelence_check(&cube,&states[p]) ;
+		}
+		ASSERT(same) ;
+		ASSERT(!rubix_cube_journal_rewind(pJournal,rubix_cube_journal_oldest(pJournal) - 1)) ;
+		ASSERT(!rubix_cube_journal_rewind(pJournal,rubix_cube_journal_position(pJournal) + 1)) ;
+
+		/* Only what is before the current position can be read back */
+		size_t oldest = rubix_cube_journal_oldest(pJournal), position = rubix_cube_journal_position(pJournal) ;
+		unsigned char codes[256] ;
+		ASSERT(rubix_cube_journal_read_codes(pJournal,oldest,codes,position - oldest)) ;
+		ASSERT(!rubix_cube_journal_read_codes(pJournal,oldest,codes,position - oldest + 1)) ;
+		ASSERT(!rubix_cube_journal_read_codes(pJournal,oldest - 1,codes,1)) ;
+		rubix_cube_journal_rewind(pJournal,rubix_cube_journal_oldest(pJournal)) ;
+		ASSERT(rubix_cube_equivelence_check(&cube,&states[rubix_cube_journal_oldest(pJournal)])) ;
+		ASSERT(rubix_cube_journal_undo(pJournal,0)) ;
+		ASSERT(!rubix_cube_journal_undo(pJournal,1)) ;
+
+		free(states) ;
+		rubix_cube_journal_free(pJournal) ;
+	) ;
+
+	TEST_CASE(branches_and_codes,
+		RubixCube cube = rubix_cube_generate_solved() ;
+		RubixCubeJournal * pJournal = rubix_cube_journal_allocate(&cube,0,0) ;
+		RubixCubeScramble * pScramble = rubix_cube_scramble_allocate(5,RUBIX_CUBE_SCRAMBLE_INTENSITY) ;
+		unsigned char codes[RUBIX_CUBE_SCRAMBLE_INTENSITY], recorded[RUBIX_CUBE_SCRAMBLE_INTENSITY] ;
+
+		rubix_cube_moves_encode(codes,pScramble->moves,pScramble->size) ;
+		rubix_cube_journal_apply_scramble(pJournal,pScramble) ;
+		ASSERT(rubix_cube_journal_read_codes(pJournal,0,recorded,pScramble->size)) ;
+		ASSERT(!memcmp(codes,recorded,pScramble->size)) ;
+		rubix_cube_journal_unapply_scramble(pJournal,pScramble) ;
+		ASSERT(rubix_cube_is_solved(&cube)) ;
+		ASSERT(rubix_cube_journal_position(pJournal) == 2 * pScramble->size) ;
+
+		/* A new branch from the middle writes over what came after it */
+		RubixCube expected = rubix_cube_generate_solved() ;
+		rubix_cube_apply_move_codes(&expected,codes,10) ;
+		ASSERT(rubix_cube_journal_rewind(pJournal,10)) ;
+		ASSERT(rubix_cube_equivelence_check(&cube,&expected)) ;
+		ASSERT(rubix_cube_journal_apply_codes(pJournal,codes + 10,40)) ;
+		ASSERT(rubix_cube_journal_unapply_codes(pJournal,codes,50)) ;
+		ASSERT(rubix_cube_is_solved(&cube)) ;
+		ASSERT(rubix_cube_journal_position(pJournal) == 100) ;
+		ASSERT(rubix_cube_journal_undo(pJournal,60)) ;
+		rubix_cube_apply_move_codes(&expected,codes + 10,30) ;
+		ASSERT(rubix_cube_equivelence_check(&cube,&expected)) ;
+		codes[3] = RUBIX_CUBE_MOVE_COUNT ;
+		ASSERT(!rubix_cube_journal_apply_codes(pJournal,codes,50)) ;
+		ASSERT(rubix_cube_journal_position(pJournal) == 40) ;
+
+		rubix_cube_journal_restart(pJournal) ;
+		ASSERT(rubix_cube_journal_position(pJournal) == 0) ;
+		ASSERT(rubix_cube_journal_rewind(pJournal,0)) ;
+		ASSERT(!rubix_cube_is_solved(&cube)) ;
+
+		rubix_cube_scramble_free(pScramble) ;
+		rubix_cube_journal_free(pJournal) ;
+	) ;
+) ;
+
+/* Number of classes among the cubes one move from solved, under the first @count symmetries */
+static size_t symmetry_classes_one_move_out(size_t count) {
+	RubixCubeFacelets canonical[RUBIX_CUBE_MOVE_COUNT] ;
+	size_t classes = 0 ;
+
+	for (size_t code = 0; code < RUBIX_CUBE_MOVE_COUNT; ++code) {
+		RubixCubeFacelets cube = rubix_cube_facelets_generate_solved() ;
+		rubix_cube_facelets_rotate_face(&cube,code / RUBIX_CUBE_FACE_ROTATION_COUNT,code % RUBIX_CUBE_FACE_ROTATION_COUNT) ;
+		rubix_cube_symmetry_canonicalize(&canonical[classes],&cube,count) ;
+
+		size_t i ;
+		for (i = 0; i < classes && !rubix_cube_facelets_equivelence_check(&canonical[i],&canonical[classes]); ++i) ;
+		classes += i == classes ;
+	}
+	return classes ;
+}
+
+TEST_SET(symmetry,
+	TEST_CASE(group,
+		RubixCubeFacelets scrambled = rubix_cube_facelets_generate_solved(), solved = scrambled ;
+		RubixCubeScramble * pScramble = rubix_cube_scramble_allocate(21,RUBIX_CUBE_SCRAMBLE_INTENSITY) ;
+		int closed = 1 ;
+
+		rubix_cube_facelets_apply_scramble(&scrambled,pScramble) ;
+		for (size_t a = 0; a < RUBIX_CUBE_SYMMETRY_COUNT; ++a) {
+			RubixCubeFacelets once, twice, composed ;
+			rubix_cube_symmetry_apply(&once,&solved,a) ;
+			closed &= rubix_cube_facelets_is_solved(&once) ;
+			closed &= rubix_cube_symmetry_compose(a,rubix_cube_symmetry_inverse(a)) == 0 ;
+			closed &= !RUBIX_CUBE_SYMMETRY_IS_REFLECTION(rubix_cube_symmetry_compose(a,a)) ;
+			rubix_cube_symmetry_apply(&once,&scrambled,a) ;
+			for (size_t b = 0; b < RUBIX_CUBE_SYMMETRY_COUNT; ++b) {
+				rubix_cube_symmetry_apply(&twice,&once,b) ;
+				rubix_cube_symmetry_apply(&composed,&scrambled,rubix_cube_symmetry_compose(a,b)) ;
+				closed &= rubix_cube_facelets_equivelence_check(&twice,&composed) ;
+			}
+		}
+		ASSERT(closed) ;
+		ASSERT(rubix_cube_symmetry_stabilizer(&solved,RUBIX_CUBE_SYMMETRY_COUNT) == RUBIX_CUBE_SYMMETRY_COUNT) ;
+		ASSERT(rubix_cube_symmetry_stabilizer(&scrambled,RUBIX_CUBE_SYMMETRY_COUNT) == 1) ;
+		rubix_cube_scramble_free(pScramble) ;
+	) ;
+
+	TEST_CASE(moves,
+		RubixCubeFacelets cube = rubix_cube_facelets_generate_solved() ;
+		RubixCubeScramble * pScramble = rubix_cube_scramble_allocate(22,RUBIX_CUBE_SCRAMBLE_INTENSITY) ;
+		int conjugate = 1 ;
+
+		rubix_cube_facelets_apply_scramble(&cube,pScramble) ;
+		for (size_t s = 0; s < RUBIX_CUBE_SYMMETRY_COUNT; ++s) {
+			for (size_t code = 0; code < RUBIX_CUBE_MOVE_COUNT; ++code) {
+				unsigned char image = rubix_cube_symmetry_move(s,code) ;
+				RubixCubeFacelets moved_first = cube, moved_after ;
+
+				rubix_cube_facelets_rotate_face(&moved_first,code / RUBIX_CUBE_FACE_ROTATION_COUNT,code % RUBIX_CUBE_FACE_ROTATION_COUNT) ;
+				rubix_cube_symmetry_apply(&moved_first,&moved_first,s) ;
+				rubix_cube_symmetry_apply(&moved_after,&cube,s) ;
+				rubix_cube_facelets_rotate_face(&moved_after,image / RUBIX_CUBE_FACE_ROTATION_COUNT,image % RUBIX_CUBE_FACE_ROTATION_COUNT) ;
+				conjugate &= rubix_cube_facelets_equivelence_check(&moved_first,&moved_after) ;
+
+				/* Mirrors turn quarter turns the other way, half turns stay half turns */
+				size_t rotation = code % RUBIX_CUBE_FACE_ROTATION_COUNT, image_rotation = image % RUBIX_CUBE_FACE_ROTATION_COUNT ;
+				if (rotation == RUBIX_CUBE_FACE_ROTATION_DOUBLE || !RUBIX_CUBE_SYMMETRY_IS_REFLECTION(s)) conjugate &= image_rotation == rotation ;
+				else conjugate &= image_rotation != rotation && image_rotation != RUBIX_CUBE_FACE_ROTATION_DOUBLE ;
+			}
+		}
+		ASSERT(conjugate) ;
+		rubix_cube_scramble_free(pScramble) ;
+	) ;
+
+	TEST_CASE(canonicalize,
+		RubixCubeFacelets cube = rubix_cube_facelets_generate_solved(), canonical, moved, again ;
+		RubixCubeScramble * pScramble = rubix_cube_scramble_allocate(23,RUBIX_CUBE_SCRAMBLE_INTENSITY) ;
+		int same = 1 ;
+
+		rubix_cube_facelets_apply_scramble(&cube,pScramble) ;
+		RubixCubeSymmetry used = rubix_cube_symmetry_canonicalize(&canonical,&cube,RUBIX_CUBE_SYMMETRY_COUNT) ;
+		rubix_cube_symmetry_apply(&moved,&cube,used) ;
+		ASSERT(rubix_cube_facelets_equivelence_check(&moved,&canonical)) ;
+		ASSERT(memcmp(canonical.facelets,cube.facelets,RUBIX_CUBE_FACELET_COUNT) <= 0) ;
+
+		/* Every one of the 48 lands on the same canonical form, and the symmetry returned gets there */
+		for (size_t s = 0; s < RUBIX_CUBE_SYMMETRY_COUNT; ++s) {
+			rubix_cube_symmetry_apply(&moved,&cube,s) ;
+			used = rubix_cube_symmetry_canonicalize(&again,&moved,RUBIX_CUBE_SYMMETRY_COUNT) ;
+			same &= rubix_cube_facelets_equivelence_check(&again,&canonical) ;
+			rubix_cube_symmetry_apply(&moved,&moved,used) ;
+			same &= rubix_cube_facelets_equivelence_check(&moved,&canonical) ;
+		}
+		ASSERT(same) ;
+
+		/* Mirror images only meet when reflections are allowed */
+		rubix_cube_symmetry_apply(&moved,&cube,RUBIX_CUBE_SYMMETRY_ROTATIONS) ;
+		rubix_cube_symmetry_canonicalize(&canonical,&cube,RUBIX_CUBE_SYMMETRY_ROTATIONS) ;
+		rubix_cube_symmetry_canonicalize(&again,&moved,RUBIX_CUBE_SYMMETRY_ROTATIONS) ;
+		ASSERT(!rubix_cube_facelets_equivelence_check(&again,&canonical)) ;
+
+		/* One move out there are quarter and half turns, and without mirrors clockwise and counterclockwise ones */
+		ASSERT(symmetry_classes_one_move_out(RUBIX_CUBE_SYMMETRY_COUNT) == 2) ;
+		ASSERT(symmetry_classes_one_move_out(RUBIX_CUBE_SYMMETRY_ROTATIONS) == 3) ;
+		ASSERT(symmetry_classes_one_move_out(1) == RUBIX_CUBE_MOVE_COUNT) ;
+
+		RubixCube plane = rubix_cube_generate_scrambled(23), plane_canonical ;
+		rubix_cube_symmetry_canonicalize_cube(&plane_canonical,&plane,RUBIX_CUBE_SYMMETRY_COUNT) ;
+		moved = rubix_cube_facelets_from_cube(&plane_canonical) ;
+		rubix_cube_symmetry_canonicalize(&canonical,&cube,RUBIX_CUBE_SYMMETRY_COUNT) ;
+		ASSERT(rubix_cube_facelets_equivelence_check(&moved,&canonical)) ;
+		rubix_cube_scramble_free(pScramble) ;
+	) ;
+) ;
+
+/* The cube @text makes as turn codes, recentered, and as the face turns rubix_cube_notation_parse() emulates them with */
+static int turn_matches_notation(const char * text, size_t length) {
+	unsigned char turns[64], moves[128] ;
+	size_t turn_count = rubix_cube_notation_parse_codes(turns,sizeof(turns),text,length,RUBIX_CUBE_NOTATION_TURNS,NULL) ;
+	size_t move_count = rubix_cube_notation_parse_codes(moves,sizeof(moves),text,length,RUBIX_CUBE_NOTATION_EXTENDED,NULL) ;
+	RubixCube native = rubix_cube_generate_solved(), emulated = rubix_cube_generate_solved() ;
+	RubixCubeFrame frame = rubix_cube_frame_identity ;
+
+	if (!turn_count || !rubix_cube_apply_turn_codes(&native,&frame,turns,turn_count)) return 0 ;
+	rubix_cube_recenter(&native,&frame) ;
+	rubix_cube_apply_move_codes(&emulated,moves,move_count) ;
+	return rubix_cube_equivelence_check(&native,&emulated) ;
+}
+
+TEST_SET(turn,
+	TEST_CASE(slices,
+		static const unsigned char sides[RUBIX_CUBE_SLICE_COUNT] = {
+			RUBIX_CUBE_SQUARE_LEFT, RUBIX_CUBE_SQUARE_BOTTOM, RUBIX_CUBE_SQUARE_FRONT
+		} ;
+		int same = 1 ;
+
+		for (size_t slice = 0; slice < RUBIX_CUBE_SLICE_COUNT; ++slice) {
+			for (size_t rotation = 0; rotation < RUBIX_CUBE_FACE_ROTATION_COUNT; ++rotation) {
+				RubixCube cube = rubix_cube_generate_scrambled(slice * 3 + rotation + 1) ;
+				RubixCubeFacelets facelets = rubix_cube_facelets_from_cube(&cube) ;
+				RubixCube3x3 layered ;
+
+				memcpy(layered.facelets,facelets.facelets,sizeof(layered.facelets)) ;
+				rubix_cube_rotate_slice(&cube,slice,rotation) ;
+				rubix_cube_3x3_rotate_layer(&layered,sides[slice],1,rotation) ;
+				facelets = rubix_cube_facelets_from_cube(&cube) ;
+				same &= !memcmp(layered.facelets,facelets.facelets,sizeof(layered.facelets)) ;
+			}
+		}
+		ASSERT(same) ;
+	) ;
+
+	TEST_CASE(rotations,
+		RubixCube cube = rubix_cube_generate_scrambled(31), scrambled = cube ;
+		RubixCubeFrame frame = rubix_cube_frame_identity ;
+		const unsigned char x = RUBIX_CUBE_TURN_ROTATION(RUBIX_CUBE_AXIS_X,RUBIX_CUBE_FACE_ROTATION_CLOCKWISE) ;
+		const unsigned char u = RUBIX_CUBE_TURN_FACE(RUBIX_CUBE_SQUARE_TOP,RUBIX_CUBE_FACE_ROTATION_CLOCKWISE) ;
+
+		/* A rotation moves nothing, but the face letters after it turn other sides */
+		ASSERT(rubix_cube_apply_turn(&cube,&frame,x) && rubix_cube_equivelence_check(&cube,&scrambled)) ;
+		ASSERT(frame.sides[RUBIX_CUBE_SQUARE_TOP] == RUBIX_CUBE_SQUARE_FRONT) ;
+		rubix_cube_apply_turn(&cube,&frame,u) ;
+		rubix_cube_rotate_face(&scrambled,RUBIX_CUBE_SQUARE_FRONT,RUBIX_CUBE_FACE_ROTATION_CLOCKWISE) ;
+		ASSERT(rubix_cube_equivelence_check(&cube,&scrambled)) ;
+		ASSERT(!rubix_cube_apply_turn(&cube,&frame,RUBIX_CUBE_TURN_COUNT)) ;
+
+		/* Turned for real the solved cube is not solved, until its centers are back home */
+		cube = rubix_cube_generate_solved() ;
+		rubix_cube_rotate_cube(&cube,RUBIX_CUBE_AXIS_Z,RUBIX_CUBE_FACE_ROTATION_CLOCKWISE) ;
+		rubix_cube_rotate_cube(&cube,RUBIX_CUBE_AXIS_Y,RUBIX_CUBE_FACE_ROTATION_DOUBLE) ;
+		ASSERT(!rubix_cube_is_solved(&cube)) ;
+		rubix_cube_recenter(&cube,NULL) ;
+		ASSERT(rubix_cube_is_solved(&cube)) ;
+	) ;
+
+	TEST_CASE(notation,
+		static const char * const texts[] = {
+			"M", "E'", "S2", "r U r'", "x U", "Lw E2 z' b", "M' U M U2 M' U M", "y x2 Rw U' S z M2 d' f2 E",
+			"x2 y r U R' U' M U r' R U R' U' R' F R2 U' R' U' R U R' F'"
+		} ;
+		unsigned char codes[8], random[24] ;
+		char text[RUBIX_CUBE_NOTATION_FORMAT_SIZE(24)] ;
+		RubixCube cube = rubix_cube_generate_scrambled(32), scrambled = cube ;
+		RubixCubeFrame frame = rubix_cube_frame_identity ;
+		size_t length ;
+		int same = 1 ;
+
+		ASSERT(rubix_cube_notation_parse_codes(codes,8,"M r' x2 U",9,RUBIX_CUBE_NOTATION_TURNS,NULL) == 4) ;
+		ASSERT(codes[0] == RUBIX_CUBE_TURN_SLICE(RUBIX_CUBE_SLICE_M,RUBIX_CUBE_FACE_ROTATION_CLOCKWISE)) ;
+		ASSERT(codes[1] == RUBIX_CUBE_TURN_WIDE(RUBIX_CUBE_SQUARE_RIGHT,RUBIX_CUBE_FACE_ROTATION_COUNTERCLOCKWISE)) ;
+		ASSERT(codes[2] == RUBIX_CUBE_TURN_ROTATION(RUBIX_CUBE_AXIS_X,RUBIX_CUBE_FACE_ROTATION_DOUBLE)) ;
+		ASSERT(codes[3] == RUBIX_CUBE_TURN_FACE(RUBIX_CUBE_SQUARE_TOP,RUBIX_CUBE_FACE_ROTATION_CLOCKWISE)) ;
+		for (size_t i = 0; i < sizeof(texts) / sizeof(*texts); ++i) same &= turn_matches_notation(texts[i],strlen(texts[i])) ;
+		ASSERT(same) ;
+
+		/* Random ones go through the formatter, and back out with unapply */
+		srand(33) ;
+		for (size_t round = 0; round < 64; ++round) {
+			for (size_t i = 0; i < 24; ++i) random[i] = (unsigned char)(rand() % RUBIX_CUBE_TURN_COUNT) ;
+			length = rubix_cube_notation_format_codes(text,sizeof(text),random,24,RUBIX_CUBE_NOTATION_TURNS) ;
+			same &= length && turn_matches_notation(text,length) ;
+			same &= rubix_cube_apply_turn_codes(&cube,&frame,random,24) ;
+			same &= rubix_cube_unapply_turn_codes(&cube,&frame,random,24) ;
+			same &= rubix_cube_equivelence_check(&cube,&scrambled) && !memcmp(&frame,&rubix_cube_frame_identity,sizeof(frame)) ;
+		}
+		ASSERT(same) ;
+		codes[0] = RUBIX_CUBE_TURN_SLICE(RUBIX_CUBE_SLICE_E,RUBIX_CUBE_FACE_ROTATION_CLOCKWISE) ;
+		ASSERT(!rubix_cube_notation_format_codes(text,sizeof(text),codes,1,0)) ;
+		ASSERT(rubix_cube_notation_format_codes(text,sizeof(text),codes,1,RUBIX_CUBE_NOTATION_TURNS) == 1 && text[0] == 'E') ;
+	) ;
+
+	TEST_CASE(sequences_match_single_turns,
+		unsigned char codes[32] ;
+		int same = 1 ;
+
+		/* The sequence loops go by tables per frame, from any frame they have to agree with one turn at a time */
+		srand(34) ;
+		for (size_t round = 0; round < 48; ++round) {
+			RubixCube cube = rubix_cube_generate_scrambled(round + 40), single = cube ;
+			RubixCubeFrame frame = rubix_cube_frame_identity, single_frame ;
+
+			for (size_t i = 0; i < 32; ++i) codes[i] = (unsigned char)(rand() % RUBIX_CUBE_TURN_COUNT) ;
+			for (size_t i = 0; i < round / 2; ++i) {
+				rubix_cube_frame_rotate(&frame,(RubixCubeAxis)(rand() % RUBIX_CUBE_AXIS_COUNT),(RubixCubeFaceRotation)(rand() % 3)) ;
+			}
+			/* A mirror is no way to hold a cube, so the tables do not have it */
+			if (round % 8 == 7) {
+				unsigned char left = frame.sides[RUBIX_CUBE_SQUARE_LEFT] ;
+				frame.sides[RUBIX_CUBE_SQUARE_LEFT] = frame.sides[RUBIX_CUBE_SQUARE_RIGHT] ;
+				frame.sides[RUBIX_CUBE_SQUARE_RIGHT] = left ;
+			}
+			single_frame = frame ;
+			same &= rubix_cube_apply_turn_codes(&cube,&frame,codes,32) ;
+			for (size_t i = 0; i < 32; ++i) same &= rubix_cube_apply_turn(&single,&single_frame,codes[i]) ;
+			same &= rubix_cube_equivelence_check(&cube,&single) && !memcmp(&frame,&single_frame,sizeof(frame)) ;
+		}
+		ASSERT(same) ;
+	) ;
+) ;
+
+/* Return nonzero if optimizing @text gives @expected */
+static int optimize_gives(const char * text, const char * expected) {
+	unsigned char codes[32] ;
+	char result[RUBIX_CUBE_NOTATION_FORMAT_SIZE(32)] ;
+	size_t count = rubix_cube_notation_parse_codes(codes,sizeof(codes),text,strlen(text),0,NULL), length ;
+
+	if (!rubix_cube_optimize_codes(codes,&count)) return 0 ;
+	length = rubix_cube_notation_format_codes(result,sizeof(result),codes,count,0) ;
+	return length == strlen(expected) && !memcmp(result,expected,length) ;
+}
+
+TEST_SET(optimize,
+	TEST_CASE(rules,
+		ASSERT(optimize_gives("U U'","")) ;
+		ASSERT(optimize_gives("R R R","R'")) ;
+		ASSERT(optimize_gives("F R R' F","F2")) ;
+		ASSERT(optimize_gives("D U","U D")) ;
+		ASSERT(optimize_gives("U D U'","D")) ;
+		ASSERT(optimize_gives("L R2 L R2 F","L2 F")) ;
+		ASSERT(optimize_gives("U D2 F2 B2 U2","U' F2 B2 D2")) ;
+		ASSERT(optimize_gives("U2 F2 B2 U2 D2","D2 F2 B2")) ;
+		ASSERT(optimize_gives("R U R' U'","R U R' U'")) ;
+	) ;
+
+	TEST_CASE(same_cube,
+		unsigned char codes[64], original[64], bad = RUBIX_CUBE_MOVE_COUNT ;
+		size_t total = 0, left = 0, length, count ;
+		int same = 1 ;
+
+		srand(34) ;
+		for (size_t round = 0; round < 256; ++round) {
+			RubixCube optimized = rubix_cube_generate_solved(), plain = rubix_cube_generate_solved() ;
+
+			count = length = 1 + (size_t)rand() % 64 ;
+			for (size_t i = 0; i < length; ++i) original[i] = codes[i] = (unsigned char)(rand() % RUBIX_CUBE_MOVE_COUNT) ;
+			same &= rubix_cube_optimize_codes(codes,&count) ;
+			total += length ;
+			left += count ;
+			rubix_cube_apply_move_codes(&optimized,codes,count) ;
+			rubix_cube_apply_move_codes(&plain,original,length) ;
+			same &= rubix_cube_equivelence_check(&optimized,&plain) ;
+			/* No face twice in a row and opposite faces in order, which the solvers never search either */
+			for (size_t i = 1; i < count; ++i) {
+				size_t side = codes[i] / RUBIX_CUBE_FACE_ROTATION_COUNT, last = codes[i - 1] / RUBIX_CUBE_FACE_ROTATION_COUNT ;
+				same &= side != last && !(side == RUBIX_CUBE_SQUARE_OPPOSITE(last) && side < last) ;
+			}
+		}
+		ASSERT(same) ;
+		ASSERT(left < total) ;
+		count = 1 ;
+		ASSERT(!rubix_cube_optimize_codes(&bad,&count) && count == 1) ;
+	) ;
+
+	TEST_CASE(scramble,
+		RubixCubeScramble * pScramble = rubix_cube_scramble_allocate(35,1000) ;
+		RubixCube optimized = rubix_cube_generate_solved(), plain = rubix_cube_generate_solved() ;
+		size_t size = pScramble->size, removed ;
+
+		rubix_cube_apply_scramble(&plain,pScramble) ;
+		removed = rubix_cube_scramble_optimize(pScramble) ;
+		ASSERT(removed > 0 && pScramble->size == size - removed) ;
+		rubix_cube_apply_scramble(&optimized,pScramble) ;
+		ASSERT(rubix_cube_equivelence_check(&optimized,&plain)) ;
+		ASSERT(rubix_cube_scramble_optimize(pScramble) == 0) ;
+		rubix_cube_scramble_free(pScramble) ;
+	) ;
+) ;
+
+static int monkeys_stop_after(const RubixCubeMonkeysSummary * pSummary, void * context) {
+	size_t * pCalls = (size_t *)context ;
+	return pSummary->moves > 0 && ++*pCalls >= 2 ;
+}
+
+TEST_SET(monkeys,
+	TEST_CASE(walk_codes,
+		RubixCubeFacelets cube = rubix_cube_facelets_generate_solved(), solved = cube ;
+		unsigned char codes[] = { 0, 1, 5, 3, 8 }, bad = RUBIX_CUBE_MOVE_COUNT ;
+
+		/* U then U' is back at solved, so the walk stops there */
+		ASSERT(rubix_cube_facelets_walk_codes(&cube,codes,5) == 2) ;
+		ASSERT(!memcmp(&cube,&solved,sizeof(cube))) ;
+		ASSERT(rubix_cube_facelets_walk_codes(&cube,&codes[2],3) == 3) ;
+		ASSERT(memcmp(&cube,&solved,sizeof(cube))) ;
+		ASSERT(rubix_cube_facelets_walk_codes(&cube,&bad,1) == 0) ;
+	) ;
+
+	TEST_CASE(statistics,
+		RubixCubeMonkeysJob job = { .seed = 7, .walkers = 300, .length = 64, .walks = 20, .threads = 1 } ;
+		RubixCubeMonkeysSummary one, three ;
+		unsigned long long returned ;
+
+		ASSERT(rubix_cube_monkeys_run(&job,&one)) ;
+		job.threads = 3 ;
+		ASSERT(rubix_cube_monkeys_run(&job,&three)) ;
+		ASSERT(one.walks == 6000 && one.moves == 6000 * 64) ;
+		/* The same walkers make the same moves however they are split between threads */
+		ASSERT(!memcmp(one.returns,three.returns,sizeof(one.returns)) && one.late_returns == three.late_returns) ;
+		ASSERT(!memcmp(one.misplaced,three.misplaced,sizeof(one.misplaced))) ;
+		ASSERT(!memcmp(one.states,three.states,sizeof(one.states))) ;
+
+		/* Nothing comes back in one move, and about 1 in 18 in two */
+		ASSERT(one.returns[0] == 0 && one.returns[1] == 0) ;
+		ASSERT(one.returns[2] > 6000 / 18 * 3 / 4 && one.returns[2] < 6000 / 18 * 5 / 4) ;
+		returned = one.late_returns ;
+		for (size_t t = 0; t < RUBIX_CUBE_MONKEYS_DEPTHS; ++t) returned += one.returns[t] ;
+		ASSERT(returned <= one.walks) ;
+
+		/* One state at 0 moves, 18 at 1, each face turn moves 12 facelets off */
+		ASSERT(one.states[0] > 0.9 && one.states[0] < 1.1) ;
+		ASSERT(one.states[1] > 17.0 && one.states[1] < 19.0) ;
+		ASSERT(rubix_cube_monkeys_misplaced(&one,0) == 0.0 && rubix_cube_monkeys_misplaced(&one,1) == 12.0) ;
+		ASSERT(rubix_cube_monkeys_misplaced(&one,5) > rubix_cube_monkeys_misplaced(&one,2)) ;
+		ASSERT(rubix_cube_monkeys_misplaced(&one,RUBIX_CUBE_MONKEYS_DEPTHS) == 0.0) ;
+	) ;
+
+	TEST_CASE(callback,
+		RubixCubeMonkeysJob job = { .seed = 8, .walkers = 16, .length = 256, .interval = 0.01, .callback = monkeys_stop_after } ;
+		RubixCubeMonkeysSummary summary ;
+		size_t calls = 0 ;
+
+		job.context = &calls ;
+		ASSERT(rubix_cube_monkeys_run(&job,&summary)) ;
+		ASSERT(calls >= 2 && summary.moves > 0) ;
+		/* Running forever needs something to stop it */
+		job.callback = NULL ;
+		ASSERT(!rubix_cube_monkeys_run(&job,&summary)) ;
+	) ;
+) ;
+
+/* Responses land at their request id, from whichever worker made them */
+typedef struct service_responses {
+	pthread_mutex_t 		lock ;
+	RubixCubeServiceResponse 	responses[64] ;
+	size_t 				count ;
+} ServiceResponses ;
+
+static void service_collect(const RubixCubeServiceResponse * pResponse, void * context) {
+	ServiceResponses * pResponses = (ServiceResponses *)context ;
+
+	pthread_mutex_lock(&pResponses->lock) ;
+	if (pResponse->id < 64) pResponses->responses[pResponse->id] = *pResponse ;
+	++pResponses->count ;
+	pthread_mutex_unlock(&pResponses->lock) ;
+}
+
+TEST_SET(service,
+	TEST_CASE(wire_format,
+		RubixCubeServiceRequest request = { .id = 0x0102030405060708ULL, .kind = RUBIX_CUBE_SERVICE_APPLY, .count = 3,
+			.codes = { 6, 0, 17 }, .target_length = 20, .microseconds = 1500 }, decoded ;
+		RubixCubeServiceResponse response = { .id = 9, .kind = RUBIX_CUBE_SERVICE_SOLVE, .status = RUBIX_CUBE_SERVICE_OK,
+			.count = 2, .codes = { 4, 5 }, .nanoseconds = 7000 }, back ;
+		RubixCubeServiceStats stats = { .submitted = 3, .max = 12345 } ;
+		unsigned char bytes[RUBIX_CUBE_SERVICE_RESPONSE_SIZE + RUBIX_CUBE_SERVICE_MAX_CODES] ;
+		size_t size ;
+
+		memset(request.state.bytes,0xab,sizeof(request.state.bytes)) ;
+		size = rubix_cube_service_encode_request(bytes,&request) ;
+		ASSERT(size == RUBIX_CUBE_SERVICE_REQUEST_SIZE + 3 && bytes[0] == 0x08 && bytes[7] == 0x01) ;
+		/* Nothing is read until the whole request is there */
+		ASSERT(rubix_cube_service_decode_request(&decoded,bytes,size - 1) == 0) ;
+		ASSERT(rubix_cube_service_decode_request(&decoded,bytes,size) == size) ;
+		ASSERT(decoded.id == request.id && decoded.kind == request.kind && decoded.count == 3 && decoded.codes[2] == 17) ;
+		ASSERT(decoded.target_length == 20 && decoded.microseconds == 1500) ;
+		ASSERT(!memcmp(decoded.state.bytes,request.state.bytes,RUBIX_CUBE_PACKED_SIZE)) ;
+
+		size = rubix_cube_service_encode_response(bytes,&response) ;
+		ASSERT(size == RUBIX_CUBE_SERVICE_RESPONSE_SIZE + 2) ;
+		ASSERT(rubix_cube_service_decode_response(&back,bytes,size) == size) ;
+		ASSERT(back.id == 9 && back.status == RUBIX_CUBE_SERVICE_OK && back.count == 2 && back.codes[1] == 5 && back.nanoseconds == 7000) ;
+
+		size = rubix_cube_service_encode_stats(bytes,4,&stats) ;
+		ASSERT(size == RUBIX_CUBE_SERVICE_RESPONSE_SIZE + 8 * RUBIX_CUBE_SERVICE_STATS_WORDS) ;
+		ASSERT(rubix_cube_service_decode_response(&back,bytes,size) == size && back.kind == RUBIX_CUBE_SERVICE_STATS) ;
+		ASSERT(back.codes[0] == 3 && back.codes[8 * (RUBIX_CUBE_SERVICE_STATS_WORDS - 1)] == (12345 & 0xff)) ;
+	) ;
+
+	TEST_CASE(requests,
+		static ServiceResponses collected = { .lock = PTHREAD_MUTEX_INITIALIZER } ;
+		RubixCubeServiceOptions options = RUBIX_CUBE_SERVICE_DEFAULT_OPTIONS ;
+		RubixCubeServiceRequest request = { .kind = RUBIX_CUBE_SERVICE_APPLY } ;
+		RubixCube solved = rubix_cube_generate_solved(), cubes[32] ;
+		RubixCubeService * pService ;
+		RubixCubeServiceStats stats ;
+		RubixCubeSeed seed = 40 ;
+		size_t count = 0, done ;
+		int same = 1 ;
+
+		options.threads = 2 ;
+		options.batch = 8 ;
+		options.pin = 0 ;
+		ASSERT(!rubix_cube_service_start(&options)) ;
+		options.callback = service_collect ;
+		options.context = &collected ;
+		ASSERT((pService = rubix_cube_service_start(&options))) ;
+
+		/* Moves on solved of a few different lengths, so every batch has several of each */
+		rubix_cube_pack(&request.state,&solved) ;
+		for (; count < 32; ++count) {
+			request.id = count ;
+			request.count = 4 + count % 3 * 6 ;
+			rubix_cube_generate_move_codes(request.codes,&seed,1,request.count) ;
+			cubes[count] = solved ;
+			rubix_cube_apply_move_codes(&cubes[count],request.codes,request.count) ;
+			ASSERT(rubix_cube_service_submit(pService,&request)) ;
+		}
+		request.id = count++ ;
+		request.count = 1 ;
+		request.codes[0] = RUBIX_CUBE_MOVE_COUNT ;
+		ASSERT(rubix_cube_service_submit(pService,&request)) ;
+		request.id = count++ ;
+		request.kind = 7 ;
+		ASSERT(rubix_cube_service_submit(pService,&request)) ;
+		request.id = count++ ;
+		request.kind = RUBIX_CUBE_SERVICE_SOLVE ;
+		rubix_cube_pack(&request.state,&cubes[31]) ;
+		ASSERT(rubix_cube_service_submit(pService,&request)) ;
+		request.id = count++ ;
+		memset(request.state.bytes,0xff,RUBIX_CUBE_PACKED_SIZE) ;
+		ASSERT(rubix_cube_service_submit(pService,&request)) ;
+
+		do {
+			usleep(1000) ;
+			pthread_mutex_lock(&collected.lock) ;
+			done = collected.count ;
+			pthread_mutex_unlock(&collected.lock) ;
+		} while (done < count) ;
+		rubix_cube_service_stats(pService,&stats) ;
+		rubix_cube_service_stop(pService) ;
+
+		for (size_t i = 0; i < 32; ++i) {
+			RubixCubePacked expected ;
+			rubix_cube_pack(&expected,&cubes[i]) ;
+			same &= collected.responses[i].status == RUBIX_CUBE_SERVICE_OK && !memcmp(collected.responses[i].state.bytes,expected.bytes,RUBIX_CUBE_PACKED_SIZE) ;
+		}
+		ASSERT(same) ;
+		ASSERT(collected.responses[32].status == RUBIX_CUBE_SERVICE_INVALID) ;
+		ASSERT(collected.responses[33].status == RUBIX_CUBE_SERVICE_BAD_REQUEST) ;
+		ASSERT(collected.responses[34].status == RUBIX_CUBE_SERVICE_OK && collected.responses[34].kind == RUBIX_CUBE_SERVICE_SOLVE) ;
+		ASSERT(rubix_cube_apply_move_codes(&cubes[31],collected.responses[34].codes,collected.responses[34].count)) ;
+		ASSERT(rubix_cube_is_solved(&cubes[31])) ;
+		ASSERT(collected.responses[35].status == RUBIX_CUBE_SERVICE_INVALID) ;
+
+		ASSERT(stats.submitted == count && stats.completed == count && stats.rejected == 0 && stats.queue_depth == 0) ;
+		ASSERT(stats.batches > 0 && stats.batches <= count) ;
+		ASSERT(stats.p50 > 0 && stats.p50 <= stats.p99 && stats.p99 <= stats.max) ;
+	) ;
+) ;
+
+typedef struct distributed_worker {
+	unsigned 			port ;
+	const RubixCubeSolver * 	pSolver ;
+	size_t 				threads ;
+	int 				success ;
+} DistributedWorker ;
+
+static void * distributed_work(void * argument) {
+	DistributedWorker * pWorker = (DistributedWorker *)argument ;
+	pWorker->success = rubix_cube_distributed_work("127.0.0.1",pWorker->port,pWorker->pSolver,pWorker->threads) ;
+	return NULL ;
+}
+
+TEST_SET(distributed,
+	TEST_CASE(enumerate_and_solve,
+		/* Canonical sequences of 0 to 5 moves, see the optimal solver */
+		const unsigned long long sequences[] = { 1, 18, 243, 3240, 43254, 577368 } ;
+		RubixCubeDistributed * pDistributed = rubix_cube_distributed_listen(0) ;
+		RubixCubeSolver * pSolver = allocate_small_solver() ;
+		DistributedWorker workers[2] ;
+		RubixCubeDistributedStats stats ;
+		RubixCubeCubie start = rubix_cube_cubie_generate_solved() ;
+		RubixCubeMove move = { (RubixCubeSide)(RUBIX_CUBE_SQUARE_RIGHT), RUBIX_CUBE_FACE_ROTATION_CLOCKWISE } ;
+		pthread_t threads[2] ;
+		int same = 1 ;
+
+		ASSERT(pDistributed && pSolver) ;
+		/* Two worker processes as far as the coordinator can tell, one with two connections */
+		for (size_t i = 0; i < 2; ++i) {
+			workers[i] = (DistributedWorker){ rubix_cube_distributed_port(pDistributed), pSolver, i + 1, 0 } ;
+			ASSERT(!pthread_create(&threads[i],NULL,distributed_work,&workers[i])) ;
+		}
+
+		for (size_t depth = 0; depth < sizeof(sequences) / sizeof(*sequences); ++depth) {
+			same &= rubix_cube_distributed_enumerate(pDistributed,NULL,depth,&stats) && stats.sequences == sequences[depth] ;
+			same &= stats.solved == (depth == 0) ;
+		}
+		ASSERT(same) ;
+		/* Fewer subtrees than it takes to keep everyone busy, the rest is given away, but counted only once */
+		ASSERT(rubix_cube_distributed_set_prefix_length(pDistributed,1)) ;
+		ASSERT(!rubix_cube_distributed_set_prefix_length(pDistributed,RUBIX_CUBE_DISTRIBUTED_MAX_DEPTH + 1)) ;
+		ASSERT(rubix_cube_distributed_enumerate(pDistributed,NULL,5,&stats) && stats.sequences == sequences[5]) ;
+		ASSERT(stats.subtrees == 18 + stats.splits && stats.workers == 3) ;
+		rubix_cube_cubie_apply_move(&start,&move) ;
+		ASSERT(rubix_cube_distributed_enumerate(pDistributed,&start,1,&stats) && stats.solved == 1) ;
+		ASSERT(!rubix_cube_distributed_enumerate(pDistributed,NULL,RUBIX_CUBE_DISTRIBUTED_MAX_DEPTH + 1,&stats)) ;
+		ASSERT(rubix_cube_distributed_set_prefix_length(pDistributed,RUBIX_CUBE_DISTRIBUTED_PREFIX_LENGTH)) ;
+
+		/* As short as the solver on its own finds */
+		for (RubixCubeSeed seed = 1; seed <= 6; ++seed) {
+			RubixCubeCubie cubie = rubix_cube_cubie_generate_solved(), check ;
+			RubixCubeScramble * pLocal, * pDistributedSolution ;
+
+			for (size_t k = 0; k < 6; ++k) {
+				move = rubix_cube_generate_move_from_seed(seed,k) ;
+				rubix_cube_cubie_apply_move(&cubie,&move) ;
+			}
+			pLocal = rubix_cube_solver_solve_cubie(pSolver,&cubie,RUBIX_CUBE_SOLVER_MAX_DEPTH) ;
+			pDistributedSolution = rubix_cube_distributed_solve(pDistributed,&cubie,RUBIX_CUBE_SOLVER_MAX_DEPTH,&stats) ;
+			same &= pLocal && pDistributedSolution && pLocal->size == pDistributedSolution->size ;
+			check = cubie ;
+			if (pDistributedSolution) rubix_cube_cubie_apply_scramble(&check,pDistributedSolution) ;
+			same &= rubix_cube_cubie_is_solved(&check) && stats.rounds > 0 ;
+			rubix_cube_scramble_free(pLocal) ;
+			rubix_cube_scramble_free(pDistributedSolution) ;
+		}
+		ASSERT(same) ;
+		ASSERT(!rubix_cube_distributed_solve(pDistributed,&start,0,&stats)) ;
+
+		rubix_cube_distributed_close(pDistributed) ;
+		for (size_t i = 0; i < 2; ++i) pthread_join(threads[i],NULL) ;
+		ASSERT(workers[0].success && workers[1].success) ;
+		rubix_cube_solver_free(pSolver) ;
+	) ;
+
+	TEST_CASE(jobs_after_cancel,
+		RubixCubeDistributed * pDistributed = rubix_cube_distributed_listen(0) ;
+		RubixCubeSolver * pSolver = allocate_small_solver() ;
+		DistributedWorker worker ;
+		RubixCubeDistributedStats stats ;
+		pthread_t thread ;
+		int same = 1 ;
+
+		ASSERT(pDistributed && pSolver) ;
+		/* Without tables nothing is pruned, so the workers are far past a look at their connection when a solution cancels them */
+		worker = (DistributedWorker){ rubix_cube_distributed_port(pDistributed), NULL, 2, 0 } ;
+		ASSERT(!pthread_create(&thread,NULL,distributed_work,&worker)) ;
+		ASSERT(rubix_cube_distributed_set_prefix_length(pDistributed,1)) ;
+
+		for (RubixCubeSeed seed = 1; seed <= 3; ++seed) {
+			RubixCubeCubie cubie = rubix_cube_cubie_generate_solved() ;
+			RubixCubeScramble * pLocal, * pSolution ;
+
+			for (size_t k = 0; k < 5; ++k) {
+				RubixCubeMove move = rubix_cube_generate_move_from_seed(seed,k) ;
+				rubix_cube_cubie_apply_move(&cubie,&move) ;
+			}
+			pLocal = rubix_cube_solver_solve_cubie(pSolver,&cubie,RUBIX_CUBE_SOLVER_MAX_DEPTH) ;
+			pSolution = rubix_cube_distributed_solve(pDistributed,&cubie,RUBIX_CUBE_SOLVER_MAX_DEPTH,&stats) ;
+			same &= pLocal && pSolution && pLocal->size == pSolution->size ;
+			rubix_cube_scramble_free(pLocal) ;
+			rubix_cube_scramble_free(pSolution) ;
+			/* The next job comes right after the cancel and has to be started, not drained with it */
+			same &= rubix_cube_distributed_enumerate(pDistributed,NULL,2,&stats) && stats.sequences == 243 ;
+		}
+		ASSERT(same) ;
+
+		rubix_cube_distributed_close(pDistributed) ;
+		pthread_join(thread,NULL) ;
+		ASSERT(worker.success) ;
+		rubix_cube_solver_free(pSolver) ;
+	) ;
+) ;
+
+TEST_SET(unrolled,
+	TEST_CASE(matches_rotation_table,
+		int same = 1 ;
+
+		for (RubixCubeSeed seed = 1; seed <= 8; ++seed) {
+			for (size_t move = 0; move < RUBIX_CUBE_MOVE_COUNT; ++move) {
+				RubixCubeSide side = move / RUBIX_CUBE_FACE_ROTATION_COUNT ;
+				RubixCubeFaceRotation rotation = move % RUBIX_CUBE_FACE_ROTATION_COUNT ;
+				RubixCube generic = rubix_cube_generate_scrambled(seed), unrolled = generic, face = generic ;
+
+				rubix_cube_rotate_face_generic(&generic,side,rotation) ;
+				rubix_cube_unrolled_turns[move](&unrolled) ;
+				rubix_cube_rotate_face(&face,side,rotation) ;
+				same &= !memcmp(&generic,&unrolled,sizeof(RubixCube)) && !memcmp(&generic,&face,sizeof(RubixCube)) ;
+			}
+		}
+		ASSERT(same) ;
+	) ;
+
+	TEST_CASE(matches_slice_rotation_table,
+		int same = 1 ;
+
+		for (RubixCubeSeed seed = 1; seed <= 8; ++seed) {
+			for (size_t slice = 0; slice < RUBIX_CUBE_SLICE_COUNT; ++slice) {
+				for (size_t rotation = 0; rotation < RUBIX_CUBE_FACE_ROTATION_COUNT; ++rotation) {
+					RubixCube generic = rubix_cube_generate_scrambled(seed), unrolled = generic ;
+
+					rubix_cube_rotate_slice_generic(&generic,slice,rotation) ;
+					rubix_cube_rotate_slice(&unrolled,slice,rotation) ;
+					same &= !memcmp(&generic,&unrolled,sizeof(RubixCube)) ;
+				}
+			}
+		}
+		ASSERT(same) ;
+	) ;
+
+	TEST_CASE(inlined_turns,
+		RubixCube cube = rubix_cube_generate_solved(), reference = cube ;
+
+		rubix_cube_unrolled_right_clockwise(&cube) ;
+		rubix_cube_unrolled_top_double(&cube) ;
+		rubix_cube_unrolled_front_counterclockwise(&cube) ;
+		ASSERT(memcmp(&cube,&rubix_cube_solved,sizeof(RubixCube))) ;
+		rubix_cube_rotate_face_generic(&reference,RUBIX_CUBE_SQUARE_RIGHT,RUBIX_CUBE_FACE_ROTATION_CLOCKWISE) ;
+		rubix_cube_rotate_face_generic(&reference,RUBIX_CUBE_SQUARE_TOP,RUBIX_CUBE_FACE_ROTATION_DOUBLE) ;
+		rubix_cube_rotate_face_generic(&reference,RUBIX_CUBE_SQUARE_FRONT,RUBIX_CUBE_FACE_ROTATION_COUNTERCLOCKWISE) ;
+		ASSERT(!memcmp(&cube,&reference,sizeof(RubixCube))) ;
+
+		rubix_cube_unrolled_front_clockwise(&cube) ;
+		rubix_cube_unrolled_top_double(&cube) ;
+		rubix_cube_unrolled_rotate_face(&cube,RUBIX_CUBE_SQUARE_RIGHT,RUBIX_CUBE_FACE_ROTATION_COUNTERCLOCKWISE) ;
+		ASSERT(!memcmp(&cube,&rubix_cube_solved,sizeof(RubixCube))) ;
+	) ;
+) ;
+
 TEST_MAIN() ;
 